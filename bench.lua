@@ -0,0 +1,82 @@
+project "lucid_bench"
+   kind "ConsoleApp"
+   language "C++"
+   targetdir "bin/%{cfg.buildcfg}"
+   cppdialect "C++17"
+
+   includedirs { "." }
+
+   includedirs {
+      "engine",
+      "engine/platform/include",
+      "engine/devices/include",
+      "engine/common/include",
+      "engine/misc/include",
+      "engine/scene/include",
+      "engine/resources/include",
+      "engine/schemas/include",
+      "engine/imgui/include",
+      "libs/stb"
+   }
+
+   includedirs {
+      "tools/bench/include",
+      "libs/glm",
+      "libs/SDL2/include",
+      "libs/df_serialize",
+      "libs/rapidjson",
+      "libs/sole/include"
+   }
+
+   libdirs {
+      "bin/%{cfg.buildcfg}",
+      "libs/SDL2/lib/x64",
+      "libs/assimp/lib/x64"
+   }
+
+   links {
+      "SDL2",
+      "SDL2main",
+      "assimp",
+      "lucid_engine"
+   }
+
+   files {
+      "tools/bench/src/*.cpp"
+   }
+
+   -- The renderer stats the benchmark reports are only gathered in development builds
+   defines { "DEVELOPMENT=1" }
+
+   filter "platforms:Win64"
+      architecture "x86_64"
+
+   filter "platforms:Win32"
+      architecture "x86"
+
+   filter "platforms:Linux"
+      architecture "x86_64"
+
+   -- EGL is needed for the surfaceless context used when there's no display
+   filter "system:linux"
+      links {
+         "GL",
+         "EGL"
+      }
+
+   filter "system:windows"
+      links {
+         "opengl32",
+      }
+
+   filter "configurations:Debug"
+      defines { "DEBUG" }
+      symbols "On"
+      optimize "Off"
+
+   filter "configurations:Release"
+      defines { "NDEBUG" }
+      symbols "Off"
+      optimize "On"
+
+   filter {}
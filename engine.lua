@@ -66,6 +66,9 @@ project "lucid_engine"
       "engine/*.cpp",
       "engine/imgui/include/*.h",
       "engine/imgui/src/*.cpp",
+      -- The actors' UI and terrain sculpting use the editor state and ImGui helpers, so they're a part of the engine instead of each tool
+      "tools/scene_editor/src/editor.cpp",
+      "tools/scene_editor/src/imgui_lucid.cpp",
       "libs/rapidjson/**.h",
       "libs/df_serialize/*.h",
       "libs/glad/src/glad.c",
@@ -85,11 +88,13 @@ project "lucid_engine"
       links { 
          "GL", 
       }
+      removefiles { "engine/platform/src/windows/**.cpp" }
 
    filter "system:windows"
       links { 
          "opengl32", 
       }
+      removefiles { "engine/platform/src/linux/**.cpp" }
    
    filter "configurations:Debug"
       defines { "DEBUG" }
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+#include "common/types.hpp"
+
+namespace lucid
+{
+    /**
+     * Linear allocator, an allocation just bumps the offset and all of them are released at once by Reset().
+     * When the arena runs out of space the allocation falls back to the heap and the arena grows to the peak usage on the next Reset(),
+     * so once the usage settles down it doesn't touch the heap at all. Not thread safe.
+     */
+    class CLinearArena
+    {
+      public:
+        explicit CLinearArena(const u64& InCapacity = 0);
+        ~CLinearArena();
+
+        CLinearArena(const CLinearArena&) = delete;
+        CLinearArena& operator=(const CLinearArena&) = delete;
+
+        void* Allocate(const u64& InSize, const u64& InAlignment = alignof(std::max_align_t));
+
+        /** Invalidates everything that was allocated from the arena */
+        void Reset();
+        void Free();
+
+        inline u64 GetUsed() const { return Used; }
+        inline u64 GetCapacity() const { return Capacity; }
+
+      private:
+        void FreeOverflowBlocks();
+
+        u8* Memory   = nullptr;
+        u64 Capacity = 0;
+        u64 Offset   = 0;
+
+        /** Bytes requested since the last reset, including the ones that didn't fit */
+        u64 Used = 0;
+
+        /** Heap blocks allocated when the arena was full, each one starts with a pointer to the previous one */
+        void* OverflowBlocks = nullptr;
+    };
+
+    /**
+     * Memory for data that only lives until the end of the frame, e.x. the results of scene queries and the renderer's scratch containers.
+     * It's reset at the beginning of each frame, main thread only.
+     */
+    extern CLinearArena GFrameArena;
+
+    /** Adapter that allows the std containers to allocate from the frame arena, the memory is never freed, just reused by the next frame */
+    template <typename T>
+    struct FFrameAllocator
+    {
+        using value_type = T;
+
+        FFrameAllocator() = default;
+
+        template <typename U>
+        FFrameAllocator(const FFrameAllocator<U>&)
+        {
+        }
+
+        T*   allocate(const std::size_t InCount) { return (T*)GFrameArena.Allocate(sizeof(T) * InCount, alignof(T)); }
+        void deallocate(T*, const std::size_t) {}
+
+        template <typename U>
+        bool operator==(const FFrameAllocator<U>&) const
+        {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const FFrameAllocator<U>&) const
+        {
+            return false;
+        }
+    };
+
+    template <typename T>
+    using FFrameVector = std::vector<T, FFrameAllocator<T>>;
+
+    template <typename K, typename V, typename THash = std::hash<K>>
+    using FFrameUnorderedMap = std::unordered_map<K, V, THash, std::equal_to<K>, FFrameAllocator<std::pair<const K, V>>>;
+} // namespace lucid
@@ -4,10 +4,13 @@
 
 namespace lucid
 {
+    class CLinearArena;
+
+    /** When an arena is passed, the array's memory comes from it and Free() doesn't have to be called, copies are allocated on the heap */
     template <typename T>
     struct FArray
     {
-        FArray(const u32& InCapacity, const bool& InAutoResize = false, const u8& InResizeFactor = 2);
+        FArray(const u32& InCapacity, const bool& InAutoResize = false, const u8& InResizeFactor = 2, CLinearArena* InArena = nullptr);
 
         T* operator[](const u32& InIndex) const;
 
@@ -30,9 +33,10 @@ namespace lucid
         }
 
     private:
-        T*      ArrayPointer;
-        bool    AutoResize;
-        u8      ResizeFactor;
+        T*            ArrayPointer;
+        bool          AutoResize;
+        u8            ResizeFactor;
+        CLinearArena* Arena;
 
         u32     Length = 0;
         u32     Capacity;
@@ -68,29 +72,122 @@ namespace lucid
         V   value;
     };
 
+    /**
+     * Open addressing hash map. The entries are stored densely in insertion order, so iterating over them by index is
+     * a linear walk over memory. Removing an entry moves the last one into it's place.
+     * The table only holds a control byte and the index of the entry for each bucket. The buckets are probed in groups
+     * of 16 control bytes at once with SSE2, the control byte holds 7 bits of the key's hash, so most of the
+     * mismatching entries are skipped without touching the keys.
+     * Get() returns a default constructed value if the key isn't in the map.
+     * The keys and the values are copied around with memcpy, so they have to be trivially copyable.
+     */
     template <typename K, typename V>
     struct FHashMap
     {
     public:
+        FHashMap() = default;
+        FHashMap(const FHashMap& Other);
+        FHashMap(FHashMap&& Other);
+        ~FHashMap();
+
+        /** Copies the entries, maps don't share their memory */
+        FHashMap& operator=(const FHashMap& Other);
+        FHashMap& operator=(FHashMap&& Other);
 
         void                    Add(const K& Key, const V& Value);
         V&                      Get(const K& Key);
         FHashMapEntry<K, V>&    GetEntryByIndex(const u64& EntryNum) const
         {
             assert(EntryNum < GetLength());
-            return HashMap[EntryNum];
+            return Entries[EntryNum];
         }
         V&                      GetByIndex(const u64& EntryNum) const;
         void                    Remove(const K& Key);
-        bool                    Contains(const K& Key);
+        bool                    Contains(const K& Key) const;
         u32                     GetLength() const;
+
+        /** Makes sure that InNumEntries fit without growing the map */
+        void                    Reserve(const u32& InNumEntries);
+
+        /** Rebuilds the table with InNumBuckets buckets (rounded up to a power of 2), which also drops the removed entries' tombstones */
+        void                    Rehash(const u32& InNumBuckets);
+
+        /** Removes all of the entries, but keeps the memory */
+        void                    Clear();
         void                    FreeAll();
 
+        inline FHashMapEntry<K, V>* begin() const { return Entries; }
+        inline FHashMapEntry<K, V>* end() const { return Entries + Length; }
+
     private:
-        
-        FHashMapEntry<K, V>* HashMap = NULL;
+        /** Returns the index of the key's bucket or -1 if the map doesn't contain it */
+        i64                     FindBucket(const K& Key, const u64& Hash) const;
+        void                    InsertIntoTable(const u32& InEntryIdx, const u64& Hash);
+
+        FHashMapEntry<K, V>*    Entries = nullptr;
+        u32                     Length = 0;
+        u32                     Capacity = 0;
+
+        u8*                     Control = nullptr;
+        u32*                    EntryIdxByBucket = nullptr;
+        u32                     NumBuckets = 0;
+        u32                     NumTombstones = 0;
+
+        V                       DefaultValue {};
     };
 
+    /**
+     * Dense map keyed by small, densely allocated ids, like the actor ids.
+     * The ids index a sparse array of slots, each slot holds the index of the id's entry. The entries are stored densely,
+     * like in FHashMap, so it can be used in it's place, but lookups are a single indirection with no hashing nor probing.
+     * Get() returns a default constructed value if the id isn't in the map.
+     */
+    template <typename V>
+    struct FSlotMap
+    {
+    public:
+        FSlotMap() = default;
+        FSlotMap(const FSlotMap& Other);
+        FSlotMap(FSlotMap&& Other);
+        ~FSlotMap();
+
+        /** Copies the entries, maps don't share their memory */
+        FSlotMap& operator=(const FSlotMap& Other);
+        FSlotMap& operator=(FSlotMap&& Other);
+
+        void                    Add(const u32& Id, const V& Value);
+        V&                      Get(const u32& Id);
+        FHashMapEntry<u32, V>&  GetEntryByIndex(const u64& EntryNum) const
+        {
+            assert(EntryNum < GetLength());
+            return Entries[EntryNum];
+        }
+        V&                      GetByIndex(const u64& EntryNum) const;
+        void                    Remove(const u32& Id);
+        bool                    Contains(const u32& Id) const;
+        inline u32              GetLength() const { return Length; }
+
+        /** Makes sure that InNumEntries with ids lower than InMaxId fit without growing the map */
+        void                    Reserve(const u32& InNumEntries, const u32& InMaxId);
+
+        /** Removes all of the entries, but keeps the memory */
+        void                    Clear();
+        void                    FreeAll();
+
+        inline FHashMapEntry<u32, V>* begin() const { return Entries; }
+        inline FHashMapEntry<u32, V>* end() const { return Entries + Length; }
+
+    private:
+        FHashMapEntry<u32, V>*  Entries = nullptr;
+        u32                     Length = 0;
+        u32                     Capacity = 0;
+
+        /** Index of the id's entry + 1, 0 if the map doesn't contain the id */
+        u32*                    Slots = nullptr;
+        u32                     NumSlots = 0;
+
+        V                       DefaultValue {};
+    };
 
     template <typename V>
     struct FStringHashMap
@@ -111,7 +208,10 @@ namespace lucid
         }* HashMap = NULL;
     };
 
-    
+#if DEVELOPMENT
+    /** Compares FHashMap and FSlotMap with the stb_ds hash map and std::unordered_map and logs the timings */
+    void BenchmarkHashMaps();
+#endif
 } // namespace lucid
 
 #include "common/collections.tpp"
\ No newline at end of file
@@ -2,21 +2,31 @@
 
 #include "common/collections.hpp"
 #include "common/bytes.hpp"
+#include "common/arena.hpp"
 
 #include <stdlib.h>
+#include <string.h>
 #include <cassert>
+#include <type_traits>
+#include <functional>
+#include <utility>
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include "stb_ds.h"
 
 namespace lucid
 {
     template <typename T>
-    FArray<T>::FArray(const u32& InCapacity, const bool& InAutoResize, const u8& InResizeFactor)
+    FArray<T>::FArray(const u32& InCapacity, const bool& InAutoResize, const u8& InResizeFactor, CLinearArena* InArena)
     {
         Capacity = InCapacity;
         AutoResize = InAutoResize;
         ResizeFactor = InResizeFactor;
-        ArrayPointer = (T*)malloc(sizeof(T) * Capacity);
+        Arena = InArena;
+        ArrayPointer = Arena ? (T*)Arena->Allocate(sizeof(T) * Capacity, alignof(T)) : (T*)malloc(sizeof(T) * Capacity);
     }
 
     template <typename T>
@@ -34,8 +44,18 @@ namespace lucid
             if (AutoResize)
             {
                 u32 NewCapacity = Capacity * ResizeFactor;
-                T* NewArray = (T*)CopyBytes((const char*)ArrayPointer, GetSizeInBytes(), sizeof(T) * NewCapacity);
-                free(ArrayPointer);
+                T* NewArray = nullptr;
+                if (Arena)
+                {
+                    // The old memory is reclaimed when the arena is reset
+                    NewArray = (T*)Arena->Allocate(sizeof(T) * NewCapacity, alignof(T));
+                    memcpy(NewArray, ArrayPointer, GetSizeInBytes());
+                }
+                else
+                {
+                    NewArray = (T*)CopyBytes((const char*)ArrayPointer, GetSizeInBytes(), sizeof(T) * NewCapacity);
+                    free(ArrayPointer);
+                }
                 ArrayPointer = NewArray;
                 Capacity = NewCapacity;
             }
@@ -59,7 +79,10 @@ namespace lucid
     template <typename T>
     void FArray<T>::Free()
     {
-        free(ArrayPointer);
+        if (!Arena)
+        {
+            free(ArrayPointer);
+        }
         Capacity = -1;
         Length = -1;
     }
@@ -76,6 +99,7 @@ namespace lucid
         Length = Rhs.Length;
         Capacity = Rhs.Capacity;
         ArrayPointer = Rhs.ArrayPointer;
+        Arena = Rhs.Arena;
         return *this;
     }
 
@@ -178,47 +202,527 @@ namespace lucid
         return Head.Element == nullptr;
     }
 
+    static constexpr u8  HASH_MAP_EMPTY      = 0x80;
+    static constexpr u8  HASH_MAP_DELETED    = 0xFE;
+    static constexpr u32 HASH_MAP_GROUP_SIZE = 16;
+
+    /** Mixes the bits of the key's hash, so sequential keys like the ids are spread over the whole table and get different control bytes */
+    template <typename K>
+    inline u64 HashMapHash(const K& Key)
+    {
+        u64 Hash;
+        if constexpr (std::is_pointer<K>::value)
+        {
+            Hash = (u64)(uintptr_t)Key;
+        }
+        else if constexpr (std::is_integral<K>::value || std::is_enum<K>::value)
+        {
+            Hash = (u64)Key;
+        }
+        else
+        {
+            Hash = std::hash<K>{}(Key);
+        }
+
+        Hash *= 0x9E3779B97F4A7C15ull;
+        return Hash ^ (Hash >> 32);
+    }
+
+    /** Returns a mask with a bit set for each of the group's control bytes that is equal to InByte */
+    inline u32 MatchHashMapGroup(const u8* InGroupControl, const u8& InByte)
+    {
+        const __m128i Group = _mm_load_si128((const __m128i*)InGroupControl);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(Group, _mm_set1_epi8((char)InByte)));
+    }
+
+    /** Returns a mask with a bit set for each of the group's buckets that is empty or deleted, full buckets have the highest bit cleared */
+    inline u32 MatchHashMapGroupFree(const u8* InGroupControl) { return _mm_movemask_epi8(_mm_load_si128((const __m128i*)InGroupControl)); }
+
+    inline u32 CountTrailingZeros(const u32& InValue)
+    {
+#if defined(_MSC_VER)
+        unsigned long Index;
+        _BitScanForward(&Index, InValue);
+        return Index;
+#else
+        return __builtin_ctz(InValue);
+#endif
+    }
+
+    template <typename K, typename V>
+    FHashMap<K, V>::FHashMap(const FHashMap& Other)
+    {
+        *this = Other;
+    }
+
+    template <typename K, typename V>
+    FHashMap<K, V>::FHashMap(FHashMap&& Other)
+    {
+        *this = std::move(Other);
+    }
+
+    template <typename K, typename V>
+    FHashMap<K, V>::~FHashMap()
+    {
+        FreeAll();
+    }
+
+    template <typename K, typename V>
+    FHashMap<K, V>& FHashMap<K, V>::operator=(const FHashMap& Other)
+    {
+        static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value);
+
+        if (this == &Other)
+        {
+            return *this;
+        }
+
+        FreeAll();
+
+        if (Other.Capacity)
+        {
+            Entries = (FHashMapEntry<K, V>*)malloc(sizeof(FHashMapEntry<K, V>) * Other.Capacity);
+            memcpy(Entries, Other.Entries, sizeof(FHashMapEntry<K, V>) * Other.Length);
+        }
+
+        if (Other.NumBuckets)
+        {
+            Control          = (u8*)_mm_malloc(Other.NumBuckets, HASH_MAP_GROUP_SIZE);
+            EntryIdxByBucket = (u32*)malloc(sizeof(u32) * Other.NumBuckets);
+            memcpy(Control, Other.Control, Other.NumBuckets);
+            memcpy(EntryIdxByBucket, Other.EntryIdxByBucket, sizeof(u32) * Other.NumBuckets);
+        }
+
+        Length        = Other.Length;
+        Capacity      = Other.Capacity;
+        NumBuckets    = Other.NumBuckets;
+        NumTombstones = Other.NumTombstones;
+        return *this;
+    }
+
+    template <typename K, typename V>
+    FHashMap<K, V>& FHashMap<K, V>::operator=(FHashMap&& Other)
+    {
+        if (this == &Other)
+        {
+            return *this;
+        }
+
+        FreeAll();
+
+        Entries          = Other.Entries;
+        Length           = Other.Length;
+        Capacity         = Other.Capacity;
+        Control          = Other.Control;
+        EntryIdxByBucket = Other.EntryIdxByBucket;
+        NumBuckets       = Other.NumBuckets;
+        NumTombstones    = Other.NumTombstones;
+
+        Other.Entries          = nullptr;
+        Other.Control          = nullptr;
+        Other.EntryIdxByBucket = nullptr;
+        Other.Length = Other.Capacity = Other.NumBuckets = Other.NumTombstones = 0;
+        return *this;
+    }
+
+    template <typename K, typename V>
+    i64 FHashMap<K, V>::FindBucket(const K& Key, const u64& Hash) const
+    {
+        if (NumBuckets == 0)
+        {
+            return -1;
+        }
+
+        const u8  ControlByte = Hash >> 57;
+        const u32 GroupMask   = (NumBuckets / HASH_MAP_GROUP_SIZE) - 1;
+
+        // Triangular probing visits each of the groups once, as the number of groups is a power of 2
+        u32 Group = (u32)Hash & GroupMask;
+        for (u32 Step = 1; Step <= GroupMask + 1; ++Step)
+        {
+            const u8* GroupControl = Control + (Group * HASH_MAP_GROUP_SIZE);
+            for (u32 Matches = MatchHashMapGroup(GroupControl, ControlByte); Matches; Matches &= Matches - 1)
+            {
+                const u32 Bucket = (Group * HASH_MAP_GROUP_SIZE) + CountTrailingZeros(Matches);
+                if (Entries[EntryIdxByBucket[Bucket]].key == Key)
+                {
+                    return Bucket;
+                }
+            }
+
+            // The key would have been put into this group if it was in the map
+            if (MatchHashMapGroup(GroupControl, HASH_MAP_EMPTY))
+            {
+                return -1;
+            }
+
+            Group = (Group + Step) & GroupMask;
+        }
+
+        return -1;
+    }
+
+    template <typename K, typename V>
+    void FHashMap<K, V>::InsertIntoTable(const u32& InEntryIdx, const u64& Hash)
+    {
+        const u32 GroupMask = (NumBuckets / HASH_MAP_GROUP_SIZE) - 1;
+
+        // The table is never full, so this always finds a free bucket
+        u32 Group = (u32)Hash & GroupMask;
+        for (u32 Step = 1;; ++Step)
+        {
+            if (const u32 FreeBuckets = MatchHashMapGroupFree(Control + (Group * HASH_MAP_GROUP_SIZE)))
+            {
+                const u32 Bucket = (Group * HASH_MAP_GROUP_SIZE) + CountTrailingZeros(FreeBuckets);
+                if (Control[Bucket] == HASH_MAP_DELETED)
+                {
+                    --NumTombstones;
+                }
+
+                Control[Bucket]          = Hash >> 57;
+                EntryIdxByBucket[Bucket] = InEntryIdx;
+                return;
+            }
+
+            Group = (Group + Step) & GroupMask;
+        }
+    }
+
     template <typename K, typename V>
     void FHashMap<K, V>::Add(const K& Key, const V& Value)
     {
-        hmput(HashMap, Key, Value);
+        const u64 Hash   = HashMapHash(Key);
+        const i64 Bucket = FindBucket(Key, Hash);
+        if (Bucket >= 0)
+        {
+            Entries[EntryIdxByBucket[Bucket]].value = Value;
+            return;
+        }
+
+        if (Length == Capacity)
+        {
+            Reserve(Capacity ? Capacity * 2 : HASH_MAP_GROUP_SIZE);
+        }
+
+        // Keep the load factor, including the tombstones, below 7/8
+        if ((u64)(Length + NumTombstones + 1) * 8 >= (u64)NumBuckets * 7)
+        {
+            Rehash((Length + 1) * 2);
+        }
+
+        Entries[Length] = { Key, Value };
+        InsertIntoTable(Length, Hash);
+        ++Length;
     }
-    
+
     template <typename K, typename V>
     V& FHashMap<K, V>::Get(const K& Key)
     {
-        return hmget(HashMap, Key);
+        const i64 Bucket = FindBucket(Key, HashMapHash(Key));
+        if (Bucket >= 0)
+        {
+            return Entries[EntryIdxByBucket[Bucket]].value;
+        }
+
+        DefaultValue = V{};
+        return DefaultValue;
     }
 
     template <typename K, typename V>
-    bool FHashMap<K, V>::Contains(const K& Key)
+    bool FHashMap<K, V>::Contains(const K& Key) const
     {
-        return hmgeti(HashMap, Key) != -1;
+        return FindBucket(Key, HashMapHash(Key)) >= 0;
     }
 
     template <typename K, typename V>
     u32 FHashMap<K, V>::GetLength() const
     {
-        return HashMap ? hmlen(HashMap) : 0;
+        return Length;
     }   
 
     template <typename K, typename V>
     V& FHashMap<K, V>::GetByIndex(const u64& EntryNum) const
     {
         assert(EntryNum < GetLength());
-        return HashMap[EntryNum].value;
+        return Entries[EntryNum].value;
     }
 
     template <typename K, typename V>
-    void FHashMap<K, V>::FreeAll()
+    void FHashMap<K, V>::Remove(const K& Key)
     {
-        hmfree(HashMap);
+        const i64 Bucket = FindBucket(Key, HashMapHash(Key));
+        if (Bucket < 0)
+        {
+            return;
+        }
+
+        // Leave a tombstone, so the probing doesn't stop at this bucket when looking for keys that were put after it
+        const u32 EntryIdx = EntryIdxByBucket[Bucket];
+        Control[Bucket]    = HASH_MAP_DELETED;
+        ++NumTombstones;
+
+        // Move the last entry in place of the removed one, so the entries stay dense
+        const u32 LastEntryIdx = Length - 1;
+        if (EntryIdx != LastEntryIdx)
+        {
+            const K& LastKey                                            = Entries[LastEntryIdx].key;
+            EntryIdxByBucket[FindBucket(LastKey, HashMapHash(LastKey))] = EntryIdx;
+            Entries[EntryIdx]                                           = Entries[LastEntryIdx];
+        }
+
+        --Length;
     }
 
     template <typename K, typename V>
-    void FHashMap<K, V>::Remove(const K& Key)
+    void FHashMap<K, V>::Reserve(const u32& InNumEntries)
     {
-        hmdel(HashMap, Key);
+        static_assert(std::is_trivially_copyable<K>::value && std::is_trivially_copyable<V>::value);
+
+        if (InNumEntries > Capacity)
+        {
+            Entries  = (FHashMapEntry<K, V>*)realloc(Entries, sizeof(FHashMapEntry<K, V>) * InNumEntries);
+            Capacity = InNumEntries;
+        }
+
+        if ((u64)InNumEntries * 8 >= (u64)NumBuckets * 7)
+        {
+            Rehash(InNumEntries);
+        }
+    }
+
+    template <typename K, typename V>
+    void FHashMap<K, V>::Rehash(const u32& InNumBuckets)
+    {
+        u32 NewNumBuckets = HASH_MAP_GROUP_SIZE;
+        while (NewNumBuckets < InNumBuckets || (u64)Length * 8 >= (u64)NewNumBuckets * 7)
+        {
+            NewNumBuckets *= 2;
+        }
+
+        _mm_free(Control);
+        free(EntryIdxByBucket);
+
+        Control          = (u8*)_mm_malloc(NewNumBuckets, HASH_MAP_GROUP_SIZE);
+        EntryIdxByBucket = (u32*)malloc(sizeof(u32) * NewNumBuckets);
+        NumBuckets       = NewNumBuckets;
+        NumTombstones    = 0;
+        memset(Control, HASH_MAP_EMPTY, NumBuckets);
+
+        for (u32 i = 0; i < Length; ++i)
+        {
+            InsertIntoTable(i, HashMapHash(Entries[i].key));
+        }
+    }
+
+    template <typename K, typename V>
+    void FHashMap<K, V>::Clear()
+    {
+        if (Control)
+        {
+            memset(Control, HASH_MAP_EMPTY, NumBuckets);
+        }
+
+        Length        = 0;
+        NumTombstones = 0;
+    }
+
+    template <typename K, typename V>
+    void FHashMap<K, V>::FreeAll()
+    {
+        free(Entries);
+        _mm_free(Control);
+        free(EntryIdxByBucket);
+
+        Entries          = nullptr;
+        Control          = nullptr;
+        EntryIdxByBucket = nullptr;
+        Length           = 0;
+        Capacity         = 0;
+        NumBuckets       = 0;
+        NumTombstones    = 0;
+    }
+
+    template <typename V>
+    FSlotMap<V>::FSlotMap(const FSlotMap& Other)
+    {
+        *this = Other;
+    }
+
+    template <typename V>
+    FSlotMap<V>::FSlotMap(FSlotMap&& Other)
+    {
+        *this = std::move(Other);
+    }
+
+    template <typename V>
+    FSlotMap<V>::~FSlotMap()
+    {
+        FreeAll();
+    }
+
+    template <typename V>
+    FSlotMap<V>& FSlotMap<V>::operator=(const FSlotMap& Other)
+    {
+        static_assert(std::is_trivially_copyable<V>::value);
+
+        if (this == &Other)
+        {
+            return *this;
+        }
+
+        FreeAll();
+
+        if (Other.Capacity)
+        {
+            Entries = (FHashMapEntry<u32, V>*)malloc(sizeof(FHashMapEntry<u32, V>) * Other.Capacity);
+            memcpy(Entries, Other.Entries, sizeof(FHashMapEntry<u32, V>) * Other.Length);
+        }
+
+        if (Other.NumSlots)
+        {
+            Slots = (u32*)malloc(sizeof(u32) * Other.NumSlots);
+            memcpy(Slots, Other.Slots, sizeof(u32) * Other.NumSlots);
+        }
+
+        Length   = Other.Length;
+        Capacity = Other.Capacity;
+        NumSlots = Other.NumSlots;
+        return *this;
+    }
+
+    template <typename V>
+    FSlotMap<V>& FSlotMap<V>::operator=(FSlotMap&& Other)
+    {
+        if (this == &Other)
+        {
+            return *this;
+        }
+
+        FreeAll();
+
+        Entries  = Other.Entries;
+        Length   = Other.Length;
+        Capacity = Other.Capacity;
+        Slots    = Other.Slots;
+        NumSlots = Other.NumSlots;
+
+        Other.Entries = nullptr;
+        Other.Slots   = nullptr;
+        Other.Length = Other.Capacity = Other.NumSlots = 0;
+        return *this;
+    }
+
+    template <typename V>
+    void FSlotMap<V>::Add(const u32& Id, const V& Value)
+    {
+        if (Id >= NumSlots)
+        {
+            Reserve(Capacity, (Id + 1) > (NumSlots * 2) ? (Id + 1) : (NumSlots * 2));
+        }
+
+        if (Slots[Id])
+        {
+            Entries[Slots[Id] - 1].value = Value;
+            return;
+        }
+
+        if (Length == Capacity)
+        {
+            Reserve(Capacity ? Capacity * 2 : 64, NumSlots);
+        }
+
+        Entries[Length] = { Id, Value };
+        Slots[Id]       = ++Length;
+    }
+
+    template <typename V>
+    V& FSlotMap<V>::Get(const u32& Id)
+    {
+        if (Id < NumSlots && Slots[Id])
+        {
+            return Entries[Slots[Id] - 1].value;
+        }
+
+        DefaultValue = V{};
+        return DefaultValue;
+    }
+
+    template <typename V>
+    V& FSlotMap<V>::GetByIndex(const u64& EntryNum) const
+    {
+        assert(EntryNum < GetLength());
+        return Entries[EntryNum].value;
+    }
+
+    template <typename V>
+    bool FSlotMap<V>::Contains(const u32& Id) const
+    {
+        return Id < NumSlots && Slots[Id];
+    }
+
+    template <typename V>
+    void FSlotMap<V>::Remove(const u32& Id)
+    {
+        if (!Contains(Id))
+        {
+            return;
+        }
+
+        // Move the last entry in place of the removed one, so the entries stay dense
+        const u32 EntryIdx     = Slots[Id] - 1;
+        const u32 LastEntryIdx = Length - 1;
+        if (EntryIdx != LastEntryIdx)
+        {
+            Entries[EntryIdx]            = Entries[LastEntryIdx];
+            Slots[Entries[EntryIdx].key] = EntryIdx + 1;
+        }
+
+        Slots[Id] = 0;
+        --Length;
+    }
+
+    template <typename V>
+    void FSlotMap<V>::Reserve(const u32& InNumEntries, const u32& InMaxId)
+    {
+        static_assert(std::is_trivially_copyable<V>::value);
+
+        if (InNumEntries > Capacity)
+        {
+            Entries  = (FHashMapEntry<u32, V>*)realloc(Entries, sizeof(FHashMapEntry<u32, V>) * InNumEntries);
+            Capacity = InNumEntries;
+        }
+
+        if (InMaxId > NumSlots)
+        {
+            Slots = (u32*)realloc(Slots, sizeof(u32) * InMaxId);
+            memset(Slots + NumSlots, 0, sizeof(u32) * (InMaxId - NumSlots));
+            NumSlots = InMaxId;
+        }
+    }
+
+    template <typename V>
+    void FSlotMap<V>::Clear()
+    {
+        // Cheaper than clearing all of the slots when the map holds only a few of the ids
+        for (u32 i = 0; i < Length; ++i)
+        {
+            Slots[Entries[i].key] = 0;
+        }
+
+        Length = 0;
+    }
+
+    template <typename V>
+    void FSlotMap<V>::FreeAll()
+    {
+        free(Entries);
+        free(Slots);
+
+        Entries  = nullptr;
+        Slots    = nullptr;
+        Length   = 0;
+        Capacity = 0;
+        NumSlots = 0;
     }
 
     template <typename V>
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+#include "common/types.hpp"
+
+namespace lucid
+{
+    using FJob = std::function<void()>;
+
+    /** Called with a [Begin, End) range of the indices passed to ParallelFor() */
+    using FRangeJob = std::function<void(const u32&, const u32&)>;
+
+    /**
+     * Pool of worker threads that run the submitted jobs in FIFO order.
+     * The GL context is only current on the main thread, so jobs can't touch the GPU.
+     */
+    class CJobSystem
+    {
+      public:
+        /** Spawns the worker threads, 0 means one worker per hardware thread except for the main one */
+        void Init(const u32& InNumWorkers = 0);
+
+        /** Can be called from any thread */
+        void Submit(FJob&& InJob);
+
+        /** Blocks until all of the submitted jobs are done */
+        void WaitForAll();
+
+        /**
+         * Splits [0, InCount) into ranges of InRangeSize indices and runs InJob on them on the workers.
+         * The calling thread works on the ranges too and only waits for them, not for the other jobs in flight.
+         */
+        void ParallelFor(const u32& InCount, const u32& InRangeSize, const FRangeJob& InJob);
+
+        /** Finishes the jobs that are already queued and joins the workers */
+        void Shutdown();
+
+        inline u32 GetNumWorkers() const { return Workers.size(); }
+
+      private:
+        void WorkerLoop();
+
+        std::vector<std::thread> Workers;
+        std::deque<FJob>         PendingJobs;
+
+        std::mutex              Mutex;
+        std::condition_variable JobAvailable;
+        std::condition_variable AllJobsDone;
+
+        /** Queued + currently running jobs */
+        u32  NumJobsInFlight = 0;
+        bool bShuttingDown   = false;
+    };
+} // namespace lucid
@@ -77,6 +77,9 @@ namespace lucid
     FDString CopyToString(char const* InToCopy, const u32& InStringLength = 0);
 
     FDString SPrintf(const char* InFormat, ...);
+
+    /** Same as SPrintf(), but the string is allocated from the frame arena, so it's valid until the end of the frame and doesn't have to be freed */
+    FSString FrameSPrintf(const char* InFormat, ...);
     
     extern FSString EMPTY_STRING;
 } // namespace lucid
@@ -0,0 +1,93 @@
+#include "common/arena.hpp"
+#include "common/log.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <cassert>
+
+namespace lucid
+{
+    CLinearArena GFrameArena{ 4 * 1024 * 1024 };
+
+    static inline uintptr_t AlignUp(const uintptr_t& InAddress, const u64& InAlignment)
+    {
+        assert((InAlignment & (InAlignment - 1)) == 0);
+        return (InAddress + InAlignment - 1) & ~(uintptr_t)(InAlignment - 1);
+    }
+
+    CLinearArena::CLinearArena(const u64& InCapacity) : Capacity(InCapacity)
+    {
+        if (Capacity)
+        {
+            Memory = (u8*)malloc(Capacity);
+        }
+    }
+
+    CLinearArena::~CLinearArena() { Free(); }
+
+    void* CLinearArena::Allocate(const u64& InSize, const u64& InAlignment)
+    {
+        Used += InSize;
+
+        const uintptr_t Start   = (uintptr_t)Memory;
+        const uintptr_t Aligned = AlignUp(Start + Offset, InAlignment);
+        if (Memory && (Aligned + InSize) <= (Start + Capacity))
+        {
+            Offset = (Aligned + InSize) - Start;
+            return (void*)Aligned;
+        }
+
+        // Doesn't fit, the arena will be big enough after the next reset
+        u8* Block      = (u8*)malloc(sizeof(void*) + InAlignment + InSize);
+        *(void**)Block = OverflowBlocks;
+        OverflowBlocks = Block;
+        Used += InAlignment;
+        return (void*)AlignUp((uintptr_t)(Block + sizeof(void*)), InAlignment);
+    }
+
+    void CLinearArena::FreeOverflowBlocks()
+    {
+        while (OverflowBlocks)
+        {
+            void* Previous = *(void**)OverflowBlocks;
+            free(OverflowBlocks);
+            OverflowBlocks = Previous;
+        }
+    }
+
+    void CLinearArena::Reset()
+    {
+        FreeOverflowBlocks();
+
+        if (Used > Capacity)
+        {
+            // Leave some headroom, so it doesn't grow by a few bytes every frame
+            const u64 NewCapacity = Used + (Used / 2);
+            LUCID_LOG(ELogLevel::INFO, "Growing linear arena from %llu to %llu bytes", Capacity, NewCapacity);
+
+            free(Memory);
+            Memory   = (u8*)malloc(NewCapacity);
+            Capacity = NewCapacity;
+        }
+#if DEVELOPMENT
+        else if (Memory)
+        {
+            // Makes use of the memory after the reset easier to spot
+            memset(Memory, 0xCD, Offset);
+        }
+#endif
+
+        Offset = 0;
+        Used   = 0;
+    }
+
+    void CLinearArena::Free()
+    {
+        FreeOverflowBlocks();
+        free(Memory);
+        Memory   = nullptr;
+        Capacity = 0;
+        Offset   = 0;
+        Used     = 0;
+    }
+} // namespace lucid
@@ -0,0 +1,176 @@
+#include "common/collections.hpp"
+
+#if DEVELOPMENT
+
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+
+#include "stb_ds.h"
+
+#include "common/log.hpp"
+
+#include "platform/util.hpp"
+
+namespace lucid
+{
+    /** Adapters, so all of the maps can be benchmarked by the same code */
+    struct FStbHashMapAdapter
+    {
+        struct
+        {
+            u32   key;
+            void* value;
+        }* HashMap = NULL;
+
+        inline void  Add(const u32& Key, void* Value) { hmput(HashMap, Key, Value); }
+        inline void* Get(const u32& Key) { return hmget(HashMap, Key); }
+        inline bool  Contains(const u32& Key) { return hmgeti(HashMap, Key) != -1; }
+        inline void* GetByIndex(const u32& Index) { return HashMap[Index].value; }
+        inline u32   GetLength() { return HashMap ? hmlen(HashMap) : 0; }
+        inline void  Remove(const u32& Key) { hmdel(HashMap, Key); }
+        inline void  FreeAll() { hmfree(HashMap); }
+    };
+
+    struct FUnorderedMapAdapter
+    {
+        std::unordered_map<u32, void*> Map;
+
+        // Can't be indexed, it's iterated instead
+        inline void  Add(const u32& Key, void* Value) { Map[Key] = Value; }
+        inline void* Get(const u32& Key)
+        {
+            const auto It = Map.find(Key);
+            return It != Map.end() ? It->second : nullptr;
+        }
+        inline bool Contains(const u32& Key) { return Map.find(Key) != Map.end(); }
+        inline void Remove(const u32& Key) { Map.erase(Key); }
+        inline void FreeAll() { Map.clear(); }
+    };
+
+    struct FHashMapTimings
+    {
+        real Add     = 0;
+        real Hits    = 0;
+        real Misses  = 0;
+        real Iterate = 0;
+        real Remove  = 0;
+    };
+
+    /** Lookups go in random order, so the benchmark isn't just walking the memory linearly when the ids are sequential */
+    template <typename TMap>
+    static FHashMapTimings BenchmarkHashMap(TMap& InMap, const std::vector<u32>& InKeys, const std::vector<u32>& InShuffledKeys, const u32& InMissOffset)
+    {
+        FHashMapTimings Timings;
+        uintptr_t       Sink = 0;
+
+        real Start = platform::GetCurrentTimeSeconds();
+        for (const u32& Key : InKeys)
+        {
+            InMap.Add(Key, (void*)(uintptr_t)(Key + 1));
+        }
+        Timings.Add = platform::GetCurrentTimeSeconds() - Start;
+
+        Start = platform::GetCurrentTimeSeconds();
+        for (const u32& Key : InShuffledKeys)
+        {
+            Sink += (uintptr_t)InMap.Get(Key);
+        }
+        Timings.Hits = platform::GetCurrentTimeSeconds() - Start;
+
+        Start = platform::GetCurrentTimeSeconds();
+        for (const u32& Key : InShuffledKeys)
+        {
+            Sink += InMap.Contains(Key + InMissOffset);
+        }
+        Timings.Misses = platform::GetCurrentTimeSeconds() - Start;
+
+        if constexpr (!std::is_same<TMap, FUnorderedMapAdapter>::value)
+        {
+            Start = platform::GetCurrentTimeSeconds();
+            for (u32 Pass = 0; Pass < 10; ++Pass)
+            {
+                for (u32 i = 0; i < InMap.GetLength(); ++i)
+                {
+                    Sink += (uintptr_t)InMap.GetByIndex(i);
+                }
+            }
+            Timings.Iterate = (platform::GetCurrentTimeSeconds() - Start) / 10;
+        }
+        else
+        {
+            Start = platform::GetCurrentTimeSeconds();
+            for (u32 Pass = 0; Pass < 10; ++Pass)
+            {
+                for (const auto& It : InMap.Map)
+                {
+                    Sink += (uintptr_t)It.second;
+                }
+            }
+            Timings.Iterate = (platform::GetCurrentTimeSeconds() - Start) / 10;
+        }
+
+        Start = platform::GetCurrentTimeSeconds();
+        for (u32 i = 0; i < InShuffledKeys.size(); i += 2)
+        {
+            InMap.Remove(InShuffledKeys[i]);
+        }
+        Timings.Remove = platform::GetCurrentTimeSeconds() - Start;
+
+        InMap.FreeAll();
+
+        // Makes sure the compiler doesn't throw the lookups away
+        if (Sink == 0)
+        {
+            LUCID_LOG(ELogLevel::INFO, "Hash map benchmark sink is 0");
+        }
+
+        return Timings;
+    }
+
+    static void LogHashMapTimings(const char* InMapName, const u32& InNumKeys, const FHashMapTimings& InTimings)
+    {
+        LUCID_LOG(ELogLevel::INFO,
+                  "%s, %d keys: add %f ms, hits %f ms, misses %f ms, iterate %f ms, remove half %f ms",
+                  InMapName,
+                  InNumKeys,
+                  InTimings.Add * 1000.0,
+                  InTimings.Hits * 1000.0,
+                  InTimings.Misses * 1000.0,
+                  InTimings.Iterate * 1000.0,
+                  InTimings.Remove * 1000.0);
+    }
+
+    void BenchmarkHashMaps()
+    {
+        std::mt19937 Random{ 1337 };
+
+        for (const u32 NumKeys : { 1000u, 10000u, 100000u })
+        {
+            // Sequential keys, like the actor ids
+            std::vector<u32> Keys(NumKeys);
+            for (u32 i = 0; i < NumKeys; ++i)
+            {
+                Keys[i] = i + 1;
+            }
+
+            std::vector<u32> ShuffledKeys = Keys;
+            std::shuffle(ShuffledKeys.begin(), ShuffledKeys.end(), Random);
+
+            FStbHashMapAdapter StbHashMap;
+            LogHashMapTimings("stb_ds hash map", NumKeys, BenchmarkHashMap(StbHashMap, Keys, ShuffledKeys, NumKeys));
+
+            FUnorderedMapAdapter UnorderedMap;
+            LogHashMapTimings("std::unordered_map", NumKeys, BenchmarkHashMap(UnorderedMap, Keys, ShuffledKeys, NumKeys));
+
+            FHashMap<u32, void*> HashMap;
+            LogHashMapTimings("FHashMap", NumKeys, BenchmarkHashMap(HashMap, Keys, ShuffledKeys, NumKeys));
+
+            FSlotMap<void*> SlotMap;
+            LogHashMapTimings("FSlotMap", NumKeys, BenchmarkHashMap(SlotMap, Keys, ShuffledKeys, NumKeys));
+        }
+    }
+} // namespace lucid
+
+#endif
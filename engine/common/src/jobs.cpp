@@ -0,0 +1,140 @@
+#include "common/jobs.hpp"
+
+#include "common/log.hpp"
+
+namespace lucid
+{
+    void CJobSystem::Init(const u32& InNumWorkers)
+    {
+        u32 NumWorkers = InNumWorkers;
+        if (NumWorkers == 0)
+        {
+            // hardware_concurrency() is allowed to return 0 when it can't tell
+            const u32 NumHardwareThreads = std::thread::hardware_concurrency();
+            NumWorkers                   = NumHardwareThreads > 1 ? NumHardwareThreads - 1 : 1;
+        }
+
+        bShuttingDown = false;
+        Workers.reserve(NumWorkers);
+        for (u32 i = 0; i < NumWorkers; ++i)
+        {
+            Workers.emplace_back(&CJobSystem::WorkerLoop, this);
+        }
+
+        LUCID_LOG(ELogLevel::INFO, "Job system started with %d workers", NumWorkers);
+    }
+
+    void CJobSystem::Submit(FJob&& InJob)
+    {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            PendingJobs.push_back(std::move(InJob));
+            ++NumJobsInFlight;
+        }
+        JobAvailable.notify_one();
+    }
+
+    void CJobSystem::WaitForAll()
+    {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        AllJobsDone.wait(Lock, [this] { return NumJobsInFlight == 0; });
+    }
+
+    void CJobSystem::ParallelFor(const u32& InCount, const u32& InRangeSize, const FRangeJob& InJob)
+    {
+        const u32 RangeSize = InRangeSize ? InRangeSize : 1;
+        const u32 NumRanges = (InCount + RangeSize - 1) / RangeSize;
+        if (NumRanges == 0)
+        {
+            return;
+        }
+
+        // Helpers can start after all of the ranges are done if the queue is busy, so they share the state instead of referencing the stack
+        struct FParallelForState
+        {
+            std::atomic<u32> NextRange      = 0;
+            std::atomic<u32> NumRangesDone  = 0;
+            u32              NumRanges      = 0;
+            u32              RangeSize      = 0;
+            u32              Count          = 0;
+            const FRangeJob* Job            = nullptr;
+        };
+
+        auto State       = std::make_shared<FParallelForState>();
+        State->NumRanges = NumRanges;
+        State->RangeSize = RangeSize;
+        State->Count     = InCount;
+        State->Job       = &InJob;
+
+        const auto RunRanges = [](FParallelForState& InState) {
+            for (u32 Range = InState.NextRange++; Range < InState.NumRanges; Range = InState.NextRange++)
+            {
+                const u32 Begin = Range * InState.RangeSize;
+                const u32 End   = Begin + InState.RangeSize < InState.Count ? Begin + InState.RangeSize : InState.Count;
+                (*InState.Job)(Begin, End);
+                ++InState.NumRangesDone;
+            }
+        };
+
+        const u32 NumHelpers = NumRanges - 1 < GetNumWorkers() ? NumRanges - 1 : GetNumWorkers();
+        for (u32 i = 0; i < NumHelpers; ++i)
+        {
+            Submit([State, RunRanges] { RunRanges(*State); });
+        }
+
+        RunRanges(*State);
+
+        // The last ranges might still be running on the workers
+        while (State->NumRangesDone < NumRanges)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void CJobSystem::Shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            bShuttingDown = true;
+        }
+        JobAvailable.notify_all();
+
+        for (std::thread& Worker : Workers)
+        {
+            Worker.join();
+        }
+        Workers.clear();
+    }
+
+    void CJobSystem::WorkerLoop()
+    {
+        while (true)
+        {
+            FJob Job;
+            {
+                std::unique_lock<std::mutex> Lock(Mutex);
+                JobAvailable.wait(Lock, [this] { return bShuttingDown || !PendingJobs.empty(); });
+
+                if (PendingJobs.empty())
+                {
+                    // Shutting down and there is nothing left to do
+                    return;
+                }
+
+                Job = std::move(PendingJobs.front());
+                PendingJobs.pop_front();
+            }
+
+            Job();
+
+            {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                --NumJobsInFlight;
+                if (NumJobsInFlight == 0)
+                {
+                    AllJobsDone.notify_all();
+                }
+            }
+        }
+    }
+} // namespace lucid
@@ -2,6 +2,7 @@
 #include "stdio.h"
 #include <ctime>
 #include <cstdarg>
+#include <mutex>
 
 namespace lucid
 {
@@ -14,11 +15,16 @@ namespace lucid
     // dummy, temporary solution
     static char msgBuff[100000];
 
+    // Jobs can log from the worker threads
+    static std::mutex LogMutex;
+
     //  static ExampleAppLog my_log;
     //  my_log.AddLog("Hello %d world\n", 123);
     //  my_log.Draw("title");
     void Log(const ELogLevel& InLevel, const char* InFile, const u32& InLine, const char* InFormat, ...)
     {
+        std::lock_guard<std::mutex> Lock(LogMutex);
+
         va_list args;
         va_start(args, InFormat);
         vsprintf_s(msgBuff, 100000, InFormat, args);
@@ -1,5 +1,6 @@
 #include "common/strings.hpp"
 #include "common/bytes.hpp"
+#include "common/arena.hpp"
 
 #include <cstdarg>
 #include <string.h>
@@ -119,11 +120,25 @@ namespace lucid
 
     FDString SPrintf(const char* InFormat, ...)
     {
-        static char MsgBuffer[5024];
+        // Per thread, as resources are imported on the job system's workers
+        static thread_local char MsgBuffer[5024];
         va_list Args;
         va_start(Args, InFormat);
         const i32 FormatSize = vsprintf_s(MsgBuffer, 5024, InFormat, Args);
         va_end(Args);
         return CopyToString(MsgBuffer, FormatSize);
     }
+
+    FSString FrameSPrintf(const char* InFormat, ...)
+    {
+        static thread_local char MsgBuffer[5024];
+        va_list Args;
+        va_start(Args, InFormat);
+        const i32 FormatSize = vsprintf_s(MsgBuffer, 5024, InFormat, Args);
+        va_end(Args);
+
+        char* FrameString = (char*)GFrameArena.Allocate(FormatSize + 1, 1);
+        memcpy(FrameString, MsgBuffer, FormatSize + 1);
+        return FSString{ FrameString, (u32)FormatSize };
+    }
 } // namespace lucid
@@ -15,7 +15,9 @@ namespace lucid::gpu
         SHADER_STORAGE,
         WRITE,
         UNIFORM,
-        READ
+        READ,
+        DRAW_INDIRECT,
+        PIXEL_UNPACK
     };
 
     enum EBufferUsage : u16
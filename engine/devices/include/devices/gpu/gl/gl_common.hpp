@@ -56,9 +56,46 @@ namespace lucid
     static GLenum GL_WRAP_FILTERS_MAPPING[] = { GL_CLAMP_TO_EDGE, GL_MIRRORED_REPEAT, GL_REPEAT, GL_CLAMP_TO_BORDER };
     static GLenum GL_TEXTURE_DATA_TYPE_MAPPING[] = { GL_UNSIGNED_BYTE, GL_FLOAT, GL_UNSIGNED_INT };
     static GLenum GL_TEXTURE_TARGET_MAPPING[] = { GL_TEXTURE_1D, GL_TEXTURE_2D, GL_TEXTURE_3D };
+// S3TC formats come from EXT_texture_compression_s3tc and EXT_texture_sRGB, which aren't part of the core profile glad was generated for
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#endif
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
     static GLenum GL_TEXTURE_DATA_FORMAT[] = {
-        GL_RED,    GL_R16F, GL_R32F,    GL_R32UI,   GL_RG,   GL_RG16F,      GL_RG32F,           GL_RGB,          GL_RGB16F,
-        GL_RGB32F, GL_RGBA, GL_RGBA16F, GL_RGBA32F, GL_SRGB, GL_SRGB_ALPHA, GL_DEPTH_COMPONENT, GL_DEPTH_STENCIL
+        GL_RED,
+        GL_R16F,
+        GL_R32F,
+        GL_R32UI,
+        GL_RG,
+        GL_RG16F,
+        GL_RG32F,
+        GL_RGB,
+        GL_RGB16F,
+        GL_RGB32F,
+        GL_RGBA,
+        GL_RGBA16F,
+        GL_RGBA32F,
+        GL_SRGB,
+        GL_SRGB_ALPHA,
+        GL_DEPTH_COMPONENT,
+        GL_DEPTH_STENCIL,
+        GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+        GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,
+        GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+        GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,
+        GL_COMPRESSED_RED_RGTC1,
+        GL_COMPRESSED_RG_RGTC2,
+        GL_COMPRESSED_RGBA_BPTC_UNORM,
+        GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
     };
     static GLenum GL_TEXTURE_PIXEL_FORMAT[] = { GL_RED,  GL_RED_INTEGER,     GL_RG,           GL_RGB,
                                                 GL_RGBA, GL_DEPTH_COMPONENT, GL_DEPTH_STENCIL };
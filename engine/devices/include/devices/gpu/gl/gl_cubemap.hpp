@@ -50,8 +50,14 @@ namespace lucid::gpu
 
         virtual void CopyPixels(void* DestBuffer, const u8& MipLevel) const override;
 
+        virtual void GenerateMipMaps() override;
+        virtual void BindAsImage(const u8& InImageUnit, const u8& InMipLevel, const EImageAccess& InAccess) override;
+
       private:
         GLuint glCubemapHandle;
+
+        GLuint64 GLBindlessHandle         = 0;
+        bool     bBindlessTextureResident = false;
     };
 
 } // namespace lucid::gpu
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "devices/gpu/shader.hpp"
 
+#include <vector>
+
 #include "glad/glad.h"
 #include "common/collections.hpp"
 
@@ -22,6 +24,14 @@ namespace lucid::gpu
         CTexture* BoundTexture = nullptr;
     };
 
+    /** Indices of the uniform variable and the texture binding a uniform handle maps to in a shader */
+    struct FUniformHandleMapping
+    {
+        bool bResolved    = false;
+        u32  UniformIndex = 0;
+        u32  TextureIndex = 0;
+    };
+
     class CGLShader : public CShader
     {
       public:
@@ -57,6 +67,24 @@ namespace lucid::gpu
         virtual void UseTexture(const FString& InUniformName, CTexture* TextureToUse) override;
         virtual void UseBindlessTexture(const FString& InUniformName, const u64& Value) override;
 
+        virtual void SetInt(const FUniformHandle& InUniform, const i32& Value) override;
+        virtual void SetUInt(const FUniformHandle& InUniform, const u32& Value) override;
+        virtual void SetFloat(const FUniformHandle& InUniform, const float& Value) override;
+        virtual void SetBool(const FUniformHandle& InUniform, const bool& Value) override;
+
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::vec2& Value) override;
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::vec3& Value) override;
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::vec4& Value) override;
+
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::ivec2& Value) override;
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::ivec3& Value) override;
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::ivec4& Value) override;
+
+        virtual void SetMatrix(const FUniformHandle& InUniform, const glm::mat4& Value) override;
+
+        virtual void UseTexture(const FUniformHandle& InUniform, CTexture* TextureToUse) override;
+        virtual void UseBindlessTexture(const FUniformHandle& InUniform, const u64& Value) override;
+
         virtual void RestoreTextureBindings() override;
         
         virtual void AddBinding(BufferBinding* Binding) override;
@@ -73,11 +101,20 @@ namespace lucid::gpu
 
       private:
 
+        /** Maps the handle to this shader's uniform variable and texture binding, they're looked up by name on first use */
+        const FUniformHandleMapping& GetHandleMapping(const FUniformHandle& InUniform);
+
+        /** Returns the location of the uniform the handle refers to or -1 if the shader doesn't have it */
+        GLint GetHandleLocation(const FUniformHandle& InUniform);
+
         GLuint glShaderID;
 
         FArray<FUniformVariable> uniformVariables;
         FArray<FTextureBinding> TextureBindings;
         FLinkedList<BufferBinding> buffersBindings;
+
+        /** Indexed by the id of the handle, cleared when the shader is hot-reloaded as the uniforms are replaced */
+        std::vector<FUniformHandleMapping> HandleMappings;
         bool warnMissingUniforms;
     };
 } // namespace lucid::gpu
\ No newline at end of file
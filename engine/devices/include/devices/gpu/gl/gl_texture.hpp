@@ -41,6 +41,9 @@ namespace lucid::gpu
 
         virtual void CopyPixels(void* DestBuffer, const u8& MipLevel) const override;
 
+        virtual void GenerateMipMaps() override;
+        virtual void BindAsImage(const u8& InImageUnit, const u8& InMipLevel, const EImageAccess& InAccess) override;
+
         /** Bindless texture stuff */
         virtual u64  GetBindlessHandle() override;
         virtual bool IsBindlessTextureResident() const override;
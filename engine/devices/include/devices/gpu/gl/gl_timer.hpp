@@ -5,13 +5,16 @@
 
 namespace lucid::gpu
 {
+    /** Uses a pair of timestamp queries instead of GL_TIME_ELAPSED, so the timers can be nested */
     class CGLTimer : public CTimer
     {
       public:
-        CGLTimer(const FString& InName, const GLuint& InGLTimerQueryHandle);
+        CGLTimer(const FString& InName, const GLuint& InGLStartQueryHandle, const GLuint& InGLEndQueryHandle);
 
         /** Timer interface */
-        virtual void StartTimer() override;
+        virtual void  StartTimer() override;
+        virtual void  StopTimer() override;
+        virtual float GetElapsedMiliseconds() override;
         virtual float EndTimer() override;
 
         /** GPUObject interface */
@@ -22,7 +25,7 @@ namespace lucid::gpu
         bool bStarted = false;
         bool bStopped = false;
 
-        GLuint GLTimerQueryHandle = 0;
-        GLsync GLSyncHandle       = nullptr;
+        GLuint GLStartQueryHandle = 0;
+        GLuint GLEndQueryHandle   = 0;
     };
 } // namespace lucid::gpu
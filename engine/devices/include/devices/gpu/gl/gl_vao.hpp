@@ -36,14 +36,19 @@ namespace lucid::gpu
         virtual void SetElementCount(const uint32_t& Count) override;
         virtual uint32_t GetElementCount() const override;
 
-        virtual void Draw(const uint32_t& First, const uint32_t& Count) override;
+        virtual void Draw(const uint32_t& First, const uint32_t& Count, const i32& BaseVertex) override;
         virtual void DrawInstanced(const uint32_t& InstancesCount,
                                    const uint32_t& First = 0,
                                    const uint32_t& Count = 0) override;
 
+        virtual void DrawIndirect(const u32& InDrawCount = 1, const u32& InOffset = 0, const u32& InStride = 0) override;
+
         virtual CGPUBuffer* GetVertexBuffer() const override;
         virtual void        SetVertexBuffer(CGPUBuffer* InVertexBuffer) override;
 
+        virtual CGPUBuffer* GetElementBuffer() const override;
+        virtual void        SetElementBuffer(CGPUBuffer* InElementBuffer) override;
+
         virtual void SetupVertexAttributes() override;
 
         
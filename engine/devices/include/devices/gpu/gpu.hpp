@@ -116,6 +116,27 @@ namespace lucid::gpu
 
     void SetLineWidth(const float& InWidth);
 
+    /////////////////////////////////////
+    //             Compute             //
+    /////////////////////////////////////
+
+    enum EMemoryBarrier : u8
+    {
+        SHADER_STORAGE_BARRIER       = 1,
+        COMMAND_BARRIER              = 2,
+        SHADER_IMAGE_ACCESS_BARRIER  = 4,
+        TEXTURE_FETCH_BARRIER        = 8,
+
+        /** Shader writes to persistently mapped buffers become visible to the CPU once a fence issued after the barrier signals */
+        CLIENT_MAPPED_BUFFER_BARRIER = 16
+    };
+
+    /** Runs the compute shader that's currently in use */
+    void DispatchCompute(const u32& InNumGroupsX, const u32& InNumGroupsY = 1, const u32& InNumGroupsZ = 1);
+
+    /** Makes sure that writes done by the previous commands are visible to the commands issued after the barrier */
+    void InsertMemoryBarrier(const EMemoryBarrier& InBarriers);
+
     /////////////////////////////////////
     //              GPU Info           //
     /////////////////////////////////////
@@ -204,6 +225,9 @@ namespace lucid::gpu
         u32 MaxTextureUnits       = 0;
         u32 MaxColorAttachments   = 0;
         u32 UniformBlockAlignment = 0;
+
+        /** GL_ARB_shader_viewport_layer_array or GL_AMD_vertex_shader_viewport_index, vertex shaders can write gl_ViewportIndex */
+        bool bVertexShaderViewportIndex = false;
     };
 
     extern FGPUInfo                GGPUInfo;
@@ -4,7 +4,11 @@ namespace lucid::gpu
 {
     struct FGPUSettings
     {
-        //TODO
+        /**
+         * Uses SDL's offscreen video driver, so the context is created through EGL without a display server, e.x. with Mesa's llvmpipe on a CI box.
+         * SDL_VIDEODRIVER and EGL_PLATFORM set in the environment take precedence.
+         */
+        bool bHeadless = false;
     };
 
     int Init(const FGPUSettings& Setings);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include "common/strings.hpp"
 #include "devices/gpu/buffer.hpp"
 #include "glm/glm.hpp"
@@ -15,6 +17,18 @@ namespace lucid::gpu
         int32_t Index = -1; // Used only for indexed buffers
     };
 
+    /**
+     * Precompiled uniform name. The name is hashed and interned once, when the handle is created, and each shader maps
+     * the handle to the uniform's location the first time it's used with it, so setting a uniform by handle is O(1)
+     * instead of a linear search through the shader's uniforms. The mapping is rebuilt when the shader is hot-reloaded.
+     */
+    struct FUniformHandle
+    {
+        inline bool IsValid() const { return Id != UINT32_MAX; }
+
+        u32 Id = UINT32_MAX;
+    };
+
     class CShader : public CGPUObject
     {
       public:
@@ -30,6 +44,16 @@ namespace lucid::gpu
 
         virtual u32 GetIdForUniform(const FString& InUniformName) const = 0;
 
+        /**
+         * Returns the handle of the uniform with the given name, the same name always gets the same handle.
+         * InArrayIndex >= 0 returns the handle of InName[InArrayIndex]. Handles should be created once, e.g. as statics,
+         * as creating them hashes the name. Main thread only.
+         */
+        static FUniformHandle GetUniformHandle(const char* InName, const i32& InArrayIndex = -1);
+
+        /** Name of the uniform the handle was created for */
+        static const FString& GetUniformHandleName(const FUniformHandle& InHandle);
+
         virtual void SetInt(const FString& InUniformName, const i32& Value) = 0;
         virtual void SetUInt(const FString& InUniformName, const u32& Value) = 0;
         virtual void SetFloat(const FString& InUniformName, const float& Value) = 0;
@@ -47,6 +71,24 @@ namespace lucid::gpu
 
         virtual void UseTexture(const FString& InUniformName, CTexture* TextureToUse) = 0;
         virtual void UseBindlessTexture(const FString& InUniformName, const u64& Value) = 0;
+
+        virtual void SetInt(const FUniformHandle& InUniform, const i32& Value) = 0;
+        virtual void SetUInt(const FUniformHandle& InUniform, const u32& Value) = 0;
+        virtual void SetFloat(const FUniformHandle& InUniform, const float& Value) = 0;
+        virtual void SetBool(const FUniformHandle& InUniform, const bool& Value) = 0;
+
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::vec2& Value) = 0;
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::vec3& Value) = 0;
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::vec4& Value) = 0;
+
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::ivec2& Value) = 0;
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::ivec3& Value) = 0;
+        virtual void SetVector(const FUniformHandle& InUniform, const glm::ivec4& Value) = 0;
+
+        virtual void SetMatrix(const FUniformHandle& InUniform, const glm::mat4& Value) = 0;
+
+        virtual void UseTexture(const FUniformHandle& InUniform, CTexture* TextureToUse) = 0;
+        virtual void UseBindlessTexture(const FUniformHandle& InUniform, const u64& Value) = 0;
         
         virtual void RestoreTextureBindings() = 0;
 
@@ -69,4 +111,6 @@ namespace lucid::gpu
         const FString& InGeometryShaderSource,
         const bool& InWarnMissingUniforms);
 
+    CShader* CompileComputeShaderProgram(const FString& InShaderName, const FString& InComputeShaderSource, const bool& InWarnMissingUniforms);
+
 } // namespace lucid::gpu
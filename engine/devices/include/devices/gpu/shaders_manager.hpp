@@ -27,6 +27,7 @@ namespace lucid::gpu
     private:
         
         CShader* CompileShader(const FShaderInfo& ShaderInfo, const bool& ShouldStoreShader);
+        CShader* CompileComputeShader(const FShaderInfo& ShaderInfo);
         
         FStringHashMap<FShaderInfo>    ShaderInfoByName;
         FStringHashMap<CShader*>       CompiledShadersByName;
@@ -40,6 +40,12 @@ namespace lucid::gpu
 
         virtual void CopyPixels(void* DestBuffer, const u8& MipLevel) const = 0;
 
+        /** Allocates (or regenerates when the base level has data) the whole mip chain of the texture, the texture has to be bound */
+        virtual void GenerateMipMaps() = 0;
+
+        /** Binds a single mip level of the texture to the image unit, so it can be read/written with image load/store operations */
+        virtual void BindAsImage(const u8& InImageUnit, const u8& InMipLevel, const EImageAccess& InAccess) = 0;
+
         /** Bindless texture stuff */
         virtual u64  GetBindlessHandle()               = 0;
         virtual bool IsBindlessTextureResident() const = 0;
@@ -78,6 +84,29 @@ namespace lucid::gpu
                                    const int32_t&             MipMapLevel,
                                    const FString&             InName);
 
+    /**
+     * Creates an immutable texture from a block compressed mip chain. The mips are stored one after another starting with the base level,
+     * each of them takes GetCompressedMipSize() bytes. With a pixel unpack buffer bound InMipData is an offset into it.
+     */
+    CTexture* CreateCompressed2DTexture(const void*                InMipData,
+                                        const u32&                 Width,
+                                        const u32&                 Height,
+                                        const u8&                  InNumMips,
+                                        const ETextureDataFormat&  InDataFormat,
+                                        const ETexturePixelFormat& InPixelFormat,
+                                        const FString&             InName);
+
     u8 GetSizeInBytes(const gpu::ETextureDataType& InType);
     u8 GetNumChannels(const gpu::ETexturePixelFormat& InType);
+
+    bool IsBlockCompressed(const gpu::ETextureDataFormat& InFormat);
+
+    /** Size of a 4x4 block of the compressed format */
+    u8 GetBlockSizeInBytes(const gpu::ETextureDataFormat& InFormat);
+
+    /** Size of a single mip of the given dimensions, partial blocks at the edges take a whole block */
+    u64 GetCompressedMipSize(const gpu::ETextureDataFormat& InFormat, const u32& InWidth, const u32& InHeight);
+
+    /** Number of mips in a full chain down to 1x1 */
+    u8 GetNumMips(const u32& InWidth, const u32& InHeight);
 } // namespace lucid::gpu
\ No newline at end of file
@@ -59,7 +59,24 @@ namespace lucid::gpu
         SRGB,
         SRGBA,
         DEPTH_COMPONENT,
-        DEPTH_STENCIL
+        DEPTH_STENCIL,
+
+        // Block compressed formats, the data is stored as 4x4 texel blocks, see GetCompressedMipSize()
+        BC1,
+        BC1_SRGB,
+        BC3,
+        BC3_SRGB,
+        BC4,
+        BC5,
+        BC7,
+        BC7_SRGB
+    };
+
+    enum class EImageAccess : u8
+    {
+        READ_ONLY,
+        WRITE_ONLY,
+        READ_WRITE
     };
 
     enum class ETexturePixelFormat :  u8
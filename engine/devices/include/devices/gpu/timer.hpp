@@ -12,6 +12,12 @@ namespace lucid::gpu
 
         virtual void StartTimer() = 0;
 
+        /** Stops the timer without waiting for the GPU, timers can overlap and be read once the whole frame is submitted */
+        virtual void StopTimer() = 0;
+
+        /** Waits for the GPU and returns the number of miliseconds that passed between StartTimer() and StopTimer() */
+        virtual float GetElapsedMiliseconds() = 0;
+
         /** Returns the number of miliseconds that passed on the GPU since StartTimer() was called */
         virtual float EndTimer() = 0;
     };
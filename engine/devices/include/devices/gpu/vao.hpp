@@ -40,6 +40,19 @@ namespace lucid::gpu
         PATCHES
     };
 
+    /**
+     * Matches the layout of DrawElementsIndirectCommand. Vertex arrays without an element buffer read it as DrawArraysIndirectCommand,
+     * in which case BaseVertex is interpreted as the base instance and BaseInstance is ignored.
+     */
+    struct FDrawIndirectCommand
+    {
+        u32 Count         = 0;
+        u32 InstanceCount = 0;
+        u32 First         = 0;
+        i32 BaseVertex    = 0;
+        u32 BaseInstance  = 0;
+    };
+
     class CVertexArray : public CGPUObject
     {
       public:
@@ -63,14 +76,24 @@ namespace lucid::gpu
         virtual u32 GetElementCount() const = 0;
 
         // 'First' and 'Count' are 0 by default which basically means 'draw all'
-        virtual void Draw(const u32& First = 0, const u32& Count = 0) = 0;
+        // When the vertex array has an element buffer, 'First' is the first index and 'BaseVertex' is added to the indices read from it
+        virtual void Draw(const u32& First = 0, const u32& Count = 0, const i32& BaseVertex = 0) = 0;
         virtual void DrawInstanced(const u32& InstancesCount,
                                    const u32& First = 0,
                                    const u32& Count = 0) = 0;
 
+        /**
+         * Issues InDrawCount draws using the commands stored in the buffer bound to EBufferBindPoint::DRAW_INDIRECT.
+         * InOffset is the offset of the first command in bytes, InStride is 0 when the commands are tightly packed.
+         */
+        virtual void DrawIndirect(const u32& InDrawCount = 1, const u32& InOffset = 0, const u32& InStride = 0) = 0;
+
         virtual CGPUBuffer* GetVertexBuffer() const = 0;
         virtual void        SetVertexBuffer(CGPUBuffer* InVertexBuffer) = 0;
 
+        virtual CGPUBuffer* GetElementBuffer() const = 0;
+        virtual void        SetElementBuffer(CGPUBuffer* InElementBuffer) = 0;
+
         virtual void SetupVertexAttributes() = 0;
 
         
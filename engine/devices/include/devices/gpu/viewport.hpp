@@ -15,4 +15,11 @@ namespace lucid::gpu
     };
 
     void SetViewport(const FViewport& ViewportToUse);
+
+    /** Sets the viewports selected by gl_ViewportIndex, starting with the first one */
+    void SetViewports(const FViewport* InViewports, const u32& InNumViewports);
+
+    /** Limits rendering and clears to the given rectangle, used e.x. to clear a single tile of a shadow atlas */
+    void EnableScissorTest(const FViewport& InScissorRect);
+    void DisableScissorTest();
 } // namespace lucid::gpu
\ No newline at end of file
@@ -10,7 +10,7 @@
 
 #define AS_GL_BIND_POINT(bindPoint) (GL_BIND_POINTS[((u16)bindPoint) - 1])
 
-static const GLenum GL_BIND_POINTS[] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_COPY_WRITE_BUFFER, GL_UNIFORM_BUFFER, GL_COPY_READ_BUFFER };
+static const GLenum GL_BIND_POINTS[] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_SHADER_STORAGE_BUFFER, GL_COPY_WRITE_BUFFER, GL_UNIFORM_BUFFER, GL_COPY_READ_BUFFER, GL_DRAW_INDIRECT_BUFFER, GL_PIXEL_UNPACK_BUFFER };
 
 static const GLenum GL_MUTABLE_USAGE_HINTS[] = { GL_STREAM_DRAW, GL_STATIC_DRAW, GL_DYNAMIC_DRAW };
 
@@ -196,8 +196,6 @@ namespace lucid::gpu
         glBindBuffer(GL_COPY_WRITE_BUFFER, GLBufferHandle);
         glBufferSubData(GL_COPY_WRITE_BUFFER, Description->Offset, Description->Size, Description->Data);
         glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
-
-        BufferDescription = *Description;
     }
 
     void CGLBuffer::Free()
@@ -259,6 +259,31 @@ namespace lucid::gpu
         glLineWidth(InWidth);
     }
 
+    static const GLbitfield GL_MEMORY_BARRIER_BITS[] = { GL_SHADER_STORAGE_BARRIER_BIT,
+                                                         GL_COMMAND_BARRIER_BIT,
+                                                         GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+                                                         GL_TEXTURE_FETCH_BARRIER_BIT,
+                                                         GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT };
+
+    void DispatchCompute(const u32& InNumGroupsX, const u32& InNumGroupsY, const u32& InNumGroupsZ)
+    {
+        glDispatchCompute(InNumGroupsX, InNumGroupsY, InNumGroupsZ);
+    }
+
+    void InsertMemoryBarrier(const EMemoryBarrier& InBarriers)
+    {
+        GLbitfield GLBarrierBits = 0;
+        for (u8 BarrierBitShift = 0; BarrierBitShift < sizeof(GL_MEMORY_BARRIER_BITS) / sizeof(GLbitfield); ++BarrierBitShift)
+        {
+            if (InBarriers & (1 << BarrierBitShift))
+            {
+                GLBarrierBits |= GL_MEMORY_BARRIER_BITS[BarrierBitShift];
+            }
+        }
+
+        glMemoryBarrier(GLBarrierBits);
+    }
+
     void BindDefaultFramebuffer()
     {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
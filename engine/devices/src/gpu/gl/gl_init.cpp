@@ -1,6 +1,8 @@
 #include "devices/gpu/init.hpp"
 #include "devices/gpu/gpu.hpp"
 
+#include <cstring>
+
 #include "glad/glad.h"
 #include "SDL2/SDL.h"
 
@@ -16,6 +18,12 @@ namespace lucid::gpu
     {
         LUCID_LOG(ELogLevel::INFO, "Initializing GPU...");
 
+        if (Setings.bHeadless)
+        {
+            SDL_setenv("SDL_VIDEODRIVER", "offscreen", 0);
+            SDL_setenv("EGL_PLATFORM", "surfaceless", 0);
+        }
+
         int SDLInitResult = SDL_Init(SDL_INIT_VIDEO);
         if (SDLInitResult != 0)
         {
@@ -32,7 +40,7 @@ namespace lucid::gpu
         SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
         SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
 
-        SDL_Window* window = SDL_CreateWindow("xxx", 200, 200, 200, 200, SDL_WINDOW_OPENGL | SDL_WINDOW_ALLOW_HIGHDPI);
+        SDL_Window* window = SDL_CreateWindow("xxx", 200, 200, 200, 200, SDL_WINDOW_OPENGL | SDL_WINDOW_ALLOW_HIGHDPI | SDL_WINDOW_HIDDEN);
         if (window == nullptr)
         {
             LUCID_LOG(ELogLevel::ERR, "[SDL] Failed to create dummy window: %s", SDL_GetError());
@@ -94,6 +102,17 @@ namespace lucid::gpu
         glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &property);
         LUCID_LOG(ELogLevel::INFO, "Uniform block alignment = %d", property);
         GGPUInfo.UniformBlockAlignment = property;
+
+        glGetIntegerv(GL_NUM_EXTENSIONS, &property);
+        for (GLint i = 0; i < property; ++i)
+        {
+            const char* Extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+            if (strcmp(Extension, "GL_ARB_shader_viewport_layer_array") == 0 || strcmp(Extension, "GL_AMD_vertex_shader_viewport_index") == 0)
+            {
+                GGPUInfo.bVertexShaderViewportIndex = true;
+            }
+        }
+        LUCID_LOG(ELogLevel::INFO, "Vertex shader viewport index = %d", GGPUInfo.bVertexShaderViewportIndex);
     }
 
     void Shutdown() { SDL_Quit(); }
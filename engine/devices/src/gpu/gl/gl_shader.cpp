@@ -21,12 +21,14 @@ namespace lucid::gpu
     const u8 _GL_VERTEX_SHADER = 1;
     const u8 _GL_FRAGMENT_SHADER = 2;
     const u8 _GL_GEOMETRY_SHADER = 3;
+    const u8 _GL_COMPUTE_SHADER = 4;
 
     const u8 MAX_UNIFORM_VARIABLE_NAME_LENGTH = 255;
 
     static const char VERTEX_SHADER_TYPE_NAME[] = "vertex";
     static const char GEOMETRY_SHADER_TYPE_NAME[] = "geometry";
     static const char FRAGMENT_SHADER_TYPE_NAME[] = "fragment";
+    static const char COMPUTE_SHADER_TYPE_NAME[] = "compute";
 
 #ifndef NDEBUG
     static char _infoLog[5096];
@@ -71,6 +73,8 @@ namespace lucid::gpu
         glAttachShader(ShaderProgramID, ShaderID);
     }
 
+    static CShader* CreateShaderFromLinkedProgram(const FString& InShaderName, const GLuint& ShaderProgramID, const bool& InWarnMissingUniforms);
+
     CShader* CompileShaderProgram(
         const FString& InShaderName,
         const FString& InVertexShaderSource,
@@ -107,6 +111,29 @@ namespace lucid::gpu
             glDeleteShader(GeometryShader);            
         }
 
+        return CreateShaderFromLinkedProgram(InShaderName, ShaderProgramID, InWarnMissingUniforms);
+    }
+
+    CShader* CompileComputeShaderProgram(const FString& InShaderName, const FString& InComputeShaderSource, const bool& InWarnMissingUniforms)
+    {
+        GLuint ShaderProgramID = glCreateProgram();
+        GLuint ComputeShader = glCreateShader(GL_COMPUTE_SHADER);
+
+        CompileShader(InShaderName, ShaderProgramID, ComputeShader, *InComputeShaderSource, _GL_COMPUTE_SHADER, COMPUTE_SHADER_TYPE_NAME);
+
+        glLinkProgram(ShaderProgramID);
+
+#ifndef NDEBUG
+        CheckCompileErrors(InShaderName, ShaderProgramID, _GL_PROGRAM, "");
+#endif
+
+        glDeleteShader(ComputeShader);
+
+        return CreateShaderFromLinkedProgram(InShaderName, ShaderProgramID, InWarnMissingUniforms);
+    }
+
+    static CShader* CreateShaderFromLinkedProgram(const FString& InShaderName, const GLuint& ShaderProgramID, const bool& InWarnMissingUniforms)
+    {
         GLint numberOfUniforms;
         glGetProgramiv(ShaderProgramID, GL_ACTIVE_UNIFORMS, &numberOfUniforms);
 
@@ -393,6 +420,191 @@ namespace lucid::gpu
         }
     }
 
+    const FUniformHandleMapping& CGLShader::GetHandleMapping(const FUniformHandle& InUniform)
+    {
+        assert(InUniform.IsValid());
+
+        if (InUniform.Id >= HandleMappings.size())
+        {
+            HandleMappings.resize(InUniform.Id + 1);
+        }
+
+        FUniformHandleMapping& Mapping = HandleMappings[InUniform.Id];
+        if (!Mapping.bResolved)
+        {
+            const FString& UniformName = GetUniformHandleName(InUniform);
+            Mapping.UniformIndex       = GetIdForUniform(UniformName);
+            Mapping.TextureIndex       = GetTextureId(UniformName);
+            Mapping.bResolved          = true;
+        }
+        return Mapping;
+    }
+
+    GLint CGLShader::GetHandleLocation(const FUniformHandle& InUniform)
+    {
+        const FUniformHandleMapping& Mapping = GetHandleMapping(InUniform);
+        if (Mapping.UniformIndex < uniformVariables.GetLength())
+        {
+            return uniformVariables[Mapping.UniformIndex]->Location;
+        }
+        if (Mapping.TextureIndex < TextureBindings.GetLength())
+        {
+            return TextureBindings[Mapping.TextureIndex]->Location;
+        }
+        return -1;
+    }
+
+    void CGLShader::SetInt(const FUniformHandle& InUniform, const i32& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform1i(Location, Value);
+        }
+    }
+
+    void CGLShader::SetUInt(const FUniformHandle& InUniform, const u32& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform1ui(Location, Value);
+        }
+    }
+
+    void CGLShader::SetFloat(const FUniformHandle& InUniform, const float& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform1f(Location, Value);
+        }
+    }
+
+    void CGLShader::SetBool(const FUniformHandle& InUniform, const bool& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform1i(Location, Value);
+        }
+    }
+
+    void CGLShader::SetVector(const FUniformHandle& InUniform, const glm::vec2& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform2fv(Location, 1, &Value[0]);
+        }
+    }
+
+    void CGLShader::SetVector(const FUniformHandle& InUniform, const glm::vec3& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform3fv(Location, 1, &Value[0]);
+        }
+    }
+
+    void CGLShader::SetVector(const FUniformHandle& InUniform, const glm::vec4& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform4fv(Location, 1, &Value[0]);
+        }
+    }
+
+    void CGLShader::SetVector(const FUniformHandle& InUniform, const glm::ivec2& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform2iv(Location, 1, &Value[0]);
+        }
+    }
+
+    void CGLShader::SetVector(const FUniformHandle& InUniform, const glm::ivec3& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform3iv(Location, 1, &Value[0]);
+        }
+    }
+
+    void CGLShader::SetVector(const FUniformHandle& InUniform, const glm::ivec4& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniform4iv(Location, 1, &Value[0]);
+        }
+    }
+
+    void CGLShader::SetMatrix(const FUniformHandle& InUniform, const glm::mat4& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const GLint Location = GetHandleLocation(InUniform);
+
+        if (Location >= 0)
+        {
+            glUniformMatrix4fv(Location, 1, GL_FALSE, &Value[0][0]);
+        }
+    }
+
+    void CGLShader::UseTexture(const FUniformHandle& InUniform, CTexture* TextureToUse)
+    {
+        assert(GGPUState->Shader == this);
+        const FUniformHandleMapping& Mapping = GetHandleMapping(InUniform);
+
+        if (Mapping.TextureIndex >= TextureBindings.GetLength())
+        {
+            return;
+        }
+
+        FTextureBinding* Binding = TextureBindings[Mapping.TextureIndex];
+        Binding->BoundTexture    = TextureToUse;
+
+        gpu::GGPUInfo.ActiveTextureUnit = Binding->TextureIndex;
+        glActiveTexture(GL_TEXTURE0 + Binding->TextureIndex);
+        TextureToUse->Bind();
+        glUniform1i(Binding->Location, Binding->TextureIndex);
+    }
+
+    void CGLShader::UseBindlessTexture(const FUniformHandle& InUniform, const u64& Value)
+    {
+        assert(GGPUState->Shader == this);
+        const FUniformHandleMapping& Mapping = GetHandleMapping(InUniform);
+
+        if (Mapping.TextureIndex < TextureBindings.GetLength())
+        {
+            glUniformHandleui64ARB(TextureBindings[Mapping.TextureIndex]->Location, Value);
+        }
+    }
+
     void CGLShader::RestoreTextureBindings()
     {
         assert(GGPUState->Shader == this);
@@ -540,6 +752,9 @@ namespace lucid::gpu
         TextureBindings.Free();
         TextureBindings = GLRecompiledShader->TextureBindings;
 
+        // Uniform indices changed, the handles are mapped again on their next use
+        HandleMappings.clear();
+
         RestoreTextureBindings();
         // Restore the currently bound shader's state
         if (CurrentShader)
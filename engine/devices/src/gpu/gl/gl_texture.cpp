@@ -16,6 +16,8 @@
 
 namespace lucid::gpu
 {
+    static const GLenum GL_IMAGE_ACCESS_MAPPING[] = { GL_READ_ONLY, GL_WRITE_ONLY, GL_READ_WRITE };
+
     // Texture
     static GLuint CreateGLTexture(const ETextureType& TextureType,
                                   const GLint&        MipMapLevel,
@@ -124,6 +126,58 @@ namespace lucid::gpu
         return GLTexture;
     }
 
+    CTexture* CreateCompressed2DTexture(const void*                InMipData,
+                                        const u32&                 Width,
+                                        const u32&                 Height,
+                                        const u8&                  InNumMips,
+                                        const ETextureDataFormat&  InDataFormat,
+                                        const ETexturePixelFormat& InPixelFormat,
+                                        const FString&             InName)
+    {
+        assert(IsBlockCompressed(InDataFormat));
+
+        const GLenum GLDataFormat = TO_GL_TEXTURE_DATA_FORMAT(InDataFormat);
+
+        GLuint GLTextureHandle;
+        glGenTextures(1, &GLTextureHandle);
+        glBindTexture(GL_TEXTURE_2D, GLTextureHandle);
+
+        // Immutable storage for the whole chain, the mips are precomputed so there's no glGenerateMipmap()
+        glTexStorage2D(GL_TEXTURE_2D, InNumMips, GLDataFormat, Width, Height);
+
+        u64 MipOffset = 0;
+        for (u8 MipLevel = 0; MipLevel < InNumMips; ++MipLevel)
+        {
+            const u32 MipWidth  = glm::max(Width >> MipLevel, 1u);
+            const u32 MipHeight = glm::max(Height >> MipLevel, 1u);
+            const u64 MipSize   = GetCompressedMipSize(InDataFormat, MipWidth, MipHeight);
+
+            glCompressedTexSubImage2D(
+              GL_TEXTURE_2D, MipLevel, 0, 0, MipWidth, MipHeight, GLDataFormat, (GLsizei)MipSize, (const char*)InMipData + MipOffset);
+            MipOffset += MipSize;
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // Reading it back decompresses it to the pixel format
+        auto* GLTexture = new CGLTexture(GLTextureHandle,
+                                         GL_TEXTURE_2D,
+                                         Width,
+                                         Height,
+                                         InName,
+                                         TO_GL_TEXTURE_PIXEL_FORMAT(InPixelFormat),
+                                         GL_UNSIGNED_BYTE,
+                                         MipOffset,
+                                         ETextureDataType::UNSIGNED_BYTE,
+                                         InDataFormat,
+                                         InPixelFormat);
+        GLTexture->SetObjectName();
+        return GLTexture;
+    }
+
     CGLTexture::CGLTexture(const GLuint&              InGLTextureID,
                            const GLenum&              InGLTextureTarget,
                            const u32&                 InWidth,
@@ -185,7 +239,7 @@ namespace lucid::gpu
     void CGLTexture::CopyPixels(void* DestBuffer, const u8& MipLevel) const
     {
         assert(GGPUState->BoundTextures[gpu::GGPUInfo.ActiveTextureUnit] == this);
-        glGetTexImage(GL_TEXTURE_2D, 0, GLPixelFormat, GLTextureDataType, DestBuffer);
+        glGetTexImage(GL_TEXTURE_2D, MipLevel, GLPixelFormat, GLTextureDataType, DestBuffer);
     }
 
     u64 CGLTexture::GetBindlessHandle()
@@ -244,6 +298,23 @@ namespace lucid::gpu
         glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, &InColor.r);
     }
 
+    void CGLTexture::GenerateMipMaps()
+    {
+        assert(GGPUState->BoundTextures[gpu::GGPUInfo.ActiveTextureUnit] == this);
+        glGenerateMipmap(GLTextureTarget);
+    }
+
+    void CGLTexture::BindAsImage(const u8& InImageUnit, const u8& InMipLevel, const EImageAccess& InAccess)
+    {
+        glBindImageTexture(InImageUnit,
+                           GLTextureHandle,
+                           InMipLevel,
+                           GL_FALSE,
+                           0,
+                           GL_IMAGE_ACCESS_MAPPING[static_cast<u8>(InAccess)],
+                           TO_GL_TEXTURE_DATA_FORMAT(TextureDataFormat));
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     // Cubemap
@@ -271,6 +342,20 @@ namespace lucid::gpu
 
         for (int i = 0; i < 6; ++i)
         {
+            // Imported faces are block compressed, the cubemap is sampled with NEAREST so the base level is enough
+            if (FaceTextures && FaceTextures[i] && IsBlockCompressed(FaceTextures[i]->DataFormat))
+            {
+                glCompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
+                                       0,
+                                       TO_GL_TEXTURE_DATA_FORMAT(FaceTextures[i]->DataFormat),
+                                       FaceTextures[i]->Width,
+                                       FaceTextures[i]->Height,
+                                       0,
+                                       (GLsizei)GetCompressedMipSize(FaceTextures[i]->DataFormat, FaceTextures[i]->Width, FaceTextures[i]->Height),
+                                       FaceTextures[i]->TextureData);
+                continue;
+            }
+
             glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
                          0,
                          GLDataFormat,
@@ -327,24 +412,34 @@ namespace lucid::gpu
 
     u64 CGLCubemap::GetBindlessHandle()
     {
-        assert(0); // not implemented
-        return 0;
+        if (GLBindlessHandle == 0)
+        {
+            GLBindlessHandle = glGetTextureHandleARB(glCubemapHandle);
+            assert(GLBindlessHandle);
+        }
+        return GLBindlessHandle;
     }
 
-    bool CGLCubemap::IsBindlessTextureResident() const
-    {
-        assert(0); // not implemented
-        return false;
-    }
+    bool CGLCubemap::IsBindlessTextureResident() const { return bBindlessTextureResident; }
 
     void CGLCubemap::MakeBindlessResident()
     {
-        assert(0); // not implemented
+        assert(GLBindlessHandle);
+        if (!bBindlessTextureResident)
+        {
+            bBindlessTextureResident = true;
+            glMakeTextureHandleResidentARB(GLBindlessHandle);
+        }
     }
 
     void CGLCubemap::MakeBindlessNonResident()
     {
-        assert(0); // not implemented
+        assert(GLBindlessHandle);
+        if (bBindlessTextureResident)
+        {
+            bBindlessTextureResident = false;
+            glMakeTextureHandleNonResidentARB(GLBindlessHandle);
+        }
     }
 
     void CGLCubemap::AttachAsStencil() { glFramebufferTexture(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, glCubemapHandle, 0); }
@@ -414,4 +509,22 @@ namespace lucid::gpu
         glTexParameterfv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BORDER_COLOR, &InColor.r);
     }
 
+    void CGLCubemap::GenerateMipMaps()
+    {
+        assert(GGPUState->Cubemap == this);
+        glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+    }
+
+    void CGLCubemap::BindAsImage(const u8& InImageUnit, const u8& InMipLevel, const EImageAccess& InAccess)
+    {
+        // Binds all of the faces, they're accessed as layers of the image in the shader
+        glBindImageTexture(InImageUnit,
+                           glCubemapHandle,
+                           InMipLevel,
+                           GL_TRUE,
+                           0,
+                           GL_IMAGE_ACCESS_MAPPING[static_cast<u8>(InAccess)],
+                           TO_GL_TEXTURE_DATA_FORMAT(TextureDataFormat));
+    }
+
 } // namespace lucid::gpu
\ No newline at end of file
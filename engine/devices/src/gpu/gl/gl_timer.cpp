@@ -4,49 +4,64 @@
 
 namespace lucid::gpu
 {
-    CGLTimer::CGLTimer(const FString& InName, const GLuint& InGLTimerQueryHandle) : CTimer(InName), GLTimerQueryHandle(InGLTimerQueryHandle) {}
+    CGLTimer::CGLTimer(const FString& InName, const GLuint& InGLStartQueryHandle, const GLuint& InGLEndQueryHandle)
+    : CTimer(InName), GLStartQueryHandle(InGLStartQueryHandle), GLEndQueryHandle(InGLEndQueryHandle)
+    {
+    }
 
     void CGLTimer::StartTimer()
     {
         assert(!bStarted);
 
-        bStarted     = true;
-        bStopped     = false;
-        
-        GLSyncHandle = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); // ensure that all prior commands have been executed
+        bStarted = true;
+        bStopped = false;
 
-        glBeginQuery(GL_TIME_ELAPSED, GLTimerQueryHandle);
+        glQueryCounter(GLStartQueryHandle, GL_TIMESTAMP);
     };
 
-    float CGLTimer::EndTimer()
+    void CGLTimer::StopTimer()
     {
         assert(bStarted && !bStopped);
 
         bStopped = true;
         bStarted = false;
 
-        glEndQuery(GL_TIME_ELAPSED);
-        GLuint64 TimerResult;
-        glGetQueryObjectui64v(GLTimerQueryHandle, GL_QUERY_RESULT, &TimerResult);
-        glDeleteSync(GLSyncHandle);
+        glQueryCounter(GLEndQueryHandle, GL_TIMESTAMP);
+    }
+
+    float CGLTimer::GetElapsedMiliseconds()
+    {
+        assert(bStopped);
 
-        return float(TimerResult) / 1e06;
+        // The end timestamp is written after the start one, so once it's available both are
+        GLuint64 StartTimestamp, EndTimestamp;
+        glGetQueryObjectui64v(GLEndQueryHandle, GL_QUERY_RESULT, &EndTimestamp);
+        glGetQueryObjectui64v(GLStartQueryHandle, GL_QUERY_RESULT, &StartTimestamp);
+
+        return float(EndTimestamp - StartTimestamp) / 1e06;
+    }
+
+    float CGLTimer::EndTimer()
+    {
+        StopTimer();
+        return GetElapsedMiliseconds();
     };
 
     void CGLTimer::Free()
     {
-        assert(GLTimerQueryHandle && bStopped);
-        glDeleteQueries(1, &GLTimerQueryHandle);
-        GLTimerQueryHandle = 0;
+        assert(GLStartQueryHandle && !bStarted);
+        glDeleteQueries(1, &GLStartQueryHandle);
+        glDeleteQueries(1, &GLEndQueryHandle);
+        GLStartQueryHandle = GLEndQueryHandle = 0;
     }
 
-    void CGLTimer::SetObjectName() { SetGLObjectName(GL_QUERY, GLTimerQueryHandle, Name); }
+    void CGLTimer::SetObjectName() { SetGLObjectName(GL_QUERY, GLStartQueryHandle, Name); }
 
     CTimer* CreateTimer(const FString& InName)
     {
-        GLuint TimerQuery;
-        glGenQueries(1, &TimerQuery);
-        assert(TimerQuery);
-        return new CGLTimer(InName, TimerQuery);
+        GLuint TimerQueries[2];
+        glGenQueries(2, TimerQueries);
+        assert(TimerQueries[0] && TimerQueries[1]);
+        return new CGLTimer(InName, TimerQueries[0], TimerQueries[1]);
     }
-} // namespace lucid::gpu
\ No newline at end of file
+} // namespace lucid::gpu
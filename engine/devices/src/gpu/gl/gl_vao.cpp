@@ -158,7 +158,7 @@ namespace lucid::gpu
 
     void CGLVertexArray::DisableAttribute(const u32& AttributeIndex) { glDisableVertexArrayAttrib(GLVAOHandle, AttributeIndex); }
 
-    void CGLVertexArray::Draw(const u32& First, const u32& Count)
+    void CGLVertexArray::Draw(const u32& First, const u32& Count, const i32& BaseVertex)
     {
         assert(GGPUState->VAO == this);
         u32 count = Count == 0 ? (ElementBuffer == nullptr ? VertexCount : ElementCount) : Count;
@@ -169,7 +169,7 @@ namespace lucid::gpu
 
         if (ElementBuffer)
         {
-            glDrawElements(GL_DRAW_MODES[DrawMode], count, GL_UNSIGNED_INT, 0);
+            glDrawElementsBaseVertex(GL_DRAW_MODES[DrawMode], count, GL_UNSIGNED_INT, (void*)(First * sizeof(u32)), BaseVertex);
         }
         else
         {
@@ -193,6 +193,26 @@ namespace lucid::gpu
         }
     }
 
+#ifdef LINUX
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wint-to-pointer-cast"
+#endif
+    void CGLVertexArray::DrawIndirect(const u32& InDrawCount, const u32& InOffset, const u32& InStride)
+    {
+        assert(GGPUState->VAO == this);
+        ++scene::GRenderStats.NumDrawCalls;
+
+        if (ElementBuffer)
+        {
+            glMultiDrawElementsIndirect(GL_DRAW_MODES[DrawMode], GL_UNSIGNED_INT, (void*)InOffset, InDrawCount, InStride);
+        }
+        else
+        {
+            glMultiDrawArraysIndirect(GL_DRAW_MODES[DrawMode], (void*)InOffset, InDrawCount, InStride);
+        }
+    }
+#pragma GCC diagnostic pop
+
     CGPUBuffer* CGLVertexArray::GetVertexBuffer() const
     {
         return VertexBuffer;
@@ -206,6 +226,19 @@ namespace lucid::gpu
         VertexBuffer = InVertexBuffer;
     }
 
+    CGPUBuffer* CGLVertexArray::GetElementBuffer() const
+    {
+        return ElementBuffer;
+    }
+
+    void CGLVertexArray::SetElementBuffer(CGPUBuffer* InElementBuffer)
+    {
+        // The element buffer binding is part of the vertex array's state
+        Bind();
+        InElementBuffer->Bind(EBufferBindPoint::ELEMENT);
+        ElementBuffer = InElementBuffer;
+    }
+
     void CGLVertexArray::SetupVertexAttributes()
     {
         for (u32 i = 0; i < VertexAttributes.GetLength(); ++i)
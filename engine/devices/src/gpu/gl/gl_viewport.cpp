@@ -1,5 +1,7 @@
 #include "devices/gpu/viewport.hpp"
 
+#include <cassert>
+
 #include "glad/glad.h"
 
 namespace lucid::gpu
@@ -8,4 +10,28 @@ namespace lucid::gpu
     {
         glViewport(ViewportToUse.X, ViewportToUse.Y, ViewportToUse.Width, ViewportToUse.Height);
     }
+
+    void SetViewports(const FViewport* InViewports, const u32& InNumViewports)
+    {
+        GLfloat Viewports[16 * 4];
+        assert(InNumViewports <= 16);
+
+        for (u32 i = 0; i < InNumViewports; ++i)
+        {
+            Viewports[(i * 4) + 0] = InViewports[i].X;
+            Viewports[(i * 4) + 1] = InViewports[i].Y;
+            Viewports[(i * 4) + 2] = InViewports[i].Width;
+            Viewports[(i * 4) + 3] = InViewports[i].Height;
+        }
+
+        glViewportArrayv(0, InNumViewports, Viewports);
+    }
+
+    void EnableScissorTest(const FViewport& InScissorRect)
+    {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(InScissorRect.X, InScissorRect.Y, InScissorRect.Width, InScissorRect.Height);
+    }
+
+    void DisableScissorTest() { glDisable(GL_SCISSOR_TEST); }
 } // namespace lucid::gpu
\ No newline at end of file
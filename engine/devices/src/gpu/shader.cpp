@@ -0,0 +1,47 @@
+#include "devices/gpu/shader.hpp"
+
+#include <cassert>
+#include <unordered_map>
+#include <vector>
+
+namespace lucid::gpu
+{
+    /** Interned names of the uniform handles, the id of a handle is the index of it's name */
+    struct FUniformHandleRegistry
+    {
+        std::unordered_map<THash, u32> IdByHash;
+        std::vector<FDString>          Names;
+    };
+
+    /** Function local, so handles can be created by statics in other translation units */
+    static FUniformHandleRegistry& GetUniformHandleRegistry()
+    {
+        static FUniformHandleRegistry Registry;
+        return Registry;
+    }
+
+    FUniformHandle CShader::GetUniformHandle(const char* InName, const i32& InArrayIndex)
+    {
+        FDString Name = InArrayIndex < 0 ? CopyToString(InName) : SPrintf("%s[%d]", InName, InArrayIndex);
+
+        FUniformHandleRegistry& Registry = GetUniformHandleRegistry();
+        const auto              It       = Registry.IdByHash.find(Name.GetHash());
+        if (It != Registry.IdByHash.end())
+        {
+            Name.Free();
+            return FUniformHandle{ It->second };
+        }
+
+        const FUniformHandle Handle{ (u32)Registry.Names.size() };
+        Registry.IdByHash[Name.GetHash()] = Handle.Id;
+        Registry.Names.push_back(Name);
+        return Handle;
+    }
+
+    const FString& CShader::GetUniformHandleName(const FUniformHandle& InHandle)
+    {
+        FUniformHandleRegistry& Registry = GetUniformHandleRegistry();
+        assert(InHandle.Id < Registry.Names.size());
+        return Registry.Names[InHandle.Id];
+    }
+} // namespace lucid::gpu
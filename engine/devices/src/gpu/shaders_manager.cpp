@@ -10,8 +10,34 @@ namespace lucid::gpu
 {
     void ReloadShaders();
 
+    CShader* CShadersManager::CompileComputeShader(const FShaderInfo& ShaderInfo)
+    {
+        FDString ComputeShaderSource = platform::ReadFile(*ShaderInfo.ComputeShaderSourcePath, true);
+        if (ComputeShaderSource.GetLength() == 0)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Failed to read compute shader source from file %s while compiling shader '%s'",
+                      *ShaderInfo.ComputeShaderSourcePath, *ShaderInfo.Name);
+            return nullptr;
+        }
+
+        CShader* CompiledShader = gpu::CompileComputeShaderProgram(ShaderInfo.Name, ComputeShaderSource, false);
+        ComputeShaderSource.Free();
+        return CompiledShader;
+    }
+
     CShader* CShadersManager::CompileShader(const FShaderInfo& ShaderInfo, const bool& ShouldStoreShader)
     {
+        if (ShaderInfo.ComputeShaderSourcePath.GetLength())
+        {
+            CShader* CompiledShader = CompileComputeShader(ShaderInfo);
+            if (CompiledShader && ShouldStoreShader)
+            {
+                ShaderInfoByName.Add(*ShaderInfo.Name, ShaderInfo);
+                CompiledShadersByName.Add(*ShaderInfo.Name, CompiledShader);
+            }
+            return CompiledShader;
+        }
+
         FDString VertexShaderSource = platform::ReadFile(*ShaderInfo.VertexShaderSourcePath, true);
         FDString FragmentShaderSource = platform::ReadFile(*ShaderInfo.FragmentShaderSourcePath, true);
 
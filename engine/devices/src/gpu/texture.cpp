@@ -43,4 +43,45 @@ namespace lucid::gpu
         }
     }
 
+    bool IsBlockCompressed(const gpu::ETextureDataFormat& InFormat) { return InFormat >= ETextureDataFormat::BC1; }
+
+    u8 GetBlockSizeInBytes(const gpu::ETextureDataFormat& InFormat)
+    {
+        switch (InFormat)
+        {
+        case ETextureDataFormat::BC1:
+        case ETextureDataFormat::BC1_SRGB:
+        case ETextureDataFormat::BC4:
+            return 8;
+        case ETextureDataFormat::BC3:
+        case ETextureDataFormat::BC3_SRGB:
+        case ETextureDataFormat::BC5:
+        case ETextureDataFormat::BC7:
+        case ETextureDataFormat::BC7_SRGB:
+            return 16;
+        default:
+            assert(0);
+            return 0;
+        }
+    }
+
+    u64 GetCompressedMipSize(const gpu::ETextureDataFormat& InFormat, const u32& InWidth, const u32& InHeight)
+    {
+        const u64 NumBlocksX = (InWidth + 3) / 4;
+        const u64 NumBlocksY = (InHeight + 3) / 4;
+        return NumBlocksX * NumBlocksY * GetBlockSizeInBytes(InFormat);
+    }
+
+    u8 GetNumMips(const u32& InWidth, const u32& InHeight)
+    {
+        u32 Size    = InWidth > InHeight ? InWidth : InHeight;
+        u8  NumMips = 1;
+        while (Size > 1)
+        {
+            Size >>= 1;
+            ++NumMips;
+        }
+        return NumMips;
+    }
+
 } // namespace lucid::gpu
@@ -1,9 +1,11 @@
 ﻿#include "engine/engine.hpp"
+#include "common/arena.hpp"
 
 #include "stb_init.hpp"
 #include "devices/gpu/init.hpp"
 #include "devices/gpu/shaders_manager.hpp"
 #include "misc/actor_thumbs.hpp"
+#include "resources/asset_archive.hpp"
 
 #include "scene/blinn_phong_material.hpp"
 #include "scene/terrain_material.hpp"
@@ -26,6 +28,12 @@ namespace lucid
 {
 
     CEngine          GEngine;
+
+    static const FSString ASSET_ARCHIVE_PATH{ "assets/assets.lpak" };
+
+    /** Archive cooked while resources from the current one were loaded, it replaces the current one on the next start */
+    static const FSString PENDING_ASSET_ARCHIVE_PATH{ "assets/assets.lpak.pending" };
+
     EEngineInitError CEngine::InitEngine(const FEngineConfig& InEngineConfig)
     {
         srand(time(NULL));
@@ -34,7 +42,10 @@ namespace lucid
         resources::InitTextures();
 
         // Init GPU
-        if (gpu::Init({}) < 0)
+        gpu::FGPUSettings GPUSettings;
+        GPUSettings.bHeadless = InEngineConfig.bHeadless;
+
+        if (gpu::Init(GPUSettings) < 0)
         {
             return EEngineInitError::GPU_INIT_ERROR;
         }
@@ -52,8 +63,17 @@ namespace lucid
         ForwardRenderer->ResultResolution = { 1920, 1080 };
         Renderer                          = ForwardRenderer;
 
+        // Workers read the resources acquired asynchronously, the streamer uploads them at the beginning of the frame
+        JobSystem.Init();
+        ResourceStreamer.Setup();
+
+        // Streams the mips of the resident textures based on the feedback from the renderer
+        TextureStreamer.Setup();
+
         EngineObjects.Add(&MeshesHolder);
         EngineObjects.Add(&TexturesHolder);
+        EngineObjects.Add(&ResourceStreamer);
+        EngineObjects.Add(&TextureStreamer);
 
         return EEngineInitError::NONE;
     }
@@ -71,25 +91,45 @@ namespace lucid
         // Read resource database
         ReadFromJSONFile(ResourceDatabase, "assets/databases/resources.json");
 
+        // Resources cooked into the asset archive are created from it's table of contents,
+        // so we don't have to open their files one by one. The rest was imported after the last cook.
+        if (platform::RenameFile(*PENDING_ASSET_ARCHIVE_PATH, *ASSET_ARCHIVE_PATH))
+        {
+            LUCID_LOG(ELogLevel::INFO, "Replaced %s with the archive cooked in the last session", *ASSET_ARCHIVE_PATH);
+        }
+
+        FHashMap<UUID, resources::CResource*> PackedResourcesById;
+        bAssetArchiveLoaded = resources::LoadAssetArchive(ASSET_ARCHIVE_PATH, PackedResourcesById);
+
         // Load resources data
         for (const FResourceDatabaseEntry& Entry : ResourceDatabase.Entries)
         {
+            resources::CResource* PackedResource = nullptr;
+            if (PackedResourcesById.Contains(Entry.Id) && !Entry.bSavedAfterCook)
+            {
+                PackedResource = PackedResourcesById.Get(Entry.Id);
+                PackedResourcesById.Remove(Entry.Id);
+            }
+
             switch (Entry.Type)
             {
             case resources::MESH:
             {
-                if (resources::CMeshResource* LoadedMesh = resources::LoadMesh(Entry.Path))
+                resources::CMeshResource* LoadedMesh = PackedResource ? (resources::CMeshResource*)PackedResource : resources::LoadMesh(Entry.Path);
+                if (LoadedMesh)
                 {
                     GEngine.GetMeshesHolder().Add(Entry.Id, LoadedMesh);
 
                     LoadedMesh->LoadThumbnail();
-                    if (!LoadedMesh->GetThumbnail())
+                    if (!LoadedMesh->GetThumbnail() && !LoadedMesh->IsPacked())
                     {
                         LoadedMesh->MakeThumbnail();
                     }
 
                     if (Entry.bIsDefault)
                     {
+                        // Drawn in place of the meshes that are still streaming in, so it has to stay resident
+                        LoadedMesh->Acquire(false, true);
                         GEngine.GetMeshesHolder().SetDefaultResource(LoadedMesh);
                     }
                 }
@@ -97,14 +137,20 @@ namespace lucid
             }
             case resources::TEXTURE:
             {
-                if (resources::CTextureResource* LoadedTexture = resources::LoadTexture(Entry.Path))
+                resources::CTextureResource* LoadedTexture =
+                  PackedResource ? (resources::CTextureResource*)PackedResource : resources::LoadTexture(Entry.Path);
+                if (LoadedTexture)
                 {
                     GEngine.GetTexturesHolder().Add(Entry.Id, LoadedTexture);
 
-                    LoadedTexture->LoadThumbnail();
-                    if (!LoadedTexture->GetThumbnail())
+                    // Packed resources come with their thumbnails
+                    if (!LoadedTexture->IsPacked())
                     {
-                        LoadedTexture->MakeThumbnail();
+                        LoadedTexture->LoadThumbnail();
+                        if (!LoadedTexture->GetThumbnail())
+                        {
+                            LoadedTexture->MakeThumbnail();
+                        }
                     }
 
                     if (Entry.bIsDefault)
@@ -117,6 +163,13 @@ namespace lucid
             }
         }
 
+        // Resources that were removed from the database since the last cook
+        for (u32 i = 0; i < PackedResourcesById.GetLength(); ++i)
+        {
+            delete PackedResourcesById.GetByIndex(i);
+        }
+        PackedResourcesById.FreeAll();
+
         // Load materials database
         ReadFromJSONFile(MaterialDatabase, "assets/databases/materials.json");
 
@@ -336,7 +389,7 @@ namespace lucid
         Renderer->Setup();
     }
 
-    void CEngine::AddTextureResource(resources::CTextureResource* InTexture)
+    void CEngine::AddTextureResource(resources::CTextureResource* InTexture, const bool& InbSaveDatabase)
     {
         FResourceDatabaseEntry Entry;
         Entry.Id         = InTexture->GetID();
@@ -346,10 +399,13 @@ namespace lucid
         Entry.bIsDefault = false;
         ResourceDatabase.Entries.push_back(Entry);
         TexturesHolder.Add(InTexture->GetID(), InTexture);
-        WriteToJSONFile(ResourceDatabase, "assets/databases/resources.json");
+        if (InbSaveDatabase)
+        {
+            SaveResourceDatabase();
+        }
     }
 
-    void CEngine::AddMeshResource(resources::CMeshResource* InMesh)
+    void CEngine::AddMeshResource(resources::CMeshResource* InMesh, const bool& InbSaveDatabase)
     {
         FResourceDatabaseEntry Entry;
         Entry.Id         = InMesh->GetID();
@@ -359,9 +415,14 @@ namespace lucid
         Entry.bIsDefault = false;
         ResourceDatabase.Entries.push_back(Entry);
         MeshesHolder.Add(InMesh->GetID(), InMesh);
-        WriteToJSONFile(GEngine.GetResourceDatabase(), "assets/databases/resources.json");
+        if (InbSaveDatabase)
+        {
+            SaveResourceDatabase();
+        }
     }
 
+    void CEngine::SaveResourceDatabase() { WriteToJSONFile(ResourceDatabase, "assets/databases/resources.json"); }
+
     void CEngine::RemoveTextureResource(resources::CTextureResource* InTexture)
     {
         // @TODO Don't allow to delete resources referenced by other resources + free main/video memory
@@ -370,7 +431,12 @@ namespace lucid
                                                       [&](const FResourceDatabaseEntry& Entry) { return Entry.Id == InTexture->GetID(); }));
 
         TexturesHolder.Remove(InTexture->GetID());
-        remove(*InTexture->GetFilePath());
+
+        // Packed resources point to the asset archive, they're dropped from it on the next cook
+        if (!InTexture->IsPacked())
+        {
+            remove(*InTexture->GetFilePath());
+        }
 
         WriteToJSONFile(ResourceDatabase, "assets/databases/resources.json");
     }
@@ -382,12 +448,49 @@ namespace lucid
           ResourceDatabase.Entries.begin(), ResourceDatabase.Entries.end(), [&](const FResourceDatabaseEntry& Entry) { return Entry.Id == InMesh->GetID(); }));
 
         MeshesHolder.Remove(InMesh->GetID());
-        remove(*InMesh->GetFilePath());
+
+        // Packed resources point to the asset archive, they're dropped from it on the next cook
+        if (!InMesh->IsPacked())
+        {
+            remove(*InMesh->GetFilePath());
+        }
 
         WriteToJSONFile(ResourceDatabase, "assets/databases/resources.json");
     }
 
-    void CEngine::Shutdown() {}
+    bool CEngine::CookResources()
+    {
+        // Packed resources point into the loaded archive and it's mapped while they're streamed, so it can't be replaced now
+        const FSString& ArchivePath = bAssetArchiveLoaded ? PENDING_ASSET_ARCHIVE_PATH : ASSET_ARCHIVE_PATH;
+        if (!resources::CookAssetArchive(ArchivePath, ResourceDatabase))
+        {
+            return false;
+        }
+
+        if (bAssetArchiveLoaded)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Resources from %s are loaded - the cooked archive will replace it after a restart", *ASSET_ARCHIVE_PATH);
+        }
+
+        // The resources saved since the last cook are up to date in the new archive
+        for (FResourceDatabaseEntry& Entry : ResourceDatabase.Entries)
+        {
+            Entry.bSavedAfterCook = false;
+        }
+        SaveResourceDatabase();
+
+        return true;
+    }
+
+    void CEngine::Shutdown()
+    {
+        ResourceStreamer.Cleanup();
+        TextureStreamer.Cleanup();
+        JobSystem.Shutdown();
+
+        // Called while the GPU context is still alive, the meshes' geometry lives in the pool's buffers
+        GeometryPool.FreeAll();
+    }
 
     void CEngine::AddMaterialAsset(scene::CMaterial* InMaterial, const scene::EMaterialType& InMaterialType, const FDString& InMaterialPath)
     {
@@ -474,6 +577,9 @@ namespace lucid
 
     void CEngine::BeginFrame()
     {
+        // Data allocated from the frame arena during the previous frame is no longer used
+        GFrameArena.Reset();
+
         gpu::QueryDeviceStatus();
 
         for (auto* Actor : ActorsWithDirtyResources)
@@ -6,6 +6,7 @@
 #include "scene/actors/actor.hpp"
 
 #include "common/types.hpp"
+#include "common/jobs.hpp"
 
 #include "schemas/types.hpp"
 
@@ -13,6 +14,9 @@
 #include "resources/resources_holder.hpp"
 #include "resources/texture_resource.hpp"
 #include "resources/mesh_resource.hpp"
+#include "resources/geometry_pool.hpp"
+#include "resources/resource_streamer.hpp"
+#include "resources/texture_streamer.hpp"
 
 #include "devices/gpu/shaders_manager.hpp"
 
@@ -44,6 +48,9 @@ namespace lucid
     struct FEngineConfig
     {
         bool bHotReloadShaders;
+
+        /** Creates the GL context without a display, the windows have to be hidden then */
+        bool bHeadless = false;
     };
 
     struct FActorResourceInfo
@@ -58,13 +65,24 @@ namespace lucid
       public:
         EEngineInitError InitEngine(const FEngineConfig& InEngineConfig);
         
+        /** Has to be called before the GPU context is destroyed, it frees the engine's GPU resources */
         void Shutdown();
         void LoadResources();
 
+        /**
+         * Packs all of the resources into the asset archive, LoadResources() reads them from there on the next start.
+         * If resources from the archive are loaded, the new one is written next to it and replaces it on the next start.
+         */
+        bool CookResources();
+
         inline FResourceDatabase&       GetResourceDatabase() { return ResourceDatabase; }
         inline FMaterialDatabase&       GetMaterialDatabase() { return MaterialDatabase; }
         inline CTexturesHolder&         GetTexturesHolder() { return TexturesHolder; }
         inline CMeshesHolder&           GetMeshesHolder() { return MeshesHolder; }
+        inline resources::CGeometryPool& GetGeometryPool() { return GeometryPool; }
+        inline resources::CResourceStreamer& GetResourceStreamer() { return ResourceStreamer; }
+        inline resources::CTextureStreamer& GetTextureStreamer() { return TextureStreamer; }
+        inline CJobSystem&              GetJobSystem() { return JobSystem; }
         inline CMaterialsHolder&        GetMaterialsHolder() { return MaterialsHolder; }
         inline scene::CRenderer*        GetRenderer() { return Renderer; }
         inline gpu::CShadersManager&    GetShadersManager() { return ShadersManager; }
@@ -77,8 +95,10 @@ namespace lucid
 
         inline FHashMap<UUID, scene::IActor*>& GetActorsResources() { return ActorResourceById; }
 
-        void AddTextureResource(resources::CTextureResource* InTexture);
-        void AddMeshResource(resources::CMeshResource* InMesh);
+        /** InbSaveDatabase can be false when adding many resources at once, SaveResourceDatabase() is then called after adding them */
+        void AddTextureResource(resources::CTextureResource* InTexture, const bool& InbSaveDatabase = true);
+        void AddMeshResource(resources::CMeshResource* InMesh, const bool& InbSaveDatabase = true);
+        void SaveResourceDatabase();
 
         void RemoveMeshResource(resources::CMeshResource* InMesh);
         void RemoveTextureResource(resources::CTextureResource*);
@@ -124,6 +144,15 @@ namespace lucid
         CTexturesHolder  TexturesHolder {};
         CMaterialsHolder MaterialsHolder {};
 
+        resources::CGeometryPool GeometryPool {};
+
+        CJobSystem                   JobSystem {};
+        resources::CResourceStreamer ResourceStreamer {};
+        resources::CTextureStreamer  TextureStreamer {};
+
+        /** Set when resources were loaded from the asset archive, it can't be replaced while they point into it */
+        bool bAssetArchiveLoaded = false;
+
         FHashMap<UUID, scene::IActor*>       ActorResourceById;
 
         scene::CMaterial* DefaultMaterial = nullptr;
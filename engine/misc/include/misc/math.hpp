@@ -2,6 +2,8 @@
 
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
 
 #include "common/types.hpp"
 #include "scene/transform.hpp"
@@ -58,6 +60,9 @@ namespace lucid::math
 
         void OrientAround(const scene::FTransform3D& Transform);
 
+        /** Same as above, but the matrix can also carry the transforms of the parents */
+        void OrientAround(const glm::mat4& InWorldMatrix);
+
         float GetMinWS(const u8& Axis) const;
         float GetMaxWS(const u8& Axis) const;
 
@@ -67,4 +72,38 @@ namespace lucid::math
         void      TranslateCorner(const int& InCorner, const glm::vec3& InTranslate);
         void      GrowInWorldSpace(const math::FAABB& Other);
     };
+
+    /** Frustum represented by 6 planes (left, right, bottom, top, near, far) with normals pointing inside the frustum */
+    struct FFrustum
+    {
+        glm::vec4 Planes[6];
+
+        /** Extracts the planes from a (projection * view) matrix, works for both perspective and orthographic projections */
+        void ExtractPlanes(const glm::mat4& InViewProjection);
+
+        /**
+         * Tests the world space bounds against the planes.
+         * The test is conservative - boxes near the frustum's corners might be reported as intersecting even if they're outside.
+         */
+        bool TestAABB(const glm::vec3& InMin, const glm::vec3& InMax) const;
+        bool TestAABB(const FAABB& InAABB) const;
+
+        /** Returns true if the bounds are fully inside the frustum */
+        bool ContainsAABB(const glm::vec3& InMin, const glm::vec3& InMax) const;
+
+        bool TestSphere(const glm::vec3& InCenter, const float& InRadius) const;
+    };
+
+    bool TestAABBSphereOverlap(const glm::vec3& InMin, const glm::vec3& InMax, const glm::vec3& InSphereCenter, const float& InSphereRadius);
+
+    /**
+     * Conservative test of a sphere against a cone with it's apex at InConeApex, pointing in InConeDirection.
+     * InConeAngle is the half-angle of the cone in radians, InConeLength is the distance from the apex to the cone's base.
+     */
+    bool TestSphereConeOverlap(const glm::vec3& InSphereCenter,
+                               const float&     InSphereRadius,
+                               const glm::vec3& InConeApex,
+                               const glm::vec3& InConeDirection,
+                               const float&     InConeLength,
+                               const float&     InConeAngle);
 } // namespace lucid::math
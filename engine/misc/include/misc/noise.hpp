@@ -0,0 +1,22 @@
+#pragma once
+
+#include "common/types.hpp"
+
+namespace lucid::math
+{
+    /** Parameters of the fractal (fBm) sum of 2D simplex noise octaves, same as the ones of SimplexNoise */
+    struct FFractalNoiseSettings
+    {
+        u32   Octaves     = 4;
+        float Frequency   = 1.f;
+        float Amplitude   = 1.f;
+        float Lacunarity  = 2.f;
+        float Persistence = 0.5f;
+    };
+
+    /**
+     * Evaluates the fractal 2D simplex noise at (InX + i, InY) for i in [0, InCount) and writes the values to OutValues.
+     * The samples are evaluated four at a time with SSE2, the results match SimplexNoise::fractal() so they're in [-1, 1].
+     */
+    void FractalNoise2DRow(const FFractalNoiseSettings& InSettings, const float& InX, const float& InY, const u32& InCount, float* OutValues);
+} // namespace lucid::math
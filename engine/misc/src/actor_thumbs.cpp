@@ -88,7 +88,7 @@ namespace lucid
         for (u16 i = 0; i < MeshResource->SubMeshes.GetLength(); ++i)
         {
             MeshResource->SubMeshes[i]->VAO->Bind();
-            MeshResource->SubMeshes[i]->VAO->Draw();
+            MeshResource->SubMeshes[i]->Draw();
         }
 
         return ThumbTexture; 
@@ -14,6 +14,61 @@ namespace lucid::math
 
     glm::vec3 RandomVec3() { return { RandomFloat(), RandomFloat(), RandomFloat() }; }
 
+    static void CalculateWorldSpaceBounds(FAABB& InOutAABB)
+    {
+        InOutAABB.MinXWS = std::min({ InOutAABB.FrontUpperLeftCorner.x,
+                                      InOutAABB.FrontLowerLeftCorner.x,
+                                      InOutAABB.FrontUpperRightCorner.x,
+                                      InOutAABB.FrontLowerRightCorner.x,
+                                      InOutAABB.BackUpperLeftCorner.x,
+                                      InOutAABB.BackLowerLeftCorner.x,
+                                      InOutAABB.BackUpperRightCorner.x,
+                                      InOutAABB.BackLowerRightCorner.x });
+        InOutAABB.MaxXWS = std::max({ InOutAABB.FrontUpperLeftCorner.x,
+                                      InOutAABB.FrontLowerLeftCorner.x,
+                                      InOutAABB.FrontUpperRightCorner.x,
+                                      InOutAABB.FrontLowerRightCorner.x,
+                                      InOutAABB.BackUpperLeftCorner.x,
+                                      InOutAABB.BackLowerLeftCorner.x,
+                                      InOutAABB.BackUpperRightCorner.x,
+                                      InOutAABB.BackLowerRightCorner.x });
+
+        InOutAABB.MinYWS = std::min({ InOutAABB.FrontUpperLeftCorner.y,
+                                      InOutAABB.FrontLowerLeftCorner.y,
+                                      InOutAABB.FrontUpperRightCorner.y,
+                                      InOutAABB.FrontLowerRightCorner.y,
+                                      InOutAABB.BackUpperLeftCorner.y,
+                                      InOutAABB.BackLowerLeftCorner.y,
+                                      InOutAABB.BackUpperRightCorner.y,
+                                      InOutAABB.BackLowerRightCorner.y });
+
+        InOutAABB.MaxYWS = std::max({ InOutAABB.FrontUpperLeftCorner.y,
+                                      InOutAABB.FrontLowerLeftCorner.y,
+                                      InOutAABB.FrontUpperRightCorner.y,
+                                      InOutAABB.FrontLowerRightCorner.y,
+                                      InOutAABB.BackUpperLeftCorner.y,
+                                      InOutAABB.BackLowerLeftCorner.y,
+                                      InOutAABB.BackUpperRightCorner.y,
+                                      InOutAABB.BackLowerRightCorner.y });
+
+        InOutAABB.MinZWS = std::min({ InOutAABB.FrontUpperLeftCorner.z,
+                                      InOutAABB.FrontLowerLeftCorner.z,
+                                      InOutAABB.FrontUpperRightCorner.z,
+                                      InOutAABB.FrontLowerRightCorner.z,
+                                      InOutAABB.BackUpperLeftCorner.z,
+                                      InOutAABB.BackLowerLeftCorner.z,
+                                      InOutAABB.BackUpperRightCorner.z,
+                                      InOutAABB.BackLowerRightCorner.z });
+        InOutAABB.MaxZWS = std::max({ InOutAABB.FrontUpperLeftCorner.z,
+                                      InOutAABB.FrontLowerLeftCorner.z,
+                                      InOutAABB.FrontUpperRightCorner.z,
+                                      InOutAABB.FrontLowerRightCorner.z,
+                                      InOutAABB.BackUpperLeftCorner.z,
+                                      InOutAABB.BackLowerLeftCorner.z,
+                                      InOutAABB.BackUpperRightCorner.z,
+                                      InOutAABB.BackLowerRightCorner.z });
+    }
+
     void FAABB::OrientAround(const scene::FTransform3D& Transform)
     {
         const FAABB ScaledAABB = (*this) * Transform.Scale;
@@ -28,57 +83,22 @@ namespace lucid::math
         BackUpperRightCorner = Transform.Translation + Transform.Rotation * glm::vec3{ ScaledAABB.MaxX, ScaledAABB.MaxY, ScaledAABB.MinZ };
         BackLowerRightCorner = Transform.Translation + Transform.Rotation * glm::vec3{ ScaledAABB.MaxX, ScaledAABB.MinY, ScaledAABB.MinZ };
 
-        MinXWS = std::min({ FrontUpperLeftCorner.x,
-                            FrontLowerLeftCorner.x,
-                            FrontUpperRightCorner.x,
-                            FrontLowerRightCorner.x,
-                            BackUpperLeftCorner.x,
-                            BackLowerLeftCorner.x,
-                            BackUpperRightCorner.x,
-                            BackLowerRightCorner.x });
-        MaxXWS = std::max({ FrontUpperLeftCorner.x,
-                            FrontLowerLeftCorner.x,
-                            FrontUpperRightCorner.x,
-                            FrontLowerRightCorner.x,
-                            BackUpperLeftCorner.x,
-                            BackLowerLeftCorner.x,
-                            BackUpperRightCorner.x,
-                            BackLowerRightCorner.x });
-
-        MinYWS = std::min({ FrontUpperLeftCorner.y,
-                            FrontLowerLeftCorner.y,
-                            FrontUpperRightCorner.y,
-                            FrontLowerRightCorner.y,
-                            BackUpperLeftCorner.y,
-                            BackLowerLeftCorner.y,
-                            BackUpperRightCorner.y,
-                            BackLowerRightCorner.y });
-
-        MaxYWS = std::max({ FrontUpperLeftCorner.y,
-                            FrontLowerLeftCorner.y,
-                            FrontUpperRightCorner.y,
-                            FrontLowerRightCorner.y,
-                            BackUpperLeftCorner.y,
-                            BackLowerLeftCorner.y,
-                            BackUpperRightCorner.y,
-                            BackLowerRightCorner.y });
-
-        MinZWS = std::min({ FrontUpperLeftCorner.z,
-                            FrontLowerLeftCorner.z,
-                            FrontUpperRightCorner.z,
-                            FrontLowerRightCorner.z,
-                            BackUpperLeftCorner.z,
-                            BackLowerLeftCorner.z,
-                            BackUpperRightCorner.z,
-                            BackLowerRightCorner.z });
-        MaxZWS = std::max({ FrontUpperLeftCorner.z,
-                            FrontLowerLeftCorner.z,
-                            FrontUpperRightCorner.z,
-                            FrontLowerRightCorner.z,
-                            BackUpperLeftCorner.z,
-                            BackLowerLeftCorner.z,
-                            BackUpperRightCorner.z,
-                            BackLowerRightCorner.z });
+        CalculateWorldSpaceBounds(*this);
+    }
+
+    void FAABB::OrientAround(const glm::mat4& InWorldMatrix)
+    {
+        FrontUpperLeftCorner  = glm::vec3{ InWorldMatrix * glm::vec4{ MinX, MaxY, MaxZ, 1 } };
+        FrontLowerLeftCorner  = glm::vec3{ InWorldMatrix * glm::vec4{ MinX, MinY, MaxZ, 1 } };
+        FrontUpperRightCorner = glm::vec3{ InWorldMatrix * glm::vec4{ MaxX, MaxY, MaxZ, 1 } };
+        FrontLowerRightCorner = glm::vec3{ InWorldMatrix * glm::vec4{ MaxX, MinY, MaxZ, 1 } };
+
+        BackUpperLeftCorner  = glm::vec3{ InWorldMatrix * glm::vec4{ MinX, MaxY, MinZ, 1 } };
+        BackLowerLeftCorner  = glm::vec3{ InWorldMatrix * glm::vec4{ MinX, MinY, MinZ, 1 } };
+        BackUpperRightCorner = glm::vec3{ InWorldMatrix * glm::vec4{ MaxX, MaxY, MinZ, 1 } };
+        BackLowerRightCorner = glm::vec3{ InWorldMatrix * glm::vec4{ MaxX, MinY, MinZ, 1 } };
+
+        CalculateWorldSpaceBounds(*this);
     }
 
     float FAABB::GetMinWS(const u8& Axis) const
@@ -238,5 +258,100 @@ namespace lucid::math
         MaxZWS = std::max(MaxZWS, Other.MaxZWS);
     }
 
+    void FFrustum::ExtractPlanes(const glm::mat4& InViewProjection)
+    {
+        // Gribb-Hartmann method, glm matrices are column major so we have to gather the rows by hand
+        const glm::vec4 Row0{ InViewProjection[0][0], InViewProjection[1][0], InViewProjection[2][0], InViewProjection[3][0] };
+        const glm::vec4 Row1{ InViewProjection[0][1], InViewProjection[1][1], InViewProjection[2][1], InViewProjection[3][1] };
+        const glm::vec4 Row2{ InViewProjection[0][2], InViewProjection[1][2], InViewProjection[2][2], InViewProjection[3][2] };
+        const glm::vec4 Row3{ InViewProjection[0][3], InViewProjection[1][3], InViewProjection[2][3], InViewProjection[3][3] };
+
+        Planes[0] = Row3 + Row0; // left
+        Planes[1] = Row3 - Row0; // right
+        Planes[2] = Row3 + Row1; // bottom
+        Planes[3] = Row3 - Row1; // top
+        Planes[4] = Row3 + Row2; // near
+        Planes[5] = Row3 - Row2; // far
+
+        for (glm::vec4& Plane : Planes)
+        {
+            Plane /= glm::length(glm::vec3{ Plane });
+        }
+    }
+
+    bool FFrustum::TestAABB(const glm::vec3& InMin, const glm::vec3& InMax) const
+    {
+        for (const glm::vec4& Plane : Planes)
+        {
+            // Test the corner that lies the furthest along the plane's normal
+            const glm::vec3 PositiveVertex{ Plane.x >= 0 ? InMax.x : InMin.x, Plane.y >= 0 ? InMax.y : InMin.y, Plane.z >= 0 ? InMax.z : InMin.z };
+            if (glm::dot(glm::vec3{ Plane }, PositiveVertex) + Plane.w < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool FFrustum::TestAABB(const FAABB& InAABB) const
+    {
+        return TestAABB({ InAABB.MinXWS, InAABB.MinYWS, InAABB.MinZWS }, { InAABB.MaxXWS, InAABB.MaxYWS, InAABB.MaxZWS });
+    }
+
+    bool FFrustum::ContainsAABB(const glm::vec3& InMin, const glm::vec3& InMax) const
+    {
+        for (const glm::vec4& Plane : Planes)
+        {
+            // Test the corner that lies the furthest against the plane's normal
+            const glm::vec3 NegativeVertex{ Plane.x >= 0 ? InMin.x : InMax.x, Plane.y >= 0 ? InMin.y : InMax.y, Plane.z >= 0 ? InMin.z : InMax.z };
+            if (glm::dot(glm::vec3{ Plane }, NegativeVertex) + Plane.w < 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool FFrustum::TestSphere(const glm::vec3& InCenter, const float& InRadius) const
+    {
+        for (const glm::vec4& Plane : Planes)
+        {
+            if (glm::dot(glm::vec3{ Plane }, InCenter) + Plane.w < -InRadius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool TestAABBSphereOverlap(const glm::vec3& InMin, const glm::vec3& InMax, const glm::vec3& InSphereCenter, const float& InSphereRadius)
+    {
+        const glm::vec3 ClosestPoint = glm::clamp(InSphereCenter, InMin, InMax);
+        const glm::vec3 ToSphere     = InSphereCenter - ClosestPoint;
+        return glm::dot(ToSphere, ToSphere) <= InSphereRadius * InSphereRadius;
+    }
+
+    bool TestSphereConeOverlap(const glm::vec3& InSphereCenter,
+                               const float&     InSphereRadius,
+                               const glm::vec3& InConeApex,
+                               const glm::vec3& InConeDirection,
+                               const float&     InConeLength,
+                               const float&     InConeAngle)
+    {
+        const glm::vec3 V           = InSphereCenter - InConeApex;
+        const float     VLenSq      = glm::dot(V, V);
+        const float     VAlongAxis  = glm::dot(V, InConeDirection);
+        const float     VFromAxisSq = std::max(VLenSq - (VAlongAxis * VAlongAxis), 0.f);
+
+        // Distance from the sphere's center to the closest point on the cone's side
+        const float DistanceToClosestPoint = (cosf(InConeAngle) * sqrtf(VFromAxisSq)) - (VAlongAxis * sinf(InConeAngle));
+
+        const bool bOutsideAngle = DistanceToClosestPoint > InSphereRadius;
+        const bool bInFront      = VAlongAxis > InConeLength + InSphereRadius;
+        const bool bBehind       = VAlongAxis < -InSphereRadius;
+
+        return !(bOutsideAngle || bInFront || bBehind);
+    }
+
     real Lerp(const real& X, const real& Y, const real& T);
 } // namespace lucid::math
@@ -0,0 +1,170 @@
+#include "misc/noise.hpp"
+
+#include <emmintrin.h>
+
+namespace lucid::math
+{
+    /** Same permutation table as the one of the simplex_noise library, so the results match SimplexNoise */
+    static const u8 NOISE_PERMUTATION[256] = {
+        151, 160, 137, 91, 90, 15, 131, 13, 201, 95, 96, 53, 194, 233, 7, 225,
+        140, 36, 103, 30, 69, 142, 8, 99, 37, 240, 21, 10, 23, 190, 6, 148,
+        247, 120, 234, 75, 0, 26, 197, 62, 94, 252, 219, 203, 117, 35, 11, 32,
+        57, 177, 33, 88, 237, 149, 56, 87, 174, 20, 125, 136, 171, 168, 68, 175,
+        74, 165, 71, 134, 139, 48, 27, 166, 77, 146, 158, 231, 83, 111, 229, 122,
+        60, 211, 133, 230, 220, 105, 92, 41, 55, 46, 245, 40, 244, 102, 143, 54,
+        65, 25, 63, 161, 1, 216, 80, 73, 209, 76, 132, 187, 208, 89, 18, 169,
+        200, 196, 135, 130, 116, 188, 159, 86, 164, 100, 109, 198, 173, 186, 3, 64,
+        52, 217, 226, 250, 124, 123, 5, 202, 38, 147, 118, 126, 255, 82, 85, 212,
+        207, 206, 59, 227, 47, 16, 58, 17, 182, 189, 28, 42, 223, 183, 170, 213,
+        119, 248, 152, 2, 44, 154, 163, 70, 221, 153, 101, 155, 167, 43, 172, 9,
+        129, 22, 39, 253, 19, 98, 108, 110, 79, 113, 224, 232, 178, 185, 112, 104,
+        218, 246, 97, 228, 251, 34, 242, 193, 238, 210, 144, 12, 191, 179, 162, 241,
+        81, 51, 145, 235, 249, 14, 239, 107, 49, 192, 214, 31, 181, 199, 106, 157,
+        184, 84, 204, 176, 115, 121, 50, 45, 127, 4, 150, 254, 138, 236, 205, 93,
+        222, 114, 67, 29, 24, 72, 243, 141, 128, 195, 78, 66, 215, 61, 156, 180,
+    };
+
+    static inline i32 NoiseHash(const i32& InValue) { return NOISE_PERMUTATION[(u8)InValue]; }
+
+    static inline __m128 Select(const __m128& InMask, const __m128& InA, const __m128& InB) { return _mm_or_ps(_mm_and_ps(InMask, InA), _mm_andnot_ps(InMask, InB)); }
+
+    static inline __m128i FloorToInt(const __m128& InValue)
+    {
+        // Truncation rounds the negative values up, the comparison mask is -1 for them
+        const __m128i Truncated  = _mm_cvttps_epi32(InValue);
+        const __m128  bRoundedUp = _mm_cmplt_ps(InValue, _mm_cvtepi32_ps(Truncated));
+        return _mm_add_epi32(Truncated, _mm_castps_si128(bRoundedUp));
+    }
+
+    /** Dot product of the corners' gradients and the offsets from them, the gradient is picked from 8 directions by the hash */
+    static inline __m128 NoiseGradient(const __m128i& InHash, const __m128& InX, const __m128& InY)
+    {
+        const __m128i H       = _mm_and_si128(InHash, _mm_set1_epi32(0x3F));
+        const __m128  bXFirst = _mm_castsi128_ps(_mm_cmplt_epi32(H, _mm_set1_epi32(4)));
+
+        const __m128 U = Select(bXFirst, InX, InY);
+        const __m128 V = _mm_mul_ps(_mm_set1_ps(2.f), Select(bXFirst, InY, InX));
+
+        // The first two bits of the hash flip the signs of u and v
+        const __m128 SignBit = _mm_set1_ps(-0.f);
+        const __m128 NegateU = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(H, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+        const __m128 NegateV = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(H, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+
+        return _mm_add_ps(_mm_xor_ps(U, _mm_and_ps(NegateU, SignBit)), _mm_xor_ps(V, _mm_and_ps(NegateV, SignBit)));
+    }
+
+    static inline __m128 NoiseCornerContribution(const __m128i& InHash, const __m128& InX, const __m128& InY)
+    {
+        __m128 T = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.5f), _mm_mul_ps(InX, InX)), _mm_mul_ps(InY, InY));
+
+        // Corners further than the radius don't contribute
+        const __m128 bInRange = _mm_cmpge_ps(T, _mm_setzero_ps());
+
+        T = _mm_mul_ps(T, T);
+        T = _mm_mul_ps(T, T);
+        return _mm_and_ps(bInRange, _mm_mul_ps(T, NoiseGradient(InHash, InX, InY)));
+    }
+
+    /** Four samples of SimplexNoise::noise(x, y) */
+    static __m128 SimplexNoise2D(const __m128& InX, const __m128& InY)
+    {
+        static constexpr float F2 = 0.366025403f; // (sqrt(3) - 1) / 2
+        static constexpr float G2 = 0.211324865f; // (3 - sqrt(3)) / 6
+
+        // Skew the input space to find the simplex cell
+        const __m128  S = _mm_mul_ps(_mm_add_ps(InX, InY), _mm_set1_ps(F2));
+        const __m128i I = FloorToInt(_mm_add_ps(InX, S));
+        const __m128i J = FloorToInt(_mm_add_ps(InY, S));
+
+        // Unskew the cell origin and get the offsets from it
+        const __m128 T  = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(I, J)), _mm_set1_ps(G2));
+        const __m128 X0 = _mm_sub_ps(InX, _mm_sub_ps(_mm_cvtepi32_ps(I), T));
+        const __m128 Y0 = _mm_sub_ps(InY, _mm_sub_ps(_mm_cvtepi32_ps(J), T));
+
+        // The middle corner is (1, 0) in the lower triangle of the cell and (0, 1) in the upper one
+        const __m128 bLowerTriangle = _mm_cmpgt_ps(X0, Y0);
+        const __m128 One            = _mm_set1_ps(1.f);
+
+        const __m128 X1 = _mm_add_ps(_mm_sub_ps(X0, _mm_and_ps(bLowerTriangle, One)), _mm_set1_ps(G2));
+        const __m128 Y1 = _mm_add_ps(_mm_sub_ps(Y0, _mm_andnot_ps(bLowerTriangle, One)), _mm_set1_ps(G2));
+        const __m128 X2 = _mm_add_ps(_mm_sub_ps(X0, One), _mm_set1_ps(2.f * G2));
+        const __m128 Y2 = _mm_add_ps(_mm_sub_ps(Y0, One), _mm_set1_ps(2.f * G2));
+
+        // SSE2 has no gathers, hash the corners lane by lane
+        alignas(16) i32 Is[4];
+        alignas(16) i32 Js[4];
+        alignas(16) i32 Hashes0[4];
+        alignas(16) i32 Hashes1[4];
+        alignas(16) i32 Hashes2[4];
+
+        _mm_store_si128((__m128i*)Is, I);
+        _mm_store_si128((__m128i*)Js, J);
+        const i32 LowerTriangleMask = _mm_movemask_ps(bLowerTriangle);
+
+        for (u8 Lane = 0; Lane < 4; ++Lane)
+        {
+            const i32 I1 = (LowerTriangleMask >> Lane) & 1;
+            const i32 J1 = 1 - I1;
+
+            Hashes0[Lane] = NoiseHash(Is[Lane] + NoiseHash(Js[Lane]));
+            Hashes1[Lane] = NoiseHash(Is[Lane] + I1 + NoiseHash(Js[Lane] + J1));
+            Hashes2[Lane] = NoiseHash(Is[Lane] + 1 + NoiseHash(Js[Lane] + 1));
+        }
+
+        const __m128 N0 = NoiseCornerContribution(_mm_load_si128((__m128i*)Hashes0), X0, Y0);
+        const __m128 N1 = NoiseCornerContribution(_mm_load_si128((__m128i*)Hashes1), X1, Y1);
+        const __m128 N2 = NoiseCornerContribution(_mm_load_si128((__m128i*)Hashes2), X2, Y2);
+
+        // Scale the result to [-1, 1]
+        return _mm_mul_ps(_mm_set1_ps(45.23065f), _mm_add_ps(_mm_add_ps(N0, N1), N2));
+    }
+
+    static __m128 FractalNoise2D(const FFractalNoiseSettings& InSettings, const __m128& InX, const __m128& InY)
+    {
+        __m128 Output    = _mm_setzero_ps();
+        float  Denom     = 0;
+        float  Frequency = InSettings.Frequency;
+        float  Amplitude = InSettings.Amplitude;
+
+        for (u32 i = 0; i < InSettings.Octaves; ++i)
+        {
+            const __m128 Frequency4 = _mm_set1_ps(Frequency);
+            const __m128 Noise      = SimplexNoise2D(_mm_mul_ps(InX, Frequency4), _mm_mul_ps(InY, Frequency4));
+
+            Output = _mm_add_ps(Output, _mm_mul_ps(_mm_set1_ps(Amplitude), Noise));
+            Denom += Amplitude;
+
+            Frequency *= InSettings.Lacunarity;
+            Amplitude *= InSettings.Persistence;
+        }
+
+        return _mm_div_ps(Output, _mm_set1_ps(Denom));
+    }
+
+    void FractalNoise2DRow(const FFractalNoiseSettings& InSettings, const float& InX, const float& InY, const u32& InCount, float* OutValues)
+    {
+        const __m128 Y       = _mm_set1_ps(InY);
+        const __m128 OffsetX = _mm_set1_ps(InX);
+
+        u32 i = 0;
+        for (; i + 4 <= InCount; i += 4)
+        {
+            const __m128 X = _mm_add_ps(_mm_cvtepi32_ps(_mm_setr_epi32(i, i + 1, i + 2, i + 3)), OffsetX);
+            _mm_storeu_ps(OutValues + i, FractalNoise2D(InSettings, X, Y));
+        }
+
+        // Evaluate the tail as a full vector and copy only the values that fit
+        if (i < InCount)
+        {
+            alignas(16) float Tail[4];
+
+            const __m128 X = _mm_add_ps(_mm_cvtepi32_ps(_mm_setr_epi32(i, i + 1, i + 2, i + 3)), OffsetX);
+            _mm_store_ps(Tail, FractalNoise2D(InSettings, X, Y));
+
+            for (u32 j = 0; i + j < InCount; ++j)
+            {
+                OutValues[i + j] = Tail[j];
+            }
+        }
+    }
+} // namespace lucid::math
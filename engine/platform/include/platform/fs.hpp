@@ -11,6 +11,24 @@ namespace lucid::platform
     FMemBuffer ReadFileToBuffer(const char* FilePath);
     void       RemoveFile(const char* FilePath);
 
+    /** Renames the file, replacing the file at InNewFilePath if there is one. Returns false if the file couldn't be renamed */
+    bool RenameFile(const char* InFilePath, const char* InNewFilePath);
+
+    /** Read-only view of a whole file mapped to memory */
+    struct FMappedFile
+    {
+        char* Pointer = nullptr;
+        u64   Size    = 0;
+
+        /** Only used on Windows, the file doesn't have to stay open after it's mapped on Linux */
+        void* FileHandle    = nullptr;
+        void* MappingHandle = nullptr;
+    };
+
+    /** Maps the whole file to memory, Pointer is null on failure */
+    FMappedFile MapFile(const char* InFilePath);
+    void        UnmapFile(FMappedFile& InMappedFile);
+
     /**
      * Adds a listener that is called when files in the directory or the directory itself changes.
      * Returns 0 on success, -1 on error
@@ -6,4 +6,7 @@ namespace lucid::platform
 {
     extern real SimulationStep;
     real GetCurrentTimeSeconds();
+
+    /** High resolution time used for profiling, GetCurrentTimeSeconds() has only a milisecond resolution */
+    double GetPreciseTimeMiliseconds();
 }
\ No newline at end of file
@@ -65,4 +65,18 @@ namespace lucid::platform
 
     void RemoveFile(const char* FilePath) { remove(FilePath); }
 
+    bool RenameFile(const char* InFilePath, const char* InNewFilePath)
+    {
+        FILE* File = fopen(InFilePath, "rb");
+        if (File == nullptr)
+        {
+            return false;
+        }
+        fclose(File);
+
+        // rename() doesn't replace existing files on Windows
+        remove(InNewFilePath);
+        return rename(InFilePath, InNewFilePath) == 0;
+    }
+
 } // namespace lucid::platform
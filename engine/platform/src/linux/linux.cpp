@@ -0,0 +1,60 @@
+#include "platform/fs.hpp"
+#include "common/log.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace lucid::platform
+{
+    FMappedFile MapFile(const char* InFilePath)
+    {
+        FMappedFile MappedFile;
+
+        const int FileDescriptor = open(InFilePath, O_RDONLY);
+        if (FileDescriptor == -1)
+        {
+            LUCID_LOG(ELogLevel::WARN, "[platform-linux] open function failed for %s with error code %d", InFilePath, errno);
+            return MappedFile;
+        }
+
+        // Empty files can't be mapped
+        struct stat FileStat;
+        if (fstat(FileDescriptor, &FileStat) == -1 || FileStat.st_size == 0)
+        {
+            close(FileDescriptor);
+            return MappedFile;
+        }
+
+        void* View = mmap(nullptr, FileStat.st_size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+
+        // The mapping keeps the file alive, so the descriptor isn't needed anymore
+        close(FileDescriptor);
+
+        if (View == MAP_FAILED)
+        {
+            LUCID_LOG(ELogLevel::WARN, "[platform-linux] mmap function failed for %s with error code %d", InFilePath, errno);
+            return MappedFile;
+        }
+
+        // Resources are mostly read front to back
+        madvise(View, FileStat.st_size, MADV_SEQUENTIAL);
+
+        MappedFile.Pointer = (char*)View;
+        MappedFile.Size    = FileStat.st_size;
+        return MappedFile;
+    }
+
+    void UnmapFile(FMappedFile& InMappedFile)
+    {
+        if (InMappedFile.Pointer == nullptr)
+        {
+            return;
+        }
+
+        munmap(InMappedFile.Pointer, InMappedFile.Size);
+        InMappedFile = {};
+    }
+} // namespace lucid::platform
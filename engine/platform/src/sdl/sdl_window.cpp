@@ -49,8 +49,10 @@ namespace lucid::platform
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
         SDL_GL_SetAttribute(SDL_GL_STENCIL_SIZE, 8);
         SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-        SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
-        SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, 4);
+
+        // Hidden windows are never presented, so they don't need a multisampled framebuffer, which headless contexts often don't have
+        SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, Definition.bHidden ? 0 : 1);
+        SDL_GL_SetAttribute(SDL_GL_MULTISAMPLESAMPLES, Definition.bHidden ? 0 : 4);
         SDL_GL_SetAttribute(SDL_GL_FRAMEBUFFER_SRGB_CAPABLE, 0);
 
         SDL_GLContext context = SDL_GL_CreateContext(window);
@@ -10,4 +10,9 @@ namespace lucid::platform
     {
         return static_cast<real>(SDL_GetTicks()) / static_cast<real>(1000);
     }
+
+    double GetPreciseTimeMiliseconds()
+    {
+        return static_cast<double>(SDL_GetPerformanceCounter()) * 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+    }
 }
\ No newline at end of file
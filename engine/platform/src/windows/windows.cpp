@@ -133,5 +133,62 @@ namespace lucid::platform
         }
         return -1;
     }
-    
+
+    FMappedFile MapFile(const char* InFilePath)
+    {
+        FMappedFile MappedFile;
+
+        //@TODO Unicode support
+        const HANDLE FileHandle =
+          CreateFileA(InFilePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (FileHandle == INVALID_HANDLE_VALUE)
+        {
+            LUCID_LOG(ELogLevel::WARN, "[platform-windows] CreateFile function failed for %s with error code %d", InFilePath, GetLastError());
+            return MappedFile;
+        }
+
+        // Empty files can't be mapped
+        LARGE_INTEGER FileSize;
+        if (GetFileSizeEx(FileHandle, &FileSize) == FALSE || FileSize.QuadPart == 0)
+        {
+            CloseHandle(FileHandle);
+            return MappedFile;
+        }
+
+        const HANDLE MappingHandle = CreateFileMappingA(FileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (MappingHandle == NULL)
+        {
+            LUCID_LOG(ELogLevel::WARN, "[platform-windows] CreateFileMapping function failed for %s with error code %d", InFilePath, GetLastError());
+            CloseHandle(FileHandle);
+            return MappedFile;
+        }
+
+        void* View = MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (View == NULL)
+        {
+            LUCID_LOG(ELogLevel::WARN, "[platform-windows] MapViewOfFile function failed for %s with error code %d", InFilePath, GetLastError());
+            CloseHandle(MappingHandle);
+            CloseHandle(FileHandle);
+            return MappedFile;
+        }
+
+        MappedFile.Pointer       = (char*)View;
+        MappedFile.Size          = FileSize.QuadPart;
+        MappedFile.FileHandle    = FileHandle;
+        MappedFile.MappingHandle = MappingHandle;
+        return MappedFile;
+    }
+
+    void UnmapFile(FMappedFile& InMappedFile)
+    {
+        if (InMappedFile.Pointer == nullptr)
+        {
+            return;
+        }
+
+        UnmapViewOfFile(InMappedFile.Pointer);
+        CloseHandle(InMappedFile.MappingHandle);
+        CloseHandle(InMappedFile.FileHandle);
+        InMappedFile = {};
+    }
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "common/types.hpp"
+#include "common/strings.hpp"
+#include "common/collections.hpp"
+
+#include "resources/resource.hpp"
+
+namespace lucid
+{
+    struct FResourceDatabase;
+} // namespace lucid
+
+namespace lucid::resources
+{
+    static constexpr u32 ASSET_ARCHIVE_MAGIC   = 0x4B41504C; // "LPAK"
+    static constexpr u32 ASSET_ARCHIVE_VERSION = 1;
+
+    /**
+     * Asset archive packs all of the resources into a single file, so startup doesn't open a file per resource.
+     * Layout: [FAssetArchiveHeader][table of contents][resources]
+     * Each TOC entry is an FAssetArchiveTOCEntry followed by a copy of the resource's header and metadata and by it's thumbnail,
+     * so the whole TOC is read sequentially. Resources are stored the same way as in their own asset files,
+     * their data is read lazily from ResourceOffset, which becomes the resource's Offset.
+     */
+#pragma pack(push, 1)
+    struct FAssetArchiveHeader
+    {
+        u32 Magic      = ASSET_ARCHIVE_MAGIC;
+        u32 Version    = ASSET_ARCHIVE_VERSION;
+        u32 NumEntries = 0;
+
+        /** Size of the table of contents in bytes, the resources start right after it */
+        u64 TOCSize = 0;
+    };
+
+    struct FAssetArchiveTOCEntry
+    {
+        UUID          Id;
+        EResourceType Type;
+
+        /** Offset of the resource in the archive and it's size including the header and the metadata */
+        u64 ResourceOffset = 0;
+        u64 ResourceSize   = 0;
+
+        /** Size of the header and metadata copy following this entry */
+        u32 MetadataSize = 0;
+
+        /** Offset of the thumbnail in the archive, it's stored right after the metadata copy */
+        u64 ThumbnailOffset = 0;
+        u32 ThumbnailSize   = 0;
+    };
+#pragma pack(pop)
+
+    /**
+     * Reads the table of contents and creates the resources stored in the archive.
+     * Only their metadata and thumbnails are read, the data is read from the archive when they're acquired.
+     * Returns false if the archive doesn't exist or is invalid.
+     */
+    bool LoadAssetArchive(const FString& InArchivePath, FHashMap<UUID, CResource*>& OutResourcesById);
+
+    /**
+     * The cook step, packs the resources listed in the database and their thumbnails into an archive.
+     * The archive is written to a temporary file first, then it replaces the one at InArchivePath.
+     */
+    bool CookAssetArchive(const FString& InArchivePath, const FResourceDatabase& InResourceDatabase);
+} // namespace lucid::resources
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/types.hpp"
+#include "common/strings.hpp"
+
+#include "resources/mesh_resource.hpp"
+
+namespace lucid::resources
+{
+    /**
+     * Imports many meshes and textures at once. The files are fanned out across the job system's workers, which decode them,
+     * interleave the vertex data and write the asset files together with the thumbnails. The textures used by the meshes
+     * are imported by separate jobs, so a mesh with many textures doesn't keep a single worker busy.
+     * Finish() then registers the results in the engine on the main thread and writes the resource database once.
+     * The batch has to outlive the jobs, i.e. it can't be destroyed before Finish() is called.
+     */
+    class CBatchImport
+    {
+      public:
+        /** The resources are saved to assets/textures/<InName>.asset, the strings are copied */
+        void AddTexture(const FString& InPath, const FString& InName, const bool& InbGammaCorrect, const bool& InbFlipY);
+
+        /** Same as ImportMesh(), the strings are copied */
+        void AddMesh(const FString& InPath, const FString& InName, const bool& InbFlipUVs, const EMeshImportStretegy& InImportStrategy);
+
+        /** Submits the import jobs, main thread only */
+        void Start();
+
+        /** Can be polled while the import runs, the textures of the meshes are added to the total when the mesh is read */
+        inline u32   GetNumImported() const { return NumImported; }
+        inline u32   GetNumToImport() const { return NumToImport; }
+        inline float GetProgress() const { return NumToImport ? (float)NumImported / (float)NumToImport : 1.f; }
+        inline bool  IsDone() const { return NumJobsInFlight == 0; }
+
+        /** Waits for the jobs and registers the imported resources and assets in the engine. Main thread only, returns the number of failed imports */
+        u32 Finish();
+
+      private:
+        struct FMeshImport
+        {
+            FDString            Path;
+            FDString            Name;
+            bool                bFlipUVs;
+            EMeshImportStretegy ImportStrategy;
+
+            bool          bImported = false;
+            FImportedMesh ImportedMesh;
+        };
+
+        void SubmitTextureImport(FImportedMeshTexture* InTexture);
+
+        /** Standalone textures go through the same path as the textures of the meshes */
+        std::vector<FImportedMeshTexture> Textures;
+        std::vector<FMeshImport>          Meshes;
+
+        std::atomic<u32> NumToImport     = 0;
+        std::atomic<u32> NumImported     = 0;
+        std::atomic<u32> NumJobsInFlight = 0;
+
+        float StartTime = 0;
+    };
+} // namespace lucid::resources
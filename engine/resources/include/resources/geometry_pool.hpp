@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "common/types.hpp"
+#include "devices/gpu/vao.hpp"
+
+namespace lucid::resources
+{
+    /** Vertex format of the geometry stored in a pool, meshes with the same layout share the vertex array */
+    struct FVertexLayout
+    {
+        bool bHasPositions = false;
+        bool bHasNormals   = false;
+        bool bHasTangents  = false;
+        bool bHasUVs       = false;
+        bool bIndexed      = false;
+
+        gpu::EDrawMode DrawMode = gpu::EDrawMode::TRIANGLES;
+
+        u16 GetVertexSize() const;
+        u16 GetKey() const;
+    };
+
+    /** First-fit allocator of ranges of elements, adjacent free ranges are merged when freeing */
+    class CRangeAllocator
+    {
+      public:
+        static constexpr u32 INVALID_OFFSET = 0xFFFFFFFF;
+
+        void Init(const u32& InCapacity);
+
+        /** Returns INVALID_OFFSET when there is no free range big enough */
+        u32  Allocate(const u32& InCount);
+        void Free(const u32& InOffset, const u32& InCount);
+
+        /** Makes the allocator aware that the underlying storage grew, new space is added to the free ranges */
+        void Grow(const u32& InNewCapacity);
+
+        inline u32 GetCapacity() const { return Capacity; }
+        inline u32 GetNumAllocated() const { return NumAllocated; }
+
+      private:
+        struct FFreeRange
+        {
+            u32 Offset = 0;
+            u32 Count  = 0;
+        };
+
+        /** Sorted by offset */
+        std::vector<FFreeRange> FreeRanges;
+
+        u32 Capacity     = 0;
+        u32 NumAllocated = 0;
+    };
+
+    /** Range of the pool's vertex and element buffers occupied by a submesh */
+    struct FGeometryAllocation
+    {
+        gpu::CVertexArray* VAO = nullptr;
+
+        u32 BaseVertex  = 0;
+        u32 VertexCount = 0;
+
+        u32 FirstIndex   = 0;
+        u32 ElementCount = 0;
+    };
+
+    /**
+     * Shared storage for the geometry of all of the meshes. There is one vertex and one element buffer per vertex layout,
+     * meshes are sub-allocated from them, so submeshes become ranges in the buffers and all of them can be drawn
+     * with a single multi-draw call as long as they share the layout. Buffers grow when they run out of space.
+     */
+    class CGeometryPool
+    {
+      public:
+        /** Allocates space for the geometry in the pool matching the layout and uploads it, element data can be null for non-indexed layouts */
+        FGeometryAllocation Allocate(const FVertexLayout& InLayout,
+                                     const void*          InVertexData,
+                                     const u32&           InVertexCount,
+                                     const u32*           InElementData,
+                                     const u32&           InElementCount);
+
+        void Free(const FVertexLayout& InLayout, const FGeometryAllocation& InAllocation);
+
+        /** Frees the GPU buffers of all of the pools */
+        void FreeAll();
+
+      private:
+        struct FLayoutPool
+        {
+            FVertexLayout      Layout;
+            gpu::CVertexArray* VAO           = nullptr;
+            gpu::CGPUBuffer*   VertexBuffer  = nullptr;
+            gpu::CGPUBuffer*   ElementBuffer = nullptr;
+            CRangeAllocator    Vertices;
+            CRangeAllocator    Elements;
+        };
+
+        FLayoutPool& GetOrCreatePool(const FVertexLayout& InLayout);
+
+        /** Reallocates the buffer so it can hold at least InRequiredCount more elements, data is copied over to the new buffer */
+        void GrowBuffer(FLayoutPool& InPool, const bool& InbElementBuffer, const u32& InRequiredCount);
+
+        std::unordered_map<u16, FLayoutPool> PoolsByLayout;
+    };
+} // namespace lucid::resources
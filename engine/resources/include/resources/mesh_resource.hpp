@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "resources/resources_holder.hpp"
 #include "common/bytes.hpp"
 #include "common/collections.hpp"
@@ -12,11 +14,30 @@ namespace lucid::resources
 
     struct FSubMesh
     {
+        /** Draws the submesh's range of the vertex array, the vertex array has to be bound */
+        inline void Draw() const
+        {
+            if (ElementCount)
+            {
+                VAO->Draw(FirstIndex, ElementCount, BaseVertex);
+            }
+            else
+            {
+                VAO->Draw(BaseVertex, VertexCount);
+            }
+        }
+
+        /** When the submesh lives in the geometry pool, this is the pool's vertex array shared by all meshes with the same vertex layout */
         gpu::CVertexArray* VAO = nullptr;
-        ;
+
+        /** Only set when the submesh has it's own buffers instead of living in the geometry pool */
         gpu::CGPUBuffer* VertexBuffer  = nullptr;
         gpu::CGPUBuffer* ElementBuffer = nullptr;
 
+        /** Range of the vertex array's buffers occupied by the submesh */
+        u32 BaseVertex = 0;
+        u32 FirstIndex = 0;
+
         bool bHasPositions;
         bool bHasNormals;
         bool bHasTangetns;
@@ -55,6 +76,7 @@ namespace lucid::resources
 
         virtual void LoadMetadata(FILE* ResourceFile) override;
         virtual void LoadDataToMainMemorySynchronously() override;
+        virtual void MapDataToMainMemory() override;
         virtual void LoadDataToVideoMemorySynchronously() override;
 
         virtual void SaveSynchronously(FILE* ResourceFile = nullptr) const override;
@@ -66,10 +88,19 @@ namespace lucid::resources
 
         inline const math::FAABB& GetAABB() const { return AABB; }
 
+        /** Offset of the vertex data of the first submesh, the data of the submeshes is stored one after another */
+        virtual u64 GetDataOffset() const override;
+
         virtual CResource* CreateCopy() const override;
 
         gpu::EDrawMode DrawMode = gpu::EDrawMode::TRIANGLES;
 
+        /**
+         * When set, the submeshes are sub-allocated from the shared geometry pool when loaded to video memory,
+         * so they can be batched with other meshes. Meshes which swap their vertex buffers (e.g. terrain when sculpting) opt out.
+         */
+        bool bUseGeometryPool = true;
+
         FArray<FSubMesh> SubMeshes{ 1, true };
 
 #if DEVELOPMENT
@@ -81,6 +112,53 @@ namespace lucid::resources
         math::FAABB AABB;
     };
 
+    /** Texture used by the materials of an imported mesh, imported by ImportMeshTexture() */
+    struct FImportedMeshTexture
+    {
+        FDString SourcePath;
+        FDString Name;
+        bool     bGammaCorrect = false;
+        bool     bNormalMap    = false;
+        bool     bFlipY        = false;
+
+        /** Set by ImportMeshTexture(), nullptr if the import failed */
+        CTextureResource* Texture = nullptr;
+        FMemBuffer        ThumbnailData;
+    };
+
+    struct FImportedMeshMaterial
+    {
+        FDString Name;
+
+        /** Indices to FImportedMesh::Textures, -1 if the material doesn't have the map */
+        i32 DiffuseMapIndex = -1;
+        i32 NormalMapIndex  = -1;
+    };
+
+    struct FImportedMeshActor
+    {
+        FDString       Name;
+        CMeshResource* Mesh = nullptr;
+        math::FAABB    AABB;
+
+        /** Index to FImportedMesh::Materials, -1 if the actor doesn't have a material */
+        i32  MaterialIndex    = -1;
+        bool bUseAllMaterials = false;
+    };
+
+    /**
+     * Result of ImportMeshData(), describes the resources and assets created from the mesh file.
+     * The textures are imported separately, so they can be imported in parallel.
+     */
+    struct FImportedMesh
+    {
+        EMeshImportStretegy                ImportStrategy;
+        std::vector<CMeshResource*>        Meshes;
+        std::vector<FImportedMeshTexture>  Textures;
+        std::vector<FImportedMeshMaterial> Materials;
+        std::vector<FImportedMeshActor>    Actors;
+    };
+
     /**
      *  Loads the mesh from the given directory, requires that
      *  textures are stored in the same directory as the model file
@@ -88,5 +166,24 @@ namespace lucid::resources
     FArray<CMeshResource*>
     ImportMesh(const FString& MeshFilePath, const FString& MeshName, const bool& InbFilpUVs, const EMeshImportStretegy& InMeshImportStrategy);
 
+    /**
+     * The steps of ImportMesh(). ImportMeshData() and ImportMeshTexture() only read the source files and write the asset files,
+     * so they can run on the job system's workers. AddImportedMeshToEngine() creates the materials and actors
+     * and registers everything in the engine, it has to be called on the main thread, it returns the number of textures that failed to import.
+     * The resource database isn't written by AddImportedMeshToEngine(), so many meshes can be added with a single write.
+     */
+    bool ImportMeshData(const FString&             InMeshFilePath,
+                        const FString&             MeshName,
+                        const bool&                InbFilpUVs,
+                        const EMeshImportStretegy& InMeshImportStrategy,
+                        FImportedMesh&             OutImportedMesh);
+
+    void ImportMeshTexture(FImportedMeshTexture& InOutTexture);
+
+    u32 AddImportedMeshToEngine(FImportedMesh& InImportedMesh);
+
+    /** Registers the texture imported by ImportMeshTexture() and creates it's thumbnail, returns false if the import failed */
+    bool AddImportedTextureToEngine(FImportedMeshTexture& InImportedTexture);
+
     CMeshResource* LoadMesh(const FString& FilePath);
 } // namespace lucid::resources
@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <atomic>
+
 #include <devices/gpu/texture.hpp>
 
 #include "common/strings.hpp"
@@ -17,12 +19,27 @@ namespace lucid::resources
 #define RESOURCE_FILE_HEADER_SIZE \
     (sizeof(lucid::UUID) + sizeof(EResourceType) + RESOURCE_SERIALIZATION_VERSION_SIZE + RESOURCE_DATA_SIZE_SIZE + RESOURCE_NAME_LENGTH_SIZE)
 
+    /** Tells LoadResource() that the resource is stored at the current position of the file */
+    static constexpr u64 RESOURCE_OFFSET_CURRENT = (u64)-1;
+
     enum EResourceType : u8
     {
         TEXTURE,
         MESH
     };
 
+    enum class EResourceState : u8
+    {
+        UNLOADED,
+        /** Data is being read on one of the job system's workers */
+        LOADING,
+        IN_MAIN_MEMORY,
+        /** Data is in video memory and the resource can be used for rendering */
+        RESIDENT
+    };
+
+    class CResourceStreamer;
+
     /** Base class that represents a resource whose data can be stored in main/video memory or both */
     class CResource
     {
@@ -44,6 +61,13 @@ namespace lucid::resources
 
         virtual void LoadDataToMainMemorySynchronously() = 0;
 
+        /**
+         * Same as LoadDataToMainMemorySynchronously(), but instead of copying the data to the heap it points straight
+         * into the memory mapped resource file. The data is read-only, so it's meant for resources that are only
+         * in main memory on their way to video memory. LoadDataToMainMemorySynchronously() replaces it with a heap copy.
+         */
+        virtual void MapDataToMainMemory() = 0;
+
         /**
          * Implementations are free to memory map the file if the data is not already loaded to the main memory
          * or just is the data loaded by the previous call to LoadDataToMainMemory*
@@ -60,6 +84,9 @@ namespace lucid::resources
 
         virtual void          LoadThumbnail(){};
         virtual void          MakeThumbnail(){};
+
+        /** Creates the thumbnail texture from the data stored by MakeThumbnail(), used when the thumbnail is read from an asset archive */
+        virtual void CreateThumbnail(const char* InThumbnailData){};
         inline gpu::CTexture* GetThumbnail() const { return ThumbnailTexture; }
 
         inline const UUID&    GetID() const { return ID; }
@@ -67,28 +94,70 @@ namespace lucid::resources
         inline const FString& GetFilePath() const { return FilePath; }
         inline u32            GetRefCount() const { return RefCount; }
 
+        inline u64            GetDataSize() const { return DataSize; }
+
         inline bool IsLoadedToMainMemory() const { return bLoadedToMainMemory; }
         inline bool IsLoadedToVideoMemory() const { return bLoadedToVideoMemory; }
+        inline bool IsMainMemoryMapped() const { return bMainMemoryMapped; }
+
+        EResourceState GetState() const;
+        inline bool    IsStreaming() const { return bStreaming; }
 
+        /** Loads the data synchronously, waits for the streamer first if the resource is being loaded in the background */
         void Acquire(const bool& InbNeededInMainMemory, const bool& InbNeededInVideoMemory);
+
+        /**
+         * Same as Acquire(), but the data is read on a worker thread and uploaded to the GPU by the resource streamer
+         * in one of the next frames. Use GetState() to check if the resource can be used already.
+         */
+        void AcquireAsync(const bool& InbNeededInMainMemory, const bool& InbNeededInVideoMemory);
+
         void Release();
 
+        /** Blocks until the worker loading the data of this resource is done */
+        void WaitUntilLoaded() const;
+
         virtual CResource* CreateCopy() const { return nullptr; }
 
         /** Called from CResourceHolder */
         inline void MarkAsFreed() { RefCount = -1; }
 
-        virtual ~CResource() = default;
+        /** Offset of the data from the beginning of the resource, i.e. the size of the header and the metadata */
+        virtual u64 GetDataOffset() const = 0;
+
+        /** Resources loaded from an asset archive are read-only, they can't be saved back to the archive */
+        inline void MarkAsPacked() { bPacked = true; }
+        inline bool IsPacked() const { return bPacked; }
+
+        /**
+         * Switches a packed resource to it's own file from the resource database, so it can be saved there.
+         * The data has to be in main memory, as it's only in the archive. Returns false if the resource can't be saved.
+         */
+        bool Unpack();
+
+        virtual ~CResource();
 
       protected:
+        friend class CResourceStreamer;
+
         void SaveHeader(FILE* ResourceFile) const;
         void Save(const u32& InAssetSerializationVersion);
 
+        /**
+         * Maps the file the resource is stored in and returns the pointer to the beginning of the resource (i.e. the file + Offset).
+         * Resources stored in the same file share the mapping, it's unmapped when the last of them calls UnmapResourceFile().
+         */
+        const char* MapResourceFile();
+        void        UnmapResourceFile();
+
+        /** Touches the pages of the mapped resource, so the data is read from disk now instead of on first access */
+        void PrefaultMappedResource() const;
+
         UUID    ID;
         FString Name;
 
         /** Path the the file from which this resource was loaded */
-        const FString FilePath;
+        FString FilePath;
 
         /** Offset at which the resource is stored in the file */
         u64 Offset;
@@ -104,14 +173,31 @@ namespace lucid::resources
         bool IsVideoMemoryFreed = true;
         bool IsMainMemoryFreed  = true;
 
+        /** Set when the main memory data points into the mapped resource file instead of the heap */
+        bool bMainMemoryMapped = false;
+
+        bool bPacked = false;
+
+        /** Beginning of the resource in the mapped file and the number of bytes mapped after it */
+        const char* MappedResource     = nullptr;
+        u64         MappedResourceSize = 0;
+
         u32 RefCount = 0;
 
+        /** Set while a worker reads the data, the streamer is the only one touching the resource then */
+        std::atomic<bool> bLoading{ false };
+
+        /** Set from AcquireAsync() until the streamer is done with the resource, main thread only */
+        bool bStreaming             = false;
+        bool bStreamedToMainMemory  = false;
+        bool bStreamedToVideoMemory = false;
+
         /** Useful in editor */
         gpu::CTexture* ThumbnailTexture = nullptr;
     };
 
     template <typename R, typename = std::enable_if<std::is_base_of<CResource, R>::value>>
-    R* LoadResource(FILE* ResourceFile, const FString& ResourceFilePath);
+    R* LoadResource(FILE* ResourceFile, const FString& ResourceFilePath, const u64& InResourceOffset = RESOURCE_OFFSET_CURRENT);
 } // namespace lucid::resources
 
 #include "resources/resource.tpp"
\ No newline at end of file
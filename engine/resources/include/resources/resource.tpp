@@ -9,9 +9,9 @@
 namespace lucid::resources
 {
     template <typename R, typename = std::enable_if<std::is_base_of<CResource, R>::value>>
-    R* LoadResource(FILE* ResourceFile, const FString& ResourceFilePath)
+    R* LoadResource(FILE* ResourceFile, const FString& ResourceFilePath, const u64& InResourceOffset)
     {
-        const u64 Offset = ftell(ResourceFile);
+        const u64 Offset = InResourceOffset == RESOURCE_OFFSET_CURRENT ? _ftelli64(ResourceFile) : InResourceOffset;
 
         UUID          ResourceUUID;
         EResourceType ResourceType;
@@ -57,8 +57,6 @@ namespace lucid::resources
 
         LoadedResource->LoadMetadata(ResourceFile);
 
-        fclose(ResourceFile);
-
         return (R*)LoadedResource;
     }
 } // namespace lucid::resources
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "common/types.hpp"
+#include "common/object.hpp"
+
+namespace lucid::gpu
+{
+    class CGPUBuffer;
+    class CFence;
+} // namespace lucid::gpu
+
+namespace lucid::resources
+{
+    class CResource;
+
+    /**
+     * Streams in resources acquired with CResource::AcquireAsync(). The data is read from disk on the job system's workers,
+     * then at the beginning of the frame the main thread uploads the loaded resources to the GPU, MaxUploadBytesPerFrame at most.
+     * Textures are copied to a persistently mapped staging buffer and sourced from there, so creating them doesn't stall on the upload.
+     * Meshes are uploaded straight to the geometry pool.
+     */
+    class CResourceStreamer : public IEngineObject
+    {
+      public:
+        static constexpr u32 STAGING_REGIONS_COUNT = 3;
+        static constexpr u32 STAGING_REGION_SIZE   = 16 * 1024 * 1024;
+
+        void Setup();
+        void Cleanup();
+
+        /** Called by CResource::AcquireAsync(), main thread only */
+        void Enqueue(CResource* InResource);
+
+        /** Called when a resource that's being streamed is deleted, waits for the worker and forgets about the resource */
+        void Cancel(CResource* InResource);
+
+        virtual void OnFrameBegin() override;
+
+        inline u32 GetNumPendingResources() const { return NumPendingResources; }
+
+        u32 MaxUploadBytesPerFrame = STAGING_REGION_SIZE;
+
+      private:
+        void FinishStreaming(CResource* InResource);
+
+        /** Resources loaded to main memory by the workers, waiting to be picked up by the main thread */
+        std::mutex              LoadedResourcesMutex;
+        std::vector<CResource*> LoadedResources;
+
+        /** Main thread only */
+        std::deque<CResource*> PendingUploads;
+        u32                    NumPendingResources = 0;
+
+        gpu::CGPUBuffer* StagingBuffer                        = nullptr;
+        char*            StagingBufferMappedPtr               = nullptr;
+        gpu::CFence*     StagingFences[STAGING_REGIONS_COUNT] = { nullptr };
+        u32              CurrentStagingRegion                 = 0;
+    };
+} // namespace lucid::resources
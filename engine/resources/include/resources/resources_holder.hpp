@@ -46,6 +46,7 @@ namespace lucid::resources
             R* Resource = ResourcesHashMap.Get(InId);
             if (Resource)
             {
+                Resource->WaitUntilLoaded();
                 Resource->FreeMainMemory();
                 Resource->FreeVideoMemroy();
                 ResourcesHashMap.Remove(InId);
@@ -60,7 +61,8 @@ namespace lucid::resources
         {
             for (u32 idx = 0; idx < ResourcesHashMap.GetLength(); ++idx)
             {
-                auto* Resource = ResourcesHashMap.Get(idx);
+                auto* Resource = ResourcesHashMap.GetByIndex(idx);
+                Resource->WaitUntilLoaded();
                 Resource->FreeMainMemory();
                 Resource->FreeVideoMemory();
                 delete Resource;
@@ -81,7 +83,9 @@ namespace lucid::resources
             for (u32 i = 0; i < ResourcesHashMap.GetLength(); ++i)
             {
                 auto* Resource = ResourcesHashMap.GetByIndex(i);
-                if (Resource->GetRefCount() == 0)
+
+                // The streamer frees the data of resources that got released while streaming
+                if (Resource->GetRefCount() == 0 && !Resource->IsStreaming())
                 {
                     LUCID_LOG(ELogLevel::INFO, "RefCount of %s dropped to 0, releasing it", *Resource->GetName());
                     Resource->FreeMainMemory();
@@ -3,6 +3,6 @@
 
 namespace lucid::resources
 {
-    constexpr u32 TEXTURE_SERIALIZATION_VERSION = 0;
+    constexpr u32 TEXTURE_SERIALIZATION_VERSION = 1;
     constexpr u32 MESH_SERIALIZATION_VERSION = 3;
 } // namespace lucid::resources
\ No newline at end of file
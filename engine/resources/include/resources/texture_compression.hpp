@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common/types.hpp"
+#include "common/bytes.hpp"
+
+#include "devices/gpu/texture_enums.hpp"
+
+namespace lucid::resources
+{
+    /**
+     * Picks the block compression format for an 8 bit texture based on what it's used for:
+     * single channel maps go to BC4, normal maps and two channel maps to BC5, opaque color to BC1,
+     * color with alpha to BC7 and linear data with alpha to BC3.
+     */
+    gpu::ETextureDataFormat ChooseBlockCompressionFormat(const u8*   InPixels,
+                                                         const u32&  InWidth,
+                                                         const u32&  InHeight,
+                                                         const u8&   InNumChannels,
+                                                         const bool& InbSRGB,
+                                                         const bool& InbNormalMap);
+
+    /**
+     * Builds the full mip chain of an 8 bit texture and block compresses each mip to InFormat. sRGB textures are filtered in linear space
+     * and normal maps are renormalized after filtering. The mips are stored one after another starting with the base level,
+     * each of them takes gpu::GetCompressedMipSize() bytes. Doesn't touch the GPU, so it can run on a worker.
+     * Returns the number of mips, the caller frees OutData.
+     */
+    u8 BuildCompressedMipChain(const u8*                      InPixels,
+                               const u32&                     InWidth,
+                               const u32&                     InHeight,
+                               const u8&                      InNumChannels,
+                               const gpu::ETextureDataFormat& InFormat,
+                               const bool&                    InbNormalMap,
+                               FMemBuffer&                    OutData);
+} // namespace lucid::resources
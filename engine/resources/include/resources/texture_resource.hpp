@@ -2,12 +2,14 @@
 
 #include <devices/gpu/texture.hpp>
 
+#include "common/bytes.hpp"
 #include "common/strings.hpp"
 #include "resources/resource.hpp"
 
 namespace lucid::gpu
 {
     class CTexture;
+    class CGPUBuffer;
     enum class ETextureDataType : u8;
     enum class ETextureDataFormat : u8;
     enum class ETexturePixelFormat : u8;
@@ -17,6 +19,10 @@ namespace lucid::resources
 {
     void InitTextures();
 
+    static constexpr u32 THUMBNAIL_SIZE = 32;
+
+    class CTextureStreamer;
+
     class CTextureResource : public CResource
     {
       public:
@@ -27,12 +33,18 @@ namespace lucid::resources
                          const u64&     InDataSize,
                          const u32&     InAssetSerializationVersion);
 
+        virtual ~CTextureResource();
+
         virtual EResourceType GetType() const override { return TEXTURE; };
 
         virtual void LoadMetadata(FILE* ResourceFile) override;
         virtual void LoadDataToMainMemorySynchronously() override;
+        virtual void MapDataToMainMemory() override;
         virtual void LoadDataToVideoMemorySynchronously() override;
 
+        /** Used by the resource streamer, copies the data to the mapped staging buffer at InOffset and sources the texture from there */
+        void LoadDataToVideoMemoryFromStagingBuffer(gpu::CGPUBuffer* InStagingBuffer, char* InStagingMappedPtr, const u32& InOffset);
+
         virtual void SaveSynchronously(FILE* ResourceFile = nullptr) const override;
         virtual void MigrateToLatestVersion() override;
 
@@ -41,6 +53,34 @@ namespace lucid::resources
 
         virtual void LoadThumbnail() override;
         virtual void MakeThumbnail() override;
+        virtual void CreateThumbnail(const char* InThumbnailData) override;
+
+        /**
+         * Downsizes the texture data to a thumbnail and writes it next to the asset file. Doesn't touch the GPU, so it can be called from a worker.
+         * Block compressed textures can only be resized right after the import, while the decoded pixels are still around.
+         * Returns the thumbnail data which can be passed to CreateThumbnail() on the main thread, the caller frees it.
+         */
+        FMemBuffer SaveThumbnail() const;
+
+        virtual u64 GetDataOffset() const override;
+
+        /** Block compressed textures with a mip chain can have their mips streamed in and out by CTextureStreamer */
+        bool IsStreamable() const;
+
+        /** Offset of the mip in TextureData, the mips of block compressed textures are stored one after another starting with the base level */
+        u64 GetMipOffset(const u8& InMip) const;
+
+        /** First mip that's not bigger than CTextureStreamer::MIP_TAIL_SIZE, streamed textures always keep the mips from this one down resident */
+        u8 GetMipTailStart() const;
+
+        /**
+         * Creates a block compressed texture with the mips from InFirstMip down. The data is copied to the mapped staging buffer at InOffset
+         * and sourced from there, without a staging buffer it's sourced straight from TextureData which has to be in main memory.
+         */
+        gpu::CTexture* CreateMipRangeTexture(const u8& InFirstMip, gpu::CGPUBuffer* InStagingBuffer, char* InStagingMappedPtr, const u32& InOffset) const;
+
+        /** Replaces TextureHandle with a texture starting at InFirstMip, keeps the bindless handle resident. The caller frees the returned old texture */
+        gpu::CTexture* SwapTextureHandle(gpu::CTexture* InTexture, const u8& InFirstMip);
 
         void*          TextureData           = nullptr;
         u8             bSRGB                 = 0;
@@ -52,13 +92,54 @@ namespace lucid::resources
         gpu::ETextureDataType    DataType;
         gpu::ETextureDataFormat  DataFormat;
         gpu::ETexturePixelFormat PixelFormat;
+
+        /** Number of mips stored in TextureData, block compressed textures store their whole chain, the others only the base level */
+        u8 NumMips = 1;
+
+        /** Mip that's the base level of TextureHandle, streamed textures are created with only their mip tail resident */
+        u8 FirstResidentMip = 0;
+
+      private:
+        friend class CTextureStreamer;
+
+        /** Streamed textures start with their mip tail only, unless streaming is disabled */
+        u8 GetInitialResidentMip() const;
+        /** Format of the thumbnail, it's never block compressed as it's made from the decoded pixels */
+        gpu::ETextureDataFormat GetThumbnailDataFormat() const;
+
+        /** Downsizes the pixels to a thumbnail and writes it next to the asset file, InStride is the size of a row in bytes or 0 if the rows are packed */
+        FMemBuffer WriteThumbnail(const u8* InPixels, const u32& InWidth, const u32& InHeight, const u32& InStride) const;
+
+        /** Decoded pixels of a freshly imported texture, TextureData is block compressed so the thumbnail is made from these */
+        u8* SourcePixels = nullptr;
+
+        /** Streaming state, owned by CTextureStreamer. TargetMip differs from FirstResidentMip while mips are being loaded */
+        bool bMipsStreamed       = false;
+        u8   TargetMip           = 0;
+        u8   RequestedMip        = 0;
+        u8   PrevRequestedMip    = 0;
+        u64  LastMipRequestFrame = 0;
+
+        friend CTextureResource* ImportTexture(const FString&               InPath,
+                                               const FString&               InResourcePath,
+                                               const bool&                  InPerformGammaCorrection,
+                                               const bool&                  InbNormalMap,
+                                               const gpu::ETextureDataType& InDataType,
+                                               const bool&                  InFlipY,
+                                               const bool&                  InSendToGPU,
+                                               const FString&               InName);
     };
 
     CTextureResource* LoadTexture(const FString& FilePath);
 
+    /**
+     * 8 bit textures get their full mip chain generated and block compressed at import, the format is chosen based on the usage,
+     * see ChooseBlockCompressionFormat(). Normal maps are stored with two channels, the shaders reconstruct Z.
+     */
     CTextureResource* ImportTexture(const FString&               InPath,
                                     const FString&               InResourcePath,
                                     const bool&                  InPerformGammaCorrection,
+                                    const bool&                  InbNormalMap,
                                     const gpu::ETextureDataType& InDataType,
                                     const bool&                  InFlipY,
                                     const bool&                  InSendToGPU,
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "common/types.hpp"
+#include "common/object.hpp"
+
+namespace lucid::gpu
+{
+    class CGPUBuffer;
+    class CFence;
+    class CTexture;
+} // namespace lucid::gpu
+
+namespace lucid::scene
+{
+    class CMaterial;
+} // namespace lucid::scene
+
+namespace lucid::resources
+{
+    class CTextureResource;
+
+    /**
+     * Streams the mips of block compressed textures based on what the GPU actually samples.
+     * Streamed textures are created with only their mip tail resident, i.e. the mips not bigger than MIP_TAIL_SIZE.
+     * Materials sampling them get a feedback slot, the material shaders write the finest UV footprint of their fragments to it
+     * (see texture_feedback.glsl). The feedback is read back a few frames later, so it never stalls, and turned into mip requests
+     * for the textures of the material. The requested mips are read from the mapped asset file on the job system's workers,
+     * then the main thread recreates the texture with the new mip range through a staging buffer and swaps it in.
+     * This changes the bindless handle, so the materials refresh their handles when GetHandlesGeneration() changes.
+     * The old texture is freed once the GPU is done with it.
+     * Mips that weren't requested for a while are evicted the same way. Requests that don't fit in VRAMBudget get the finest mip that does,
+     * when over the budget the mips of the least recently requested textures are evicted first.
+     */
+    class CTextureStreamer : public IEngineObject
+    {
+      public:
+        static constexpr u32 MIP_TAIL_SIZE          = 64;
+        static constexpr u32 MAX_FEEDBACK_SLOTS     = 4096;
+        static constexpr u32 INVALID_FEEDBACK_SLOT  = 0xFFFFFFFF;
+        static constexpr u32 FEEDBACK_BUFFERS_COUNT = 3;
+        static constexpr u32 STAGING_REGIONS_COUNT  = 2;
+        static constexpr u32 STAGING_REGION_SIZE    = 16 * 1024 * 1024;
+        static constexpr u32 MAX_LOADS_IN_FLIGHT    = 16;
+
+        /** Requests are gathered over windows of this many frames, mips that weren't requested in the last two windows are evicted */
+        static constexpr u32 REQUEST_WINDOW_FRAMES = 120;
+
+        void Setup();
+        void Cleanup();
+
+        /** Called by the texture when it's created with it's mip tail only and when it's video memory is freed */
+        void Register(CTextureResource* InTexture);
+        void Unregister(CTextureResource* InTexture);
+
+        /** Slots index the feedback buffer, the material writes the slot to it's shader data */
+        u32  AllocFeedbackSlot(scene::CMaterial* InMaterial);
+        void FreeFeedbackSlot(const u32& InSlot);
+
+        /** Called by the materials with the footprint read back from their feedback slot, keeps the texture's mips resident */
+        void RequestMips(CTextureResource* InTexture, const float& InLog2UVFootprint);
+
+        /**
+         * The renderer clears and binds the feedback buffer of this frame at InBindingIndex before drawing with the material shaders
+         * and calls EndFeedback() when it's done, the buffer is read back when it's fence signals.
+         */
+        void BeginFeedback(const u32& InBindingIndex);
+        void EndFeedback();
+
+        virtual void OnFrameBegin() override;
+
+        /** Incremented whenever a texture is swapped, materials compare it against the value they've seen to know when to refresh their handles */
+        inline u32 GetHandlesGeneration() const { return HandlesGeneration; }
+        inline u64 GetResidentBytes() const { return ResidentBytes; }
+        inline u32 GetNumStreamedTextures() const { return StreamedTextures.size(); }
+
+        /** Only affects the textures uploaded after it's changed, the other ones keep their current mips */
+        bool bEnabled = true;
+
+        /** Budget for the streamed textures, the mip tails are always resident and don't count against it */
+        u64 VRAMBudget = 512 * 1024 * 1024;
+
+        u32 MaxUploadBytesPerFrame = STAGING_REGION_SIZE;
+
+      private:
+        struct FMipsLoad
+        {
+            CTextureResource* Texture;
+            u8                FirstMip;
+            bool              bMappedByStreamer;
+        };
+
+        struct FRetiredTexture
+        {
+            gpu::CTexture* Texture;
+            gpu::CFence*   Fence;
+        };
+
+        struct FFeedbackBuffer
+        {
+            gpu::CGPUBuffer* Buffer    = nullptr;
+            u32*             MappedPtr = nullptr;
+            gpu::CFence*     Fence     = nullptr;
+        };
+
+        void ResolveFeedback(FFeedbackBuffer& InFeedbackBuffer);
+        void UploadLoadedMips();
+        void ScheduleMipChanges();
+        void LoadMips(CTextureResource* InTexture, const u8& InFirstMip);
+
+        /** The data was mapped only for the upload, unless somebody made a copy of it in the meantime */
+        void ReleaseMappedData(const FMipsLoad& InLoad);
+
+        /** Bytes that the texture would take above it's mip tail with InFirstMip as the first resident mip */
+        u64 GetStreamedSize(const CTextureResource* InTexture, const u8& InFirstMip) const;
+
+        u64 FrameNumber       = 0;
+        u32 HandlesGeneration = 0;
+        u64 ResidentBytes     = 0;
+
+        std::vector<CTextureResource*> StreamedTextures;
+
+        /** Mips loaded to main memory by the workers, waiting to be uploaded by the main thread */
+        std::mutex             LoadedMipsMutex;
+        std::vector<FMipsLoad> LoadedMips;
+
+        /** Main thread only */
+        std::vector<FMipsLoad>         PendingUploads;
+        std::vector<CTextureResource*> MipRequests;
+        u32                            NumLoadsInFlight = 0;
+
+        std::vector<FRetiredTexture> RetiredTextures;
+
+        std::vector<scene::CMaterial*> FeedbackMaterials;
+        std::vector<u32>               FreeFeedbackSlots;
+
+        FFeedbackBuffer FeedbackBuffers[FEEDBACK_BUFFERS_COUNT];
+        u32             CurrentFeedbackBuffer = 0;
+
+        gpu::CGPUBuffer* StagingBuffer                        = nullptr;
+        char*            StagingBufferMappedPtr               = nullptr;
+        gpu::CFence*     StagingFences[STAGING_REGIONS_COUNT] = { nullptr };
+        u32              CurrentStagingRegion                 = 0;
+    };
+} // namespace lucid::resources
@@ -0,0 +1,288 @@
+#include "resources/asset_archive.hpp"
+
+#include <vector>
+
+#include "common/log.hpp"
+#include "common/bytes.hpp"
+
+#include "platform/fs.hpp"
+#include "platform/util.hpp"
+
+#include "resources/mesh_resource.hpp"
+#include "resources/texture_resource.hpp"
+
+#include "schemas/types.hpp"
+
+namespace lucid::resources
+{
+    /** The TOC is read through a buffer this big, so it's read with a handful of big reads instead of one per resource */
+    static constexpr u32 TOC_READ_BUFFER_SIZE = 8 * 1024 * 1024;
+
+    /** Resources are copied to the archive through a buffer this big, so only a chunk of one resource is in memory at a time */
+    static constexpr u32 COOK_COPY_BUFFER_SIZE = 4 * 1024 * 1024;
+
+    bool LoadAssetArchive(const FString& InArchivePath, FHashMap<UUID, CResource*>& OutResourcesById)
+    {
+        const float StartTime = platform::GetCurrentTimeSeconds();
+
+        FILE* ArchiveFile;
+        if (fopen_s(&ArchiveFile, *InArchivePath, "rb") != 0)
+        {
+            return false;
+        }
+
+        setvbuf(ArchiveFile, nullptr, _IOFBF, TOC_READ_BUFFER_SIZE);
+
+        FAssetArchiveHeader Header;
+        if (fread_s(&Header, sizeof(Header), sizeof(Header), 1, ArchiveFile) != 1 || Header.Magic != ASSET_ARCHIVE_MAGIC)
+        {
+            LUCID_LOG(ELogLevel::WARN, "%s is not an asset archive", *InArchivePath);
+            fclose(ArchiveFile);
+            return false;
+        }
+
+        if (Header.Version != ASSET_ARCHIVE_VERSION)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Asset archive %s has version %d, expected %d - it has to be cooked again", *InArchivePath, Header.Version, ASSET_ARCHIVE_VERSION);
+            fclose(ArchiveFile);
+            return false;
+        }
+
+        // Thumbnails are small, so they share a single buffer
+        std::vector<char> ThumbnailData;
+
+        for (u32 i = 0; i < Header.NumEntries; ++i)
+        {
+            FAssetArchiveTOCEntry TOCEntry;
+            if (fread_s(&TOCEntry, sizeof(TOCEntry), sizeof(TOCEntry), 1, ArchiveFile) != 1)
+            {
+                LUCID_LOG(ELogLevel::ERR, "Asset archive %s is truncated", *InArchivePath);
+                break;
+            }
+
+            // The thumbnail ends the entry, so that's where the next one starts
+            const u64 NextEntryOffset = TOCEntry.ThumbnailOffset + TOCEntry.ThumbnailSize;
+
+            // Metadata is parsed from the copy in the TOC, but the resource points to it's data in the archive
+            CResource* Resource = nullptr;
+            switch (TOCEntry.Type)
+            {
+            case MESH:
+                Resource = LoadResource<CMeshResource>(ArchiveFile, InArchivePath, TOCEntry.ResourceOffset);
+                break;
+            case TEXTURE:
+                Resource = LoadResource<CTextureResource>(ArchiveFile, InArchivePath, TOCEntry.ResourceOffset);
+                break;
+            default:
+                LUCID_LOG(ELogLevel::WARN, "Skipping resource of unknown type %d in asset archive %s", TOCEntry.Type, *InArchivePath);
+                break;
+            }
+
+            if (Resource == nullptr)
+            {
+                _fseeki64(ArchiveFile, NextEntryOffset, SEEK_SET);
+                continue;
+            }
+
+            Resource->MarkAsPacked();
+
+            // Seeking drops the read buffer, so it's done only when the metadata didn't end where the cook step said it does
+            if (_ftelli64(ArchiveFile) != (i64)TOCEntry.ThumbnailOffset)
+            {
+                LUCID_LOG(ELogLevel::WARN, "Metadata size of resource %s in asset archive %s doesn't match the TOC", *Resource->GetName(), *InArchivePath);
+                _fseeki64(ArchiveFile, TOCEntry.ThumbnailOffset, SEEK_SET);
+            }
+
+            if (TOCEntry.ThumbnailSize)
+            {
+                ThumbnailData.resize(TOCEntry.ThumbnailSize);
+                if (fread_s(ThumbnailData.data(), TOCEntry.ThumbnailSize, TOCEntry.ThumbnailSize, 1, ArchiveFile) == 1)
+                {
+                    Resource->CreateThumbnail(ThumbnailData.data());
+                }
+            }
+
+            OutResourcesById.Add(TOCEntry.Id, Resource);
+        }
+
+        fclose(ArchiveFile);
+
+        LUCID_LOG(ELogLevel::INFO, "Loaded %d resources from asset archive %s in %f seconds", Header.NumEntries, *InArchivePath, platform::GetCurrentTimeSeconds() - StartTime);
+        return true;
+    }
+
+    /** Returns the size of the file in bytes, 0 if it can't be opened */
+    static u64 GetCookedFileSize(const char* InFilePath)
+    {
+        FILE* File;
+        if (fopen_s(&File, InFilePath, "rb") != 0)
+        {
+            return 0;
+        }
+
+        _fseeki64(File, 0, SEEK_END);
+        const i64 FileSize = _ftelli64(File);
+        fclose(File);
+
+        return FileSize > 0 ? FileSize : 0;
+    }
+
+    /** Appends the first InNumBytes of the file to the archive, it's copied in chunks of COOK_COPY_BUFFER_SIZE */
+    static bool CopyFileToArchive(FILE* InArchiveFile, const char* InFilePath, const u64& InNumBytes, std::vector<char>& InCopyBuffer)
+    {
+        FILE* File;
+        if (fopen_s(&File, InFilePath, "rb") != 0)
+        {
+            return false;
+        }
+
+        u64 NumBytesLeft = InNumBytes;
+        while (NumBytesLeft > 0)
+        {
+            const u64 ChunkSize = NumBytesLeft < COOK_COPY_BUFFER_SIZE ? NumBytesLeft : COOK_COPY_BUFFER_SIZE;
+            if (fread_s(InCopyBuffer.data(), InCopyBuffer.size(), ChunkSize, 1, File) != 1 || fwrite(InCopyBuffer.data(), ChunkSize, 1, InArchiveFile) != 1)
+            {
+                break;
+            }
+            NumBytesLeft -= ChunkSize;
+        }
+
+        fclose(File);
+        return NumBytesLeft == 0;
+    }
+
+    bool CookAssetArchive(const FString& InArchivePath, const FResourceDatabase& InResourceDatabase)
+    {
+        const float StartTime = platform::GetCurrentTimeSeconds();
+
+        struct FCookedResource
+        {
+            FAssetArchiveTOCEntry         TOCEntry;
+            const FResourceDatabaseEntry* DatabaseEntry;
+        };
+
+        std::vector<FCookedResource> CookedResources;
+        CookedResources.reserve(InResourceDatabase.Entries.size());
+
+        FAssetArchiveHeader Header;
+
+        // Only the sizes are gathered up front, the files are copied to the archive one at a time once the TOC is laid out,
+        // so the cook doesn't hold all of the resources in memory
+        for (const FResourceDatabaseEntry& Entry : InResourceDatabase.Entries)
+        {
+            FCookedResource CookedResource;
+            CookedResource.DatabaseEntry         = &Entry;
+            CookedResource.TOCEntry.ResourceSize = GetCookedFileSize(*Entry.Path);
+            if (CookedResource.TOCEntry.ResourceSize == 0)
+            {
+                LUCID_LOG(ELogLevel::WARN, "Skipping resource %s when cooking - failed to read %s", *Entry.Name, *Entry.Path);
+                continue;
+            }
+
+            // Read the metadata the same way it's read at startup to find out where the data begins
+            CResource* Resource = nullptr;
+            switch (Entry.Type)
+            {
+            case MESH:
+                Resource = LoadMesh(Entry.Path);
+                break;
+            case TEXTURE:
+                Resource = LoadTexture(Entry.Path);
+                break;
+            }
+
+            if (Resource == nullptr)
+            {
+                LUCID_LOG(ELogLevel::WARN, "Skipping resource %s when cooking - failed to load it", *Entry.Name);
+                continue;
+            }
+
+            CookedResource.TOCEntry.Id           = Entry.Id;
+            CookedResource.TOCEntry.Type         = Entry.Type;
+            CookedResource.TOCEntry.MetadataSize = Resource->GetDataOffset();
+            delete Resource;
+
+            FDString ThumbPath                    = SPrintf("%s.th", *Entry.Path);
+            CookedResource.TOCEntry.ThumbnailSize = GetCookedFileSize(*ThumbPath);
+            ThumbPath.Free();
+
+            Header.TOCSize += sizeof(FAssetArchiveTOCEntry) + CookedResource.TOCEntry.MetadataSize + CookedResource.TOCEntry.ThumbnailSize;
+            CookedResources.push_back(CookedResource);
+        }
+
+        Header.NumEntries = CookedResources.size();
+
+        // Now that the TOC size is known, the resources can be laid out after it
+        u64 TOCOffset      = sizeof(FAssetArchiveHeader);
+        u64 ResourceOffset = sizeof(FAssetArchiveHeader) + Header.TOCSize;
+        for (FCookedResource& CookedResource : CookedResources)
+        {
+            CookedResource.TOCEntry.ThumbnailOffset = TOCOffset + sizeof(FAssetArchiveTOCEntry) + CookedResource.TOCEntry.MetadataSize;
+            CookedResource.TOCEntry.ResourceOffset  = ResourceOffset;
+
+            TOCOffset += sizeof(FAssetArchiveTOCEntry) + CookedResource.TOCEntry.MetadataSize + CookedResource.TOCEntry.ThumbnailSize;
+            ResourceOffset += CookedResource.TOCEntry.ResourceSize;
+        }
+
+        // The archive is written next to the old one and renamed over it at the end, so a failed cook leaves the old archive intact
+        FDString TempArchivePath = SPrintf("%s.tmp", *InArchivePath);
+
+        FILE* ArchiveFile;
+        if (fopen_s(&ArchiveFile, *TempArchivePath, "wb") != 0)
+        {
+            LUCID_LOG(ELogLevel::ERR, "Failed to cook resources - couldn't open %s for writing", *TempArchivePath);
+            TempArchivePath.Free();
+            return false;
+        }
+
+        std::vector<char> CopyBuffer(COOK_COPY_BUFFER_SIZE);
+
+        bool bSuccess = fwrite(&Header, sizeof(Header), 1, ArchiveFile) == 1;
+
+        for (u32 i = 0; bSuccess && i < CookedResources.size(); ++i)
+        {
+            const FCookedResource& CookedResource = CookedResources[i];
+
+            // The metadata copy is the beginning of the resource file
+            bSuccess = fwrite(&CookedResource.TOCEntry, sizeof(CookedResource.TOCEntry), 1, ArchiveFile) == 1 &&
+                       CopyFileToArchive(ArchiveFile, *CookedResource.DatabaseEntry->Path, CookedResource.TOCEntry.MetadataSize, CopyBuffer);
+
+            if (bSuccess && CookedResource.TOCEntry.ThumbnailSize)
+            {
+                FDString ThumbPath = SPrintf("%s.th", *CookedResource.DatabaseEntry->Path);
+                bSuccess           = CopyFileToArchive(ArchiveFile, *ThumbPath, CookedResource.TOCEntry.ThumbnailSize, CopyBuffer);
+                ThumbPath.Free();
+            }
+        }
+
+        for (u32 i = 0; bSuccess && i < CookedResources.size(); ++i)
+        {
+            const FCookedResource& CookedResource = CookedResources[i];
+            bSuccess = CopyFileToArchive(ArchiveFile, *CookedResource.DatabaseEntry->Path, CookedResource.TOCEntry.ResourceSize, CopyBuffer);
+        }
+
+        fclose(ArchiveFile);
+
+        if (!bSuccess)
+        {
+            // The offsets in the TOC are only valid if every file was copied whole, e.x. a file could've changed since it's size was read
+            LUCID_LOG(ELogLevel::ERR, "Failed to cook resources - couldn't write %s", *TempArchivePath);
+            platform::RemoveFile(*TempArchivePath);
+            TempArchivePath.Free();
+            return false;
+        }
+
+        // The old archive can't be replaced while it's mapped, e.x. when the engine streams resources from it
+        if (!platform::RenameFile(*TempArchivePath, *InArchivePath))
+        {
+            LUCID_LOG(ELogLevel::ERR, "Failed to cook resources - couldn't replace %s", *InArchivePath);
+            platform::RemoveFile(*TempArchivePath);
+            TempArchivePath.Free();
+            return false;
+        }
+        TempArchivePath.Free();
+
+        LUCID_LOG(ELogLevel::INFO, "Cooked %d resources to %s in %f seconds", Header.NumEntries, *InArchivePath, platform::GetCurrentTimeSeconds() - StartTime);
+        return true;
+    }
+} // namespace lucid::resources
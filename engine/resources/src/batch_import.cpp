@@ -0,0 +1,120 @@
+#include "resources/batch_import.hpp"
+
+#include "engine/engine.hpp"
+
+#include "common/log.hpp"
+#include "common/jobs.hpp"
+
+#include "platform/util.hpp"
+
+namespace lucid::resources
+{
+    void CBatchImport::AddTexture(const FString& InPath, const FString& InName, const bool& InbGammaCorrect, const bool& InbFlipY)
+    {
+        FImportedMeshTexture Texture;
+        Texture.SourcePath    = CopyToString(*InPath, InPath.GetLength());
+        Texture.Name          = CopyToString(*InName, InName.GetLength());
+        Texture.bGammaCorrect = InbGammaCorrect;
+        Texture.bFlipY        = InbFlipY;
+        Textures.push_back(Texture);
+    }
+
+    void CBatchImport::AddMesh(const FString& InPath, const FString& InName, const bool& InbFlipUVs, const EMeshImportStretegy& InImportStrategy)
+    {
+        FMeshImport Mesh;
+        Mesh.Path           = CopyToString(*InPath, InPath.GetLength());
+        Mesh.Name           = CopyToString(*InName, InName.GetLength());
+        Mesh.bFlipUVs       = InbFlipUVs;
+        Mesh.ImportStrategy = InImportStrategy;
+        Meshes.push_back(Mesh);
+    }
+
+    void CBatchImport::Start()
+    {
+        StartTime   = platform::GetCurrentTimeSeconds();
+        NumToImport = Textures.size() + Meshes.size();
+        NumImported = 0;
+
+        // The vectors don't change from now on, so the jobs can hold pointers to their elements
+        for (FImportedMeshTexture& Texture : Textures)
+        {
+            SubmitTextureImport(&Texture);
+        }
+
+        for (FMeshImport& Mesh : Meshes)
+        {
+            ++NumJobsInFlight;
+            GEngine.GetJobSystem().Submit([this, MeshPtr = &Mesh] {
+                MeshPtr->bImported = ImportMeshData(MeshPtr->Path, MeshPtr->Name, MeshPtr->bFlipUVs, MeshPtr->ImportStrategy, MeshPtr->ImportedMesh);
+
+                // Submitted before this job is done, so NumJobsInFlight doesn't drop to 0 in between
+                NumToImport += MeshPtr->ImportedMesh.Textures.size();
+                for (FImportedMeshTexture& Texture : MeshPtr->ImportedMesh.Textures)
+                {
+                    SubmitTextureImport(&Texture);
+                }
+
+                ++NumImported;
+                --NumJobsInFlight;
+            });
+        }
+    }
+
+    void CBatchImport::SubmitTextureImport(FImportedMeshTexture* InTexture)
+    {
+        ++NumJobsInFlight;
+        GEngine.GetJobSystem().Submit([this, InTexture] {
+            ImportMeshTexture(*InTexture);
+            ++NumImported;
+            --NumJobsInFlight;
+        });
+    }
+
+    u32 CBatchImport::Finish()
+    {
+        // Texture jobs are submitted by the mesh jobs before they finish, so they're waited for too
+        GEngine.GetJobSystem().WaitForAll();
+
+        u32 NumFailed = 0;
+
+        for (FImportedMeshTexture& Texture : Textures)
+        {
+            if (!AddImportedTextureToEngine(Texture))
+            {
+                ++NumFailed;
+            }
+        }
+
+        for (FMeshImport& Mesh : Meshes)
+        {
+            if (Mesh.bImported)
+            {
+                NumFailed += AddImportedMeshToEngine(Mesh.ImportedMesh);
+            }
+            else
+            {
+                LUCID_LOG(ELogLevel::WARN, "Failed to import mesh %s", *Mesh.Path);
+                ++NumFailed;
+            }
+
+            Mesh.Path.Free();
+            Mesh.Name.Free();
+        }
+
+        // Written once for the whole batch
+        GEngine.SaveResourceDatabase();
+
+        LUCID_LOG(ELogLevel::INFO,
+                  "Batch import of %d files done in %f seconds, %d failed",
+                  (u32)NumToImport,
+                  platform::GetCurrentTimeSeconds() - StartTime,
+                  NumFailed);
+
+        Textures.clear();
+        Meshes.clear();
+        NumToImport = 0;
+        NumImported = 0;
+
+        return NumFailed;
+    }
+} // namespace lucid::resources
@@ -0,0 +1,305 @@
+#include "resources/geometry_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+#include "devices/gpu/buffer.hpp"
+#include "devices/gpu/vao.hpp"
+
+#include "common/log.hpp"
+#include "common/strings.hpp"
+
+namespace lucid::resources
+{
+    static constexpr u32 INITIAL_POOL_VERTEX_COUNT  = 1 << 18;
+    static constexpr u32 INITIAL_POOL_ELEMENT_COUNT = 1 << 20;
+
+    u16 FVertexLayout::GetVertexSize() const
+    {
+        u16 VertexSize = 0;
+        if (bHasPositions)
+        {
+            VertexSize += sizeof(float) * 3;
+        }
+
+        if (bHasNormals)
+        {
+            VertexSize += sizeof(float) * 3;
+        }
+
+        if (bHasTangents)
+        {
+            VertexSize += sizeof(float) * 3;
+        }
+
+        if (bHasUVs)
+        {
+            VertexSize += sizeof(float) * 2;
+        }
+        return VertexSize;
+    }
+
+    u16 FVertexLayout::GetKey() const
+    {
+        return (bHasPositions << 0) | (bHasNormals << 1) | (bHasTangents << 2) | (bHasUVs << 3) | (bIndexed << 4) | (DrawMode << 5);
+    }
+
+    void CRangeAllocator::Init(const u32& InCapacity)
+    {
+        Capacity     = InCapacity;
+        NumAllocated = 0;
+        FreeRanges   = { { 0, InCapacity } };
+    }
+
+    u32 CRangeAllocator::Allocate(const u32& InCount)
+    {
+        for (u32 i = 0; i < FreeRanges.size(); ++i)
+        {
+            FFreeRange& FreeRange = FreeRanges[i];
+            if (FreeRange.Count < InCount)
+            {
+                continue;
+            }
+
+            const u32 Offset = FreeRange.Offset;
+            FreeRange.Offset += InCount;
+            FreeRange.Count -= InCount;
+
+            if (FreeRange.Count == 0)
+            {
+                FreeRanges.erase(FreeRanges.begin() + i);
+            }
+
+            NumAllocated += InCount;
+            return Offset;
+        }
+
+        return INVALID_OFFSET;
+    }
+
+    void CRangeAllocator::Free(const u32& InOffset, const u32& InCount)
+    {
+        if (InCount == 0)
+        {
+            return;
+        }
+
+        assert(NumAllocated >= InCount);
+        NumAllocated -= InCount;
+
+        // Find the first free range after the freed one
+        auto NextIt = std::lower_bound(
+          FreeRanges.begin(), FreeRanges.end(), InOffset, [](const FFreeRange& InFreeRange, const u32& InValue) { return InFreeRange.Offset < InValue; });
+
+        const bool bMergeWithPrev = NextIt != FreeRanges.begin() && ((NextIt - 1)->Offset + (NextIt - 1)->Count) == InOffset;
+        const bool bMergeWithNext = NextIt != FreeRanges.end() && (InOffset + InCount) == NextIt->Offset;
+
+        if (bMergeWithPrev && bMergeWithNext)
+        {
+            (NextIt - 1)->Count += InCount + NextIt->Count;
+            FreeRanges.erase(NextIt);
+        }
+        else if (bMergeWithPrev)
+        {
+            (NextIt - 1)->Count += InCount;
+        }
+        else if (bMergeWithNext)
+        {
+            NextIt->Offset = InOffset;
+            NextIt->Count += InCount;
+        }
+        else
+        {
+            FreeRanges.insert(NextIt, { InOffset, InCount });
+        }
+    }
+
+    void CRangeAllocator::Grow(const u32& InNewCapacity)
+    {
+        assert(InNewCapacity > Capacity);
+
+        const u32 OldCapacity = Capacity;
+        Capacity              = InNewCapacity;
+
+        // Free() merges the new space with the free range at the end if there is one
+        NumAllocated += InNewCapacity - OldCapacity;
+        Free(OldCapacity, InNewCapacity - OldCapacity);
+    }
+
+    FGeometryAllocation CGeometryPool::Allocate(const FVertexLayout& InLayout,
+                                                const void*          InVertexData,
+                                                const u32&           InVertexCount,
+                                                const u32*           InElementData,
+                                                const u32&           InElementCount)
+    {
+        assert(InLayout.bIndexed == (InElementData != nullptr));
+
+        FLayoutPool& Pool       = GetOrCreatePool(InLayout);
+        const u16    VertexSize = InLayout.GetVertexSize();
+
+        FGeometryAllocation Allocation;
+        Allocation.VAO          = Pool.VAO;
+        Allocation.VertexCount  = InVertexCount;
+        Allocation.ElementCount = InLayout.bIndexed ? InElementCount : 0;
+
+        // Vertex data
+        Allocation.BaseVertex = Pool.Vertices.Allocate(InVertexCount);
+        if (Allocation.BaseVertex == CRangeAllocator::INVALID_OFFSET)
+        {
+            GrowBuffer(Pool, false, InVertexCount);
+            Allocation.BaseVertex = Pool.Vertices.Allocate(InVertexCount);
+            assert(Allocation.BaseVertex != CRangeAllocator::INVALID_OFFSET);
+        }
+
+        gpu::FBufferDescription BufferDescription;
+        BufferDescription.Data   = (void*)InVertexData;
+        BufferDescription.Offset = Allocation.BaseVertex * VertexSize;
+        BufferDescription.Size   = InVertexCount * VertexSize;
+        Pool.VertexBuffer->Upload(&BufferDescription);
+
+        // Element data
+        if (InLayout.bIndexed)
+        {
+            Allocation.FirstIndex = Pool.Elements.Allocate(InElementCount);
+            if (Allocation.FirstIndex == CRangeAllocator::INVALID_OFFSET)
+            {
+                GrowBuffer(Pool, true, InElementCount);
+                Allocation.FirstIndex = Pool.Elements.Allocate(InElementCount);
+                assert(Allocation.FirstIndex != CRangeAllocator::INVALID_OFFSET);
+            }
+
+            // Indices stay relative to the submesh, the base vertex is applied when drawing
+            BufferDescription.Data   = (void*)InElementData;
+            BufferDescription.Offset = Allocation.FirstIndex * sizeof(u32);
+            BufferDescription.Size   = InElementCount * sizeof(u32);
+            Pool.ElementBuffer->Upload(&BufferDescription);
+        }
+
+        return Allocation;
+    }
+
+    void CGeometryPool::Free(const FVertexLayout& InLayout, const FGeometryAllocation& InAllocation)
+    {
+        const auto PoolIt = PoolsByLayout.find(InLayout.GetKey());
+        if (PoolIt == PoolsByLayout.end())
+        {
+            LUCID_LOG(ELogLevel::WARN, "Trying to free geometry from a pool that doesn't exist");
+            return;
+        }
+
+        PoolIt->second.Vertices.Free(InAllocation.BaseVertex, InAllocation.VertexCount);
+        PoolIt->second.Elements.Free(InAllocation.FirstIndex, InAllocation.ElementCount);
+    }
+
+    void CGeometryPool::FreeAll()
+    {
+        for (auto& It : PoolsByLayout)
+        {
+            It.second.VAO->Free();
+            delete It.second.VAO;
+
+            It.second.VertexBuffer->Free();
+            delete It.second.VertexBuffer;
+
+            if (It.second.ElementBuffer)
+            {
+                It.second.ElementBuffer->Free();
+                delete It.second.ElementBuffer;
+            }
+        }
+        PoolsByLayout.clear();
+    }
+
+    CGeometryPool::FLayoutPool& CGeometryPool::GetOrCreatePool(const FVertexLayout& InLayout)
+    {
+        const u16  LayoutKey = InLayout.GetKey();
+        const auto PoolIt    = PoolsByLayout.find(LayoutKey);
+        if (PoolIt != PoolsByLayout.end())
+        {
+            return PoolIt->second;
+        }
+
+        FLayoutPool& Pool = PoolsByLayout[LayoutKey];
+        Pool.Layout       = InLayout;
+
+        const u16 VertexSize = InLayout.GetVertexSize();
+
+        gpu::FBufferDescription BufferDescription;
+        BufferDescription.Size = INITIAL_POOL_VERTEX_COUNT * VertexSize;
+        Pool.VertexBuffer      = gpu::CreateBuffer(BufferDescription, gpu::EBufferUsage::STATIC_DRAW, SPrintf("GeometryPool_%d_VertexBuffer", LayoutKey));
+        Pool.Vertices.Init(INITIAL_POOL_VERTEX_COUNT);
+
+        if (InLayout.bIndexed)
+        {
+            BufferDescription.Size = INITIAL_POOL_ELEMENT_COUNT * sizeof(u32);
+            Pool.ElementBuffer = gpu::CreateBuffer(BufferDescription, gpu::EBufferUsage::STATIC_DRAW, SPrintf("GeometryPool_%d_ElementBuffer", LayoutKey));
+            Pool.Elements.Init(INITIAL_POOL_ELEMENT_COUNT);
+        }
+
+        FArray<gpu::FVertexAttribute> VertexAttributes(4);
+
+        u32 FirstElemOffset = 0;
+        if (InLayout.bHasPositions)
+        {
+            VertexAttributes.Add({ 0, 3, EType::FLOAT, false, VertexSize, FirstElemOffset, 0 });
+            FirstElemOffset += sizeof(float) * 3;
+        }
+
+        if (InLayout.bHasNormals)
+        {
+            VertexAttributes.Add({ 1, 3, EType::FLOAT, false, VertexSize, FirstElemOffset, 0 });
+            FirstElemOffset += sizeof(float) * 3;
+        }
+
+        if (InLayout.bHasTangents)
+        {
+            VertexAttributes.Add({ 2, 3, EType::FLOAT, false, VertexSize, FirstElemOffset, 0 });
+            FirstElemOffset += sizeof(float) * 3;
+        }
+
+        if (InLayout.bHasUVs)
+        {
+            VertexAttributes.Add({ 3, 2, EType::FLOAT, false, VertexSize, FirstElemOffset, 0 });
+        }
+
+        // Buffers are owned by the pool as they're replaced when the pool grows
+        Pool.VAO =
+          gpu::CreateVertexArray(SPrintf("GeometryPool_%d_VAO", LayoutKey), VertexAttributes, Pool.VertexBuffer, Pool.ElementBuffer, InLayout.DrawMode, 0, 0, false);
+
+        return Pool;
+    }
+
+    void CGeometryPool::GrowBuffer(FLayoutPool& InPool, const bool& InbElementBuffer, const u32& InRequiredCount)
+    {
+        CRangeAllocator& Allocator   = InbElementBuffer ? InPool.Elements : InPool.Vertices;
+        gpu::CGPUBuffer* OldBuffer   = InbElementBuffer ? InPool.ElementBuffer : InPool.VertexBuffer;
+        const u32        ElementSize = InbElementBuffer ? sizeof(u32) : InPool.Layout.GetVertexSize();
+        const u32        NewCapacity = std::max(Allocator.GetCapacity() * 2, Allocator.GetCapacity() + InRequiredCount);
+
+        LUCID_LOG(ELogLevel::INFO, "Growing geometry pool %d %s buffer to %d entries", InPool.Layout.GetKey(), InbElementBuffer ? "element" : "vertex", NewCapacity);
+
+        gpu::FBufferDescription BufferDescription;
+        BufferDescription.Size = NewCapacity * ElementSize;
+
+        gpu::CGPUBuffer* NewBuffer = gpu::CreateBuffer(BufferDescription,
+                                                       gpu::EBufferUsage::STATIC_DRAW,
+                                                       SPrintf("GeometryPool_%d_%s", InPool.Layout.GetKey(), InbElementBuffer ? "ElementBuffer" : "VertexBuffer"));
+        OldBuffer->CopyDataTo(NewBuffer, Allocator.GetCapacity() * ElementSize);
+
+        if (InbElementBuffer)
+        {
+            InPool.VAO->SetElementBuffer(NewBuffer);
+            InPool.ElementBuffer = NewBuffer;
+        }
+        else
+        {
+            InPool.VAO->SetVertexBuffer(NewBuffer);
+            InPool.VertexBuffer = NewBuffer;
+        }
+
+        OldBuffer->Free();
+        delete OldBuffer;
+
+        Allocator.Grow(NewCapacity);
+    }
+} // namespace lucid::resources
@@ -21,6 +21,7 @@
 #include "assimp/postprocess.h"
 
 #include "resources/texture_resource.hpp"
+#include "resources/geometry_pool.hpp"
 #include "resources/serialization_versions.hpp"
 
 #include "platform/util.hpp"
@@ -35,6 +36,18 @@ namespace lucid::resources
 {
 #define SUBMESH_INFO_SIZE (((sizeof(u32) * 4) + (sizeof(bool) * 4)))
 
+    static FVertexLayout GetSubMeshVertexLayout(const FSubMesh* InSubMesh, const gpu::EDrawMode& InDrawMode)
+    {
+        FVertexLayout VertexLayout;
+        VertexLayout.bHasPositions = InSubMesh->bHasPositions;
+        VertexLayout.bHasNormals   = InSubMesh->bHasNormals;
+        VertexLayout.bHasTangents  = InSubMesh->bHasTangetns;
+        VertexLayout.bHasUVs       = InSubMesh->bHasUVs;
+        VertexLayout.bIndexed      = InSubMesh->ElementCount > 0;
+        VertexLayout.DrawMode      = InDrawMode;
+        return VertexLayout;
+    }
+
     CMeshResource::CMeshResource(const UUID&        InID,
                                  const FString&     InName,
                                  const FString&     InFilePath,
@@ -90,21 +103,9 @@ namespace lucid::resources
         }
     }
 
-    void CMeshResource::LoadDataToMainMemorySynchronously()
+    u64 CMeshResource::GetDataOffset() const
     {
-        if (bLoadedToMainMemory)
-        {
-            return;
-        }
-
-        FILE* MeshFile;
-        if (fopen_s(&MeshFile, *FilePath, "rb") != 0)
-        {
-            LUCID_LOG(ELogLevel::WARN, "Failed to open file %s", *FilePath);
-            return;
-        }
-        // Position the file pointer to the beginning of mesh data
-        u32 VertexDataOffset = Offset + RESOURCE_FILE_HEADER_SIZE + Name.GetLength() + sizeof(u16) + (SUBMESH_INFO_SIZE * SubMeshes.GetLength());
+        u64 VertexDataOffset = RESOURCE_FILE_HEADER_SIZE + Name.GetLength() + sizeof(u16) + (SUBMESH_INFO_SIZE * SubMeshes.GetLength());
 
         if (AssetSerializationVersion > 0)
         {
@@ -121,7 +122,42 @@ namespace lucid::resources
             VertexDataOffset += sizeof(DrawMode);
         }
 
-        fseek(MeshFile, VertexDataOffset, SEEK_SET);
+        return VertexDataOffset;
+    }
+
+    void CMeshResource::LoadDataToMainMemorySynchronously()
+    {
+        if (bLoadedToMainMemory)
+        {
+            if (bMainMemoryMapped)
+            {
+                // Replace the read-only mapped data with a copy that the caller owns
+                for (u16 i = 0; i < SubMeshes.GetLength(); ++i)
+                {
+                    FSubMesh* SubMesh = SubMeshes[i];
+
+                    SubMesh->VertexDataBuffer.Pointer = (char*)CopyBytes(SubMesh->VertexDataBuffer.Pointer, SubMesh->VertexDataBuffer.Size);
+                    if (SubMesh->ElementDataBuffer.Pointer)
+                    {
+                        SubMesh->ElementDataBuffer.Pointer = (char*)CopyBytes(SubMesh->ElementDataBuffer.Pointer, SubMesh->ElementDataBuffer.Size);
+                    }
+                }
+
+                UnmapResourceFile();
+                bMainMemoryMapped = false;
+            }
+            return;
+        }
+
+        FILE* MeshFile;
+        if (fopen_s(&MeshFile, *FilePath, "rb") != 0)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Failed to open file %s", *FilePath);
+            return;
+        }
+
+        // Position the file pointer to the beginning of mesh data
+        _fseeki64(MeshFile, Offset + GetDataOffset(), SEEK_SET);
 
         // Read vertex and element data for each submesh
         for (u16 i = 0; i < SubMeshes.GetLength(); ++i)
@@ -148,7 +184,44 @@ namespace lucid::resources
         // Close the file
         fclose(MeshFile);
         bLoadedToMainMemory = true;
-        IsVideoMemoryFreed  = false;
+        IsMainMemoryFreed   = false;
+    }
+
+    void CMeshResource::MapDataToMainMemory()
+    {
+        if (bLoadedToMainMemory)
+        {
+            return;
+        }
+
+        const char* ResourceData = MapResourceFile();
+        if (ResourceData == nullptr)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Failed to map file %s", *FilePath);
+            return;
+        }
+
+        // Submeshes are stored one after another, vertex data first
+        char* SubMeshData = (char*)ResourceData + GetDataOffset();
+        for (u16 i = 0; i < SubMeshes.GetLength(); ++i)
+        {
+            FSubMesh* SubMesh = SubMeshes[i];
+
+            SubMesh->VertexDataBuffer.Pointer = SubMeshData;
+            SubMesh->VertexDataBuffer.Size    = SubMesh->VertexDataBuffer.Capacity;
+            SubMeshData += SubMesh->VertexDataBuffer.Capacity;
+
+            if (SubMesh->ElementDataBuffer.Capacity > 0)
+            {
+                SubMesh->ElementDataBuffer.Pointer = SubMeshData;
+                SubMesh->ElementDataBuffer.Size    = SubMesh->ElementDataBuffer.Capacity;
+                SubMeshData += SubMesh->ElementDataBuffer.Capacity;
+            }
+        }
+
+        bMainMemoryMapped   = true;
+        bLoadedToMainMemory = true;
+        IsMainMemoryFreed   = false;
     }
 
     void CMeshResource::LoadDataToVideoMemorySynchronously()
@@ -158,16 +231,29 @@ namespace lucid::resources
             return;
         }
 
-        // For now we require for the data to be loaded in the main memory
+        // The data is uploaded straight from the mapped file, no heap copy needed
         if (!bLoadedToMainMemory)
         {
-            LoadDataToMainMemorySynchronously();
+            MapDataToMainMemory();
         }
 
         for (u16 i = 0; i < SubMeshes.GetLength(); ++i)
         {
             FSubMesh* SubMesh = SubMeshes[i];
 
+            if (bUseGeometryPool)
+            {
+                const FGeometryAllocation Allocation = GEngine.GetGeometryPool().Allocate(GetSubMeshVertexLayout(SubMesh, DrawMode),
+                                                                                          SubMesh->VertexDataBuffer.Pointer,
+                                                                                          SubMesh->VertexCount,
+                                                                                          (u32*)SubMesh->ElementDataBuffer.Pointer,
+                                                                                          SubMesh->ElementCount);
+                SubMesh->VAO        = Allocation.VAO;
+                SubMesh->BaseVertex = Allocation.BaseVertex;
+                SubMesh->FirstIndex = Allocation.FirstIndex;
+                continue;
+            }
+
             gpu::FBufferDescription GPUBufferDescription;
 
             // Sending vertex data to the gpu
@@ -244,7 +330,7 @@ namespace lucid::resources
         }
 
         bLoadedToVideoMemory = true;
-        IsMainMemoryFreed    = false;
+        IsVideoMemoryFreed   = false;
     }
 
     void CMeshResource::SaveSynchronously(FILE* ResourceFile) const
@@ -313,8 +399,20 @@ namespace lucid::resources
         {
             for (u16 i = 0; i < SubMeshes.GetLength(); ++i)
             {
-                free(SubMeshes[i]->VertexDataBuffer.Pointer);
-                free(SubMeshes[i]->ElementDataBuffer.Pointer);
+                if (!bMainMemoryMapped)
+                {
+                    free(SubMeshes[i]->VertexDataBuffer.Pointer);
+                    free(SubMeshes[i]->ElementDataBuffer.Pointer);
+                }
+
+                SubMeshes[i]->VertexDataBuffer.Pointer  = nullptr;
+                SubMeshes[i]->ElementDataBuffer.Pointer = nullptr;
+            }
+
+            if (bMainMemoryMapped)
+            {
+                UnmapResourceFile();
+                bMainMemoryMapped = false;
             }
 
             IsMainMemoryFreed   = true;
@@ -328,11 +426,32 @@ namespace lucid::resources
         {
             for (u16 i = 0; i < SubMeshes.GetLength(); ++i)
             {
-                SubMeshes[i]->VAO->Free();
+                FSubMesh* SubMesh = SubMeshes[i];
 
-                delete SubMeshes[i]->VAO;
-                delete SubMeshes[i]->VertexBuffer;
-                delete SubMeshes[i]->ElementBuffer;
+                // Submeshes without their own buffers live in the geometry pool
+                if (SubMesh->VertexBuffer == nullptr)
+                {
+                    FGeometryAllocation Allocation;
+                    Allocation.VAO          = SubMesh->VAO;
+                    Allocation.BaseVertex   = SubMesh->BaseVertex;
+                    Allocation.VertexCount  = SubMesh->VertexCount;
+                    Allocation.FirstIndex   = SubMesh->FirstIndex;
+                    Allocation.ElementCount = SubMesh->ElementCount;
+
+                    GEngine.GetGeometryPool().Free(GetSubMeshVertexLayout(SubMesh, DrawMode), Allocation);
+                    SubMesh->VAO = nullptr;
+                    continue;
+                }
+
+                SubMesh->VAO->Free();
+
+                delete SubMesh->VAO;
+                delete SubMesh->VertexBuffer;
+                delete SubMesh->ElementBuffer;
+
+                SubMesh->VAO           = nullptr;
+                SubMesh->VertexBuffer  = nullptr;
+                SubMesh->ElementBuffer = nullptr;
             }
 
             IsVideoMemoryFreed   = true;
@@ -348,8 +467,6 @@ namespace lucid::resources
 
     CResourcesHolder<CMeshResource> MeshesHolder;
 
-    static Assimp::Importer AssimpImporter;
-
     static constexpr u32 ASSIMP_DEFAULT_FLAGS =
       aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_OptimizeMeshes | aiProcess_JoinIdenticalVertices | aiProcess_Triangulate;
 
@@ -431,58 +548,43 @@ namespace lucid::resources
         return MeshSize;
     }
 
-    static void AddAssetsToEngine(scene::CStaticMesh* InStaticMesh, CMeshResource* InMesh)
-    {
-        // Save actor to file
-        InStaticMesh->SaveAssetToFile();
-
-        // Save mesh to file
-        FILE* ImportedMeshFile;
-        fopen_s(&ImportedMeshFile, *InMesh->GetFilePath(), "wb");
-        InMesh->SaveSynchronously(ImportedMeshFile);
-        fclose(ImportedMeshFile);
-
-        // Add assets and resoruce to the engine
-        GEngine.AddActorAsset(InStaticMesh);
-        GEngine.AddMeshResource(InMesh);
-    }
-
     static void LoadAssimpNode(aiNode* Node, const aiScene* Scene, FMeshInfoHelper& MeshData);
     static void LoadAssimpNodeAsSingleMesh(aiNode* Node, const aiScene* Scene, FMeshInfoHelper& MeshData, FMeshImportInfo& CombinedMeshInfo);
     static void LoadAssimpMesh(aiMesh* Mesh, FMeshInfoHelper& MeshData);
     static void LoadAssimpMeshAsSingleMesh(aiMesh* Mesh, FMeshInfoHelper& MeshData, FMeshImportInfo& CombinedMesh);
 
-    static CTextureResource* AssimpImportMaterialTexture(const u8&      InIndex,
-                                                         const FString& ModelFileDir,
-                                                         aiMaterial*    Material,
-                                                         aiTextureType  TextureType,
-                                                         const FString& MeshName,
-                                                         const FString& TextureTypeName,
-                                                         const bool&    InFlipUV);
-
-    FArray<CMeshResource*>
-    ImportMesh(const FString& InMeshFilePath, const FString& MeshName, const bool& InbFilpUVs, const EMeshImportStretegy& InMeshImportStrategy)
+    static i32 AssimpAddMaterialTexture(const FString& InMeshDirPath,
+                                        aiMaterial*    Material,
+                                        aiTextureType  TextureType,
+                                        const FString& MeshName,
+                                        const FString& TextureTypeName,
+                                        const bool&    InFlipUV,
+                                        FImportedMesh& OutImportedMesh);
+
+    bool ImportMeshData(const FString&             InMeshFilePath,
+                        const FString&             MeshName,
+                        const bool&                InbFilpUVs,
+                        const EMeshImportStretegy& InMeshImportStrategy,
+                        FImportedMesh&             OutImportedMesh)
     {
-#ifndef NDEBUG
         real StartTime = platform::GetCurrentTimeSeconds();
-#endif
 
-        auto           AssimpFlags = ASSIMP_DEFAULT_FLAGS;
-        const aiScene* Root        = AssimpImporter.ReadFile(*InMeshFilePath, AssimpFlags);
+        // Assimp::Importer isn't thread safe, so each import gets it's own
+        Assimp::Importer AssimpImporter;
+        const aiScene*   Root = AssimpImporter.ReadFile(*InMeshFilePath, ASSIMP_DEFAULT_FLAGS);
 
         LUCID_LOG(ELogLevel::INFO, "Reading mesh with assimp %s took %f", *InMeshFilePath, platform::GetCurrentTimeSeconds() - StartTime);
 
         if (!Root || Root->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !Root->mRootNode)
         {
             LUCID_LOG(ELogLevel::WARN, "Assimp failed to load model %s", AssimpImporter.GetErrorString())
-            return { 0, false };
+            return false;
         }
 
         FMeshInfoHelper MeshInfoHelper;
 
-#ifndef NDEBUG
         StartTime = platform::GetCurrentTimeSeconds();
-#endif
+
         MeshInfoHelper.AABB.MinX = MeshInfoHelper.AABB.MinY = MeshInfoHelper.AABB.MinZ = FLT_MAX;
         MeshInfoHelper.AABB.MaxX = MeshInfoHelper.AABB.MaxY = MeshInfoHelper.AABB.MaxZ = 0;
 
@@ -492,23 +594,11 @@ namespace lucid::resources
         FDString              MeshFileDirPath = CopyToString(MeshFilePath.parent_path().string().c_str()); // @TODO .string().c_str()
                                                                                               // once we support wchars
 
-        FArray<CMeshResource*> ImportedMeshes{ InMeshImportStrategy == EMeshImportStretegy::SPLIT_MESHES ? Root->mNumMeshes : 1, false };
+        OutImportedMesh.ImportStrategy = InMeshImportStrategy;
 
         // Load meshes to main memory and create MeshResources for them
         if (InMeshImportStrategy == EMeshImportStretegy::SINGLE_MESH)
         {
-            math::FAABB AABB{ MeshInfoHelper.AABB.MinX, MeshInfoHelper.AABB.MaxX, MeshInfoHelper.AABB.MinY,
-                              MeshInfoHelper.AABB.MaxY, MeshInfoHelper.AABB.MinZ, MeshInfoHelper.AABB.MaxZ };
-
-            auto* ImportedMesh = new CMeshResource{ sole::uuid4(),
-                                                    MeshName,
-                                                    SPrintf("assets/meshes/%s.asset", *MeshName),
-                                                    0,
-                                                    MeshDataSize.VertexDataSize + MeshDataSize.ElementDataSize,
-                                                    MESH_SERIALIZATION_VERSION,
-                                                    AABB };
-            ImportedMeshes.Add(ImportedMesh);
-
             FMeshImportInfo CombinedMeshInfo{};
             CombinedMeshInfo.VertexData = CreateMemBuffer(MeshDataSize.VertexDataSize);
             if (MeshDataSize.ElementDataSize > 0)
@@ -518,6 +608,16 @@ namespace lucid::resources
 
             LoadAssimpNodeAsSingleMesh(Root->mRootNode, Root, MeshInfoHelper, CombinedMeshInfo);
 
+            // The AABB is known only after the vertices are read
+            auto* ImportedMesh = new CMeshResource{ sole::uuid4(),
+                                                    CopyToString(*MeshName, MeshName.GetLength()),
+                                                    SPrintf("assets/meshes/%s.asset", *MeshName),
+                                                    0,
+                                                    MeshDataSize.VertexDataSize + MeshDataSize.ElementDataSize,
+                                                    MESH_SERIALIZATION_VERSION,
+                                                    MeshInfoHelper.AABB };
+            OutImportedMesh.Meshes.push_back(ImportedMesh);
+
             FSubMesh CombinedMesh;
             CombinedMesh.bHasPositions     = Root->mMeshes[0]->HasPositions();
             CombinedMesh.bHasNormals       = Root->mMeshes[0]->HasNormals();
@@ -547,7 +647,7 @@ namespace lucid::resources
                                                             SubMeshInfo->VertexData.Size + SubMeshInfo->ElementData.Size,
                                                             MESH_SERIALIZATION_VERSION,
                                                             SubMeshInfo->AABB };
-                    ImportedMeshes.Add(ImportedMesh);
+                    OutImportedMesh.Meshes.push_back(ImportedMesh);
 
                     FSubMesh SubMesh;
                     SubMesh.MaterialIndex     = 0;
@@ -565,13 +665,13 @@ namespace lucid::resources
             else
             {
                 auto* ImportedMesh = new CMeshResource{ sole::uuid4(),
-                                                        MeshName,
+                                                        CopyToString(*MeshName, MeshName.GetLength()),
                                                         SPrintf("assets/meshes/%s.asset", *MeshName),
                                                         0,
                                                         MeshDataSize.VertexDataSize + MeshDataSize.ElementDataSize,
                                                         MESH_SERIALIZATION_VERSION,
                                                         MeshInfoHelper.AABB };
-                ImportedMeshes.Add(ImportedMesh);
+                OutImportedMesh.Meshes.push_back(ImportedMesh);
 
                 for (u16 i = 0; i < MeshInfoHelper.SubMeshes.GetLength(); ++i)
                 {
@@ -590,139 +690,205 @@ namespace lucid::resources
             }
         }
 
-        // Create actors for the meshes
-        if (InMeshImportStrategy == EMeshImportStretegy::SPLIT_MESHES)
+        LUCID_LOG(ELogLevel::INFO, "Interleaving mesh %s data took %f", *MeshName, platform::GetCurrentTimeSeconds() - StartTime);
+
+        // Write the mesh files, from now on the meshes are loaded from there
+        for (CMeshResource* ImportedMesh : OutImportedMesh.Meshes)
         {
-            FArray<scene::CMaterial*> ImportedMaterials{ 1, true };
+            ImportedMesh->SaveSynchronously();
+            for (u32 j = 0; j < ImportedMesh->SubMeshes.GetLength(); ++j)
+            {
+                ImportedMesh->SubMeshes[j]->VertexDataBuffer.Free();
+                ImportedMesh->SubMeshes[j]->ElementDataBuffer.Free();
+            }
+        }
 
-            // Load materials
-            for (int MaterialIndex = 0; MaterialIndex < Root->mNumMaterials; ++MaterialIndex)
+        // Collect the materials, their textures are imported by ImportMeshTexture()
+        std::vector<i32> MaterialIndexMap(Root->mNumMaterials, -1);
+        for (u32 MaterialIndex = 0; MaterialIndex < Root->mNumMaterials; ++MaterialIndex)
+        {
+            aiMaterial* Material = Root->mMaterials[MaterialIndex];
+
+            aiString MaterialName;
+            Material->Get(AI_MATKEY_NAME, MaterialName);
+            if (InMeshImportStrategy == EMeshImportStretegy::SPLIT_MESHES && MaterialName == aiString("Default"))
             {
-                aiMaterial* Material = Root->mMaterials[MaterialIndex];
+                continue;
+            }
 
-                aiString MaterialName;
-                Material->Get(AI_MATKEY_NAME, MaterialName);
-                if (MaterialName == aiString("Default"))
-                {
-                    continue;
-                }
+            FImportedMeshMaterial ImportedMaterial;
+            ImportedMaterial.Name = SPrintf("%s_%s", *MeshName, MaterialName.C_Str());
+            ImportedMaterial.DiffuseMapIndex =
+              AssimpAddMaterialTexture(MeshFileDirPath, Material, aiTextureType_DIFFUSE, MeshName, FString{ "Diffuse" }, InbFilpUVs, OutImportedMesh);
+            ImportedMaterial.NormalMapIndex =
+              AssimpAddMaterialTexture(MeshFileDirPath, Material, aiTextureType_HEIGHT, MeshName, FString{ "Normal" }, InbFilpUVs, OutImportedMesh);
 
-#ifndef NDEBUG
-                StartTime = platform::GetCurrentTimeSeconds();
-#endif
-                CTextureResource* DiffuseMap =
-                  AssimpImportMaterialTexture(0, MeshFileDirPath, Material, aiTextureType_DIFFUSE, MeshName, FString{ "Diffuse" }, InbFilpUVs);
-                CTextureResource* NormalMap =
-                  AssimpImportMaterialTexture(0, MeshFileDirPath, Material, aiTextureType_HEIGHT, MeshName, FString{ "Normal" }, InbFilpUVs);
+            MaterialIndexMap[MaterialIndex] = OutImportedMesh.Materials.size();
+            OutImportedMesh.Materials.push_back(ImportedMaterial);
+        }
 
-                auto* ImportedMaterial = new scene::CTexturedPBRMaterial{ sole::uuid4(),
-                                                                             SPrintf("%s_%s", *MeshName, MaterialName.C_Str()),
-                                                                             SPrintf("assets/materials/%s_%s.asset", *MeshName, MaterialName.C_Str()),
-                                                                             GEngine.GetShadersManager().GetShaderByName("Textured PBR") };
+        // Describe the actors for the meshes
+        if (InMeshImportStrategy == EMeshImportStretegy::SPLIT_MESHES)
+        {
+            for (u32 i = 0; i < OutImportedMesh.Meshes.size(); ++i)
+            {
+                FImportedMeshActor ImportedActor;
+                ImportedActor.Name          = SPrintf("%s_%s", *MeshName, MeshInfoHelper.SubMeshes[i]->Name.C_Str());
+                ImportedActor.Mesh          = OutImportedMesh.Meshes[i];
+                ImportedActor.AABB          = MeshInfoHelper.SubMeshes[i]->AABB;
+                ImportedActor.MaterialIndex = MaterialIndexMap[MeshInfoHelper.SubMeshes[i]->MaterialIndex];
+                OutImportedMesh.Actors.push_back(ImportedActor);
+            }
+        }
+        else
+        {
+            FImportedMeshActor ImportedActor;
+            ImportedActor.Name             = CopyToString(*MeshName, MeshName.GetLength());
+            ImportedActor.Mesh             = OutImportedMesh.Meshes[0];
+            ImportedActor.AABB             = MeshInfoHelper.AABB;
+            ImportedActor.bUseAllMaterials = true;
+            OutImportedMesh.Actors.push_back(ImportedActor);
+        }
 
-                ImportedMaterial->SetAlbedoMap(DiffuseMap);
-                ImportedMaterial->SetNormalMap(NormalMap);
-                ImportedMaterial->bIsAsset = true;
+        MeshFileDirPath.Free();
+        return true;
+    }
 
-                ImportedMaterials.Add(ImportedMaterial);
+    void ImportMeshTexture(FImportedMeshTexture& InOutTexture)
+    {
+        FDString TextureResourceFilePath = SPrintf("assets/textures/%s.asset", *InOutTexture.Name);
+
+        InOutTexture.Texture = ImportTexture(InOutTexture.SourcePath,
+                                             TextureResourceFilePath,
+                                             InOutTexture.bGammaCorrect,
+                                             InOutTexture.bNormalMap,
+                                             gpu::ETextureDataType::UNSIGNED_BYTE,
+                                             InOutTexture.bFlipY,
+                                             false,
+                                             InOutTexture.Name);
+
+        if (InOutTexture.Texture == nullptr)
+        {
+            TextureResourceFilePath.Free();
+            return;
+        }
 
-                // Add material do the engine
-                ImportedMaterial->SaveToResourceFile(EFileFormat::Json);
-                GEngine.AddMaterialAsset(ImportedMaterial, scene::EMaterialType::TEXTURED_PBR, ImportedMaterial->AssetPath);
-            }
+        // Write the asset file and the thumbnail before the imported data is freed, it's loaded from there from now on
+        InOutTexture.Texture->SaveSynchronously();
+        InOutTexture.ThumbnailData = InOutTexture.Texture->SaveThumbnail();
+        InOutTexture.Texture->FreeMainMemory();
+    }
 
-            // Create a static mesh actor for each of the submeshes
-            for (u32 i = 0; i < ImportedMeshes.GetLength(); ++i)
-            {
+    static CTextureResource* GetImportedTexture(const FImportedMesh& InImportedMesh, const i32& InTextureIndex)
+    {
+        return InTextureIndex == -1 ? nullptr : InImportedMesh.Textures[InTextureIndex].Texture;
+    }
 
-                auto* ImportedMesh         = *ImportedMeshes[i];
-                auto* StaticMeshActorAsset = new scene::CStaticMesh{ SPrintf("%s_%s", *MeshName, MeshInfoHelper.SubMeshes[i]->Name.C_Str()),
-                                                                     nullptr,
-                                                                     nullptr,
-                                                                     ImportedMesh,
-                                                                     scene::EStaticMeshType::STATIONARY,
-                                                                     MeshInfoHelper.SubMeshes[i]->AABB };
+    bool AddImportedTextureToEngine(FImportedMeshTexture& InImportedTexture)
+    {
+        const bool bImported = InImportedTexture.Texture != nullptr;
+        if (bImported)
+        {
+            GEngine.AddTextureResource(InImportedTexture.Texture, false);
+            InImportedTexture.Texture->CreateThumbnail(InImportedTexture.ThumbnailData.Pointer);
+        }
+        else
+        {
+            LUCID_LOG(ELogLevel::WARN, "Failed to import texture %s", *InImportedTexture.SourcePath);
+            InImportedTexture.Name.Free();
+        }
 
-                StaticMeshActorAsset->AssetId   = sole::uuid4();
-                StaticMeshActorAsset->AssetPath = SPrintf("assets/actors/%s.asset", *StaticMeshActorAsset->Name);
+        InImportedTexture.SourcePath.Free();
+        InImportedTexture.ThumbnailData.Free();
+        return bImported;
+    }
 
-                StaticMeshActorAsset->AddMaterial(*ImportedMaterials[MeshInfoHelper.SubMeshes[i]->MaterialIndex]);
-                AddAssetsToEngine(StaticMeshActorAsset, ImportedMesh);
+    u32 AddImportedMeshToEngine(FImportedMesh& InImportedMesh)
+    {
+        u32 NumFailedTextures = 0;
+        for (FImportedMeshTexture& ImportedTexture : InImportedMesh.Textures)
+        {
+            if (!AddImportedTextureToEngine(ImportedTexture))
+            {
+                ++NumFailedTextures;
             }
+        }
 
-            ImportedMaterials.Free();
+        for (CMeshResource* ImportedMesh : InImportedMesh.Meshes)
+        {
+            GEngine.AddMeshResource(ImportedMesh, false);
         }
-        else
+
+        std::vector<scene::CMaterial*> ImportedMaterials;
+        ImportedMaterials.reserve(InImportedMesh.Materials.size());
+
+        for (const FImportedMeshMaterial& Material : InImportedMesh.Materials)
         {
-            // Create a static mesh actor for this mesh
-            auto* StaticMeshActorAsset = new scene::CStaticMesh{
-                CopyToString(*MeshName, MeshName.GetLength()), nullptr, nullptr, *ImportedMeshes[0], scene::EStaticMeshType::STATIONARY, MeshInfoHelper.AABB
-            };
+            auto* ImportedMaterial = new scene::CTexturedPBRMaterial{ sole::uuid4(),
+                                                                         Material.Name,
+                                                                         SPrintf("assets/materials/%s.asset", *Material.Name),
+                                                                         GEngine.GetShadersManager().GetShaderByName("Textured PBR") };
+
+            ImportedMaterial->SetAlbedoMap(GetImportedTexture(InImportedMesh, Material.DiffuseMapIndex));
+            ImportedMaterial->SetNormalMap(GetImportedTexture(InImportedMesh, Material.NormalMapIndex));
+            ImportedMaterial->bIsAsset = true;
+
+            // Add material do the engine
+            GEngine.AddMaterialAsset(ImportedMaterial, scene::EMaterialType::TEXTURED_PBR, ImportedMaterial->AssetPath);
+            ImportedMaterials.push_back(ImportedMaterial);
+        }
+
+        for (const FImportedMeshActor& Actor : InImportedMesh.Actors)
+        {
+            auto* StaticMeshActorAsset =
+              new scene::CStaticMesh{ Actor.Name, nullptr, nullptr, Actor.Mesh, scene::EStaticMeshType::STATIONARY, Actor.AABB };
+
             StaticMeshActorAsset->AssetId   = sole::uuid4();
-            StaticMeshActorAsset->AssetPath = SPrintf("assets/actors/%s.asset", *MeshName);
+            StaticMeshActorAsset->AssetPath = SPrintf("assets/actors/%s.asset", *Actor.Name);
 
-            // Load materials
-            for (int MaterialIndex = 0; MaterialIndex < Root->mNumMaterials; ++MaterialIndex)
+            if (Actor.bUseAllMaterials)
             {
-                aiMaterial* Material = Root->mMaterials[MaterialIndex];
-
-                aiString MaterialName;
-                Material->Get(AI_MATKEY_NAME, MaterialName);
-
-#ifndef NDEBUG
-                StartTime = platform::GetCurrentTimeSeconds();
-#endif
-                CTextureResource* DiffuseMap =
-                  AssimpImportMaterialTexture(0, MeshFileDirPath, Material, aiTextureType_DIFFUSE, MeshName, FString{ "Diffuse" }, InbFilpUVs);
-                CTextureResource* NormalMap =
-                  AssimpImportMaterialTexture(0, MeshFileDirPath, Material, aiTextureType_HEIGHT, MeshName, FString{ "Normal" }, InbFilpUVs);
-
-                auto* ImportedMaterial = new scene::CTexturedPBRMaterial{ sole::uuid4(),
-                                                                             SPrintf("%s_%s", *MeshName, MaterialName.C_Str()),
-                                                                             SPrintf("assets/materials/%s_%s.asset", *MeshName, MaterialName.C_Str()),
-                                                                             GEngine.GetShadersManager().GetShaderByName("Textured PBR") };
-                ImportedMaterial->SetAlbedoMap(DiffuseMap);
-                ImportedMaterial->SetNormalMap(NormalMap);
-                ImportedMaterial->SetDisplacementMap(nullptr);
-                ImportedMaterial->bIsAsset = true;
-
-                // Use the first material (this should also be the only one in the mesh btw) as the material for the imported mesh
-                if (InMeshImportStrategy == EMeshImportStretegy::SINGLE_MESH && MaterialIndex == 0)
+                for (scene::CMaterial* Material : ImportedMaterials)
                 {
-                    StaticMeshActorAsset->AddMaterial(ImportedMaterial);
+                    StaticMeshActorAsset->AddMaterial(Material);
                 }
-                else
-                {
-                    StaticMeshActorAsset->AddMaterial(ImportedMaterial);
-                }
-
-                // Add material do the engine
-                ImportedMaterial->SaveToResourceFile(EFileFormat::Json);
-                GEngine.AddMaterialAsset(ImportedMaterial, scene::EMaterialType::TEXTURED_PBR, ImportedMaterial->AssetPath);
+            }
+            else if (Actor.MaterialIndex != -1)
+            {
+                StaticMeshActorAsset->AddMaterial(ImportedMaterials[Actor.MaterialIndex]);
             }
 
-            AddAssetsToEngine(StaticMeshActorAsset, StaticMeshActorAsset->MeshResource);
+            StaticMeshActorAsset->SaveAssetToFile();
+            GEngine.AddActorAsset(StaticMeshActorAsset);
         }
 
-        MeshFileDirPath.Free();
+        return NumFailedTextures;
+    }
 
-#ifndef NDEBUG
-        LUCID_LOG(ELogLevel::INFO, "Loading textures of mesh %s took %f", *MeshName, platform::GetCurrentTimeSeconds() - StartTime);
-        LUCID_LOG(ELogLevel::INFO, "Sending mesh %s data to GPU took %f", *MeshName, platform::GetCurrentTimeSeconds() - StartTime);
-#endif
+    FArray<CMeshResource*>
+    ImportMesh(const FString& InMeshFilePath, const FString& MeshName, const bool& InbFilpUVs, const EMeshImportStretegy& InMeshImportStrategy)
+    {
+        FImportedMesh ImportedMesh;
+        if (!ImportMeshData(InMeshFilePath, MeshName, InbFilpUVs, InMeshImportStrategy, ImportedMesh))
+        {
+            return { 0, false };
+        }
 
-        for (u32 i = 0; i < ImportedMeshes.GetLength(); ++i)
+        for (FImportedMeshTexture& ImportedTexture : ImportedMesh.Textures)
         {
-            const FArray<FSubMesh>& CreatedSubmeshs = (*ImportedMeshes[i])->SubMeshes;
-            for (u32 j = 0; j < CreatedSubmeshs.GetLength(); ++j)
-            {
-                (*CreatedSubmeshs[j]).VertexDataBuffer.Free();
-                (*CreatedSubmeshs[j]).ElementDataBuffer.Free();
-            }
+            ImportMeshTexture(ImportedTexture);
         }
 
+        AddImportedMeshToEngine(ImportedMesh);
+        GEngine.SaveResourceDatabase();
+
+        FArray<CMeshResource*> ImportedMeshes{ (u32)ImportedMesh.Meshes.size(), false };
+        for (CMeshResource* Mesh : ImportedMesh.Meshes)
+        {
+            ImportedMeshes.Add(Mesh);
+        }
         return ImportedMeshes;
-    }; // namespace lucid::resources
+    }
 
     static void LoadAssimpNode(aiNode* Node, const aiScene* Scene, FMeshInfoHelper& MeshData)
     {
@@ -943,9 +1109,6 @@ namespace lucid::resources
             VertexDataPointer->y = Mesh->mVertices[i].y;
             VertexDataPointer->z = Mesh->mVertices[i].z;
 
-            VertexDataPointer += 1;
-            CombinedMesh.VertexData.Size += sizeof(glm::vec3);
-
             MeshData.AABB.MinX = VertexDataPointer->x < MeshData.AABB.MinX ? VertexDataPointer->x : MeshData.AABB.MinX;
             MeshData.AABB.MaxX = VertexDataPointer->x > MeshData.AABB.MaxX ? VertexDataPointer->x : MeshData.AABB.MaxX;
 
@@ -955,6 +1118,9 @@ namespace lucid::resources
             MeshData.AABB.MinZ = VertexDataPointer->z < MeshData.AABB.MinZ ? VertexDataPointer->z : MeshData.AABB.MinZ;
             MeshData.AABB.MaxZ = VertexDataPointer->z > MeshData.AABB.MaxZ ? VertexDataPointer->z : MeshData.AABB.MaxZ;
 
+            VertexDataPointer += 1;
+            CombinedMesh.VertexData.Size += sizeof(glm::vec3);
+
             VertexDataPointer->x = Mesh->mNormals[i].x;
             VertexDataPointer->y = Mesh->mNormals[i].y;
             VertexDataPointer->z = Mesh->mNormals[i].z;
@@ -996,74 +1162,53 @@ namespace lucid::resources
         }
     }
 
-    static CTextureResource* AssimpImportMaterialTexture(const u8&      InIndex,
-                                                         const FString& InMeshDirPath,
-                                                         aiMaterial*    Material,
-                                                         aiTextureType  TextureType,
-                                                         const FString& MeshName,
-                                                         const FString& TextureTypeName,
-                                                         const bool&    InFlipUV)
+    static i32 AssimpAddMaterialTexture(const FString& InMeshDirPath,
+                                        aiMaterial*    Material,
+                                        aiTextureType  TextureType,
+                                        const FString& MeshName,
+                                        const FString& TextureTypeName,
+                                        const bool&    InFlipUV,
+                                        FImportedMesh& OutImportedMesh)
     {
-        // Import the texture
         aiString TextureFilePath;
-        if (Material->GetTexture(TextureType, InIndex, &TextureFilePath) == aiReturn_FAILURE)
+        if (Material->GetTexture(TextureType, 0, &TextureFilePath) == aiReturn_FAILURE)
         {
-            return nullptr;
+            return -1;
         }
         std::filesystem::path Path{ TextureFilePath.C_Str() };
         Path.replace_extension("");
 
-        FDString TexturePath             = SPrintf("%s/%s", *InMeshDirPath, TextureFilePath.C_Str());
-        FDString TextureName             = SPrintf("%s_Texture_%s_%s", *MeshName, Path.filename().string().c_str(), *TextureTypeName);
-        FDString TextureResourceFilePath = SPrintf("assets/textures/%s.asset", *TextureName);
+        FDString TextureName = SPrintf("%s_Texture_%s_%s", *MeshName, Path.filename().string().c_str(), *TextureTypeName);
 
-        bool bGammaCorrect = false;
-        switch (TextureType)
+        // Materials often share textures, import them only once
+        for (u32 i = 0; i < OutImportedMesh.Textures.size(); ++i)
         {
-        case aiTextureType_DIFFUSE:
-        case aiTextureType_SPECULAR:
-            bGammaCorrect = true;
-            break;
+            if (OutImportedMesh.Textures[i].Name == TextureName)
+            {
+                TextureName.Free();
+                return i;
+            }
         }
 
-        CTextureResource* Texture =
-          ImportTexture(TexturePath, TextureResourceFilePath, bGammaCorrect, gpu::ETextureDataType::UNSIGNED_BYTE, InFlipUV, false, TextureName);
-        Texture->FreeMainMemory();
-
-        // Update engine resources database
-        GEngine.AddTextureResource(Texture);
+        FImportedMeshTexture ImportedTexture;
+        ImportedTexture.SourcePath = SPrintf("%s/%s", *InMeshDirPath, TextureFilePath.C_Str());
+        ImportedTexture.Name       = TextureName;
+        ImportedTexture.bFlipY     = InFlipUV;
 
-        TexturePath.Free();
-
-        if (Texture == nullptr)
-        {
-            TextureName.Free();
-            LUCID_LOG(ELogLevel::WARN, "Failed to load %s texture of mesh %s", TextureTypeName, MeshName)
-            return GEngine.GetTexturesHolder().GetDefaultResource();
-        }
-
-        // Save to a texture resource
-        FILE* TextureResourceFile = fopen(*TextureResourceFilePath, "wb");
-        if (TextureResourceFile == nullptr)
+        switch (TextureType)
         {
-            TextureResourceFilePath.Free();
-            TextureName.Free();
-
-            LUCID_LOG(ELogLevel::WARN,
-                      "Failed to save save imported %d texture of "
-                      "mesh %s - failed to open the file %s",
-                      *TextureTypeName,
-                      *MeshName,
-                      *TextureResourceFilePath);
-            return GEngine.GetTexturesHolder().GetDefaultResource();
+        case aiTextureType_DIFFUSE:
+        case aiTextureType_SPECULAR:
+            ImportedTexture.bGammaCorrect = true;
+            break;
+        case aiTextureType_HEIGHT:
+            ImportedTexture.bNormalMap = true;
+            break;
         }
 
-        Texture->SaveSynchronously(TextureResourceFile);
-        fclose(TextureResourceFile);
-
-        return Texture;
+        OutImportedMesh.Textures.push_back(ImportedTexture);
+        return OutImportedMesh.Textures.size() - 1;
     }
-
     CMeshResource* LoadMesh(const FString& FilePath)
     {
         FILE* MeshFile;
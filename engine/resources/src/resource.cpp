@@ -1,10 +1,29 @@
 ﻿#include "resources/resource.hpp"
 
+#include <mutex>
+#include <algorithm>
+#include <thread>
+#include <string>
+#include <unordered_map>
+
 #include "common/log.hpp"
+#include "engine/engine.hpp"
+#include "platform/fs.hpp"
 #include "resources/texture_resource.hpp"
+#include "resources/resource_streamer.hpp"
 
 namespace lucid::resources
 {
+    struct FMappedResourceFile
+    {
+        platform::FMappedFile File;
+        u32                   RefCount = 0;
+    };
+
+    /** Resources are mapped from the streamer's workers too */
+    static std::mutex                                           MappedFilesMutex;
+    static std::unordered_map<std::string, FMappedResourceFile> MappedFilesByPath;
+
     CResource::CResource(const UUID&    InID,
                          const FString& InName,
                          const FString& InFilePath,
@@ -15,6 +34,101 @@ namespace lucid::resources
     {
     }
 
+    CResource::~CResource()
+    {
+        if (bStreaming)
+        {
+            GEngine.GetResourceStreamer().Cancel(this);
+        }
+    }
+
+    EResourceState CResource::GetState() const
+    {
+        if (bLoading)
+        {
+            return EResourceState::LOADING;
+        }
+
+        if (bLoadedToVideoMemory)
+        {
+            return EResourceState::RESIDENT;
+        }
+
+        return bLoadedToMainMemory ? EResourceState::IN_MAIN_MEMORY : EResourceState::UNLOADED;
+    }
+
+    void CResource::WaitUntilLoaded() const
+    {
+        // Reads are short, so it's not worth to sleep on a condition variable
+        while (bLoading)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    const char* CResource::MapResourceFile()
+    {
+        std::lock_guard<std::mutex> Lock(MappedFilesMutex);
+
+        FMappedResourceFile& MappedFile = MappedFilesByPath[*FilePath];
+        if (MappedFile.RefCount == 0)
+        {
+            MappedFile.File = platform::MapFile(*FilePath);
+            if (MappedFile.File.Pointer == nullptr)
+            {
+                MappedFilesByPath.erase(*FilePath);
+                return nullptr;
+            }
+        }
+
+        assert(Offset + DataSize <= MappedFile.File.Size);
+        ++MappedFile.RefCount;
+
+        MappedResource     = MappedFile.File.Pointer + Offset;
+        MappedResourceSize = MappedFile.File.Size - Offset;
+        return MappedResource;
+    }
+
+    void CResource::UnmapResourceFile()
+    {
+        std::lock_guard<std::mutex> Lock(MappedFilesMutex);
+
+        auto MappedFileIt = MappedFilesByPath.find(*FilePath);
+        if (MappedFileIt == MappedFilesByPath.end())
+        {
+            LUCID_LOG(ELogLevel::WARN, "Trying to unmap resource %s which isn't mapped", *Name);
+            return;
+        }
+
+        if (--MappedFileIt->second.RefCount == 0)
+        {
+            platform::UnmapFile(MappedFileIt->second.File);
+            MappedFilesByPath.erase(MappedFileIt);
+        }
+
+        MappedResource     = nullptr;
+        MappedResourceSize = 0;
+    }
+
+    void CResource::PrefaultMappedResource() const
+    {
+        static constexpr u64 PAGE_SIZE = 4096;
+
+        if (MappedResource == nullptr)
+        {
+            return;
+        }
+
+        // The metadata between the header and the data is small, so it's fine if it's last page is missed
+        const u64 NumBytesToTouch = std::min<u64>(MappedResourceSize, RESOURCE_FILE_HEADER_SIZE + Name.GetLength() + DataSize);
+
+        volatile char Sink = 0;
+        for (u64 ByteIdx = 0; ByteIdx < NumBytesToTouch; ByteIdx += PAGE_SIZE)
+        {
+            Sink += MappedResource[ByteIdx];
+        }
+    }
+
     void CResource::SaveHeader(FILE* ResourceFile) const
     {
         const u32           NameLength   = Name.GetLength();
@@ -28,6 +142,39 @@ namespace lucid::resources
         fwrite(*Name, Name.GetLength(), 1, ResourceFile);
     }
 
+    bool CResource::Unpack()
+    {
+        if (!bPacked)
+        {
+            return true;
+        }
+
+        assert(bLoadedToMainMemory);
+        if (bMainMemoryMapped)
+        {
+            // The mapping points into the archive, switch to a heap copy before the resource moves to it's own file
+            LoadDataToMainMemorySynchronously();
+        }
+
+        for (FResourceDatabaseEntry& Entry : GEngine.GetResourceDatabase().Entries)
+        {
+            if (Entry.Id == ID)
+            {
+                FilePath = Entry.Path;
+                Offset   = 0;
+                bPacked  = false;
+
+                // The copy in the archive stays out of date until the next cook, so the resource is loaded from it's own file until then
+                Entry.bSavedAfterCook = true;
+                GEngine.SaveResourceDatabase();
+                return true;
+            }
+        }
+
+        LUCID_LOG(ELogLevel::ERR, "Can't unpack resource %s - it's not in the resource database", *Name);
+        return false;
+    }
+
     void CResource::Save(const u32& InAssetSerializationVersion)
     {
         bool  bNeedsFree = false;
@@ -36,6 +183,23 @@ namespace lucid::resources
             bNeedsFree = true;
             LoadDataToMainMemorySynchronously();
         }
+        else if (bMainMemoryMapped)
+        {
+            // The file can't be rewritten while we're reading from it's mapping, so switch to a heap copy
+            LoadDataToMainMemorySynchronously();
+        }
+
+        // Packed resources are read from the archive above, then they're written to their own file
+        if (!Unpack())
+        {
+            LUCID_LOG(ELogLevel::ERR, "Failed to resave resource %s - it's stored in an asset archive", *Name);
+            if (bNeedsFree)
+            {
+                FreeMainMemory();
+            }
+            return;
+        }
+
         FILE* ResourceFile;
         if (fopen_s(&ResourceFile, *FilePath, "wb+") == 0)
         {
@@ -56,7 +220,15 @@ namespace lucid::resources
 
     void CResource::Acquire(const bool& InbNeededInMainMemory, const bool& InbNeededInVideoMemory)
     {
-        bool bLoadedToMainMemoryBefore = bLoadedToMainMemory;
+        WaitUntilLoaded();
+
+        // The streamer still owns the main memory data, it'll free it when it's done unless we need it
+        if (bStreaming)
+        {
+            bStreamedToMainMemory |= InbNeededInMainMemory;
+        }
+
+        bool bLoadedToMainMemoryBefore = bLoadedToMainMemory || bStreaming;
 
         if (InbNeededInMainMemory)
         {
@@ -84,6 +256,35 @@ namespace lucid::resources
         }
     }
 
+    void CResource::AcquireAsync(const bool& InbNeededInMainMemory, const bool& InbNeededInVideoMemory)
+    {
+        if (RefCount == -1)
+        {
+            RefCount = 1;
+        }
+        else
+        {
+            ++RefCount;
+        }
+
+        if (bStreaming)
+        {
+            bStreamedToMainMemory |= InbNeededInMainMemory;
+            bStreamedToVideoMemory |= InbNeededInVideoMemory;
+            return;
+        }
+
+        if ((!InbNeededInMainMemory || bLoadedToMainMemory) && (!InbNeededInVideoMemory || bLoadedToVideoMemory))
+        {
+            return;
+        }
+
+        bStreaming             = true;
+        bStreamedToMainMemory  = InbNeededInMainMemory || bLoadedToMainMemory;
+        bStreamedToVideoMemory = InbNeededInVideoMemory;
+        GEngine.GetResourceStreamer().Enqueue(this);
+    }
+
     void CResource::Release()
     {
         assert(RefCount);
@@ -0,0 +1,207 @@
+#include "resources/resource_streamer.hpp"
+
+#include <algorithm>
+
+#include "engine/engine.hpp"
+
+#include "common/log.hpp"
+#include "common/jobs.hpp"
+
+#include "devices/gpu/buffer.hpp"
+#include "devices/gpu/fence.hpp"
+
+#include "resources/resource.hpp"
+#include "resources/texture_resource.hpp"
+
+namespace lucid::resources
+{
+    /** Texture uploads start at multiples of the biggest texel size, so the unpack alignment rules are always satisfied */
+    static constexpr u32 STAGING_ALIGNMENT = 16;
+
+    static constexpr gpu::EImmutableBufferUsage STAGING_BUFFER_USAGE =
+      (gpu::EImmutableBufferUsage)(gpu::EImmutableBufferUsage::IMM_BUFFER_WRITE | gpu::EImmutableBufferUsage::IMM_BUFFER_COHERENT);
+
+    static constexpr gpu::EBufferMapPolicy STAGING_BUFFER_MAP_POLICY =
+      (gpu::EBufferMapPolicy)(gpu::EBufferMapPolicy::BUFFER_WRITE | gpu::EBufferMapPolicy::BUFFER_COHERENT | gpu::EBufferMapPolicy::BUFFER_PERSISTENT);
+
+    void CResourceStreamer::Setup()
+    {
+        gpu::FBufferDescription BufferDescription;
+        BufferDescription.Size = STAGING_REGION_SIZE * STAGING_REGIONS_COUNT;
+
+        StagingBuffer = gpu::CreateImmutableBuffer(BufferDescription, STAGING_BUFFER_USAGE, "ResourceStreamerStagingBuffer");
+        StagingBuffer->Bind(gpu::EBufferBindPoint::WRITE);
+        StagingBufferMappedPtr = (char*)StagingBuffer->MemoryMap(STAGING_BUFFER_MAP_POLICY);
+        StagingBuffer->Unbind();
+    }
+
+    void CResourceStreamer::Cleanup()
+    {
+        // Workers might still be reading resources
+        GEngine.GetJobSystem().WaitForAll();
+
+        LoadedResources.clear();
+        PendingUploads.clear();
+        NumPendingResources = 0;
+
+        for (u32 i = 0; i < STAGING_REGIONS_COUNT; ++i)
+        {
+            if (StagingFences[i])
+            {
+                StagingFences[i]->Free();
+                delete StagingFences[i];
+                StagingFences[i] = nullptr;
+            }
+        }
+
+        if (StagingBuffer)
+        {
+            StagingBuffer->Bind(gpu::EBufferBindPoint::WRITE);
+            StagingBuffer->MemoryUnmap();
+            StagingBuffer->Free();
+            delete StagingBuffer;
+
+            StagingBuffer          = nullptr;
+            StagingBufferMappedPtr = nullptr;
+        }
+    }
+
+    void CResourceStreamer::Enqueue(CResource* InResource)
+    {
+        ++NumPendingResources;
+
+        if (InResource->bLoadedToMainMemory)
+        {
+            // Only the upload is left
+            PendingUploads.push_back(InResource);
+            return;
+        }
+
+        // Data that's only needed for the upload is read straight from the mapped file
+        const bool bMapData = !InResource->bStreamedToMainMemory;
+
+        InResource->bLoading = true;
+        GEngine.GetJobSystem().Submit([this, InResource, bMapData] {
+            if (bMapData)
+            {
+                // Fault the pages in here, so the main thread doesn't wait for the disk during the upload
+                InResource->MapDataToMainMemory();
+                InResource->PrefaultMappedResource();
+            }
+            else
+            {
+                InResource->LoadDataToMainMemorySynchronously();
+            }
+
+            std::lock_guard<std::mutex> Lock(LoadedResourcesMutex);
+            LoadedResources.push_back(InResource);
+
+            // Cleared under the lock, so Cancel() finds the resource in LoadedResources after waiting for it
+            InResource->bLoading = false;
+        });
+    }
+
+    void CResourceStreamer::Cancel(CResource* InResource)
+    {
+        InResource->WaitUntilLoaded();
+
+        {
+            std::lock_guard<std::mutex> Lock(LoadedResourcesMutex);
+            LoadedResources.erase(std::remove(LoadedResources.begin(), LoadedResources.end(), InResource), LoadedResources.end());
+        }
+
+        PendingUploads.erase(std::remove(PendingUploads.begin(), PendingUploads.end(), InResource), PendingUploads.end());
+
+        InResource->bStreaming = false;
+        --NumPendingResources;
+    }
+
+    void CResourceStreamer::OnFrameBegin()
+    {
+        {
+            std::lock_guard<std::mutex> Lock(LoadedResourcesMutex);
+            PendingUploads.insert(PendingUploads.end(), LoadedResources.begin(), LoadedResources.end());
+            LoadedResources.clear();
+        }
+
+        if (PendingUploads.empty())
+        {
+            return;
+        }
+
+        // Textures go through the next region of the staging buffer, unless the GPU still sources textures from it
+        CurrentStagingRegion = (CurrentStagingRegion + 1) % STAGING_REGIONS_COUNT;
+
+        gpu::CFence*& StagingFence = StagingFences[CurrentStagingRegion];
+        if (StagingFence && StagingFence->Wait(0))
+        {
+            StagingFence->Free();
+            delete StagingFence;
+            StagingFence = nullptr;
+        }
+
+        const bool bStagingRegionAvailable = StagingFence == nullptr;
+        const u32  StagingRegionStart      = CurrentStagingRegion * STAGING_REGION_SIZE;
+        u32        StagingRegionUsed       = 0;
+        u64        UploadedBytes           = 0;
+
+        while (!PendingUploads.empty())
+        {
+            CResource* Resource = PendingUploads.front();
+
+            const bool bStillNeeded = Resource->RefCount != 0 && Resource->RefCount != -1;
+            if (bStillNeeded && Resource->bStreamedToVideoMemory && Resource->bLoadedToMainMemory && !Resource->bLoadedToVideoMemory)
+            {
+                // Always upload at least one resource, so the ones bigger than the budget get uploaded too
+                if (UploadedBytes > 0 && (UploadedBytes + Resource->DataSize) > MaxUploadBytesPerFrame)
+                {
+                    break;
+                }
+
+                if (Resource->GetType() == TEXTURE && bStagingRegionAvailable && (StagingRegionUsed + Resource->DataSize) <= STAGING_REGION_SIZE)
+                {
+                    auto* TextureResource = (CTextureResource*)Resource;
+                    TextureResource->LoadDataToVideoMemoryFromStagingBuffer(StagingBuffer, StagingBufferMappedPtr, StagingRegionStart + StagingRegionUsed);
+                    StagingRegionUsed += (Resource->DataSize + STAGING_ALIGNMENT - 1) & ~(u64)(STAGING_ALIGNMENT - 1);
+                }
+                else
+                {
+                    // Meshes are sub-allocated from the geometry pool which uploads them with glBufferSubData(),
+                    // textures that don't fit in the staging region take the same synchronous path
+                    Resource->LoadDataToVideoMemorySynchronously();
+                }
+
+                UploadedBytes += Resource->DataSize;
+            }
+            else if (!Resource->bLoadedToMainMemory && !Resource->bLoadedToVideoMemory)
+            {
+                LUCID_LOG(ELogLevel::WARN, "Failed to stream resource %s", *Resource->Name);
+            }
+
+            PendingUploads.pop_front();
+            FinishStreaming(Resource);
+        }
+
+        if (StagingRegionUsed > 0)
+        {
+            StagingFence = gpu::CreateFence("ResourceStreamerStagingFence");
+        }
+    }
+
+    void CResourceStreamer::FinishStreaming(CResource* InResource)
+    {
+        InResource->bStreaming = false;
+        --NumPendingResources;
+
+        // The worker read the data only to upload it
+        if (!InResource->bStreamedToMainMemory)
+        {
+            InResource->FreeMainMemory();
+        }
+        else if (InResource->bMainMemoryMapped)
+        {
+            // Main memory was requested while the data was being mapped, the requester expects a copy it owns
+            InResource->LoadDataToMainMemorySynchronously();
+        }
+    }
+} // namespace lucid::resources
@@ -0,0 +1,575 @@
+#include "resources/texture_compression.hpp"
+
+#include "devices/gpu/texture.hpp"
+
+#include "stb_image_resize.h"
+
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace lucid::resources
+{
+    /** Interpolation weights of the 4 bit BC7 indices */
+    static const i32 BC7_WEIGHTS_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    /** Texels of a 4x4 block expanded to RGBA, texels past the edge of the mip repeat the last row and column */
+    struct FBlockTexels
+    {
+        u8 Texels[16][4];
+    };
+
+    /** Writes the bits of a block starting from the least significant one, the block has to be zeroed */
+    struct FBitWriter
+    {
+        u8* Data;
+        u32 BitOffset = 0;
+
+        void Write(const u32& InValue, const u32& InNumBits)
+        {
+            for (u32 i = 0; i < InNumBits; ++i, ++BitOffset)
+            {
+                if ((InValue >> i) & 1)
+                {
+                    Data[BitOffset >> 3] |= 1 << (BitOffset & 7);
+                }
+            }
+        }
+    };
+
+    static void FetchBlock(const u8*     InPixels,
+                           const u32&    InWidth,
+                           const u32&    InHeight,
+                           const u8&     InNumChannels,
+                           const u32&    InBlockX,
+                           const u32&    InBlockY,
+                           FBlockTexels& OutBlock)
+    {
+        for (u32 y = 0; y < 4; ++y)
+        {
+            const u32 PixelY = glm::min(InBlockY * 4 + y, InHeight - 1);
+            for (u32 x = 0; x < 4; ++x)
+            {
+                const u32 PixelX = glm::min(InBlockX * 4 + x, InWidth - 1);
+                const u8* Pixel  = InPixels + (((u64)PixelY * InWidth) + PixelX) * InNumChannels;
+                u8*       Texel  = OutBlock.Texels[(y * 4) + x];
+
+                Texel[0] = Pixel[0];
+                Texel[1] = InNumChannels > 1 ? Pixel[1] : 0;
+                Texel[2] = InNumChannels > 2 ? Pixel[2] : 0;
+                Texel[3] = InNumChannels > 3 ? Pixel[3] : 255;
+            }
+        }
+    }
+
+    /**
+     * Fits a line through the texels of the block and returns it's ends. The line goes along the principal axis of the texels,
+     * which is found with a few power iterations on their covariance matrix.
+     */
+    static void FitEndpoints(const FBlockTexels& InBlock, const u8& InNumChannels, float OutMin[4], float OutMax[4])
+    {
+        float Mean[4]  = { 0, 0, 0, 0 };
+        float BBMin[4] = { 255, 255, 255, 255 };
+        float BBMax[4] = { 0, 0, 0, 0 };
+        for (u8 i = 0; i < 16; ++i)
+        {
+            for (u8 c = 0; c < InNumChannels; ++c)
+            {
+                Mean[c] += InBlock.Texels[i][c];
+                BBMin[c] = glm::min(BBMin[c], (float)InBlock.Texels[i][c]);
+                BBMax[c] = glm::max(BBMax[c], (float)InBlock.Texels[i][c]);
+            }
+        }
+
+        for (u8 c = 0; c < InNumChannels; ++c)
+        {
+            Mean[c] /= 16.f;
+        }
+
+        float Covariance[4][4] = {};
+        for (u8 i = 0; i < 16; ++i)
+        {
+            for (u8 a = 0; a < InNumChannels; ++a)
+            {
+                for (u8 b = 0; b < InNumChannels; ++b)
+                {
+                    Covariance[a][b] += (InBlock.Texels[i][a] - Mean[a]) * (InBlock.Texels[i][b] - Mean[b]);
+                }
+            }
+        }
+
+        // The diagonal of the bounding box is a good first guess, a solid block leaves it at zero
+        float Axis[4] = { 0, 0, 0, 0 };
+        for (u8 c = 0; c < InNumChannels; ++c)
+        {
+            Axis[c] = BBMax[c] - BBMin[c];
+        }
+
+        for (u8 Iteration = 0; Iteration < 8; ++Iteration)
+        {
+            float NextAxis[4]  = { 0, 0, 0, 0 };
+            float MaxComponent = 0;
+            for (u8 a = 0; a < InNumChannels; ++a)
+            {
+                for (u8 b = 0; b < InNumChannels; ++b)
+                {
+                    NextAxis[a] += Covariance[a][b] * Axis[b];
+                }
+                MaxComponent = glm::max(MaxComponent, fabsf(NextAxis[a]));
+            }
+
+            if (MaxComponent < FLT_EPSILON)
+            {
+                break;
+            }
+
+            for (u8 c = 0; c < InNumChannels; ++c)
+            {
+                Axis[c] = NextAxis[c] / MaxComponent;
+            }
+        }
+
+        float AxisLength = 0;
+        for (u8 c = 0; c < InNumChannels; ++c)
+        {
+            AxisLength += Axis[c] * Axis[c];
+        }
+        AxisLength = sqrtf(AxisLength);
+
+        float MinT = 0, MaxT = 0;
+        if (AxisLength > FLT_EPSILON)
+        {
+            for (u8 c = 0; c < InNumChannels; ++c)
+            {
+                Axis[c] /= AxisLength;
+            }
+
+            MinT = FLT_MAX;
+            MaxT = -FLT_MAX;
+            for (u8 i = 0; i < 16; ++i)
+            {
+                float T = 0;
+                for (u8 c = 0; c < InNumChannels; ++c)
+                {
+                    T += (InBlock.Texels[i][c] - Mean[c]) * Axis[c];
+                }
+                MinT = glm::min(MinT, T);
+                MaxT = glm::max(MaxT, T);
+            }
+        }
+
+        for (u8 c = 0; c < 4; ++c)
+        {
+            OutMin[c] = c < InNumChannels ? glm::clamp(Mean[c] + (MinT * Axis[c]), 0.f, 255.f) : 0;
+            OutMax[c] = c < InNumChannels ? glm::clamp(Mean[c] + (MaxT * Axis[c]), 0.f, 255.f) : 0;
+        }
+    }
+
+    static u8 FindClosestPaletteEntry(const u8* InTexel, const i32 (*InPalette)[4], const u8& InPaletteSize, const u8& InNumChannels)
+    {
+        u8  BestEntry = 0;
+        i32 BestError = INT32_MAX;
+        for (u8 i = 0; i < InPaletteSize; ++i)
+        {
+            i32 Error = 0;
+            for (u8 c = 0; c < InNumChannels; ++c)
+            {
+                const i32 Delta = InTexel[c] - InPalette[i][c];
+                Error += Delta * Delta;
+            }
+
+            if (Error < BestError)
+            {
+                BestError = Error;
+                BestEntry = i;
+            }
+        }
+        return BestEntry;
+    }
+
+    static u16 ToRGB565(const float InColor[4])
+    {
+        const u32 R = (u32)((InColor[0] * 31.f / 255.f) + 0.5f);
+        const u32 G = (u32)((InColor[1] * 63.f / 255.f) + 0.5f);
+        const u32 B = (u32)((InColor[2] * 31.f / 255.f) + 0.5f);
+        return (u16)((R << 11) | (G << 5) | B);
+    }
+
+    static void FromRGB565(const u16& InColor, i32 OutColor[4])
+    {
+        const i32 R = (InColor >> 11) & 31;
+        const i32 G = (InColor >> 5) & 63;
+        const i32 B = InColor & 31;
+
+        OutColor[0] = (R << 3) | (R >> 2);
+        OutColor[1] = (G << 2) | (G >> 4);
+        OutColor[2] = (B << 3) | (B >> 2);
+        OutColor[3] = 255;
+    }
+
+    static void EncodeBC1Block(const FBlockTexels& InBlock, u8* OutBlock)
+    {
+        float Min[4], Max[4];
+        FitEndpoints(InBlock, 3, Min, Max);
+
+        u16 Color0 = ToRGB565(Max);
+        u16 Color1 = ToRGB565(Min);
+
+        // Color0 > Color1 selects the four color mode, with equal endpoints the block is solid and all of the indices stay 0
+        if (Color0 < Color1)
+        {
+            const u16 Tmp = Color0;
+            Color0        = Color1;
+            Color1        = Tmp;
+        }
+
+        u32 Indices = 0;
+        if (Color0 != Color1)
+        {
+            i32 Palette[4][4];
+            FromRGB565(Color0, Palette[0]);
+            FromRGB565(Color1, Palette[1]);
+            for (u8 c = 0; c < 3; ++c)
+            {
+                Palette[2][c] = ((2 * Palette[0][c]) + Palette[1][c] + 1) / 3;
+                Palette[3][c] = (Palette[0][c] + (2 * Palette[1][c]) + 1) / 3;
+            }
+
+            for (u8 i = 0; i < 16; ++i)
+            {
+                Indices |= (u32)FindClosestPaletteEntry(InBlock.Texels[i], Palette, 4, 3) << (i * 2);
+            }
+        }
+
+        memcpy(OutBlock, &Color0, sizeof(Color0));
+        memcpy(OutBlock + 2, &Color1, sizeof(Color1));
+        memcpy(OutBlock + 4, &Indices, sizeof(Indices));
+    }
+
+    static void EncodeBC4Block(const FBlockTexels& InBlock, const u8& InChannel, u8* OutBlock)
+    {
+        u8 Min = 255, Max = 0;
+        for (u8 i = 0; i < 16; ++i)
+        {
+            Min = glm::min(Min, InBlock.Texels[i][InChannel]);
+            Max = glm::max(Max, InBlock.Texels[i][InChannel]);
+        }
+
+        // Max > Min selects the eight value mode, with equal endpoints the block is solid and all of the indices stay 0
+        OutBlock[0] = Max;
+        OutBlock[1] = Min;
+
+        u64 Indices = 0;
+        if (Max > Min)
+        {
+            i32 Palette[8] = { Max, Min };
+            for (u8 i = 1; i < 7; ++i)
+            {
+                Palette[i + 1] = (((7 - i) * Max) + (i * Min) + 3) / 7;
+            }
+
+            for (u8 i = 0; i < 16; ++i)
+            {
+                u64 BestEntry = 0;
+                i32 BestError = INT32_MAX;
+                for (u8 Entry = 0; Entry < 8; ++Entry)
+                {
+                    const i32 Error = abs(InBlock.Texels[i][InChannel] - Palette[Entry]);
+                    if (Error < BestError)
+                    {
+                        BestError = Error;
+                        BestEntry = Entry;
+                    }
+                }
+                Indices |= BestEntry << (i * 3);
+            }
+        }
+
+        memcpy(OutBlock + 2, &Indices, 6);
+    }
+
+    /** BC7 endpoints have 7 bits per channel and a p-bit shared by the channels, which is picked so the error is the smallest */
+    static void QuantizeBC7Endpoint(const float InColor[4], u8 OutEndpoint[4], u8& OutPBit)
+    {
+        float BestError = FLT_MAX;
+        for (u8 PBit = 0; PBit < 2; ++PBit)
+        {
+            u8    Endpoint[4];
+            float Error = 0;
+            for (u8 c = 0; c < 4; ++c)
+            {
+                Endpoint[c]       = (u8)glm::clamp((i32)(((InColor[c] - PBit) / 2.f) + 0.5f), 0, 127);
+                const float Delta = (float)((Endpoint[c] << 1) | PBit) - InColor[c];
+                Error += Delta * Delta;
+            }
+
+            if (Error < BestError)
+            {
+                BestError = Error;
+                OutPBit   = PBit;
+                memcpy(OutEndpoint, Endpoint, sizeof(Endpoint));
+            }
+        }
+    }
+
+    /** Only mode 6 is used - a single subset with RGBA endpoints and 4 bit indices, which works well for smooth color with alpha */
+    static void EncodeBC7Block(const FBlockTexels& InBlock, u8* OutBlock)
+    {
+        float Min[4], Max[4];
+        FitEndpoints(InBlock, 4, Min, Max);
+
+        u8 Endpoints[2][4];
+        u8 PBits[2];
+        QuantizeBC7Endpoint(Max, Endpoints[0], PBits[0]);
+        QuantizeBC7Endpoint(Min, Endpoints[1], PBits[1]);
+
+        i32 Palette[16][4];
+        for (u8 c = 0; c < 4; ++c)
+        {
+            const i32 Endpoint0 = (Endpoints[0][c] << 1) | PBits[0];
+            const i32 Endpoint1 = (Endpoints[1][c] << 1) | PBits[1];
+            for (u8 i = 0; i < 16; ++i)
+            {
+                Palette[i][c] = (((64 - BC7_WEIGHTS_4[i]) * Endpoint0) + (BC7_WEIGHTS_4[i] * Endpoint1) + 32) >> 6;
+            }
+        }
+
+        u8 Indices[16];
+        for (u8 i = 0; i < 16; ++i)
+        {
+            Indices[i] = FindClosestPaletteEntry(InBlock.Texels[i], Palette, 16, 4);
+        }
+
+        // The most significant bit of the first index is implicitly 0, so the endpoints are swapped when it's set
+        if (Indices[0] & 8)
+        {
+            for (u8 c = 0; c < 4; ++c)
+            {
+                const u8 Tmp    = Endpoints[0][c];
+                Endpoints[0][c] = Endpoints[1][c];
+                Endpoints[1][c] = Tmp;
+            }
+
+            const u8 TmpPBit = PBits[0];
+            PBits[0]         = PBits[1];
+            PBits[1]         = TmpPBit;
+
+            for (u8 i = 0; i < 16; ++i)
+            {
+                Indices[i] = 15 - Indices[i];
+            }
+        }
+
+        memset(OutBlock, 0, 16);
+        FBitWriter Writer{ OutBlock };
+
+        // Mode is stored as the number of zeros before the first set bit
+        Writer.Write(1 << 6, 7);
+        for (u8 c = 0; c < 4; ++c)
+        {
+            Writer.Write(Endpoints[0][c], 7);
+            Writer.Write(Endpoints[1][c], 7);
+        }
+        Writer.Write(PBits[0], 1);
+        Writer.Write(PBits[1], 1);
+
+        Writer.Write(Indices[0], 3);
+        for (u8 i = 1; i < 16; ++i)
+        {
+            Writer.Write(Indices[i], 4);
+        }
+    }
+
+    static void CompressMip(const u8*                      InPixels,
+                            const u32&                     InWidth,
+                            const u32&                     InHeight,
+                            const u8&                      InNumChannels,
+                            const gpu::ETextureDataFormat& InFormat,
+                            u8*                            OutData)
+    {
+        const u8  BlockSize  = gpu::GetBlockSizeInBytes(InFormat);
+        const u32 NumBlocksX = (InWidth + 3) / 4;
+        const u32 NumBlocksY = (InHeight + 3) / 4;
+
+        FBlockTexels Block;
+        for (u32 BlockY = 0; BlockY < NumBlocksY; ++BlockY)
+        {
+            for (u32 BlockX = 0; BlockX < NumBlocksX; ++BlockX)
+            {
+                FetchBlock(InPixels, InWidth, InHeight, InNumChannels, BlockX, BlockY, Block);
+
+                switch (InFormat)
+                {
+                case gpu::ETextureDataFormat::BC1:
+                case gpu::ETextureDataFormat::BC1_SRGB:
+                    EncodeBC1Block(Block, OutData);
+                    break;
+                case gpu::ETextureDataFormat::BC3:
+                case gpu::ETextureDataFormat::BC3_SRGB:
+                    EncodeBC4Block(Block, 3, OutData);
+                    EncodeBC1Block(Block, OutData + 8);
+                    break;
+                case gpu::ETextureDataFormat::BC4:
+                    EncodeBC4Block(Block, 0, OutData);
+                    break;
+                case gpu::ETextureDataFormat::BC5:
+                    EncodeBC4Block(Block, 0, OutData);
+                    EncodeBC4Block(Block, 1, OutData + 8);
+                    break;
+                case gpu::ETextureDataFormat::BC7:
+                case gpu::ETextureDataFormat::BC7_SRGB:
+                    EncodeBC7Block(Block, OutData);
+                    break;
+                default:
+                    assert(0);
+                }
+
+                OutData += BlockSize;
+            }
+        }
+    }
+
+    /** Filtering shortens the normals, so they're normalized again. Two channel normal maps get their Z reconstructed first */
+    static void RenormalizeNormals(u8* InOutPixels, const u32& InWidth, const u32& InHeight, const u8& InNumChannels)
+    {
+        for (u64 i = 0; i < (u64)InWidth * InHeight; ++i)
+        {
+            u8* Pixel = InOutPixels + (i * InNumChannels);
+
+            const float X = (Pixel[0] / 127.5f) - 1.f;
+            const float Y = (Pixel[1] / 127.5f) - 1.f;
+            const float Z = InNumChannels > 2 ? (Pixel[2] / 127.5f) - 1.f : sqrtf(glm::max(1.f - (X * X) - (Y * Y), 0.f));
+
+            const float Length = sqrtf((X * X) + (Y * Y) + (Z * Z));
+            if (Length < FLT_EPSILON)
+            {
+                continue;
+            }
+
+            const float Normal[3] = { X / Length, Y / Length, Z / Length };
+            for (u8 c = 0; c < glm::min(InNumChannels, (u8)3); ++c)
+            {
+                Pixel[c] = (u8)glm::clamp((((Normal[c] * 0.5f) + 0.5f) * 255.f) + 0.5f, 0.f, 255.f);
+            }
+        }
+    }
+
+    static bool IsSRGB(const gpu::ETextureDataFormat& InFormat)
+    {
+        return InFormat == gpu::ETextureDataFormat::BC1_SRGB || InFormat == gpu::ETextureDataFormat::BC3_SRGB ||
+               InFormat == gpu::ETextureDataFormat::BC7_SRGB;
+    }
+
+    gpu::ETextureDataFormat ChooseBlockCompressionFormat(const u8*   InPixels,
+                                                         const u32&  InWidth,
+                                                         const u32&  InHeight,
+                                                         const u8&   InNumChannels,
+                                                         const bool& InbSRGB,
+                                                         const bool& InbNormalMap)
+    {
+        if (InNumChannels == 1)
+        {
+            return gpu::ETextureDataFormat::BC4;
+        }
+
+        // Z of the normals is reconstructed in the shaders, so two channels with the better precision of BC5 are enough
+        if (InNumChannels == 2 || InbNormalMap)
+        {
+            return gpu::ETextureDataFormat::BC5;
+        }
+
+        if (InNumChannels == 4)
+        {
+            // Plenty of RGBA images are fully opaque, they don't need the bigger formats
+            for (u64 i = 0; i < (u64)InWidth * InHeight; ++i)
+            {
+                if (InPixels[(i * 4) + 3] != 255)
+                {
+                    return InbSRGB ? gpu::ETextureDataFormat::BC7_SRGB : gpu::ETextureDataFormat::BC3;
+                }
+            }
+        }
+
+        return InbSRGB ? gpu::ETextureDataFormat::BC1_SRGB : gpu::ETextureDataFormat::BC1;
+    }
+
+    u8 BuildCompressedMipChain(const u8*                      InPixels,
+                               const u32&                     InWidth,
+                               const u32&                     InHeight,
+                               const u8&                      InNumChannels,
+                               const gpu::ETextureDataFormat& InFormat,
+                               const bool&                    InbNormalMap,
+                               FMemBuffer&                    OutData)
+    {
+        const u8 NumMips = gpu::GetNumMips(InWidth, InHeight);
+
+        u64 TotalSize = 0;
+        for (u8 MipLevel = 0; MipLevel < NumMips; ++MipLevel)
+        {
+            TotalSize += gpu::GetCompressedMipSize(InFormat, glm::max(InWidth >> MipLevel, 1u), glm::max(InHeight >> MipLevel, 1u));
+        }
+
+        OutData      = CreateMemBuffer(TotalSize);
+        OutData.Size = TotalSize;
+
+        // Each mip is downsampled from the previous one, so only two of them are alive at once
+        const u8* MipPixels     = InPixels;
+        u8*       PrevMipPixels = nullptr;
+        u32       MipWidth      = InWidth;
+        u32       MipHeight     = InHeight;
+        u64       MipOffset     = 0;
+
+        for (u8 MipLevel = 0; MipLevel < NumMips; ++MipLevel)
+        {
+            CompressMip(MipPixels, MipWidth, MipHeight, InNumChannels, InFormat, (u8*)OutData.Pointer + MipOffset);
+            MipOffset += gpu::GetCompressedMipSize(InFormat, MipWidth, MipHeight);
+
+            if (MipLevel == NumMips - 1)
+            {
+                break;
+            }
+
+            const u32 NextMipWidth  = glm::max(MipWidth >> 1, 1u);
+            const u32 NextMipHeight = glm::max(MipHeight >> 1, 1u);
+            u8*       NextMipPixels = (u8*)malloc((u64)NextMipWidth * NextMipHeight * InNumChannels);
+
+            // sRGB is filtered in linear space, otherwise the mips get darker
+            if (IsSRGB(InFormat))
+            {
+                stbir_resize_uint8_srgb(MipPixels,
+                                        MipWidth,
+                                        MipHeight,
+                                        0,
+                                        NextMipPixels,
+                                        NextMipWidth,
+                                        NextMipHeight,
+                                        0,
+                                        InNumChannels,
+                                        InNumChannels == 4 ? 3 : STBIR_ALPHA_CHANNEL_NONE,
+                                        0);
+            }
+            else
+            {
+                stbir_resize_uint8(MipPixels, MipWidth, MipHeight, 0, NextMipPixels, NextMipWidth, NextMipHeight, 0, InNumChannels);
+            }
+
+            if (InbNormalMap && InNumChannels > 1)
+            {
+                RenormalizeNormals(NextMipPixels, NextMipWidth, NextMipHeight, InNumChannels);
+            }
+
+            free(PrevMipPixels);
+            PrevMipPixels = NextMipPixels;
+            MipPixels     = NextMipPixels;
+            MipWidth      = NextMipWidth;
+            MipHeight     = NextMipHeight;
+        }
+
+        free(PrevMipPixels);
+        assert(MipOffset == TotalSize);
+
+        return NumMips;
+    }
+} // namespace lucid::resources
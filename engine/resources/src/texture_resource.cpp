@@ -1,11 +1,16 @@
 #include "resources/texture_resource.hpp"
 #include "resources/serialization_versions.hpp"
+#include "resources/texture_compression.hpp"
+#include "resources/texture_streamer.hpp"
+
+#include "engine/engine.hpp"
 
 #include "common/log.hpp"
 
 #include "platform/util.hpp"
 #include "platform/fs.hpp"
 
+#include "devices/gpu/buffer.hpp"
 #include "devices/gpu/texture.hpp"
 #include "devices/gpu/texture_enums.hpp"
 
@@ -24,6 +29,7 @@ namespace lucid::resources
     CTextureResource* ImportTexture(const FString&               InPath,
                                     const FString&               InResourcePath,
                                     const bool&                  InPerformGammaCorrection,
+                                    const bool&                  InbNormalMap,
                                     const gpu::ETextureDataType& InDataType,
                                     const bool&                  InFlipY,
                                     const bool&                  InSendToGPU,
@@ -35,10 +41,17 @@ namespace lucid::resources
         u32 NumChannels;
         u32 Width, Height;
 
-        stbi_set_flip_vertically_on_load(InFlipY);
+        // Textures are imported on multiple threads at once by the batch import
+        stbi_set_flip_vertically_on_load_thread(InFlipY);
 
         stbi_uc* TextureData = stbi_load(*InPath, (int*)&Width, (int*)&Height, (int*)&NumChannels, 0);
-        u64      TextureSize = Width * Height * NumChannels * GetSizeInBytes(InDataType);
+        if (TextureData == nullptr)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Failed to import texture %s - %s", *InPath, stbi_failure_reason());
+            return nullptr;
+        }
+
+        u64 TextureSize = Width * Height * NumChannels * GetSizeInBytes(InDataType);
 
         auto* TextureResource = new CTextureResource(sole::uuid4(), InName, InResourcePath, 0, TextureSize, TEXTURE_SERIALIZATION_VERSION);
 
@@ -100,9 +113,30 @@ namespace lucid::resources
             assert(0);
         }
 
-        TextureResource->TextureData = TextureData;
-        TextureResource->Width       = Width;
-        TextureResource->Height      = Height;
+        TextureResource->Width  = Width;
+        TextureResource->Height = Height;
+
+        // 8 bit textures are stored block compressed together with their mips, the decoded pixels are kept around for the thumbnail
+        if (InDataType == gpu::ETextureDataType::UNSIGNED_BYTE)
+        {
+            FMemBuffer CompressedData;
+            TextureResource->DataFormat =
+              ChooseBlockCompressionFormat(TextureData, Width, Height, NumChannels, InPerformGammaCorrection, InbNormalMap);
+            TextureResource->NumMips =
+              BuildCompressedMipChain(TextureData, Width, Height, NumChannels, TextureResource->DataFormat, InbNormalMap, CompressedData);
+
+            TextureResource->TextureData  = CompressedData.Pointer;
+            TextureResource->DataSize     = CompressedData.Size;
+            TextureResource->SourcePixels = TextureData;
+        }
+        else
+        {
+            TextureResource->TextureData = TextureData;
+        }
+
+        // The imported data isn't saved yet, so it mustn't be replaced with the file contents
+        TextureResource->bLoadedToMainMemory = true;
+        TextureResource->IsMainMemoryFreed   = false;
 
         if (InSendToGPU)
         {
@@ -134,6 +168,14 @@ namespace lucid::resources
     {
     }
 
+    CTextureResource::~CTextureResource()
+    {
+        if (bMipsStreamed)
+        {
+            GEngine.GetTextureStreamer().Unregister(this);
+        }
+    }
+
     void CTextureResource::LoadMetadata(FILE* ResourceFile)
     {
         fread_s(&bSRGB, sizeof(bSRGB), sizeof(bSRGB), 1, ResourceFile);
@@ -142,12 +184,33 @@ namespace lucid::resources
         fread_s(&DataFormat, sizeof(DataFormat), sizeof(DataFormat), 1, ResourceFile);
         fread_s(&DataType, sizeof(DataType), sizeof(DataType), 1, ResourceFile);
         fread_s(&PixelFormat, sizeof(PixelFormat), sizeof(PixelFormat), 1, ResourceFile);
+
+        if (AssetSerializationVersion > 0)
+        {
+            fread_s(&NumMips, sizeof(NumMips), sizeof(NumMips), 1, ResourceFile);
+        }
+    }
+
+    u64 CTextureResource::GetDataOffset() const
+    {
+        const u64 MetadataSize = TEXTURE_RESOURCE_METADATA_SIZE + (AssetSerializationVersion > 0 ? sizeof(NumMips) : 0);
+        return RESOURCE_FILE_HEADER_SIZE + Name.GetLength() + MetadataSize;
     }
 
     void CTextureResource::LoadDataToMainMemorySynchronously()
     {
         if (bLoadedToMainMemory)
         {
+            if (bMainMemoryMapped)
+            {
+                // Replace the read-only mapped data with a copy that the caller owns
+                void* HeapTextureData = malloc(DataSize);
+                memcpy(HeapTextureData, TextureData, DataSize);
+                UnmapResourceFile();
+
+                TextureData       = HeapTextureData;
+                bMainMemoryMapped = false;
+            }
             return;
         }
 
@@ -158,7 +221,7 @@ namespace lucid::resources
             return;
         }
 
-        fseek(TextureFile, Offset + RESOURCE_FILE_HEADER_SIZE + Name.GetLength() + TEXTURE_RESOURCE_METADATA_SIZE, SEEK_SET);
+        _fseeki64(TextureFile, Offset + GetDataOffset(), SEEK_SET);
 
         TextureData = malloc(DataSize);
 
@@ -167,7 +230,28 @@ namespace lucid::resources
         fclose(TextureFile);
 
         bLoadedToMainMemory = true;
-        bLoadedToMainMemory = false;
+        IsMainMemoryFreed   = false;
+    }
+
+    void CTextureResource::MapDataToMainMemory()
+    {
+        if (bLoadedToMainMemory)
+        {
+            return;
+        }
+
+        const char* ResourceData = MapResourceFile();
+        if (ResourceData == nullptr)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Failed to map file %s", *FilePath);
+            return;
+        }
+
+        TextureData = (void*)(ResourceData + GetDataOffset());
+
+        bMainMemoryMapped   = true;
+        bLoadedToMainMemory = true;
+        IsMainMemoryFreed   = false;
     }
 
     void CTextureResource::LoadDataToVideoMemorySynchronously()
@@ -178,17 +262,148 @@ namespace lucid::resources
             return;
         }
 
-        // For now we require for the data to be loaded in the main memory
+        // The data is uploaded straight from the mapped file, no heap copy needed
         if (!bLoadedToMainMemory)
         {
-            LoadDataToMainMemorySynchronously();
+            MapDataToMainMemory();
+        }
+
+        if (gpu::IsBlockCompressed(DataFormat))
+        {
+            FirstResidentMip = GetInitialResidentMip();
+            TextureHandle    = CreateMipRangeTexture(FirstResidentMip, nullptr, nullptr, 0);
+        }
+        else
+        {
+            TextureHandle = gpu::Create2DTexture(TextureData, Width, Height, DataType, DataFormat, PixelFormat, 0, Name);
         }
+        assert(TextureHandle);
 
-        TextureHandle = gpu::Create2DTexture(TextureData, Width, Height, DataType, DataFormat, PixelFormat, 0, Name);
+        bLoadedToVideoMemory = true;
+        IsVideoMemoryFreed   = false;
+
+        if (FirstResidentMip > 0)
+        {
+            GEngine.GetTextureStreamer().Register(this);
+        }
+    }
+
+    void CTextureResource::LoadDataToVideoMemoryFromStagingBuffer(gpu::CGPUBuffer* InStagingBuffer, char* InStagingMappedPtr, const u32& InOffset)
+    {
+        if (bLoadedToVideoMemory)
+        {
+            return;
+        }
+
+        assert(bLoadedToMainMemory);
+        assert(InStagingBuffer->GetSize() >= InOffset + DataSize);
+
+        if (gpu::IsBlockCompressed(DataFormat))
+        {
+            FirstResidentMip = GetInitialResidentMip();
+            TextureHandle    = CreateMipRangeTexture(FirstResidentMip, InStagingBuffer, InStagingMappedPtr, InOffset);
+        }
+        else
+        {
+            // The staging buffer is mapped coherently, so the copy is visible to the GPU without a flush
+            memcpy(InStagingMappedPtr + InOffset, TextureData, DataSize);
+
+            // With a pixel unpack buffer bound the data pointer is treated as an offset into it
+            InStagingBuffer->Bind(gpu::EBufferBindPoint::PIXEL_UNPACK);
+            TextureHandle = gpu::Create2DTexture((void*)(uintptr_t)InOffset, Width, Height, DataType, DataFormat, PixelFormat, 0, Name);
+            InStagingBuffer->Unbind();
+
+            // Offset 0 looks like no data to Create2DTexture(), so it doesn't build the mip chain on it's own. Compressed mips are precomputed.
+            if (InOffset == 0)
+            {
+                TextureHandle->Bind();
+                TextureHandle->GenerateMipMaps();
+            }
+        }
         assert(TextureHandle);
 
         bLoadedToVideoMemory = true;
         IsVideoMemoryFreed   = false;
+
+        if (FirstResidentMip > 0)
+        {
+            GEngine.GetTextureStreamer().Register(this);
+        }
+    }
+
+    bool CTextureResource::IsStreamable() const { return gpu::IsBlockCompressed(DataFormat) && NumMips > 1; }
+
+    u64 CTextureResource::GetMipOffset(const u8& InMip) const
+    {
+        u64 MipOffset = 0;
+        for (u8 Mip = 0; Mip < InMip; ++Mip)
+        {
+            MipOffset += gpu::GetCompressedMipSize(DataFormat, glm::max(Width >> Mip, 1u), glm::max(Height >> Mip, 1u));
+        }
+        return MipOffset;
+    }
+
+    u8 CTextureResource::GetMipTailStart() const
+    {
+        u8 Mip = 0;
+        while ((Mip + 1) < NumMips && glm::max(Width >> Mip, Height >> Mip) > CTextureStreamer::MIP_TAIL_SIZE)
+        {
+            ++Mip;
+        }
+        return Mip;
+    }
+
+    u8 CTextureResource::GetInitialResidentMip() const { return IsStreamable() && GEngine.GetTextureStreamer().bEnabled ? GetMipTailStart() : 0; }
+
+    gpu::CTexture* CTextureResource::CreateMipRangeTexture(const u8&        InFirstMip,
+                                                           gpu::CGPUBuffer* InStagingBuffer,
+                                                           char*            InStagingMappedPtr,
+                                                           const u32&       InOffset) const
+    {
+        assert(gpu::IsBlockCompressed(DataFormat) && InFirstMip < NumMips);
+
+        const u64   MipOffset = GetMipOffset(InFirstMip);
+        const void* MipData   = (const char*)TextureData + MipOffset;
+
+        if (InStagingBuffer)
+        {
+            // The staging buffer is mapped coherently, so the copy is visible to the GPU without a flush
+            memcpy(InStagingMappedPtr + InOffset, MipData, DataSize - MipOffset);
+
+            // With a pixel unpack buffer bound the data pointer is treated as an offset into it
+            InStagingBuffer->Bind(gpu::EBufferBindPoint::PIXEL_UNPACK);
+            MipData = (const void*)(uintptr_t)InOffset;
+        }
+
+        gpu::CTexture* Texture = gpu::CreateCompressed2DTexture(MipData,
+                                                                glm::max(Width >> InFirstMip, 1u),
+                                                                glm::max(Height >> InFirstMip, 1u),
+                                                                NumMips - InFirstMip,
+                                                                DataFormat,
+                                                                PixelFormat,
+                                                                Name);
+        if (InStagingBuffer)
+        {
+            InStagingBuffer->Unbind();
+        }
+
+        return Texture;
+    }
+
+    gpu::CTexture* CTextureResource::SwapTextureHandle(gpu::CTexture* InTexture, const u8& InFirstMip)
+    {
+        gpu::CTexture* OldTexture = TextureHandle;
+
+        // Materials pick up the new handle when the streamer tells them, the old one stays valid until the old texture is freed
+        if (OldTexture->IsBindlessTextureResident())
+        {
+            InTexture->GetBindlessHandle();
+            InTexture->MakeBindlessResident();
+        }
+
+        TextureHandle    = InTexture;
+        FirstResidentMip = InFirstMip;
+        return OldTexture;
     }
 
     void CTextureResource::SaveSynchronously(FILE* ResourceFile) const
@@ -216,7 +431,12 @@ namespace lucid::resources
         fwrite(&DataType, sizeof(DataType), 1, ResourceFile);
         fwrite(&PixelFormat, sizeof(PixelFormat), 1, ResourceFile);
 
-        // Write texture data
+        if (AssetSerializationVersion > 0)
+        {
+            fwrite(&NumMips, sizeof(NumMips), 1, ResourceFile);
+        }
+
+        // Write texture data, block compressed textures store their mips one after another
         fwrite(TextureData, DataSize, 1, ResourceFile);
 
         if (bShouldCloseFile)
@@ -227,9 +447,25 @@ namespace lucid::resources
 
     void CTextureResource::FreeMainMemory()
     {
+        if (SourcePixels)
+        {
+            stbi_image_free(SourcePixels);
+            SourcePixels = nullptr;
+        }
+
         if (bLoadedToMainMemory && !IsMainMemoryFreed)
         {
-            free(TextureData);
+            if (bMainMemoryMapped)
+            {
+                UnmapResourceFile();
+                bMainMemoryMapped = false;
+            }
+            else
+            {
+                free(TextureData);
+            }
+
+            TextureData         = nullptr;
             IsMainMemoryFreed   = true;
             bLoadedToMainMemory = false;
         }
@@ -238,6 +474,9 @@ namespace lucid::resources
     {
         if (bLoadedToVideoMemory && !IsVideoMemoryFreed)
         {
+            GEngine.GetTextureStreamer().Unregister(this);
+            FirstResidentMip = 0;
+
             if (TextureHandle->GetBindlessHandle())
             {
                 TextureHandle->MakeBindlessNonResident();
@@ -266,6 +505,8 @@ namespace lucid::resources
 
     void CTextureResource::MigrateToLatestVersion()
     {
+        // The usage of older textures isn't known, so they keep their uncompressed base level. They have to be reimported to get compressed.
+        NumMips = 1;
         Save(TEXTURE_SERIALIZATION_VERSION);
     }
 
@@ -282,7 +523,7 @@ namespace lucid::resources
         FMemBuffer ThumbData = platform::ReadFileToBuffer(*ThumbPath);
         if (ThumbData.Size)
         {
-            ThumbnailTexture = gpu::Create2DTexture(ThumbData.Pointer, 32, 32, DataType, DataFormat, PixelFormat, 0, SPrintf("%s_Thumb", *Name));
+            CreateThumbnail(ThumbData.Pointer);
             free(ThumbData.Pointer);
         }
 
@@ -291,32 +532,85 @@ namespace lucid::resources
         LUCID_LOG(ELogLevel::INFO, "Loaded thumbnail for %s done in %f seconds", *Name, platform::GetCurrentTimeSeconds() - StartTime);
     }
 
+    void CTextureResource::CreateThumbnail(const char* InThumbnailData)
+    {
+        if (ThumbnailTexture)
+        {
+            return;
+        }
+
+        ThumbnailTexture = gpu::Create2DTexture(
+          (void*)InThumbnailData, THUMBNAIL_SIZE, THUMBNAIL_SIZE, DataType, GetThumbnailDataFormat(), PixelFormat, 0, SPrintf("%s_Thumb", *Name));
+    }
+
+    gpu::ETextureDataFormat CTextureResource::GetThumbnailDataFormat() const
+    {
+        if (!gpu::IsBlockCompressed(DataFormat))
+        {
+            return DataFormat;
+        }
+
+        switch (PixelFormat)
+        {
+        case gpu::ETexturePixelFormat::RED:
+            return gpu::ETextureDataFormat::R;
+        case gpu::ETexturePixelFormat::RG:
+            return gpu::ETextureDataFormat::RG;
+        case gpu::ETexturePixelFormat::RGB:
+            return bSRGB ? gpu::ETextureDataFormat::SRGB : gpu::ETextureDataFormat::RGB;
+        default:
+            return bSRGB ? gpu::ETextureDataFormat::SRGBA : gpu::ETextureDataFormat::RGBA;
+        }
+    }
+
     void CTextureResource::MakeThumbnail()
     {
         LUCID_LOG(ELogLevel::INFO, "Making thumbnail for texture %s", *Name);
         const float StartTime = platform::GetCurrentTimeSeconds();
 
-        bool  bShouldFreeMainMemory = false;
-        void* ThumbData             = malloc(32 * 32 * gpu::GetNumChannels(PixelFormat));
+        const bool bShouldFreeMainMemory = !bLoadedToMainMemory;
 
-        if (!bLoadedToMainMemory)
+        FMemBuffer ThumbData;
+        if (gpu::IsBlockCompressed(DataFormat) && !SourcePixels)
         {
-            bShouldFreeMainMemory = true;
-            LoadDataToMainMemorySynchronously();
-        }
+            // The driver decompresses the texture when it's read back, the smallest resident mip that still covers the thumbnail is enough
+            const bool bShouldFreeVideoMemory = !bLoadedToVideoMemory;
+            LoadDataToVideoMemorySynchronously();
 
-        stbir_resize_uint8((unsigned char*)TextureData, Width, Height, 0, (unsigned char*)ThumbData, 32, 32, 0, gpu::GetNumChannels(PixelFormat));
-        ThumbnailTexture = gpu::Create2DTexture(ThumbData, 32, 32, DataType, DataFormat, PixelFormat, 0, SPrintf("%s_Thumb", *Name));
+            u8 MipLevel = FirstResidentMip;
+            while ((MipLevel + 1) < NumMips && (Width >> (MipLevel + 1)) >= THUMBNAIL_SIZE && (Height >> (MipLevel + 1)) >= THUMBNAIL_SIZE)
+            {
+                ++MipLevel;
+            }
 
-        FDString ThumbPath = SPrintf("%s.th", *FilePath);
-        FILE*    ThumbFile = fopen(*ThumbPath, "wb");
+            const u32 MipWidth  = glm::max(Width >> MipLevel, 1u);
+            const u32 MipHeight = glm::max(Height >> MipLevel, 1u);
 
-        fwrite(ThumbData, 1, ThumbnailTexture->GetSizeInBytes(), ThumbFile);
+            // Rows are read back aligned to 4 bytes
+            const u32 MipStride = ((MipWidth * gpu::GetNumChannels(PixelFormat)) + 3) & ~3u;
+            u8*       MipPixels = (u8*)malloc(MipStride * MipHeight);
 
-        free(ThumbData);
-        free(TextureData);
-        fclose(ThumbFile);
-        ThumbPath.Free();
+            TextureHandle->Bind();
+            TextureHandle->CopyPixels(MipPixels, MipLevel - FirstResidentMip);
+            ThumbData = WriteThumbnail(MipPixels, MipWidth, MipHeight, MipStride);
+            free(MipPixels);
+
+            if (bShouldFreeVideoMemory)
+            {
+                FreeVideoMemory();
+            }
+        }
+        else
+        {
+            if (bShouldFreeMainMemory)
+            {
+                LoadDataToMainMemorySynchronously();
+            }
+            ThumbData = SaveThumbnail();
+        }
+
+        CreateThumbnail(ThumbData.Pointer);
+        ThumbData.Free();
 
         if (bShouldFreeMainMemory)
         {
@@ -326,4 +620,33 @@ namespace lucid::resources
         LUCID_LOG(ELogLevel::INFO, "Thumbnail for %s done in %f seconds", *Name, platform::GetCurrentTimeSeconds() - StartTime);
     }
 
+    FMemBuffer CTextureResource::SaveThumbnail() const
+    {
+        // Block compressed data can't be resized, so the pixels decoded at import are used instead
+        const u8* Pixels = gpu::IsBlockCompressed(DataFormat) ? SourcePixels : (const u8*)TextureData;
+        assert(Pixels);
+
+        return WriteThumbnail(Pixels, Width, Height, 0);
+    }
+
+    FMemBuffer CTextureResource::WriteThumbnail(const u8* InPixels, const u32& InWidth, const u32& InHeight, const u32& InStride) const
+    {
+        const u32  NumChannels = gpu::GetNumChannels(PixelFormat);
+        FMemBuffer ThumbData   = CreateMemBuffer(THUMBNAIL_SIZE * THUMBNAIL_SIZE * NumChannels);
+
+        stbir_resize_uint8(InPixels, InWidth, InHeight, InStride, (unsigned char*)ThumbData.Pointer, THUMBNAIL_SIZE, THUMBNAIL_SIZE, 0, NumChannels);
+        ThumbData.Size = ThumbData.Capacity;
+
+        FDString ThumbPath = SPrintf("%s.th", *FilePath);
+        FILE*    ThumbFile;
+        if (fopen_s(&ThumbFile, *ThumbPath, "wb") == 0)
+        {
+            fwrite(ThumbData.Pointer, 1, ThumbData.Size, ThumbFile);
+            fclose(ThumbFile);
+        }
+        ThumbPath.Free();
+
+        return ThumbData;
+    }
+
 } // namespace lucid::resources
\ No newline at end of file
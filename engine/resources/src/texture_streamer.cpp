@@ -0,0 +1,549 @@
+#include "resources/texture_streamer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "engine/engine.hpp"
+
+#include "common/log.hpp"
+#include "common/jobs.hpp"
+
+#include "devices/gpu/gpu.hpp"
+#include "devices/gpu/buffer.hpp"
+#include "devices/gpu/fence.hpp"
+#include "devices/gpu/texture.hpp"
+
+#include "resources/texture_resource.hpp"
+
+#include "scene/material.hpp"
+
+namespace lucid::resources
+{
+    /** Same as in the resource streamer, compressed mips are multiples of 8 bytes so they stay aligned within the region */
+    static constexpr u32 STAGING_ALIGNMENT = 16;
+
+    /** The shaders write log2 of the UV footprint as fixed point, biased so it's never negative, see texture_feedback.glsl */
+    static constexpr u32   FEEDBACK_NOT_WRITTEN = 0xFFFFFFFF;
+    static constexpr float FEEDBACK_SCALE       = 16.f;
+    static constexpr float FEEDBACK_BIAS        = 32.f;
+
+    static constexpr gpu::EImmutableBufferUsage STAGING_BUFFER_USAGE =
+      (gpu::EImmutableBufferUsage)(gpu::EImmutableBufferUsage::IMM_BUFFER_WRITE | gpu::EImmutableBufferUsage::IMM_BUFFER_COHERENT);
+
+    static constexpr gpu::EBufferMapPolicy STAGING_BUFFER_MAP_POLICY =
+      (gpu::EBufferMapPolicy)(gpu::EBufferMapPolicy::BUFFER_WRITE | gpu::EBufferMapPolicy::BUFFER_COHERENT | gpu::EBufferMapPolicy::BUFFER_PERSISTENT);
+
+    static constexpr gpu::EImmutableBufferUsage FEEDBACK_BUFFER_USAGE = (gpu::EImmutableBufferUsage)(
+      gpu::EImmutableBufferUsage::IMM_BUFFER_READ | gpu::EImmutableBufferUsage::IMM_BUFFER_WRITE | gpu::EImmutableBufferUsage::IMM_BUFFER_COHERENT);
+
+    static constexpr gpu::EBufferMapPolicy FEEDBACK_BUFFER_MAP_POLICY =
+      (gpu::EBufferMapPolicy)(gpu::EBufferMapPolicy::BUFFER_READ | gpu::EBufferMapPolicy::BUFFER_WRITE | gpu::EBufferMapPolicy::BUFFER_COHERENT |
+                              gpu::EBufferMapPolicy::BUFFER_PERSISTENT);
+
+    static void FreeFence(gpu::CFence*& InFence)
+    {
+        InFence->Free();
+        delete InFence;
+        InFence = nullptr;
+    }
+
+    void CTextureStreamer::Setup()
+    {
+        gpu::FBufferDescription BufferDescription;
+        BufferDescription.Size = STAGING_REGION_SIZE * STAGING_REGIONS_COUNT;
+
+        StagingBuffer = gpu::CreateImmutableBuffer(BufferDescription, STAGING_BUFFER_USAGE, "TextureStreamerStagingBuffer");
+        StagingBuffer->Bind(gpu::EBufferBindPoint::WRITE);
+        StagingBufferMappedPtr = (char*)StagingBuffer->MemoryMap(STAGING_BUFFER_MAP_POLICY);
+        StagingBuffer->Unbind();
+
+        BufferDescription.Size = MAX_FEEDBACK_SLOTS * sizeof(u32);
+        for (FFeedbackBuffer& FeedbackBuffer : FeedbackBuffers)
+        {
+            FeedbackBuffer.Buffer = gpu::CreateImmutableBuffer(BufferDescription, FEEDBACK_BUFFER_USAGE, "TextureFeedbackBuffer");
+            FeedbackBuffer.Buffer->Bind(gpu::EBufferBindPoint::WRITE);
+            FeedbackBuffer.MappedPtr = (u32*)FeedbackBuffer.Buffer->MemoryMap(FEEDBACK_BUFFER_MAP_POLICY);
+            FeedbackBuffer.Buffer->Unbind();
+
+            memset(FeedbackBuffer.MappedPtr, 0xFF, BufferDescription.Size);
+        }
+    }
+
+    void CTextureStreamer::Cleanup()
+    {
+        // Workers might still be mapping textures
+        GEngine.GetJobSystem().WaitForAll();
+
+        for (const FMipsLoad& Load : LoadedMips)
+        {
+            ReleaseMappedData(Load);
+        }
+
+        for (const FMipsLoad& Load : PendingUploads)
+        {
+            ReleaseMappedData(Load);
+        }
+
+        LoadedMips.clear();
+        PendingUploads.clear();
+        NumLoadsInFlight = 0;
+
+        for (CTextureResource* Texture : StreamedTextures)
+        {
+            Texture->bMipsStreamed = false;
+            Texture->TargetMip     = Texture->FirstResidentMip;
+        }
+        StreamedTextures.clear();
+
+        for (FRetiredTexture& RetiredTexture : RetiredTextures)
+        {
+            while (!RetiredTexture.Fence->Wait(1))
+            {
+            }
+            FreeFence(RetiredTexture.Fence);
+
+            if (RetiredTexture.Texture->IsBindlessTextureResident())
+            {
+                RetiredTexture.Texture->MakeBindlessNonResident();
+            }
+            RetiredTexture.Texture->Free();
+            delete RetiredTexture.Texture;
+        }
+        RetiredTextures.clear();
+
+        for (FFeedbackBuffer& FeedbackBuffer : FeedbackBuffers)
+        {
+            if (FeedbackBuffer.Fence)
+            {
+                FreeFence(FeedbackBuffer.Fence);
+            }
+
+            if (FeedbackBuffer.Buffer)
+            {
+                FeedbackBuffer.Buffer->Bind(gpu::EBufferBindPoint::WRITE);
+                FeedbackBuffer.Buffer->MemoryUnmap();
+                FeedbackBuffer.Buffer->Free();
+                delete FeedbackBuffer.Buffer;
+
+                FeedbackBuffer.Buffer    = nullptr;
+                FeedbackBuffer.MappedPtr = nullptr;
+            }
+        }
+
+        for (u32 i = 0; i < STAGING_REGIONS_COUNT; ++i)
+        {
+            if (StagingFences[i])
+            {
+                FreeFence(StagingFences[i]);
+            }
+        }
+
+        if (StagingBuffer)
+        {
+            StagingBuffer->Bind(gpu::EBufferBindPoint::WRITE);
+            StagingBuffer->MemoryUnmap();
+            StagingBuffer->Free();
+            delete StagingBuffer;
+
+            StagingBuffer          = nullptr;
+            StagingBufferMappedPtr = nullptr;
+        }
+    }
+
+    void CTextureStreamer::Register(CTextureResource* InTexture)
+    {
+        assert(!InTexture->bMipsStreamed);
+
+        const u8 MipTailStart          = InTexture->GetMipTailStart();
+        InTexture->bMipsStreamed       = true;
+        InTexture->TargetMip           = InTexture->FirstResidentMip;
+        InTexture->RequestedMip        = MipTailStart;
+        InTexture->PrevRequestedMip    = MipTailStart;
+        InTexture->LastMipRequestFrame = 0;
+
+        StreamedTextures.push_back(InTexture);
+    }
+
+    void CTextureStreamer::Unregister(CTextureResource* InTexture)
+    {
+        if (!InTexture->bMipsStreamed)
+        {
+            return;
+        }
+
+        // Mips of the texture are being loaded, forget about them
+        if (InTexture->TargetMip != InTexture->FirstResidentMip)
+        {
+            InTexture->WaitUntilLoaded();
+
+            const auto IsTextureLoad = [InTexture](const FMipsLoad& Load) { return Load.Texture == InTexture; };
+            {
+                std::lock_guard<std::mutex> Lock(LoadedMipsMutex);
+                const auto                  LoadIt = std::find_if(LoadedMips.begin(), LoadedMips.end(), IsTextureLoad);
+                if (LoadIt != LoadedMips.end())
+                {
+                    ReleaseMappedData(*LoadIt);
+                    LoadedMips.erase(LoadIt);
+                }
+            }
+
+            const auto UploadIt = std::find_if(PendingUploads.begin(), PendingUploads.end(), IsTextureLoad);
+            if (UploadIt != PendingUploads.end())
+            {
+                ReleaseMappedData(*UploadIt);
+                PendingUploads.erase(UploadIt);
+            }
+
+            --NumLoadsInFlight;
+        }
+
+        InTexture->bMipsStreamed = false;
+        InTexture->TargetMip     = InTexture->FirstResidentMip;
+        StreamedTextures.erase(std::remove(StreamedTextures.begin(), StreamedTextures.end(), InTexture), StreamedTextures.end());
+    }
+
+    u32 CTextureStreamer::AllocFeedbackSlot(scene::CMaterial* InMaterial)
+    {
+        if (FreeFeedbackSlots.size())
+        {
+            const u32 Slot = FreeFeedbackSlots.back();
+            FreeFeedbackSlots.pop_back();
+            FeedbackMaterials[Slot] = InMaterial;
+            return Slot;
+        }
+
+        if (FeedbackMaterials.size() == MAX_FEEDBACK_SLOTS)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Out of texture feedback slots, textures of material %s won't be streamed in", *InMaterial->GetName());
+            return INVALID_FEEDBACK_SLOT;
+        }
+
+        FeedbackMaterials.push_back(InMaterial);
+        return FeedbackMaterials.size() - 1;
+    }
+
+    void CTextureStreamer::FreeFeedbackSlot(const u32& InSlot)
+    {
+        // The slot might still be written by the frames in flight, the feedback is just ignored or goes to the next owner of the slot
+        FeedbackMaterials[InSlot] = nullptr;
+        FreeFeedbackSlots.push_back(InSlot);
+    }
+
+    void CTextureStreamer::RequestMips(CTextureResource* InTexture, const float& InLog2UVFootprint)
+    {
+        if (!InTexture || !InTexture->bMipsStreamed)
+        {
+            return;
+        }
+
+        // The footprint in texels is the footprint in UV space scaled by the texture size, so the mip is just log2 of it
+        const float Log2TextureSize = log2f((float)glm::max(InTexture->Width, InTexture->Height));
+        const i32   Mip             = glm::clamp((i32)floorf(InLog2UVFootprint + Log2TextureSize), 0, (i32)InTexture->GetMipTailStart());
+
+        InTexture->RequestedMip        = glm::min(InTexture->RequestedMip, (u8)Mip);
+        InTexture->LastMipRequestFrame = FrameNumber;
+    }
+
+    void CTextureStreamer::BeginFeedback(const u32& InBindingIndex)
+    {
+        CurrentFeedbackBuffer           = (CurrentFeedbackBuffer + 1) % FEEDBACK_BUFFERS_COUNT;
+        FFeedbackBuffer& FeedbackBuffer = FeedbackBuffers[CurrentFeedbackBuffer];
+
+        // Usually resolved frames ago in OnFrameBegin(), this only waits when the GPU is FEEDBACK_BUFFERS_COUNT frames behind
+        if (FeedbackBuffer.Fence)
+        {
+            while (!FeedbackBuffer.Fence->Wait(1))
+            {
+            }
+            ResolveFeedback(FeedbackBuffer);
+        }
+
+        FeedbackBuffer.Buffer->BindIndexed(InBindingIndex, gpu::EBufferBindPoint::SHADER_STORAGE);
+    }
+
+    void CTextureStreamer::EndFeedback()
+    {
+        gpu::InsertMemoryBarrier(gpu::EMemoryBarrier::CLIENT_MAPPED_BUFFER_BARRIER);
+        FeedbackBuffers[CurrentFeedbackBuffer].Fence = gpu::CreateFence("TextureFeedbackFence");
+    }
+
+    void CTextureStreamer::ResolveFeedback(FFeedbackBuffer& InFeedbackBuffer)
+    {
+        FreeFence(InFeedbackBuffer.Fence);
+
+        for (u32 Slot = 0; Slot < FeedbackMaterials.size(); ++Slot)
+        {
+            const u32 Feedback = InFeedbackBuffer.MappedPtr[Slot];
+            if (Feedback == FEEDBACK_NOT_WRITTEN)
+            {
+                continue;
+            }
+
+            // Cleared for the next frame that uses this buffer
+            InFeedbackBuffer.MappedPtr[Slot] = FEEDBACK_NOT_WRITTEN;
+
+            if (FeedbackMaterials[Slot])
+            {
+                FeedbackMaterials[Slot]->RequestTextureMips(((float)Feedback / FEEDBACK_SCALE) - FEEDBACK_BIAS);
+            }
+        }
+    }
+
+    void CTextureStreamer::OnFrameBegin()
+    {
+        ++FrameNumber;
+
+        for (FFeedbackBuffer& FeedbackBuffer : FeedbackBuffers)
+        {
+            if (FeedbackBuffer.Fence && FeedbackBuffer.Fence->Wait(0))
+            {
+                ResolveFeedback(FeedbackBuffer);
+            }
+        }
+
+        // Textures replaced by the streamed ones are freed once the frames that sampled them are done
+        const auto RemovedIt = std::remove_if(RetiredTextures.begin(), RetiredTextures.end(), [](FRetiredTexture& RetiredTexture) {
+            if (!RetiredTexture.Fence->Wait(0))
+            {
+                return false;
+            }
+
+            FreeFence(RetiredTexture.Fence);
+            if (RetiredTexture.Texture->IsBindlessTextureResident())
+            {
+                RetiredTexture.Texture->MakeBindlessNonResident();
+            }
+            RetiredTexture.Texture->Free();
+            delete RetiredTexture.Texture;
+            return true;
+        });
+        RetiredTextures.erase(RemovedIt, RetiredTextures.end());
+
+        UploadLoadedMips();
+        ScheduleMipChanges();
+    }
+
+    void CTextureStreamer::UploadLoadedMips()
+    {
+        {
+            std::lock_guard<std::mutex> Lock(LoadedMipsMutex);
+            PendingUploads.insert(PendingUploads.end(), LoadedMips.begin(), LoadedMips.end());
+            LoadedMips.clear();
+        }
+
+        if (PendingUploads.empty())
+        {
+            return;
+        }
+
+        // Same scheme as in the resource streamer, the next region is used unless the GPU still sources textures from it
+        CurrentStagingRegion = (CurrentStagingRegion + 1) % STAGING_REGIONS_COUNT;
+
+        gpu::CFence*& StagingFence = StagingFences[CurrentStagingRegion];
+        if (StagingFence && StagingFence->Wait(0))
+        {
+            FreeFence(StagingFence);
+        }
+
+        const bool bStagingRegionAvailable = StagingFence == nullptr;
+        const u32  StagingRegionStart      = CurrentStagingRegion * STAGING_REGION_SIZE;
+        u32        StagingRegionUsed       = 0;
+        u64        UploadedBytes           = 0;
+        u32        NumUploaded             = 0;
+
+        for (; NumUploaded < PendingUploads.size(); ++NumUploaded)
+        {
+            const FMipsLoad&  Load       = PendingUploads[NumUploaded];
+            CTextureResource* Texture    = Load.Texture;
+            const u64         UploadSize = Texture->GetDataSize() - Texture->GetMipOffset(Load.FirstMip);
+
+            // Always upload at least one texture, so the ones bigger than the budget get uploaded too
+            if (UploadedBytes > 0 && (UploadedBytes + UploadSize) > MaxUploadBytesPerFrame)
+            {
+                break;
+            }
+
+            gpu::CTexture* NewTexture = nullptr;
+            if (!Texture->bLoadedToMainMemory)
+            {
+                LUCID_LOG(ELogLevel::WARN, "Failed to stream mips of texture %s", *Texture->GetName());
+            }
+            else if (bStagingRegionAvailable && (StagingRegionUsed + UploadSize) <= STAGING_REGION_SIZE)
+            {
+                NewTexture = Texture->CreateMipRangeTexture(Load.FirstMip, StagingBuffer, StagingBufferMappedPtr, StagingRegionStart + StagingRegionUsed);
+                StagingRegionUsed += (UploadSize + STAGING_ALIGNMENT - 1) & ~(u64)(STAGING_ALIGNMENT - 1);
+            }
+            else
+            {
+                // Doesn't fit in the staging region, the driver copies the data straight from the mapped file
+                NewTexture = Texture->CreateMipRangeTexture(Load.FirstMip, nullptr, nullptr, 0);
+            }
+
+            if (NewTexture)
+            {
+                // The old texture was last sampled by the frames already submitted, the fence covers them
+                FRetiredTexture RetiredTexture;
+                RetiredTexture.Texture = Texture->SwapTextureHandle(NewTexture, Load.FirstMip);
+                RetiredTexture.Fence   = gpu::CreateFence("RetiredStreamedTextureFence");
+                RetiredTextures.push_back(RetiredTexture);
+
+                ++HandlesGeneration;
+            }
+
+            Texture->TargetMip = Texture->FirstResidentMip;
+            ReleaseMappedData(Load);
+
+            --NumLoadsInFlight;
+            UploadedBytes += UploadSize;
+        }
+
+        PendingUploads.erase(PendingUploads.begin(), PendingUploads.begin() + NumUploaded);
+
+        if (StagingRegionUsed > 0)
+        {
+            StagingFence = gpu::CreateFence("TextureStreamerStagingFence");
+        }
+    }
+
+    void CTextureStreamer::ScheduleMipChanges()
+    {
+        const bool bNewRequestWindow = (FrameNumber % REQUEST_WINDOW_FRAMES) == 0;
+
+        // Bytes the textures will take once the loads in flight are done
+        u64 ProjectedBytes = 0;
+        ResidentBytes      = 0;
+        MipRequests.clear();
+
+        for (CTextureResource* Texture : StreamedTextures)
+        {
+            if (bNewRequestWindow)
+            {
+                Texture->PrevRequestedMip = Texture->RequestedMip;
+                Texture->RequestedMip     = Texture->GetMipTailStart();
+            }
+
+            ResidentBytes += GetStreamedSize(Texture, Texture->FirstResidentMip);
+            ProjectedBytes += GetStreamedSize(Texture, Texture->TargetMip);
+
+            // The resource streamer might be loading the texture to main memory
+            const bool bIdle = Texture->TargetMip == Texture->FirstResidentMip && !Texture->bStreaming && !Texture->bLoading;
+            if (!bIdle || NumLoadsInFlight >= MAX_LOADS_IN_FLIGHT)
+            {
+                continue;
+            }
+
+            const u8 WantedMip = glm::min(Texture->RequestedMip, Texture->PrevRequestedMip);
+            if (WantedMip > Texture->FirstResidentMip)
+            {
+                ProjectedBytes -= GetStreamedSize(Texture, Texture->FirstResidentMip) - GetStreamedSize(Texture, WantedMip);
+                LoadMips(Texture, WantedMip);
+            }
+            else if (WantedMip < Texture->FirstResidentMip)
+            {
+                MipRequests.push_back(Texture);
+            }
+        }
+
+        // The most recently requested textures go first, each of them gets the finest of the requested mips that fits in the budget
+        std::sort(MipRequests.begin(), MipRequests.end(), [](const CTextureResource* A, const CTextureResource* B) {
+            return A->LastMipRequestFrame > B->LastMipRequestFrame;
+        });
+
+        for (CTextureResource* Texture : MipRequests)
+        {
+            if (NumLoadsInFlight >= MAX_LOADS_IN_FLIGHT)
+            {
+                break;
+            }
+
+            const u8  WantedMip   = glm::min(Texture->RequestedMip, Texture->PrevRequestedMip);
+            const u64 CurrentSize = GetStreamedSize(Texture, Texture->FirstResidentMip);
+
+            u8 FirstMip = Texture->FirstResidentMip;
+            while (FirstMip > WantedMip && (ProjectedBytes - CurrentSize + GetStreamedSize(Texture, FirstMip - 1)) <= VRAMBudget)
+            {
+                --FirstMip;
+            }
+
+            if (FirstMip < Texture->FirstResidentMip)
+            {
+                ProjectedBytes += GetStreamedSize(Texture, FirstMip) - CurrentSize;
+                LoadMips(Texture, FirstMip);
+            }
+        }
+
+        if (ProjectedBytes <= VRAMBudget)
+        {
+            return;
+        }
+
+        // Still over the budget, e.g. because it was lowered, drop the biggest mip of the least recently requested textures
+        MipRequests.clear();
+        for (CTextureResource* Texture : StreamedTextures)
+        {
+            const bool bIdle = Texture->TargetMip == Texture->FirstResidentMip && !Texture->bStreaming && !Texture->bLoading;
+            if (bIdle && Texture->FirstResidentMip < Texture->GetMipTailStart())
+            {
+                MipRequests.push_back(Texture);
+            }
+        }
+
+        std::sort(MipRequests.begin(), MipRequests.end(), [](const CTextureResource* A, const CTextureResource* B) {
+            return A->LastMipRequestFrame < B->LastMipRequestFrame;
+        });
+
+        for (CTextureResource* Texture : MipRequests)
+        {
+            if (ProjectedBytes <= VRAMBudget || NumLoadsInFlight >= MAX_LOADS_IN_FLIGHT)
+            {
+                break;
+            }
+
+            const u8 FirstMip = Texture->FirstResidentMip + 1;
+            ProjectedBytes -= GetStreamedSize(Texture, Texture->FirstResidentMip) - GetStreamedSize(Texture, FirstMip);
+            LoadMips(Texture, FirstMip);
+        }
+    }
+
+    void CTextureStreamer::LoadMips(CTextureResource* InTexture, const u8& InFirstMip)
+    {
+        ++NumLoadsInFlight;
+
+        FMipsLoad Load;
+        Load.Texture           = InTexture;
+        Load.FirstMip          = InFirstMip;
+        Load.bMappedByStreamer = !InTexture->bLoadedToMainMemory;
+
+        InTexture->TargetMip = InFirstMip;
+        InTexture->bLoading  = true;
+
+        GEngine.GetJobSystem().Submit([this, Load] {
+            if (Load.bMappedByStreamer)
+            {
+                // Fault the pages in here, so the main thread doesn't wait for the disk during the upload
+                Load.Texture->MapDataToMainMemory();
+                Load.Texture->PrefaultMappedResource();
+            }
+
+            std::lock_guard<std::mutex> Lock(LoadedMipsMutex);
+            LoadedMips.push_back(Load);
+
+            // Cleared under the lock, so Unregister() finds the load in LoadedMips after waiting for it
+            Load.Texture->bLoading = false;
+        });
+    }
+
+    void CTextureStreamer::ReleaseMappedData(const FMipsLoad& InLoad)
+    {
+        if (InLoad.bMappedByStreamer && InLoad.Texture->bMainMemoryMapped)
+        {
+            InLoad.Texture->FreeMainMemory();
+        }
+    }
+
+    u64 CTextureStreamer::GetStreamedSize(const CTextureResource* InTexture, const u8& InFirstMip) const
+    {
+        const u8 MipTailStart = InTexture->GetMipTailStart();
+        return InFirstMip < MipTailStart ? InTexture->GetMipOffset(MipTailStart) - InTexture->GetMipOffset(InFirstMip) : 0;
+    }
+} // namespace lucid::resources
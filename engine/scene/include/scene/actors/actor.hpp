@@ -6,6 +6,7 @@
 #include "glm/glm.hpp"
 
 #include "scene/transform.hpp"
+#include "scene/transform_hierarchy.hpp"
 #include "scene/actors/actor_enums.hpp"
 
 #include "schemas/types.hpp"
@@ -40,19 +41,22 @@ namespace lucid::scene
             World     = InRHS.World;
         }
 
-        glm::mat4 CalculateModelMatrix()
+        glm::mat4 CalculateLocalMatrix() const
         {
             glm::mat4  Identity{ 1 };
             const auto Translation = glm::translate(Identity, Transform.Translation);
             const auto Rotation    = glm::mat4_cast(Transform.Rotation);
             const auto Scale       = glm::scale(Identity, Transform.Scale);
 
-            const glm::mat4 ModelMatrix = Translation * Rotation * Scale;
-
-            CachedModelMatrix = ModelMatrix;
-            return Parent ? Parent->CalculateModelMatrix() * ModelMatrix : ModelMatrix;
+            return Translation * Rotation * Scale;
         }
 
+        /**
+         * Actors in a world get the world matrix from the world's transform hierarchy, pending transform changes are applied first.
+         * The matrix of actors outside of a world, e.x. assets, is calculated by walking up the parent chain.
+         */
+        glm::mat4 CalculateModelMatrix();
+
 #if DEVELOPMENT
         /** Editor stuff */
         virtual void    UIDrawActorDetails();
@@ -118,11 +122,13 @@ namespace lucid::scene
         {
             Children.Add(InChild);
             InChild->Parent = this;
+            InChild->OnParentChanged();
         }
         inline void RemoveChild(IActor* InChild)
         {
             Children.Remove(InChild);
             InChild->Parent = nullptr;
+            InChild->OnParentChanged();
         }
 
         /**
@@ -134,6 +140,12 @@ namespace lucid::scene
 
         inline const math::FAABB& GetAABB() const { return AABB; }
 
+        /**
+         * Recalculates the world space AABB and lets the world know about it, has to be called when the model space AABB changes.
+         * For actors in the world's transform hierarchy this is deferred until the hierarchy updates their world matrices.
+         */
+        void UpdateAABB();
+
         virtual void Tick(const float& InDeltaTime);
 
         virtual void OnScaled(const glm::vec3& InOldScale, const glm::vec3& InNewScale);
@@ -147,7 +159,8 @@ namespace lucid::scene
         {
             OldTransform     = Transform;
             Transform        = InTransform;
-            bRotationUpdated = bTranslationUpdated = bRotationUpdated = true;
+            bScaleUpdated = bTranslationUpdated = bRotationUpdated = true;
+            MarkTransformDirty();
         }
 
         inline void Translate(const glm::vec3 InTranslation)
@@ -155,6 +168,7 @@ namespace lucid::scene
             OldTransform = Transform;
             Transform.Translation += InTranslation;
             bTranslationUpdated = true;
+            MarkTransformDirty();
         }
 
         inline void SetTranslation(const glm::vec3 InTranslation)
@@ -162,8 +176,12 @@ namespace lucid::scene
             OldTransform          = Transform;
             Transform.Translation = InTranslation;
             bTranslationUpdated   = true;
+            MarkTransformDirty();
         }
 
+        /** Lets the world's transform hierarchy know that the world matrices of the actor and it's children have to be recalculated */
+        void MarkTransformDirty();
+
         void DrawAABB() const;
 
         virtual ~IActor() = default;
@@ -179,7 +197,10 @@ namespace lucid::scene
         UUID      AssetId  = sole::INVALID_UUID;
         FDString  AssetPath{ "" };
         CWorld*   World; // World that this actor is in
-        glm::mat4 CachedModelMatrix{ 1 };
+
+        /** Node of the actor in the world's transform hierarchy, bTransformDirty is set while the actor waits for it's world matrix update */
+        u32  TransformNodeIdx = INVALID_TRANSFORM_NODE;
+        bool bTransformDirty  = false;
 
         FLinkedList<IActor> Children;
 
@@ -192,12 +213,16 @@ namespace lucid::scene
         IActor* PrevBaseActorAsset = nullptr;
 
       protected:
+        friend class CTransformHierarchy;
+
         math::FAABB AABB;
 
         bool bMovable    = true;
         bool bParentable = true;
 
       private:
+        void OnParentChanged();
+
         FTransform3D Transform;
         FTransform3D OldTransform;
 
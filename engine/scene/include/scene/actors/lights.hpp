@@ -18,6 +18,42 @@ namespace lucid::scene
 {
     constexpr u8 MAX_SHADOW_CASCADES = 6;
 
+    /** Max number of directional lights with cascaded shadow maps, has to match MAX_CASCADED_LIGHTS in light_data.glsl */
+    constexpr u8 MAX_CASCADED_LIGHTS = 4;
+
+#pragma pack(push, 1)
+
+    /** Light as laid out in the light buffer, has to match FLight in light_data.glsl */
+    struct FLightData
+    {
+        glm::mat4 LightMatrix;
+        glm::vec3 Color;
+        i32       Type;
+        glm::vec3 Position;
+        float     AttenuationRadius;
+        glm::vec3 Direction;
+        float     InvAttenuationRadiusSquared;
+        float     Intensity;
+        float     InnerCutOffCos;
+        float     OuterCutOffCos;
+        float     FarPlane;
+        u32       ShadowAtlasTiles[6]; // Packed tiles in the shadow atlas, one per cube face for point lights
+        i32       bCastsShadows;
+        i32       CascadesIdx; // Index of the light's cascades in the light buffer, -1 if it has none
+    };
+
+    /** Cascaded shadow maps of a directional light, has to match FLightCascades in light_data.glsl */
+    struct FLightCascadesData
+    {
+        glm::mat4 Matrices[MAX_SHADOW_CASCADES];
+        u64       ShadowMapBindlessHandles[MAX_SHADOW_CASCADES];
+        float     FarPlanes[MAX_SHADOW_CASCADES];
+        i32       Count;
+        char      _padding[4];
+    };
+
+#pragma pack(pop)
+
     class CShadowMap;
 
     class CLight : public IActor
@@ -30,8 +66,8 @@ namespace lucid::scene
         /** Recalculates the light space matrix when e.x. the light moves or is initially created */
         virtual void UpdateLightSpaceMatrix(const LightSettings& LightSettings) = 0;
 
-        /** Sets up the shader's uniform to use this light's data */
-        virtual void SetupShader(gpu::CShader* InShader) const;
+        /** Writes this light's data to it's entry in the light buffer */
+        virtual void SetupLightData(FLightData& OutLightData) const;
         virtual void SetupShadowMapShader(gpu::CShader* InShader) = 0;
         virtual void CreateShadowMap();
         virtual void FreeShadowMap();
@@ -89,10 +125,13 @@ namespace lucid::scene
         virtual void    CreateShadowMap() override;
         virtual void    FreeShadowMap() override;
         virtual void    UpdateLightSpaceMatrix(const LightSettings& LightSettings) override;
-        virtual void    SetupShader(gpu::CShader* InShader) const override;
+        virtual void    SetupLightData(FLightData& OutLightData) const override;
         virtual void    SetupShadowMapShader(gpu::CShader* InShader) override;
         virtual IActor* CreateActorCopy() override;
 
+        /** Writes the matrices and shadow maps of the cascades calculated this frame, used only when the light casts shadows */
+        void SetupCascadesData(FLightCascadesData& OutCascadesData) const;
+
         virtual void OnAddToWorld(CWorld* InWorld) override;
         virtual void OnRemoveFromWorld(const bool& InbHardRemove) override;
 
@@ -142,7 +181,7 @@ namespace lucid::scene
         virtual ELightType GetType() const override { return ELightType::SPOT; }
 
         virtual void    UpdateLightSpaceMatrix(const LightSettings& LightSettings) override;
-        virtual void    SetupShader(gpu::CShader* InShader) const override;
+        virtual void    SetupLightData(FLightData& OutLightData) const override;
         virtual void    SetupShadowMapShader(gpu::CShader* InShader) override;
         virtual IActor* CreateActorCopy() override;
 
@@ -189,7 +228,7 @@ namespace lucid::scene
         virtual ELightType GetType() const override { return ELightType::POINT; }
 
         virtual void    UpdateLightSpaceMatrix(const LightSettings& LightSettings) override;
-        virtual void    SetupShader(gpu::CShader* InShader) const override;
+        virtual void    SetupLightData(FLightData& OutLightData) const override;
         virtual void    SetupShadowMapShader(gpu::CShader* InShader) override;
         virtual IActor* CreateActorCopy() override;
 
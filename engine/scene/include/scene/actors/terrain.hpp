@@ -1,8 +1,14 @@
 ﻿#pragma once
 
+#include <vector>
+
 #include "scene/actors/actor.hpp"
 #include "schemas/types.hpp"
 
+#include "misc/math.hpp"
+
+#include "resources/mesh_resource.hpp"
+
 namespace lucid
 {
     namespace resources
@@ -14,12 +20,41 @@ namespace lucid
     {
         class CVertexArray;
         class CGPUBuffer;
-        class CFence;
     } // namespace gpu
 } // namespace lucid
 
 namespace lucid::scene
 {
+    class CCamera;
+
+    /**
+     * The terrain is drawn as a quadtree of chunks. A chunk at level N covers TERRAIN_CHUNK_SIZE * 2^N cells and is drawn
+     * as TERRAIN_CHUNK_SIZE x TERRAIN_CHUNK_SIZE quads using every 2^N-th vertex of the terrain mesh, so distant chunks are coarser.
+     * The chunks share the mesh's vertex buffer, the index pattern of each level is stored once per combination of edges that
+     * have to be stitched to a coarser neighbour, so there are no cracks between the levels.
+     */
+    static constexpr u32 TERRAIN_CHUNK_SIZE     = 32;
+    static constexpr u8  TERRAIN_MAX_LOD_LEVELS = 10;
+
+    /** A chunk is split when the camera is closer to it than this many times it's size, 2 keeps the neighbouring chunks at most one level apart */
+    static constexpr float TERRAIN_LOD_SPLIT_DISTANCE = 2.f;
+
+    struct FTerrainChunk
+    {
+        /** Range of the terrain's LOD vertex array drawn by the chunk */
+        resources::FSubMesh SubMesh;
+
+        glm::vec3 MinWS;
+        glm::vec3 MaxWS;
+
+        /** Position of the chunk in units of the smallest chunks */
+        u32 ChunkX;
+        u32 ChunkZ;
+
+        u8   LODLevel;
+        bool bVisible;
+    };
+
     struct FTerrainSettings
     {
         /** Size of the grid in world space*/
@@ -67,6 +102,18 @@ namespace lucid::scene
         inline resources::CMeshResource* GetTerrainMesh() const { return TerrainMesh; }
         inline CMaterial*                GetTerrainMaterial() const { return TerrainMaterial; }
 
+        /**
+         * Selects the chunks to draw and their level of detail based on the distance to the camera and frustum culls them, called by the renderer each frame.
+         * Returns false when the terrain can't be drawn in chunks, i.e. it's resolution isn't a multiple of the chunk size,
+         * it's mesh isn't resident or it's being sculpted - the whole mesh should be drawn then.
+         */
+        bool UpdateChunks(const CCamera* InCamera);
+
+        /** True if the chunks selected by the last UpdateChunks() can be drawn, shadow passes draw all of them, not only the visible ones */
+        bool CanDrawChunks() const;
+
+        inline const std::vector<FTerrainChunk>& GetChunks() const { return Chunks; }
+
         /** Actor interface stuff */
 
         void FillActorAssetDescription(FTerrainDescription& OutDescription) const;
@@ -108,21 +155,52 @@ namespace lucid::scene
         float SculptStrength = 1;
         int   BrushSize      = 10;
 
-      public:
-        static constexpr u8 NumSculptingVBOs                     = 2;
-        gpu::CGPUBuffer*    SculptingVBOs[NumSculptingVBOs]      = { nullptr };
-        gpu::CFence*        SculptingVBOFences[NumSculptingVBOs] = { nullptr };
-        u8                  CurrentSculptingVBOIndex             = 0;
-        FTerrainVertex*     TerrainSculptData                    = nullptr;
-        bool                bSculptFlushNeeded                   = false;
-        bool                bSculpFlushed                        = false;
-        gpu::CGPUBuffer*    OriginalTerrainVBO;
+        /** Main memory copy of the vertices edited by the brush */
+        FTerrainVertex* TerrainSculptData = nullptr;
 
+        /**
+         * Applies the brush centered at the InBrushCenter vertex. Normals are recalculated and the vertices uploaded to
+         * the terrain mesh's vertex buffer only in the dirty rectangle, i.e. the brush plus a one vertex border.
+         */
+        void Sculpt(const glm::ivec2& InBrushCenter, const float& InDelta);
 #endif
       protected:
+        /** Creates the index buffer with the patterns of each level and the vertex array drawing the terrain mesh's vertices with it */
+        void SetupChunks();
+        void FreeChunks();
+
+        /** Recursively selects the chunks of the node at InLevel, InChunkX and InChunkZ are in units of the smallest chunks */
+        void SelectChunks(const u8& InLevel, const u32& InChunkX, const u32& InChunkZ, const glm::vec3& InCameraPosLS);
+
+        /** Sets the stitching masks and world space bounds of the selected chunks and frustum culls them */
+        void FinishChunks(const math::FFrustum& InFrustum, const glm::mat4& InModelMatrix);
+
         FTerrainSettings          TerrainSettings;
         resources::CMeshResource* TerrainMesh     = nullptr;
         CMaterial*                TerrainMaterial = nullptr;
+
+        /** Mesh and vertex buffer for which the LOD resources were created, they're recreated when the mesh changes */
+        resources::CMeshResource* ChunksTerrainMesh  = nullptr;
+        gpu::CGPUBuffer*          ChunksVertexBuffer = nullptr;
+        gpu::CGPUBuffer*          LODElementBuffer   = nullptr;
+        gpu::CVertexArray*        LODVertexArray     = nullptr;
+
+        /** 0 when the terrain can't be drawn in chunks */
+        u8 NumLODLevels = 0;
+
+        /** Number of the smallest chunks and of the root chunks in x and z */
+        u32 NumChunksX = 0;
+        u32 NumChunksZ = 0;
+        u32 NumRootsX  = 0;
+        u32 NumRootsZ  = 0;
+
+        /** Index range of the pattern for each level and mask of the edges stitched to a coarser neighbour (-Z, +X, +Z, -X) */
+        u32 LODPatternFirstIndex[TERRAIN_MAX_LOD_LEVELS][16];
+        u32 LODPatternElementCount[TERRAIN_MAX_LOD_LEVELS][16];
+
+        /** Level of the selected chunk covering each of the smallest chunks, used to find the edges that have to be stitched */
+        std::vector<u8>            ChunkLevels;
+        std::vector<FTerrainChunk> Chunks;
     };
 
     CTerrain* CreateTerrainAsset(const FDString& InName);
@@ -69,6 +69,9 @@ namespace lucid::scene
         virtual void LoadResources();
         virtual void UnloadResources();
 
+        virtual void RequestTextureMips(const float& InLog2UVFootprint) override;
+        virtual bool RefreshTextureHandles() override;
+
         inline void SetShininess(const u32& InShininess)
         {
             bMaterialDataDirty = true;
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+#include "common/types.hpp"
+#include "common/collections.hpp"
+#include "misc/math.hpp"
+
+namespace lucid::scene
+{
+    class IActor;
+
+    /** Node of the bounding volume hierarchy. Leaves store actors, inner nodes always have exactly two children. */
+    struct FBVHNode
+    {
+        inline bool IsLeaf() const { return Left == -1; }
+
+        glm::vec3 Min{ 0 };
+        glm::vec3 Max{ 0 };
+
+        i32 Parent = -1;
+        i32 Left   = -1;
+        i32 Right  = -1;
+
+        /** Height of the subtree rooted at this node, leaves have height 0 and free nodes -1 */
+        i32 Height = -1;
+
+        /** Only valid for leaves */
+        IActor* Actor = nullptr;
+    };
+
+    /**
+     * Dynamic AABB tree built over the world space bounds of the actors, used to quickly find actors in a given region of the world.
+     * Leaves store the bounds enlarged by a margin, so actors that move just a bit don't have to be reinserted every time they move.
+     * The tree is kept balanced with tree rotations when inserting/removing leaves, the same way Box2D's dynamic tree does it.
+     */
+    class CBoundingVolumeHierarchy
+    {
+      public:
+        explicit CBoundingVolumeHierarchy(const float& InFatMargin = 0.5f) : FatMargin(InFatMargin) {}
+
+        void Insert(IActor* InActor);
+        void Remove(const u32& InActorId);
+
+        /**
+         * Has to be called when the actor's world space AABB changes.
+         * Returns true if the actor had to be reinserted, false if it's still inside its enlarged bounds.
+         */
+        bool Update(IActor* InActor);
+
+        bool Contains(const u32& InActorId);
+
+        /** Adds the actors whose bounds intersect the frustum to OutActors */
+        void QueryFrustum(const math::FFrustum& InFrustum, std::vector<IActor*>& OutActors) const;
+
+        /** Adds the actors whose bounds overlap the world space bounds of InAABB to OutActors */
+        void QueryAABB(const math::FAABB& InAABB, std::vector<IActor*>& OutActors) const;
+
+        /** Adds the actors whose bounds can be hit when sweeping InAABB along InSweepDirection to OutActors */
+        void QuerySweptAABB(const math::FAABB& InAABB, const glm::vec3& InSweepDirection, std::vector<IActor*>& OutActors) const;
+
+        /** Adds the actors whose bounds overlap the sphere to OutActors */
+        void QuerySphere(const glm::vec3& InCenter, const float& InRadius, std::vector<IActor*>& OutActors) const;
+
+        /**
+         * Adds the actors whose bounds might overlap the cone to OutActors.
+         * InAngle is the cone's half-angle in radians, InLength is the distance from the apex to the cone's base.
+         */
+        void QueryCone(const glm::vec3&      InApex,
+                       const glm::vec3&      InDirection,
+                       const float&          InLength,
+                       const float&          InAngle,
+                       std::vector<IActor*>& OutActors) const;
+
+        inline u32 GetNumActors() const { return NumActors; }
+
+        void Clear();
+
+      private:
+        i32  AllocateNode();
+        void FreeNode(const i32& InNodeIndex);
+
+        void InsertLeaf(const i32& InLeafIndex);
+        void RemoveLeaf(const i32& InLeafIndex);
+
+        /** Performs a tree rotation if the subtree rooted at InNodeIndex is imbalanced, returns the new root of the subtree */
+        i32 Balance(const i32& InNodeIndex);
+
+        /** Walks the tree and collects the actors for which InOverlapTest(Min, Max) returns true for both the node and the actor's bounds */
+        template <typename TOverlapTest>
+        void QueryOverlapping(const TOverlapTest& InOverlapTest, std::vector<IActor*>& OutActors) const;
+
+        /** Adds all of the actors in the subtree to OutActors without any tests, used when the whole subtree is visible */
+        void CollectActors(const i32& InNodeIndex, std::vector<IActor*>& OutActors) const;
+
+        void FixUpwards(i32 InNodeIndex);
+
+        std::vector<FBVHNode> Nodes;
+
+        i32 RootIndex     = -1;
+        i32 FreeListIndex = -1;
+        u32 NumActors     = 0;
+        float FatMargin;
+
+        FSlotMap<i32> LeafIndexByActorId;
+
+        /** Reused between queries so we don't allocate on every query */
+        mutable std::vector<i32> TraversalStack;
+    };
+} // namespace lucid::scene
@@ -50,6 +50,7 @@ namespace lucid::scene
 
         inline void SetAspectRatio(const float& InAspectRatio) { AspectRatio = InAspectRatio; }
         inline void SetYaw(const float& InYaw) { Yaw = InYaw; }
+        inline void SetPitch(const float& InPitch) { Pitch = InPitch; }
         inline void SetPosition(const glm::vec3& InPosition) { Position = InPosition; }
         inline void SetDirection(const glm::vec3& InDirection) { FrontVector = InDirection;}
         inline void SetNearPlane(const float& InNearPlane) { NearPlane = InNearPlane; }
@@ -61,10 +62,14 @@ namespace lucid::scene
         inline float     GetNearPlane() const { return NearPlane; }
         inline float     GetFarPlane() const { return FarPlane; }
         inline float     GetYaw() const { return Yaw; }
+        inline float     GetPitch() const { return Pitch; }
         inline glm::vec3 GetCameraUp() const { return UpVector; }
 
         const math::FAABB& GetFrustumAABB() const { return FrustumAABB; }
 
+        /** Returns the world space planes of the camera's frustum, used for culling */
+        math::FFrustum GetFrustum() const;
+
         void AddForwardVelocity(const float& InSpeed);
         void AddRightVelocity(const float& InSpeed);
 
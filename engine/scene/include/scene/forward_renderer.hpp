@@ -4,11 +4,13 @@
 
 #include "material.hpp"
 #include "devices/gpu/gpu.hpp"
+#include "devices/gpu/vao.hpp"
 #include "scene/renderer.hpp"
 
 namespace lucid::resources
 {
     class CMeshResource;
+    struct FSubMesh;
 };
 
 namespace lucid::gpu
@@ -28,6 +30,15 @@ namespace lucid::scene
     constexpr int PREPASS_DATA_BUFFER_SIZE  = 1024 * 1024;
     constexpr int INSTANCE_DATA_BUFFER_SIZE = 1024 * 1024;
     constexpr int ACTOR_DATA_BUFFER_SIZE    = 1024 * 1024;
+    constexpr int DRAW_COMMANDS_BUFFER_SIZE = 1024 * 64;
+    constexpr int LIGHTS_DATA_BUFFER_SIZE   = 1024 * 256;
+
+    /** Lights are assigned to view space clusters, the grid has to match the one in light_data.glsl */
+    constexpr u32 CLUSTER_GRID_SIZE_X    = 16;
+    constexpr u32 CLUSTER_GRID_SIZE_Y    = 9;
+    constexpr u32 CLUSTER_GRID_SIZE_Z    = 24;
+    constexpr u32 NUM_CLUSTERS           = CLUSTER_GRID_SIZE_X * CLUSTER_GRID_SIZE_Y * CLUSTER_GRID_SIZE_Z;
+    constexpr u32 MAX_LIGHTS_PER_CLUSTER = 128;
 
 #pragma pack(push, 1)
     struct FForwardPrepassUniforms
@@ -37,8 +48,57 @@ namespace lucid::scene
         u64 NormalMapBindlessHandle       = 0;
         u64 DisplacementMapBindlessHandle = 0;
     };
+
+    struct FInstanceData
+    {
+        u32 ActorDataIdx;
+        u32 MaterialDataIdx;
+        u32 PrepassDataIdx;
+    };
+
+    /** Indirect draw command with additional data used by the culling shader, GL skips it thanks to the stride */
+    struct FGPUDrawCommand
+    {
+        gpu::FDrawIndirectCommand Command;
+        u32                       FirstInstance;
+        u32                       BatchSize;
+        u32                       _padding;
+    };
 #pragma pack(pop)
 
+    /** Renderer side state of an actor registered with the renderer */
+    struct FActorRenderProxy
+    {
+        IActor* Actor          = nullptr;
+        u32     ActorDataIdx   = 0; // Persistent slot of the actor in the actor data buffer
+        u8      NumDirtyFrames = 0; // Number of frame data buffers that still hold stale data of this actor
+    };
+
+    /**
+     * Everything that the mesh batches depend on for a single submesh instance. Instances visible in the current frame are compared with
+     * the ones that were batched previously and the batches are rebuilt only if they differ.
+     */
+    struct FBatchedInstance
+    {
+        const resources::FSubMesh* SubMesh             = nullptr;
+        gpu::CVertexArray*         VertexArray         = nullptr;
+        CMaterial*                 Material            = nullptr;
+        gpu::CShader*              Shader              = nullptr;
+        i32                        MaterialBufferIndex = -1;
+        u32                        ActorDataIdx        = 0;
+        u32                        BaseVertex          = 0;
+        u32                        FirstIndex          = 0;
+        u32                        VertexCount         = 0;
+        u32                        ElementCount        = 0;
+
+        bool operator==(const FBatchedInstance& InRHS) const
+        {
+            return SubMesh == InRHS.SubMesh && VertexArray == InRHS.VertexArray && Material == InRHS.Material && Shader == InRHS.Shader &&
+                   MaterialBufferIndex == InRHS.MaterialBufferIndex && ActorDataIdx == InRHS.ActorDataIdx && BaseVertex == InRHS.BaseVertex &&
+                   FirstIndex == InRHS.FirstIndex && VertexCount == InRHS.VertexCount && ElementCount == InRHS.ElementCount;
+        }
+    };
+
     struct FFreeMaterialBufferEntries
     {
         EMaterialType    MaterialType;
@@ -63,10 +123,37 @@ namespace lucid::scene
         u32                  BatchedSoFar       = 0; // Total number of batched meshes processed up until this batch
         FMaterialDataBuffer* MaterialDataBuffer = nullptr;
         u32                  BatchSize          = 0;
+        u32                  DrawCommandIdx     = 0; // Index of the batch's first indirect draw command
+        u32                  NumDrawCommands    = 0; // One draw command per submesh in the batch, meshes with the same vertex layout share the vertex array
 
         std::vector<CMaterial*> BatchedMaterials; // this is currently needed only for the prepass and should be removed
     };
 
+    /** Shadow casters of a single light that share the same vertex array, their instance data is laid out one after another */
+    struct FShadowCasterBatch
+    {
+        gpu::CVertexArray* MeshVertexArray = nullptr;
+        u32                BatchedSoFar    = 0; // Offset of the batch's first instance in the instance data buffer
+        u32                BatchSize       = 0;
+        u32                DrawCommandIdx  = 0;
+        u32                NumDrawCommands = 0;
+    };
+
+    /** Instance of a shadow caster's submesh, CubeFace is the face it's drawn to when the cube shadow map is rendered with layered instancing */
+    struct FShadowCasterInstance
+    {
+        u32 ActorDataIdx;
+        u32 CubeFace;
+    };
+
+    /** How the six faces of the point lights' shadow maps are rendered */
+    enum class EPointShadowMode : u8
+    {
+        GEOMETRY_SHADER,   // Single pass, the geometry shader sends each triangle to all of the faces
+        PER_FACE,          // Six passes, the casters are drawn once for each face
+        LAYERED_INSTANCING // Single pass, the casters are drawn once per face they're visible in, the vertex shader picks the face
+    };
+
     class CForwardRenderer : public CRenderer
     {
       public:
@@ -78,6 +165,10 @@ namespace lucid::scene
         virtual void ResetState() override;
         virtual void Cleanup() override;
 
+        virtual void RegisterActor(IActor* InActor) override;
+        virtual void UnregisterActor(const u32& InActorId) override;
+        virtual void MarkActorDirty(IActor* InActor) override;
+
         virtual gpu::CFramebuffer* GetResultFramebuffer() override { return FrameResultFramebuffer; }
         virtual gpu::CTexture*     GetResultFrameTexture() override { return FrameResultTextures[(GRenderStats.FrameNumber - 2) % NumFrameBuffers]; }
 
@@ -86,6 +177,10 @@ namespace lucid::scene
         /** Renderer properties, have to be set before the first Setup() call */
         int NumFrameBuffers = 2;
 
+        /** Sizes of the shadow atlases of spot lights and of the point lights' cube faces */
+        u16 ShadowAtlasSize     = 4096;
+        u16 CubeShadowAtlasSize = 4096;
+
         struct FRendererSettings
         {
             float AmbientStrength                 = 0.05;
@@ -95,10 +190,17 @@ namespace lucid::scene
             float SSAORadius                      = 0.5;
             bool  bDrawGrid                       = true;
             bool  bEnableDepthPrepass             = true;
-            bool  bUseGeometryShaderForShadowMaps = true;
+            bool  bGPUDrivenRendering             = false;
+            bool  bEnableOcclusionCulling         = true;
             int   SSAOKernelSize                  = 64;
             int   SSAOStrength                    = 10;
+            bool  bHalfResSSAO                    = true; // SSAO at half resolution, accumulated over frames and upsampled with a depth-aware filter
+            float SSAOTemporalBlend               = 0.1;  // Weight of the current frame when accumulating the half resolution SSAO
             int   NumPCFSamples                   = 25;
+            int   MaxShadowTileUpdatesPerFrame    = 12; // A point light takes 6 tiles, one per cube face
+
+            /** Layered instancing requires the GPU to support writing gl_ViewportIndex from the vertex shader */
+            EPointShadowMode PointShadowMode = EPointShadowMode::GEOMETRY_SHADER;
         } RendererSettings;
 
       private:
@@ -106,33 +208,92 @@ namespace lucid::scene
 
         void FreeMaterialBufferEntry(const EMaterialType& InMaterialType, const i32& InIndex);
         void HandleMaterialBufferUpdateIfNecessary(CMaterial* Material);
-        void CreateMeshBatches(FRenderScene* InSceneToRender);
+
+        /**
+         * Creates batches for the meshes in the scene and compacted lists of shadow casters for each spot and point light.
+         * Mesh batches are cached between frames, they're rebuilt only when the set of visible submesh instances changes
+         * and their instance data is copied only to the frame data buffers that don't hold it yet.
+         */
+        void CreateMeshBatches(FRenderScene* InSceneToRender, const CCamera* InCamera);
+
+        /** Builds the mesh batches, their instance data and draw commands from BatchedInstances */
+        void RebuildMeshBatches();
+
+        /** Returns the proxy of the actor, registering the actor if it wasn't registered yet. Null when the actor data buffer is full */
+        FActorRenderProxy* GetActorRenderProxy(IActor* InActor);
+
+        /** Writes the data of the dirty actors to the current frame data buffer */
+        void UpdateDirtyActorData();
 
         void SetupGlobalRenderData(const FRenderView* InRenderView);
 
+        /**
+         * GPU-driven mode only. Culls the instances of the mesh batches against the view frustum and optionally against the Hi-Z buffer
+         * built from the previous frame's depth prepass. Visible instances are compacted per batch and their count is written to the batch's draw command.
+         */
+        void CullMeshBatches(const FRenderView* InRenderView);
+
+        /**
+         * Second phase of the occlusion culling, tests the instances occluded in the first phase against the Hi-Z buffer built from this frame's prepass.
+         * The ones that passed are appended to the batches' draw commands and also get their own commands in DisoccludedDrawCommandsBuffer,
+         * so the prepass can draw just them.
+         */
+        void CullOccludedMeshBatches();
+
+        void SetupHiZCullingUniforms();
+
+        /** Builds the Hi-Z buffer from the depth written in the depth prepass, used by the second culling phase and the next frame's first one */
+        void BuildHiZBuffer(const FRenderView* InRenderView);
+
+        /**
+         * Calculates SSAO at half resolution from the half resolution depth chain, reprojects the previous frame's result and blends it with the current one.
+         * The accumulated result is upsampled to SSAOBlurred with a depth-aware bilateral filter.
+         */
+        void CalculateHalfResSSAO(const FRenderView* InRenderView);
+
+        /**
+         * Draws a batch whose vertex array is already bound with a single multi-draw call, one draw per submesh.
+         * In GPU-driven mode the instance counts of the mesh batches are written to their draw commands by the culling shader.
+         */
+        inline void DrawBatch(gpu::CVertexArray* InVertexArray, const u32& InNumDrawCommands, const u32& InFirstDrawCommandIdx);
+
+        /** Writes the parameters, shadow matrices and shadow map handles of all lights in the scene to the current light buffer */
+        void SetupLightsData(const FRenderScene* InSceneToRender);
+
+        /** Assigns the spot and point lights to the view space clusters they affect, so the lighting pass can draw each batch once */
+        void AssignLightsToClusters(const FRenderView* InRenderView);
+
+        /**
+         * Allocates the atlas tiles of the spot and point light shadow maps based on how much of the screen the lights cover
+         * and picks the stale shadow maps that are rendered this frame, most important first, within the per-frame tile budget.
+         * A shadow map is stale when it's tiles were (re)allocated, the light changed or one of it's casters moved, appeared or disappeared.
+         * Has to be called before CreateMeshBatches, only the casters of the picked shadow maps are batched.
+         */
+        void UpdateShadowAtlases(FRenderScene* InSceneToRender, const FRenderView* InRenderView);
+
         void GenerateShadowMaps(FRenderScene* InSceneToRender, CCamera* InCamera);
-        void GeneratePointShadowMapWithoutGS(CPointLight* InLight, FRenderScene* InRenderScene);
-        void GenerateCascadeShadowMaps(CDirectionalLight* InLight, const FRenderScene* InRenderScene, CCamera* InCamera);
+        /** Renders the cube faces of the point light into their tiles using the point shadow mode from the settings */
+        void GeneratePointShadowMap(CPointLight* InLight);
+        /** Calculates cascade matrices and finds the shadow casters of each cascade, has to be called before CreateMeshBatches */
+        void CalculateCascades(CDirectionalLight* InLight, const FRenderScene* InRenderScene, CCamera* InCamera);
+        void GenerateCascadeShadowMaps(CDirectionalLight* InLight);
         void Prepass(const FRenderScene* InSceneToRender, const FRenderView* InRenderSource);
         void LightingPass(const FRenderScene* InSceneToRender, const FRenderView* InRenderSource);
 
-        inline void BindAndClearFramebuffer(gpu::CFramebuffer* InFramebuffer);
-
-        void        RenderStaticMeshes(const FRenderScene* InScene, const FRenderView* InRenderView);
-        inline void RenderLightContribution(const CLight* InLight, const FRenderScene* InScene, const FRenderView* InRenderView);
+        /** Draws each mesh batch once, the shaders loop over the lights in the fragment's cluster */
+        void RenderStaticMeshes(const FRenderScene* InScene, const FRenderView* InRenderView);
 
         void RenderSkybox(const CSkybox* InSkybox, const FRenderView* InRenderView);
 
         void DoGammaCorrection(gpu::CTexture* InTexture);
 
+        /** Debug group of one of the top level passes, in development builds it's GPU time and draw calls are added to GRenderStats */
+        void BeginRenderPass(const char* InName);
+        void EndRenderPass();
+
 #if DEVELOPMENT
         void DrawLightsBillboards(const FRenderScene* InScene, const FRenderView* InRenderView);
         void RenderEditorHelpers(const FRenderScene* InScene, const FRenderView* InRenderView);
-        void RenderWithDefaultMaterial(const resources::CMeshResource* InMeshResource,
-                                       const u16&                      InSubMeshIndex,
-                                       const CLight*                   InLight,
-                                       const FRenderView*              InRenderView,
-                                       const glm::mat4&                InModelMatrix);
         void RenderWorldGrid(const FRenderView* InRenderView);
         void RenderDebugLines(const FRenderView* InRenderView);
 #endif
@@ -159,11 +320,18 @@ namespace lucid::scene
         gpu::CShader* CascadeShadowMapShader;
         gpu::CShader* ShadowCubeMapShader;
         gpu::CShader* ShadowCubeMapShaderNoGS;
+        gpu::CShader* ShadowCubeMapShaderLayered;
         gpu::CShader* SkyboxShader;
         gpu::CShader* PrepassShader;
         gpu::CShader* SSAOShader;
+        gpu::CShader* SSAOHalfResShader;
+        gpu::CShader* SSAOUpsampleShader;
+        gpu::CShader* SSAODepthChainShader;
         gpu::CShader* BillboardShader;
         gpu::CShader* GammaCorrectionShader;
+        gpu::CShader* CullMeshBatchesShader;
+        gpu::CShader* HiZShader;
+        gpu::CShader* ClusterLightsShader;
 
         /** Blur shader */
         gpu::CShader* SimpleBlurShader;
@@ -196,14 +364,34 @@ namespace lucid::scene
         gpu::CTexture* SSAOBlurred;
         u64            SSAOBlurredBindlessHandle;
 
-        gpu::CTexture**     LightingPassColorBuffers;
-        gpu::CRenderbuffer* DepthStencilRenderBuffer;
+        /** Half resolution linear view space depth, each mip stores the min of the previous one. Built after the depth prepass when using half resolution SSAO */
+        gpu::CTexture* SSAODepthChain;
+        u8             SSAODepthChainNumMips = 0;
+
+        /** Half resolution SSAO accumulated over frames and the linear depth it was calculated at, the previous frame's one is read when writing the current one */
+        gpu::CTexture* SSAOHistory[2];
+        u8             CurrentSSAOHistory = 0;
+        bool           bSSAOHistoryValid  = false;
+        glm::mat4      SSAOPreviousViewProjection{ 1 };
+
+        gpu::CTexture** LightingPassColorBuffers;
+
+        /** Shared by the depth prepass and the lighting pass, view space positions are reconstructed from it */
+        gpu::CTexture* SceneDepthTexture;
 
         /** Generated in the depth prepass so we can later use it when calculating SSAO and things like that (VS - View Space) */
         gpu::CTexture* CurrentFrameVSNormalMap;
 
-        /** Generated in the depth prepass so we can later use it when calculating SSAO and things like that (VS - View Space) */
-        gpu::CTexture* CurrentFrameVSPositionMap;
+        /** Farthest view space depth of each pixel, each mip stores the max of the previous one. Built after the depth prepass */
+        gpu::CTexture* HiZTexture;
+        u8             HiZNumMips = 0;
+        bool           bHiZValid  = false;
+
+        /** Set when the first culling phase rejected instances using the Hi-Z buffer, so the second phase has to run */
+        bool bMainInstancesOcclusionCulled = false;
+        glm::mat4      HiZViewMatrix{ 1 };
+        glm::mat4      HiZProjectionMatrix{ 1 };
+        float          HiZNearPlane = 0;
 
         /** Holds the final frame after post-processing, tone-mapping and gamma correction */
         gpu::CFramebuffer* FrameResultFramebuffer;
@@ -221,7 +409,51 @@ namespace lucid::scene
         gpu::CGPUBuffer* InstanceDataSSBO;
         char*            InstanceDataMappedPtr = nullptr;
 
+        /** GPU-driven mode only, instance data of the instances that survived culling, compacted per mesh batch */
+        gpu::CGPUBuffer* CulledInstanceDataSSBO;
+
+        /** GPU-driven mode only, whether each instance was rejected by the first occlusion culling phase and the draw commands of the second one */
+        gpu::CGPUBuffer* OccludedInstancesSSBO;
+        gpu::CGPUBuffer* DisoccludedDrawCommandsBuffer;
+
+        /** Indirect draw commands of the mesh batches followed by the commands of the shadow caster batches */
+        gpu::CGPUBuffer* DrawCommandsBuffer;
+        char*            DrawCommandsMappedPtr = nullptr;
+        u32              NumMainInstances      = 0;
+        u32              NumMainDrawCommands   = 0;
+
+        /** Light buffer with the data of all lights in the scene, directional lights are stored first */
+        gpu::CGPUBuffer* LightsDataSSBO;
+        char*            LightsDataMappedPtr = nullptr;
+
+        /** Number of lights and indices of the lights affecting each cluster, written only by the GPU */
+        gpu::CGPUBuffer* ClusterLightsSSBO;
+
+        /** Registered actors, each of them owns a slot in the actor data buffer until it's unregistered */
+        std::unordered_map<u32, FActorRenderProxy> RenderProxyByActorId;
+        std::vector<u32>                           DirtyActorIds;
+        std::vector<u32>                           FreeActorDataSlots;
+        u32                                        NumActorDataSlots = 0;
+
+        /** Submesh instances that the cached mesh batches were built from and the ones visible in the current frame */
+        std::vector<FBatchedInstance> BatchedInstances;
+        std::vector<FBatchedInstance> VisibleInstances;
+
+        /** CPU copy of the cached mesh batches' instance data and draw commands, copied to the frame data buffers when they're stale */
+        std::vector<FInstanceData>   MainInstanceData;
+        std::vector<FGPUDrawCommand> MainDrawCommands;
+        u32                          MeshBatchesVersion = 0;
+        u32                          MainInstanceDataVersions[FRAME_DATA_BUFFERS_COUNT]{ 0 };
+
+        /** Reused between frames when building the shadow caster batches */
+        std::unordered_map<gpu::CVertexArray*, std::unordered_map<const resources::FSubMesh*, std::vector<FShadowCasterInstance>>> CasterInstancesByVAO;
+
         std::vector<FMeshBatch>                                       MeshBatches;
+        std::unordered_map<u32, std::vector<FShadowCasterBatch>>      ShadowCasterBatchesByLightId;
+        std::unordered_map<u32, std::vector<IActor*>>                 CascadeShadowCastersByLightId[MAX_SHADOW_CASCADES];
+        std::unordered_map<u32, std::vector<IActor*>>                 ShadowCastersByLightId;
+        std::vector<CLight*>                                          ShadowMapsToUpdate; // Spot and point lights whose shadow maps are rendered this frame
+        std::unordered_map<u32, std::vector<FShadowCasterBatch>>      CascadeShadowCasterBatchesByLightId[MAX_SHADOW_CASCADES];
         std::unordered_map<EMaterialType, FMaterialDataBuffer>        MaterialDataBufferPerMaterialType;
         std::vector<FFreeMaterialBufferEntries>                       FreeMaterialBuffersEntries;
         std::unordered_map<EMaterialType, FFreeMaterialBufferEntries> NewFreeMaterialBuffersEntries; // entries freed during current frame
@@ -249,25 +481,43 @@ namespace lucid::scene
         gpu::FPipelineState WorldGridPipelineState;
         gpu::FPipelineState DebugLinesPipelineState;
 
-        /** Used to render ids of the objects in the scene so we can do nice mouse picking in the tools */
+        /**
+         * Used to render ids of the objects in the scene so we can do nice mouse picking in the tools.
+         * They're rendered only when a pick was requested, scissored to the picked pixel unless the hitmap is shown as the debug texture.
+         */
         gpu::CTexture*      HitMapTexture;
         gpu::CTexture*      DistanceToCameraTexture;
         gpu::CFramebuffer*  EditorHelpersFramebuffer;
         gpu::FPipelineState EditorHelpersPipelineState;
         gpu::CRenderbuffer* EditorHelpersDepthStencilRenderbuffer;
 
+        /** Read back the picked pixel of the hit map and of the distance to camera texture */
         gpu::CPixelBuffer* HitmapReadPBO;
         gpu::CPixelBuffer* DistanceToCameraPBO;
+        bool               bPickReadInFlight = false;
+        u32                PickReadRequestId = 0;
 
         gpu::CTimer* FrameTimer = nullptr;
 
+        /** Read after the frame timer, which already waited for the GPU, so the passes don't stall it */
+        gpu::CTimer* PassTimers[MAX_RENDER_PASS_STATS]{ nullptr };
+        u32          PassFirstDrawCall = 0;
+
+        /**
+         * Renders the shadow maps of all of the point lights with each of the point shadow modes, one mode per frame, and logs how long they took.
+         * Open a world with many point lights and shadow casters first.
+         * BenchmarkedPointShadowMode is the mode measured in the current frame, -1 when the benchmark isn't running.
+         */
+        void BenchmarkPointShadowMaps();
+
+        i8               BenchmarkedPointShadowMode = -1;
+        EPointShadowMode PointShadowModeBeforeBenchmark;
+
         gpu::CShader*      DebugLinesShader = nullptr;
         gpu::CVertexArray* DebugLinesVAO    = nullptr;
         gpu::CGPUBuffer*   DebugLinesVertexBuffers[FRAME_DATA_BUFFERS_COUNT]{ nullptr };
 
-        // @TODO add support for editing multiple terrains at the same time
-        gpu::CFence** TerrainFenceToCreate  = nullptr;
-        int           CurrentDebugDebugType = 0;
+        int CurrentDebugDebugType = 0;
 
 #endif
     };
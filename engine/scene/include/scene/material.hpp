@@ -8,6 +8,11 @@ namespace lucid::gpu
     class CTexture;
 } // namespace lucid::gpu
 
+namespace lucid::resources
+{
+    class CTextureResource;
+} // namespace lucid::resources
+
 namespace lucid
 {
     enum class EFileFormat : int;
@@ -66,7 +71,19 @@ namespace lucid::scene
         /** Calculates the size in bytes needed to store properties of this material */
         virtual u16 GetShaderDataSize() const = 0;
 
-        virtual ~CMaterial() = default;
+        /**
+         * Called by the texture streamer with the finest UV footprint of the material's fragments read back from the feedback buffer,
+         * materials that sample streamed textures request their mips based on it.
+         */
+        virtual void RequestTextureMips(const float& InLog2UVFootprint) {}
+
+        /**
+         * Called by the renderer when the streamer swapped some textures, updates the cached bindless handles.
+         * Returns true when the shader data has to be written again.
+         */
+        virtual bool RefreshTextureHandles() { return false; }
+
+        virtual ~CMaterial();
 
 #if DEVELOPMENT
         virtual void UIDrawMaterialEditor();
@@ -86,9 +103,21 @@ namespace lucid::scene
         i32           MaterialBufferIndexToFree = -1;
         EMaterialType TypeToFree                = EMaterialType::NONE;
 
+        /** Value of CTextureStreamer::GetHandlesGeneration() when the renderer last refreshed the texture handles of this material */
+        u32 TextureHandlesGeneration = 0;
+
       protected:
         virtual void InternalSaveToResourceFile(const lucid::EFileFormat& InFileFormat) = 0;
 
+        /** Materials that sample textures get a slot in the texture streamer's feedback buffer while their resources are loaded */
+        void AcquireTextureFeedbackSlot();
+        void ReleaseTextureFeedbackSlot();
+
+        /** Updates a cached bindless handle of a texture that was made resident, returns true if the streamer swapped the texture */
+        static bool RefreshBindlessHandle(const resources::CTextureResource* InTexture, u64& InOutBindlessHandle);
+
+        u32 TextureFeedbackSlot = 0xFFFFFFFF;
+
         bool bMaterialDataDirty = true;
         bool bIsRenaming        = false;
     };
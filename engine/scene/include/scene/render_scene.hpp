@@ -1,5 +1,8 @@
 #pragma once
 
+#include <vector>
+
+#include "common/arena.hpp"
 #include "common/collections.hpp"
 #include "common/strings.hpp"
 #include "misc/math.hpp"
@@ -18,6 +21,8 @@ namespace lucid::scene
     class CStaticMesh;
     class CSkybox;
     class CTerrain;
+    class IActor;
+    class CBoundingVolumeHierarchy;
 
     /*
      * The RenderScene contains things like objects to render, lights, fog volumes in a Renderer-implementation-agnostic format.
@@ -29,19 +34,23 @@ namespace lucid::scene
     {
         FRenderScene() = default;
 
-        FHashMap<u32, CStaticMesh*>       StaticMeshes;
-        FHashMap<u32, CTerrain*>          Terrains;
-        FHashMap<u32, CDirectionalLight*> DirectionalLights;
-        FHashMap<u32, CSpotLight*>        SpotLights;
-        FHashMap<u32, CPointLight*>       PointLights;
-        FHashMap<u32, CLight*>            AllLights;
-        CSkybox*                          Skybox;
+        FSlotMap<CStaticMesh*>            StaticMeshes;
+        FSlotMap<CTerrain*>               Terrains;
+        FSlotMap<CDirectionalLight*>      DirectionalLights;
+        FSlotMap<CSpotLight*>             SpotLights;
+        FSlotMap<CPointLight*>            PointLights;
+        FSlotMap<CLight*>                 AllLights;
+        CSkybox*                          Skybox = nullptr;
+
+        /** Spatial index over all of the geometry in the world, used by the renderer to find geometry outside of the view, e.x. shadow casters */
+        const CBoundingVolumeHierarchy* GeometryBVH = nullptr;
     };
 
+    /** The arrays are allocated from the frame arena, so the result is only valid until the end of the frame and doesn't have to be freed */
     struct FGeometryIntersectionQueryResult
     {
-        FArray<CStaticMesh*> StaticMeshes{ 32, true };
-        FArray<CTerrain*>    Terrains{ 32, true };
+        FArray<CStaticMesh*> StaticMeshes{ 32, true, 2, &GFrameArena };
+        FArray<CTerrain*>    Terrains{ 32, true, 2, &GFrameArena };
         math::FAABB          GeometryAABB;
     };
 
@@ -54,4 +63,10 @@ namespace lucid::scene
                                           const math::FAABB&                AABB,
                                           const glm::vec3&                  SweepDirection,
                                           FGeometryIntersectionQueryResult& OutQueryResult);
+
+    /**
+     * Finds the geometry that can cast shadows into the spot/point light's shadow map - geometry inside the light's cone/sphere.
+     * The casters don't have to be a part of the scene, as they can be outside of the view, but still cast shadows visible in it.
+     */
+    void FindLightShadowCasters(const FRenderScene* Scene, const CLight* InLight, std::vector<IActor*>& OutCasters);
 } // namespace lucid::scene
@@ -69,47 +69,135 @@ namespace lucid::scene
     /////////////////////////////////////
     //           ShadowMaps            //
     /////////////////////////////////////
+
+    /** Square region of a shadow atlas in texels */
+    struct FShadowAtlasTile
+    {
+        inline bool IsValid() const { return Size > 0; }
+
+        u16 X = 0, Y = 0;
+        u16 Size = 0;
+    };
+
+    /**
+     * Shared depth texture that the shadow maps of spot lights and the cube faces of point lights are rendered into.
+     * Tiles are power of two squares handed out by a quadtree buddy allocator - a free tile is split into four smaller ones
+     * when there's no free tile of the requested size and the four are merged back into their parent once all of them are released.
+     */
+    class CShadowAtlas
+    {
+      public:
+        CShadowAtlas(gpu::CTexture* InTexture, const u16& InMinTileSize);
+
+        /** Returns false if there is no free tile of the requested size, InSize is rounded up to a power of two */
+        bool Allocate(const u16& InSize, FShadowAtlasTile& OutTile);
+        void Release(const FShadowAtlasTile& InTile);
+
+        /** Packs the tile into a single u32 stored in the light buffer, see GetShadowAtlasTileRect() in light_data.glsl */
+        static u32 PackTile(const FShadowAtlasTile& InTile);
+
+        inline gpu::CTexture* GetTexture() const { return Texture; }
+        inline u16            GetSize() const { return Size; }
+        inline u16            GetMinTileSize() const { return MinTileSize; }
+        inline u32            GetNumFreeTexels() const { return NumFreeTexels; }
+
+        void Free();
+
+      private:
+        inline u8 GetTileLevel(const u16& InSize) const;
+
+        gpu::CTexture* Texture;
+        u16            Size;
+        u16            MinTileSize;
+        u32            NumFreeTexels;
+
+        /** Free tiles of each level, level 0 is the whole atlas and each following level halves the tile size */
+        std::vector<std::vector<FShadowAtlasTile>> FreeTilesByLevel;
+    };
+
+    /**
+     * Cascades of directional lights own their textures, as they follow the camera and are rendered every frame.
+     * Shadow maps of spot and point lights are tiles in the shadow atlases, which the renderer allocates based on the light's
+     * importance on screen. Their contents are cached and rendered again only when they were invalidated.
+     */
     class CShadowMap : public CRendererObject
     {
       public:
         CShadowMap(const RID& InId, gpu::CTexture* InShadowMapTexture, const u8& InShadowMapQuality);
+        CShadowMap(const RID& InId, const ELightType& InLightType, const u8& InShadowMapQuality);
 
         inline gpu::CTexture* GetShadowMapTexture() const { return ShadowMapTexture; }
-        inline gpu::CCubemap* GetShadowCubeMapTexture() const { return ShadowCubeMapTexture; }
         inline u8             GetQuality() const { return ShadowMapQuality; }
 
+        /** One tile for spot lights, one tile per cube face for point lights */
+        inline u8                      GetNumTiles() const { return LightType == ELightType::POINT ? 6 : 1; }
+        inline const FShadowAtlasTile& GetTile(const u8& InTileIdx) const { return Tiles[InTileIdx]; }
+        inline bool                    HasTiles() const { return Tiles[0].IsValid(); }
+        inline CShadowAtlas*           GetAtlas() const { return Atlas; }
+
+        /** Allocates all of the tiles of the shadow map with the given size, the old ones are released first */
+        bool AllocateTiles(CShadowAtlas* InAtlas, const u16& InTileSize);
+        void ReleaseTiles();
+
         virtual void Free() override;
 
+        /** Set when the contents of the tiles are stale, i.e. they were just allocated or the light or one of it's casters changed */
+        bool bNeedsUpdate = true;
+
+        /** False until the tiles are rendered for the first time after they were allocated, the light doesn't cast shadows until then */
+        bool bTilesRendered = false;
+
+        /** State of the light and of it's casters when the tiles were last rendered, used to detect changes */
+        glm::mat4 CachedLightMatrix{ 0 };
+        u64       CachedCastersHash = 0;
+
+        /** Roughly the fraction of the screen covered by the light's volume, calculated each frame */
+        float Importance = 0;
+
       private:
         u8             ShadowMapQuality;
-        gpu::CTexture* ShadowMapTexture     = nullptr;
-        gpu::CCubemap* ShadowCubeMapTexture = nullptr;
+        ELightType     LightType;
+        gpu::CTexture* ShadowMapTexture = nullptr;
+
+        CShadowAtlas*    Atlas = nullptr;
+        FShadowAtlasTile Tiles[6];
     };
 
 #if DEVELOPMENT
 
-    template <typename T>
-    struct FCachedTexture
+    /** Id of the actor and it's distance to the camera under the pixel requested with RequestPick(), 0 if there was nothing there */
+    struct FPickResult
     {
-        inline T GetValueAtPosition(const glm::vec2& MousePosition) const
-        {
-            if (MousePosition.x > 0 && (int)MousePosition.x < Width && MousePosition.y > 0 && (int)MousePosition.y < Height)
-            {
-                return CachedTextureData[(Width * (Height - (int)MousePosition.y)) + (int)MousePosition.x];
-            }
-            return 0;
-        }
+        u32   RequestId        = 0;
+        u32   ActorId          = 0;
+        float DistanceToCamera = 0;
+    };
+
+    static constexpr u8 MAX_RENDER_PASS_STATS = 16;
 
-        T*  CachedTextureData;
-        u32 Width, Height;
+    /** GPU time and draw calls of one of the top level passes of the frame, the name is the pass' debug group */
+    struct FRenderPassStats
+    {
+        const char* Name;
+        float       GPUTimeMiliseconds;
+        u32         NumDrawCalls;
     };
 
     /** Stores information about the last rendered frame, populated by the renderer in Render() */
     struct FRenderStats
     {
+        /** GPU time of the whole frame */
         float FrameTimeMiliseconds;
+
+        /** Time Render() spent on the CPU, without waiting for the frame timer */
+        float CPUTimeMiliseconds;
+
         u32   NumDrawCalls;
+        u32   NumShadowTilesUpdated;
         u64   FrameNumber = 0;
+
+        FRenderPassStats Passes[MAX_RENDER_PASS_STATS];
+        u8               NumPasses = 0;
     };
 
     extern FRenderStats GRenderStats;
@@ -153,6 +241,20 @@ namespace lucid::scene
         /** Stalls the CPU until GPU finished executing all commands of the previous Render() call.  */
         void WaitForFrameEnd() const { gpu::Finish(); }
 
+        /////////////////////////////////////
+        //          Render proxies         //
+        /////////////////////////////////////
+
+        /**
+         * Called by the world when a static mesh or a terrain is added to it, so the renderer can keep persistent per-actor data
+         * for it instead of rebuilding it every frame. The data is rewritten only after the actor is marked as dirty.
+         */
+        virtual void RegisterActor(IActor* InActor) {}
+        virtual void UnregisterActor(const u32& InActorId) {}
+
+        /** Has to be called when something that the per-actor render data depends on changes, e.x. the actor's transform */
+        virtual void MarkActorDirty(IActor* InActor) {}
+
         /////////////////////////////////////
         //         Lights/ShadowMaps       //
         /////////////////////////////////////
@@ -165,10 +267,23 @@ namespace lucid::scene
         void        RemoveShadowMap(CShadowMap* InShadowMap);
 
 #if DEVELOPMENT
-        inline const FCachedTexture<u32>&   GetCachedHitMap() const { return CachedHitMap; }
-        inline const FCachedTexture<float>& GetCachedDistanceToCameraMap() const { return CachedDistanceToCameraMap; }
-        inline gpu::CTexture*               GetLightBulbTexture() const { return LightBulbTexture; }
-        inline gpu::CTexture*               GetSelectedDebugTexture() const { return SelectedDebugTexture; }
+        inline gpu::CTexture* GetLightBulbTexture() const { return LightBulbTexture; }
+        inline gpu::CTexture* GetSelectedDebugTexture() const { return SelectedDebugTexture; }
+
+        /**
+         * Requests a pick at InPosition, which is in the result's resolution with the origin in the upper left corner.
+         * The renderer reads back only the picked pixel and only when there's a request, so the result is ready a frame or two later.
+         * Returns the id of the request, which is stored in the result so the caller can tell if the result is stale.
+         */
+        inline u32 RequestPick(const glm::uvec2& InPosition)
+        {
+            bPickRequested = true;
+            PickPosition   = InPosition;
+            return ++LastPickRequestId;
+        }
+
+        /** Result of the last pick that was read back */
+        inline const FPickResult& GetLastPickResult() const { return LastPickResult; }
         
         /**
          * Queues a debug line to draw during the next Render() call.
@@ -206,6 +321,10 @@ namespace lucid::scene
         CLight**     CreatedLights     = nullptr;
         CShadowMap** CreatedShadowMaps = nullptr;
 
+        /** Atlases of the spot light shadow maps and of the point light cube faces, created by the renderer in Setup() */
+        CShadowAtlas* ShadowAtlas     = nullptr;
+        CShadowAtlas* CubeShadowAtlas = nullptr;
+
         /** Default quality used when creating  shadow maps - 0 lowest */
         u8 DefaultShadowMapQuality = 1;
         u8 DefaultLightQuality     = 1;
@@ -226,8 +345,11 @@ namespace lucid::scene
         /** Used to visualize light sources in the editor */
         gpu::CTexture* LightBulbTexture = nullptr;
 
-        FCachedTexture<u32>   CachedHitMap              = {};
-        FCachedTexture<float> CachedDistanceToCameraMap = {};
+        /** Pick requested by the editor, handled in the next Render() call */
+        bool        bPickRequested    = false;
+        glm::uvec2  PickPosition      = { 0, 0 };
+        u32         LastPickRequestId = 0;
+        FPickResult LastPickResult;
 
         gpu::CTexture* SelectedDebugTexture = nullptr;
 #endif
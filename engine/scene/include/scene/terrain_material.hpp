@@ -39,6 +39,9 @@ namespace lucid::scene
         virtual void LoadResources() override;
         virtual void UnloadResources() override;
 
+        virtual void RequestTextureMips(const float& InLog2UVFootprint) override;
+        virtual bool RefreshTextureHandles() override;
+
 #if DEVELOPMENT
         int          EditedLayer = -1;
         virtual void UIDrawMaterialEditor() override;
@@ -22,6 +22,9 @@ namespace lucid::scene
         void LoadResources() override;
         void UnloadResources() override;
 
+        virtual void RequestTextureMips(const float& InLog2UVFootprint) override;
+        virtual bool RefreshTextureHandles() override;
+
         inline void SetRoughnessMap(resources::CTextureResource* InRoughnessMap)
         {
             RoughnessMap       = InRoughnessMap;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include "common/types.hpp"
+
+namespace lucid::scene
+{
+    class IActor;
+
+    /** Node index of actors that aren't a part of any hierarchy */
+    static constexpr u32 INVALID_TRANSFORM_NODE = UINT32_MAX;
+
+    /**
+     * World matrices of the actors in the world, stored as structure of arrays sorted so that parents always go before their children.
+     * Subtrees occupy contiguous ranges of the arrays, so a subtree is updated by a single linear pass that reads the parent's world matrix
+     * computed just before it. The actors mark themselves as dirty when their transform changes and Update() recomputes only the subtrees
+     * of the dirty nodes, independent subtrees in parallel. The arrays are re-sorted only when actors are added, removed or re-parented.
+     */
+    class CTransformHierarchy
+    {
+      public:
+        void Add(IActor* InActor);
+        void Remove(IActor* InActor);
+
+        /** Has to be called when the actor's parent changes, the nodes are sorted again on the next update */
+        inline void OnParentChanged() { bStructureDirty = true; }
+
+        /** The actor's local transform is read on the next update, so it can be called multiple times per frame */
+        void MarkDirty(IActor* InActor);
+
+        /** Recomputes the world matrices and AABBs of the dirty nodes and their descendants and lets the world know that their bounds changed */
+        void Update();
+
+        inline const glm::mat4& GetWorldMatrix(const u32& InNodeIdx) const { return WorldMatrices[InNodeIdx]; }
+        inline bool             HasPendingChanges() const { return bStructureDirty || !DirtyActors.empty(); }
+        inline u32              GetNumNodes() const { return Actors.size(); }
+
+        void Clear();
+
+      private:
+        void Sort();
+        void UpdateSubtree(const u32& InRootNodeIdx);
+
+        /** Parents go before their children, the subtree of a node ends at it's SubtreeEnd */
+        std::vector<IActor*>   Actors;
+        std::vector<i32>       Parents;
+        std::vector<u32>       SubtreeEnds;
+        std::vector<glm::vec3> Translations;
+        std::vector<glm::quat> Rotations;
+        std::vector<glm::vec3> Scales;
+        std::vector<glm::mat4> WorldMatrices;
+
+        /** Actors whose transform changed since the last update */
+        std::vector<IActor*> DirtyActors;
+
+        /** Reused between the updates so we don't allocate */
+        std::vector<u32>     DirtyNodes;
+        std::vector<u32>     DirtySubtrees;
+        std::vector<IActor*> TraversalStack;
+        std::vector<IActor*> SortedActors;
+
+        bool bStructureDirty = false;
+    };
+} // namespace lucid::scene
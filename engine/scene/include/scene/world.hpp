@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+#include <vector>
+
 #include "actors/terrain.hpp"
 #include "common/strings.hpp"
 
@@ -7,6 +9,9 @@
 #include "platform/input.hpp"
 #include "schemas/types.hpp"
 
+#include "scene/bvh.hpp"
+#include "scene/transform_hierarchy.hpp"
+
 namespace lucid::scene
 {
     class CStaticMesh;
@@ -55,30 +60,47 @@ namespace lucid::scene
 
         IActor* RemoveActorById(const u32& InActorId, const bool& InbHardRemove);
 
+        /** Culls the world against the camera's frustum, the resulting scene contains only the actors that the camera can see */
         FRenderScene* MakeRenderScene(CCamera* InCamera);
+
+        /** Called by the actors when their world space AABB changes so we can keep the spatial index and the renderer's actor data up to date */
+        void OnActorAABBChanged(IActor* InActor);
+
+        inline const CBoundingVolumeHierarchy& GetGeometryBVH() const { return GeometryBVH; }
+
+        inline CTransformHierarchy& GetTransformHierarchy() { return TransformHierarchy; }
+
         IActor*       GetActorById(const u32& InActorId);
 
         void SaveToJSONFile(const FString& InFilePath) const;
         void SaveToBinaryFile(const FString& InFilePath) const;
 
-        inline FHashMap<u32, IActor*>& GetActorsMap() { return ActorById; }
+        inline FSlotMap<IActor*>& GetActorsMap() { return ActorById; }
 
         void Unload();
     private:
         void CreateWorldDescription(FWorldDescription& OutWorldDescription) const;
         u32  AddActor(IActor* InActor);
 
-        FHashMap<u32, IActor*> ActorById;
+        FSlotMap<IActor*> ActorById;
 
         u32                               NextActorId = 1;
-        FHashMap<u32, CStaticMesh*>       StaticMeshes;
-        FHashMap<u32, CDirectionalLight*> DirectionalLights;
-        FHashMap<u32, CSpotLight*>        SpotLights;
-        FHashMap<u32, CPointLight*>       PointLights;
-        FHashMap<u32, CLight*>            AllLights;
+        FSlotMap<CStaticMesh*>            StaticMeshes;
+        FSlotMap<CDirectionalLight*>      DirectionalLights;
+        FSlotMap<CSpotLight*>             SpotLights;
+        FSlotMap<CPointLight*>            PointLights;
+        FSlotMap<CLight*>                 AllLights;
         CSkybox*                          Skybox = nullptr;
-        FHashMap<u32, CTerrain*>          Terrains;
+        FSlotMap<CTerrain*>               Terrains;
+
+        /** Spatial index over static meshes and terrains, lights are culled separately based on their attenuation radius */
+        CBoundingVolumeHierarchy GeometryBVH;
+
+        /** World matrices of all of the actors, updated once per frame before the world is culled */
+        CTransformHierarchy TransformHierarchy;
 
+        /** Reused between frames so we don't allocate when culling */
+        std::vector<IActor*> CulledActors;
     };
 
     CWorld* LoadWorldFromJSONFile(const FString& InFilePath);
@@ -380,6 +380,10 @@ namespace lucid::scene
         {
             BaseActorAsset->RemoveAssetReference(this);
         }
+        if (World)
+        {
+            World->GetTransformHierarchy().Remove(this);
+        }
     }
 
     void IActor::CleanupAfterRemove()
@@ -440,7 +444,8 @@ namespace lucid::scene
 
         if (bTransformUpdated)
         {
-            AABB.OrientAround(Transform);
+            // The editor changes the transform directly, so the hierarchy is notified here as well
+            UpdateAABB();
         }
 
         if (bDrawAABB)
@@ -449,6 +454,55 @@ namespace lucid::scene
         }
     }
 
+    void IActor::UpdateAABB()
+    {
+        // The AABB has to be oriented with the parents' transforms as well, so it's updated along with the world matrix
+        if (World && TransformNodeIdx != INVALID_TRANSFORM_NODE)
+        {
+            MarkTransformDirty();
+            return;
+        }
+
+        AABB.OrientAround(Transform);
+        if (World)
+        {
+            World->OnActorAABBChanged(this);
+        }
+    }
+
+    glm::mat4 IActor::CalculateModelMatrix()
+    {
+        if (World && TransformNodeIdx != INVALID_TRANSFORM_NODE)
+        {
+            CTransformHierarchy& TransformHierarchy = World->GetTransformHierarchy();
+            if (TransformHierarchy.HasPendingChanges())
+            {
+                TransformHierarchy.Update();
+            }
+            return TransformHierarchy.GetWorldMatrix(TransformNodeIdx);
+        }
+
+        const glm::mat4 LocalMatrix = CalculateLocalMatrix();
+        return Parent ? Parent->CalculateModelMatrix() * LocalMatrix : LocalMatrix;
+    }
+
+    void IActor::MarkTransformDirty()
+    {
+        if (World && TransformNodeIdx != INVALID_TRANSFORM_NODE)
+        {
+            World->GetTransformHierarchy().MarkDirty(this);
+        }
+    }
+
+    void IActor::OnParentChanged()
+    {
+        if (World && TransformNodeIdx != INVALID_TRANSFORM_NODE)
+        {
+            World->GetTransformHierarchy().OnParentChanged();
+            World->GetTransformHierarchy().MarkDirty(this);
+        }
+    }
+
     void IActor::OnScaled(const glm::vec3& InOldScale, const glm::vec3& InNewScale) { }
 
     void IActor::OnTranslated(const glm::vec3& InOldPostion, const glm::vec3& InNewPosition) {}
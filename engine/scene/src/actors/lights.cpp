@@ -12,35 +12,20 @@
 
 namespace lucid::scene
 {
-    static const FSString LIGHT_TYPE("uLightType");
+    static const gpu::FUniformHandle LIGHT_POSITION = gpu::CShader::GetUniformHandle("uLightPosition");
 
-    static const FSString LIGHT_POSITION{ "uLightPosition" };
-    static const FSString LIGHT_COLOR{ "uLightColor" };
+    static const gpu::FUniformHandle LIGHT_SPACE_MATRIX = gpu::CShader::GetUniformHandle("uLightMatrix");
 
-    static const FSString LIGHT_SPACE_MATRIX("uLightMatrix");
+    static const gpu::FUniformHandle LIGHT_FAR_PLANE = gpu::CShader::GetUniformHandle("uLightFarPlane");
 
-    static const FSString LIGHT_NEAR_PLANE{ "uLightNearPlane" };
-    static const FSString LIGHT_FAR_PLANE{ "uLightFarPlane" };
+    static const gpu::FUniformHandle LIGHT_SPACE_MATRIX_0 = gpu::CShader::GetUniformHandle("uLightMatrices[0]");
+    static const gpu::FUniformHandle LIGHT_SPACE_MATRIX_1 = gpu::CShader::GetUniformHandle("uLightMatrices[1]");
+    static const gpu::FUniformHandle LIGHT_SPACE_MATRIX_2 = gpu::CShader::GetUniformHandle("uLightMatrices[2]");
+    static const gpu::FUniformHandle LIGHT_SPACE_MATRIX_3 = gpu::CShader::GetUniformHandle("uLightMatrices[3]");
+    static const gpu::FUniformHandle LIGHT_SPACE_MATRIX_4 = gpu::CShader::GetUniformHandle("uLightMatrices[4]");
+    static const gpu::FUniformHandle LIGHT_SPACE_MATRIX_5 = gpu::CShader::GetUniformHandle("uLightMatrices[5]");
 
-    static const FSString LIGHT_SPACE_MATRIX_0{ "uLightMatrices[0]" };
-    static const FSString LIGHT_SPACE_MATRIX_1{ "uLightMatrices[1]" };
-    static const FSString LIGHT_SPACE_MATRIX_2{ "uLightMatrices[2]" };
-    static const FSString LIGHT_SPACE_MATRIX_3{ "uLightMatrices[3]" };
-    static const FSString LIGHT_SPACE_MATRIX_4{ "uLightMatrices[4]" };
-    static const FSString LIGHT_SPACE_MATRIX_5{ "uLightMatrices[5]" };
-
-    static const FSString LIGHT_DIRECTION("uLightDirection");
-    static const FSString ATTENUATION_RADIUS("uLightAttenuationRadius");
-    static const FSString INV_ATTENUATION_RADIUS_SQUARED("uLightInvAttenuationRadiusSquared");
-
-    static const FSString LIGHT_INNER_CUT_OFF("uLightInnerCutOffCos");
-    static const FSString LIGHT_OUTER_CUT_OFF("uLightOuterCutOffCos");
-    static const FSString LIGHT_SHADOW_MAP("uLightShadowMap");
-    static const FSString LIGHT_CASTS_SHADOWS("uLightCastsShadows");
-    static const FSString LIGHT_SHADOW_CUBE("uLightShadowCube");
-    static const FSString LIGHT_INTENSITY("uLightIntensity");
-
-    static const FSString CASCADE_COUNT("uCascadeCount");
+    static const gpu::FUniformHandle LIGHT_DIRECTION = gpu::CShader::GetUniformHandle("uLightDirection");
 
     static const float LightEfficiencyByLightSourceType[]{
         3.5f, // Incandescent
@@ -48,11 +33,10 @@ namespace lucid::scene
         12.5f // Fluorescent
     };
 
-    void SetupLightIntensityBasedOnUnit(const ELightSourceType& LightSourceType,
-                                        const ELightUnit&       LightUnit,
-                                        const float&            LuminousPower,
-                                        const float&            RadiantPower,
-                                        gpu::CShader*           Shader)
+    float CalculateLightIntensityBasedOnUnit(const ELightSourceType& LightSourceType,
+                                             const ELightUnit&       LightUnit,
+                                             const float&            LuminousPower,
+                                             const float&            RadiantPower)
     {
         float LightIntensity = 0;
         switch (LightUnit)
@@ -68,7 +52,15 @@ namespace lucid::scene
             assert(0);
         }
 
-        Shader->SetFloat(LIGHT_INTENSITY, LightIntensity);
+        return LightIntensity;
+    }
+
+    static void SetupShadowAtlasTiles(const CShadowMap* InShadowMap, FLightData& OutLightData)
+    {
+        for (u8 i = 0; i < InShadowMap->GetNumTiles(); ++i)
+        {
+            OutLightData.ShadowAtlasTiles[i] = CShadowAtlas::PackTile(InShadowMap->GetTile(i));
+        }
     }
 
 #if DEVELOPMENT
@@ -117,11 +109,13 @@ namespace lucid::scene
     }
 #endif
 
-    void CLight::SetupShader(gpu::CShader* InShader) const
+    void CLight::SetupLightData(FLightData& OutLightData) const
     {
-        InShader->SetInt(LIGHT_TYPE, static_cast<u32>(GetType()));
-        InShader->SetVector(LIGHT_POSITION, GetTransform().Translation);
-        InShader->SetVector(LIGHT_COLOR, Color);
+        OutLightData             = FLightData{};
+        OutLightData.Type        = static_cast<i32>(GetType());
+        OutLightData.Position    = GetTransform().Translation;
+        OutLightData.Color       = Color;
+        OutLightData.CascadesIdx = -1;
     }
 
 #if DEVELOPMENT
@@ -207,43 +201,23 @@ namespace lucid::scene
         // noop, dir lights are using CSMs
     }
 
-    void CDirectionalLight::SetupShader(gpu::CShader* InShader) const
+    void CDirectionalLight::SetupLightData(FLightData& OutLightData) const
     {
-        CLight::SetupShader(InShader);
-
-        InShader->SetVector(LIGHT_DIRECTION, Direction);
-        InShader->SetFloat(LIGHT_INTENSITY, Illuminance);
-
-        if (bCastsShadow)
-        {
-            InShader->SetBool(LIGHT_CASTS_SHADOWS, true);
-            InShader->SetInt(CASCADE_COUNT, CascadeCount);
-
-            for (int i = 0; i < CascadeCount; ++i)
-            {
-                std::ostringstream UniformParamName;
-                UniformParamName << "uCascadeMatrices[" << i << "]";
+        CLight::SetupLightData(OutLightData);
 
-                const std::string CascadeMatrixName = UniformParamName.str();
-
-                UniformParamName.str("");
-                UniformParamName << "uCascadeFarPlanes[" << i << "]";
-
-                const std::string CascadeFarPlaneName = UniformParamName.str();
-
-                UniformParamName.str("");
-                UniformParamName << "uCascadeShadowMaps[" << i << "]";
-
-                const std::string CascadeShadowMapName = UniformParamName.str();
+        OutLightData.Direction     = Direction;
+        OutLightData.Intensity     = Illuminance;
+        OutLightData.bCastsShadows = bCastsShadow;
+    }
 
-                InShader->SetMatrix((char*)CascadeMatrixName.c_str(), CascadeMatrices[i]);
-                InShader->SetFloat((char*)CascadeFarPlaneName.c_str(), CascadeFarPlanes[i]);
-                InShader->UseBindlessTexture((char*)CascadeShadowMapName.c_str(), CascadeShadowMaps[i]->GetShadowMapTexture()->GetBindlessHandle());
-            }
-        }
-        else
+    void CDirectionalLight::SetupCascadesData(FLightCascadesData& OutCascadesData) const
+    {
+        OutCascadesData.Count = CascadeCount;
+        for (u8 i = 0; i < CascadeCount; ++i)
         {
-            InShader->SetBool(LIGHT_CASTS_SHADOWS, false);
+            OutCascadesData.Matrices[i]                 = CascadeMatrices[i];
+            OutCascadesData.FarPlanes[i]                = CascadeFarPlanes[i];
+            OutCascadesData.ShadowMapBindlessHandles[i] = CascadeShadowMaps[i]->GetShadowMapTexture()->GetBindlessHandle();
         }
     }
 
@@ -270,8 +244,6 @@ namespace lucid::scene
                 while (NewCascadeCount > CascadeCount)
                 {
                     CascadeShadowMaps[CascadeCount] = GEngine.GetRenderer()->CreateShadowMap(ELightType::DIRECTIONAL);
-                    CascadeShadowMaps[CascadeCount]->GetShadowMapTexture()->GetBindlessHandle();
-                    CascadeShadowMaps[CascadeCount]->GetShadowMapTexture()->MakeBindlessResident();
                     ++CascadeCount;
                 }
                 
@@ -352,34 +324,28 @@ namespace lucid::scene
 
     void CSpotLight::UpdateLightSpaceMatrix(const LightSettings& LightSettings)
     {
-        const float ShadowMapWidth  = (float)ShadowMap->GetShadowMapTexture()->GetWidth();
-        const float ShadowMapHeight = (float)ShadowMap->GetShadowMapTexture()->GetHeight();
-
+        // Tiles in the shadow atlas are square
         const glm::mat4 ViewMatrix       = glm::lookAt(GetTransform().Translation, GetTransform().Translation + Direction, LightUp);
-        const glm::mat4 ProjectionMatrix = glm::perspective(OuterCutOffRad * 2, ShadowMapWidth / ShadowMapHeight, LightSettings.Near, LightSettings.Far);
+        const glm::mat4 ProjectionMatrix = glm::perspective(OuterCutOffRad * 2, 1.f, LightSettings.Near, LightSettings.Far);
         LightSpaceMatrix                 = ProjectionMatrix * ViewMatrix;
     }
 
-    void CSpotLight::SetupShader(gpu::CShader* InShader) const
+    void CSpotLight::SetupLightData(FLightData& OutLightData) const
     {
-        CLight::SetupShader(InShader);
-        InShader->SetVector(LIGHT_DIRECTION, Direction);
-        InShader->SetFloat(ATTENUATION_RADIUS, AttenuationRadius);
-        InShader->SetFloat(INV_ATTENUATION_RADIUS_SQUARED, powf(1.f / AttenuationRadius, 2.f));
-        InShader->SetFloat(LIGHT_INNER_CUT_OFF, glm::cos(InnerCutOffRad));
-        InShader->SetFloat(LIGHT_OUTER_CUT_OFF, glm::cos(OuterCutOffRad));
-        InShader->SetMatrix(LIGHT_SPACE_MATRIX, LightSpaceMatrix);
+        CLight::SetupLightData(OutLightData);
 
-        SetupLightIntensityBasedOnUnit(LightSourceType, LightUnit, LuminousPower, RadiantPower, InShader);
+        OutLightData.Direction                   = Direction;
+        OutLightData.AttenuationRadius           = AttenuationRadius;
+        OutLightData.InvAttenuationRadiusSquared = powf(1.f / AttenuationRadius, 2.f);
+        OutLightData.InnerCutOffCos              = glm::cos(InnerCutOffRad);
+        OutLightData.OuterCutOffCos              = glm::cos(OuterCutOffRad);
+        OutLightData.LightMatrix                 = LightSpaceMatrix;
+        OutLightData.Intensity                   = CalculateLightIntensityBasedOnUnit(LightSourceType, LightUnit, LuminousPower, RadiantPower);
 
-        if (ShadowMap)
-        {
-            InShader->SetBool(LIGHT_CASTS_SHADOWS, true);
-            InShader->UseTexture(LIGHT_SHADOW_MAP, ShadowMap->GetShadowMapTexture());
-        }
-        else
+        if (ShadowMap && ShadowMap->bTilesRendered)
         {
-            InShader->SetBool(LIGHT_CASTS_SHADOWS, false);
+            OutLightData.bCastsShadows = true;
+            SetupShadowAtlasTiles(ShadowMap, OutLightData);
         }
     }
 
@@ -458,11 +424,7 @@ namespace lucid::scene
         Copy->SetTransform(GetTransform());
         Copy->Translate({ 1, 0, 0 });
 
-        if (ShadowMap)
-        {
-            ShadowMap = GEngine.GetRenderer()->CreateShadowMap(ELightType::SPOT);
-        }
-
+        // The copy gets it's own shadow map when it's added to the world
         World->AddSpotLight(Copy);
         return Copy;
     }
@@ -472,7 +434,7 @@ namespace lucid::scene
         CLight::OnAddToWorld(InWorld);
         if (bCastsShadow && !ShadowMap)
         {
-            ShadowMap = GEngine.GetRenderer()->CreateShadowMap(ELightType::DIRECTIONAL);
+            ShadowMap = GEngine.GetRenderer()->CreateShadowMap(ELightType::SPOT);
         }
     }
 
@@ -500,13 +462,11 @@ namespace lucid::scene
 
     void CPointLight::UpdateLightSpaceMatrix(const LightSettings& LightSettings)
     {
-        const float ShadowMapWidth  = (float)ShadowMap->GetShadowMapTexture()->GetWidth();
-        const float ShadowMapHeight = (float)ShadowMap->GetShadowMapTexture()->GetHeight();
-
         CachedNearPlane = LightSettings.Near;
         CachedFarPlane  = LightSettings.Far;
 
-        const glm::mat4 projectionMatrix = glm::perspective(glm::radians(90.f), ShadowMapWidth / ShadowMapHeight, CachedNearPlane, CachedFarPlane);
+        // Each of the cube faces is a square tile in the cube shadow atlas
+        const glm::mat4 projectionMatrix = glm::perspective(glm::radians(90.f), 1.f, CachedNearPlane, CachedFarPlane);
 
         LightSpaceMatrices[0] =
           projectionMatrix * glm::lookAt(GetTransform().Translation, GetTransform().Translation + glm::vec3{ 1.0, 0.0, 0.0 }, glm::vec3{ 0.0, -1.0, 0.0 });
@@ -522,31 +482,20 @@ namespace lucid::scene
           projectionMatrix * glm::lookAt(GetTransform().Translation, GetTransform().Translation + glm::vec3{ 0.0, 0.0, -1.0 }, glm::vec3{ 0.0, -1.0, 0.0 });
     }
 
-    void CPointLight::SetupShader(gpu::CShader* InShader) const
+    void CPointLight::SetupLightData(FLightData& OutLightData) const
     {
-        CLight::SetupShader(InShader);
-        InShader->SetFloat(ATTENUATION_RADIUS, AttenuationRadius);
-        InShader->SetFloat(INV_ATTENUATION_RADIUS_SQUARED, powf(1.f / AttenuationRadius, 2.f));
-        InShader->SetFloat(LIGHT_NEAR_PLANE, CachedNearPlane);
-        InShader->SetFloat(LIGHT_FAR_PLANE, CachedFarPlane);
-        InShader->SetMatrix(LIGHT_SPACE_MATRIX_0, LightSpaceMatrices[0]);
-        InShader->SetMatrix(LIGHT_SPACE_MATRIX_1, LightSpaceMatrices[1]);
-        InShader->SetMatrix(LIGHT_SPACE_MATRIX_2, LightSpaceMatrices[2]);
-        InShader->SetMatrix(LIGHT_SPACE_MATRIX_3, LightSpaceMatrices[3]);
-        InShader->SetMatrix(LIGHT_SPACE_MATRIX_4, LightSpaceMatrices[4]);
-        InShader->SetMatrix(LIGHT_SPACE_MATRIX_5, LightSpaceMatrices[5]);
+        CLight::SetupLightData(OutLightData);
 
-        if (ShadowMap)
-        {
-            InShader->SetBool(LIGHT_CASTS_SHADOWS, true);
-            InShader->UseTexture(LIGHT_SHADOW_CUBE, ShadowMap->GetShadowMapTexture());
-        }
-        else
+        OutLightData.AttenuationRadius           = AttenuationRadius;
+        OutLightData.InvAttenuationRadiusSquared = powf(1.f / AttenuationRadius, 2.f);
+        OutLightData.FarPlane                    = CachedFarPlane;
+        OutLightData.Intensity                   = CalculateLightIntensityBasedOnUnit(LightSourceType, LightUnit, LuminousPower, RadiantPower);
+
+        if (ShadowMap && ShadowMap->bTilesRendered)
         {
-            InShader->SetBool(LIGHT_CASTS_SHADOWS, false);
+            OutLightData.bCastsShadows = true;
+            SetupShadowAtlasTiles(ShadowMap, OutLightData);
         }
-
-        SetupLightIntensityBasedOnUnit(LightSourceType, LightUnit, LuminousPower, RadiantPower, InShader);
     }
 
     void CPointLight::SetupShadowMapShader(gpu::CShader* InShader)
@@ -594,11 +543,7 @@ namespace lucid::scene
         Copy->SetTransform(GetTransform());
         Copy->Translate({ 1, 0, 0 });
 
-        if (ShadowMap)
-        {
-            ShadowMap = GEngine.GetRenderer()->CreateShadowMap(ELightType::POINT);
-        }
-
+        // The copy gets it's own shadow map when it's added to the world
         World->AddPointLight(Copy);
         return Copy;
     }
@@ -608,7 +553,7 @@ namespace lucid::scene
         CLight::OnAddToWorld(InWorld);
         if (bCastsShadow && !ShadowMap)
         {
-            ShadowMap = GEngine.GetRenderer()->CreateShadowMap(ELightType::DIRECTIONAL);
+            ShadowMap = GEngine.GetRenderer()->CreateShadowMap(ELightType::POINT);
         }
     }
 
@@ -5,6 +5,7 @@
 
 #include "scene/material.hpp"
 #include "scene/world.hpp"
+#include "scene/renderer.hpp"
 
 #include "engine/engine.hpp"
 #include "schemas/json.hpp"
@@ -41,6 +42,7 @@ namespace lucid::scene
                     NewBaseMeshAsset = NewStaticMesh;
 
                     AABB = NewStaticMesh->AABB;
+                    UpdateAABB();
                 }
 
                 GEngine.AddActorWithDirtyResources(this);
@@ -50,7 +52,10 @@ namespace lucid::scene
         if (ImGui::CollapsingHeader("Static mesh"))
         {
             // Handle actor instance details
-            ImGui::Checkbox("Reverse normals:", &bReverseNormals);
+            if (ImGui::Checkbox("Reverse normals:", &bReverseNormals))
+            {
+                GEngine.GetRenderer()->MarkActorDirty(this);
+            }
 
             if (BaseStaticMesh)
             {
@@ -136,7 +141,7 @@ namespace lucid::scene
             for (u16 i = 0; i < MaterialSlots.GetLength(); ++i)
             {
                 CMaterial* Material                = *MaterialSlots[i];
-                FDString   MaterialSlotEditorLabel = SPrintf("static_mesh_material_%d", i);
+                FSString   MaterialSlotEditorLabel = FrameSPrintf("static_mesh_material_%d", i);
                 if (ImGui::TreeNode(*MaterialSlotEditorLabel, "Material slot %d: %s", i, Material ? *Material->GetName() : "-- None --"))
                 {
                     if (ImGui::Button("Edit"))
@@ -168,8 +173,6 @@ namespace lucid::scene
 
                     ImGui::TreePop();
                 }
-
-                MaterialSlotEditorLabel.Free();
             }
 
             if (CurrentlyEditedMaterial)
@@ -338,7 +341,7 @@ namespace lucid::scene
             LoadedActorMeshResource = MeshResource;
         }
 
-        LoadedActorMeshResource->Acquire(false, true);
+        LoadedActorMeshResource->AcquireAsync(false, true);
 
         FTransform3D Transform;
         Transform.Translation = Float3ToVec(StaticMeshDescription->Postion);
@@ -504,7 +507,7 @@ namespace lucid::scene
 
         if (MeshResource)
         {
-            MeshResource->Acquire(false, true);
+            MeshResource->AcquireAsync(false, true);
             for (u32 i = 0; i < MaterialSlots.GetLength(); ++i)
             {
                 GetMaterialSlot(i)->LoadResources();
@@ -566,7 +569,7 @@ namespace lucid::scene
         SpawnedMesh->BaseActorAsset = this;
         SpawnedMesh->BaseStaticMesh = this;
         SpawnedMesh->MeshResource   = MeshResource;
-        SpawnedMesh->MeshResource->Acquire(false, true);
+        SpawnedMesh->MeshResource->AcquireAsync(false, true);
 
         InWorld->AddStaticMesh(SpawnedMesh);
 
@@ -592,7 +595,7 @@ namespace lucid::scene
         SpawnedMesh->BaseActorAsset = BaseActorAsset;
         SpawnedMesh->BaseStaticMesh = BaseStaticMesh;
 
-        SpawnedMesh->MeshResource->Acquire(false, true);
+        SpawnedMesh->MeshResource->AcquireAsync(false, true);
         SpawnedMesh->SetTransform(GetTransform());
         SpawnedMesh->Translate({ 1, 0, 0 });
 
@@ -652,7 +655,7 @@ namespace lucid::scene
 
         if (NewMeshResource)
         {
-            NewMeshResource->Acquire(false, true);
+            NewMeshResource->AcquireAsync(false, true);
             NewMeshResource = nullptr;
         }
 
@@ -2,14 +2,18 @@
 #include "scene/world.hpp"
 #include "scene/terrain_material.hpp"
 #include "scene/renderer.hpp"
+#include "scene/camera.hpp"
 
 #include "engine/engine.hpp"
 
+#include "common/jobs.hpp"
+#include "misc/noise.hpp"
+#include "platform/util.hpp"
+
 #include "schemas/json.hpp"
 
 #include "devices/gpu/vao.hpp"
 #include "devices/gpu/buffer.hpp"
-#include "devices/gpu/fence.hpp"
 
 #include "resources/mesh_resource.hpp"
 #include "resources/serialization_versions.hpp"
@@ -19,6 +23,7 @@
 #include "lucid_editor/imgui_lucid.h"
 
 #include <random>
+#include <utility>
 #include <glm/common.hpp>
 #include <lucid_editor/editor.hpp>
 
@@ -27,9 +32,6 @@
 
 namespace lucid::scene
 {
-    static constexpr gpu::EBufferMapPolicy UNSYNCHRONIZED_WRITE =
-      (gpu::EBufferMapPolicy)(gpu::EBufferMapPolicy::BUFFER_WRITE | gpu::EBufferMapPolicy::BUFFER_UNSYNCHRONIZED);
-
     CTerrain::CTerrain(const FDString&           InName,
                        IActor*                   InParent,
                        CWorld*                   InWorld,
@@ -62,133 +64,292 @@ namespace lucid::scene
         OutDescription.TerrainMaterialId     = TerrainMaterial ? TerrainMaterial->GetID() : sole::INVALID_UUID;
     }
 
-    static lucid::resources::CMeshResource* GenerateTerrainMesh(const FTerrainSettings& TerrainSettings)
+    /** Rows of the terrain's vertices processed by a single job when generating the terrain and calculating it's normals */
+    static constexpr u32 TERRAIN_ROWS_PER_JOB = 16;
+
+    /**
+     * Calculates the normals of the vertices in [InMin, InMax] from the central differences of the heights of their neighbours,
+     * one-sided at the borders. Each vertex only reads the positions of it's neighbours, so the rows are processed in parallel.
+     */
+    static void CalculateTerrainNormals(FTerrainVertex*   InOutVertices,
+                                        const glm::vec2&  InResolution,
+                                        const glm::vec2&  InCellSize,
+                                        const glm::uvec2& InMin,
+                                        const glm::uvec2& InMax)
     {
-        const u32 VertexCount  = (TerrainSettings.Resolution.x + 1) * (TerrainSettings.Resolution.y + 1);
-        const u32 IndicesCount = TerrainSettings.Resolution.x * TerrainSettings.Resolution.y * 6;
+        const u32 NumVerticesX = InResolution.x + 1;
+        const u32 NumVerticesZ = InResolution.y + 1;
 
-        const u32 TerrainVertexDataSize  = VertexCount * sizeof(FTerrainVertex);
-        const u32 TerrainIndicesDataSize = IndicesCount * sizeof(u32);
+        GEngine.GetJobSystem().ParallelFor(InMax.y - InMin.y + 1, TERRAIN_ROWS_PER_JOB, [&](const u32& InFirstRow, const u32& InEndRow) {
+            for (u32 z = InMin.y + InFirstRow; z < InMin.y + InEndRow; ++z)
+            {
+                const u32 PrevZ = z > 0 ? z - 1 : z;
+                const u32 NextZ = z < NumVerticesZ - 1 ? z + 1 : z;
 
-        FMemBuffer VertexDataBuffer  = CreateMemBuffer(TerrainVertexDataSize);
-        FMemBuffer IndicesDataBuffer = CreateMemBuffer(TerrainIndicesDataSize);
+                for (u32 x = InMin.x; x <= InMax.x; ++x)
+                {
+                    const u32 PrevX = x > 0 ? x - 1 : x;
+                    const u32 NextX = x < NumVerticesX - 1 ? x + 1 : x;
 
-        FTerrainVertex* VertexData  = (FTerrainVertex*)VertexDataBuffer.Pointer;
-        u32*            IndicesData = (u32*)IndicesDataBuffer.Pointer;
+                    const float HeightPrevX = InOutVertices[(z * NumVerticesX) + PrevX].Position.y;
+                    const float HeightNextX = InOutVertices[(z * NumVerticesX) + NextX].Position.y;
+                    const float HeightPrevZ = InOutVertices[(PrevZ * NumVerticesX) + x].Position.y;
+                    const float HeightNextZ = InOutVertices[(NextZ * NumVerticesX) + x].Position.y;
 
-        const glm::vec3 UpperLeft = { -TerrainSettings.GridSize.x / 2, 0, -TerrainSettings.GridSize.y / 2 };
+                    const float SlopeX = (HeightNextX - HeightPrevX) / ((NextX - PrevX) * InCellSize.x);
+                    const float SlopeZ = (HeightNextZ - HeightPrevZ) / ((NextZ - PrevZ) * InCellSize.y);
 
-        const glm::vec2 CellSize = TerrainSettings.GridSize / TerrainSettings.Resolution;
-        const glm::vec2 UVStep   = { 1.f / TerrainSettings.Resolution.x, 1 / TerrainSettings.Resolution.y };
+                    InOutVertices[(z * NumVerticesX) + x].Normal = glm::normalize(glm::vec3{ -SlopeX, 1, -SlopeZ });
+                }
+            }
+        });
+    }
 
-        std::function<float(u32, u32)> HeightFunc = [](const u32& X, const u32& Z) -> float { return 0; };
+    /**
+     * Generates the vertices and indices of the terrain. Rows of vertices are generated in parallel, the heights of
+     * a row are evaluated by the SIMD fractal noise kernel. Returns the terrain's height range in OutMinHeight/OutMaxHeight.
+     */
+    static void GenerateTerrainGeometry(const FTerrainSettings& TerrainSettings,
+                                        const float&            InNoiseOffsetX,
+                                        const float&            InNoiseOffsetZ,
+                                        FTerrainVertex*         OutVertexData,
+                                        u32*                    OutIndicesData,
+                                        float&                  OutMinHeight,
+                                        float&                  OutMaxHeight)
+    {
+        const u32 NumVerticesX = TerrainSettings.Resolution.x + 1;
+        const u32 NumVerticesZ = TerrainSettings.Resolution.y + 1;
 
-        if (!TerrainSettings.bFlatMesh)
-        {
-            static std::default_random_engine RandomEngine{ std::mt19937(TerrainSettings.Seed == -1 ? math::RandomFloat() * UINT32_MAX :
-                                                                                                      TerrainSettings.Seed) };
+        const glm::vec3 UpperLeft = { -TerrainSettings.GridSize.x / 2, 0, -TerrainSettings.GridSize.y / 2 };
+        const glm::vec2 CellSize  = TerrainSettings.GridSize / TerrainSettings.Resolution;
+        const glm::vec2 UVStep    = { 1.f / TerrainSettings.Resolution.x, 1 / TerrainSettings.Resolution.y };
 
-            static std::uniform_real_distribution<float> dis(0, 100000.0f);
+        math::FFractalNoiseSettings NoiseSettings;
+        NoiseSettings.Octaves     = TerrainSettings.Octaves > 0 ? TerrainSettings.Octaves : 0;
+        NoiseSettings.Frequency   = TerrainSettings.Frequency;
+        NoiseSettings.Amplitude   = TerrainSettings.Amplitude;
+        NoiseSettings.Lacunarity  = TerrainSettings.Lacunarity;
+        NoiseSettings.Persistence = TerrainSettings.Persistence;
 
-            const auto SimplexGenerator =
-              SimplexNoise{ TerrainSettings.Frequency, TerrainSettings.Amplitude, TerrainSettings.Lacunarity, TerrainSettings.Persistence };
+        // Each job tracks the height range of it's rows
+        const u32          NumJobs = (NumVerticesZ + TERRAIN_ROWS_PER_JOB - 1) / TERRAIN_ROWS_PER_JOB;
+        std::vector<float> MinHeights(NumJobs, FLT_MAX);
+        std::vector<float> MaxHeights(NumJobs, -FLT_MAX);
 
-            const float OffsetX = dis(RandomEngine);
-            const float OffsetZ = dis(RandomEngine);
+        // Generate vertex data
+        GEngine.GetJobSystem().ParallelFor(NumVerticesZ, TERRAIN_ROWS_PER_JOB, [&](const u32& InFirstRow, const u32& InEndRow) {
+            const u32          JobIndex = InFirstRow / TERRAIN_ROWS_PER_JOB;
+            std::vector<float> Noise(NumVerticesX, 0.f);
 
-            HeightFunc = [&SimplexGenerator, &TerrainSettings, OffsetX, OffsetZ](const u32& X, const u32& Z) -> float {
-                const float f = SimplexGenerator.fractal(TerrainSettings.Octaves, X + OffsetX, Z + OffsetZ);
+            for (u32 z = InFirstRow; z < InEndRow; ++z)
+            {
+                if (!TerrainSettings.bFlatMesh)
+                {
+                    math::FractalNoise2DRow(NoiseSettings, InNoiseOffsetX, z + InNoiseOffsetZ, NumVerticesX, Noise.data());
+                }
 
-                return math::Remap(f, -1, 1, TerrainSettings.MinHeight, TerrainSettings.MaxHeight);
-            };
-        }
+                FTerrainVertex* RowVertexData = OutVertexData + (z * NumVerticesX);
+                for (u32 x = 0; x < NumVerticesX; ++x)
+                {
+                    const float Height = TerrainSettings.bFlatMesh ? 0 : math::Remap(Noise[x], -1, 1, TerrainSettings.MinHeight, TerrainSettings.MaxHeight);
 
-        math::FAABB TerrainAABB;
-        TerrainAABB.MinY = FLT_MAX;
-        TerrainAABB.MaxY = 0;
+                    RowVertexData[x].Position      = UpperLeft + glm::vec3{ x * CellSize.x, Height, z * CellSize.y };
+                    RowVertexData[x].TextureCoords = { x * UVStep.x, z * UVStep.y };
 
-        // Generate vertex data
-        for (u32 z = 0; z < TerrainSettings.Resolution.y + 1; ++z)
-        {
-            for (u32 x = 0; x < TerrainSettings.Resolution.x + 1; ++x)
-            {
-                // Vertex data
-                VertexData->Position = UpperLeft;
-                VertexData->Position += glm::vec3{ x * CellSize.x, 0, z * CellSize.y };
+                    MinHeights[JobIndex] = glm::min(MinHeights[JobIndex], Height);
+                    MaxHeights[JobIndex] = glm::max(MaxHeights[JobIndex], Height);
+                }
+            }
+        });
 
-                VertexData->Position.y = HeightFunc(x, z);
+        // Generate indices, each row of cells writes it's own range
+        GEngine.GetJobSystem().ParallelFor(NumVerticesZ - 1, TERRAIN_ROWS_PER_JOB, [&](const u32& InFirstRow, const u32& InEndRow) {
+            u32* IndicesData = OutIndicesData + (InFirstRow * (NumVerticesX - 1) * 6);
 
-                if (VertexData->Position.y < TerrainAABB.MinY)
+            for (u32 z = InFirstRow; z < InEndRow; ++z)
+            {
+                for (u32 x = 0; x < NumVerticesX - 1; ++x)
                 {
-                    TerrainAABB.MinY = VertexData->Position.y;
-                }
+                    // First triangle
+                    IndicesData[0] = (z * NumVerticesX) + x + 1;
+                    IndicesData[1] = (z * NumVerticesX) + x;
+                    IndicesData[2] = ((z + 1) * NumVerticesX) + x;
 
-                if (VertexData->Position.y > TerrainAABB.MaxY)
-                {
-                    TerrainAABB.MaxY = VertexData->Position.y;
+                    // Second triangle
+                    IndicesData[3] = ((z + 1) * NumVerticesX) + x;
+                    IndicesData[4] = ((z + 1) * NumVerticesX) + x + 1;
+                    IndicesData[5] = (z * NumVerticesX) + x + 1;
+
+                    IndicesData += 6;
                 }
+            }
+        });
 
-                VertexData->Normal = glm::vec3{ 0 };
-                VertexData->TextureCoords += glm::vec2{ x * UVStep.x, z * UVStep.y };
+        CalculateTerrainNormals(OutVertexData, TerrainSettings.Resolution, CellSize, { 0, 0 }, { NumVerticesX - 1, NumVerticesZ - 1 });
 
-                VertexData += 1;
-            }
+        OutMinHeight = FLT_MAX;
+        OutMaxHeight = -FLT_MAX;
+        for (u32 i = 0; i < NumJobs; ++i)
+        {
+            OutMinHeight = glm::min(OutMinHeight, MinHeights[i]);
+            OutMaxHeight = glm::max(OutMaxHeight, MaxHeights[i]);
         }
+    }
 
-        // Reset the pointer so we can index when generating normals
-        VertexData = (FTerrainVertex*)VertexDataBuffer.Pointer;
+#if DEVELOPMENT
+    /**
+     * The single-threaded generation that GenerateTerrainGeometry() replaced - noise is evaluated per vertex by SimplexNoise and
+     * the normals are accumulated from the faces. Kept only to benchmark the two against each other.
+     */
+    static void GenerateTerrainGeometryReference(const FTerrainSettings& TerrainSettings,
+                                                 const float&            InNoiseOffsetX,
+                                                 const float&            InNoiseOffsetZ,
+                                                 FTerrainVertex*         OutVertexData,
+                                                 u32*                    OutIndicesData)
+    {
+        const glm::vec3 UpperLeft = { -TerrainSettings.GridSize.x / 2, 0, -TerrainSettings.GridSize.y / 2 };
+        const glm::vec2 CellSize  = TerrainSettings.GridSize / TerrainSettings.Resolution;
+        const glm::vec2 UVStep    = { 1.f / TerrainSettings.Resolution.x, 1 / TerrainSettings.Resolution.y };
 
-        const auto StoreIndicesAndUpdateNormals = [VertexData, &IndicesData](const u32& FaceVert0, const u32& FaceVert1, const u32& FaceVert2) -> void {
-            *IndicesData = FaceVert0;
-            IndicesData += 1;
+        std::function<float(u32, u32)> HeightFunc = [](const u32& X, const u32& Z) -> float { return 0; };
 
-            *IndicesData = FaceVert1;
-            IndicesData += 1;
+        const auto SimplexGenerator =
+          SimplexNoise{ TerrainSettings.Frequency, TerrainSettings.Amplitude, TerrainSettings.Lacunarity, TerrainSettings.Persistence };
 
-            *IndicesData = FaceVert2;
-            IndicesData += 1;
+        if (!TerrainSettings.bFlatMesh)
+        {
+            HeightFunc = [&SimplexGenerator, &TerrainSettings, InNoiseOffsetX, InNoiseOffsetZ](const u32& X, const u32& Z) -> float {
+                const float f = SimplexGenerator.fractal(TerrainSettings.Octaves, X + InNoiseOffsetX, Z + InNoiseOffsetZ);
+                return math::Remap(f, -1, 1, TerrainSettings.MinHeight, TerrainSettings.MaxHeight);
+            };
+        }
+
+        FTerrainVertex* VertexData = OutVertexData;
+        for (u32 z = 0; z < TerrainSettings.Resolution.y + 1; ++z)
+        {
+            for (u32 x = 0; x < TerrainSettings.Resolution.x + 1; ++x)
+            {
+                VertexData->Position      = UpperLeft + glm::vec3{ x * CellSize.x, HeightFunc(x, z), z * CellSize.y };
+                VertexData->Normal        = glm::vec3{ 0 };
+                VertexData->TextureCoords = { x * UVStep.x, z * UVStep.y };
+                VertexData += 1;
+            }
+        }
+
+        VertexData       = OutVertexData;
+        u32* IndicesData = OutIndicesData;
 
-            // Normals
-            const glm::vec3 Edge0 = VertexData[FaceVert0].Position - VertexData[FaceVert1].Position;
-            const glm::vec3 Edge1 = VertexData[FaceVert1].Position - VertexData[FaceVert2].Position;
+        const auto StoreIndicesAndUpdateNormals = [VertexData, &IndicesData](const u32& FaceVert0, const u32& FaceVert1, const u32& FaceVert2) -> void {
+            IndicesData[0] = FaceVert0;
+            IndicesData[1] = FaceVert1;
+            IndicesData[2] = FaceVert2;
+            IndicesData += 3;
 
-            const glm::vec3 Normal = glm::cross(Edge0, Edge1);
+            const glm::vec3 Normal = glm::cross(VertexData[FaceVert0].Position - VertexData[FaceVert1].Position,
+                                                VertexData[FaceVert1].Position - VertexData[FaceVert2].Position);
 
             VertexData[FaceVert0].Normal += Normal;
             VertexData[FaceVert1].Normal += Normal;
             VertexData[FaceVert2].Normal += Normal;
         };
 
-        // Generate indices, calculate normals
         for (u32 z = 0; z < TerrainSettings.Resolution.y; ++z)
         {
             for (u32 x = 0; x < TerrainSettings.Resolution.x; ++x)
             {
-                // First triangle
-                {
-                    const u32 FaceVert0 = (z * (TerrainSettings.Resolution.x + 1)) + x + 1;
-                    const u32 FaceVert1 = (z * (TerrainSettings.Resolution.x + 1)) + x;
-                    const u32 FaceVert2 = ((z + 1) * (TerrainSettings.Resolution.x + 1)) + x;
+                StoreIndicesAndUpdateNormals((z * (TerrainSettings.Resolution.x + 1)) + x + 1,
+                                             (z * (TerrainSettings.Resolution.x + 1)) + x,
+                                             ((z + 1) * (TerrainSettings.Resolution.x + 1)) + x);
 
-                    StoreIndicesAndUpdateNormals(FaceVert0, FaceVert1, FaceVert2);
-                }
-
-                // Second triangle
-                {
-                    const u32 FaceVert0 = ((z + 1) * (TerrainSettings.Resolution.x + 1)) + x;
-                    const u32 FaceVert1 = ((z + 1) * (TerrainSettings.Resolution.x + 1)) + x + 1;
-                    const u32 FaceVert2 = (z * (TerrainSettings.Resolution.x + 1)) + x + 1;
-
-                    StoreIndicesAndUpdateNormals(FaceVert0, FaceVert1, FaceVert2);
-                }
+                StoreIndicesAndUpdateNormals(((z + 1) * (TerrainSettings.Resolution.x + 1)) + x,
+                                             ((z + 1) * (TerrainSettings.Resolution.x + 1)) + x + 1,
+                                             (z * (TerrainSettings.Resolution.x + 1)) + x + 1);
             }
         }
 
-        // Normalize the normals
         for (u32 i = 0; i < (TerrainSettings.Resolution.x + 1) * (TerrainSettings.Resolution.y + 1); ++i)
         {
             VertexData[i].Normal = glm::normalize(VertexData[i].Normal);
         }
+    }
+
+    /** Generates the terrain with both paths and logs their timings and how much the results differ */
+    static void BenchmarkTerrainGeneration(const FTerrainSettings& TerrainSettings)
+    {
+        const u32 VertexCount  = (TerrainSettings.Resolution.x + 1) * (TerrainSettings.Resolution.y + 1);
+        const u32 IndicesCount = TerrainSettings.Resolution.x * TerrainSettings.Resolution.y * 6;
+
+        std::vector<FTerrainVertex> ReferenceVertices(VertexCount);
+        std::vector<FTerrainVertex> Vertices(VertexCount);
+        std::vector<u32>            Indices(IndicesCount);
+
+        const float NoiseOffsetX = math::RandomFloat() * 100000.0f;
+        const float NoiseOffsetZ = math::RandomFloat() * 100000.0f;
+
+        const real ReferenceStart = platform::GetCurrentTimeSeconds();
+        GenerateTerrainGeometryReference(TerrainSettings, NoiseOffsetX, NoiseOffsetZ, ReferenceVertices.data(), Indices.data());
+        const real ReferenceTime = platform::GetCurrentTimeSeconds() - ReferenceStart;
+
+        float      MinHeight, MaxHeight;
+        const real Start = platform::GetCurrentTimeSeconds();
+        GenerateTerrainGeometry(TerrainSettings, NoiseOffsetX, NoiseOffsetZ, Vertices.data(), Indices.data(), MinHeight, MaxHeight);
+        const real Time = platform::GetCurrentTimeSeconds() - Start;
+
+        float MaxHeightDifference = 0;
+        float MinNormalsDot       = 1;
+        for (u32 i = 0; i < VertexCount; ++i)
+        {
+            MaxHeightDifference = glm::max(MaxHeightDifference, glm::abs(Vertices[i].Position.y - ReferenceVertices[i].Position.y));
+            MinNormalsDot       = glm::min(MinNormalsDot, glm::dot(Vertices[i].Normal, ReferenceVertices[i].Normal));
+        }
+
+        LUCID_LOG(ELogLevel::INFO,
+                  "Terrain generation %dx%d: reference %f s, parallel SIMD %f s (%.1fx), max height difference %f, min normals dot %f",
+                  (u32)TerrainSettings.Resolution.x,
+                  (u32)TerrainSettings.Resolution.y,
+                  ReferenceTime,
+                  Time,
+                  Time > 0 ? ReferenceTime / Time : 0,
+                  MaxHeightDifference,
+                  MinNormalsDot);
+    }
+#endif
+
+    static lucid::resources::CMeshResource* GenerateTerrainMesh(const FTerrainSettings& TerrainSettings)
+    {
+        const u32 VertexCount  = (TerrainSettings.Resolution.x + 1) * (TerrainSettings.Resolution.y + 1);
+        const u32 IndicesCount = TerrainSettings.Resolution.x * TerrainSettings.Resolution.y * 6;
+
+        const u32 TerrainVertexDataSize  = VertexCount * sizeof(FTerrainVertex);
+        const u32 TerrainIndicesDataSize = IndicesCount * sizeof(u32);
+
+        FMemBuffer VertexDataBuffer  = CreateMemBuffer(TerrainVertexDataSize);
+        FMemBuffer IndicesDataBuffer = CreateMemBuffer(TerrainIndicesDataSize);
+
+        const glm::vec3 UpperLeft = { -TerrainSettings.GridSize.x / 2, 0, -TerrainSettings.GridSize.y / 2 };
+
+        float NoiseOffsetX = 0;
+        float NoiseOffsetZ = 0;
+
+        if (!TerrainSettings.bFlatMesh)
+        {
+            static std::default_random_engine RandomEngine{ std::mt19937(TerrainSettings.Seed == -1 ? math::RandomFloat() * UINT32_MAX :
+                                                                                                      TerrainSettings.Seed) };
+
+            static std::uniform_real_distribution<float> dis(0, 100000.0f);
+
+            NoiseOffsetX = dis(RandomEngine);
+            NoiseOffsetZ = dis(RandomEngine);
+        }
+
+        math::FAABB TerrainAABB;
+        GenerateTerrainGeometry(TerrainSettings,
+                                NoiseOffsetX,
+                                NoiseOffsetZ,
+                                (FTerrainVertex*)VertexDataBuffer.Pointer,
+                                (u32*)IndicesDataBuffer.Pointer,
+                                TerrainAABB.MinY,
+                                TerrainAABB.MaxY);
 
         VertexDataBuffer.Size  = TerrainVertexDataSize;
         IndicesDataBuffer.Size = TerrainIndicesDataSize;
@@ -221,7 +382,8 @@ namespace lucid::scene
         TerrainSubMesh.MaterialIndex     = 0;
         TerrainMesh->SubMeshes.Add(TerrainSubMesh);
 
-        TerrainMesh->DrawMode = gpu::EDrawMode::TRIANGLES;
+        TerrainMesh->DrawMode         = gpu::EDrawMode::TRIANGLES;
+        TerrainMesh->bUseGeometryPool = false; // sculpting swaps the vertex buffers of the terrain's vertex array
 
         TerrainMesh->SaveSynchronously();
 
@@ -321,6 +483,12 @@ namespace lucid::scene
 
         if (TerrainMesh)
         {
+            // Sculpting needs the terrain to have it's own vertex buffers, the mesh could've been put in the geometry pool when making it's thumbnail
+            if (TerrainMesh->bUseGeometryPool && TerrainMesh->IsLoadedToVideoMemory())
+            {
+                TerrainMesh->FreeVideoMemory();
+            }
+            TerrainMesh->bUseGeometryPool = false;
             TerrainMesh->Acquire(false, true);
             AABB = TerrainMesh->GetAABB();
         }
@@ -340,6 +508,8 @@ namespace lucid::scene
             return;
         }
 
+        FreeChunks();
+
         if (TerrainMesh)
         {
             TerrainMesh->Release();
@@ -373,6 +543,8 @@ namespace lucid::scene
     {
         IActor::CleanupAfterRemove();
 
+        FreeChunks();
+
         if (TerrainMaterial)
         {
             TerrainMaterial->UnloadResources();
@@ -380,6 +552,325 @@ namespace lucid::scene
         }
     }
 
+    /** Appends a triangle of a chunk pattern, the vertices are in chunk space, i.e. in the chunk's quads */
+    static void AddChunkTriangle(std::vector<u32>& OutIndices, const u32& InRowStride, const u32& InStep, glm::ivec2 V0, glm::ivec2 V1, glm::ivec2 V2)
+    {
+        // Keep the winding of the full resolution mesh's triangles
+        const i32 Cross = ((V1.x - V0.x) * (V2.y - V0.y)) - ((V1.y - V0.y) * (V2.x - V0.x));
+        if (Cross > 0)
+        {
+            std::swap(V1, V2);
+        }
+
+        // Indices are relative to the chunk's first vertex, it's added as the base vertex when drawing
+        OutIndices.push_back(((V0.y * InRowStride) + V0.x) * InStep);
+        OutIndices.push_back(((V1.y * InRowStride) + V1.x) * InStep);
+        OutIndices.push_back(((V2.y * InRowStride) + V2.x) * InStep);
+    }
+
+    /**
+     * Generates the indices of a chunk drawn with every InStep-th vertex. The inner quads are drawn as a regular grid,
+     * each edge is a strip connecting the chunk's border to the inner quads. Edges in InStitchMask use every other vertex
+     * of the border, so they match the border of a coarser neighbour.
+     */
+    static void GenerateChunkPattern(std::vector<u32>& OutIndices, const u32& InRowStride, const u32& InStep, const u8& InStitchMask)
+    {
+        static constexpr i32 C = TERRAIN_CHUNK_SIZE;
+
+        for (i32 z = 1; z < C - 1; ++z)
+        {
+            for (i32 x = 1; x < C - 1; ++x)
+            {
+                AddChunkTriangle(OutIndices, InRowStride, InStep, { x + 1, z }, { x, z }, { x, z + 1 });
+                AddChunkTriangle(OutIndices, InRowStride, InStep, { x, z + 1 }, { x + 1, z + 1 }, { x + 1, z });
+            }
+        }
+
+        // Edges in the order of the stitch mask's bits: -Z, +X, +Z, -X
+        for (u8 Edge = 0; Edge < 4; ++Edge)
+        {
+            const i32 BorderStep = (InStitchMask & (1 << Edge)) ? 2 : 1;
+
+            // T is the position along the edge, the border row has D = 0, the inner one D = 1
+            const auto EdgeVertex = [Edge](const i32& T, const i32& D) -> glm::ivec2 {
+                switch (Edge)
+                {
+                case 0:
+                    return { T, D };
+                case 1:
+                    return { C - D, T };
+                case 2:
+                    return { T, C - D };
+                default:
+                    return { D, T };
+                }
+            };
+
+            // Zip the border vertices in [0, C] with the inner ones in [1, C - 1]
+            i32 Border = 0;
+            i32 Inner  = 1;
+            while (Border < C || Inner < C - 1)
+            {
+                const i32 NextBorder = Border + BorderStep;
+                const i32 NextInner  = Inner + 1;
+
+                if (Inner == C - 1 || (Border < C && NextBorder <= NextInner))
+                {
+                    AddChunkTriangle(OutIndices, InRowStride, InStep, EdgeVertex(Border, 0), EdgeVertex(NextBorder, 0), EdgeVertex(Inner, 1));
+                    Border = NextBorder;
+                }
+                else
+                {
+                    AddChunkTriangle(OutIndices, InRowStride, InStep, EdgeVertex(Border, 0), EdgeVertex(NextInner, 1), EdgeVertex(Inner, 1));
+                    Inner = NextInner;
+                }
+            }
+        }
+    }
+
+    void CTerrain::SetupChunks()
+    {
+        FreeChunks();
+
+        const resources::FSubMesh* TerrainSubMesh = TerrainMesh->SubMeshes[0];
+        ChunksTerrainMesh                         = TerrainMesh;
+        ChunksVertexBuffer                        = TerrainSubMesh->VertexBuffer;
+
+        const u32 ResolutionX = TerrainSettings.Resolution.x;
+        const u32 ResolutionZ = TerrainSettings.Resolution.y;
+
+        if (!ChunksVertexBuffer || ResolutionX == 0 || ResolutionZ == 0 || (ResolutionX % TERRAIN_CHUNK_SIZE) || (ResolutionZ % TERRAIN_CHUNK_SIZE) ||
+            TerrainSubMesh->VertexCount != (ResolutionX + 1) * (ResolutionZ + 1))
+        {
+            LUCID_LOG(ELogLevel::INFO, "Terrain '%s' resolution isn't a multiple of %d, it'll be drawn without LOD", *Name, TERRAIN_CHUNK_SIZE);
+            return;
+        }
+
+        NumChunksX = ResolutionX / TERRAIN_CHUNK_SIZE;
+        NumChunksZ = ResolutionZ / TERRAIN_CHUNK_SIZE;
+
+        // The roots are the largest chunks that still tile the terrain
+        NumLODLevels = 1;
+        while (NumLODLevels < TERRAIN_MAX_LOD_LEVELS && (NumChunksX % (1u << NumLODLevels)) == 0 && (NumChunksZ % (1u << NumLODLevels)) == 0)
+        {
+            ++NumLODLevels;
+        }
+
+        NumRootsX = NumChunksX >> (NumLODLevels - 1);
+        NumRootsZ = NumChunksZ >> (NumLODLevels - 1);
+
+        ChunkLevels.resize(NumChunksX * NumChunksZ);
+
+        std::vector<u32> Indices;
+        for (u8 Level = 0; Level < NumLODLevels; ++Level)
+        {
+            for (u8 StitchMask = 0; StitchMask < 16; ++StitchMask)
+            {
+                LODPatternFirstIndex[Level][StitchMask] = Indices.size();
+                GenerateChunkPattern(Indices, ResolutionX + 1, 1 << Level, StitchMask);
+                LODPatternElementCount[Level][StitchMask] = Indices.size() - LODPatternFirstIndex[Level][StitchMask];
+            }
+        }
+
+        gpu::FBufferDescription ElementBufferDescription;
+        ElementBufferDescription.Offset = 0;
+        ElementBufferDescription.Size   = Indices.size() * sizeof(u32);
+        ElementBufferDescription.Data   = Indices.data();
+
+        LODElementBuffer = gpu::CreateBuffer(ElementBufferDescription, gpu::EBufferUsage::STATIC_DRAW, "TerrainLODElementBuffer");
+
+        FArray<gpu::FVertexAttribute> TerrainAttributes(3);
+        TerrainAttributes.Add({ 0, 3, EType::FLOAT, false, sizeof(FTerrainVertex), offsetof(FTerrainVertex, Position), 0 });
+        TerrainAttributes.Add({ 1, 3, EType::FLOAT, false, sizeof(FTerrainVertex), offsetof(FTerrainVertex, Normal), 0 });
+        TerrainAttributes.Add({ 3, 2, EType::FLOAT, false, sizeof(FTerrainVertex), offsetof(FTerrainVertex, TextureCoords), 0 });
+
+        // The vertex buffer is owned by the terrain mesh and the element buffer is freed with the chunks
+        LODVertexArray = gpu::CreateVertexArray("TerrainLODVertexArray",
+                                                TerrainAttributes,
+                                                ChunksVertexBuffer,
+                                                LODElementBuffer,
+                                                gpu::EDrawMode::TRIANGLES,
+                                                TerrainSubMesh->VertexCount,
+                                                Indices.size(),
+                                                false);
+    }
+
+    void CTerrain::FreeChunks()
+    {
+        if (LODVertexArray)
+        {
+            LODVertexArray->Free();
+            delete LODVertexArray;
+            LODVertexArray = nullptr;
+        }
+
+        if (LODElementBuffer)
+        {
+            LODElementBuffer->Free();
+            delete LODElementBuffer;
+            LODElementBuffer = nullptr;
+        }
+
+        ChunksTerrainMesh  = nullptr;
+        ChunksVertexBuffer = nullptr;
+        NumLODLevels       = 0;
+
+        ChunkLevels.clear();
+        Chunks.clear();
+    }
+
+    bool CTerrain::CanDrawChunks() const
+    {
+        return NumLODLevels && ChunksTerrainMesh == TerrainMesh && TerrainMesh->IsLoadedToVideoMemory() &&
+               ChunksVertexBuffer == TerrainMesh->SubMeshes[0]->VertexBuffer;
+    }
+
+    bool CTerrain::UpdateChunks(const CCamera* InCamera)
+    {
+        if (!TerrainMesh || !TerrainMesh->IsLoadedToVideoMemory() || TerrainMesh->SubMeshes.GetLength() == 0)
+        {
+            return false;
+        }
+
+        if (ChunksTerrainMesh != TerrainMesh)
+        {
+            SetupChunks();
+        }
+        else if (LODVertexArray && ChunksVertexBuffer != TerrainMesh->SubMeshes[0]->VertexBuffer)
+        {
+            // The mesh was reloaded to the GPU, the patterns are still valid
+            ChunksVertexBuffer = TerrainMesh->SubMeshes[0]->VertexBuffer;
+            LODVertexArray->SetVertexBuffer(ChunksVertexBuffer);
+        }
+
+        if (NumLODLevels == 0)
+        {
+            return false;
+        }
+
+        const glm::mat4 ModelMatrix = CalculateModelMatrix();
+        const glm::vec3 CameraPosLS = glm::inverse(ModelMatrix) * glm::vec4{ InCamera->GetPosition(), 1 };
+
+        Chunks.clear();
+
+        const u32 RootSize = 1 << (NumLODLevels - 1);
+        for (u32 RootZ = 0; RootZ < NumRootsZ; ++RootZ)
+        {
+            for (u32 RootX = 0; RootX < NumRootsX; ++RootX)
+            {
+                SelectChunks(NumLODLevels - 1, RootX * RootSize, RootZ * RootSize, CameraPosLS);
+            }
+        }
+
+        FinishChunks(InCamera->GetFrustum(), ModelMatrix);
+        return true;
+    }
+
+    void CTerrain::SelectChunks(const u8& InLevel, const u32& InChunkX, const u32& InChunkZ, const glm::vec3& InCameraPosLS)
+    {
+        const glm::vec2 CellSize = TerrainSettings.GridSize / TerrainSettings.Resolution;
+        const u32       NumCells = TERRAIN_CHUNK_SIZE << InLevel;
+
+        // The height range of the whole terrain is used for all chunks, this also keeps the neighbouring chunks at most one level apart
+        const glm::vec3 MinLS = { (-TerrainSettings.GridSize.x / 2) + (InChunkX * TERRAIN_CHUNK_SIZE * CellSize.x),
+                                  AABB.MinY,
+                                  (-TerrainSettings.GridSize.y / 2) + (InChunkZ * TERRAIN_CHUNK_SIZE * CellSize.y) };
+        const glm::vec3 MaxLS = MinLS + glm::vec3{ NumCells * CellSize.x, AABB.MaxY - AABB.MinY, NumCells * CellSize.y };
+
+        const float ChunkSize        = NumCells * glm::max(CellSize.x, CellSize.y);
+        const float DistanceToCamera = glm::distance(glm::clamp(InCameraPosLS, MinLS, MaxLS), InCameraPosLS);
+
+        if (InLevel > 0 && DistanceToCamera < ChunkSize * TERRAIN_LOD_SPLIT_DISTANCE)
+        {
+            const u32 HalfSize = 1 << (InLevel - 1);
+            SelectChunks(InLevel - 1, InChunkX, InChunkZ, InCameraPosLS);
+            SelectChunks(InLevel - 1, InChunkX + HalfSize, InChunkZ, InCameraPosLS);
+            SelectChunks(InLevel - 1, InChunkX, InChunkZ + HalfSize, InCameraPosLS);
+            SelectChunks(InLevel - 1, InChunkX + HalfSize, InChunkZ + HalfSize, InCameraPosLS);
+            return;
+        }
+
+        const resources::FSubMesh* TerrainSubMesh = TerrainMesh->SubMeshes[0];
+
+        FTerrainChunk Chunk;
+        Chunk.SubMesh.VAO           = LODVertexArray;
+        Chunk.SubMesh.BaseVertex    = (InChunkZ * TERRAIN_CHUNK_SIZE * (TerrainSettings.Resolution.x + 1)) + (InChunkX * TERRAIN_CHUNK_SIZE);
+        Chunk.SubMesh.bHasPositions = TerrainSubMesh->bHasPositions;
+        Chunk.SubMesh.bHasNormals   = TerrainSubMesh->bHasNormals;
+        Chunk.SubMesh.bHasTangetns  = TerrainSubMesh->bHasTangetns;
+        Chunk.SubMesh.bHasUVs       = TerrainSubMesh->bHasUVs;
+        Chunk.SubMesh.VertexCount   = TerrainSubMesh->VertexCount;
+        Chunk.SubMesh.MaterialIndex = 0;
+        Chunk.MinWS                 = MinLS;
+        Chunk.MaxWS                 = MaxLS;
+        Chunk.ChunkX                = InChunkX;
+        Chunk.ChunkZ                = InChunkZ;
+        Chunk.LODLevel              = InLevel;
+        Chunk.bVisible              = false;
+        Chunks.push_back(Chunk);
+
+        const u32 Size = 1 << InLevel;
+        for (u32 z = InChunkZ; z < InChunkZ + Size; ++z)
+        {
+            for (u32 x = InChunkX; x < InChunkX + Size; ++x)
+            {
+                ChunkLevels[(z * NumChunksX) + x] = InLevel;
+            }
+        }
+    }
+
+    void CTerrain::FinishChunks(const math::FFrustum& InFrustum, const glm::mat4& InModelMatrix)
+    {
+        for (FTerrainChunk& Chunk : Chunks)
+        {
+            // Edges bordering a coarser chunk are stitched to it, a coarser neighbour always spans the whole edge
+            const u8  Level      = Chunk.LODLevel;
+            const u32 Size       = 1 << Level;
+            u8        StitchMask = 0;
+
+            if (Chunk.ChunkZ > 0 && ChunkLevels[((Chunk.ChunkZ - 1) * NumChunksX) + Chunk.ChunkX] > Level)
+            {
+                StitchMask |= 1;
+            }
+
+            if (Chunk.ChunkX + Size < NumChunksX && ChunkLevels[(Chunk.ChunkZ * NumChunksX) + Chunk.ChunkX + Size] > Level)
+            {
+                StitchMask |= 2;
+            }
+
+            if (Chunk.ChunkZ + Size < NumChunksZ && ChunkLevels[((Chunk.ChunkZ + Size) * NumChunksX) + Chunk.ChunkX] > Level)
+            {
+                StitchMask |= 4;
+            }
+
+            if (Chunk.ChunkX > 0 && ChunkLevels[(Chunk.ChunkZ * NumChunksX) + Chunk.ChunkX - 1] > Level)
+            {
+                StitchMask |= 8;
+            }
+
+            Chunk.SubMesh.FirstIndex   = LODPatternFirstIndex[Level][StitchMask];
+            Chunk.SubMesh.ElementCount = LODPatternElementCount[Level][StitchMask];
+
+            // Bounds were stored in local space by SelectChunks()
+            const glm::vec3 MinLS = Chunk.MinWS;
+            const glm::vec3 MaxLS = Chunk.MaxWS;
+
+            Chunk.MinWS = glm::vec3{ FLT_MAX };
+            Chunk.MaxWS = glm::vec3{ -FLT_MAX };
+
+            for (u8 Corner = 0; Corner < 8; ++Corner)
+            {
+                const glm::vec3 CornerLS = { (Corner & 1) ? MaxLS.x : MinLS.x, (Corner & 2) ? MaxLS.y : MinLS.y, (Corner & 4) ? MaxLS.z : MinLS.z };
+                const glm::vec3 CornerWS = InModelMatrix * glm::vec4{ CornerLS, 1 };
+
+                Chunk.MinWS = glm::min(Chunk.MinWS, CornerWS);
+                Chunk.MaxWS = glm::max(Chunk.MaxWS, CornerWS);
+            }
+
+            Chunk.bVisible = InFrustum.TestAABB(Chunk.MinWS, Chunk.MaxWS);
+        }
+    }
+
     void CTerrain::UpdateBaseAssetTerrainMeshUpdate(resources::CMeshResource* InNewTerrainMesh, const FTerrainSettings& InNewTerrainSettings)
     {
         auto ChildReference = &AssetReferences.Head;
@@ -404,6 +895,58 @@ namespace lucid::scene
         SaveAssetToFile();
     }
 
+    void CTerrain::Sculpt(const glm::ivec2& InBrushCenter, const float& InDelta)
+    {
+        const glm::ivec2 Resolution{ TerrainSettings.Resolution };
+        const u32        RowStride  = Resolution.x + 1;
+
+        // Vertices touched by the brush, clamped to the grid
+        const glm::ivec2 BrushMin = glm::max(InBrushCenter - glm::ivec2{ BrushSize }, glm::ivec2{ 0 });
+        const glm::ivec2 BrushMax = glm::min(InBrushCenter + glm::ivec2{ BrushSize }, Resolution);
+
+        if (BrushMin.x > BrushMax.x || BrushMin.y > BrushMax.y)
+        {
+            return;
+        }
+
+        for (i32 z = BrushMin.y; z <= BrushMax.y; ++z)
+        {
+            for (i32 x = BrushMin.x; x <= BrushMax.x; ++x)
+            {
+                FTerrainVertex& Vertex = TerrainSculptData[(z * RowStride) + x];
+                Vertex.Position.y += InDelta;
+
+                AABB.MaxY = glm::max(AABB.MaxY, Vertex.Position.y);
+                AABB.MinY = glm::min(AABB.MinY, Vertex.Position.y);
+            }
+        }
+
+        UpdateAABB();
+
+        // The normals of the vertices bordering the brush depend on the sculpted heights too
+        const glm::uvec2 DirtyMin{ glm::max(BrushMin - 1, glm::ivec2{ 0 }) };
+        const glm::uvec2 DirtyMax{ glm::min(BrushMax + 1, Resolution) };
+
+        CalculateTerrainNormals(TerrainSculptData, TerrainSettings.Resolution, TerrainSettings.GridSize / TerrainSettings.Resolution, DirtyMin, DirtyMax);
+
+        // Upload only the dirty rectangle, a row at a time, so the cost depends on the brush size instead of the terrain size
+        gpu::CGPUBuffer* VertexBuffer = TerrainMesh->SubMeshes[0]->VertexBuffer;
+        for (u32 z = DirtyMin.y; z <= DirtyMax.y; ++z)
+        {
+            const u32 FirstVertex = (z * RowStride) + DirtyMin.x;
+
+            gpu::FBufferDescription DirtyRowDescription;
+            DirtyRowDescription.Offset = FirstVertex * sizeof(FTerrainVertex);
+            DirtyRowDescription.Size   = (DirtyMax.x - DirtyMin.x + 1) * sizeof(FTerrainVertex);
+            DirtyRowDescription.Data   = TerrainSculptData + FirstVertex;
+
+            VertexBuffer->Upload(&DirtyRowDescription);
+        }
+
+        // Cached shadow maps of the lights around the terrain have to be rendered again
+        GEngine.GetRenderer()->MarkActorDirty(this);
+    }
+
     void CTerrain::UIDrawActorDetails()
     {
         IActor::UIDrawActorDetails();
@@ -427,6 +970,12 @@ namespace lucid::scene
                 bRegenerateTerrain |= ImGui::InputFloat("Max height", &NewTerrainSettings.MaxHeight);
                 bRegenerateTerrain |= ImGui::Button("Regenerate");
 
+                ImGui::SameLine();
+                if (ImGui::Button("Benchmark generation"))
+                {
+                    BenchmarkTerrainGeneration(NewTerrainSettings);
+                }
+
                 if (bRegenerateTerrain)
                 {
                     NewTerrainSettings.bRegeneratingTerrainMesh = true;
@@ -434,6 +983,7 @@ namespace lucid::scene
                     resources::CMeshResource* NewTerrainMesh = GenerateTerrainMesh(NewTerrainSettings);
                     GEngine.RemoveMeshResource(TerrainMesh);
                     AABB = NewTerrainMesh->GetAABB();
+                    UpdateAABB();
 
                     if (auto* BaseTerrainAsset = dynamic_cast<CTerrain*>(BaseActorAsset))
                     {
@@ -480,59 +1030,14 @@ namespace lucid::scene
                 // Button to submit the new terrain
                 if (ImGui::Button("Submit terrain"))
                 {
-                    // Recalculate the normals
-                    for (u32 z = 0; z < TerrainSettings.Resolution.y; ++z)
-                    {
-                        for (u32 x = 0; x < TerrainSettings.Resolution.x; ++x)
-                        {
-                            // First triangle
-                            {
-                                const u32 FaceVert0 = (z * (TerrainSettings.Resolution.x + 1)) + x + 1;
-                                const u32 FaceVert1 = (z * (TerrainSettings.Resolution.x + 1)) + x;
-                                const u32 FaceVert2 = ((z + 1) * (TerrainSettings.Resolution.x + 1)) + x;
-
-                                // Normals
-                                const glm::vec3 Edge0 = TerrainSculptData[FaceVert0].Position - TerrainSculptData[FaceVert1].Position;
-                                const glm::vec3 Edge1 = TerrainSculptData[FaceVert1].Position - TerrainSculptData[FaceVert2].Position;
-
-                                const glm::vec3 Normal = glm::cross(Edge0, Edge1);
-
-                                TerrainSculptData[FaceVert0].Normal += Normal;
-                                TerrainSculptData[FaceVert1].Normal += Normal;
-                                TerrainSculptData[FaceVert2].Normal += Normal;
-                            }
-
-                            // Second triangle
-                            {
-                                const u32 FaceVert0 = ((z + 1) * (TerrainSettings.Resolution.x + 1)) + x;
-                                const u32 FaceVert1 = ((z + 1) * (TerrainSettings.Resolution.x + 1)) + x + 1;
-                                const u32 FaceVert2 = (z * (TerrainSettings.Resolution.x + 1)) + x + 1;
-
-                                // Normals
-                                const glm::vec3 Edge0 = TerrainSculptData[FaceVert0].Position - TerrainSculptData[FaceVert1].Position;
-                                const glm::vec3 Edge1 = TerrainSculptData[FaceVert1].Position - TerrainSculptData[FaceVert2].Position;
-
-                                const glm::vec3 Normal = glm::cross(Edge0, Edge1);
-
-                                TerrainSculptData[FaceVert0].Normal += Normal;
-                                TerrainSculptData[FaceVert1].Normal += Normal;
-                                TerrainSculptData[FaceVert2].Normal += Normal;
-                            }
-                        }
-                    }
-
                     bSculpting                           = false;
                     GSceneEditorState.bBlockActorPicking = false;
 
-                    // Save the changes
-                    TerrainMesh->SaveSynchronously();
-
-                    // Restore the original VBO so it gets freed properly
-                    TerrainMesh->SubMeshes[0]->VAO->SetVertexBuffer(OriginalTerrainVBO);
-
-                    // Load the edited terrain to the GPU
-                    TerrainMesh->FreeVideoMemory();
-                    TerrainMesh->LoadDataToVideoMemorySynchronously();
+                    // Normals and the vertex buffer were kept up to date while sculpting, so only the asset has to be saved
+                    if (TerrainMesh->Unpack())
+                    {
+                        TerrainMesh->SaveSynchronously();
+                    }
 
                     // Cleanup main memory if we need to
                     if (bShouldFreeMainMemoryAfterSculpting)
@@ -541,12 +1046,7 @@ namespace lucid::scene
                         bShouldFreeMainMemoryAfterSculpting = false;
                     }
 
-                    // Cleanup VBOs
-                    for (u8 i = 0; i < NumSculptingVBOs; ++i)
-                    {
-                        SculptingVBOs[i]->Free();
-                        delete SculptingVBOs[i];
-                    }
+                    TerrainSculptData = nullptr;
                 }
 
                 float SculptDelta = 0;
@@ -568,74 +1068,24 @@ namespace lucid::scene
                 // Sculpting
                 if (SculptDelta != 0 && bSculpting)
                 {
-                    const float     DistanceToTerrain = SceneWindow_GetDistanceToCameraUnderCursor();
-                    const glm::vec3 WorldRay          = GSceneEditorState.CurrentCamera->GetMouseRayInWorldSpace(GetMouseNDCPos(), DistanceToTerrain);
-
-                    const glm::vec2 TerrainGridUpperLeft =
-                      glm::vec2{ GetTransform().Translation.x, GetTransform().Translation.z } - (TerrainSettings.GridSize / 2.f);
-                    const glm::vec2 RayProjectedToGrid = glm::vec2{ WorldRay.x, WorldRay.z } - TerrainGridUpperLeft;
-
-                    int OffsetX = (RayProjectedToGrid.x / TerrainSettings.GridSize.x) * TerrainSettings.Resolution.x;
-                    int OffsetZ = (RayProjectedToGrid.y / TerrainSettings.GridSize.y) * TerrainSettings.Resolution.y;
-
-                    for (int z = -BrushSize; z <= BrushSize; ++z)
-                    {
-                        for (int x = -BrushSize; x <= BrushSize; ++x)
-                        {
-                            const int TerrainIndex = ((TerrainSettings.Resolution.x + 1) * (OffsetZ + z)) + OffsetX + x;
-                            if (TerrainIndex < 0 || TerrainIndex > ((TerrainSettings.Resolution.x + 1) * (TerrainSettings.Resolution.y + 1) - 1))
-                            {
-                                continue;
-                            }
-
-                            TerrainSculptData[TerrainIndex].Position.y += SculptDelta;
-
-                            if (TerrainSculptData[TerrainIndex].Position.y > AABB.MaxY)
-                            {
-                                AABB.MaxY = TerrainSculptData[TerrainIndex].Position.y;
-                            }
-
-                            if (TerrainSculptData[TerrainIndex].Position.y < AABB.MinY)
-                            {
-                                AABB.MinY = TerrainSculptData[TerrainIndex].Position.y;
-                            }
-                        }
-                    }
-                }
-                bSculptFlushNeeded = true;
-
-                if (bSculptFlushNeeded && bSculpting)
-                {
-                    const u8 NextVBOIndex = (CurrentSculptingVBOIndex + 1) % NumSculptingVBOs;
-                    if (SculptingVBOFences[NextVBOIndex] == nullptr || SculptingVBOFences[NextVBOIndex]->Wait(10))
+                    // The distance is read back from the GPU a few frames later, it's negative until the first readback lands
+                    const float DistanceToTerrain = SceneWindow_GetDistanceToCameraUnderCursor();
+                    if (DistanceToTerrain >= 0)
                     {
-                        // Send updated data
-                        SculptingVBOs[NextVBOIndex]->Bind(gpu::EBufferBindPoint::WRITE);
-                        void* VBOMemoryPtr = SculptingVBOs[NextVBOIndex]->MemoryMap(UNSYNCHRONIZED_WRITE);
-                        memcpy(VBOMemoryPtr, TerrainSculptData, TerrainMesh->SubMeshes[0]->VertexDataBuffer.Size);
-                        SculptingVBOs[NextVBOIndex]->MemoryUnmap();
-                        SculptingVBOs[NextVBOIndex]->Unbind();
+                        const glm::vec3 WorldRay = GSceneEditorState.CurrentCamera->GetMouseRayInWorldSpace(GetMouseNDCPos(), DistanceToTerrain);
 
-                        // Change VBO to the new one
-                        TerrainMesh->SubMeshes[0]->VAO->SetVertexBuffer(SculptingVBOs[NextVBOIndex]);
+                        const glm::vec2 TerrainGridUpperLeft =
+                          glm::vec2{ GetTransform().Translation.x, GetTransform().Translation.z } - (TerrainSettings.GridSize / 2.f);
+                        const glm::vec2 RayProjectedToGrid = glm::vec2{ WorldRay.x, WorldRay.z } - TerrainGridUpperLeft;
 
-                        bSculptFlushNeeded = false;
-                        bSculpFlushed      = true;
+                        const glm::ivec2 BrushCenter = { (i32)((RayProjectedToGrid.x / TerrainSettings.GridSize.x) * TerrainSettings.Resolution.x),
+                                                         (i32)((RayProjectedToGrid.y / TerrainSettings.GridSize.y) * TerrainSettings.Resolution.y) };
 
-                        // delete old fence
-                        if (SculptingVBOFences[NextVBOIndex])
-                        {
-                            SculptingVBOFences[NextVBOIndex]->Free();
-                            delete SculptingVBOFences[NextVBOIndex];
-                            SculptingVBOFences[NextVBOIndex] = nullptr;
-                        }
-
-                        // Update current VBO index
-                        CurrentSculptingVBOIndex = NextVBOIndex;
+                        Sculpt(BrushCenter, SculptDelta);
                     }
                 }
             }
-            else if (ImGui::Button("Sculpt terrain"))
+            else if (ImGui::Button("Sculpt terrain") && TerrainMesh->IsLoadedToVideoMemory() && TerrainMesh->SubMeshes[0]->VertexBuffer)
             {
                 // Start sculpting when button is pressed
                 bSculpting                           = true;
@@ -646,20 +1096,13 @@ namespace lucid::scene
                     TerrainMesh->LoadDataToMainMemorySynchronously();
                     bShouldFreeMainMemoryAfterSculpting = true;
                 }
-
-                // Create VBOs set to stream-draw that we'll cycle through while sculpting
-                gpu::FBufferDescription SculptingVBODescription;
-                SculptingVBODescription.Offset = 0;
-                SculptingVBODescription.Size   = TerrainMesh->SubMeshes[0]->VertexDataBuffer.Size;
-                SculptingVBODescription.Data   = TerrainMesh->SubMeshes[0]->VertexDataBuffer.Pointer;
-
-                for (u8 i = 0; i < NumSculptingVBOs; ++i)
+                else if (TerrainMesh->IsMainMemoryMapped())
                 {
-                    SculptingVBOs[i] = gpu::CreateBuffer(SculptingVBODescription, gpu::EBufferUsage::STREAM_DRAW, "SculptingVBO");
+                    // Mapped data is read-only, get a copy we can modify
+                    TerrainMesh->LoadDataToMainMemorySynchronously();
                 }
 
-                OriginalTerrainVBO = TerrainMesh->SubMeshes[0]->VAO->GetVertexBuffer();
-                TerrainSculptData  = (FTerrainVertex*)TerrainMesh->SubMeshes[0]->VertexDataBuffer.Pointer;
+                TerrainSculptData = (FTerrainVertex*)TerrainMesh->SubMeshes[0]->VertexDataBuffer.Pointer;
             }
 
             if (ImGui::CollapsingHeader("Material"))
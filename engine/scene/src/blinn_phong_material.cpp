@@ -162,7 +162,7 @@ namespace lucid::scene
     struct FBlinnPhongMapsMaterialData
     {
         glm::vec3 SpecularColor;
-        u32       _padding;
+        u32       TextureFeedbackSlot;
 
         u64 DiffuseMapBindlessHandle;
         u64 SpecularMapBindlessHandle;
@@ -182,6 +182,7 @@ namespace lucid::scene
 
         FBlinnPhongMapsMaterialData* MaterialData   = (FBlinnPhongMapsMaterialData*)InMaterialDataPtr;
         MaterialData->SpecularColor                 = SpecularColor;
+        MaterialData->TextureFeedbackSlot           = TextureFeedbackSlot;
         MaterialData->Shininess                     = Shininess;
         MaterialData->bHasSpecularMap               = SpecularMap != nullptr;
         MaterialData->bHasNormalMap                 = NormalMap != nullptr;
@@ -401,6 +402,8 @@ namespace lucid::scene
                 DisplacementMap->TextureHandle->MakeBindlessResident();
             }
         }
+
+        AcquireTextureFeedbackSlot();
     }
     
     void CBlinnPhongMapsMaterial::UnloadResources()
@@ -428,5 +431,26 @@ namespace lucid::scene
             DisplacementMap->Release();
             DisplacementMapBindlessHandle = 0;
         }
+
+        ReleaseTextureFeedbackSlot();
+    }
+
+    void CBlinnPhongMapsMaterial::RequestTextureMips(const float& InLog2UVFootprint)
+    {
+        // All of the maps are sampled with the same coordinates
+        resources::CTextureStreamer& TextureStreamer = GEngine.GetTextureStreamer();
+        TextureStreamer.RequestMips(DiffuseMap, InLog2UVFootprint);
+        TextureStreamer.RequestMips(SpecularMap, InLog2UVFootprint);
+        TextureStreamer.RequestMips(NormalMap, InLog2UVFootprint);
+        TextureStreamer.RequestMips(DisplacementMap, InLog2UVFootprint);
+    }
+
+    bool CBlinnPhongMapsMaterial::RefreshTextureHandles()
+    {
+        bool bRefreshed = RefreshBindlessHandle(DiffuseMap, DiffuseMapBindlessHandle);
+        bRefreshed |= RefreshBindlessHandle(SpecularMap, SpecularMapBindlessHandle);
+        bRefreshed |= RefreshBindlessHandle(NormalMap, NormalMapBindlessHandle);
+        bRefreshed |= RefreshBindlessHandle(DisplacementMap, DisplacementMapBindlessHandle);
+        return bRefreshed;
     }
 } // namespace lucid::scene
\ No newline at end of file
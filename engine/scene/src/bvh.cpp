@@ -0,0 +1,553 @@
+#include "scene/bvh.hpp"
+
+#include "scene/actors/actor.hpp"
+#include "scene/render_scene.hpp"
+
+#include <cassert>
+#include <algorithm>
+
+namespace lucid::scene
+{
+    static inline float SurfaceArea(const glm::vec3& InMin, const glm::vec3& InMax)
+    {
+        const glm::vec3 Extent = InMax - InMin;
+        return 2.f * (Extent.x * Extent.y + Extent.y * Extent.z + Extent.z * Extent.x);
+    }
+
+    static inline void GetActorBounds(const IActor* InActor, glm::vec3& OutMin, glm::vec3& OutMax)
+    {
+        const math::FAABB& AABB = InActor->GetAABB();
+        OutMin                  = { AABB.MinXWS, AABB.MinYWS, AABB.MinZWS };
+        OutMax                  = { AABB.MaxXWS, AABB.MaxYWS, AABB.MaxZWS };
+    }
+
+    static inline math::FAABB MakeWorldSpaceAABB(const glm::vec3& InMin, const glm::vec3& InMax)
+    {
+        math::FAABB AABB;
+        AABB.MinXWS = InMin.x;
+        AABB.MinYWS = InMin.y;
+        AABB.MinZWS = InMin.z;
+        AABB.MaxXWS = InMax.x;
+        AABB.MaxYWS = InMax.y;
+        AABB.MaxZWS = InMax.z;
+        return AABB;
+    }
+
+    void CBoundingVolumeHierarchy::Insert(IActor* InActor)
+    {
+        assert(!LeafIndexByActorId.Contains(InActor->ActorId));
+
+        const i32 LeafIndex = AllocateNode();
+        FBVHNode& Leaf      = Nodes[LeafIndex];
+
+        GetActorBounds(InActor, Leaf.Min, Leaf.Max);
+        Leaf.Min -= FatMargin;
+        Leaf.Max += FatMargin;
+        Leaf.Height = 0;
+        Leaf.Actor  = InActor;
+
+        InsertLeaf(LeafIndex);
+        LeafIndexByActorId.Add(InActor->ActorId, LeafIndex);
+        ++NumActors;
+    }
+
+    void CBoundingVolumeHierarchy::Remove(const u32& InActorId)
+    {
+        if (!LeafIndexByActorId.Contains(InActorId))
+        {
+            return;
+        }
+
+        const i32 LeafIndex = LeafIndexByActorId.Get(InActorId);
+        LeafIndexByActorId.Remove(InActorId);
+
+        RemoveLeaf(LeafIndex);
+        FreeNode(LeafIndex);
+        --NumActors;
+    }
+
+    bool CBoundingVolumeHierarchy::Update(IActor* InActor)
+    {
+        if (!LeafIndexByActorId.Contains(InActor->ActorId))
+        {
+            return false;
+        }
+
+        const i32 LeafIndex = LeafIndexByActorId.Get(InActor->ActorId);
+
+        glm::vec3 Min, Max;
+        GetActorBounds(InActor, Min, Max);
+
+        // Still fits in the enlarged bounds, nothing to do
+        FBVHNode& Leaf = Nodes[LeafIndex];
+        if (Leaf.Min.x <= Min.x && Leaf.Min.y <= Min.y && Leaf.Min.z <= Min.z && Leaf.Max.x >= Max.x && Leaf.Max.y >= Max.y && Leaf.Max.z >= Max.z)
+        {
+            return false;
+        }
+
+        RemoveLeaf(LeafIndex);
+
+        Nodes[LeafIndex].Min = Min - FatMargin;
+        Nodes[LeafIndex].Max = Max + FatMargin;
+
+        InsertLeaf(LeafIndex);
+        return true;
+    }
+
+    bool CBoundingVolumeHierarchy::Contains(const u32& InActorId) { return LeafIndexByActorId.Contains(InActorId); }
+
+    void CBoundingVolumeHierarchy::QueryFrustum(const math::FFrustum& InFrustum, std::vector<IActor*>& OutActors) const
+    {
+        if (RootIndex == -1)
+        {
+            return;
+        }
+
+        TraversalStack.clear();
+        TraversalStack.push_back(RootIndex);
+
+        while (!TraversalStack.empty())
+        {
+            const i32 NodeIndex = TraversalStack.back();
+            TraversalStack.pop_back();
+
+            const FBVHNode& Node = Nodes[NodeIndex];
+            if (!InFrustum.TestAABB(Node.Min, Node.Max))
+            {
+                continue;
+            }
+
+            if (Node.IsLeaf())
+            {
+                // Leaves store enlarged bounds, so test the actual bounds of the actor
+                if (InFrustum.TestAABB(Node.Actor->GetAABB()))
+                {
+                    OutActors.push_back(Node.Actor);
+                }
+                continue;
+            }
+
+            // Whole subtree is visible, no need to test it's children
+            if (InFrustum.ContainsAABB(Node.Min, Node.Max))
+            {
+                CollectActors(NodeIndex, OutActors);
+                continue;
+            }
+
+            TraversalStack.push_back(Node.Left);
+            TraversalStack.push_back(Node.Right);
+        }
+    }
+
+    template <typename TOverlapTest>
+    void CBoundingVolumeHierarchy::QueryOverlapping(const TOverlapTest& InOverlapTest, std::vector<IActor*>& OutActors) const
+    {
+        if (RootIndex == -1)
+        {
+            return;
+        }
+
+        TraversalStack.clear();
+        TraversalStack.push_back(RootIndex);
+
+        while (!TraversalStack.empty())
+        {
+            const i32 NodeIndex = TraversalStack.back();
+            TraversalStack.pop_back();
+
+            const FBVHNode& Node = Nodes[NodeIndex];
+            if (!InOverlapTest(Node.Min, Node.Max))
+            {
+                continue;
+            }
+
+            if (Node.IsLeaf())
+            {
+                // Leaves store enlarged bounds, so test the actual bounds of the actor
+                glm::vec3 ActorMin, ActorMax;
+                GetActorBounds(Node.Actor, ActorMin, ActorMax);
+                if (InOverlapTest(ActorMin, ActorMax))
+                {
+                    OutActors.push_back(Node.Actor);
+                }
+                continue;
+            }
+
+            TraversalStack.push_back(Node.Left);
+            TraversalStack.push_back(Node.Right);
+        }
+    }
+
+    void CBoundingVolumeHierarchy::QueryAABB(const math::FAABB& InAABB, std::vector<IActor*>& OutActors) const
+    {
+        QueryOverlapping([&InAABB](const glm::vec3& InMin, const glm::vec3& InMax) { return TestOverlap(InAABB, MakeWorldSpaceAABB(InMin, InMax)); },
+                         OutActors);
+    }
+
+    void CBoundingVolumeHierarchy::QuerySweptAABB(const math::FAABB& InAABB, const glm::vec3& InSweepDirection, std::vector<IActor*>& OutActors) const
+    {
+        QueryOverlapping(
+          [&InAABB, &InSweepDirection](const glm::vec3& InMin, const glm::vec3& InMax) {
+              return SweptTestOverlap(InAABB, MakeWorldSpaceAABB(InMin, InMax), InSweepDirection);
+          },
+          OutActors);
+    }
+
+    void CBoundingVolumeHierarchy::QuerySphere(const glm::vec3& InCenter, const float& InRadius, std::vector<IActor*>& OutActors) const
+    {
+        QueryOverlapping(
+          [&InCenter, &InRadius](const glm::vec3& InMin, const glm::vec3& InMax) { return math::TestAABBSphereOverlap(InMin, InMax, InCenter, InRadius); },
+          OutActors);
+    }
+
+    void CBoundingVolumeHierarchy::QueryCone(const glm::vec3&      InApex,
+                                             const glm::vec3&      InDirection,
+                                             const float&          InLength,
+                                             const float&          InAngle,
+                                             std::vector<IActor*>& OutActors) const
+    {
+        QueryOverlapping(
+          [&](const glm::vec3& InMin, const glm::vec3& InMax) {
+              // The cone is bounded by a sphere of radius InLength, so reject everything outside of it first
+              if (!math::TestAABBSphereOverlap(InMin, InMax, InApex, InLength))
+              {
+                  return false;
+              }
+
+              // Test the box's bounding sphere against the cone
+              const glm::vec3 Center = (InMin + InMax) * 0.5f;
+              const float     Radius = glm::length(InMax - InMin) * 0.5f;
+              return math::TestSphereConeOverlap(Center, Radius, InApex, InDirection, InLength, InAngle);
+          },
+          OutActors);
+    }
+
+    void CBoundingVolumeHierarchy::Clear()
+    {
+        Nodes.clear();
+        LeafIndexByActorId.FreeAll();
+        RootIndex     = -1;
+        FreeListIndex = -1;
+        NumActors     = 0;
+    }
+
+    i32 CBoundingVolumeHierarchy::AllocateNode()
+    {
+        if (FreeListIndex == -1)
+        {
+            Nodes.push_back({});
+            return static_cast<i32>(Nodes.size() - 1);
+        }
+
+        // Free nodes use the parent index to point to the next free node
+        const i32 NodeIndex = FreeListIndex;
+        FreeListIndex       = Nodes[NodeIndex].Parent;
+        Nodes[NodeIndex]    = {};
+        return NodeIndex;
+    }
+
+    void CBoundingVolumeHierarchy::FreeNode(const i32& InNodeIndex)
+    {
+        Nodes[InNodeIndex]        = {};
+        Nodes[InNodeIndex].Parent = FreeListIndex;
+        FreeListIndex             = InNodeIndex;
+    }
+
+    void CBoundingVolumeHierarchy::InsertLeaf(const i32& InLeafIndex)
+    {
+        if (RootIndex == -1)
+        {
+            RootIndex               = InLeafIndex;
+            Nodes[RootIndex].Parent = -1;
+            return;
+        }
+
+        const glm::vec3 LeafMin = Nodes[InLeafIndex].Min;
+        const glm::vec3 LeafMax = Nodes[InLeafIndex].Max;
+
+        // Find the best sibling for the new leaf using the surface area heuristic
+        i32 SiblingIndex = RootIndex;
+        while (!Nodes[SiblingIndex].IsLeaf())
+        {
+            const FBVHNode& Node = Nodes[SiblingIndex];
+
+            const float Area         = SurfaceArea(Node.Min, Node.Max);
+            const float CombinedArea = SurfaceArea(glm::min(Node.Min, LeafMin), glm::max(Node.Max, LeafMax));
+
+            // Cost of creating a new parent for this node and the new leaf
+            const float Cost = 2.f * CombinedArea;
+
+            // Minimum cost of pushing the leaf further down the tree
+            const float InheritanceCost = 2.f * (CombinedArea - Area);
+
+            const auto CalculateDescendCost = [&](const FBVHNode& InChild) -> float {
+                const float NewArea = SurfaceArea(glm::min(InChild.Min, LeafMin), glm::max(InChild.Max, LeafMax));
+                if (InChild.IsLeaf())
+                {
+                    return NewArea + InheritanceCost;
+                }
+                return (NewArea - SurfaceArea(InChild.Min, InChild.Max)) + InheritanceCost;
+            };
+
+            const float LeftCost  = CalculateDescendCost(Nodes[Node.Left]);
+            const float RightCost = CalculateDescendCost(Nodes[Node.Right]);
+
+            if (Cost < LeftCost && Cost < RightCost)
+            {
+                break;
+            }
+
+            SiblingIndex = LeftCost < RightCost ? Node.Left : Node.Right;
+        }
+
+        // Create a new parent for the sibling and the leaf
+        const i32 OldParentIndex = Nodes[SiblingIndex].Parent;
+        const i32 NewParentIndex = AllocateNode();
+
+        FBVHNode& NewParent = Nodes[NewParentIndex];
+        NewParent.Parent    = OldParentIndex;
+        NewParent.Min       = glm::min(Nodes[SiblingIndex].Min, LeafMin);
+        NewParent.Max       = glm::max(Nodes[SiblingIndex].Max, LeafMax);
+        NewParent.Height    = Nodes[SiblingIndex].Height + 1;
+        NewParent.Left      = SiblingIndex;
+        NewParent.Right     = InLeafIndex;
+
+        if (OldParentIndex != -1)
+        {
+            if (Nodes[OldParentIndex].Left == SiblingIndex)
+            {
+                Nodes[OldParentIndex].Left = NewParentIndex;
+            }
+            else
+            {
+                Nodes[OldParentIndex].Right = NewParentIndex;
+            }
+        }
+        else
+        {
+            RootIndex = NewParentIndex;
+        }
+
+        Nodes[SiblingIndex].Parent = NewParentIndex;
+        Nodes[InLeafIndex].Parent  = NewParentIndex;
+
+        FixUpwards(Nodes[InLeafIndex].Parent);
+    }
+
+    void CBoundingVolumeHierarchy::RemoveLeaf(const i32& InLeafIndex)
+    {
+        if (InLeafIndex == RootIndex)
+        {
+            RootIndex = -1;
+            return;
+        }
+
+        const i32 ParentIndex      = Nodes[InLeafIndex].Parent;
+        const i32 GrandParentIndex = Nodes[ParentIndex].Parent;
+        const i32 SiblingIndex     = Nodes[ParentIndex].Left == InLeafIndex ? Nodes[ParentIndex].Right : Nodes[ParentIndex].Left;
+
+        // Replace the parent with the sibling
+        if (GrandParentIndex != -1)
+        {
+            if (Nodes[GrandParentIndex].Left == ParentIndex)
+            {
+                Nodes[GrandParentIndex].Left = SiblingIndex;
+            }
+            else
+            {
+                Nodes[GrandParentIndex].Right = SiblingIndex;
+            }
+
+            Nodes[SiblingIndex].Parent = GrandParentIndex;
+            FreeNode(ParentIndex);
+            FixUpwards(GrandParentIndex);
+        }
+        else
+        {
+            RootIndex                  = SiblingIndex;
+            Nodes[SiblingIndex].Parent = -1;
+            FreeNode(ParentIndex);
+        }
+
+        Nodes[InLeafIndex].Parent = -1;
+    }
+
+    void CBoundingVolumeHierarchy::FixUpwards(i32 InNodeIndex)
+    {
+        // Walk back up the tree fixing heights and bounds
+        while (InNodeIndex != -1)
+        {
+            InNodeIndex = Balance(InNodeIndex);
+
+            FBVHNode&       Node  = Nodes[InNodeIndex];
+            const FBVHNode& Left  = Nodes[Node.Left];
+            const FBVHNode& Right = Nodes[Node.Right];
+
+            Node.Height = 1 + std::max(Left.Height, Right.Height);
+            Node.Min    = glm::min(Left.Min, Right.Min);
+            Node.Max    = glm::max(Left.Max, Right.Max);
+
+            InNodeIndex = Node.Parent;
+        }
+    }
+
+    i32 CBoundingVolumeHierarchy::Balance(const i32& InNodeIndex)
+    {
+        FBVHNode* A = &Nodes[InNodeIndex];
+        if (A->IsLeaf() || A->Height < 2)
+        {
+            return InNodeIndex;
+        }
+
+        const i32 IndexB = A->Left;
+        const i32 IndexC = A->Right;
+
+        FBVHNode* B = &Nodes[IndexB];
+        FBVHNode* C = &Nodes[IndexC];
+
+        const i32 Imbalance = C->Height - B->Height;
+
+        // Rotate C up
+        if (Imbalance > 1)
+        {
+            const i32 IndexF = C->Left;
+            const i32 IndexG = C->Right;
+
+            FBVHNode* F = &Nodes[IndexF];
+            FBVHNode* G = &Nodes[IndexG];
+
+            // Swap A and C
+            C->Left   = InNodeIndex;
+            C->Parent = A->Parent;
+            A->Parent = IndexC;
+
+            // A's old parent should point to C
+            if (C->Parent != -1)
+            {
+                if (Nodes[C->Parent].Left == InNodeIndex)
+                {
+                    Nodes[C->Parent].Left = IndexC;
+                }
+                else
+                {
+                    Nodes[C->Parent].Right = IndexC;
+                }
+            }
+            else
+            {
+                RootIndex = IndexC;
+            }
+
+            // Rotate
+            if (F->Height > G->Height)
+            {
+                C->Right  = IndexF;
+                A->Right  = IndexG;
+                G->Parent = InNodeIndex;
+
+                A->Min = glm::min(B->Min, G->Min);
+                A->Max = glm::max(B->Max, G->Max);
+                C->Min = glm::min(A->Min, F->Min);
+                C->Max = glm::max(A->Max, F->Max);
+
+                A->Height = 1 + std::max(B->Height, G->Height);
+                C->Height = 1 + std::max(A->Height, F->Height);
+            }
+            else
+            {
+                C->Right  = IndexG;
+                A->Right  = IndexF;
+                F->Parent = InNodeIndex;
+
+                A->Min = glm::min(B->Min, F->Min);
+                A->Max = glm::max(B->Max, F->Max);
+                C->Min = glm::min(A->Min, G->Min);
+                C->Max = glm::max(A->Max, G->Max);
+
+                A->Height = 1 + std::max(B->Height, F->Height);
+                C->Height = 1 + std::max(A->Height, G->Height);
+            }
+
+            return IndexC;
+        }
+
+        // Rotate B up
+        if (Imbalance < -1)
+        {
+            const i32 IndexD = B->Left;
+            const i32 IndexE = B->Right;
+
+            FBVHNode* D = &Nodes[IndexD];
+            FBVHNode* E = &Nodes[IndexE];
+
+            // Swap A and B
+            B->Left   = InNodeIndex;
+            B->Parent = A->Parent;
+            A->Parent = IndexB;
+
+            // A's old parent should point to B
+            if (B->Parent != -1)
+            {
+                if (Nodes[B->Parent].Left == InNodeIndex)
+                {
+                    Nodes[B->Parent].Left = IndexB;
+                }
+                else
+                {
+                    Nodes[B->Parent].Right = IndexB;
+                }
+            }
+            else
+            {
+                RootIndex = IndexB;
+            }
+
+            // Rotate
+            if (D->Height > E->Height)
+            {
+                B->Right  = IndexD;
+                A->Left   = IndexE;
+                E->Parent = InNodeIndex;
+
+                A->Min = glm::min(C->Min, E->Min);
+                A->Max = glm::max(C->Max, E->Max);
+                B->Min = glm::min(A->Min, D->Min);
+                B->Max = glm::max(A->Max, D->Max);
+
+                A->Height = 1 + std::max(C->Height, E->Height);
+                B->Height = 1 + std::max(A->Height, D->Height);
+            }
+            else
+            {
+                B->Right  = IndexE;
+                A->Left   = IndexD;
+                D->Parent = InNodeIndex;
+
+                A->Min = glm::min(C->Min, D->Min);
+                A->Max = glm::max(C->Max, D->Max);
+                B->Min = glm::min(A->Min, E->Min);
+                B->Max = glm::max(A->Max, E->Max);
+
+                A->Height = 1 + std::max(C->Height, D->Height);
+                B->Height = 1 + std::max(A->Height, E->Height);
+            }
+
+            return IndexB;
+        }
+
+        return InNodeIndex;
+    }
+
+    void CBoundingVolumeHierarchy::CollectActors(const i32& InNodeIndex, std::vector<IActor*>& OutActors) const
+    {
+        const FBVHNode& Node = Nodes[InNodeIndex];
+        if (Node.IsLeaf())
+        {
+            OutActors.push_back(Node.Actor);
+            return;
+        }
+
+        CollectActors(Node.Left, OutActors);
+        CollectActors(Node.Right, OutActors);
+    }
+} // namespace lucid::scene
@@ -134,6 +134,13 @@ namespace lucid::scene
         FrustumAABB.OrientAround(CameraTransform);
     }
 
+    math::FFrustum CCamera::GetFrustum() const
+    {
+        math::FFrustum Frustum;
+        Frustum.ExtractPlanes(GetProjectionMatrix() * GetViewMatrix());
+        return Frustum;
+    }
+
     glm::vec3 CCamera::GetMouseRayInViewSpace(const glm::vec2& InMousePosNDC, const float InT) const
     {
         const glm::vec4 MouseRayClip{ InMousePosNDC, -1, 1 };
@@ -1,6 +1,8 @@
 #include "scene/forward_renderer.hpp"
 
 #include <set>
+#include <algorithm>
+#include <stb_ds.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 
@@ -28,6 +30,7 @@
 #include "scene/actors/static_mesh.hpp"
 #include "scene/actors/skybox.hpp"
 #include "scene/actors/terrain.hpp"
+#include "scene/world.hpp"
 
 #include "misc/basic_shapes.hpp"
 #include "misc/math.hpp"
@@ -35,44 +38,105 @@
 #include "resources/resources_holder.hpp"
 #include "resources/mesh_resource.hpp"
 
+#include "platform/util.hpp"
+
 namespace lucid::scene
 {
-    static const u8       NO_LIGHT = 0;
-    static const FSString LIGHT_TYPE("uLightType");
+    static const gpu::FUniformHandle VIEWPORT_SIZE = gpu::CShader::GetUniformHandle("uViewportSize");
+
+    static const gpu::FUniformHandle SCENE_DEPTH = gpu::CShader::GetUniformHandle("uSceneDepth");
+    static const gpu::FUniformHandle FROM_SCENE_DEPTH = gpu::CShader::GetUniformHandle("uFromDepth");
+    static const gpu::FUniformHandle NEAR_PLANE = gpu::CShader::GetUniformHandle("uNearPlane");
+    static const gpu::FUniformHandle FAR_PLANE = gpu::CShader::GetUniformHandle("uFarPlane");
+
+    static const gpu::FUniformHandle SSAO_NORMALS_VS = gpu::CShader::GetUniformHandle("uNormalsVS");
+    static const gpu::FUniformHandle SSAO_NOISE = gpu::CShader::GetUniformHandle("uNoise");
+    static const gpu::FUniformHandle SSAO_NOISE_SCALE = gpu::CShader::GetUniformHandle("uNoiseScale");
+    static const gpu::FUniformHandle SSAO_RADIUS = gpu::CShader::GetUniformHandle("uRadius");
+    static const gpu::FUniformHandle SSAO_BIAS = gpu::CShader::GetUniformHandle("uBias");
+    static const gpu::FUniformHandle SSAO_DEPTH_CHAIN = gpu::CShader::GetUniformHandle("uSSAODepthChain");
+    static const gpu::FUniformHandle SSAO_HISTORY = gpu::CShader::GetUniformHandle("uSSAOHistory");
+    static const gpu::FUniformHandle SSAO_HISTORY_VALID = gpu::CShader::GetUniformHandle("uHistoryValid");
+    static const gpu::FUniformHandle SSAO_TEMPORAL_BLEND = gpu::CShader::GetUniformHandle("uTemporalBlend");
+    static const gpu::FUniformHandle SSAO_FRAME_INDEX = gpu::CShader::GetUniformHandle("uFrameIndex");
+    static const gpu::FUniformHandle SSAO_VIEW_TO_PREVIOUS_CLIP = gpu::CShader::GetUniformHandle("uViewToPreviousClip");
+    static const gpu::FUniformHandle SSAO_HALF_RES = gpu::CShader::GetUniformHandle("uSSAOHalfRes");
+
+    static const gpu::FUniformHandle SIMPLE_BLUR_OFFSET_X = gpu::CShader::GetUniformHandle("uOffsetX");
+    static const gpu::FUniformHandle SIMPLE_BLUR_OFFSET_Y = gpu::CShader::GetUniformHandle("uOffsetY");
+    static const gpu::FUniformHandle SIMPLE_BLUR_TEXTURE = gpu::CShader::GetUniformHandle("uTextureToBlur");
+
+    static const gpu::FUniformHandle BILLBOARD_MATRIX = gpu::CShader::GetUniformHandle("uBillboardMatrix");
+    static const gpu::FUniformHandle BILLBOARD_VIEWPORT_SIZE = gpu::CShader::GetUniformHandle("uBillboardViewportSize");
+    static const gpu::FUniformHandle BILLBOARD_TEXTURE = gpu::CShader::GetUniformHandle("uBillboardTexture");
+    static const gpu::FUniformHandle BILLBOARD_WORLD_POS = gpu::CShader::GetUniformHandle("uBillboardWorldPos");
+    static const gpu::FUniformHandle BILLBOARD_COLOR_TINT = gpu::CShader::GetUniformHandle("uBillboardColorTint");
+
+    static const gpu::FUniformHandle MODEL_MATRIX = gpu::CShader::GetUniformHandle("uModelMatrix");
+    static const gpu::FUniformHandle VIEW_MATRIX = gpu::CShader::GetUniformHandle("uView");
+    static const gpu::FUniformHandle PROJECTION_MATRIX = gpu::CShader::GetUniformHandle("uProjection");
+
+    static const gpu::FUniformHandle SKYBOX_CUBEMAP = gpu::CShader::GetUniformHandle("uSkybox");
+
+    static const gpu::FUniformHandle GAMMA = gpu::CShader::GetUniformHandle("uGamma");
+    static const gpu::FUniformHandle SCENE_TEXTURE = gpu::CShader::GetUniformHandle("uSceneTexture");
+
+    static const gpu::FUniformHandle MESH_BATCH_OFFSET = gpu::CShader::GetUniformHandle("uMeshBatchOffset");
+
+    static const gpu::FUniformHandle LIGHT_NEAR_PLANE = gpu::CShader::GetUniformHandle("uLightNearPlane");
+    static const gpu::FUniformHandle LIGHT_FAR_PLANE = gpu::CShader::GetUniformHandle("uLightFarPlane");
+    static const gpu::FUniformHandle LIGHT_SPACE_MATRIX = gpu::CShader::GetUniformHandle("uLightMatrix");
+    static const gpu::FUniformHandle LIGHT_POSITION     = gpu::CShader::GetUniformHandle("uLightPosition");
+    static const gpu::FUniformHandle LIGHT_FACE_MATRIX  = gpu::CShader::GetUniformHandle("uLightSpaceMatrix");
+
+    static const gpu::FUniformHandle CULLING_PHASE = gpu::CShader::GetUniformHandle("uCullingPhase");
+    static const gpu::FUniformHandle CULLING_NUM_INSTANCES = gpu::CShader::GetUniformHandle("uNumInstances");
+    static const gpu::FUniformHandle CULLING_NUM_DRAW_COMMANDS = gpu::CShader::GetUniformHandle("uNumDrawCommands");
+    static const gpu::FUniformHandle CULLING_OCCLUSION_CULLING = gpu::CShader::GetUniformHandle("uOcclusionCulling");
+    static const gpu::FUniformHandle CULLING_FRUSTUM_PLANES[6]{
+        gpu::CShader::GetUniformHandle("uFrustumPlanes", 0), gpu::CShader::GetUniformHandle("uFrustumPlanes", 1),
+        gpu::CShader::GetUniformHandle("uFrustumPlanes", 2), gpu::CShader::GetUniformHandle("uFrustumPlanes", 3),
+        gpu::CShader::GetUniformHandle("uFrustumPlanes", 4), gpu::CShader::GetUniformHandle("uFrustumPlanes", 5)
+    };
+
+    static const gpu::FUniformHandle HI_Z = gpu::CShader::GetUniformHandle("uHiZ");
+    static const gpu::FUniformHandle HI_Z_VIEW_MATRIX = gpu::CShader::GetUniformHandle("uHiZView");
+    static const gpu::FUniformHandle HI_Z_PROJECTION_MATRIX = gpu::CShader::GetUniformHandle("uHiZProjection");
+    static const gpu::FUniformHandle HI_Z_NEAR_PLANE = gpu::CShader::GetUniformHandle("uHiZNearPlane");
+    static const gpu::FUniformHandle HI_Z_NUM_MIPS = gpu::CShader::GetUniformHandle("uHiZNumMips");
+
+    static const gpu::FUniformHandle CLUSTER_INVERSE_PROJECTION = gpu::CShader::GetUniformHandle("uInverseProjection");
 
-    static const FSString VIEWPORT_SIZE("uViewportSize");
+    /** Has to match the local size in cull_mesh_batches.comp */
+    static constexpr u32 CULLING_GROUP_SIZE = 64;
 
-    static const FSString SSAO_POSITIONS_VS("uPositionsVS");
-    static const FSString SSAO_NORMALS_VS("uNormalsVS");
-    static const FSString SSAO_NOISE("uNoise");
-    static const FSString SSAO_NOISE_SCALE("uNoiseScale");
-    static const FSString SSAO_RADIUS("uRadius");
-    static const FSString SSAO_BIAS("uBias");
+    /** Have to match the phases in cull_mesh_batches.comp */
+    static constexpr u32 CULLING_PHASE_FIRST          = 0;
+    static constexpr u32 CULLING_PHASE_PREPARE_SECOND = 1;
+    static constexpr u32 CULLING_PHASE_SECOND         = 2;
 
-    static const FSString SIMPLE_BLUR_OFFSET_X("uOffsetX");
-    static const FSString SIMPLE_BLUR_OFFSET_Y("uOffsetY");
-    static const FSString SIMPLE_BLUR_TEXTURE("uTextureToBlur");
+    /** Has to match the local size in hi_z.comp and ssao_depth_chain.comp */
+    static constexpr u32 HI_Z_GROUP_SIZE = 8;
 
-    static const FSString BILLBOARD_MATRIX("uBillboardMatrix");
-    static const FSString BILLBOARD_VIEWPORT_SIZE("uBillboardViewportSize");
-    static const FSString BILLBOARD_TEXTURE("uBillboardTexture");
-    static const FSString BILLBOARD_WORLD_POS("uBillboardWorldPos");
-    static const FSString BILLBOARD_COLOR_TINT("uBillboardColorTint");
+    /** Has to match NUM_SAMPLES in ssao_half_res.frag, the temporal accumulation makes up for the smaller kernel */
+    static constexpr u8 NUM_HALF_RES_SSAO_SAMPLES = 16;
 
-    static const FSString MODEL_MATRIX("uModelMatrix");
-    static const FSString VIEW_MATRIX("uView");
-    static const FSString PROJECTION_MATRIX("uProjection");
+    /** Has to match the local size in cluster_lights.comp */
+    static constexpr u32 CLUSTER_LIGHTS_GROUP_SIZE = 64;
 
-    static const FSString SKYBOX_CUBEMAP("uSkybox");
+    /** Tiles in the shadow atlases are at most this many times smaller than the light's shadow map size, but not smaller than the min tile size */
+    static constexpr u8  MAX_SHADOW_TILE_LEVELS      = 3;
+    static constexpr u16 MIN_SHADOW_ATLAS_TILE_SIZE = 64;
 
-    static const FSString GAMMA("uGamma");
-    static const FSString SCENE_TEXTURE("uSceneTexture");
+    /** How far (in tile levels) the importance of a light can move past the tile's level before the tile is reallocated */
+    static constexpr float SHADOW_TILE_LEVEL_HYSTERESIS = 0.25f;
 
-    static const FSString MESH_BATCH_OFFSET("uMeshBatchOffset");
+#if DEVELOPMENT
+    /** How many times the point shadow maps are rendered with each of the modes during the benchmark */
+    static constexpr u32 POINT_SHADOW_BENCHMARK_ITERATIONS = 16;
 
-    static const FSString LIGHT_NEAR_PLANE{ "uLightNearPlane" };
-    static const FSString LIGHT_FAR_PLANE{ "uLightFarPlane" };
-    static const FSString LIGHT_SPACE_MATRIX{ "uLightMatrix" };
+    static const char* POINT_SHADOW_MODE_NAMES[] = { "Geometry shader", "Per face", "Layered instancing" };
+#endif
 
     constexpr gpu::EImmutableBufferUsage COHERENT_WRITE_USAGE =
       (gpu::EImmutableBufferUsage)(gpu::EImmutableBufferUsage::IMM_BUFFER_WRITE | gpu::EImmutableBufferUsage::IMM_BUFFER_COHERENT);
@@ -84,13 +148,13 @@ namespace lucid::scene
 
 #if DEVELOPMENT
 
-    static const FSString ACTOR_ID("uActorId");
+    static const gpu::FUniformHandle ACTOR_ID = gpu::CShader::GetUniformHandle("uActorId");
 
     enum EDebugTextureType
     {
         SSAO,
         NORMALS,
-        POSITIONS,
+        DEPTH,
         LIGHTING,
         HITMAP
     };
@@ -107,12 +171,8 @@ namespace lucid::scene
         i32       NormalMultiplier;
         u32       ActorId;
         char      _padding[8];
-    };
-
-    struct FInstanceData
-    {
-        u32 ActorDataIdx;
-        u32 MaterialDataIdx;
+        glm::vec4 BoundsMin; // World space AABB, used when culling on the GPU
+        glm::vec4 BoundsMax;
     };
 
     struct FGlobalRenderData
@@ -129,15 +189,93 @@ namespace lucid::scene
         float     FarPlane;
         int       uSSAOKernelSize;
         int       uSSAOStrength;
+        u32       FrameNumber;
+    };
+
+    /** Start of the light buffer, followed by the data of the lights. Has to match LightsDataBlock in light_data.glsl */
+    struct FLightsDataHeader
+    {
+        u32                NumLights;
+        u32                NumDirectionalLights;
+        u64                ShadowAtlasBindlessHandle;
+        u64                CubeShadowAtlasBindlessHandle;
+        char               _padding[8];
+        FLightCascadesData Cascades[MAX_CASCADED_LIGHTS];
     };
 
 #pragma pack(pop)
 
+    static constexpr u32 MAX_LIGHTS = (LIGHTS_DATA_BUFFER_SIZE - sizeof(FLightsDataHeader)) / sizeof(FLightData);
+
+    static constexpr u32 MAX_ACTOR_DATA_SLOTS = ACTOR_DATA_BUFFER_SIZE / sizeof(FActorData);
+    static constexpr u32 MAX_INSTANCES        = INSTANCE_DATA_BUFFER_SIZE / sizeof(FInstanceData);
+    static constexpr u32 MAX_DRAW_COMMANDS    = DRAW_COMMANDS_BUFFER_SIZE / sizeof(FGPUDrawCommand);
+
+    /** Each of the main instances also writes it's prepass data */
+    static constexpr u32 MAX_MAIN_INSTANCES = glm::min(MAX_INSTANCES, (u32)(PREPASS_DATA_BUFFER_SIZE / sizeof(FForwardPrepassUniforms)));
+
+    /** What doesn't fit into the frame data buffers is skipped, they stay full until the scene gets smaller so each of them is reported once */
+    static bool bActorDataBufferFullReported    = false;
+    static bool bInstanceDataBufferFullReported = false;
+    static bool bDrawCommandsBufferFullReported = false;
+
+    static void ReportBufferFull(bool& InOutbReported, const char* InBufferName, const u32& InCapacity)
+    {
+        if (!InOutbReported)
+        {
+            LUCID_LOG(ELogLevel::WARN, "%s buffer is full (%d entries), whatever doesn't fit won't be rendered", InBufferName, InCapacity);
+            InOutbReported = true;
+        }
+    }
+
 #define GLOBAL_DATA_BUFFER_SIZE                                                                       \
     (sizeof(FGlobalRenderData) + (sizeof(FGlobalRenderData) > gpu::GGPUInfo.UniformBlockAlignment ?   \
                                     sizeof(FGlobalRenderData) % gpu::GGPUInfo.UniformBlockAlignment : \
                                     gpu::GGPUInfo.UniformBlockAlignment % sizeof(FGlobalRenderData)))
 
+    static gpu::CTexture* CreateShadowAtlasTexture(const u16& InSize, const FString& InName)
+    {
+        gpu::CTexture* AtlasTexture = gpu::CreateEmpty2DTexture(
+          InSize, InSize, gpu::ETextureDataType::FLOAT, gpu::ETextureDataFormat::DEPTH_COMPONENT, gpu::ETexturePixelFormat::DEPTH_COMPONENT, 0, InName);
+
+        // Samples are clamped to the tiles in the shaders
+        AtlasTexture->Bind();
+        AtlasTexture->SetWrapSFilter(gpu::EWrapTextureFilter::CLAMP_TO_EDGE);
+        AtlasTexture->SetWrapTFilter(gpu::EWrapTextureFilter::CLAMP_TO_EDGE);
+        AtlasTexture->SetMinFilter(gpu::EMinTextureFilter::NEAREST);
+        AtlasTexture->SetMagFilter(gpu::EMagTextureFilter::NEAREST);
+
+        AtlasTexture->GetBindlessHandle();
+        AtlasTexture->MakeBindlessResident();
+
+        return AtlasTexture;
+    }
+
+    /** Sends the sample vectors of a hemisphere kernel to the SSAO shader, which has to be in use */
+    static void SetupSSAOKernel(gpu::CShader* InShader, const u8& InNumSamples)
+    {
+        for (int i = 0; i < InNumSamples; ++i)
+        {
+            glm::vec3 Sample = math::RandomVec3();
+
+            // Transform x and y to [-1, 1], keep z [0, 1] so the we sample around a hemisphere
+            Sample.x = Sample.x * 2.0 - 1.0;
+            Sample.y = Sample.y * 2.0 - 1.0;
+            Sample   = glm::normalize(Sample);
+            Sample *= math::RandomFloat();
+
+            // Use an accelerating interpolation function so there are more samples close to the fragment
+            float Scale = (float)i / (float)InNumSamples;
+            Scale       = math::Lerp(0.1, 1.0f, Scale * Scale);
+            Sample *= Scale;
+
+            // Send the sample to the shader
+            FDString SampleUniformName = SPrintf(LUCID_TEXT("uSamples[%d]"), i);
+            InShader->SetVector(SampleUniformName, Sample);
+            SampleUniformName.Free();
+        }
+    }
+
     CForwardRenderer::CForwardRenderer(const u32& InMaxNumOfDirectionalLights, const u8& InNumSSAOSamples)
     : MaxNumOfDirectionalLights(InMaxNumOfDirectionalLights)
     {
@@ -156,17 +294,30 @@ namespace lucid::scene
             UnitCubeVAO = misc::CreateCubeVAO();
         }
 
-        ShadowMapShader         = GEngine.GetShadersManager().GetShaderByName("ShadowMap");
-        CascadeShadowMapShader  = GEngine.GetShadersManager().GetShaderByName("CascadeShadowMap");
-        ShadowCubeMapShader     = GEngine.GetShadersManager().GetShaderByName("ShadowCubemap");
-        ShadowCubeMapShaderNoGS = GEngine.GetShadersManager().GetShaderByName("ShadowCubemapNoGS");
-        PrepassShader           = GEngine.GetShadersManager().GetShaderByName("ForwardPrepass");
-        SSAOShader              = GEngine.GetShadersManager().GetShaderByName("SSAO");
-        SimpleBlurShader        = GEngine.GetShadersManager().GetShaderByName("SimpleBlur");
-        SkyboxShader            = GEngine.GetShadersManager().GetShaderByName("Skybox");
-        BillboardShader         = GEngine.GetShadersManager().GetShaderByName("Billboard");
-        FlatShader              = GEngine.GetShadersManager().GetShaderByName("Flat");
-        GammaCorrectionShader   = GEngine.GetShadersManager().GetShaderByName("GammaCorrection");
+        ShadowMapShader            = GEngine.GetShadersManager().GetShaderByName("ShadowMap");
+        CascadeShadowMapShader     = GEngine.GetShadersManager().GetShaderByName("CascadeShadowMap");
+        ShadowCubeMapShader        = GEngine.GetShadersManager().GetShaderByName("ShadowCubemap");
+        ShadowCubeMapShaderNoGS    = GEngine.GetShadersManager().GetShaderByName("ShadowCubemapNoGS");
+        ShadowCubeMapShaderLayered = GEngine.GetShadersManager().GetShaderByName("ShadowCubemapLayered");
+        PrepassShader              = GEngine.GetShadersManager().GetShaderByName("ForwardPrepass");
+        SSAOShader                 = GEngine.GetShadersManager().GetShaderByName("SSAO");
+        SSAOHalfResShader          = GEngine.GetShadersManager().GetShaderByName("SSAOHalfRes");
+        SSAOUpsampleShader         = GEngine.GetShadersManager().GetShaderByName("SSAOUpsample");
+        SSAODepthChainShader       = GEngine.GetShadersManager().GetShaderByName("SSAODepthChain");
+        SimpleBlurShader           = GEngine.GetShadersManager().GetShaderByName("SimpleBlur");
+        SkyboxShader               = GEngine.GetShadersManager().GetShaderByName("Skybox");
+        BillboardShader            = GEngine.GetShadersManager().GetShaderByName("Billboard");
+        FlatShader                 = GEngine.GetShadersManager().GetShaderByName("Flat");
+        GammaCorrectionShader      = GEngine.GetShadersManager().GetShaderByName("GammaCorrection");
+        CullMeshBatchesShader      = GEngine.GetShadersManager().GetShaderByName("CullMeshBatches");
+        HiZShader                  = GEngine.GetShadersManager().GetShaderByName("HiZ");
+        ClusterLightsShader        = GEngine.GetShadersManager().GetShaderByName("ClusterLights");
+
+        if (RendererSettings.PointShadowMode == EPointShadowMode::LAYERED_INSTANCING && !gpu::GGPUInfo.bVertexShaderViewportIndex)
+        {
+            LUCID_LOG(ELogLevel::WARN, "Vertex shader viewport index isn't supported, point shadows fall back to the geometry shader");
+            RendererSettings.PointShadowMode = EPointShadowMode::GEOMETRY_SHADER;
+        }
 
 #if DEVELOPMENT
         EditorHelpersShader    = GEngine.GetShadersManager().GetShaderByName("Hitmap");
@@ -198,11 +349,7 @@ namespace lucid::scene
         LightpassPipelineState.ClearColorBufferColor    = BlackColor;
         LightpassPipelineState.IsDepthTestEnabled       = true;
         LightpassPipelineState.DepthTestFunction        = gpu::EDepthTestFunction::EQUAL;
-        LightpassPipelineState.IsBlendingEnabled        = true;
-        LightpassPipelineState.BlendFunctionSrc         = gpu::EBlendFunction::ONE;
-        LightpassPipelineState.BlendFunctionDst         = gpu::EBlendFunction::ONE;
-        LightpassPipelineState.BlendFunctionAlphaSrc    = gpu::EBlendFunction::ONE;
-        LightpassPipelineState.BlendFunctionAlphaDst    = gpu::EBlendFunction::ONE;
+        LightpassPipelineState.IsBlendingEnabled        = false;
         LightpassPipelineState.IsCullingEnabled         = true;
         LightpassPipelineState.CullMode                 = gpu::ECullMode::BACK;
         LightpassPipelineState.IsSRGBFramebufferEnabled = false;
@@ -247,6 +394,9 @@ namespace lucid::scene
 
         // Create the framebuffers
         ShadowMapFramebuffer    = gpu::CreateFramebuffer(FSString{ "ShadowmapFramebuffer" });
+
+        ShadowAtlas     = new CShadowAtlas(CreateShadowAtlasTexture(ShadowAtlasSize, FSString{ "ShadowAtlas" }), MIN_SHADOW_ATLAS_TILE_SIZE);
+        CubeShadowAtlas = new CShadowAtlas(CreateShadowAtlasTexture(CubeShadowAtlasSize, FSString{ "CubeShadowAtlas" }), MIN_SHADOW_ATLAS_TILE_SIZE);
         PrepassFramebuffer      = gpu::CreateFramebuffer(FSString{ "PrepassFramebuffer" });
         LightingPassFramebuffer = gpu::CreateFramebuffer(FSString{ "LightingPassFramebuffer" });
         SSAOFramebuffer         = gpu::CreateFramebuffer(FSString{ "SSAOFramebuffer" });
@@ -261,22 +411,24 @@ namespace lucid::scene
                                                             gpu::ETexturePixelFormat::RGB,
                                                             0,
                                                             FSString{ "CurrentFrameVSNormalMap" });
-        CurrentFrameVSPositionMap = gpu::CreateEmpty2DTexture(ResultResolution.x,
-                                                              ResultResolution.y,
-                                                              gpu::ETextureDataType::FLOAT,
-                                                              gpu::ETextureDataFormat::RGB16F,
-                                                              gpu::ETexturePixelFormat::RGB,
-                                                              0,
-                                                              FSString{ "CurrentFrameVSPositionMap" });
-
-        // Create color attachment for the lighting pass framebuffer and a shared depth-setencil attachment
-        DepthStencilRenderBuffer =
-          gpu::CreateRenderbuffer(gpu::ERenderbufferFormat::DEPTH24_STENCIL8, ResultResolution, FSString{ "LightingPassRenderbuffer" });
-        DepthStencilRenderBuffer->Bind();
+
+        // Create a depth attachment shared by the lighting pass and the prepass, it's a texture so we can reconstruct view space positions from it
+        SceneDepthTexture = gpu::CreateEmpty2DTexture(ResultResolution.x,
+                                                      ResultResolution.y,
+                                                      gpu::ETextureDataType::FLOAT,
+                                                      gpu::ETextureDataFormat::DEPTH_COMPONENT,
+                                                      gpu::ETexturePixelFormat::DEPTH_COMPONENT,
+                                                      0,
+                                                      FSString{ "SceneDepth" });
+        SceneDepthTexture->Bind();
+        SceneDepthTexture->SetMinFilter(gpu::EMinTextureFilter::NEAREST);
+        SceneDepthTexture->SetMagFilter(gpu::EMagTextureFilter::NEAREST);
+        SceneDepthTexture->SetWrapSFilter(gpu::EWrapTextureFilter::CLAMP_TO_EDGE);
+        SceneDepthTexture->SetWrapTFilter(gpu::EWrapTextureFilter::CLAMP_TO_EDGE);
 
         // Attach it to the lighting pass framebuffer
         LightingPassFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
-        LightingPassFramebuffer->SetupDepthStencilAttachment(DepthStencilRenderBuffer);
+        LightingPassFramebuffer->SetupDepthAttachment(SceneDepthTexture);
 
         LightingPassColorBuffers = new gpu::CTexture*[NumFrameBuffers];
         FrameResultTextures      = new gpu::CTexture*[NumFrameBuffers];
@@ -315,14 +467,56 @@ namespace lucid::scene
         CurrentFrameVSNormalMap->SetMinFilter(gpu::EMinTextureFilter::NEAREST);
         CurrentFrameVSNormalMap->SetMagFilter(gpu::EMagTextureFilter::NEAREST);
         PrepassFramebuffer->SetupColorAttachment(0, CurrentFrameVSNormalMap);
+        PrepassFramebuffer->SetupDepthAttachment(SceneDepthTexture);
 
-        CurrentFrameVSPositionMap->Bind();
-        CurrentFrameVSPositionMap->SetMinFilter(gpu::EMinTextureFilter::NEAREST);
-        CurrentFrameVSPositionMap->SetMagFilter(gpu::EMagTextureFilter::NEAREST);
-        PrepassFramebuffer->SetupColorAttachment(1, CurrentFrameVSPositionMap);
-
-        DepthStencilRenderBuffer->Bind();
-        PrepassFramebuffer->SetupDepthStencilAttachment(DepthStencilRenderBuffer);
+        // Create the Hi-Z buffer used for occlusion culling in GPU-driven mode
+        HiZTexture = gpu::CreateEmpty2DTexture(ResultResolution.x,
+                                               ResultResolution.y,
+                                               gpu::ETextureDataType::FLOAT,
+                                               gpu::ETextureDataFormat::R32F,
+                                               gpu::ETexturePixelFormat::RED,
+                                               0,
+                                               FSString{ "HiZ" });
+        HiZTexture->Bind();
+        HiZTexture->SetMinFilter(gpu::EMinTextureFilter::NEAREST_MIPMAP_NEAREST);
+        HiZTexture->SetMagFilter(gpu::EMagTextureFilter::NEAREST);
+        HiZTexture->GenerateMipMaps();
+        HiZNumMips = 1 + (u8)floorf(log2f((float)std::max(ResultResolution.x, ResultResolution.y)));
+
+        // Create the half resolution depth chain and the history textures used by the half resolution SSAO
+        const glm::uvec2 HalfResolution = (ResultResolution + 1u) / 2u;
+
+        SSAODepthChain = gpu::CreateEmpty2DTexture(HalfResolution.x,
+                                                   HalfResolution.y,
+                                                   gpu::ETextureDataType::FLOAT,
+                                                   gpu::ETextureDataFormat::R32F,
+                                                   gpu::ETexturePixelFormat::RED,
+                                                   0,
+                                                   FSString{ "SSAODepthChain" });
+        SSAODepthChain->Bind();
+        SSAODepthChain->SetMinFilter(gpu::EMinTextureFilter::NEAREST_MIPMAP_NEAREST);
+        SSAODepthChain->SetMagFilter(gpu::EMagTextureFilter::NEAREST);
+        SSAODepthChain->SetWrapSFilter(gpu::EWrapTextureFilter::CLAMP_TO_EDGE);
+        SSAODepthChain->SetWrapTFilter(gpu::EWrapTextureFilter::CLAMP_TO_EDGE);
+        SSAODepthChain->GenerateMipMaps();
+        SSAODepthChainNumMips = 1 + (u8)floorf(log2f((float)std::max(HalfResolution.x, HalfResolution.y)));
+
+        for (u8 i = 0; i < 2; ++i)
+        {
+            SSAOHistory[i] = gpu::CreateEmpty2DTexture(HalfResolution.x,
+                                                       HalfResolution.y,
+                                                       gpu::ETextureDataType::FLOAT,
+                                                       gpu::ETextureDataFormat::RG16F,
+                                                       gpu::ETexturePixelFormat::RG,
+                                                       0,
+                                                       FSString{ "SSAOHistory" });
+            SSAOHistory[i]->Bind();
+            SSAOHistory[i]->SetMinFilter(gpu::EMinTextureFilter::LINEAR);
+            SSAOHistory[i]->SetMagFilter(gpu::EMagTextureFilter::LINEAR);
+            SSAOHistory[i]->SetWrapSFilter(gpu::EWrapTextureFilter::CLAMP_TO_EDGE);
+            SSAOHistory[i]->SetWrapTFilter(gpu::EWrapTextureFilter::CLAMP_TO_EDGE);
+        }
+        bSSAOHistoryValid = false;
 
         // Create texture to store SSO result
         SSAOResult = gpu::CreateEmpty2DTexture(ResultResolution.x,
@@ -365,30 +559,9 @@ namespace lucid::scene
 
         // Setup the SSAO shader
         SSAOShader->Use();
-        SSAOShader->UseTexture(SSAO_POSITIONS_VS, CurrentFrameVSPositionMap);
+        SSAOShader->UseTexture(SCENE_DEPTH, SceneDepthTexture);
         SSAOShader->UseTexture(SSAO_NORMALS_VS, CurrentFrameVSNormalMap);
-
-        // Sample vectors
-        for (int i = 0; i < RendererSettings.NumSSAOSamples; ++i)
-        {
-            glm::vec3 Sample = math::RandomVec3();
-
-            // Transform x and y to [-1, 1], keep z [0, 1] so the we sample around a hemisphere
-            Sample.x = Sample.x * 2.0 - 1.0;
-            Sample.y = Sample.y * 2.0 - 1.0;
-            Sample   = glm::normalize(Sample);
-            Sample *= math::RandomFloat();
-
-            // Use an accelerating interpolation function so there are more samples close to the fragment
-            float Scale = (float)i / (float)RendererSettings.NumSSAOSamples;
-            Scale       = math::Lerp(0.1, 1.0f, Scale * Scale);
-            Sample *= Scale;
-
-            // Send the sample to the shader
-            FDString SampleUniformName = SPrintf(LUCID_TEXT("uSamples[%d]"), i);
-            SSAOShader->SetVector(SampleUniformName, Sample);
-            SampleUniformName.Free();
-        }
+        SetupSSAOKernel(SSAOShader, RendererSettings.NumSSAOSamples);
 
         // Noise
         glm::vec2 Noise[16];
@@ -407,6 +580,10 @@ namespace lucid::scene
         SSAOShader->UseTexture(SSAO_NOISE, SSAONoise);
         SSAOShader->SetFloat(SSAO_RADIUS, RendererSettings.SSAORadius);
 
+        // The half resolution SSAO uses a smaller kernel, it's rotated differently every frame instead of using the noise texture
+        SSAOHalfResShader->Use();
+        SetupSSAOKernel(SSAOHalfResShader, NUM_HALF_RES_SSAO_SAMPLES);
+
         // Fame data buffers fences
         for (u8 i = 0; i < FRAME_DATA_BUFFERS_COUNT; ++i)
         {
@@ -461,6 +638,63 @@ namespace lucid::scene
             InstanceDataMappedPtr = (char*)InstanceDataSSBO->MemoryMap(COHERENT_WRITE);
         }
 
+        {
+            // Culled instance data buffer, written only by the GPU so it doesn't have to be multi-buffered
+            gpu::FBufferDescription BufferDesc;
+            BufferDesc.Data   = nullptr;
+            BufferDesc.Offset = 0;
+            BufferDesc.Size   = INSTANCE_DATA_BUFFER_SIZE;
+
+            CulledInstanceDataSSBO = gpu::CreateBuffer(BufferDesc, gpu::EBufferUsage::DYNAMIC_DRAW, "CulledInstanceDataSSBO");
+        }
+
+        {
+            // Results of the first occlusion culling phase and the draw commands of the second one, also written only by the GPU
+            gpu::FBufferDescription BufferDesc;
+            BufferDesc.Data   = nullptr;
+            BufferDesc.Offset = 0;
+            BufferDesc.Size   = MAX_INSTANCES * sizeof(u32);
+
+            OccludedInstancesSSBO = gpu::CreateBuffer(BufferDesc, gpu::EBufferUsage::DYNAMIC_DRAW, "OccludedInstancesSSBO");
+
+            BufferDesc.Size               = DRAW_COMMANDS_BUFFER_SIZE;
+            DisoccludedDrawCommandsBuffer = gpu::CreateBuffer(BufferDesc, gpu::EBufferUsage::DYNAMIC_DRAW, "DisoccludedDrawCommandsBuffer");
+        }
+
+        {
+            // Indirect draw commands buffers
+            gpu::FBufferDescription BufferDesc;
+            BufferDesc.Data   = nullptr;
+            BufferDesc.Offset = 0;
+            BufferDesc.Size   = DRAW_COMMANDS_BUFFER_SIZE * FRAME_DATA_BUFFERS_COUNT;
+
+            DrawCommandsBuffer = gpu::CreateImmutableBuffer(BufferDesc, COHERENT_WRITE_USAGE, "DrawCommandsBuffer");
+            DrawCommandsBuffer->Bind(gpu::EBufferBindPoint::WRITE);
+            DrawCommandsMappedPtr = (char*)DrawCommandsBuffer->MemoryMap(COHERENT_WRITE);
+        }
+
+        {
+            // Light buffers
+            gpu::FBufferDescription BufferDesc;
+            BufferDesc.Data   = nullptr;
+            BufferDesc.Offset = 0;
+            BufferDesc.Size   = LIGHTS_DATA_BUFFER_SIZE * FRAME_DATA_BUFFERS_COUNT;
+
+            LightsDataSSBO = gpu::CreateImmutableBuffer(BufferDesc, COHERENT_WRITE_USAGE, "LightsDataSSBO");
+            LightsDataSSBO->Bind(gpu::EBufferBindPoint::WRITE);
+            LightsDataMappedPtr = (char*)LightsDataSSBO->MemoryMap(COHERENT_WRITE);
+        }
+
+        {
+            // Cluster light lists, written only by the GPU so they don't have to be multi-buffered
+            gpu::FBufferDescription BufferDesc;
+            BufferDesc.Data   = nullptr;
+            BufferDesc.Offset = 0;
+            BufferDesc.Size   = (NUM_CLUSTERS + (NUM_CLUSTERS * MAX_LIGHTS_PER_CLUSTER)) * sizeof(u32);
+
+            ClusterLightsSSBO = gpu::CreateBuffer(BufferDesc, gpu::EBufferUsage::DYNAMIC_DRAW, "ClusterLightsSSBO");
+        }
+
 #if DEVELOPMENT
 
         // Light bulbs
@@ -522,23 +756,18 @@ namespace lucid::scene
 
         EditorHelpersFramebuffer->IsComplete();
 
-        CachedHitMap.Width  = ResultResolution.x;
-        CachedHitMap.Height = ResultResolution.y;
-        // @Note doesn't get freed, but it's probably okay as it should die with the editor
-        CachedHitMap.CachedTextureData = (u32*)malloc(HitMapTexture->GetSizeInBytes());
-        Zero(CachedHitMap.CachedTextureData, HitMapTexture->GetSizeInBytes());
-
-        CachedDistanceToCameraMap.Width  = ResultResolution.x;
-        CachedDistanceToCameraMap.Height = ResultResolution.y;
-        // @Note doesn't get freed, but it's probably okay as it should die with the editor
-        CachedDistanceToCameraMap.CachedTextureData = (float*)malloc(DistanceToCameraTexture->GetSizeInBytes()); //
-        Zero(CachedDistanceToCameraMap.CachedTextureData, DistanceToCameraTexture->GetSizeInBytes());
-
-        HitmapReadPBO       = gpu::CreatePixelBuffer("HitmapReadPixelBuffer_0", HitMapTexture->GetSizeInBytes());
-        DistanceToCameraPBO = gpu::CreatePixelBuffer("DistanceToCameraReadPixelBuffer_0", HitMapTexture->GetSizeInBytes());
+        // Only the picked pixel is read back
+        HitmapReadPBO       = gpu::CreatePixelBuffer("HitmapReadPixelBuffer_0", sizeof(u32));
+        DistanceToCameraPBO = gpu::CreatePixelBuffer("DistanceToCameraReadPixelBuffer_0", sizeof(float));
+        bPickReadInFlight   = false;
 
         // Timer
         FrameTimer = gpu::CreateTimer("FameTimer");
+        for (u8 i = 0; i < MAX_RENDER_PASS_STATS; ++i)
+        {
+            FDString TimerName = SPrintf("PassTimer_%d", i);
+            PassTimers[i]      = gpu::CreateTimer(TimerName);
+        }
 
         // Debug lines
         DebugLinesPipelineState.IsDepthTestEnabled       = true;
@@ -586,49 +815,71 @@ namespace lucid::scene
     void CForwardRenderer::Cleanup()
     {
         assert(0); // @TODO Implement this properly!
+
+        // Shadow maps get new tiles once the atlases are recreated in Setup()
+        for (u32 i = 0; i < arrlen(CreatedShadowMaps); ++i)
+        {
+            CreatedShadowMaps[i]->ReleaseTiles();
+        }
+
+        ShadowAtlas->Free();
+        CubeShadowAtlas->Free();
+        delete ShadowAtlas;
+        delete CubeShadowAtlas;
+        ShadowAtlas     = nullptr;
+        CubeShadowAtlas = nullptr;
+
         if (CurrentFrameVSNormalMap)
         {
             CurrentFrameVSNormalMap->Free();
             delete CurrentFrameVSNormalMap;
         }
 
-        if (CurrentFrameVSPositionMap)
+        if (SceneDepthTexture)
         {
-            CurrentFrameVSPositionMap->Free();
-            delete CurrentFrameVSPositionMap;
+            SceneDepthTexture->Free();
+            delete SceneDepthTexture;
         }
-    }
 
-    void CForwardRenderer::Render(FRenderScene* InSceneToRender, const FRenderView* InRenderView)
-    {
-        for (u32 i = 0; i < InSceneToRender->StaticMeshes.GetLength(); ++i)
+        if (SSAODepthChain)
         {
-            InSceneToRender->StaticMeshes.GetByIndex(i)->CalculateModelMatrix();
+            SSAODepthChain->Free();
+            delete SSAODepthChain;
         }
 
-        for (u32 i = 0; i < InSceneToRender->Terrains.GetLength(); ++i)
+        for (gpu::CTexture* History : SSAOHistory)
         {
-            InSceneToRender->Terrains.GetByIndex(i)->CalculateModelMatrix();
+            if (History)
+            {
+                History->Free();
+                delete History;
+            }
         }
+    }
 
+    void CForwardRenderer::Render(FRenderScene* InSceneToRender, const FRenderView* InRenderView)
+    {
         SkyboxPipelineState.Viewport = LightpassPipelineState.Viewport = PrepassPipelineState.Viewport = InRenderView->Viewport;
 
         ++GRenderStats.FrameNumber;
 
 #if DEVELOPMENT
+        const double RenderStartTime = platform::GetPreciseTimeMiliseconds();
+
         GRenderStats.NumDrawCalls = 0;
+        GRenderStats.NumPasses    = 0;
         FrameTimer->StartTimer();
 
         switch (CurrentDebugDebugType)
         {
         case SSAO:
-            SelectedDebugTexture = SSAOResult;
+            SelectedDebugTexture = RendererSettings.bHalfResSSAO ? SSAOBlurred : SSAOResult;
             break;
         case NORMALS:
             SelectedDebugTexture = CurrentFrameVSNormalMap;
             break;
-        case POSITIONS:
-            SelectedDebugTexture = CurrentFrameVSPositionMap;
+        case DEPTH:
+            SelectedDebugTexture = SceneDepthTexture;
             break;
         case LIGHTING:
             SelectedDebugTexture = FrameResultTextures[GRenderStats.FrameNumber % NumFrameBuffers];
@@ -656,43 +907,90 @@ namespace lucid::scene
 
         // Check if any of the material buffer entries can be returned to the pool
         {
-            std::vector<FFreeMaterialBufferEntries> EntriesStillInUse;
-            for (FFreeMaterialBufferEntries& FreeEntries : FreeMaterialBuffersEntries)
+            // Removed in place, so it doesn't allocate a new vector every frame
+            const auto RemovedIt = std::remove_if(
+              FreeMaterialBuffersEntries.begin(), FreeMaterialBuffersEntries.end(), [&](FFreeMaterialBufferEntries& FreeEntries) {
+                  if (!FreeEntries.Fence->Wait(0))
+                  {
+                      return false;
+                  }
+
+                  FMaterialDataBuffer& MaterialBuffer = MaterialDataBufferPerMaterialType[FreeEntries.MaterialType];
+                  MaterialBuffer.FreeIndices.insert(MaterialBuffer.FreeIndices.end(), FreeEntries.Indices.begin(), FreeEntries.Indices.end());
+                  FreeEntries.Fence->Free();
+                  delete FreeEntries.Fence;
+                  return true;
+              });
+            FreeMaterialBuffersEntries.erase(RemovedIt, FreeMaterialBuffersEntries.end());
+        }
+
+        SetupGlobalRenderData(InRenderView);
+
+        // Cascades have to be calculated before batching, so we know which geometry has to be batched for each of them
+        for (auto& CascadeShadowCasters : CascadeShadowCastersByLightId)
+        {
+            for (auto& It : CascadeShadowCasters)
             {
-                if (FreeEntries.Fence->Wait(0))
-                {
-                    FMaterialDataBuffer& MaterialBuffer = MaterialDataBufferPerMaterialType[FreeEntries.MaterialType];
-                    MaterialBuffer.FreeIndices.insert(MaterialBuffer.FreeIndices.end(), FreeEntries.Indices.begin(), FreeEntries.Indices.end());
-                    FreeEntries.Fence->Free();
-                    delete FreeEntries.Fence;
-                }
-                else
-                {
-                    EntriesStillInUse.push_back(FreeEntries);
-                }
+                It.second.clear();
             }
-            FreeMaterialBuffersEntries = EntriesStillInUse;
         }
 
-        SetupGlobalRenderData(InRenderView);
-        CreateMeshBatches(InSceneToRender);
+        for (u32 i = 0; i < InSceneToRender->DirectionalLights.GetLength(); ++i)
+        {
+            CDirectionalLight* DirectionalLight = InSceneToRender->DirectionalLights.GetByIndex(i);
+            if (DirectionalLight->bCastsShadow)
+            {
+                CalculateCascades(DirectionalLight, InSceneToRender, InRenderView->Camera);
+            }
+        }
+
+#if DEVELOPMENT
+        // The benchmark measures one point shadow mode per frame
+        if (BenchmarkedPointShadowMode >= 0)
+        {
+            RendererSettings.PointShadowMode = (EPointShadowMode)BenchmarkedPointShadowMode;
+        }
+#endif
+
+        UpdateShadowAtlases(InSceneToRender, InRenderView);
+
+        CreateMeshBatches(InSceneToRender, InRenderView->Camera);
+        DrawCommandsBuffer->Bind(gpu::EBufferBindPoint::DRAW_INDIRECT);
+
+        if (RendererSettings.bGPUDrivenRendering)
+        {
+            BeginRenderPass("Culling");
+            CullMeshBatches(InRenderView);
+            EndRenderPass();
+        }
+
+        BeginRenderPass("Light clustering");
+        SetupLightsData(InSceneToRender);
+        AssignLightsToClusters(InRenderView);
+        EndRenderPass();
 
         gpu::SetViewport(InRenderView->Viewport);
 
-        gpu::PushDebugGroup("Shadow maps generation");
+        BeginRenderPass("Shadow maps generation");
         GenerateShadowMaps(InSceneToRender, InRenderView->Camera);
-        gpu::PopDebugGroup();
+#if DEVELOPMENT
+        if (BenchmarkedPointShadowMode >= 0)
+        {
+            BenchmarkPointShadowMaps();
+        }
+#endif
+        EndRenderPass();
 
-        gpu::PushDebugGroup("Prepass");
+        BeginRenderPass("Prepass");
         Prepass(InSceneToRender, InRenderView);
-        gpu::PopDebugGroup();
+        EndRenderPass();
 
-        gpu::PushDebugGroup("Lighting pass");
+        BeginRenderPass("Lighting pass");
         LightingPass(InSceneToRender, InRenderView);
-        gpu::PopDebugGroup();
+        EndRenderPass();
 
 #if DEVELOPMENT
-        gpu::PushDebugGroup("Editor primitives");
+        BeginRenderPass("Editor primitives");
 
         if (RendererSettings.bDrawGrid)
         {
@@ -713,14 +1011,19 @@ namespace lucid::scene
         RenderEditorHelpers(InSceneToRender, InRenderView);
         gpu::PopDebugGroup();
 
-        gpu::PopDebugGroup();
+        EndRenderPass();
 #endif
 
-        gpu::PushDebugGroup("Gamma correction");
+        BeginRenderPass("Gamma correction");
         DoGammaCorrection(LightingPassColorBuffers[GRenderStats.FrameNumber % NumFrameBuffers]);
-        gpu::PopDebugGroup();
+        EndRenderPass();
 #if DEVELOPMENT
+        GRenderStats.CPUTimeMiliseconds   = (float)(platform::GetPreciseTimeMiliseconds() - RenderStartTime);
         GRenderStats.FrameTimeMiliseconds = FrameTimer->EndTimer();
+        for (u8 i = 0; i < GRenderStats.NumPasses; ++i)
+        {
+            GRenderStats.Passes[i].GPUTimeMiliseconds = PassTimers[i]->GetElapsedMiliseconds();
+        }
         RemoveStaleDebugLines();
 #endif
 
@@ -734,13 +1037,6 @@ namespace lucid::scene
         }
 
         NewFreeMaterialBuffersEntries.clear();
-
-        // Put fences for terrain sculpting
-        if (TerrainFenceToCreate)
-        {
-            *TerrainFenceToCreate = gpu::CreateFence("TerrainSculptFence");
-            TerrainFenceToCreate  = nullptr;
-        }
     }
 
     void CForwardRenderer::ResetState()
@@ -768,6 +1064,10 @@ namespace lucid::scene
         MaterialDataBufferPerMaterialType.clear();
         FreeMaterialBuffersEntries.clear();
         NewFreeMaterialBuffersEntries.clear();
+
+        // Cached batches point to the material buffers
+        BatchedInstances.clear();
+        RebuildMeshBatches();
     }
 
     struct FBatchKey
@@ -783,15 +1083,46 @@ namespace lucid::scene
         std::size_t operator()(const FBatchKey& Key) const { return (uintptr_t)(Key.VertexArray) ^ static_cast<u64>(Key.MaterialType); }
     };
 
+    /** Instances of a batch that use the same submesh, each of those groups is drawn with a separate draw command */
+    struct FSubMeshInstances
+    {
+        const resources::FSubMesh* SubMesh = nullptr;
+        FFrameVector<u32>          ActorEntryIndices;
+        FFrameVector<u32>          MaterialEntryIndices;
+
+        FFrameVector<CMaterial*> BatchedMaterials; // this is only needed for the prepass and should be removed
+    };
+
+    /** Only lives while the batches are rebuilt, so it allocates from the frame arena */
     struct FMeshBatchBuilder
     {
-        gpu::CShader*    BatchShader = nullptr;
-        std::vector<u32> ActorEntryIndices;
-        std::vector<u32> MaterialEntryIndices;
+        gpu::CShader*                   BatchShader = nullptr;
+        u32                             BatchSize   = 0;
+        FFrameVector<FSubMeshInstances> SubMeshInstances;
 
-        std::vector<CMaterial*> BatchedMaterials; // this is only needed for the prepass and should be removed
+        FFrameUnorderedMap<const resources::FSubMesh*, u32> SubMeshInstancesIdxBySubMesh;
     };
 
+    /** Fills the geometry part of the draw command, so it draws the submesh's range of the vertex array */
+    static inline void SetDrawCommandGeometry(gpu::FDrawIndirectCommand& OutCommand, const resources::FSubMesh* InSubMesh, const u32& InBaseInstance)
+    {
+        if (InSubMesh->ElementCount)
+        {
+            OutCommand.Count        = InSubMesh->ElementCount;
+            OutCommand.First        = InSubMesh->FirstIndex;
+            OutCommand.BaseVertex   = InSubMesh->BaseVertex;
+            OutCommand.BaseInstance = InBaseInstance;
+        }
+        else
+        {
+            // DrawArraysIndirectCommand has the base instance where the base vertex is
+            OutCommand.Count        = InSubMesh->VertexCount;
+            OutCommand.First        = InSubMesh->BaseVertex;
+            OutCommand.BaseVertex   = InBaseInstance;
+            OutCommand.BaseInstance = 0;
+        }
+    }
+
     FMaterialDataBuffer CForwardRenderer::CreateMaterialBuffer(CMaterial const* InMaterial, const u32& InMaterialBufferSize)
     {
         static gpu::FBufferDescription BufferDesc;
@@ -826,6 +1157,15 @@ namespace lucid::scene
 
     void CForwardRenderer::HandleMaterialBufferUpdateIfNecessary(CMaterial* Material)
     {
+        // Streamed textures were swapped since the material was last drawn, so it's cached handles might point to the old textures
+        bool      bTextureHandlesRefreshed = false;
+        const u32 TextureHandlesGeneration = GEngine.GetTextureStreamer().GetHandlesGeneration();
+        if (Material->TextureHandlesGeneration != TextureHandlesGeneration)
+        {
+            Material->TextureHandlesGeneration = TextureHandlesGeneration;
+            bTextureHandlesRefreshed           = Material->RefreshTextureHandles();
+        }
+
         // Find material data buffer
         if (MaterialDataBufferPerMaterialType.find(Material->GetType()) == MaterialDataBufferPerMaterialType.end())
         {
@@ -912,6 +1252,11 @@ namespace lucid::scene
                 FreeMaterialBuffersEntries = FreeBufferEntries;
             }
         }
+        else if (bTextureHandlesRefreshed)
+        {
+            // Rewritten in place, the old textures stay valid until the frames that might still read the old handles are done
+            Material->SetupShaderBuffer(MaterialBuffer.MappedPtr + (Material->MaterialBufferIndex * Material->GetShaderDataSize()));
+        }
     }
 
     static inline u32 CalculateCurrentBufferOffset(const u32& InBufferSize)
@@ -920,70 +1265,162 @@ namespace lucid::scene
         return BufferIdx * InBufferSize;
     }
 
-    void CForwardRenderer::CreateMeshBatches(FRenderScene* InSceneToRender)
+    void CForwardRenderer::RegisterActor(IActor* InActor)
     {
-        std::unordered_map<FBatchKey, FMeshBatchBuilder, FBatchKeyHash> MeshBatchBuilders;
-        std::unordered_map<EMaterialType, std::vector<FBatchKey>>       BatchKeyPerMaterialType;
-        std::unordered_map<u32, u32>                                    ActorDataIdxByActorId;
+        if (RenderProxyByActorId.find(InActor->ActorId) != RenderProxyByActorId.end())
+        {
+            return;
+        }
 
-        const auto BatchMesh = [&MeshBatchBuilders, &BatchKeyPerMaterialType](
-                                 const FBatchKey& BatchKey, const u32& ActorEntryIndex, const u32& MaterialEntryIndex, CMaterial* Material) -> void {
-            auto& BatchIt = MeshBatchBuilders.find(BatchKey);
+        FActorRenderProxy Proxy;
+        Proxy.Actor = InActor;
 
-            if (BatchIt == MeshBatchBuilders.end())
-            {
-                FMeshBatchBuilder BatchBuilder;
-                BatchBuilder.ActorEntryIndices    = { ActorEntryIndex };
-                BatchBuilder.MaterialEntryIndices = { MaterialEntryIndex };
-                BatchBuilder.BatchShader          = Material->Shader;
-                BatchBuilder.BatchedMaterials     = { Material };
-                MeshBatchBuilders[BatchKey]       = BatchBuilder;
+        if (FreeActorDataSlots.size())
+        {
+            Proxy.ActorDataIdx = FreeActorDataSlots.back();
+            FreeActorDataSlots.pop_back();
+        }
+        else if (NumActorDataSlots < MAX_ACTOR_DATA_SLOTS)
+        {
+            Proxy.ActorDataIdx = NumActorDataSlots++;
+        }
+        else
+        {
+            ReportBufferFull(bActorDataBufferFullReported, "Actor data", MAX_ACTOR_DATA_SLOTS);
+            return;
+        }
 
-                if (BatchKeyPerMaterialType.find(BatchKey.MaterialType) == BatchKeyPerMaterialType.end())
-                {
-                    BatchKeyPerMaterialType[BatchKey.MaterialType] = { BatchKey };
-                }
-                else
-                {
-                    BatchKeyPerMaterialType[BatchKey.MaterialType].push_back(BatchKey);
-                }
-            }
-            else
+        RenderProxyByActorId[InActor->ActorId] = Proxy;
+        MarkActorDirty(InActor);
+    }
+
+    void CForwardRenderer::UnregisterActor(const u32& InActorId)
+    {
+        const auto ProxyIt = RenderProxyByActorId.find(InActorId);
+        if (ProxyIt == RenderProxyByActorId.end())
+        {
+            return;
+        }
+
+        // The slot can be reused right away, batches referencing it are rebuilt as the actor is no longer visible
+        FreeActorDataSlots.push_back(ProxyIt->second.ActorDataIdx);
+        if (ProxyIt->second.NumDirtyFrames)
+        {
+            DirtyActorIds.erase(std::find(DirtyActorIds.begin(), DirtyActorIds.end(), InActorId));
+        }
+
+        RenderProxyByActorId.erase(ProxyIt);
+    }
+
+    void CForwardRenderer::MarkActorDirty(IActor* InActor)
+    {
+        const auto ProxyIt = RenderProxyByActorId.find(InActor->ActorId);
+        if (ProxyIt == RenderProxyByActorId.end())
+        {
+            return;
+        }
+
+        // Each of the frame data buffers has it's own copy of the actor data, so it has to be written to all of them
+        if (ProxyIt->second.NumDirtyFrames == 0)
+        {
+            DirtyActorIds.push_back(InActor->ActorId);
+        }
+        ProxyIt->second.NumDirtyFrames = FRAME_DATA_BUFFERS_COUNT;
+    }
+
+    FActorRenderProxy* CForwardRenderer::GetActorRenderProxy(IActor* InActor)
+    {
+        auto ProxyIt = RenderProxyByActorId.find(InActor->ActorId);
+        if (ProxyIt == RenderProxyByActorId.end())
+        {
+            RegisterActor(InActor);
+            ProxyIt = RenderProxyByActorId.find(InActor->ActorId);
+        }
+        return ProxyIt != RenderProxyByActorId.end() ? &ProxyIt->second : nullptr;
+    }
+
+    void CForwardRenderer::UpdateDirtyActorData()
+    {
+        FActorData* ActorData = (FActorData*)(ActorDataMappedPtr + CalculateCurrentBufferOffset(ACTOR_DATA_BUFFER_SIZE));
+
+        u32 NumStillDirty = 0;
+        for (const u32& ActorId : DirtyActorIds)
+        {
+            FActorRenderProxy& Proxy = RenderProxyByActorId[ActorId];
+            IActor*            Actor = Proxy.Actor;
+
+            // The world updated it's transform hierarchy when the render scene was made. Pending changes aren't applied here,
+            // as that would mark actors dirty while we're iterating over them.
+            const math::FAABB& AABB     = Actor->GetAABB();
+            FActorData&        Entry    = ActorData[Proxy.ActorDataIdx];
+            Entry.ModelMatrix           = Actor->TransformNodeIdx != INVALID_TRANSFORM_NODE
+                                            ? Actor->World->GetTransformHierarchy().GetWorldMatrix(Actor->TransformNodeIdx)
+                                            : Actor->CalculateModelMatrix();
+            Entry.NormalMultiplier      = 1;
+            Entry.ActorId               = ActorId;
+            Entry.BoundsMin             = { AABB.MinXWS, AABB.MinYWS, AABB.MinZWS, 1 };
+            Entry.BoundsMax             = { AABB.MaxXWS, AABB.MaxYWS, AABB.MaxZWS, 1 };
+
+            if (Actor->GetActorType() == EActorType::STATIC_MESH && ((CStaticMesh*)Actor)->bReverseNormals)
             {
-                BatchIt->second.ActorEntryIndices.push_back(ActorEntryIndex);
-                BatchIt->second.MaterialEntryIndices.push_back(MaterialEntryIndex);
-                BatchIt->second.BatchedMaterials.push_back(Material);
+                Entry.NormalMultiplier = -1;
             }
-        };
-
-        u32         ActorDataSize   = 0;
-        const u32   ActorDataOffset = CalculateCurrentBufferOffset(ACTOR_DATA_BUFFER_SIZE);
-        FActorData* ActorData       = (FActorData*)(ActorDataMappedPtr + ActorDataOffset);
 
-        const auto FindActorEntryIndex =
-          [&ActorDataIdxByActorId, &ActorData, &ActorDataSize](const u32& ActorId, const glm::mat4& ModelMatrix, const i8& NormalMultiplier) -> u32 {
-            const auto ActorDataIdxIt = ActorDataIdxByActorId.find(ActorId);
-            if (ActorDataIdxIt == ActorDataIdxByActorId.end())
+            if (--Proxy.NumDirtyFrames > 0)
             {
-                u32 NewIndex                   = ActorDataIdxByActorId.size();
-                ActorDataIdxByActorId[ActorId] = static_cast<u32>(NewIndex);
+                DirtyActorIds[NumStillDirty++] = ActorId;
+            }
+        }
 
-                ActorData->ModelMatrix      = ModelMatrix;
-                ActorData->NormalMultiplier = NormalMultiplier;
-                ActorData->ActorId          = ActorId;
+        DirtyActorIds.resize(NumStillDirty);
+    }
 
-                ActorData += 1;
+    /** Fills the draw command of InNumInstances instances of the submesh, the first one being InFirstInstance */
+    static inline void FillDrawCommand(FGPUDrawCommand&           OutDrawCommand,
+                                       const resources::FSubMesh* InSubMesh,
+                                       const u32&                 InBatchedSoFar,
+                                       const u32&                 InFirstInstance,
+                                       const u32&                 InNumInstances,
+                                       const u32&                 InInstanceCount)
+    {
+        SetDrawCommandGeometry(OutDrawCommand.Command, InSubMesh, InFirstInstance - InBatchedSoFar);
+        OutDrawCommand.Command.InstanceCount = InInstanceCount;
+        OutDrawCommand.FirstInstance         = InFirstInstance;
+        OutDrawCommand.BatchSize             = InNumInstances;
+    }
 
-                ActorDataSize += sizeof(FActorData);
-                assert(ActorDataSize < ACTOR_DATA_BUFFER_SIZE);
+    /** Returns the mesh to draw for the static mesh, the default mesh is drawn until the actor's mesh is streamed in */
+    static inline resources::CMeshResource* GetResidentMeshResource(const CStaticMesh* InStaticMesh)
+    {
+        if (InStaticMesh->MeshResource->GetState() == resources::EResourceState::RESIDENT)
+        {
+            return InStaticMesh->MeshResource;
+        }
 
-                return NewIndex;
-            }
+        resources::CMeshResource* DefaultMesh = GEngine.GetMeshesHolder().GetDefaultResource();
+        return DefaultMesh && DefaultMesh->GetState() == resources::EResourceState::RESIDENT ? DefaultMesh : nullptr;
+    }
 
-            return ActorDataIdxIt->second;
+    void CForwardRenderer::CreateMeshBatches(FRenderScene* InSceneToRender, const CCamera* InCamera)
+    {
+        // Collect the submesh instances visible this frame
+        VisibleInstances.clear();
+
+        const auto AddVisibleInstance = [this](const resources::FSubMesh* SubMesh, CMaterial* Material, const u32& ActorDataIdx) {
+            FBatchedInstance Instance;
+            Instance.SubMesh             = SubMesh;
+            Instance.VertexArray         = SubMesh->VAO;
+            Instance.Material            = Material;
+            Instance.Shader              = Material->Shader;
+            Instance.MaterialBufferIndex = Material->MaterialBufferIndex;
+            Instance.ActorDataIdx        = ActorDataIdx;
+            Instance.BaseVertex          = SubMesh->BaseVertex;
+            Instance.FirstIndex          = SubMesh->FirstIndex;
+            Instance.VertexCount         = SubMesh->VertexCount;
+            Instance.ElementCount        = SubMesh->ElementCount;
+            VisibleInstances.push_back(Instance);
         };
 
-        // Create batch builders for static meshes
         for (u32 i = 0; i < InSceneToRender->StaticMeshes.GetLength(); ++i)
         {
             CStaticMesh* StaticMesh = InSceneToRender->StaticMeshes.GetByIndex(i);
@@ -998,8 +1435,13 @@ namespace lucid::scene
                 continue;
             }
 
-            const u32 ActorDataIdx = FindActorEntryIndex(StaticMesh->ActorId, StaticMesh->CachedModelMatrix, StaticMesh->bReverseNormals ? -1 : 1);
-
+            const FActorRenderProxy* Proxy = GetActorRenderProxy(StaticMesh);
+            if (!Proxy)
+            {
+                continue;
+            }
+            const u32 ActorDataIdx = Proxy->ActorDataIdx;
+
             // Send material updates to GPU
             for (u32 j = 0; j < StaticMesh->GetNumMaterialSlots(); ++j)
             {
@@ -1014,19 +1456,22 @@ namespace lucid::scene
                 HandleMaterialBufferUpdateIfNecessary(Material);
             }
 
-            // Iterate over submeshes and create batch builders
-            for (u32 j = 0; j < StaticMesh->MeshResource->SubMeshes.GetLength(); ++j)
+            resources::CMeshResource* MeshResource = GetResidentMeshResource(StaticMesh);
+            if (MeshResource == nullptr)
             {
-                resources::FSubMesh* SubMesh         = StaticMesh->MeshResource->SubMeshes[j];
-                CMaterial*           SubMeshMaterial = StaticMesh->GetMaterialSlot(SubMesh->MaterialIndex);
+                continue;
+            }
 
-                const FBatchKey BatchKey{ SubMesh->VAO, SubMeshMaterial->GetType() };
+            for (u32 j = 0; j < MeshResource->SubMeshes.GetLength(); ++j)
+            {
+                resources::FSubMesh* SubMesh = MeshResource->SubMeshes[j];
 
-                BatchMesh(BatchKey, ActorDataIdx, SubMeshMaterial->MaterialBufferIndex, SubMeshMaterial);
+                // The default mesh might have more material slots than the actor
+                const u16 MaterialSlot = SubMesh->MaterialIndex < StaticMesh->GetNumMaterialSlots() ? SubMesh->MaterialIndex : 0;
+                AddVisibleInstance(SubMesh, StaticMesh->GetMaterialSlot(MaterialSlot), ActorDataIdx);
             }
         }
 
-        // Create batch builders for terrain
         for (u32 i = 0; i < InSceneToRender->Terrains.GetLength(); ++i)
         {
             CTerrain* Terrain = InSceneToRender->Terrains.GetByIndex(i);
@@ -1036,18 +1481,12 @@ namespace lucid::scene
                 continue;
             }
 
-            const u32 ActorDataIdx = FindActorEntryIndex(Terrain->ActorId, Terrain->CachedModelMatrix, 1);
-
-            // Check if we're currently sculpting this material
-            if (Terrain->bSculpFlushed)
-            {
-                TerrainFenceToCreate   = &Terrain->SculptingVBOFences[Terrain->CurrentSculptingVBOIndex];
-                Terrain->bSculpFlushed = true;
-            }
-            else
+            const FActorRenderProxy* Proxy = GetActorRenderProxy(Terrain);
+            if (!Proxy)
             {
-                TerrainFenceToCreate = nullptr;
+                continue;
             }
+            const u32 ActorDataIdx = Proxy->ActorDataIdx;
 
             // Send material updates to GPU
             CMaterial* TerrainMaterial = Terrain->GetTerrainMaterial();
@@ -1059,22 +1498,319 @@ namespace lucid::scene
 
             HandleMaterialBufferUpdateIfNecessary(TerrainMaterial);
 
-            // Create batch builder for this terrain
-            const FBatchKey BatchKey{ Terrain->GetTerrainMesh()->SubMeshes[0]->VAO, Terrain->GetTerrainMaterial()->GetType() };
-            BatchMesh(BatchKey, ActorDataIdx, Terrain->GetTerrainMaterial()->MaterialBufferIndex, Terrain->GetTerrainMaterial());
+            // Draw the chunks selected for the camera, falls back to the whole mesh if the terrain can't be chunked
+            if (Terrain->UpdateChunks(InCamera))
+            {
+                for (const FTerrainChunk& Chunk : Terrain->GetChunks())
+                {
+                    if (Chunk.bVisible)
+                    {
+                        AddVisibleInstance(&Chunk.SubMesh, TerrainMaterial, ActorDataIdx);
+                    }
+                }
+            }
+            else
+            {
+                AddVisibleInstance(Terrain->GetTerrainMesh()->SubMeshes[0], TerrainMaterial, ActorDataIdx);
+            }
         }
 
-        ActorDataSSBO->BindIndexed(1, gpu::EBufferBindPoint::SHADER_STORAGE, ActorDataSize, ActorDataOffset);
-
-        // Create the batches themselves
-        MeshBatches.clear();
+        // Rebuild the batches only if the visible instances changed since they were last built
+        if (VisibleInstances != BatchedInstances)
+        {
+            std::swap(VisibleInstances, BatchedInstances);
+            RebuildMeshBatches();
+        }
 
-        u32            InstanceDataSize   = 0;
-        u32            TotalBatchedMeshes = 0;
+        const int      BufferIdx          = GRenderStats.FrameNumber % FRAME_DATA_BUFFERS_COUNT;
         const u32      InstanceDataOffset = CalculateCurrentBufferOffset(INSTANCE_DATA_BUFFER_SIZE);
         FInstanceData* InstanceData       = (FInstanceData*)(InstanceDataMappedPtr + InstanceDataOffset);
 
-        // This guarantees batches are sorted by material type
+        if (MainInstanceDataVersions[BufferIdx] != MeshBatchesVersion)
+        {
+            memcpy(InstanceData, MainInstanceData.data(), MainInstanceData.size() * sizeof(FInstanceData));
+            MainInstanceDataVersions[BufferIdx] = MeshBatchesVersion;
+        }
+
+        // Draw commands are copied every frame, as the culling shader overwrites the instance counts in GPU-driven mode
+        FGPUDrawCommand* DrawCommands = (FGPUDrawCommand*)(DrawCommandsMappedPtr + CalculateCurrentBufferOffset(DRAW_COMMANDS_BUFFER_SIZE));
+        memcpy(DrawCommands, MainDrawCommands.data(), MainDrawCommands.size() * sizeof(FGPUDrawCommand));
+
+        if (RendererSettings.bGPUDrivenRendering)
+        {
+            for (u32 i = 0; i < NumMainDrawCommands; ++i)
+            {
+                DrawCommands[i].Command.InstanceCount = 0;
+            }
+        }
+
+        // Shadow caster batches depend on the lights' view of the world, so they're still built every frame after the main instances
+        InstanceData += NumMainInstances;
+
+        u32 InstanceDataSize   = NumMainInstances * sizeof(FInstanceData);
+        u32 TotalBatchedMeshes = NumMainInstances;
+        u32 NumDrawCommands    = NumMainDrawCommands;
+
+        // When the cube face frustums are passed, each caster gets an instance for every cube face it's visible in
+        const auto BatchShadowCasters = [&](const std::vector<IActor*>&     InShadowCasters,
+                                            std::vector<FShadowCasterBatch>& OutShadowCasterBatches,
+                                            const math::FFrustum*            InCubeFaceFrustums = nullptr) -> void {
+            for (auto& It : CasterInstancesByVAO)
+            {
+                for (auto& SubMeshIt : It.second)
+                {
+                    SubMeshIt.second.clear();
+                }
+            }
+
+            u8         CubeFacesMask      = 1;
+            const auto AddCasterInstances = [&](const resources::FSubMesh* InSubMesh, const u32& InActorDataIdx) {
+                std::vector<FShadowCasterInstance>& Instances = CasterInstancesByVAO[InSubMesh->VAO][InSubMesh];
+                for (u32 Face = 0; Face < 6; ++Face)
+                {
+                    if (CubeFacesMask & (1 << Face))
+                    {
+                        Instances.push_back({ InActorDataIdx, Face });
+                    }
+                }
+            };
+
+            for (IActor* ShadowCaster : InShadowCasters)
+            {
+                if (!ShadowCaster->bVisible)
+                {
+                    continue;
+                }
+
+                if (InCubeFaceFrustums)
+                {
+                    CubeFacesMask = 0;
+                    for (u8 Face = 0; Face < 6; ++Face)
+                    {
+                        if (InCubeFaceFrustums[Face].TestAABB(ShadowCaster->GetAABB()))
+                        {
+                            CubeFacesMask |= 1 << Face;
+                        }
+                    }
+
+                    if (CubeFacesMask == 0)
+                    {
+                        continue;
+                    }
+                }
+
+                if (ShadowCaster->GetActorType() == EActorType::STATIC_MESH)
+                {
+                    CStaticMesh* StaticMesh = (CStaticMesh*)ShadowCaster;
+                    if (StaticMesh->MeshResource == nullptr)
+                    {
+                        continue;
+                    }
+
+                    resources::CMeshResource* MeshResource = GetResidentMeshResource(StaticMesh);
+                    if (MeshResource == nullptr)
+                    {
+                        continue;
+                    }
+
+                    const FActorRenderProxy* Proxy = GetActorRenderProxy(StaticMesh);
+                    if (!Proxy)
+                    {
+                        continue;
+                    }
+
+                    const u32 ActorDataIdx = Proxy->ActorDataIdx;
+                    for (u32 j = 0; j < MeshResource->SubMeshes.GetLength(); ++j)
+                    {
+                        const resources::FSubMesh* SubMesh = MeshResource->SubMeshes[j];
+                        AddCasterInstances(SubMesh, ActorDataIdx);
+                    }
+                }
+                else if (ShadowCaster->GetActorType() == EActorType::TERRAIN)
+                {
+                    CTerrain*                Terrain = (CTerrain*)ShadowCaster;
+                    const FActorRenderProxy* Proxy   = GetActorRenderProxy(Terrain);
+                    if (!Proxy)
+                    {
+                        continue;
+                    }
+
+                    const u32 ActorDataIdx = Proxy->ActorDataIdx;
+
+                    // Use all of the chunks last selected for the camera, the ones outside of it's frustum can still cast shadows into it
+                    if (Terrain->CanDrawChunks())
+                    {
+                        for (const FTerrainChunk& Chunk : Terrain->GetChunks())
+                        {
+                            AddCasterInstances(&Chunk.SubMesh, ActorDataIdx);
+                        }
+                    }
+                    else
+                    {
+                        const resources::FSubMesh* TerrainSubMesh = Terrain->GetTerrainMesh()->SubMeshes[0];
+                        AddCasterInstances(TerrainSubMesh, ActorDataIdx);
+                    }
+                }
+            }
+
+            for (const auto& It : CasterInstancesByVAO)
+            {
+                FShadowCasterBatch ShadowCasterBatch;
+                ShadowCasterBatch.MeshVertexArray = It.first;
+                ShadowCasterBatch.BatchedSoFar    = TotalBatchedMeshes;
+                ShadowCasterBatch.DrawCommandIdx  = NumDrawCommands;
+
+                for (const auto& SubMeshIt : It.second)
+                {
+                    if (SubMeshIt.second.empty())
+                    {
+                        continue;
+                    }
+
+                    if (NumDrawCommands == MAX_DRAW_COMMANDS)
+                    {
+                        ReportBufferFull(bDrawCommandsBufferFullReported, "Draw commands", MAX_DRAW_COMMANDS);
+                        break;
+                    }
+
+                    const u32 NumInstances = glm::min((u32)SubMeshIt.second.size(), MAX_INSTANCES - TotalBatchedMeshes);
+                    if (NumInstances < SubMeshIt.second.size())
+                    {
+                        ReportBufferFull(bInstanceDataBufferFullReported, "Instance data", MAX_INSTANCES);
+                        if (NumInstances == 0)
+                        {
+                            break;
+                        }
+                    }
+
+                    FillDrawCommand(
+                      DrawCommands[NumDrawCommands++], SubMeshIt.first, ShadowCasterBatch.BatchedSoFar, TotalBatchedMeshes, NumInstances, NumInstances);
+
+                    ShadowCasterBatch.NumDrawCommands += 1;
+                    ShadowCasterBatch.BatchSize += NumInstances;
+
+                    for (u32 i = 0; i < NumInstances; ++i)
+                    {
+                        // Shadow map shaders don't use the material nor the prepass data, the layered cube shadow map shader reads the face instead of the material
+                        const FShadowCasterInstance& CasterInstance = SubMeshIt.second[i];
+                        InstanceData->ActorDataIdx                  = CasterInstance.ActorDataIdx;
+                        InstanceData->MaterialDataIdx               = CasterInstance.CubeFace;
+                        InstanceData->PrepassDataIdx                = 0;
+
+                        InstanceData += 1;
+                        InstanceDataSize += sizeof(FInstanceData);
+                        ++TotalBatchedMeshes;
+                    }
+                }
+
+                if (ShadowCasterBatch.NumDrawCommands > 0)
+                {
+                    OutShadowCasterBatches.push_back(ShadowCasterBatch);
+                }
+            }
+        };
+
+        for (auto& It : ShadowCasterBatchesByLightId)
+        {
+            It.second.clear();
+        }
+        for (auto& CascadeBatches : CascadeShadowCasterBatchesByLightId)
+        {
+            for (auto& It : CascadeBatches)
+            {
+                It.second.clear();
+            }
+        }
+
+        for (u32 i = 0; i < InSceneToRender->DirectionalLights.GetLength(); ++i)
+        {
+            const CDirectionalLight* DirectionalLight = InSceneToRender->DirectionalLights.GetByIndex(i);
+            if (!DirectionalLight->bCastsShadow)
+            {
+                continue;
+            }
+
+            // Casters for each of the cascades were found in CalculateCascades
+            for (u8 Cascade = 0; Cascade < DirectionalLight->CascadeCount; ++Cascade)
+            {
+                BatchShadowCasters(CascadeShadowCastersByLightId[Cascade][DirectionalLight->ActorId],
+                                   CascadeShadowCasterBatchesByLightId[Cascade][DirectionalLight->ActorId]);
+            }
+        }
+
+        // Casters of the spot and point lights were found in UpdateShadowAtlases, only the shadow maps rendered this frame need them
+        for (const CLight* Light : ShadowMapsToUpdate)
+        {
+            if (Light->GetType() == ELightType::POINT && RendererSettings.PointShadowMode == EPointShadowMode::LAYERED_INSTANCING)
+            {
+                // Each face gets only the casters it can see
+                math::FFrustum CubeFaceFrustums[6];
+                for (u8 Face = 0; Face < 6; ++Face)
+                {
+                    CubeFaceFrustums[Face].ExtractPlanes(((const CPointLight*)Light)->LightSpaceMatrices[Face]);
+                }
+
+                BatchShadowCasters(ShadowCastersByLightId[Light->ActorId], ShadowCasterBatchesByLightId[Light->ActorId], CubeFaceFrustums);
+                continue;
+            }
+
+            BatchShadowCasters(ShadowCastersByLightId[Light->ActorId], ShadowCasterBatchesByLightId[Light->ActorId]);
+        }
+
+        // Shadow casters might have been registered just now, so this has to happen after batching them
+        UpdateDirtyActorData();
+
+        const u32 ActorDataOffset = CalculateCurrentBufferOffset(ACTOR_DATA_BUFFER_SIZE);
+        ActorDataSSBO->BindIndexed(1, gpu::EBufferBindPoint::SHADER_STORAGE, NumActorDataSlots * sizeof(FActorData), ActorDataOffset);
+        InstanceDataSSBO->BindIndexed(2, gpu::EBufferBindPoint::SHADER_STORAGE, InstanceDataSize, InstanceDataOffset);
+    }
+
+    void CForwardRenderer::RebuildMeshBatches()
+    {
+        FFrameUnorderedMap<FBatchKey, FMeshBatchBuilder, FBatchKeyHash> MeshBatchBuilders;
+        FFrameUnorderedMap<EMaterialType, FFrameVector<FBatchKey>>      BatchKeyPerMaterialType;
+
+        for (const FBatchedInstance& Instance : BatchedInstances)
+        {
+            const FBatchKey BatchKey{ Instance.VertexArray, Instance.Material->GetType() };
+
+            auto BatchIt = MeshBatchBuilders.find(BatchKey);
+            if (BatchIt == MeshBatchBuilders.end())
+            {
+                FMeshBatchBuilder BatchBuilder;
+                BatchBuilder.BatchShader = Instance.Shader;
+                BatchIt                  = MeshBatchBuilders.insert({ BatchKey, BatchBuilder }).first;
+                BatchKeyPerMaterialType[BatchKey.MaterialType].push_back(BatchKey);
+            }
+
+            // Meshes sharing the vertex layout share the vertex array, so group the instances by submesh within the batch
+            FMeshBatchBuilder& BatchBuilder       = BatchIt->second;
+            const auto         SubMeshInstancesIt = BatchBuilder.SubMeshInstancesIdxBySubMesh.find(Instance.SubMesh);
+            if (SubMeshInstancesIt == BatchBuilder.SubMeshInstancesIdxBySubMesh.end())
+            {
+                BatchBuilder.SubMeshInstancesIdxBySubMesh[Instance.SubMesh] = BatchBuilder.SubMeshInstances.size();
+                BatchBuilder.SubMeshInstances.push_back(
+                  { Instance.SubMesh, { Instance.ActorDataIdx }, { (u32)Instance.MaterialBufferIndex }, { Instance.Material } });
+            }
+            else
+            {
+                FSubMeshInstances& SubMeshInstances = BatchBuilder.SubMeshInstances[SubMeshInstancesIt->second];
+                SubMeshInstances.ActorEntryIndices.push_back(Instance.ActorDataIdx);
+                SubMeshInstances.MaterialEntryIndices.push_back(Instance.MaterialBufferIndex);
+                SubMeshInstances.BatchedMaterials.push_back(Instance.Material);
+            }
+
+            BatchBuilder.BatchSize += 1;
+        }
+
+        MeshBatches.clear();
+        MainInstanceData.clear();
+        MainDrawCommands.clear();
+
+        // Each group of instances sharing a submesh gets a draw command, commands of a batch are stored one after another so the batch is drawn
+        // with a single multi-draw call. In GPU-driven mode the instance count of the mesh batches' commands is filled by the culling shader.
+        // The base instance is relative to the batch's offset, shaders add it to the instance id when reading the instance data.
+        // Iterating over the material types guarantees batches are sorted by material type.
         for (const auto& It : BatchKeyPerMaterialType)
         {
             for (const auto& BatchKey : It.second)
@@ -1086,99 +1822,315 @@ namespace lucid::scene
 
                 MeshBatch.MeshVertexArray    = BatchKey.VertexArray;
                 MeshBatch.Shader             = BatchBuilder.BatchShader;
-                MeshBatch.BatchedSoFar       = TotalBatchedMeshes;
+                MeshBatch.BatchedSoFar       = MainInstanceData.size();
                 MeshBatch.MaterialDataBuffer = &MaterialDataBufferPerMaterialType[BatchKey.MaterialType];
-                MeshBatch.BatchSize          = BatchBuilder.ActorEntryIndices.size();
-                MeshBatch.BatchedMaterials   = BatchBuilder.BatchedMaterials;
+                MeshBatch.BatchSize          = 0;
+                MeshBatch.DrawCommandIdx     = MainDrawCommands.size();
+                MeshBatch.NumDrawCommands    = 0;
+                MeshBatch.BatchedMaterials.reserve(BatchBuilder.BatchSize);
 
-                // Build batch, write instance data to the gpu
-                for (int i = 0; i < BatchBuilder.ActorEntryIndices.size(); ++i, ++TotalBatchedMeshes)
+                for (const FSubMeshInstances& SubMeshInstances : BatchBuilder.SubMeshInstances)
                 {
-                    //  instance data
-                    InstanceData->ActorDataIdx    = BatchBuilder.ActorEntryIndices[i];
-                    InstanceData->MaterialDataIdx = BatchBuilder.MaterialEntryIndices[i];
+                    const u32 NumInstances = SubMeshInstances.ActorEntryIndices.size();
+
+                    // The instances of a submesh are all skipped, so the materials stay in sync with the instances
+                    if (MainDrawCommands.size() == MAX_DRAW_COMMANDS)
+                    {
+                        ReportBufferFull(bDrawCommandsBufferFullReported, "Draw commands", MAX_DRAW_COMMANDS);
+                        continue;
+                    }
+
+                    if (MainInstanceData.size() + NumInstances > MAX_MAIN_INSTANCES)
+                    {
+                        ReportBufferFull(bInstanceDataBufferFullReported, "Instance data", MAX_MAIN_INSTANCES);
+                        continue;
+                    }
+
+                    MeshBatch.BatchSize += NumInstances;
+                    MeshBatch.NumDrawCommands += 1;
+
+                    MainDrawCommands.push_back({});
+                    FillDrawCommand(MainDrawCommands.back(), SubMeshInstances.SubMesh, MeshBatch.BatchedSoFar, MainInstanceData.size(), NumInstances, NumInstances);
+
+                    MeshBatch.BatchedMaterials.insert(
+                      MeshBatch.BatchedMaterials.end(), SubMeshInstances.BatchedMaterials.begin(), SubMeshInstances.BatchedMaterials.end());
 
-                    InstanceData += 1;
-                    InstanceDataSize += sizeof(FInstanceData);
+                    for (u32 i = 0; i < NumInstances; ++i)
+                    {
+                        FInstanceData InstanceData;
+                        InstanceData.ActorDataIdx    = SubMeshInstances.ActorEntryIndices[i];
+                        InstanceData.MaterialDataIdx = SubMeshInstances.MaterialEntryIndices[i];
+                        InstanceData.PrepassDataIdx  = MainInstanceData.size(); // the prepass writes its data in the same order as the instances
+                        MainInstanceData.push_back(InstanceData);
+                    }
+                }
 
-                    // @TODO handle this case
-                    assert(InstanceDataSize < INSTANCE_DATA_BUFFER_SIZE);
+                if (MeshBatch.NumDrawCommands == 0)
+                {
+                    MeshBatches.pop_back();
                 }
             }
         }
 
-        InstanceDataSSBO->BindIndexed(2, gpu::EBufferBindPoint::SHADER_STORAGE, InstanceDataSize, InstanceDataOffset);
+        NumMainInstances    = MainInstanceData.size();
+        NumMainDrawCommands = MainDrawCommands.size();
 
-    } // namespace lucid::scene
+        // Instance data in all of the frame data buffers is now stale
+        ++MeshBatchesVersion;
+    }
 
-    void CForwardRenderer::GenerateShadowMaps(FRenderScene* InSceneToRender, CCamera* InCamera)
+    void CForwardRenderer::UpdateShadowAtlases(FRenderScene* InSceneToRender, const FRenderView* InRenderView)
     {
-        // Prepare the pipeline state
-        gpu::ConfigurePipelineState(ShadowMapGenerationPipelineState);
+        ShadowMapsToUpdate.clear();
 
-        ShadowMapFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
-        ShadowMapFramebuffer->DisableReadWriteBuffers();
+        // The vectors are cleared instead of the map, so they keep their memory between the frames
+        for (auto& It : ShadowCastersByLightId)
+        {
+            It.second.clear();
+        }
 
-        u8 PrevShadowMapQuality = 255;
+        const glm::vec3 CameraPosition  = InRenderView->Camera->GetPosition();
+        const float     ProjectionScale = InRenderView->Camera->GetProjectionMatrix()[1][1]; // 1 / tan(FOV / 2)
 
-        for (int i = 0; i < InSceneToRender->AllLights.GetLength(); ++i)
+        FFrameVector<CLight*> ShadowedLights;
+        ShadowedLights.reserve(InSceneToRender->AllLights.GetLength());
+        for (u32 i = 0; i < InSceneToRender->AllLights.GetLength(); ++i)
         {
             CLight* Light = InSceneToRender->AllLights.GetByIndex(i);
+            if (!Light->bCastsShadow || !Light->ShadowMap || Light->GetType() == ELightType::DIRECTIONAL)
+            {
+                continue;
+            }
+
+            CShadowMap* ShadowMap = Light->ShadowMap;
+            Light->UpdateLightSpaceMatrix(LightSettingsByQuality[Light->Quality]);
+
+            const bool       bSpotLight  = Light->GetType() == ELightType::SPOT;
+            const float      Radius      = bSpotLight ? ((CSpotLight*)Light)->AttenuationRadius : ((CPointLight*)Light)->AttenuationRadius;
+            const glm::mat4& LightMatrix = bSpotLight ? ((CSpotLight*)Light)->LightSpaceMatrix : ((CPointLight*)Light)->LightSpaceMatrices[0];
+
+            // Projected radius of the light's volume in NDC, the light covers the whole screen when the camera is inside of it
+            const float DistanceToCamera = glm::length(Light->GetTransform().Translation - CameraPosition);
+            ShadowMap->Importance        = DistanceToCamera > Radius ? glm::min(1.f, (Radius * ProjectionScale) / DistanceToCamera) : 1.f;
 
-            if (!Light->bCastsShadow)
+            if (LightMatrix != ShadowMap->CachedLightMatrix)
             {
-                continue; // Light doesn't cast shadows
+                ShadowMap->CachedLightMatrix = LightMatrix;
+                ShadowMap->bNeedsUpdate      = true;
             }
 
-            gpu::PushDebugGroup(*Light->Name);
+            std::vector<IActor*>& ShadowCasters = ShadowCastersByLightId[Light->ActorId];
+            FindLightShadowCasters(InSceneToRender, Light, ShadowCasters);
 
-            // @TODO This should happen only if light moves
-            Light->UpdateLightSpaceMatrix(LightSettingsByQuality[Light->Quality]);
+            // The hash changes when a caster enters or leaves the light's volume, is hidden or it's mesh becomes resident
+            u64 CastersHash = ShadowCasters.size();
+            for (IActor* ShadowCaster : ShadowCasters)
+            {
+                bool bResident = true;
+                if (ShadowCaster->GetActorType() == EActorType::STATIC_MESH)
+                {
+                    const CStaticMesh* StaticMesh = (CStaticMesh*)ShadowCaster;
+                    bResident = StaticMesh->MeshResource && StaticMesh->MeshResource->GetState() == resources::EResourceState::RESIDENT;
+                }
+                CastersHash = (CastersHash * 31) + (ShadowCaster->ActorId << 2) + (ShadowCaster->bVisible << 1) + bResident;
 
-            //@TODO Handle for cascade shadow map
-            // Check if we need to adjust the viewport based on light's shadow map quality
-            if (Light->GetType() == ELightType::DIRECTIONAL && Light->bCastsShadow)
+                // Actors are marked as dirty when they change, e.x. when they move. Dirty actors which weren't written yet have all of the frames left.
+                const auto ProxyIt = RenderProxyByActorId.find(ShadowCaster->ActorId);
+                if (ProxyIt != RenderProxyByActorId.end() && ProxyIt->second.NumDirtyFrames == FRAME_DATA_BUFFERS_COUNT)
+                {
+                    ShadowMap->bNeedsUpdate = true;
+                }
+            }
+
+            if (CastersHash != ShadowMap->CachedCastersHash)
             {
-                CDirectionalLight* DirLight = (CDirectionalLight*)Light;
-                PrevShadowMapQuality        = DirLight->CascadeShadowMaps[0]->GetQuality();
-                gpu::SetViewport({ 0, 0, ShadowMapSizeByQuality[PrevShadowMapQuality].x, ShadowMapSizeByQuality[PrevShadowMapQuality].y });
+                ShadowMap->CachedCastersHash = CastersHash;
+                ShadowMap->bNeedsUpdate      = true;
             }
-            else if (Light->GetType() != ELightType::DIRECTIONAL && Light->ShadowMap->GetQuality() != PrevShadowMapQuality)
+
+            ShadowedLights.push_back(Light);
+        }
+
+        // The most important lights get their tiles first
+        std::sort(ShadowedLights.begin(), ShadowedLights.end(), [](const CLight* InLightA, const CLight* InLightB) {
+            return InLightA->ShadowMap->Importance > InLightB->ShadowMap->Importance;
+        });
+
+        // Release the tiles whose size no longer matches the importance of the light first, so their space can be reused right away
+        FFrameVector<u16> TileSizes(ShadowedLights.size());
+        for (u32 i = 0; i < ShadowedLights.size(); ++i)
+        {
+            CShadowMap*   ShadowMap   = ShadowedLights[i]->ShadowMap;
+            CShadowAtlas* Atlas       = ShadowedLights[i]->GetType() == ELightType::POINT ? CubeShadowAtlas : ShadowAtlas;
+            const u16     MaxTileSize = ShadowMapSizeByQuality[ShadowMap->GetQuality()].x;
+
+            // Each level halves the tile size, the importance is halved with each level as well
+            const float Level = -glm::log2(glm::max(ShadowMap->Importance, 0.0001f));
+            TileSizes[i]      = glm::max((u16)(MaxTileSize >> glm::min((u32)Level, (u32)MAX_SHADOW_TILE_LEVELS)), MIN_SHADOW_ATLAS_TILE_SIZE);
+
+            if (!ShadowMap->HasTiles())
             {
-                PrevShadowMapQuality = Light->ShadowMap->GetQuality();
-                gpu::SetViewport({ 0, 0, ShadowMapSizeByQuality[PrevShadowMapQuality].x, ShadowMapSizeByQuality[PrevShadowMapQuality].y });
+                continue;
             }
 
-            if (Light->GetType() == ELightType::POINT && !RendererSettings.bUseGeometryShaderForShadowMaps)
+            // Don't reallocate the tiles back and forth while the importance hovers around the boundary between two levels
+            const u16   CurrentTileSize = ShadowMap->GetTile(0).Size;
+            const float CurrentLevel    = glm::log2((float)MaxTileSize / CurrentTileSize);
+            if (CurrentTileSize == TileSizes[i] || (Level > (CurrentLevel - SHADOW_TILE_LEVEL_HYSTERESIS) && Level < (CurrentLevel + 1 + SHADOW_TILE_LEVEL_HYSTERESIS)))
             {
-                GeneratePointShadowMapWithoutGS((CPointLight*)Light, InSceneToRender);
-                gpu::PopDebugGroup();
+                TileSizes[i] = CurrentTileSize;
                 continue;
             }
 
-            if (Light->GetType() == ELightType::DIRECTIONAL)
+            // Bigger tiles are allocated only when there's a chance that they'll fit, so the light doesn't lose it's shadows every frame when the atlas is full
+            const u32 NumRequiredTexels = (TileSizes[i] * TileSizes[i] - CurrentTileSize * CurrentTileSize) * ShadowMap->GetNumTiles();
+            if (TileSizes[i] > CurrentTileSize && Atlas->GetNumFreeTexels() < NumRequiredTexels)
             {
-                GenerateCascadeShadowMaps((CDirectionalLight*)Light, InSceneToRender, InCamera);
-                gpu::PopDebugGroup();
+                TileSizes[i] = CurrentTileSize;
                 continue;
             }
 
-            gpu::CShader* CurrentShadowMapShader = Light->GetType() == ELightType::POINT ? ShadowCubeMapShader : ShadowMapShader;
+            ShadowMap->ReleaseTiles();
+        }
 
-            CurrentShadowMapShader->Use();
-            Light->SetupShadowMapShader(CurrentShadowMapShader);
+        for (u32 i = 0; i < ShadowedLights.size(); ++i)
+        {
+            CShadowMap* ShadowMap = ShadowedLights[i]->ShadowMap;
+            if (ShadowMap->HasTiles())
+            {
+                continue;
+            }
 
-            // Setup light's shadow map texture
-            ShadowMapFramebuffer->SetupDepthAttachment(Light->ShadowMap->GetShadowMapTexture());
-            gpu::ClearBuffers(gpu::EGPUBuffer::DEPTH);
+            // Fall back to smaller tiles when the atlas is full, the light doesn't cast shadows if even the smallest ones don't fit
+            CShadowAtlas* Atlas = ShadowedLights[i]->GetType() == ELightType::POINT ? CubeShadowAtlas : ShadowAtlas;
+            for (u16 TileSize = TileSizes[i]; TileSize >= MIN_SHADOW_ATLAS_TILE_SIZE && !ShadowMap->AllocateTiles(Atlas, TileSize); TileSize /= 2)
+            {
+            }
+        }
 
-            // Static geometry
-            for (const FMeshBatch& MeshBatch : MeshBatches)
+        // Lights without shadows until their tiles are rendered go first, then the most important ones.
+        // Partitioned by hand, std::stable_partition allocates a temporary buffer on the heap.
+        {
+            FFrameVector<CLight*> PartitionedLights;
+            PartitionedLights.reserve(ShadowedLights.size());
+            for (CLight* Light : ShadowedLights)
             {
-                MeshBatch.MeshVertexArray->Bind();
-                CurrentShadowMapShader->SetInt(MESH_BATCH_OFFSET, MeshBatch.BatchedSoFar);
-                MeshBatch.MeshVertexArray->DrawInstanced(MeshBatch.BatchSize);
+                if (!Light->ShadowMap->bTilesRendered)
+                {
+                    PartitionedLights.push_back(Light);
+                }
+            }
+            for (CLight* Light : ShadowedLights)
+            {
+                if (Light->ShadowMap->bTilesRendered)
+                {
+                    PartitionedLights.push_back(Light);
+                }
+            }
+            ShadowedLights.swap(PartitionedLights);
+        }
+
+        u32 NumTilesToUpdate = 0;
+        for (CLight* Light : ShadowedLights)
+        {
+            CShadowMap* ShadowMap = Light->ShadowMap;
+
+#if DEVELOPMENT
+            // The benchmark renders the shadow maps of all of the point lights, regardless of the budget
+            if (BenchmarkedPointShadowMode >= 0 && Light->GetType() == ELightType::POINT && ShadowMap->HasTiles())
+            {
+                NumTilesToUpdate += ShadowMap->GetNumTiles();
+                ShadowMapsToUpdate.push_back(Light);
+                continue;
+            }
+#endif
+            if (!ShadowMap->HasTiles() || !ShadowMap->bNeedsUpdate)
+            {
+                continue;
+            }
+
+            // The first one is always updated, so point lights get their shadows even when the budget is smaller than 6 tiles
+            if (NumTilesToUpdate > 0 && (NumTilesToUpdate + ShadowMap->GetNumTiles()) > (u32)RendererSettings.MaxShadowTileUpdatesPerFrame)
+            {
+                continue;
+            }
+
+            NumTilesToUpdate += ShadowMap->GetNumTiles();
+            ShadowMapsToUpdate.push_back(Light);
+        }
+
+#if DEVELOPMENT
+        GRenderStats.NumShadowTilesUpdated = NumTilesToUpdate;
+#endif
+    }
+
+    /** Clears the tile only, the rest of the atlas holds the cached shadow maps of other lights */
+    static inline void ClearShadowAtlasTile(const gpu::FViewport& InTileViewport)
+    {
+        gpu::EnableScissorTest(InTileViewport);
+        gpu::ClearBuffers(gpu::EGPUBuffer::DEPTH);
+        gpu::DisableScissorTest();
+    }
+
+    static inline gpu::FViewport GetShadowAtlasTileViewport(const FShadowAtlasTile& InTile) { return { InTile.X, InTile.Y, InTile.Size, InTile.Size }; }
+
+    void CForwardRenderer::GenerateShadowMaps(FRenderScene* InSceneToRender, CCamera* InCamera)
+    {
+        // Prepare the pipeline state
+        gpu::ConfigurePipelineState(ShadowMapGenerationPipelineState);
+
+        ShadowMapFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
+        ShadowMapFramebuffer->DisableReadWriteBuffers();
+
+        // Cascades follow the camera, so they're rendered every frame
+        for (u32 i = 0; i < InSceneToRender->DirectionalLights.GetLength(); ++i)
+        {
+            CDirectionalLight* DirectionalLight = InSceneToRender->DirectionalLights.GetByIndex(i);
+            if (!DirectionalLight->bCastsShadow)
+            {
+                continue;
+            }
+
+            gpu::PushDebugGroup(*DirectionalLight->Name);
+
+            const u8 ShadowMapQuality = DirectionalLight->CascadeShadowMaps[0]->GetQuality();
+            gpu::SetViewport({ 0, 0, ShadowMapSizeByQuality[ShadowMapQuality].x, ShadowMapSizeByQuality[ShadowMapQuality].y });
+            GenerateCascadeShadowMaps(DirectionalLight);
+
+            gpu::PopDebugGroup();
+        }
+
+        // Shadow maps of the other lights are cached in the atlases, only the ones picked in UpdateShadowAtlases are rendered
+        for (CLight* Light : ShadowMapsToUpdate)
+        {
+            gpu::PushDebugGroup(*Light->Name);
+
+            CShadowMap* ShadowMap = Light->ShadowMap;
+            ShadowMapFramebuffer->SetupDepthAttachment(ShadowMap->GetAtlas()->GetTexture());
+
+            if (Light->GetType() == ELightType::POINT)
+            {
+                GeneratePointShadowMap((CPointLight*)Light);
             }
+            else
+            {
+                const gpu::FViewport TileViewport = GetShadowAtlasTileViewport(ShadowMap->GetTile(0));
+                gpu::SetViewport(TileViewport);
+                ClearShadowAtlasTile(TileViewport);
+
+                ShadowMapShader->Use();
+                Light->SetupShadowMapShader(ShadowMapShader);
+
+                for (const FShadowCasterBatch& ShadowCasterBatch : ShadowCasterBatchesByLightId[Light->ActorId])
+                {
+                    ShadowCasterBatch.MeshVertexArray->Bind();
+                    ShadowMapShader->SetInt(MESH_BATCH_OFFSET, ShadowCasterBatch.BatchedSoFar);
+                    DrawBatch(ShadowCasterBatch.MeshVertexArray, ShadowCasterBatch.NumDrawCommands, ShadowCasterBatch.DrawCommandIdx);
+                }
+            }
+
+            ShadowMap->bNeedsUpdate   = false;
+            ShadowMap->bTilesRendered = true;
 
             gpu::PopDebugGroup();
         }
@@ -1188,6 +2140,12 @@ namespace lucid::scene
     {
         gpu::PushDebugGroup("Prepass");
 
+        // From now on we render from the camera's point of view, so we can use the instances that survived culling
+        if (RendererSettings.bGPUDrivenRendering)
+        {
+            CulledInstanceDataSSBO->BindIndexed(2, gpu::EBufferBindPoint::SHADER_STORAGE, NumMainInstances * sizeof(FInstanceData));
+        }
+
         if (RendererSettings.bEnableDepthPrepass)
         {
             gpu::PushDebugGroup("Depth prepass");
@@ -1205,10 +2163,10 @@ namespace lucid::scene
                     // Advance the pointer
                     PrepassDataPtr += 1;
 
-                    // Add data size
+                    // Add data size, MAX_MAIN_INSTANCES can fill the buffer up to the last entry
                     PrepassDataSize += sizeof(FForwardPrepassUniforms);
 
-                    assert(PrepassDataSize < PREPASS_DATA_BUFFER_SIZE);
+                    assert(PrepassDataSize <= PREPASS_DATA_BUFFER_SIZE);
                 }
             }
 
@@ -1224,188 +2182,499 @@ namespace lucid::scene
             // Bind the SSBO
             PrepassDataSSBO->BindIndexed(3, gpu::EBufferBindPoint::SHADER_STORAGE, PREPASS_DATA_BUFFER_SIZE, PrepassBufferOffset);
 
-            // Issue batches
-            for (const auto& MeshBatch : MeshBatches)
+            // Issue batches
+            for (const auto& MeshBatch : MeshBatches)
+            {
+                PrepassShader->SetInt(MESH_BATCH_OFFSET, MeshBatch.BatchedSoFar);
+                MeshBatch.MeshVertexArray->Bind();
+                DrawBatch(MeshBatch.MeshVertexArray, MeshBatch.NumDrawCommands, MeshBatch.DrawCommandIdx);
+            }
+
+            gpu::PopDebugGroup();
+
+            if (RendererSettings.bGPUDrivenRendering && RendererSettings.bEnableOcclusionCulling)
+            {
+                gpu::PushDebugGroup("Hi-Z");
+                BuildHiZBuffer(InRenderView);
+                gpu::PopDebugGroup();
+
+                // Instances hidden by the previous frame's depth that are visible now would otherwise show up a frame late
+                if (bMainInstancesOcclusionCulled)
+                {
+                    gpu::PushDebugGroup("Disoccluded instances");
+                    CullOccludedMeshBatches();
+
+                    gpu::ConfigurePipelineState(PrepassPipelineState);
+                    PrepassFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
+                    PrepassFramebuffer->SetupDrawBuffers();
+                    PrepassShader->Use();
+
+                    DisoccludedDrawCommandsBuffer->Bind(gpu::EBufferBindPoint::DRAW_INDIRECT);
+                    for (const auto& MeshBatch : MeshBatches)
+                    {
+                        PrepassShader->SetInt(MESH_BATCH_OFFSET, MeshBatch.BatchedSoFar);
+                        MeshBatch.MeshVertexArray->Bind();
+                        MeshBatch.MeshVertexArray->DrawIndirect(
+                          MeshBatch.NumDrawCommands, MeshBatch.DrawCommandIdx * sizeof(FGPUDrawCommand), sizeof(FGPUDrawCommand));
+                    }
+                    DrawCommandsBuffer->Bind(gpu::EBufferBindPoint::DRAW_INDIRECT);
+
+                    // Next frame's first phase has to see the disoccluded instances as well
+                    BuildHiZBuffer(InRenderView);
+                    gpu::PopDebugGroup();
+                }
+            }
+            else
+            {
+                bHiZValid = false;
+            }
+        }
+        else
+        {
+            bHiZValid = false;
+        }
+
+        if (RendererSettings.bEnableDepthPrepass && RendererSettings.bEnableSSAO)
+        {
+            gpu::PushDebugGroup("SSAO");
+
+            if (RendererSettings.bHalfResSSAO)
+            {
+                CalculateHalfResSSAO(InRenderView);
+            }
+            else
+            {
+                // Calculate SSAO
+                const glm::vec2 NoiseTextureSize = { SSAONoise->GetWidth(), SSAONoise->GetHeight() };
+                const glm::vec2 ViewportSize     = { InRenderView->Viewport.Width, InRenderView->Viewport.Height };
+                const glm::vec2 NoiseScale       = ViewportSize / NoiseTextureSize;
+
+                SSAOShader->Use();
+
+                // The half resolution SSAO renders to the same framebuffer
+                SSAOFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
+                SSAOFramebuffer->SetupColorAttachment(0, SSAOResult);
+                gpu::ClearBuffers(COLOR_AND_DEPTH);
+
+                SSAOShader->UseTexture(SCENE_DEPTH, SceneDepthTexture);
+                SSAOShader->UseTexture(SSAO_NORMALS_VS, CurrentFrameVSNormalMap);
+                SSAOShader->UseTexture(SSAO_NOISE, SSAONoise);
+                SSAOShader->SetVector(SSAO_NOISE_SCALE, NoiseScale);
+                SSAOShader->SetFloat(SSAO_BIAS, RendererSettings.SSAOBias);
+                SSAOShader->SetFloat(SSAO_RADIUS, RendererSettings.SSAORadius);
+
+                ScreenWideQuadVAO->Bind();
+                ScreenWideQuadVAO->Draw();
+
+                // Blur SSAO
+                BlurFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
+                BlurFramebuffer->SetupColorAttachment(0, SSAOBlurred);
+
+                gpu::ClearBuffers(gpu::EGPUBuffer::COLOR);
+
+                SimpleBlurShader->Use();
+                SimpleBlurShader->UseTexture(SIMPLE_BLUR_TEXTURE, SSAOResult);
+                SimpleBlurShader->SetInt(SIMPLE_BLUR_OFFSET_X, SimpleBlurXOffset);
+                SimpleBlurShader->SetInt(SIMPLE_BLUR_OFFSET_Y, SimpleBlurYOffset);
+
+                ScreenWideQuadVAO->Bind();
+                ScreenWideQuadVAO->Draw();
+
+                bSSAOHistoryValid = false;
+            }
+
+            gpu::PopDebugGroup();
+        }
+        else
+        {
+            bSSAOHistoryValid = false;
+        }
+        gpu::PopDebugGroup();
+    }
+
+    void CForwardRenderer::LightingPass(const FRenderScene* InSceneToRender, const FRenderView* InRenderView)
+    {
+        // gpu::ConfigurePipelineState(InitialLightLightpassPipelineState);
+        gpu::ConfigurePipelineState(LightpassPipelineState);
+
+        gpu::CTexture* ColorBuffer = LightingPassColorBuffers[GRenderStats.FrameNumber % NumFrameBuffers];
+        ColorBuffer->Bind();
+
+        LightingPassFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
+        LightingPassFramebuffer->SetupColorAttachment(0, ColorBuffer);
+        LightingPassFramebuffer->SetupDrawBuffers();
+
+        if (RendererSettings.bEnableDepthPrepass)
+        {
+            gpu::ClearBuffers(gpu::EGPUBuffer::COLOR);
+        }
+        else
+        {
+            gpu::ClearBuffers(COLOR_AND_DEPTH);
+        }
+
+        // The material shaders write which mips of their textures they need to the texture feedback buffer
+        GEngine.GetTextureStreamer().BeginFeedback(8);
+        RenderStaticMeshes(InSceneToRender, InRenderView);
+        GEngine.GetTextureStreamer().EndFeedback();
+
+        if (InSceneToRender->Skybox)
+        {
+            RenderSkybox(InSceneToRender->Skybox, InRenderView);
+        }
+    }
+
+    void CForwardRenderer::RenderStaticMeshes(const FRenderScene* InScene, const FRenderView* InRenderView)
+    {
+        // The light buffer and the cluster light lists were bound when the lights were assigned to the clusters
+        for (const FMeshBatch& MeshBatch : MeshBatches)
+        {
+            gpu::PushDebugGroup(*MeshBatch.MeshVertexArray->GetName());
+            MeshBatch.Shader->Use();
+            MeshBatch.Shader->SetInt(MESH_BATCH_OFFSET, MeshBatch.BatchedSoFar);
+            MeshBatch.MaterialDataBuffer->GPUBuffer->BindIndexed(3, gpu::EBufferBindPoint::SHADER_STORAGE);
+
+            MeshBatch.MeshVertexArray->Bind();
+            DrawBatch(MeshBatch.MeshVertexArray, MeshBatch.NumDrawCommands, MeshBatch.DrawCommandIdx);
+            gpu::PopDebugGroup();
+        }
+    }
+
+    void CForwardRenderer::SetupGlobalRenderData(const FRenderView* InRenderView)
+    {
+        const u32& BufferOffset = CalculateCurrentBufferOffset(GLOBAL_DATA_BUFFER_SIZE);
+
+        FGlobalRenderData* GlobalRenderData              = (FGlobalRenderData*)(GlobalDataMappedPtr + BufferOffset);
+        GlobalRenderData->AmbientStrength                = RendererSettings.AmbientStrength;
+        GlobalRenderData->NumPCFsamples                  = RendererSettings.NumPCFSamples;
+        GlobalRenderData->uSSAOStrength                  = RendererSettings.SSAOStrength;
+        GlobalRenderData->uSSAOKernelSize                = RendererSettings.SSAOKernelSize;
+        GlobalRenderData->ProjectionMatrix               = InRenderView->Camera->GetProjectionMatrix();
+        GlobalRenderData->ViewMatrix                     = InRenderView->Camera->GetViewMatrix();
+        GlobalRenderData->ViewPos                        = InRenderView->Camera->GetPosition();
+        GlobalRenderData->ParallaxHeightScale            = 0.1f;
+        GlobalRenderData->ViewportSize                   = glm::vec2{ InRenderView->Viewport.Width, InRenderView->Viewport.Height };
+        GlobalRenderData->AmbientOcclusionBindlessHandle = RendererSettings.bEnableSSAO ? SSAOBlurredBindlessHandle : BlankTextureBindlessHandle;
+        GlobalRenderData->NearPlane                      = InRenderView->Camera->GetNearPlane();
+        GlobalRenderData->FarPlane                       = InRenderView->Camera->GetFarPlane();
+        GlobalRenderData->FrameNumber                    = (u32)GRenderStats.FrameNumber;
+
+        GlobalDataUBO->BindIndexed(0, gpu::EBufferBindPoint::UNIFORM, GLOBAL_DATA_BUFFER_SIZE, BufferOffset);
+    }
+
+    void CForwardRenderer::SetupLightsData(const FRenderScene* InSceneToRender)
+    {
+        const u32          BufferOffset = CalculateCurrentBufferOffset(LIGHTS_DATA_BUFFER_SIZE);
+        FLightsDataHeader* Header       = (FLightsDataHeader*)(LightsDataMappedPtr + BufferOffset);
+        FLightData*        LightsData   = (FLightData*)(LightsDataMappedPtr + BufferOffset + sizeof(FLightsDataHeader));
+
+        u32 NumLights         = 0;
+        u32 NumCascadedLights = 0;
+
+        // Directional lights go first, they affect every cluster
+        for (u32 i = 0; i < InSceneToRender->DirectionalLights.GetLength() && NumLights < MAX_LIGHTS; ++i)
+        {
+            const CDirectionalLight* DirectionalLight = InSceneToRender->DirectionalLights.GetByIndex(i);
+            FLightData&              LightData        = LightsData[NumLights++];
+            DirectionalLight->SetupLightData(LightData);
+
+            if (LightData.bCastsShadows)
             {
-                PrepassShader->SetInt(MESH_BATCH_OFFSET, MeshBatch.BatchedSoFar);
-                MeshBatch.MeshVertexArray->Bind();
-                MeshBatch.MeshVertexArray->DrawInstanced(MeshBatch.BatchedMaterials.size());
+                if (NumCascadedLights < MAX_CASCADED_LIGHTS)
+                {
+                    LightData.CascadesIdx = NumCascadedLights;
+                    DirectionalLight->SetupCascadesData(Header->Cascades[NumCascadedLights++]);
+                }
+                else
+                {
+                    LightData.bCastsShadows = false;
+                }
             }
-
-            gpu::PopDebugGroup();
         }
-        if (RendererSettings.bEnableDepthPrepass && RendererSettings.bEnableSSAO)
-        {
-            gpu::PushDebugGroup("SSAO");
+        Header->NumDirectionalLights = NumLights;
 
-            // Calculate SSAO
-            const glm::vec2 NoiseTextureSize = { SSAONoise->GetWidth(), SSAONoise->GetHeight() };
-            const glm::vec2 ViewportSize     = { InRenderView->Viewport.Width, InRenderView->Viewport.Height };
-            const glm::vec2 NoiseScale       = ViewportSize / NoiseTextureSize;
+        for (u32 i = 0; i < InSceneToRender->SpotLights.GetLength() && NumLights < MAX_LIGHTS; ++i)
+        {
+            InSceneToRender->SpotLights.GetByIndex(i)->SetupLightData(LightsData[NumLights++]);
+        }
 
-            SSAOShader->Use();
-            BindAndClearFramebuffer(SSAOFramebuffer);
+        for (u32 i = 0; i < InSceneToRender->PointLights.GetLength() && NumLights < MAX_LIGHTS; ++i)
+        {
+            InSceneToRender->PointLights.GetByIndex(i)->SetupLightData(LightsData[NumLights++]);
+        }
 
-            SSAOShader->UseTexture(SSAO_POSITIONS_VS, CurrentFrameVSPositionMap);
-            SSAOShader->UseTexture(SSAO_NORMALS_VS, CurrentFrameVSNormalMap);
-            SSAOShader->UseTexture(SSAO_NOISE, SSAONoise);
-            SSAOShader->SetVector(SSAO_NOISE_SCALE, NoiseScale);
-            SSAOShader->SetFloat(SSAO_BIAS, RendererSettings.SSAOBias);
-            SSAOShader->SetFloat(SSAO_RADIUS, RendererSettings.SSAORadius);
+        if (NumLights < InSceneToRender->AllLights.GetLength())
+        {
+            LUCID_LOG(ELogLevel::WARN, "Only %d of %d lights fit into the light buffer", NumLights, InSceneToRender->AllLights.GetLength());
+        }
 
-            ScreenWideQuadVAO->Bind();
-            ScreenWideQuadVAO->Draw();
+        Header->NumLights                     = NumLights;
+        Header->ShadowAtlasBindlessHandle     = ShadowAtlas->GetTexture()->GetBindlessHandle();
+        Header->CubeShadowAtlasBindlessHandle = CubeShadowAtlas->GetTexture()->GetBindlessHandle();
 
-            // Blur SSAO
-            BlurFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
-            BlurFramebuffer->SetupColorAttachment(0, SSAOBlurred);
+        LightsDataSSBO->BindIndexed(6, gpu::EBufferBindPoint::SHADER_STORAGE, LIGHTS_DATA_BUFFER_SIZE, BufferOffset);
+    }
 
-            gpu::ClearBuffers(gpu::EGPUBuffer::COLOR);
+    void CForwardRenderer::AssignLightsToClusters(const FRenderView* InRenderView)
+    {
+        ClusterLightsShader->Use();
+        ClusterLightsShader->SetMatrix(CLUSTER_INVERSE_PROJECTION, glm::inverse(InRenderView->Camera->GetProjectionMatrix()));
 
-            SimpleBlurShader->Use();
-            SimpleBlurShader->UseTexture(SIMPLE_BLUR_TEXTURE, SSAOResult);
-            SimpleBlurShader->SetInt(SIMPLE_BLUR_OFFSET_X, SimpleBlurXOffset);
-            SimpleBlurShader->SetInt(SIMPLE_BLUR_OFFSET_Y, SimpleBlurYOffset);
+        ClusterLightsSSBO->BindIndexed(7, gpu::EBufferBindPoint::SHADER_STORAGE);
 
-            ScreenWideQuadVAO->Bind();
-            ScreenWideQuadVAO->Draw();
+        gpu::DispatchCompute((NUM_CLUSTERS + CLUSTER_LIGHTS_GROUP_SIZE - 1) / CLUSTER_LIGHTS_GROUP_SIZE);
 
-            gpu::PopDebugGroup();
-        }
-        gpu::PopDebugGroup();
+        // The light lists are read by the lighting pass
+        gpu::InsertMemoryBarrier(gpu::EMemoryBarrier::SHADER_STORAGE_BARRIER);
     }
 
-    void CForwardRenderer::LightingPass(const FRenderScene* InSceneToRender, const FRenderView* InRenderView)
+    void CForwardRenderer::CullMeshBatches(const FRenderView* InRenderView)
     {
-        // gpu::ConfigurePipelineState(InitialLightLightpassPipelineState);
-        gpu::ConfigurePipelineState(LightpassPipelineState);
+        if (NumMainInstances > 0)
+        {
+            CullMeshBatchesShader->Use();
 
-        gpu::CTexture* ColorBuffer = LightingPassColorBuffers[GRenderStats.FrameNumber % NumFrameBuffers];
-        ColorBuffer->Bind();
+            const math::FFrustum Frustum = InRenderView->Camera->GetFrustum();
+            for (u8 i = 0; i < 6; ++i)
+            {
+                CullMeshBatchesShader->SetVector(CULLING_FRUSTUM_PLANES[i], Frustum.Planes[i]);
+            }
 
-        LightingPassFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
-        LightingPassFramebuffer->SetupColorAttachment(0, ColorBuffer);
-        LightingPassFramebuffer->SetupDrawBuffers();
+            CullMeshBatchesShader->SetUInt(CULLING_PHASE, CULLING_PHASE_FIRST);
+            CullMeshBatchesShader->SetUInt(CULLING_NUM_INSTANCES, NumMainInstances);
+            CullMeshBatchesShader->SetUInt(CULLING_NUM_DRAW_COMMANDS, NumMainDrawCommands);
 
-        if (RendererSettings.bEnableDepthPrepass)
-        {
-            gpu::ClearBuffers(gpu::EGPUBuffer::COLOR);
+            // The Hi-Z buffer was built in the previous frame, so the bounds are projected using the previous frame's matrices
+            bMainInstancesOcclusionCulled = RendererSettings.bEnableOcclusionCulling && bHiZValid;
+            CullMeshBatchesShader->SetBool(CULLING_OCCLUSION_CULLING, bMainInstancesOcclusionCulled);
+            if (bMainInstancesOcclusionCulled)
+            {
+                SetupHiZCullingUniforms();
+            }
+
+            // Actor and instance data were bound in CreateMeshBatches
+            DrawCommandsBuffer->BindIndexed(
+              4, gpu::EBufferBindPoint::SHADER_STORAGE, DRAW_COMMANDS_BUFFER_SIZE, CalculateCurrentBufferOffset(DRAW_COMMANDS_BUFFER_SIZE));
+            CulledInstanceDataSSBO->BindIndexed(5, gpu::EBufferBindPoint::SHADER_STORAGE);
+            OccludedInstancesSSBO->BindIndexed(9, gpu::EBufferBindPoint::SHADER_STORAGE);
+
+            gpu::DispatchCompute((NumMainInstances + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE);
+
+            // Make sure the instance counts and the culled instance data are written before we start drawing
+            gpu::InsertMemoryBarrier((gpu::EMemoryBarrier)(gpu::EMemoryBarrier::COMMAND_BARRIER | gpu::EMemoryBarrier::SHADER_STORAGE_BARRIER));
         }
         else
         {
-            gpu::ClearBuffers(COLOR_AND_DEPTH);
+            bMainInstancesOcclusionCulled = false;
         }
+    }
 
-        RenderStaticMeshes(InSceneToRender, InRenderView);
-        if (InSceneToRender->Skybox)
-        {
-            RenderSkybox(InSceneToRender->Skybox, InRenderView);
-        }
+    void CForwardRenderer::CullOccludedMeshBatches()
+    {
+        CullMeshBatchesShader->Use();
+        CullMeshBatchesShader->SetUInt(CULLING_NUM_INSTANCES, NumMainInstances);
+        CullMeshBatchesShader->SetUInt(CULLING_NUM_DRAW_COMMANDS, NumMainDrawCommands);
+        CullMeshBatchesShader->SetBool(CULLING_OCCLUSION_CULLING, true);
+        SetupHiZCullingUniforms();
+
+        // The prepass reads the culled instances from the instance data binding, but the culling shader needs all of them
+        InstanceDataSSBO->BindIndexed(
+          2, gpu::EBufferBindPoint::SHADER_STORAGE, NumMainInstances * sizeof(FInstanceData), CalculateCurrentBufferOffset(INSTANCE_DATA_BUFFER_SIZE));
+        DrawCommandsBuffer->BindIndexed(
+          4, gpu::EBufferBindPoint::SHADER_STORAGE, DRAW_COMMANDS_BUFFER_SIZE, CalculateCurrentBufferOffset(DRAW_COMMANDS_BUFFER_SIZE));
+        CulledInstanceDataSSBO->BindIndexed(5, gpu::EBufferBindPoint::SHADER_STORAGE);
+        OccludedInstancesSSBO->BindIndexed(9, gpu::EBufferBindPoint::SHADER_STORAGE);
+        DisoccludedDrawCommandsBuffer->BindIndexed(10, gpu::EBufferBindPoint::SHADER_STORAGE);
+
+        // The disoccluded instances are appended after the ones that passed the first phase
+        CullMeshBatchesShader->SetUInt(CULLING_PHASE, CULLING_PHASE_PREPARE_SECOND);
+        gpu::DispatchCompute((NumMainDrawCommands + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE);
+        gpu::InsertMemoryBarrier(gpu::EMemoryBarrier::SHADER_STORAGE_BARRIER);
+
+        CullMeshBatchesShader->SetUInt(CULLING_PHASE, CULLING_PHASE_SECOND);
+        gpu::DispatchCompute((NumMainInstances + CULLING_GROUP_SIZE - 1) / CULLING_GROUP_SIZE);
+        gpu::InsertMemoryBarrier((gpu::EMemoryBarrier)(gpu::EMemoryBarrier::COMMAND_BARRIER | gpu::EMemoryBarrier::SHADER_STORAGE_BARRIER));
+
+        CulledInstanceDataSSBO->BindIndexed(2, gpu::EBufferBindPoint::SHADER_STORAGE, NumMainInstances * sizeof(FInstanceData));
     }
 
-    void CForwardRenderer::RenderStaticMeshes(const FRenderScene* InScene, const FRenderView* InRenderView)
+    void CForwardRenderer::SetupHiZCullingUniforms()
     {
-        if (InScene->AllLights.GetLength() == 0)
-        {
-            RenderLightContribution(nullptr, InScene, InRenderView);
-            return;
-        }
+        CullMeshBatchesShader->UseTexture(HI_Z, HiZTexture);
+        CullMeshBatchesShader->SetMatrix(HI_Z_VIEW_MATRIX, HiZViewMatrix);
+        CullMeshBatchesShader->SetMatrix(HI_Z_PROJECTION_MATRIX, HiZProjectionMatrix);
+        CullMeshBatchesShader->SetFloat(HI_Z_NEAR_PLANE, HiZNearPlane);
+        CullMeshBatchesShader->SetInt(HI_Z_NUM_MIPS, HiZNumMips);
+    }
 
-        for (int i = 0; i < InScene->AllLights.GetLength(); ++i)
+    void CForwardRenderer::BuildHiZBuffer(const FRenderView* InRenderView)
+    {
+        HiZShader->Use();
+
+        // The first mip is made from the depth buffer, each of the following ones is made by downsampling the previous one
+        HiZShader->SetBool(FROM_SCENE_DEPTH, true);
+        HiZShader->SetFloat(NEAR_PLANE, InRenderView->Camera->GetNearPlane());
+        HiZShader->SetFloat(FAR_PLANE, InRenderView->Camera->GetFarPlane());
+        HiZShader->UseTexture(SCENE_DEPTH, SceneDepthTexture);
+        HiZTexture->BindAsImage(1, 0, gpu::EImageAccess::WRITE_ONLY);
+
+        u32 MipWidth  = HiZTexture->GetWidth();
+        u32 MipHeight = HiZTexture->GetHeight();
+        gpu::DispatchCompute((MipWidth + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE, (MipHeight + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE);
+
+        HiZShader->SetBool(FROM_SCENE_DEPTH, false);
+        for (u8 Mip = 1; Mip < HiZNumMips; ++Mip)
         {
-            RenderLightContribution(InScene->AllLights.GetByIndex(i), InScene, InRenderView);
+            gpu::InsertMemoryBarrier(gpu::EMemoryBarrier::SHADER_IMAGE_ACCESS_BARRIER);
+
+            MipWidth  = std::max(1u, MipWidth / 2);
+            MipHeight = std::max(1u, MipHeight / 2);
+
+            HiZTexture->BindAsImage(0, Mip - 1, gpu::EImageAccess::READ_ONLY);
+            HiZTexture->BindAsImage(1, Mip, gpu::EImageAccess::WRITE_ONLY);
+            gpu::DispatchCompute((MipWidth + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE, (MipHeight + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE);
         }
+
+        // The culling shader samples the Hi-Z buffer in the next frame
+        gpu::InsertMemoryBarrier(gpu::EMemoryBarrier::TEXTURE_FETCH_BARRIER);
+
+        HiZViewMatrix       = InRenderView->Camera->GetViewMatrix();
+        HiZProjectionMatrix = InRenderView->Camera->GetProjectionMatrix();
+        HiZNearPlane        = InRenderView->Camera->GetNearPlane();
+        bHiZValid           = true;
     }
 
-    void CForwardRenderer::RenderLightContribution(const CLight* InLight, const FRenderScene* InScene, const FRenderView* InRenderView)
+    void CForwardRenderer::CalculateHalfResSSAO(const FRenderView* InRenderView)
     {
-        if (InLight)
+        // Build the depth chain, the first mip is made from the depth buffer, each of the following ones is made by downsampling the previous one
+        SSAODepthChainShader->Use();
+        SSAODepthChainShader->SetBool(FROM_SCENE_DEPTH, true);
+        SSAODepthChainShader->SetFloat(NEAR_PLANE, InRenderView->Camera->GetNearPlane());
+        SSAODepthChainShader->SetFloat(FAR_PLANE, InRenderView->Camera->GetFarPlane());
+        SSAODepthChainShader->UseTexture(SCENE_DEPTH, SceneDepthTexture);
+        SSAODepthChain->BindAsImage(1, 0, gpu::EImageAccess::WRITE_ONLY);
+
+        u32 MipWidth  = SSAODepthChain->GetWidth();
+        u32 MipHeight = SSAODepthChain->GetHeight();
+        gpu::DispatchCompute((MipWidth + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE, (MipHeight + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE);
+
+        SSAODepthChainShader->SetBool(FROM_SCENE_DEPTH, false);
+        for (u8 Mip = 1; Mip < SSAODepthChainNumMips; ++Mip)
         {
-            gpu::PushDebugGroup(*InLight->Name);
+            gpu::InsertMemoryBarrier(gpu::EMemoryBarrier::SHADER_IMAGE_ACCESS_BARRIER);
+
+            MipWidth  = std::max(1u, MipWidth / 2);
+            MipHeight = std::max(1u, MipHeight / 2);
+
+            SSAODepthChain->BindAsImage(0, Mip - 1, gpu::EImageAccess::READ_ONLY);
+            SSAODepthChain->BindAsImage(1, Mip, gpu::EImageAccess::WRITE_ONLY);
+            gpu::DispatchCompute((MipWidth + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE, (MipHeight + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE);
         }
 
-        for (const FMeshBatch& MeshBatch : MeshBatches)
-        {
-            gpu::PushDebugGroup(*MeshBatch.MeshVertexArray->GetName());
-            MeshBatch.Shader->Use();
-            if (InLight)
-            {
-                InLight->SetupShader(MeshBatch.Shader);
-            }
-            else
-            {
-                MeshBatch.Shader->SetInt(LIGHT_TYPE, NO_LIGHT);
-            }
+        gpu::InsertMemoryBarrier(gpu::EMemoryBarrier::TEXTURE_FETCH_BARRIER);
 
-            MeshBatch.Shader->SetInt(MESH_BATCH_OFFSET, MeshBatch.BatchedSoFar);
-            MeshBatch.MaterialDataBuffer->GPUBuffer->BindIndexed(3, gpu::EBufferBindPoint::SHADER_STORAGE);
+        // Calculate SSAO at half resolution and blend it with the previous frame's result reprojected to the current frame
+        gpu::CTexture* PreviousHistory = SSAOHistory[CurrentSSAOHistory];
+        CurrentSSAOHistory             = (CurrentSSAOHistory + 1) % 2;
+        gpu::CTexture* History         = SSAOHistory[CurrentSSAOHistory];
 
-            MeshBatch.MeshVertexArray->Bind();
-            MeshBatch.MeshVertexArray->DrawInstanced(MeshBatch.BatchedMaterials.size());
-            gpu::PopDebugGroup();
-        }
-        if (InLight)
-        {
-            gpu::PopDebugGroup();
-        }
+        const glm::mat4 ViewMatrix     = InRenderView->Camera->GetViewMatrix();
+        const glm::mat4 ViewProjection = InRenderView->Camera->GetProjectionMatrix() * ViewMatrix;
+
+        gpu::SetViewport({ 0, 0, History->GetWidth(), History->GetHeight() });
+
+        SSAOFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
+        SSAOFramebuffer->SetupColorAttachment(0, History);
+
+        SSAOHalfResShader->Use();
+        SSAOHalfResShader->UseTexture(SSAO_DEPTH_CHAIN, SSAODepthChain);
+        SSAOHalfResShader->UseTexture(SSAO_NORMALS_VS, CurrentFrameVSNormalMap);
+        SSAOHalfResShader->UseTexture(SSAO_HISTORY, PreviousHistory);
+        SSAOHalfResShader->SetFloat(SSAO_BIAS, RendererSettings.SSAOBias);
+        SSAOHalfResShader->SetFloat(SSAO_RADIUS, RendererSettings.SSAORadius);
+        SSAOHalfResShader->SetInt(SSAO_FRAME_INDEX, (i32)(GRenderStats.FrameNumber % 64));
+        SSAOHalfResShader->SetBool(SSAO_HISTORY_VALID, bSSAOHistoryValid);
+        SSAOHalfResShader->SetFloat(SSAO_TEMPORAL_BLEND, RendererSettings.SSAOTemporalBlend);
+        SSAOHalfResShader->SetMatrix(SSAO_VIEW_TO_PREVIOUS_CLIP, SSAOPreviousViewProjection * glm::inverse(ViewMatrix));
+
+        ScreenWideQuadVAO->Bind();
+        ScreenWideQuadVAO->Draw();
+
+        // Upsample the result to full resolution, this replaces the blur
+        gpu::SetViewport(InRenderView->Viewport);
+
+        BlurFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
+        BlurFramebuffer->SetupColorAttachment(0, SSAOBlurred);
+
+        SSAOUpsampleShader->Use();
+        SSAOUpsampleShader->UseTexture(SCENE_DEPTH, SceneDepthTexture);
+        SSAOUpsampleShader->UseTexture(SSAO_HALF_RES, History);
+
+        ScreenWideQuadVAO->Draw();
+
+        SSAOPreviousViewProjection = ViewProjection;
+        bSSAOHistoryValid          = true;
     }
 
-    void CForwardRenderer::BindAndClearFramebuffer(gpu::CFramebuffer* InFramebuffer)
+    inline void CForwardRenderer::DrawBatch(gpu::CVertexArray* InVertexArray, const u32& InNumDrawCommands, const u32& InFirstDrawCommandIdx)
     {
-        InFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
-        gpu::ClearBuffers(COLOR_AND_DEPTH);
+        const u32 DrawCommandsOffset = CalculateCurrentBufferOffset(DRAW_COMMANDS_BUFFER_SIZE) + (InFirstDrawCommandIdx * sizeof(FGPUDrawCommand));
+        InVertexArray->DrawIndirect(InNumDrawCommands, DrawCommandsOffset, sizeof(FGPUDrawCommand));
     }
 
-    void CForwardRenderer::SetupGlobalRenderData(const FRenderView* InRenderView)
+    void CForwardRenderer::GeneratePointShadowMap(CPointLight* InLight)
     {
-        const u32& BufferOffset = CalculateCurrentBufferOffset(GLOBAL_DATA_BUFFER_SIZE);
+        const CShadowMap* ShadowMap = InLight->ShadowMap;
 
-        FGlobalRenderData* GlobalRenderData              = (FGlobalRenderData*)(GlobalDataMappedPtr + BufferOffset);
-        GlobalRenderData->AmbientStrength                = RendererSettings.AmbientStrength;
-        GlobalRenderData->NumPCFsamples                  = RendererSettings.NumPCFSamples;
-        GlobalRenderData->uSSAOStrength                  = RendererSettings.SSAOStrength;
-        GlobalRenderData->uSSAOKernelSize                = RendererSettings.SSAOKernelSize;
-        GlobalRenderData->ProjectionMatrix               = InRenderView->Camera->GetProjectionMatrix();
-        GlobalRenderData->ViewMatrix                     = InRenderView->Camera->GetViewMatrix();
-        GlobalRenderData->ViewPos                        = InRenderView->Camera->GetPosition();
-        GlobalRenderData->ParallaxHeightScale            = 0.1f;
-        GlobalRenderData->ViewportSize                   = glm::vec2{ InRenderView->Viewport.Width, InRenderView->Viewport.Height };
-        GlobalRenderData->AmbientOcclusionBindlessHandle = RendererSettings.bEnableSSAO ? SSAOBlurredBindlessHandle : BlankTextureBindlessHandle;
-        GlobalRenderData->NearPlane                      = InRenderView->Camera->GetNearPlane();
-        GlobalRenderData->FarPlane                       = InRenderView->Camera->GetFarPlane();
+        gpu::FViewport FaceViewports[6];
+        for (u8 Face = 0; Face < 6; ++Face)
+        {
+            FaceViewports[Face] = GetShadowAtlasTileViewport(ShadowMap->GetTile(Face));
+            ClearShadowAtlasTile(FaceViewports[Face]);
+        }
 
-        GlobalDataUBO->BindIndexed(0, gpu::EBufferBindPoint::UNIFORM, GLOBAL_DATA_BUFFER_SIZE, BufferOffset);
-    }
+        const std::vector<FShadowCasterBatch>& ShadowCasterBatches = ShadowCasterBatchesByLightId[InLight->ActorId];
 
-    void CForwardRenderer::GeneratePointShadowMapWithoutGS(CPointLight* InLight, FRenderScene* InRenderScene)
-    {
-        ShadowCubeMapShaderNoGS->Use();
+        if (RendererSettings.PointShadowMode == EPointShadowMode::GEOMETRY_SHADER || RendererSettings.PointShadowMode == EPointShadowMode::LAYERED_INSTANCING)
+        {
+            // Each face has it's own viewport, the geometry shader sends each triangle to all of them,
+            // with layered instancing each instance was batched for a single face that the vertex shader picks
+            gpu::CShader* CubeMapShader =
+              RendererSettings.PointShadowMode == EPointShadowMode::GEOMETRY_SHADER ? ShadowCubeMapShader : ShadowCubeMapShaderLayered;
+            gpu::SetViewports(FaceViewports, 6);
 
-        gpu::CCubemap* ShadowCubeMap = InLight->ShadowMap->GetShadowCubeMapTexture();
+            CubeMapShader->Use();
+            InLight->SetupShadowMapShader(CubeMapShader);
 
-        ShadowCubeMap->Bind();
+            for (const FShadowCasterBatch& ShadowCasterBatch : ShadowCasterBatches)
+            {
+                ShadowCasterBatch.MeshVertexArray->Bind();
+                CubeMapShader->SetInt(MESH_BATCH_OFFSET, ShadowCasterBatch.BatchedSoFar);
+                DrawBatch(ShadowCasterBatch.MeshVertexArray, ShadowCasterBatch.NumDrawCommands, ShadowCasterBatch.DrawCommandIdx);
+            }
+            return;
+        }
 
-        ShadowCubeMapShaderNoGS->SetVector("uLightPosition", InLight->GetTransform().Translation);
+        ShadowCubeMapShaderNoGS->Use();
+        ShadowCubeMapShaderNoGS->SetVector(LIGHT_POSITION, InLight->GetTransform().Translation);
         ShadowCubeMapShaderNoGS->SetFloat(LIGHT_FAR_PLANE, InLight->CachedFarPlane);
 
         for (u8 Face = 0; Face < 6; ++Face)
         {
-            ShadowCubeMapShaderNoGS->SetMatrix("uLightSpaceMatrix", InLight->LightSpaceMatrices[Face]);
-
-            ShadowCubeMap->AttachAsDepth(0, static_cast<gpu::CCubemap::EFace>(Face));
-            gpu::ClearBuffers(gpu::EGPUBuffer::DEPTH);
+            gpu::SetViewport(FaceViewports[Face]);
+            ShadowCubeMapShaderNoGS->SetMatrix(LIGHT_FACE_MATRIX, InLight->LightSpaceMatrices[Face]);
 
-            // Static geometry
-            for (const FMeshBatch& MeshBatch : MeshBatches)
+            // Shadow casters
+            for (const FShadowCasterBatch& ShadowCasterBatch : ShadowCasterBatches)
             {
-                MeshBatch.MeshVertexArray->Bind();
-                ShadowCubeMapShaderNoGS->SetInt(MESH_BATCH_OFFSET, MeshBatch.BatchedSoFar);
-                MeshBatch.MeshVertexArray->DrawInstanced(MeshBatch.BatchSize);
+                ShadowCasterBatch.MeshVertexArray->Bind();
+                ShadowCubeMapShaderNoGS->SetInt(MESH_BATCH_OFFSET, ShadowCasterBatch.BatchedSoFar);
+                DrawBatch(ShadowCasterBatch.MeshVertexArray, ShadowCasterBatch.NumDrawCommands, ShadowCasterBatch.DrawCommandIdx);
             }
         }
     }
 
-    void CForwardRenderer::GenerateCascadeShadowMaps(CDirectionalLight* InLight, const FRenderScene* InRenderScene, CCamera* InCamera)
+    void CForwardRenderer::CalculateCascades(CDirectionalLight* InLight, const FRenderScene* InRenderScene, CCamera* InCamera)
     {
         // Calculate cascade far planes
         {
@@ -1428,24 +2697,16 @@ namespace lucid::scene
             InLight->CascadeFarPlanes[InLight->CascadeCount - 1] = CascadeMaxFarPlane;
         }
 
-        // Generate shadow maps
+        // Calculate cascade matrices and find the geometry inside each cascade
         {
             // Save the camera near and far plane so we can restore them
             // after we generate shadow map for each cascade
             const float CameraNearPlane = InCamera->GetNearPlane();
             const float CameraFarPlane  = InCamera->GetFarPlane();
 
-            CascadeShadowMapShader->Use();
-
             float CascadeNearPlane = InLight->FirstCascadeNearPlane;
             for (u8 i = 0; i < InLight->CascadeCount; ++i)
             {
-                gpu::PushDebugGroup("Cascade");
-
-                // Prepare the depth map
-                ShadowMapFramebuffer->SetupDepthAttachment(InLight->CascadeShadowMaps[i]->GetShadowMapTexture());
-                gpu::ClearBuffers(gpu::EGPUBuffer::DEPTH);
-
                 // Set camera's near and far planes to cascade's near and far plane
                 // so we can get a proper camera frustum aabb to test for objects in the cascade
                 const float CascadeFarPlane = InLight->CascadeFarPlanes[i];
@@ -1508,37 +2769,23 @@ namespace lucid::scene
                 CropMatrix[3][1] = OffsetY;
 
                 InLight->CascadeMatrices[i] = CropMatrix * ProjectionMatrix * ViewMatrix;
-                CascadeShadowMapShader->SetMatrix(LIGHT_SPACE_MATRIX, InLight->CascadeMatrices[i]);
 
                 // Find geometry to render for this cascade
                 FGeometryIntersectionQueryResult QueryResult;
                 FindGeometryOverlappingSweptAABB(InRenderScene, CascadeAABB, -InLight->Direction, QueryResult);
 
-                for (int j = 0; j < QueryResult.StaticMeshes.GetLength(); ++j)
+                std::vector<IActor*>& CascadeShadowCasters = CascadeShadowCastersByLightId[i][InLight->ActorId];
+                for (u32 j = 0; j < QueryResult.StaticMeshes.GetLength(); ++j)
                 {
-                    const CStaticMesh* StaticMesh = *QueryResult.StaticMeshes[j];
-                    CascadeShadowMapShader->SetMatrix(MODEL_MATRIX, StaticMesh->CachedModelMatrix);
-                    for (int SubMesh = 0; SubMesh < StaticMesh->MeshResource->SubMeshes.GetLength(); ++SubMesh)
-                    {
-                        StaticMesh->MeshResource->SubMeshes[SubMesh]->VAO->Bind();
-                        StaticMesh->MeshResource->SubMeshes[SubMesh]->VAO->Draw();
-                    }
+                    CascadeShadowCasters.push_back(*QueryResult.StaticMeshes[j]);
                 }
 
-                for (int j = 0; j < QueryResult.Terrains.GetLength(); ++j)
+                for (u32 j = 0; j < QueryResult.Terrains.GetLength(); ++j)
                 {
-                    const CTerrain* Terrain = *QueryResult.Terrains[j];
-                    CascadeShadowMapShader->SetMatrix(MODEL_MATRIX, Terrain->CachedModelMatrix);
-                    for (int SubMesh = 0; SubMesh < Terrain->GetTerrainMesh()->SubMeshes.GetLength(); ++SubMesh)
-                    {
-                        Terrain->GetTerrainMesh()->SubMeshes[SubMesh]->VAO->Bind();
-                        Terrain->GetTerrainMesh()->SubMeshes[SubMesh]->VAO->Draw();
-                    }
+                    CascadeShadowCasters.push_back(*QueryResult.Terrains[j]);
                 }
 
                 CascadeNearPlane = CascadeFarPlane;
-
-                gpu::PopDebugGroup();
             }
 
             InCamera->SetNearPlane(CameraNearPlane);
@@ -1547,6 +2794,32 @@ namespace lucid::scene
         }
     }
 
+    void CForwardRenderer::GenerateCascadeShadowMaps(CDirectionalLight* InLight)
+    {
+        CascadeShadowMapShader->Use();
+
+        for (u8 i = 0; i < InLight->CascadeCount; ++i)
+        {
+            gpu::PushDebugGroup("Cascade");
+
+            // Prepare the depth map
+            ShadowMapFramebuffer->SetupDepthAttachment(InLight->CascadeShadowMaps[i]->GetShadowMapTexture());
+            gpu::ClearBuffers(gpu::EGPUBuffer::DEPTH);
+
+            CascadeShadowMapShader->SetMatrix(LIGHT_SPACE_MATRIX, InLight->CascadeMatrices[i]);
+
+            // Render the geometry found in CalculateCascades, one draw per vertex array
+            for (const FShadowCasterBatch& ShadowCasterBatch : CascadeShadowCasterBatchesByLightId[i][InLight->ActorId])
+            {
+                ShadowCasterBatch.MeshVertexArray->Bind();
+                CascadeShadowMapShader->SetInt(MESH_BATCH_OFFSET, ShadowCasterBatch.BatchedSoFar);
+                DrawBatch(ShadowCasterBatch.MeshVertexArray, ShadowCasterBatch.NumDrawCommands, ShadowCasterBatch.DrawCommandIdx);
+            }
+
+            gpu::PopDebugGroup();
+        }
+    }
+
     inline void CForwardRenderer::RenderSkybox(const CSkybox* InSkybox, const FRenderView* InRenderView)
     {
         gpu::PushDebugGroup("Skybox");
@@ -1595,11 +2868,44 @@ namespace lucid::scene
 #if DEVELOPMENT
     void CForwardRenderer::RenderEditorHelpers(const FRenderScene* InScene, const FRenderView* InRenderView)
     {
+        // Pick up the result of the previous pick once it's read back, it's not a problem to be 1-2 frames behind with this
+        if (bPickReadInFlight && HitmapReadPBO->IsReady() && DistanceToCameraPBO->IsReady())
+        {
+            LastPickResult.RequestId = PickReadRequestId;
+
+            u32* HitmapPixel       = (u32*)HitmapReadPBO->MapBuffer(gpu::EMapMode::READ_ONLY);
+            LastPickResult.ActorId = *HitmapPixel;
+            HitmapReadPBO->UnmapBuffer();
+
+            float* DistanceToCameraPixel    = (float*)DistanceToCameraPBO->MapBuffer(gpu::EMapMode::READ_ONLY);
+            LastPickResult.DistanceToCamera = *DistanceToCameraPixel;
+            DistanceToCameraPBO->UnmapBuffer();
+
+            bPickReadInFlight = false;
+        }
+
+        // The hitmap is rendered fully only when it's shown as the debug texture
+        const bool bShowHitMap = CurrentDebugDebugType == HITMAP;
+        const bool bPick       = bPickRequested && !bPickReadInFlight;
+        if (!bPick && !bShowHitMap)
+        {
+            return;
+        }
+
+        // Flip the picked pixel, so it's origin is in the lower left corner like in OpenGL
+        const u32 PickX = glm::min(PickPosition.x, HitMapTexture->GetWidth() - 1);
+        const u32 PickY = HitMapTexture->GetHeight() - 1 - glm::min(PickPosition.y, HitMapTexture->GetHeight() - 1);
+
         gpu::ConfigurePipelineState(EditorHelpersPipelineState);
 
         EditorHelpersFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
         EditorHelpersFramebuffer->SetupDrawBuffers();
 
+        if (!bShowHitMap)
+        {
+            gpu::EnableScissorTest({ PickX, PickY, 1, 1 });
+        }
+
         gpu::ClearBuffers((gpu::EGPUBuffer)(gpu::EGPUBuffer::COLOR | gpu::EGPUBuffer::DEPTH));
 
         EditorHelpersShader->Use();
@@ -1609,7 +2915,7 @@ namespace lucid::scene
         {
             MeshBatch.MeshVertexArray->Bind();
             EditorHelpersShader->SetInt(MESH_BATCH_OFFSET, MeshBatch.BatchedSoFar);
-            MeshBatch.MeshVertexArray->DrawInstanced(MeshBatch.BatchedMaterials.size());
+            DrawBatch(MeshBatch.MeshVertexArray, MeshBatch.NumDrawCommands, MeshBatch.DrawCommandIdx);
         }
 
         // Render lights quads
@@ -1633,71 +2939,20 @@ namespace lucid::scene
             ScreenWideQuadVAO->Draw();
         }
 
-        // Get the result
-        if (GRenderStats.FrameNumber == 1)
-        {
-            HitmapReadPBO->AsyncReadPixels(0, 0, 0, HitMapTexture->GetWidth(), HitMapTexture->GetHeight(), EditorHelpersFramebuffer);
-            DistanceToCameraPBO->AsyncReadPixels(1, 0, 0, DistanceToCameraTexture->GetWidth(), DistanceToCameraTexture->GetHeight(), EditorHelpersFramebuffer);
-        }
-        else
+        if (!bShowHitMap)
         {
-            // Check if the previous reads have finished and skip the read if not - it's not a problem to be 1-2 frames behind with this
-
-            if (HitmapReadPBO->IsReady())
-            {
-                // Get the current result
-                char* HitmapPixels = HitmapReadPBO->MapBuffer(gpu::EMapMode::READ_ONLY);
-                memcpy(CachedHitMap.CachedTextureData, HitmapPixels, HitMapTexture->GetSizeInBytes());
-                HitmapReadPBO->UnmapBuffer();
-
-                // Async read the current frame
-                HitmapReadPBO->AsyncReadPixels(0, 0, 0, HitMapTexture->GetWidth(), HitMapTexture->GetHeight(), EditorHelpersFramebuffer);
-            }
-
-            if (DistanceToCameraPBO->IsReady())
-            {
-                // Get the current result
-                char* DistanceToCameraPixelsPixels = DistanceToCameraPBO->MapBuffer(gpu::EMapMode::READ_ONLY);
-                memcpy(CachedDistanceToCameraMap.CachedTextureData, DistanceToCameraPixelsPixels, DistanceToCameraTexture->GetSizeInBytes());
-                DistanceToCameraPBO->UnmapBuffer();
-
-                // Async read the current frame
-                DistanceToCameraPBO->AsyncReadPixels(
-                  1, 0, 0, DistanceToCameraTexture->GetWidth(), DistanceToCameraTexture->GetHeight(), EditorHelpersFramebuffer);
-            }
+            gpu::DisableScissorTest();
         }
-    }
-
-    // @TODO this should handle the batching
-    void CForwardRenderer::RenderWithDefaultMaterial(const resources::CMeshResource* InMeshResource,
-                                                     const u16&                      InSubMeshIndex,
-                                                     const CLight*                   InLight,
-                                                     const FRenderView*              InRenderView,
-                                                     const glm::mat4&                InModelMatrix)
-    {
-        CMaterial* DefaultMaterial = GEngine.GetDefaultMaterial();
-        DefaultMaterial->GetShader()->Use();
 
-        if (InLight)
-        {
-            InLight->SetupShader(DefaultMaterial->GetShader());
-        }
-        else
+        // Read back the picked pixel, the result is picked up in one of the next frames
+        if (bPick)
         {
-            DefaultMaterial->GetShader()->SetInt(LIGHT_TYPE, NO_LIGHT);
-        }
-        DefaultMaterial->GetShader()->SetMatrix(MODEL_MATRIX, InModelMatrix);
-        // DefaultMaterial->SetupShader(DefaultMaterial->GetShader());
+            HitmapReadPBO->AsyncReadPixels(0, PickX, PickY, 1, 1, EditorHelpersFramebuffer);
+            DistanceToCameraPBO->AsyncReadPixels(1, PickX, PickY, 1, 1, EditorHelpersFramebuffer);
 
-        if (InMeshResource)
-        {
-            InMeshResource->SubMeshes[InSubMeshIndex]->VAO->Bind();
-            InMeshResource->SubMeshes[InSubMeshIndex]->VAO->Draw();
-        }
-        else
-        {
-            UnitCubeVAO->Bind();
-            UnitCubeVAO->Draw();
+            PickReadRequestId = LastPickRequestId;
+            bPickReadInFlight = true;
+            bPickRequested    = false;
         }
     }
 
@@ -1775,6 +3030,69 @@ namespace lucid::scene
         DebugLinesVAO->Draw(0, DebugLines.size() * 2);
     }
 
+    void CForwardRenderer::BenchmarkPointShadowMaps()
+    {
+        gpu::ConfigurePipelineState(ShadowMapGenerationPipelineState);
+        ShadowMapFramebuffer->Bind(gpu::EFramebufferBindMode::READ_WRITE);
+        ShadowMapFramebuffer->DisableReadWriteBuffers();
+        ShadowMapFramebuffer->SetupDepthAttachment(CubeShadowAtlas->GetTexture());
+
+        u32 NumPointLights        = 0;
+        u32 NumCasterInstances    = 0;
+        u32 NumCasterDrawCommands = 0;
+        for (const CLight* Light : ShadowMapsToUpdate)
+        {
+            if (Light->GetType() == ELightType::POINT)
+            {
+                ++NumPointLights;
+                for (const FShadowCasterBatch& ShadowCasterBatch : ShadowCasterBatchesByLightId[Light->ActorId])
+                {
+                    NumCasterInstances += ShadowCasterBatch.BatchSize;
+                    NumCasterDrawCommands += ShadowCasterBatch.NumDrawCommands;
+                }
+            }
+        }
+
+        // Wait for the rest of the frame, so only the shadow maps are measured
+        gpu::Finish();
+        const real Start = platform::GetCurrentTimeSeconds();
+
+        for (u32 i = 0; i < POINT_SHADOW_BENCHMARK_ITERATIONS; ++i)
+        {
+            for (CLight* Light : ShadowMapsToUpdate)
+            {
+                if (Light->GetType() == ELightType::POINT)
+                {
+                    GeneratePointShadowMap((CPointLight*)Light);
+                }
+            }
+        }
+
+        gpu::Finish();
+        const real Time = (platform::GetCurrentTimeSeconds() - Start) / POINT_SHADOW_BENCHMARK_ITERATIONS;
+
+        LUCID_LOG(ELogLevel::INFO,
+                  "Point shadows benchmark - %s: %f ms for %d lights, %d caster instances in %d draw commands",
+                  POINT_SHADOW_MODE_NAMES[BenchmarkedPointShadowMode],
+                  Time * 1000.0,
+                  NumPointLights,
+                  NumCasterInstances,
+                  NumCasterDrawCommands);
+
+        ++BenchmarkedPointShadowMode;
+        if (BenchmarkedPointShadowMode == (i8)EPointShadowMode::LAYERED_INSTANCING && !gpu::GGPUInfo.bVertexShaderViewportIndex)
+        {
+            LUCID_LOG(ELogLevel::INFO, "Point shadows benchmark - %s: not supported", POINT_SHADOW_MODE_NAMES[BenchmarkedPointShadowMode]);
+            ++BenchmarkedPointShadowMode;
+        }
+
+        if (BenchmarkedPointShadowMode > (i8)EPointShadowMode::LAYERED_INSTANCING)
+        {
+            BenchmarkedPointShadowMode       = -1;
+            RendererSettings.PointShadowMode = PointShadowModeBeforeBenchmark;
+        }
+    }
+
     bool CForwardRenderer::UIDrawSettingsWindow()
     {
         ImGui::SetNextWindowSize({ 0, 0 });
@@ -1784,8 +3102,51 @@ namespace lucid::scene
             ImGui::DragFloat("Ambient strength", &RendererSettings.AmbientStrength, 0.01, 0, 1);
             ImGui::DragInt("Num PCF samples", &RendererSettings.NumPCFSamples, 1, 0, 64);
             ImGui::Checkbox("Enable SSAO", &RendererSettings.bEnableSSAO);
+            if (RendererSettings.bEnableSSAO)
+            {
+                ImGui::Checkbox("Half resolution SSAO", &RendererSettings.bHalfResSSAO);
+                if (RendererSettings.bHalfResSSAO)
+                {
+                    ImGui::DragFloat("SSAO temporal blend", &RendererSettings.SSAOTemporalBlend, 0.01, 0.01, 1);
+                }
+            }
             ImGui::Checkbox("Draw grid", &RendererSettings.bDrawGrid);
-            ImGui::Checkbox("Use geometry shader for shadow mapping", &RendererSettings.bUseGeometryShaderForShadowMaps);
+            ImGui::Text("Point shadows:");
+            for (u8 Mode = 0; Mode <= (u8)EPointShadowMode::LAYERED_INSTANCING; ++Mode)
+            {
+                if (Mode == (u8)EPointShadowMode::LAYERED_INSTANCING && !gpu::GGPUInfo.bVertexShaderViewportIndex)
+                {
+                    continue;
+                }
+
+                ImGui::SameLine();
+                if (ImGui::RadioButton(POINT_SHADOW_MODE_NAMES[Mode], RendererSettings.PointShadowMode == (EPointShadowMode)Mode))
+                {
+                    RendererSettings.PointShadowMode = (EPointShadowMode)Mode;
+                }
+            }
+            if (BenchmarkedPointShadowMode < 0 && ImGui::Button("Benchmark point shadows"))
+            {
+                PointShadowModeBeforeBenchmark = RendererSettings.PointShadowMode;
+                BenchmarkedPointShadowMode     = 0;
+            }
+            ImGui::DragInt("Shadow tile updates per frame", &RendererSettings.MaxShadowTileUpdatesPerFrame, 1, 1, 64);
+            ImGui::Text("Shadow tiles updated: %d", GRenderStats.NumShadowTilesUpdated);
+
+            resources::CTextureStreamer& TextureStreamer = GEngine.GetTextureStreamer();
+            int                          BudgetMB        = TextureStreamer.VRAMBudget / (1024 * 1024);
+            if (ImGui::DragInt("Texture streaming budget (MB)", &BudgetMB, 8, 0, 16384))
+            {
+                TextureStreamer.VRAMBudget = (u64)BudgetMB * 1024 * 1024;
+            }
+            ImGui::Text("Streamed textures: %d, %.1f MB resident",
+                        TextureStreamer.GetNumStreamedTextures(),
+                        (float)TextureStreamer.GetResidentBytes() / (1024.f * 1024.f));
+            ImGui::Checkbox("GPU-driven rendering", &RendererSettings.bGPUDrivenRendering);
+            if (RendererSettings.bGPUDrivenRendering)
+            {
+                ImGui::Checkbox("Occlusion culling", &RendererSettings.bEnableOcclusionCulling);
+            }
             ImGui::DragInt("SSAO kernel size", &RendererSettings.SSAOKernelSize, 1, 0, 64);
             ImGui::DragInt("SSAO strength", &RendererSettings.SSAOStrength, 1, 0, 32);
             if (ImGui::Checkbox("Depth prepass", &RendererSettings.bEnableDepthPrepass))
@@ -1802,7 +3163,7 @@ namespace lucid::scene
                 }
             }
 
-            static const char* DebugTextureNames[] = { "SSAO", "NORMALS", "WORLD_POSITIONS", "LIGHTING", "HITMAP" };
+            static const char* DebugTextureNames[] = { "SSAO", "NORMALS", "DEPTH", "LIGHTING", "HITMAP" };
             ImGui::Combo("Texture to show", &CurrentDebugDebugType, DebugTextureNames, IM_ARRAYSIZE(DebugTextureNames));
         }
         ImGui::End();
@@ -1831,4 +3192,32 @@ namespace lucid::scene
         ScreenWideQuadVAO->Draw();
     }
 
+    void CForwardRenderer::BeginRenderPass(const char* InName)
+    {
+        gpu::PushDebugGroup(InName);
+
+#if DEVELOPMENT
+        if (GRenderStats.NumPasses < MAX_RENDER_PASS_STATS)
+        {
+            GRenderStats.Passes[GRenderStats.NumPasses].Name = InName;
+            PassFirstDrawCall                                = GRenderStats.NumDrawCalls;
+            PassTimers[GRenderStats.NumPasses]->StartTimer();
+        }
+#endif
+    }
+
+    void CForwardRenderer::EndRenderPass()
+    {
+#if DEVELOPMENT
+        if (GRenderStats.NumPasses < MAX_RENDER_PASS_STATS)
+        {
+            PassTimers[GRenderStats.NumPasses]->StopTimer();
+            GRenderStats.Passes[GRenderStats.NumPasses].NumDrawCalls = GRenderStats.NumDrawCalls - PassFirstDrawCall;
+            ++GRenderStats.NumPasses;
+        }
+#endif
+
+        gpu::PopDebugGroup();
+    }
+
 } // namespace lucid::scene
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "imgui.h"
 #include "platform/fs.hpp"
 #include "platform/platform.hpp"
+#include "resources/texture_resource.hpp"
 
 namespace lucid::scene
 {
@@ -47,6 +48,43 @@ namespace lucid::scene
     }
 #endif
 
+    CMaterial::~CMaterial() { ReleaseTextureFeedbackSlot(); }
+
+    void CMaterial::AcquireTextureFeedbackSlot()
+    {
+        if (TextureFeedbackSlot == resources::CTextureStreamer::INVALID_FEEDBACK_SLOT)
+        {
+            TextureFeedbackSlot = GEngine.GetTextureStreamer().AllocFeedbackSlot(this);
+        }
+    }
+
+    void CMaterial::ReleaseTextureFeedbackSlot()
+    {
+        if (TextureFeedbackSlot != resources::CTextureStreamer::INVALID_FEEDBACK_SLOT)
+        {
+            GEngine.GetTextureStreamer().FreeFeedbackSlot(TextureFeedbackSlot);
+            TextureFeedbackSlot = resources::CTextureStreamer::INVALID_FEEDBACK_SLOT;
+        }
+    }
+
+    bool CMaterial::RefreshBindlessHandle(const resources::CTextureResource* InTexture, u64& InOutBindlessHandle)
+    {
+        // Only the handles that were made resident are refreshed, the streamer made the handles of the new textures resident too
+        if (InTexture == nullptr || InOutBindlessHandle == 0 || InTexture->TextureHandle == nullptr)
+        {
+            return false;
+        }
+
+        const u64 BindlessHandle = InTexture->TextureHandle->GetBindlessHandle();
+        if (BindlessHandle == InOutBindlessHandle)
+        {
+            return false;
+        }
+
+        InOutBindlessHandle = BindlessHandle;
+        return true;
+    }
+
     void CMaterial::SaveToResourceFile(const EFileFormat& InFileFormat)
     {
         if (bIsAsset)
@@ -1,7 +1,9 @@
 #include "scene/render_scene.hpp"
 
+#include "scene/bvh.hpp"
 #include "scene/actors/static_mesh.hpp"
 #include "scene/actors/terrain.hpp"
+#include "scene/actors/lights.hpp"
 
 namespace lucid::scene
 {
@@ -88,23 +90,57 @@ namespace lucid::scene
         OutQueryResult.GeometryAABB.MaxYWS = 0;
         OutQueryResult.GeometryAABB.MaxZWS = 0;
 
-        for (int i = 0; i < Scene->StaticMeshes.GetLength(); ++i)
+        if (Scene->GeometryBVH)
         {
-            CStaticMesh* StaticMesh = Scene->StaticMeshes.GetByIndex(i);
-            if (SweptTestOverlap(AABB, StaticMesh->GetAABB(), SweepDirection))
+            // Use the spatial index, so we also find geometry that was culled from the scene, but can still e.x. cast shadows on it
+            // Reused between the queries so we don't allocate, main thread only
+            static std::vector<IActor*> OverlappingActors;
+            OverlappingActors.clear();
+
+            Scene->GeometryBVH->QuerySweptAABB(AABB, SweepDirection, OverlappingActors);
+            for (IActor* Actor : OverlappingActors)
             {
-                OutQueryResult.StaticMeshes.Add(StaticMesh);
-                OutQueryResult.GeometryAABB.GrowInWorldSpace(StaticMesh->GetAABB());
+                if (!Actor->bVisible)
+                {
+                    continue;
+                }
+
+                if (Actor->GetActorType() == EActorType::STATIC_MESH)
+                {
+                    OutQueryResult.StaticMeshes.Add((CStaticMesh*)Actor);
+                }
+                else if (Actor->GetActorType() == EActorType::TERRAIN)
+                {
+                    OutQueryResult.Terrains.Add((CTerrain*)Actor);
+                }
+                else
+                {
+                    continue;
+                }
+
+                OutQueryResult.GeometryAABB.GrowInWorldSpace(Actor->GetAABB());
             }
         }
-
-        for (int i = 0; i < Scene->Terrains.GetLength(); ++i)
+        else
         {
-            CTerrain* Terrain = Scene->Terrains.GetByIndex(i);
-            if (SweptTestOverlap(Terrain->GetAABB(), AABB, SweepDirection))
+            for (int i = 0; i < Scene->StaticMeshes.GetLength(); ++i)
+            {
+                CStaticMesh* StaticMesh = Scene->StaticMeshes.GetByIndex(i);
+                if (SweptTestOverlap(AABB, StaticMesh->GetAABB(), SweepDirection))
+                {
+                    OutQueryResult.StaticMeshes.Add(StaticMesh);
+                    OutQueryResult.GeometryAABB.GrowInWorldSpace(StaticMesh->GetAABB());
+                }
+            }
+
+            for (int i = 0; i < Scene->Terrains.GetLength(); ++i)
             {
-                OutQueryResult.Terrains.Add(Terrain);
-                OutQueryResult.GeometryAABB.GrowInWorldSpace(Terrain->GetAABB());
+                CTerrain* Terrain = Scene->Terrains.GetByIndex(i);
+                if (SweptTestOverlap(Terrain->GetAABB(), AABB, SweepDirection))
+                {
+                    OutQueryResult.Terrains.Add(Terrain);
+                    OutQueryResult.GeometryAABB.GrowInWorldSpace(Terrain->GetAABB());
+                }
             }
         }
 
@@ -126,4 +162,71 @@ namespace lucid::scene
         OutQueryResult.GeometryAABB.BackLowerRightCorner =
           glm::vec3{ OutQueryResult.GeometryAABB.MaxXWS, OutQueryResult.GeometryAABB.MinYWS, OutQueryResult.GeometryAABB.MinZWS };
     }
+    void FindLightShadowCasters(const FRenderScene* Scene, const CLight* InLight, std::vector<IActor*>& OutCasters)
+    {
+        assert(InLight->GetType() != ELightType::DIRECTIONAL);
+
+        const glm::vec3 LightPosition = InLight->GetTransform().Translation;
+
+        if (InLight->GetType() == ELightType::SPOT)
+        {
+            const CSpotLight* SpotLight      = (const CSpotLight*)InLight;
+            const glm::vec3   LightDirection = glm::normalize(SpotLight->Direction);
+
+            if (Scene->GeometryBVH)
+            {
+                Scene->GeometryBVH->QueryCone(LightPosition, LightDirection, SpotLight->AttenuationRadius, SpotLight->OuterCutOffRad, OutCasters);
+                return;
+            }
+
+            const auto TestCaster = [&](IActor* InActor) {
+                const math::FAABB& AABB = InActor->GetAABB();
+                const glm::vec3    Min{ AABB.MinXWS, AABB.MinYWS, AABB.MinZWS };
+                const glm::vec3    Max{ AABB.MaxXWS, AABB.MaxYWS, AABB.MaxZWS };
+                if (math::TestAABBSphereOverlap(Min, Max, LightPosition, SpotLight->AttenuationRadius) &&
+                    math::TestSphereConeOverlap(
+                      (Min + Max) * 0.5f, glm::length(Max - Min) * 0.5f, LightPosition, LightDirection, SpotLight->AttenuationRadius, SpotLight->OuterCutOffRad))
+                {
+                    OutCasters.push_back(InActor);
+                }
+            };
+
+            for (u32 i = 0; i < Scene->StaticMeshes.GetLength(); ++i)
+            {
+                TestCaster(Scene->StaticMeshes.GetByIndex(i));
+            }
+
+            for (u32 i = 0; i < Scene->Terrains.GetLength(); ++i)
+            {
+                TestCaster(Scene->Terrains.GetByIndex(i));
+            }
+            return;
+        }
+
+        const CPointLight* PointLight = (const CPointLight*)InLight;
+        if (Scene->GeometryBVH)
+        {
+            Scene->GeometryBVH->QuerySphere(LightPosition, PointLight->AttenuationRadius, OutCasters);
+            return;
+        }
+
+        const auto TestCaster = [&](IActor* InActor) {
+            const math::FAABB& AABB = InActor->GetAABB();
+            if (math::TestAABBSphereOverlap(
+                  { AABB.MinXWS, AABB.MinYWS, AABB.MinZWS }, { AABB.MaxXWS, AABB.MaxYWS, AABB.MaxZWS }, LightPosition, PointLight->AttenuationRadius))
+            {
+                OutCasters.push_back(InActor);
+            }
+        };
+
+        for (u32 i = 0; i < Scene->StaticMeshes.GetLength(); ++i)
+        {
+            TestCaster(Scene->StaticMeshes.GetByIndex(i));
+        }
+
+        for (u32 i = 0; i < Scene->Terrains.GetLength(); ++i)
+        {
+            TestCaster(Scene->Terrains.GetByIndex(i));
+        }
+    }
 }; // namespace lucid::scene
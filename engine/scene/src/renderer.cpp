@@ -1,5 +1,6 @@
 ﻿#include "scene/renderer.hpp"
 
+#include <algorithm>
 #include <stb_ds.h>
 
 #include "engine/engine.hpp"
@@ -28,8 +29,6 @@ namespace lucid::scene
             for (u8 i = 0; i < InCascadeCount; ++i)
             {
                 DirectionalLight->CascadeShadowMaps[i] = CreateShadowMap(ELightType::DIRECTIONAL);
-                DirectionalLight->CascadeShadowMaps[i]->GetShadowMapTexture()->GetBindlessHandle();
-                DirectionalLight->CascadeShadowMaps[i]->GetShadowMapTexture()->MakeBindlessResident();
             }
         }
 
@@ -65,26 +64,14 @@ namespace lucid::scene
 
     CShadowMap* CRenderer::CreateShadowMap(const ELightType& InLightType)
     {
-        if (InLightType == ELightType::POINT)
+        if (InLightType != ELightType::DIRECTIONAL)
         {
-            gpu::CTexture* ShadowMapTexture = gpu::CreateCubemap(ShadowMapSizeByQuality[DefaultShadowMapQuality].x,
-                                                                 ShadowMapSizeByQuality[DefaultShadowMapQuality].y,
-                                                                 gpu::ETextureDataFormat::DEPTH_COMPONENT,
-                                                                 gpu::ETexturePixelFormat::DEPTH_COMPONENT,
-                                                                 gpu::ETextureDataType::FLOAT,
-                                                                 nullptr,
-                                                                 FSString{ "ShadowCubemap" },
-                                                                 gpu::EMinTextureFilter::LINEAR,
-                                                                 gpu::EMagTextureFilter::LINEAR,
-                                                                 gpu::EWrapTextureFilter::CLAMP_TO_BORDER,
-                                                                 gpu::EWrapTextureFilter::CLAMP_TO_BORDER,
-                                                                 gpu::EWrapTextureFilter::CLAMP_TO_BORDER,
-                                                                 { 1, 1, 1, 1 });
-
-            auto* ShadowMap = new CShadowMap(arrlen(CreatedShadowMaps), ShadowMapTexture, DefaultShadowMapQuality);
+            // Tiles in the atlas are allocated by the renderer, once it knows how important the light is on screen
+            auto* ShadowMap = new CShadowMap(arrlen(CreatedShadowMaps), InLightType, DefaultShadowMapQuality);
             arrput(CreatedShadowMaps, ShadowMap);
             return ShadowMap;
         }
+
         gpu::CTexture* ShadowMapTexture = gpu::CreateEmpty2DTexture(ShadowMapSizeByQuality[DefaultShadowMapQuality].x,
                                                                     ShadowMapSizeByQuality[DefaultShadowMapQuality].y,
                                                                     gpu::ETextureDataType::FLOAT,
@@ -100,15 +87,56 @@ namespace lucid::scene
         ShadowMapTexture->SetMagFilter(lucid::gpu::EMagTextureFilter::NEAREST);
         ShadowMapTexture->SetBorderColor({ 1, 1, 1, 1 });
 
+        // Lights reference their shadow maps through the bindless handles stored in the light buffer
+        ShadowMapTexture->GetBindlessHandle();
+        ShadowMapTexture->MakeBindlessResident();
+
         auto* ShadowMap = new CShadowMap(arrlen(CreatedShadowMaps), ShadowMapTexture, DefaultShadowMapQuality);
         arrput(CreatedShadowMaps, ShadowMap);
         return ShadowMap;
     }
 
     CShadowMap::CShadowMap(const RID& InId, gpu::CTexture* InShadowMapTexture, const u8& InShadowMapQuality)
-    : CRendererObject(InId), ShadowMapTexture(InShadowMapTexture), ShadowMapQuality(InShadowMapQuality)
+    : CRendererObject(InId), ShadowMapQuality(InShadowMapQuality), LightType(ELightType::DIRECTIONAL), ShadowMapTexture(InShadowMapTexture)
+    {
+    }
+
+    CShadowMap::CShadowMap(const RID& InId, const ELightType& InLightType, const u8& InShadowMapQuality)
+    : CRendererObject(InId), ShadowMapQuality(InShadowMapQuality), LightType(InLightType)
     {
-        ShadowCubeMapTexture = dynamic_cast<gpu::CCubemap*>(InShadowMapTexture);
+    }
+
+    bool CShadowMap::AllocateTiles(CShadowAtlas* InAtlas, const u16& InTileSize)
+    {
+        ReleaseTiles();
+
+        Atlas = InAtlas;
+        for (u8 i = 0; i < GetNumTiles(); ++i)
+        {
+            if (!Atlas->Allocate(InTileSize, Tiles[i]))
+            {
+                // All of the cube faces have to be of the same size, so give back the ones that were already allocated
+                ReleaseTiles();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void CShadowMap::ReleaseTiles()
+    {
+        for (FShadowAtlasTile& Tile : Tiles)
+        {
+            if (Tile.IsValid())
+            {
+                Atlas->Release(Tile);
+                Tile = {};
+            }
+        }
+
+        Atlas          = nullptr;
+        bNeedsUpdate   = true;
+        bTilesRendered = false;
     }
 
     void CShadowMap::Free()
@@ -119,6 +147,110 @@ namespace lucid::scene
             delete ShadowMapTexture;
             ShadowMapTexture = nullptr;
         }
+        ReleaseTiles();
+    }
+
+    CShadowAtlas::CShadowAtlas(gpu::CTexture* InTexture, const u16& InMinTileSize)
+    : Texture(InTexture), Size(InTexture->GetWidth()), MinTileSize(InMinTileSize), NumFreeTexels(Size * Size)
+    {
+        assert(InTexture->GetWidth() == InTexture->GetHeight());
+        assert((MinTileSize % 16) == 0); // PackTile() stores the tiles in 16 texel units
+
+        u8 NumLevels = 1;
+        for (u16 TileSize = Size; TileSize > MinTileSize; TileSize /= 2)
+        {
+            ++NumLevels;
+        }
+
+        FreeTilesByLevel.resize(NumLevels);
+        FreeTilesByLevel[0].push_back({ 0, 0, Size });
+    }
+
+    inline u8 CShadowAtlas::GetTileLevel(const u16& InSize) const
+    {
+        // Smallest tile that's at least of the requested size
+        u8 Level = 0;
+        for (u16 TileSize = Size / 2; TileSize >= InSize && Level < (FreeTilesByLevel.size() - 1); TileSize /= 2)
+        {
+            ++Level;
+        }
+        return Level;
+    }
+
+    bool CShadowAtlas::Allocate(const u16& InSize, FShadowAtlasTile& OutTile)
+    {
+        const u8 Level = GetTileLevel(InSize);
+
+        // Find the smallest free tile that can hold the requested one
+        i32 FreeTileLevel = Level;
+        while (FreeTileLevel >= 0 && FreeTilesByLevel[FreeTileLevel].empty())
+        {
+            --FreeTileLevel;
+        }
+
+        if (FreeTileLevel < 0)
+        {
+            return false;
+        }
+
+        FShadowAtlasTile Tile = FreeTilesByLevel[FreeTileLevel].back();
+        FreeTilesByLevel[FreeTileLevel].pop_back();
+
+        // Split it until it's of the requested size, the other three quarters stay free
+        for (u8 SplitLevel = FreeTileLevel + 1; SplitLevel <= Level; ++SplitLevel)
+        {
+            Tile.Size /= 2;
+            FreeTilesByLevel[SplitLevel].push_back({ (u16)(Tile.X + Tile.Size), Tile.Y, Tile.Size });
+            FreeTilesByLevel[SplitLevel].push_back({ Tile.X, (u16)(Tile.Y + Tile.Size), Tile.Size });
+            FreeTilesByLevel[SplitLevel].push_back({ (u16)(Tile.X + Tile.Size), (u16)(Tile.Y + Tile.Size), Tile.Size });
+        }
+
+        NumFreeTexels -= Tile.Size * Tile.Size;
+        OutTile = Tile;
+        return true;
+    }
+
+    void CShadowAtlas::Release(const FShadowAtlasTile& InTile)
+    {
+        NumFreeTexels += InTile.Size * InTile.Size;
+
+        FShadowAtlasTile Tile  = InTile;
+        u8               Level = GetTileLevel(Tile.Size);
+
+        // Merge the tile with it's siblings for as long as all of them are free
+        while (Level > 0)
+        {
+            const u16  ParentSize = Tile.Size * 2;
+            const u16  ParentX    = Tile.X - (Tile.X % ParentSize);
+            const u16  ParentY    = Tile.Y - (Tile.Y % ParentSize);
+            const auto IsSibling  = [&](const FShadowAtlasTile& InFreeTile) {
+                return (InFreeTile.X - (InFreeTile.X % ParentSize)) == ParentX && (InFreeTile.Y - (InFreeTile.Y % ParentSize)) == ParentY;
+            };
+
+            std::vector<FShadowAtlasTile>& FreeTiles = FreeTilesByLevel[Level];
+            if (std::count_if(FreeTiles.begin(), FreeTiles.end(), IsSibling) < 3)
+            {
+                break;
+            }
+
+            FreeTiles.erase(std::remove_if(FreeTiles.begin(), FreeTiles.end(), IsSibling), FreeTiles.end());
+            Tile = { ParentX, ParentY, ParentSize };
+            --Level;
+        }
+
+        FreeTilesByLevel[Level].push_back(Tile);
+    }
+
+    u32 CShadowAtlas::PackTile(const FShadowAtlasTile& InTile)
+    {
+        return (InTile.X / 16) | ((InTile.Y / 16) << 10) | ((InTile.Size / 16) << 20);
+    }
+
+    void CShadowAtlas::Free()
+    {
+        Texture->Free();
+        delete Texture;
+        Texture = nullptr;
     }
 
     void CRenderer::RemoveShadowMap(CShadowMap* InShadowMap)
@@ -180,20 +312,12 @@ namespace lucid::scene
 
     void CRenderer::RemoveStaleDebugLines()
     {
-        const float             CurrentTime = platform::GetCurrentTimeSeconds();
-        std::vector<FDebugLine> PersistedLines;
-
-        for (int i = 0; i < DebugLines.size(); ++i)
-        {
-            const FDebugLine& DebugLine = DebugLines[i];
-            if (DebugLine.RemoveTime < 0 || DebugLine.RemoveTime > CurrentTime)
-            {
-                PersistedLines.push_back(DebugLine);
-            }
-        }
-
-        DebugLines.clear();
-        DebugLines = std::move(PersistedLines);
+        // Removed in place, so the vector keeps it's memory and the lines don't allocate once it's big enough
+        const float CurrentTime = platform::GetCurrentTimeSeconds();
+        const auto  RemovedIt   = std::remove_if(DebugLines.begin(), DebugLines.end(), [CurrentTime](const FDebugLine& InDebugLine) {
+            return InDebugLine.RemoveTime >= 0 && InDebugLine.RemoveTime <= CurrentTime;
+        });
+        DebugLines.erase(RemovedIt, DebugLines.end());
     }
 
     FDebugArrow MakeDebugArrowData(const glm::vec3& InStart, const glm::vec3& InDirection, const float& InLength)
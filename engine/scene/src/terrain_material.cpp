@@ -66,7 +66,7 @@ namespace lucid::scene
     {
         FTerrainLayerData Layers[MAX_TERRAIN_LAYERS];
         u32               NumLayers;
-        u8                _padding[4];
+        u32               TextureFeedbackSlot;
     };
 
 #pragma pack(pop)
@@ -103,7 +103,8 @@ namespace lucid::scene
                 MaterialData->Layers[i].bHasNormalMap = false;
             }
         }
-        MaterialData->NumLayers = NumLayers;
+        MaterialData->NumLayers           = NumLayers;
+        MaterialData->TextureFeedbackSlot = TextureFeedbackSlot;
     }
 
     void CTerrainMaterial::SetupPrepassShader(FForwardPrepassUniforms* InPrepassUniforms)
@@ -148,6 +149,8 @@ namespace lucid::scene
                 TerrainLayer.Normal->TextureHandle->MakeBindlessResident();
             }
         }
+
+        AcquireTextureFeedbackSlot();
     }
 
     void CTerrainMaterial::UnloadResources()
@@ -166,6 +169,28 @@ namespace lucid::scene
                 TerrainLayer.Normal->Release();
             }
         }
+
+        ReleaseTextureFeedbackSlot();
+    }
+
+    void CTerrainMaterial::RequestTextureMips(const float& InLog2UVFootprint)
+    {
+        // The feedback is written with the terrain's coordinates, the layers tile them
+        resources::CTextureStreamer& TextureStreamer = GEngine.GetTextureStreamer();
+        for (u8 i = 0; i < NumLayers; ++i)
+        {
+            const FTerrainLayer& TerrainLayer         = TerrainLayers[i];
+            const float          LayerLog2UVFootprint = InLog2UVFootprint + log2f(glm::max(TerrainLayer.UVTiling.x, TerrainLayer.UVTiling.y));
+
+            TextureStreamer.RequestMips(TerrainLayer.Diffuse, LayerLog2UVFootprint);
+            TextureStreamer.RequestMips(TerrainLayer.Normal, LayerLog2UVFootprint);
+        }
+    }
+
+    bool CTerrainMaterial::RefreshTextureHandles()
+    {
+        // The handles aren't cached, SetupShaderBuffer() reads them from the textures
+        return NumLayers > 0;
     }
 
     void CTerrainMaterial::UIDrawMaterialEditor()
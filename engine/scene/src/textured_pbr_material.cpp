@@ -68,7 +68,8 @@ namespace lucid::scene
         float     Metallic  = 0;
 
         u32 Flags;
-        u8  _Padding[8];
+        u32 TextureFeedbackSlot;
+        u8  _Padding[4];
     };
 #pragma pack(pop)
 
@@ -83,6 +84,7 @@ namespace lucid::scene
         MaterialData->AOMapBindlessHandle           = AOMapBindlessHandle;
         MaterialData->NormalMapBindlessHandle       = NormalMapBindlessHandle;
         MaterialData->DisplacementMapBindlessHandle = DisplacementMapBindlessHandle;
+        MaterialData->TextureFeedbackSlot           = TextureFeedbackSlot;
 
         MaterialData->Flags = 0;
 
@@ -364,6 +366,8 @@ namespace lucid::scene
                 DisplacementMap->TextureHandle->MakeBindlessResident();
             }
         }
+
+        AcquireTextureFeedbackSlot();
     }
 
     void CTexturedPBRMaterial::UnloadResources()
@@ -403,6 +407,30 @@ namespace lucid::scene
             DisplacementMap->Release();
             DisplacementMapBindlessHandle = 0;
         }
+
+        ReleaseTextureFeedbackSlot();
     }
 
+    void CTexturedPBRMaterial::RequestTextureMips(const float& InLog2UVFootprint)
+    {
+        // All of the maps are sampled with the same coordinates
+        resources::CTextureStreamer& TextureStreamer = GEngine.GetTextureStreamer();
+        TextureStreamer.RequestMips(RoughnessMap, InLog2UVFootprint);
+        TextureStreamer.RequestMips(MetallicMap, InLog2UVFootprint);
+        TextureStreamer.RequestMips(AlbedoMap, InLog2UVFootprint);
+        TextureStreamer.RequestMips(AOMap, InLog2UVFootprint);
+        TextureStreamer.RequestMips(NormalMap, InLog2UVFootprint);
+        TextureStreamer.RequestMips(DisplacementMap, InLog2UVFootprint);
+    }
+
+    bool CTexturedPBRMaterial::RefreshTextureHandles()
+    {
+        bool bRefreshed = RefreshBindlessHandle(RoughnessMap, RoughnessMapBindlessHandle);
+        bRefreshed |= RefreshBindlessHandle(MetallicMap, MetallicMapBindlessHandle);
+        bRefreshed |= RefreshBindlessHandle(AlbedoMap, AlbedoMapBindlessHandle);
+        bRefreshed |= RefreshBindlessHandle(AOMap, AOMapBindlessHandle);
+        bRefreshed |= RefreshBindlessHandle(NormalMap, NormalMapBindlessHandle);
+        bRefreshed |= RefreshBindlessHandle(DisplacementMap, DisplacementMapBindlessHandle);
+        return bRefreshed;
+    }
 } // namespace lucid::scene
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "scene/transform_hierarchy.hpp"
+
+#include "engine/engine.hpp"
+#include "common/jobs.hpp"
+
+#include "scene/world.hpp"
+#include "scene/renderer.hpp"
+#include "scene/actors/actor.hpp"
+
+#include <algorithm>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace lucid::scene
+{
+    /** Below that the update isn't worth spreading across the workers */
+    static constexpr u32 PARALLEL_TRANSFORM_UPDATE_MIN_NODES = 2048;
+    static constexpr u32 TRANSFORM_SUBTREES_PER_JOB          = 16;
+
+    void CTransformHierarchy::Add(IActor* InActor)
+    {
+        if (InActor->TransformNodeIdx < Actors.size() && Actors[InActor->TransformNodeIdx] == InActor)
+        {
+            return;
+        }
+
+        // Appended for now, it's moved after it's parent when the nodes are sorted
+        InActor->TransformNodeIdx = Actors.size();
+        Actors.push_back(InActor);
+        Parents.push_back(-1);
+        SubtreeEnds.push_back(Actors.size());
+        Translations.push_back(InActor->GetTransform().Translation);
+        Rotations.push_back(InActor->GetTransform().Rotation);
+        Scales.push_back(InActor->GetTransform().Scale);
+        WorldMatrices.push_back(glm::mat4{ 1 });
+
+        bStructureDirty = true;
+        MarkDirty(InActor);
+    }
+
+    void CTransformHierarchy::Remove(IActor* InActor)
+    {
+        const u32 NodeIdx = InActor->TransformNodeIdx;
+        if (NodeIdx >= Actors.size() || Actors[NodeIdx] != InActor)
+        {
+            return;
+        }
+
+        if (InActor->bTransformDirty)
+        {
+            DirtyActors.erase(std::find(DirtyActors.begin(), DirtyActors.end(), InActor));
+            InActor->bTransformDirty = false;
+        }
+
+        // Swap with the last node, the order is restored when the nodes are sorted
+        const u32 LastNodeIdx = Actors.size() - 1;
+        Actors[NodeIdx]        = Actors[LastNodeIdx];
+        Translations[NodeIdx]  = Translations[LastNodeIdx];
+        Rotations[NodeIdx]     = Rotations[LastNodeIdx];
+        Scales[NodeIdx]        = Scales[LastNodeIdx];
+        WorldMatrices[NodeIdx] = WorldMatrices[LastNodeIdx];
+        Actors[NodeIdx]->TransformNodeIdx = NodeIdx;
+
+        Actors.pop_back();
+        Parents.pop_back();
+        SubtreeEnds.pop_back();
+        Translations.pop_back();
+        Rotations.pop_back();
+        Scales.pop_back();
+        WorldMatrices.pop_back();
+
+        InActor->TransformNodeIdx = INVALID_TRANSFORM_NODE;
+        bStructureDirty           = true;
+    }
+
+    void CTransformHierarchy::MarkDirty(IActor* InActor)
+    {
+        if (!InActor->bTransformDirty)
+        {
+            InActor->bTransformDirty = true;
+            DirtyActors.push_back(InActor);
+        }
+    }
+
+    template <typename T>
+    static void PermuteNodes(std::vector<T>& InOutValues, const std::vector<IActor*>& InSortedActors)
+    {
+        std::vector<T> SortedValues(InOutValues.size());
+        for (u32 i = 0; i < InSortedActors.size(); ++i)
+        {
+            SortedValues[i] = InOutValues[InSortedActors[i]->TransformNodeIdx];
+        }
+        InOutValues.swap(SortedValues);
+    }
+
+    void CTransformHierarchy::Sort()
+    {
+        const auto IsNode = [this](const IActor* InActor) {
+            return InActor && InActor->TransformNodeIdx < Actors.size() && Actors[InActor->TransformNodeIdx] == InActor;
+        };
+
+        // Depth first traversal from the roots, so each subtree ends up in a contiguous range right after it's root
+        SortedActors.clear();
+        for (IActor* Actor : Actors)
+        {
+            if (IsNode(Actor->Parent))
+            {
+                continue;
+            }
+
+            TraversalStack.push_back(Actor);
+            while (!TraversalStack.empty())
+            {
+                IActor* Node = TraversalStack.back();
+                TraversalStack.pop_back();
+                SortedActors.push_back(Node);
+
+                auto ChildNode = &Node->Children.Head;
+                while (ChildNode && ChildNode->Element)
+                {
+                    if (IsNode(ChildNode->Element))
+                    {
+                        TraversalStack.push_back(ChildNode->Element);
+                    }
+                    ChildNode = ChildNode->Next;
+                }
+            }
+        }
+        assert(SortedActors.size() == Actors.size());
+
+        // Sorting happens only when the hierarchy changes, so the temporary arrays are fine here
+        PermuteNodes(Translations, SortedActors);
+        PermuteNodes(Rotations, SortedActors);
+        PermuteNodes(Scales, SortedActors);
+        PermuteNodes(WorldMatrices, SortedActors);
+
+        Actors.swap(SortedActors);
+        for (u32 i = 0; i < Actors.size(); ++i)
+        {
+            Actors[i]->TransformNodeIdx = i;
+        }
+
+        for (u32 i = 0; i < Actors.size(); ++i)
+        {
+            Parents[i]     = IsNode(Actors[i]->Parent) ? Actors[i]->Parent->TransformNodeIdx : -1;
+            SubtreeEnds[i] = i + 1;
+        }
+
+        // Children go after their parents, so walking backwards propagates the ends of the subtrees up to the roots
+        for (u32 i = Actors.size(); i > 0; --i)
+        {
+            const i32 ParentIdx = Parents[i - 1];
+            if (ParentIdx >= 0)
+            {
+                SubtreeEnds[ParentIdx] = glm::max(SubtreeEnds[ParentIdx], SubtreeEnds[i - 1]);
+            }
+        }
+    }
+
+    void CTransformHierarchy::UpdateSubtree(const u32& InRootNodeIdx)
+    {
+        const glm::mat4 Identity{ 1 };
+        for (u32 i = InRootNodeIdx; i < SubtreeEnds[InRootNodeIdx]; ++i)
+        {
+            const glm::mat4 LocalMatrix = glm::translate(Identity, Translations[i]) * glm::mat4_cast(Rotations[i]) * glm::scale(Identity, Scales[i]);
+            WorldMatrices[i]            = Parents[i] >= 0 ? WorldMatrices[Parents[i]] * LocalMatrix : LocalMatrix;
+            Actors[i]->AABB.OrientAround(WorldMatrices[i]);
+        }
+    }
+
+    void CTransformHierarchy::Update()
+    {
+        if (bStructureDirty)
+        {
+            Sort();
+            bStructureDirty = false;
+        }
+
+        if (DirtyActors.empty())
+        {
+            return;
+        }
+
+        DirtyNodes.clear();
+        for (IActor* Actor : DirtyActors)
+        {
+            const u32           NodeIdx   = Actor->TransformNodeIdx;
+            const FTransform3D& Transform = Actor->GetTransform();
+            Translations[NodeIdx]         = Transform.Translation;
+            Rotations[NodeIdx]            = Transform.Rotation;
+            Scales[NodeIdx]               = Transform.Scale;
+            Actor->bTransformDirty        = false;
+            DirtyNodes.push_back(NodeIdx);
+        }
+        DirtyActors.clear();
+
+        // Only the topmost dirty nodes are kept, their subtrees cover the dirty nodes below them
+        std::sort(DirtyNodes.begin(), DirtyNodes.end());
+
+        DirtySubtrees.clear();
+        u32 NumNodesToUpdate = 0;
+        u32 CoveredEnd       = 0;
+        for (const u32& NodeIdx : DirtyNodes)
+        {
+            if (NodeIdx >= CoveredEnd)
+            {
+                DirtySubtrees.push_back(NodeIdx);
+                CoveredEnd = SubtreeEnds[NodeIdx];
+                NumNodesToUpdate += CoveredEnd - NodeIdx;
+            }
+        }
+
+        // The subtrees don't overlap and their roots' parents aren't written, so they can be updated independently
+        if (NumNodesToUpdate >= PARALLEL_TRANSFORM_UPDATE_MIN_NODES && DirtySubtrees.size() > 1)
+        {
+            GEngine.GetJobSystem().ParallelFor(DirtySubtrees.size(), TRANSFORM_SUBTREES_PER_JOB, [this](const u32& InBegin, const u32& InEnd) {
+                for (u32 i = InBegin; i < InEnd; ++i)
+                {
+                    UpdateSubtree(DirtySubtrees[i]);
+                }
+            });
+        }
+        else
+        {
+            for (const u32& SubtreeRootIdx : DirtySubtrees)
+            {
+                UpdateSubtree(SubtreeRootIdx);
+            }
+        }
+
+        // Neither the BVH nor the renderer are thread safe, so they're notified once all of the matrices and AABBs are ready
+        for (const u32& SubtreeRootIdx : DirtySubtrees)
+        {
+            for (u32 i = SubtreeRootIdx; i < SubtreeEnds[SubtreeRootIdx]; ++i)
+            {
+                if (Actors[i]->World)
+                {
+                    Actors[i]->World->OnActorAABBChanged(Actors[i]);
+                }
+                else
+                {
+                    GEngine.GetRenderer()->MarkActorDirty(Actors[i]);
+                }
+            }
+        }
+    }
+
+    void CTransformHierarchy::Clear()
+    {
+        for (IActor* Actor : Actors)
+        {
+            Actor->TransformNodeIdx = INVALID_TRANSFORM_NODE;
+            Actor->bTransformDirty  = false;
+        }
+
+        Actors.clear();
+        Parents.clear();
+        SubtreeEnds.clear();
+        Translations.clear();
+        Rotations.clear();
+        Scales.clear();
+        WorldMatrices.clear();
+        DirtyActors.clear();
+        bStructureDirty = false;
+    }
+} // namespace lucid::scene
@@ -4,6 +4,7 @@
 
 #include "scene/render_scene.hpp"
 #include "scene/renderer.hpp"
+#include "scene/camera.hpp"
 
 #include "scene/actors/static_mesh.hpp"
 #include "scene/actors/skybox.hpp"
@@ -36,10 +37,17 @@ namespace lucid::scene
         if (AddActor(InStaticMesh))
         {
             StaticMeshes.Add(InStaticMesh->ActorId, InStaticMesh);
+            GeometryBVH.Insert(InStaticMesh);
+            GEngine.GetRenderer()->RegisterActor(InStaticMesh);
         }
     }
 
-    void CWorld::RemoveStaticMesh(const u32& InId) { StaticMeshes.Remove(InId); }
+    void CWorld::RemoveStaticMesh(const u32& InId)
+    {
+        StaticMeshes.Remove(InId);
+        GeometryBVH.Remove(InId);
+        GEngine.GetRenderer()->UnregisterActor(InId);
+    }
 
     void CWorld::AddDirectionalLight(CDirectionalLight* InLight)
     {
@@ -89,10 +97,17 @@ namespace lucid::scene
         if (AddActor(InTerrain))
         {
             Terrains.Add(InTerrain->ActorId, InTerrain);
+            GeometryBVH.Insert(InTerrain);
+            GEngine.GetRenderer()->RegisterActor(InTerrain);
         }
     }
 
-    void CWorld::RemoveTerrain(CTerrain* InTerrain) { Terrains.Remove(InTerrain->ActorId); }
+    void CWorld::RemoveTerrain(CTerrain* InTerrain)
+    {
+        Terrains.Remove(InTerrain->ActorId);
+        GeometryBVH.Remove(InTerrain->ActorId);
+        GEngine.GetRenderer()->UnregisterActor(InTerrain->ActorId);
+    }
 
     void CWorld::SetSkybox(CSkybox* InSkybox)
     {
@@ -112,16 +127,75 @@ namespace lucid::scene
 
     FRenderScene* CWorld::MakeRenderScene(CCamera* InCamera)
     {
-        StaticRenderScene.AllLights         = AllLights;
-        StaticRenderScene.DirectionalLights = DirectionalLights;
-        StaticRenderScene.SpotLights        = SpotLights;
-        StaticRenderScene.PointLights       = PointLights;
-        StaticRenderScene.StaticMeshes      = StaticMeshes;
-        StaticRenderScene.Skybox            = Skybox;
-        StaticRenderScene.Terrains          = Terrains;
+        // Only the subtrees of the actors that moved are updated, static worlds don't pay anything here
+        TransformHierarchy.Update();
+
+        // The render scene keeps it's memory between frames
+        StaticRenderScene.AllLights.Clear();
+        StaticRenderScene.DirectionalLights.Clear();
+        StaticRenderScene.SpotLights.Clear();
+        StaticRenderScene.PointLights.Clear();
+        StaticRenderScene.StaticMeshes.Clear();
+        StaticRenderScene.Terrains.Clear();
+
+        const math::FFrustum Frustum = InCamera->GetFrustum();
+
+        // Lights - directional lights affect the whole scene, spot and point lights are culled using their attenuation radius
+        for (u32 i = 0; i < DirectionalLights.GetLength(); ++i)
+        {
+            CDirectionalLight* DirectionalLight = DirectionalLights.GetByIndex(i);
+            StaticRenderScene.DirectionalLights.Add(DirectionalLight->ActorId, DirectionalLight);
+            StaticRenderScene.AllLights.Add(DirectionalLight->ActorId, DirectionalLight);
+        }
+
+        for (u32 i = 0; i < SpotLights.GetLength(); ++i)
+        {
+            CSpotLight* SpotLight = SpotLights.GetByIndex(i);
+            if (Frustum.TestSphere(SpotLight->GetTransform().Translation, SpotLight->AttenuationRadius))
+            {
+                StaticRenderScene.SpotLights.Add(SpotLight->ActorId, SpotLight);
+                StaticRenderScene.AllLights.Add(SpotLight->ActorId, SpotLight);
+            }
+        }
+
+        for (u32 i = 0; i < PointLights.GetLength(); ++i)
+        {
+            CPointLight* PointLight = PointLights.GetByIndex(i);
+            if (Frustum.TestSphere(PointLight->GetTransform().Translation, PointLight->AttenuationRadius))
+            {
+                StaticRenderScene.PointLights.Add(PointLight->ActorId, PointLight);
+                StaticRenderScene.AllLights.Add(PointLight->ActorId, PointLight);
+            }
+        }
+
+        // Geometry
+        CulledActors.clear();
+        GeometryBVH.QueryFrustum(Frustum, CulledActors);
+
+        for (IActor* Actor : CulledActors)
+        {
+            if (Actor->GetActorType() == EActorType::STATIC_MESH)
+            {
+                StaticRenderScene.StaticMeshes.Add(Actor->ActorId, (CStaticMesh*)Actor);
+            }
+            else if (Actor->GetActorType() == EActorType::TERRAIN)
+            {
+                StaticRenderScene.Terrains.Add(Actor->ActorId, (CTerrain*)Actor);
+            }
+        }
+
+        StaticRenderScene.Skybox      = Skybox;
+        StaticRenderScene.GeometryBVH = &GeometryBVH;
+
         return &StaticRenderScene;
     }
 
+    void CWorld::OnActorAABBChanged(IActor* InActor)
+    {
+        GeometryBVH.Update(InActor);
+        GEngine.GetRenderer()->MarkActorDirty(InActor);
+    }
+
     IActor* CWorld::GetActorById(const u32& InActorId) { return ActorById.Get(InActorId); }
 
     u32 CWorld::AddActor(IActor* InActor)
@@ -136,6 +210,7 @@ namespace lucid::scene
         }
         ActorById.Add(InActor->ActorId, InActor);
         InActor->OnAddToWorld(this);
+        TransformHierarchy.Add(InActor);
         LUCID_LOG(ELogLevel::INFO, "Actor '%s' added to the world", *InActor->Name);
         return InActor->ActorId;
     }
@@ -467,6 +542,8 @@ namespace lucid::scene
 
     void CWorld::Unload()
     {
+        TransformHierarchy.Clear();
+
         for (u32 i = 0; i < ActorById.GetLength(); ++i)
         {
             IActor* Actor = ActorById.GetByIndex(i);
@@ -480,6 +557,8 @@ namespace lucid::scene
         SpotLights.FreeAll();
         PointLights.FreeAll();
         AllLights.FreeAll();
+        Terrains.FreeAll();
+        GeometryBVH.Clear();
         if (Skybox)
         {
             Skybox = nullptr;
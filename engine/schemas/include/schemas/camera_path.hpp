@@ -0,0 +1,10 @@
+﻿STRUCT_BEGIN(lucid, FCameraPathKey, "Pose of the camera at a point of a recorded camera path")
+    STRUCT_FIELD(float, Time, 0, "Seconds since the recording started")
+    STRUCT_STATIC_ARRAY(float, Position, 3, {0 COMMA 0 COMMA 0 }, "")
+    STRUCT_FIELD(float, Yaw, -90, "")
+    STRUCT_FIELD(float, Pitch, 0, "")
+STRUCT_END()
+
+STRUCT_BEGIN(lucid, FCameraPath, "Camera path recorded in the editor and replayed by the benchmark")
+    STRUCT_DYNAMIC_ARRAY(lucid::FCameraPathKey, Keys, "")
+STRUCT_END()
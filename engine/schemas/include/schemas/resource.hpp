@@ -6,6 +6,7 @@ STRUCT_BEGIN(lucid, FResourceDatabaseEntry, "Mapping of resource name to asset p
     STRUCT_FIELD(lucid::FDString, Path, "", "Path to the asset resource")
     STRUCT_FIELD(lucid::resources::EResourceType, Type, lucid::resources::TEXTURE, "Type of the resource")
     STRUCT_FIELD(bool, bIsDefault, false, "Is this the default resource for the given type")
+    STRUCT_FIELD(bool, bSavedAfterCook, false, "Set when the resource was saved to it's own file after the last cook, the copy in the asset archive is out of date")
 STRUCT_END()
 
 STRUCT_BEGIN(lucid, FResourceDatabase, "")
@@ -3,3 +3,4 @@
 #include "schemas/materials.hpp"
 #include "schemas/world.hpp"
 #include "schemas/resource.hpp"
+#include "schemas/camera_path.hpp"
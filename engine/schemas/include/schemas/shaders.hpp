@@ -3,6 +3,7 @@
     STRUCT_FIELD(lucid::FDString, VertexShaderSourcePath, "", "Path to the vertex shader source")
     STRUCT_FIELD(lucid::FDString, FragmentShaderSourcePath, "", "Path to the fragment shader source")
     STRUCT_FIELD(lucid::FDString, GeometryShaderSourcePath, "", "Path to the geometry shader source")
+    STRUCT_FIELD(lucid::FDString, ComputeShaderSourcePath, "", "Path to the compute shader source, compute shader programs don't have any other shaders")
     STRUCT_FIELD(lucid::FDString, VertexShaderBinaryDataPath, "", "Path to the vertex shader cached binary data")
     STRUCT_FIELD(lucid::FDString, FragmentShaderBinaryDataPath, "", "Path to the fragment shader cached binary data")
     STRUCT_FIELD(lucid::FDString, GeometryShaderBinaryDataPath, "", "Path to the geometry shader cached binary data")
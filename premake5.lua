@@ -3,4 +3,5 @@ workspace "lucid"
    configurations { "Debug", "Release" }
    platforms { "Win32", "Win64", "Linux"}
    include "engine"
-   include "scene_editor"
\ No newline at end of file
+   include "scene_editor"
+   include "bench"
\ No newline at end of file
@@ -44,6 +44,12 @@ project "lucid_scene_editor"
       "tools/scene_editor/src/*.cpp"
    }
 
+   -- Built into lucid_engine
+   removefiles {
+      "tools/scene_editor/src/editor.cpp",
+      "tools/scene_editor/src/imgui_lucid.cpp"
+   }
+
    filter "platforms:Win64"
       architecture "x86_64"
    
@@ -1,3 +1,5 @@
+#extension GL_ARB_shader_draw_parameters : enable
+
 uniform int uMeshBatchOffset;
 
 struct FActorData
@@ -5,17 +7,23 @@ struct FActorData
     mat4 ModelMatrix;
     int  NormalMultiplier;
     uint ActorId;
+    vec4 BoundsMin;
+    vec4 BoundsMax;
 };
 
 struct FInstanceData
 {
     int ActorDataIdx;
     int MaterialDataIdx;
+    int PrepassDataIdx;
 };
 
 layout(std430, binding = 1) buffer ActorDataBlock { FActorData ActorData[]; };
 layout(std430, binding = 2) buffer InstanceDataBlock { FInstanceData InstanceData[]; };
 
+// Instance id within the batch, batches are drawn with multi-draw calls where each draw starts at it's base instance
+#define BATCH_INSTANCE_ID (gl_BaseInstanceARB + gl_InstanceID)
+
 #define INSTANCE_DATA ActorData[InstanceData[uMeshBatchOffset + InstanceID].ActorDataIdx]
 #define MATERIAL_DATA_INDEX InstanceData[uMeshBatchOffset + InstanceID].MaterialDataIdx
 #define MATERIAL_DATA MaterialData[MATERIAL_DATA_INDEX]
\ No newline at end of file
@@ -6,6 +6,7 @@ layout(bindless_sampler) uniform;
 struct FBlinnPhongMapsMaterial
 {
     vec3 SpecularColor;
+    uint TextureFeedbackSlot;
 
     sampler2D DiffuseMap;
     sampler2D SpecularMap;
@@ -1,11 +1,15 @@
 #version 450 core
 
+#include "batch_instance.glsl"
+
 layout(location = 0) in vec3 aPosition;
 
+in int gl_InstanceID;
+
 uniform mat4 uLightMatrix;
-uniform mat4 uModelMatrix;
 
 void main()
 {
-    gl_Position = uLightMatrix * uModelMatrix * vec4(aPosition, 1.0);
+    int InstanceID = BATCH_INSTANCE_ID;
+    gl_Position = uLightMatrix * INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1.0);
 }
\ No newline at end of file
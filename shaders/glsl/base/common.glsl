@@ -18,4 +18,5 @@ layout(std140, binding = 0) uniform GlobalDataBlock
     float     uFarPlane;
     int       uSSAOKernelSize;
     int       uSSAOStrength;
+    uint      uFrameNumber;
 };
\ No newline at end of file
@@ -0,0 +1,14 @@
+// Converts a value read from the depth buffer to linear view space depth
+float LinearizeDepth(float InDepth, float InNearPlane, float InFarPlane)
+{
+    float NDCDepth = (InDepth * 2.0) - 1.0;
+    return (2.0 * InNearPlane * InFarPlane) / (InFarPlane + InNearPlane - (NDCDepth * (InFarPlane - InNearPlane)));
+}
+
+// Reconstructs the view space position of a pixel from it's texture coordinates and linear depth
+vec3 ViewSpacePositionFromDepth(vec2 InTextureCoords, float InLinearDepth, mat4 InProjection)
+{
+    vec2 NDC = (InTextureCoords * 2.0) - 1.0;
+    vec2 XY  = (NDC + vec2(InProjection[2][0], InProjection[2][1])) * InLinearDepth / vec2(InProjection[0][0], InProjection[1][1]);
+    return vec3(XY, -InLinearDepth);
+}
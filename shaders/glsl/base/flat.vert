@@ -10,7 +10,7 @@ layout(location = 0) in vec3 aPosition;
 
 void main()
 {
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
     vec4 WorldPos = INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1.0);
     gl_Position = uProjection * uView * WorldPos;
 }
@@ -3,11 +3,11 @@
 #include "common.glsl"
 #include "forward_prepass_common.glsl"
 #include "parallax_occlusion.glsl"
+#include "normal_map.glsl"
 
 flat in int InstanceID;
 
 layout (location = 0) out vec3 oNormalVS;
-layout (location = 1) out vec3 oPositionVS;
 
 in vec3 PositionVS;
 in vec3 NormalVS;
@@ -31,12 +31,11 @@ void main()
             }
         }
         
-        vec3 SampledNormal = (texture(PREPASS_DATA.NormalMap, textureCoords).rgb * 2) - 1;
+        vec3 SampledNormal = UnpackNormalMap(texture(PREPASS_DATA.NormalMap, textureCoords));
         oNormalVS = normalize(TBNMatrix * SampledNormal);
     }
     else
     {
         oNormalVS = normalize(NormalVS);
     }
-    oPositionVS = PositionVS;
 }
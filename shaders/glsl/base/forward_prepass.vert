@@ -19,7 +19,7 @@ flat out mat3 TBNMatrix;
 
 void main() 
 {
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
     TexCoords = aTextureCoords;
     
     mat3 NormalMatrix = transpose(inverse(mat3(uView * INSTANCE_DATA.ModelMatrix)));
@@ -16,4 +16,4 @@ layout(std430, binding = 3) buffer PrepassDataBlock
     FForwardPrepassUniforms PrepassData[]; 
 };
 
-#define PREPASS_DATA PrepassData[uMeshBatchOffset + InstanceID]
+#define PREPASS_DATA PrepassData[InstanceData[uMeshBatchOffset + InstanceID].PrepassDataIdx]
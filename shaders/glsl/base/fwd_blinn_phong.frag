@@ -24,25 +24,36 @@ void main()
     vec3 toViewN = normalize(uViewPos - fsIn.FragPos);
 
     vec3 ambient = MATERIAL_DATA.DiffuseColor * uAmbientStrength;
-    float shadowFactor = 1.0;
+    vec3 result  = vec3(0);
 
-    LightContribution lightCntrb;
-    if (uLightType == DIRECTIONAL_LIGHT)
+    uint clusterIdx = GetClusterIndex(gl_FragCoord.xy, fsIn.FragPos);
+    uint numLights  = GetClusterNumLights(clusterIdx);
+    for (uint i = 0; i < numLights; ++i)
     {
-        shadowFactor = CalculateShadow(fsIn.FragPos, normal, normalize(uLightDirection));
-        lightCntrb = CalculateDirectionalLightContribution(toViewN, normal, MATERIAL_DATA.Shininess);
-    }
-    else if (uLightType == POINT_LIGHT)
-    {
-        shadowFactor = CalculateShadowCubemap(fsIn.FragPos, normal, uLightPosition);
-        lightCntrb = CalculatePointLightContribution(fsIn.FragPos, toViewN, normal, MATERIAL_DATA.Shininess);
-    }
-    else if (uLightType == SPOT_LIGHT)
-    {
-        shadowFactor = CalculateShadow(fsIn.FragPos, normal, normalize(uLightDirection));
-        lightCntrb = CalculateSpotLightContribution(fsIn.FragPos, toViewN, normal, MATERIAL_DATA.Shininess);
+        Light = Lights[GetClusterLightIndex(clusterIdx, i)];
+
+        float shadowFactor = 1.0;
+
+        LightContribution lightCntrb;
+        if (Light.Type == DIRECTIONAL_LIGHT)
+        {
+            shadowFactor = CalculateShadow(fsIn.FragPos, normal, normalize(Light.Direction));
+            lightCntrb = CalculateDirectionalLightContribution(toViewN, normal, MATERIAL_DATA.Shininess);
+        }
+        else if (Light.Type == POINT_LIGHT)
+        {
+            shadowFactor = CalculateShadowCubemap(fsIn.FragPos, normal, Light.Position);
+            lightCntrb = CalculatePointLightContribution(fsIn.FragPos, toViewN, normal, MATERIAL_DATA.Shininess);
+        }
+        else
+        {
+            shadowFactor = CalculateShadow(fsIn.FragPos, normal, normalize(Light.Direction));
+            lightCntrb = CalculateSpotLightContribution(fsIn.FragPos, toViewN, normal, MATERIAL_DATA.Shininess);
+        }
+
+        vec3 fragColor = (MATERIAL_DATA.DiffuseColor *  lightCntrb.Diffuse) + (MATERIAL_DATA.SpecularColor * lightCntrb.Specular);
+        result += (ambient * lightCntrb.Attenuation) + (fragColor * shadowFactor);
     }
 
-    vec3 fragColor = (MATERIAL_DATA.DiffuseColor *  lightCntrb.Diffuse) + (MATERIAL_DATA.SpecularColor * lightCntrb.Specular);
-    oFragColor = vec4((ambient * lightCntrb.Attenuation) + (fragColor * shadowFactor), 1);
+    oFragColor = vec4(result, 1);
 }
\ No newline at end of file
@@ -20,7 +20,7 @@ vsOut;
 
 void main()
 {
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
 
     mat3 normalMatrix = mat3(transpose(inverse(INSTANCE_DATA.ModelMatrix)));
     vec4 FragPos = INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1);
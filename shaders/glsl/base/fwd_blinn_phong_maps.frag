@@ -21,6 +21,8 @@ uniform mat4 uModel;
 #include "lights.glsl"
 #include "shadow_mapping.glsl"
 #include "parallax_occlusion.glsl"
+#include "normal_map.glsl"
+#include "texture_feedback.glsl"
 
 out vec4 oFragColor;
 
@@ -30,6 +32,8 @@ void main()
     vec2  ScreenSpaceCoords = (gl_FragCoord.xy / uViewportSize);
     float AmbientOcclusion  = texture(uAmbientOcclusion, ScreenSpaceCoords).r;
 
+    WriteTextureFeedback(MATERIAL_DATA.TextureFeedbackSlot, fsIn.TextureCoords);
+
     vec2 textureCoords = fsIn.TextureCoords;
     if (MATERIAL_DATA.bHasDisplacementMap)
     {
@@ -43,7 +47,7 @@ void main()
     vec3 normal;
     if (MATERIAL_DATA.bHasNormalMap)
     {
-        normal = normalize(fsIn.TBN * ((texture(MATERIAL_DATA.NormalMap, textureCoords).rgb * 2) - 1));
+        normal = normalize(fsIn.TBN * UnpackNormalMap(texture(MATERIAL_DATA.NormalMap, textureCoords)));
     }
     else
     {
@@ -55,28 +59,36 @@ void main()
 
     vec3 ambient = diffuseColor * uAmbientStrength;
 
-    float shadowFactor = 1.0;
+    vec3 result = ambient;
 
-    LightContribution lightCntrb;
-    if (uLightType == DIRECTIONAL_LIGHT)
-    {
-        shadowFactor = CalculateShadow(fsIn.FragPos, normal, normalize(uLightDirection));
-        lightCntrb   = CalculateDirectionalLightContribution(toViewN, normal, MATERIAL_DATA.Shininess);
-    }
-    else if (uLightType == POINT_LIGHT)
-    {
-        shadowFactor = CalculateShadowCubemap(fsIn.FragPos, normal, uLightPosition);
-        lightCntrb   = CalculatePointLightContribution(fsIn.FragPos, toViewN, normal, MATERIAL_DATA.Shininess);
-    }
-    else if (uLightType == SPOT_LIGHT)
+    uint clusterIdx = GetClusterIndex(gl_FragCoord.xy, fsIn.FragPos);
+    uint numLights  = GetClusterNumLights(clusterIdx);
+    for (uint i = 0; i < numLights; ++i)
     {
-        shadowFactor = CalculateShadow(fsIn.FragPos, normal, normalize(uLightDirection));
-        lightCntrb   = CalculateSpotLightContribution(fsIn.FragPos, toViewN, normal, MATERIAL_DATA.Shininess);
+        Light = Lights[GetClusterLightIndex(clusterIdx, i)];
+
+        float shadowFactor = 1.0;
+
+        LightContribution lightCntrb;
+        if (Light.Type == DIRECTIONAL_LIGHT)
+        {
+            shadowFactor = CalculateShadow(fsIn.FragPos, normal, normalize(Light.Direction));
+            lightCntrb   = CalculateDirectionalLightContribution(toViewN, normal, MATERIAL_DATA.Shininess);
+        }
+        else if (Light.Type == POINT_LIGHT)
+        {
+            shadowFactor = CalculateShadowCubemap(fsIn.FragPos, normal, Light.Position);
+            lightCntrb   = CalculatePointLightContribution(fsIn.FragPos, toViewN, normal, MATERIAL_DATA.Shininess);
+        }
+        else
+        {
+            shadowFactor = CalculateShadow(fsIn.FragPos, normal, normalize(Light.Direction));
+            lightCntrb   = CalculateSpotLightContribution(fsIn.FragPos, toViewN, normal, MATERIAL_DATA.Shininess);
+        }
+
+        vec3 fragColor = (diffuseColor * lightCntrb.Diffuse) + (specularColor * lightCntrb.Specular);
+        result += fragColor * lightCntrb.Attenuation * Light.Intensity * shadowFactor;
     }
 
-    vec3 fragColor = (diffuseColor * lightCntrb.Diffuse) + (specularColor * lightCntrb.Specular);
-    
-    fragColor *= lightCntrb.Attenuation * uLightIntensity * shadowFactor;
-    
-    oFragColor     = vec4(ambient + fragColor, 1);
+    oFragColor = vec4(result, 1);
 }
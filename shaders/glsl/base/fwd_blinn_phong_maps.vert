@@ -23,7 +23,7 @@ vsOut;
 
 void main()
 {
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
 
     mat3 normalMatrix = transpose(inverse(mat3(INSTANCE_DATA.ModelMatrix)));
     vec4 worldPos = INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1);
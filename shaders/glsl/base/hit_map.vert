@@ -10,7 +10,7 @@ out vec4 oWorldPos;
 
 void main()
 {
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
     vec4 WorldPos = INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1);
     oWorldPos = WorldPos;
     gl_Position = uProjection * uView * WorldPos;
@@ -0,0 +1,88 @@
+#define DIRECTIONAL_LIGHT 1
+#define POINT_LIGHT 2
+#define SPOT_LIGHT 3
+#define MAX_SHADOW_CASCADES 6
+#define MAX_CASCADED_LIGHTS 4
+
+// Has to match the cluster grid in forward_renderer.hpp
+#define CLUSTER_GRID_SIZE_X 16
+#define CLUSTER_GRID_SIZE_Y 9
+#define CLUSTER_GRID_SIZE_Z 24
+#define NUM_CLUSTERS (CLUSTER_GRID_SIZE_X * CLUSTER_GRID_SIZE_Y * CLUSTER_GRID_SIZE_Z)
+#define MAX_LIGHTS_PER_CLUSTER 128
+
+// Has to match FLightData in lights.hpp
+struct FLight
+{
+    mat4  LightMatrix;
+    vec3  Color;
+    int   Type;
+    vec3  Position;
+    float AttenuationRadius;
+    vec3  Direction;
+    float InvAttenuationRadiusSquared;
+    float Intensity;
+    float InnerCutOffCos;
+    float OuterCutOffCos;
+    float FarPlane;
+    uint  ShadowAtlasTiles[6]; // Packed tiles in the shadow atlas, one per cube face for point lights
+    int   CastsShadows;
+    int   CascadesIdx;
+};
+
+// Has to match FLightCascadesData in lights.hpp
+struct FLightCascades
+{
+    mat4  Matrices[MAX_SHADOW_CASCADES];
+    uvec2 ShadowMaps[MAX_SHADOW_CASCADES];
+    float FarPlanes[MAX_SHADOW_CASCADES];
+    int   Count;
+};
+
+// Directional lights are stored first, they're not clustered as they affect every fragment
+layout(std430, binding = 6) buffer LightsDataBlock
+{
+    uint           NumLights;
+    uint           NumDirectionalLights;
+    uvec2          ShadowAtlas; // Bindless handles of the atlases with the shadow maps of spot lights and the cube faces of point lights
+    uvec2          CubeShadowAtlas;
+    FLightCascades LightCascades[MAX_CASCADED_LIGHTS];
+    FLight         Lights[];
+};
+
+// Written by cluster_lights.comp, each cluster has room for MAX_LIGHTS_PER_CLUSTER indices of the lights that affect it
+layout(std430, binding = 7) buffer ClusterLightsBlock
+{
+    uint ClusterNumLights[NUM_CLUSTERS];
+    uint ClusterLightIndices[];
+};
+
+// The view frustum is split into tiles in screen space and exponentially distributed slices in depth
+uint GetClusterIndex(in vec2 FragCoord, in vec3 FragPos)
+{
+    float ViewSpaceZ = -(uView * vec4(FragPos, 1.0)).z;
+    float Slice      = log(max(ViewSpaceZ, uNearPlane) / uNearPlane) / log(uFarPlane / uNearPlane) * CLUSTER_GRID_SIZE_Z;
+
+    uvec3 Cluster = uvec3(FragCoord / uViewportSize * vec2(CLUSTER_GRID_SIZE_X, CLUSTER_GRID_SIZE_Y), Slice);
+    Cluster       = min(Cluster, uvec3(CLUSTER_GRID_SIZE_X - 1, CLUSTER_GRID_SIZE_Y - 1, CLUSTER_GRID_SIZE_Z - 1));
+
+    return Cluster.x + (Cluster.y * CLUSTER_GRID_SIZE_X) + (Cluster.z * CLUSTER_GRID_SIZE_X * CLUSTER_GRID_SIZE_Y);
+}
+
+// Number of lights affecting the cluster, including the directional lights
+uint GetClusterNumLights(in uint ClusterIdx) { return NumDirectionalLights + ClusterNumLights[ClusterIdx]; }
+
+uint GetClusterLightIndex(in uint ClusterIdx, in uint Idx)
+{
+    return Idx < NumDirectionalLights ? Idx : ClusterLightIndices[(ClusterIdx * MAX_LIGHTS_PER_CLUSTER) + Idx - NumDirectionalLights];
+}
+
+// Unpacks a tile packed by CShadowAtlas::PackTile(), returns it's offset and size in the atlas' UV space
+vec4 GetShadowAtlasTileRect(in uint PackedTile, in vec2 AtlasSize)
+{
+    uvec3 Tile = uvec3(PackedTile & 0x3FF, (PackedTile >> 10) & 0x3FF, (PackedTile >> 20) & 0x3FF) * 16;
+    return vec4(vec2(Tile.xy) / AtlasSize, vec2(Tile.zz) / AtlasSize);
+}
+
+// The light currently being evaluated, the lighting functions read it's parameters from here
+FLight Light;
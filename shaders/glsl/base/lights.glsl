@@ -1,33 +1,4 @@
-#define DIRECTIONAL_LIGHT 1
-#define POINT_LIGHT 2
-#define SPOT_LIGHT 3
-#define MAX_SHADOW_CASCADES 6
-
-uniform int  uLightType;
-uniform vec3 uLightColor;
-uniform vec3 uLightPosition;
-
-uniform vec3 uLightDirection;
-
-uniform float uLightAttenuationRadius;
-uniform float uLightInvAttenuationRadiusSquared;
-uniform float uLightIntensity;
-
-uniform float uLightInnerCutOffCos;
-uniform float uLightOuterCutOffCos;
-
-uniform mat4  uLightMatrix;
-uniform float uLightFarPlane;
-
-uniform bool        uLightCastsShadows;
-uniform sampler2D   uLightShadowMap;
-uniform samplerCube uLightShadowCube;
-
-uniform int       uCascadeCount;
-uniform mat4      uCascadeMatrices[MAX_SHADOW_CASCADES];
-uniform float     uCascadeFarPlanes[MAX_SHADOW_CASCADES];
-uniform sampler2D uCascadeShadowMaps[MAX_SHADOW_CASCADES];
-uniform vec3      uCascadeFrustumPositions[MAX_SHADOW_CASCADES];
+#include "light_data.glsl"
 
 struct LightContribution
 {
@@ -38,9 +9,9 @@ struct LightContribution
 
 LightContribution CalculateDirectionalLightContribution(in vec3 ToViewN, in vec3 Normal, in int Shininess)
 {
-    vec3  ToLight = -uLightDirection;
+    vec3  ToLight = -Light.Direction;
     float NdotL   = max(dot(Normal, ToLight), 0.0);
-    vec3  diffuse = NdotL * uLightColor;
+    vec3  diffuse = NdotL * Light.Color;
 
     vec3 specular = vec3(0);
     // Cut specular contribution on back-facing sides
@@ -48,19 +19,19 @@ LightContribution CalculateDirectionalLightContribution(in vec3 ToViewN, in vec3
     {
         vec3  halfWayN         = normalize(ToViewN + ToLight);
         float specularStrength = pow(max(dot(Normal, halfWayN), 0.0), Shininess);
-        specular               = specularStrength * uLightColor;
+        specular               = specularStrength * Light.Color;
     }
 
-    return LightContribution(1, diffuse * uLightIntensity * NdotL, specular * uLightIntensity * NdotL);
+    return LightContribution(1, diffuse * Light.Intensity * NdotL, specular * Light.Intensity * NdotL);
 }
 
 LightContribution _CalculatePointLightContribution(in vec3 FragPos, in vec3 ToViewN, in vec3 Normal, in vec3 LightDirN, in int Shininess)
 {
-    float distanceToLight = length(FragPos - uLightPosition);
+    float distanceToLight = length(FragPos - Light.Position);
     float NdotL           = max(dot(Normal, -LightDirN), 0.0);
 
     LightContribution ctrb;
-    ctrb.Diffuse  = NdotL * uLightColor;
+    ctrb.Diffuse  = NdotL * Light.Color;
     ctrb.Specular = vec3(0);
 
     // Cut specular contribution on back-facing sides
@@ -68,11 +39,11 @@ LightContribution _CalculatePointLightContribution(in vec3 FragPos, in vec3 ToVi
     {
         vec3  halfWayN         = normalize(ToViewN + (-LightDirN));
         float specularStrength = pow(max(dot(Normal, halfWayN), 0.0), Shininess);
-        ctrb.Specular          = specularStrength * uLightColor;
+        ctrb.Specular          = specularStrength * Light.Color;
     }
 
     float distanceSquare = distanceToLight * distanceToLight;
-    float factor         = distanceSquare * uLightInvAttenuationRadiusSquared;
+    float factor         = distanceSquare * Light.InvAttenuationRadiusSquared;
     float smoothFactor   = max(1.0 - factor * factor, 0.0);
     ctrb.Attenuation     = (smoothFactor * smoothFactor) / max(distanceSquare, 1e-4);
 
@@ -81,16 +52,16 @@ LightContribution _CalculatePointLightContribution(in vec3 FragPos, in vec3 ToVi
 
 LightContribution CalculatePointLightContribution(in vec3 FragPos, in vec3 ToViewN, in vec3 Normal, in int Shininess)
 {
-    return _CalculatePointLightContribution(FragPos, ToViewN, Normal, normalize(FragPos - uLightPosition), Shininess);
+    return _CalculatePointLightContribution(FragPos, ToViewN, Normal, normalize(FragPos - Light.Position), Shininess);
 }
 
 LightContribution CalculateSpotLightContribution(in vec3 FragPos, in vec3 ToViewN, in vec3 Normal, in int Shininess)
 {
-    vec3 toLightN = normalize(uLightPosition - FragPos);
+    vec3 toLightN = normalize(Light.Position - FragPos);
 
-    float epsilon   = uLightInnerCutOffCos - uLightOuterCutOffCos;
-    float theta     = dot(toLightN, normalize(-uLightDirection));
-    float intensity = clamp((theta - uLightOuterCutOffCos) / epsilon, 0.0, 1.0);
+    float epsilon   = Light.InnerCutOffCos - Light.OuterCutOffCos;
+    float theta     = dot(toLightN, normalize(-Light.Direction));
+    float intensity = clamp((theta - Light.OuterCutOffCos) / epsilon, 0.0, 1.0);
 
     LightContribution ctrb = _CalculatePointLightContribution(FragPos, ToViewN, Normal, normalize(-toLightN), Shininess);
     return LightContribution(ctrb.Attenuation * intensity, ctrb.Diffuse, ctrb.Specular);
@@ -0,0 +1,7 @@
+// Normal maps may be stored with two channels only (BC5), so Z is reconstructed from XY instead of being read from the blue channel.
+// Tangent space normals always point out of the surface, so this works for the three channel ones as well.
+vec3 UnpackNormalMap(vec4 InNormalMapSample)
+{
+    vec2 XY = (InNormalMapSample.rg * 2.0) - 1.0;
+    return vec3(XY, sqrt(max(1.0 - dot(XY, XY), 0.0)));
+}
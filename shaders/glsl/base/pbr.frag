@@ -29,4 +29,18 @@ layout(std430, binding = 3) buffer MaterialDataDataBlock { FPBRMaterial Material
 
 out vec4 oFragColor;
 
-void main() { oFragColor = vec4(CalculatePBR(normalize(fsIn.InterpolatedNormal), MATERIAL_DATA.Roughness, MATERIAL_DATA.Metallic, MATERIAL_DATA.Albedo), 1.0); }
\ No newline at end of file
+void main()
+{
+    vec3 Normal = normalize(fsIn.InterpolatedNormal);
+    vec3 Result = CalculatePBRAmbient(MATERIAL_DATA.Albedo);
+
+    uint ClusterIdx = GetClusterIndex(gl_FragCoord.xy, fsIn.FragPos);
+    uint NumLights  = GetClusterNumLights(ClusterIdx);
+    for (uint i = 0; i < NumLights; ++i)
+    {
+        Light = Lights[GetClusterLightIndex(ClusterIdx, i)];
+        Result += CalculatePBR(Normal, MATERIAL_DATA.Roughness, MATERIAL_DATA.Metallic, MATERIAL_DATA.Albedo);
+    }
+
+    oFragColor = vec4(Result, 1.0);
+}
\ No newline at end of file
@@ -44,19 +44,19 @@ vec3 CalculatePBR(vec3 InNormal, float InRoughness, float InMetallic, vec3 InAlb
 
     // calculate light radiance
     vec3 Radiance = vec3(1);
-    if (uLightType == DIRECTIONAL_LIGHT)
+    if (Light.Type == DIRECTIONAL_LIGHT)
     {
-        L        = -uLightDirection;
+        L        = -Light.Direction;
         Radiance = CalculateDirectionalLightRadiance(V, InNormal);
     }
-    else if (uLightType == POINT_LIGHT)
+    else if (Light.Type == POINT_LIGHT)
     {
-        L        = normalize(uLightPosition - fsIn.FragPos);
+        L        = normalize(Light.Position - fsIn.FragPos);
         Radiance = CalculatePointLightRadiance(fsIn.FragPos, V, InNormal);
     }
-    else if (uLightType == SPOT_LIGHT)
+    else if (Light.Type == SPOT_LIGHT)
     {
-        L        = normalize(uLightPosition - fsIn.FragPos);
+        L        = normalize(Light.Position - fsIn.FragPos);
         Radiance = CalculateSpotLightRadiance(fsIn.FragPos, V, InNormal);
     }
 
@@ -77,10 +77,12 @@ vec3 CalculatePBR(vec3 InNormal, float InRoughness, float InMetallic, vec3 InAlb
 
     float NdotL = max(dot(InNormal, L), 0.0);
 
-    vec3 Lo = (kD * InAlbedo / PI + specular) * Radiance * NdotL;
-
-    float ao      = 0.1;
-    vec3  ambient = vec3(0.03) * InAlbedo * ao;
+    return (kD * InAlbedo / PI + specular) * Radiance * NdotL;
+}
 
-    return ambient + Lo;
+// Constant ambient term, added once and not per light
+vec3 CalculatePBRAmbient(vec3 InAlbedo)
+{
+    float ao = 0.1;
+    return vec3(0.03) * InAlbedo * ao;
 }
\ No newline at end of file
@@ -9,7 +9,7 @@ layout(location = 0) in vec3 aPosition;
 void main() 
 {
     int InstanceID;
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
 
     gl_Position = INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1.0);
 }
\ No newline at end of file
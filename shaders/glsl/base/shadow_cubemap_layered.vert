@@ -0,0 +1,32 @@
+#version 450 core
+
+#extension GL_ARB_shader_viewport_layer_array : enable
+#extension GL_AMD_vertex_shader_viewport_index : enable
+
+#include "batch_instance.glsl"
+
+in int gl_InstanceID;
+
+layout(location = 0) in vec3 aPosition;
+
+uniform mat4 uLightMatrices[6];
+
+out vec4 FragPos;
+
+void main()
+{
+    int InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
+
+    // Each instance is drawn to a single cube face, the instances were culled against the faces' frustums when they were batched
+    int Face = MATERIAL_DATA_INDEX;
+
+    FragPos = INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1.0);
+    gl_Position = uLightMatrices[Face] * FragPos;
+
+    // Each of the faces is a separate tile of the cube shadow atlas, with it's own viewport.
+    // The renderer doesn't use this shader when neither of the extensions is supported.
+#if defined(GL_ARB_shader_viewport_layer_array) || defined(GL_AMD_vertex_shader_viewport_index)
+    gl_ViewportIndex = Face;
+#endif
+}
\ No newline at end of file
@@ -12,7 +12,7 @@ uniform mat4 uLightSpaceMatrix;
 void main()
 {
     int InstanceID;
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
 
     FragPos = INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1.0);
     gl_Position = uLightSpaceMatrix * FragPos;
@@ -1,9 +1,9 @@
 #version 450 core
 
-layout(location = 0) in vec3 aPosition;
-
 #include "batch_instance.glsl"
 
+layout(location = 0) in vec3 aPosition;
+
 in int gl_InstanceID;
 flat out int InstanceID;
 
@@ -11,6 +11,6 @@ uniform mat4 uLightMatrix;
 
 void main()
 {
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
     gl_Position = uLightMatrix * INSTANCE_DATA.ModelMatrix * vec4(aPosition, 1.0);
 }
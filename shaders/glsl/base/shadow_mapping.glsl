@@ -1,38 +1,42 @@
 float CalculateShadow(in vec3 FragPos, in vec3 NormalN, in vec3 LightDirN)
 {
-    if (!uLightCastsShadows)
+    if (Light.CastsShadows == 0)
     {
         return 1;
     }
 
-    sampler2D ShadowMap         = uLightShadowMap;
+    sampler2D ShadowMap;
+    vec4      TileRect          = vec4(0, 0, 1, 1); // Cascades have their own textures
     vec4      lightSpaceFragPos = vec4(0);
     float     bias              = 0;
     int       numPCFSamples     = uNumPCFSamples;
-    if (uLightType == DIRECTIONAL_LIGHT)
+    if (Light.Type == DIRECTIONAL_LIGHT)
     {
         float FragViewSpaceZ = -(uView * vec4(FragPos, 1.0)).z;
 
         int CascadeIndex = 0;
-        while (FragViewSpaceZ > uCascadeFarPlanes[CascadeIndex] && CascadeIndex < uCascadeCount)
+        while (CascadeIndex < LightCascades[Light.CascadesIdx].Count - 1 && FragViewSpaceZ > LightCascades[Light.CascadesIdx].FarPlanes[CascadeIndex])
         {
             CascadeIndex += 1;
         }
 
-        lightSpaceFragPos = uCascadeMatrices[CascadeIndex] * vec4(FragPos, 1.0);
-        ShadowMap         = uCascadeShadowMaps[CascadeIndex];
+        lightSpaceFragPos = LightCascades[Light.CascadesIdx].Matrices[CascadeIndex] * vec4(FragPos, 1.0);
+        ShadowMap         = sampler2D(LightCascades[Light.CascadesIdx].ShadowMaps[CascadeIndex]);
         numPCFSamples     = 5; // this should be be calculated based on the cascade's far plane and other things or just set per light
     }
     else
     {
-        lightSpaceFragPos = uLightMatrix * vec4(FragPos, 1.0);
-        bias              = max(0.05 * (1.0 - dot(NormalN, normalize(uLightPosition - FragPos))), 0.005);
+        ShadowMap         = sampler2D(ShadowAtlas);
+        TileRect          = GetShadowAtlasTileRect(Light.ShadowAtlasTiles[0], textureSize(ShadowMap, 0));
+        lightSpaceFragPos = Light.LightMatrix * vec4(FragPos, 1.0);
+        bias              = max(0.05 * (1.0 - dot(NormalN, normalize(Light.Position - FragPos))), 0.005);
     }
 
     vec3 clipSpaceCoords = lightSpaceFragPos.xyz / lightSpaceFragPos.w;
     clipSpaceCoords      = (clipSpaceCoords * 0.5) + 0.5;
 
-    if (clipSpaceCoords.z > 1.0)
+    // Fragments outside of the light's frustum are lit
+    if (clipSpaceCoords.z > 1.0 || any(lessThan(clipSpaceCoords.xy, vec2(0))) || any(greaterThan(clipSpaceCoords.xy, vec2(1))))
     {
         return 1;
     }
@@ -43,16 +47,21 @@ float CalculateShadow(in vec3 FragPos, in vec3 NormalN, in vec3 LightDirN)
     float samplesSum = 0;
     vec2  texelSize  = 1.0 / textureSize(ShadowMap, 0);
     int   numSamples = numPCFSamples / 2;
+
+    // PCF samples are clamped to the tile, so they don't read the neighbouring tiles of the atlas
+    vec2 shadowMapUV = TileRect.xy + (clipSpaceCoords.xy * TileRect.zw);
+    vec2 minUV       = TileRect.xy + (texelSize * 0.5);
+    vec2 maxUV       = TileRect.xy + TileRect.zw - (texelSize * 0.5);
     if (uNumPCFSamples == 1)
     {
-        float closestDepth = texture(ShadowMap, clipSpaceCoords.xy).r;
+        float closestDepth = texture(ShadowMap, shadowMapUV).r;
         return currentDepth > closestDepth ? 0.0 : 1.0;
     }
     for (int x = -numSamples; x <= numSamples; ++x)
     {
         for (int y = -numSamples; y <= numSamples; ++y)
         {
-            float closestDepth = texture(ShadowMap, clipSpaceCoords.xy + vec2(x, y) * texelSize).r;
+            float closestDepth = texture(ShadowMap, clamp(shadowMapUV + vec2(x, y) * texelSize, minUV, maxUV)).r;
             samplesSum += (currentDepth > closestDepth ? 0.0 : 1.0);
         }
     }
@@ -80,9 +89,41 @@ vec3 pcfDirections[20] = vec3[](vec3(1, 1, 1),
                                 vec3(0, -1, -1),
                                 vec3(0, 1, -1));
 
+// Faces are rendered with the same orientation as the faces of a GL cube map, so the UV within a face is calculated the same way
+vec2 GetCubeShadowAtlasUV(in vec3 Direction, in vec2 AtlasSize)
+{
+    vec3  absDirection = abs(Direction);
+    int   face;
+    float majorAxis;
+    vec2  faceUV;
+    if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z)
+    {
+        face      = Direction.x > 0 ? 0 : 1;
+        majorAxis = absDirection.x;
+        faceUV    = vec2(Direction.x > 0 ? -Direction.z : Direction.z, -Direction.y);
+    }
+    else if (absDirection.y >= absDirection.z)
+    {
+        face      = Direction.y > 0 ? 2 : 3;
+        majorAxis = absDirection.y;
+        faceUV    = vec2(Direction.x, Direction.y > 0 ? Direction.z : -Direction.z);
+    }
+    else
+    {
+        face      = Direction.z > 0 ? 4 : 5;
+        majorAxis = absDirection.z;
+        faceUV    = vec2(Direction.z > 0 ? Direction.x : -Direction.x, -Direction.y);
+    }
+    faceUV = ((faceUV / majorAxis) * 0.5) + 0.5;
+
+    vec4 tileRect  = GetShadowAtlasTileRect(Light.ShadowAtlasTiles[face], AtlasSize);
+    vec2 halfTexel = 0.5 / AtlasSize;
+    return tileRect.xy + clamp(faceUV * tileRect.zw, halfTexel, tileRect.zw - halfTexel);
+}
+
 float CalculateShadowCubemap(in vec3 FragPos, in vec3 NormalN, in vec3 LightPos)
 {
-    if (!uLightCastsShadows)
+    if (Light.CastsShadows == 0)
     {
         return 1.0;
     }
@@ -94,13 +135,16 @@ float CalculateShadowCubemap(in vec3 FragPos, in vec3 NormalN, in vec3 LightPos)
     float shadow          = 0;
     float numOfSamples    = min(uNumPCFSamples, 20);
     float viewDistance    = length(uViewPos - FragPos);
-    float diskRadius      = (1.0 + (viewDistance / uLightFarPlane)) / uLightFarPlane;
+    float diskRadius      = (1.0 + (viewDistance / Light.FarPlane)) / Light.FarPlane;
+
+    sampler2D shadowAtlas = sampler2D(CubeShadowAtlas);
+    vec2      atlasSize   = textureSize(shadowAtlas, 0);
 
     for (int i = 0; i < numOfSamples; i++)
     {
         vec3  ShadowMapCoords = normalize(toFrag + (pcfDirections[i] * diskRadius));
-        float closestDepth    = texture(uLightShadowCube, ShadowMapCoords).r;
-        closestDepth *= uLightFarPlane;
+        float closestDepth    = texture(shadowAtlas, GetCubeShadowAtlasUV(ShadowMapCoords, atlasSize)).r;
+        closestDepth *= Light.FarPlane;
         shadow += currentDepth > closestDepth ? 0.0 : 1.0;
     }
 
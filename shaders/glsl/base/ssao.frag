@@ -1,12 +1,13 @@
 #version 450 core
 
 #include "common.glsl"
+#include "depth.glsl"
 
 in vec2 inTextureCoords;
 
 out float oFragColor;
 
-uniform sampler2D uPositionsVS;
+uniform sampler2D uSceneDepth;
 uniform sampler2D uNormalsVS;
 uniform sampler2D uNoise;
 
@@ -18,8 +19,16 @@ uniform float uBias;
 
 void main()
 {
-    // Fetch position and normal in viewspace prepared by the ealier pass
-    vec3 FragPosVS = texture(uPositionsVS, inTextureCoords).xyz;
+    // Nothing was rendered there, so there's nothing to occlude
+    float FragDepth = texture(uSceneDepth, inTextureCoords).r;
+    if (FragDepth == 1.0)
+    {
+        oFragColor = 1.0;
+        return;
+    }
+
+    // Reconstruct the position in viewspace from the depth, the normal was prepared by the ealier pass
+    vec3 FragPosVS = ViewSpacePositionFromDepth(inTextureCoords, LinearizeDepth(FragDepth, uNearPlane, uFarPlane), uProjection);
     vec3 NormalVS = normalize(texture(uNormalsVS, inTextureCoords).rgb);
     vec3 RandomVec = vec3(normalize(texture(uNoise, inTextureCoords * uNoiseScale).xy), 0);
     
@@ -42,7 +51,7 @@ void main()
         Offset.xyz = (Offset.xyz * 0.5) + 0.5;
         
         // Get depth at sample's position
-        float SampledDepth = texture(uPositionsVS, Offset.xy).z;
+        float SampledDepth = -LinearizeDepth(texture(uSceneDepth, Offset.xy).r, uNearPlane, uFarPlane);
         float RangeCheck = smoothstep(0.0, 1.0, uRadius / abs(FragPosVS.z - SampledDepth));
 
         // Compare depth at sample's position and sample's depth
@@ -0,0 +1,101 @@
+#version 450 core
+
+#include "common.glsl"
+#include "depth.glsl"
+
+// Has to match NUM_HALF_RES_SSAO_SAMPLES in forward_renderer.cpp
+#define NUM_SAMPLES 16
+
+// Samples projected further than 2^MIP_OFFSET pixels away read the coarser mips of the depth chain, which keeps them cache friendly
+#define MIP_OFFSET 3
+
+in vec2 inTextureCoords;
+
+// AO accumulated over frames and the linear depth it was calculated at, so the next frame can detect disocclusions
+layout(location = 0) out vec2 oAOAndDepth;
+
+uniform sampler2D uSSAODepthChain;
+uniform sampler2D uNormalsVS;
+uniform sampler2D uSSAOHistory;
+
+uniform vec3 uSamples[NUM_SAMPLES];
+
+uniform float uRadius;
+uniform float uBias;
+
+uniform int   uFrameIndex;
+uniform bool  uHistoryValid;
+uniform float uTemporalBlend;
+
+// Takes the view space positions of the current frame to the clip space of the previous one
+uniform mat4 uViewToPreviousClip;
+
+void main()
+{
+    // Nothing was rendered there, the cleared depth linearizes to the far plane
+    float FragDepth = texelFetch(uSSAODepthChain, ivec2(gl_FragCoord.xy), 0).r;
+    if (FragDepth >= uFarPlane * 0.9999)
+    {
+        oAOAndDepth = vec2(1.0, FragDepth);
+        return;
+    }
+
+    vec3 FragPosVS = ViewSpacePositionFromDepth(inTextureCoords, FragDepth, uProjection);
+    vec3 NormalVS  = normalize(texture(uNormalsVS, inTextureCoords).rgb);
+
+    // Rotate the kernel by a per-pixel angle that changes every frame, the temporal accumulation then averages the rotations out
+    float Noise     = fract(52.9829189 * fract(dot(gl_FragCoord.xy, vec2(0.06711056, 0.00583715))));
+    float Angle     = 6.28318530 * fract(Noise + (float(uFrameIndex) * 0.61803398));
+    vec3  RandomVec = vec3(cos(Angle), sin(Angle), 0);
+
+    // Build a TBN matrix that we'll use to transform the samples from tangent space to view space
+    vec3 T   = normalize(RandomVec - NormalVS * dot(RandomVec, NormalVS));
+    vec3 B   = cross(NormalVS, T);
+    mat3 TBN = mat3(T, B, NormalVS);
+
+    vec2 DepthChainSize   = vec2(textureSize(uSSAODepthChain, 0));
+    int  DepthChainMaxMip = textureQueryLevels(uSSAODepthChain) - 1;
+
+    float Occlusion = 0;
+    for (int i = 0; i < NUM_SAMPLES; ++i)
+    {
+        vec3 SamplePosVS = FragPosVS + ((TBN * uSamples[i]) * uRadius);
+
+        // Project the sample to NDC so we can read the depth at sample's position
+        vec4 Offset = uProjection * vec4(SamplePosVS, 1.0);
+        Offset.xy   = ((Offset.xy / Offset.w) * 0.5) + 0.5;
+
+        float OffsetInPixels = length((Offset.xy - inTextureCoords) * DepthChainSize);
+        int   Mip            = clamp(int(log2(max(OffsetInPixels, 1.0))) - MIP_OFFSET, 0, DepthChainMaxMip);
+
+        float SampledDepth = -textureLod(uSSAODepthChain, Offset.xy, Mip).r;
+        float RangeCheck   = smoothstep(0.0, 1.0, uRadius / abs(FragPosVS.z - SampledDepth));
+
+        if (SampledDepth >= SamplePosVS.z + uBias)
+        {
+            Occlusion += RangeCheck;
+        }
+    }
+
+    float AO = pow(1.0 - (Occlusion / NUM_SAMPLES), uSSAOStrength);
+
+    // Reproject the pixel to the previous frame and blend with the history, unless it wasn't visible there
+    if (uHistoryValid)
+    {
+        vec4 PreviousClip = uViewToPreviousClip * vec4(FragPosVS, 1.0);
+        vec2 PreviousUV   = ((PreviousClip.xy / PreviousClip.w) * 0.5) + 0.5;
+
+        if (all(greaterThanEqual(PreviousUV, vec2(0))) && all(lessThanEqual(PreviousUV, vec2(1))))
+        {
+            vec2 History = texture(uSSAOHistory, PreviousUV).rg;
+
+            // W of the previous clip space position is the depth the pixel would have had in the previous frame
+            if (abs(History.g - PreviousClip.w) < (0.1 * PreviousClip.w))
+            {
+                AO = mix(History.r, AO, uTemporalBlend);
+            }
+        }
+    }
+
+    oAOAndDepth = vec2(AO, FragDepth);
+}
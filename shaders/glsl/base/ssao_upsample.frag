@@ -0,0 +1,51 @@
+#version 450 core
+
+#include "common.glsl"
+#include "depth.glsl"
+
+// How quickly the weight of a half resolution sample falls off with the relative difference between it's depth and the pixel's depth
+#define DEPTH_SENSITIVITY 50.0
+
+in vec2 inTextureCoords;
+
+out float oFragColor;
+
+uniform sampler2D uSceneDepth;
+
+// Half resolution AO in the red channel and the linear depth it was calculated at in the green one
+uniform sampler2D uSSAOHalfRes;
+
+void main()
+{
+    float FragDepth = texelFetch(uSceneDepth, ivec2(gl_FragCoord.xy), 0).r;
+    if (FragDepth == 1.0)
+    {
+        oFragColor = 1.0;
+        return;
+    }
+
+    float LinearDepth = LinearizeDepth(FragDepth, uNearPlane, uFarPlane);
+
+    ivec2 HalfResSize   = textureSize(uSSAOHalfRes, 0);
+    vec2  HalfResCoords = (inTextureCoords * vec2(HalfResSize)) - 0.5;
+    ivec2 BaseCoords    = ivec2(floor(HalfResCoords));
+    vec2  Fraction      = HalfResCoords - vec2(BaseCoords);
+
+    const ivec2 Offsets[4] = ivec2[](ivec2(0, 0), ivec2(1, 0), ivec2(0, 1), ivec2(1, 1));
+    float BilinearWeights[4] = float[]((1.0 - Fraction.x) * (1.0 - Fraction.y), Fraction.x * (1.0 - Fraction.y), (1.0 - Fraction.x) * Fraction.y, Fraction.x * Fraction.y);
+
+    // Bilinear upsample where the samples from the other side of a depth discontinuity get almost no weight, so AO doesn't bleed over the edges
+    float AO          = 0;
+    float TotalWeight = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        vec2  Sample = texelFetch(uSSAOHalfRes, clamp(BaseCoords + Offsets[i], ivec2(0), HalfResSize - 1), 0).rg;
+        float Weight = BilinearWeights[i] * exp(-DEPTH_SENSITIVITY * abs(Sample.g - LinearDepth) / LinearDepth);
+        Weight       = max(Weight, 1e-5);
+
+        AO += Sample.r * Weight;
+        TotalWeight += Weight;
+    }
+
+    oFragColor = AO / TotalWeight;
+}
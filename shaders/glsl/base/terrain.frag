@@ -3,6 +3,8 @@
 #include "common.glsl"
 #include "terrain_uniforms.glsl"
 #include "batch_instance.glsl"
+#include "normal_map.glsl"
+#include "texture_feedback.glsl"
 
 flat in int InstanceID;
 
@@ -25,6 +27,9 @@ void main()
     vec3 Normal  = normalize(fsIn.InterpolatedNormal);
     vec3 ToViewN = normalize(uViewPos - fsIn.FragPos);
 
+    // The layers' tiling is applied by the streamer
+    WriteTextureFeedback(MATERIAL_DATA.TextureFeedbackSlot, fsIn.TextureCoords);
+
     float ShadowFactor = 1.0;
 
     int LayerIndex = -1;
@@ -58,7 +63,7 @@ void main()
         if (MATERIAL_DATA.Layers[LayerIndex].bHasNormalMap)
         {
             sampler2D LayerNormalMap = MATERIAL_DATA.Layers[LayerIndex].NormalMap;
-            Normal                   = texture(LayerNormalMap, LayerTextureCoords).rgb * 2 - 1;
+            Normal                   = UnpackNormalMap(texture(LayerNormalMap, LayerTextureCoords));
         }
 
         if (LayerIndex - 1 > -1)
@@ -76,29 +81,39 @@ void main()
             if (MATERIAL_DATA.Layers[LayerIndex - 1].bHasNormalMap)
             {
                 sampler2D PrevLayerNormalMap = MATERIAL_DATA.Layers[LayerIndex - 1].NormalMap;
-                Normal                       = mix(Normal, texture(PrevLayerNormalMap, PrevLayerTextureCoords).rgb * 2 - 1, BlendFactor);
+                Normal                       = mix(Normal, UnpackNormalMap(texture(PrevLayerNormalMap, PrevLayerTextureCoords)), BlendFactor);
             }
         }
     }
     
-    LightContribution LightCntrb;
-    if (uLightType == DIRECTIONAL_LIGHT)
-    {
-        ShadowFactor = CalculateShadow(fsIn.FragPos, Normal, normalize(uLightDirection));
-        LightCntrb   = CalculateDirectionalLightContribution(ToViewN, Normal, 32);
-    }
-    else if (uLightType == POINT_LIGHT)
-    {
-        ShadowFactor = CalculateShadowCubemap(fsIn.FragPos, Normal, uLightPosition);
-        LightCntrb   = CalculatePointLightContribution(fsIn.FragPos, ToViewN, Normal, 32);
-    }
-    else if (uLightType == SPOT_LIGHT)
+    vec3 Result = vec3(0);
+
+    uint ClusterIdx = GetClusterIndex(gl_FragCoord.xy, fsIn.FragPos);
+    uint NumLights  = GetClusterNumLights(ClusterIdx);
+    for (uint i = 0; i < NumLights; ++i)
     {
-        ShadowFactor = CalculateShadow(fsIn.FragPos, Normal, normalize(uLightDirection));
-        LightCntrb   = CalculateSpotLightContribution(fsIn.FragPos, ToViewN, Normal, 32);
+        Light = Lights[GetClusterLightIndex(ClusterIdx, i)];
+
+        LightContribution LightCntrb;
+        if (Light.Type == DIRECTIONAL_LIGHT)
+        {
+            ShadowFactor = CalculateShadow(fsIn.FragPos, Normal, normalize(Light.Direction));
+            LightCntrb   = CalculateDirectionalLightContribution(ToViewN, Normal, 32);
+        }
+        else if (Light.Type == POINT_LIGHT)
+        {
+            ShadowFactor = CalculateShadowCubemap(fsIn.FragPos, Normal, Light.Position);
+            LightCntrb   = CalculatePointLightContribution(fsIn.FragPos, ToViewN, Normal, 32);
+        }
+        else
+        {
+            ShadowFactor = CalculateShadow(fsIn.FragPos, Normal, normalize(Light.Direction));
+            LightCntrb   = CalculateSpotLightContribution(fsIn.FragPos, ToViewN, Normal, 32);
+        }
+
+        vec3 FragColor = TerrainDiffuse * (LightCntrb.Diffuse + LightCntrb.Specular) * LightCntrb.Attenuation;
+        Result += (FragColor * ShadowFactor) + FragColor * uAmbientStrength;
     }
 
-    
-    vec3 FragColor =  TerrainDiffuse * (LightCntrb.Diffuse + LightCntrb.Specular) * LightCntrb.Attenuation;
-    oFragColor     = vec4((FragColor * ShadowFactor) + FragColor * uAmbientStrength, 1);
+    oFragColor = vec4(Result, 1);
 }
\ No newline at end of file
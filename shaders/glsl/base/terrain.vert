@@ -21,7 +21,7 @@ vsOut;
 
 void main()
 {
-    InstanceID = gl_InstanceID;
+    InstanceID = BATCH_INSTANCE_ID;
 
     vec4 WorldPosition = vec4(aPosition, 1);
 
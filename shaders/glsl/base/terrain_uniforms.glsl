@@ -16,6 +16,7 @@ struct FTerrainMaterial
 {
     FTerrainLayer Layers[MAX_TERRAIN_LAYERS];
     int           NumLayers;
+    uint          TextureFeedbackSlot;
 };
 
 layout(std430, binding = 3) buffer MaterialDataDataBlock { FTerrainMaterial MaterialData[]; };
\ No newline at end of file
@@ -0,0 +1,26 @@
+// Texture streaming feedback, read back by CTextureStreamer. Materials sampling streamed textures get a slot in the buffer,
+// their fragments write the finest UV footprint they see to it and the streamer turns it into the mips the textures need.
+// Only one fragment of each 8x8 tile writes, the fragment changes every frame, so it behaves like a low resolution feedback target.
+#define TEXTURE_FEEDBACK_TILE_SIZE 8u
+#define TEXTURE_FEEDBACK_INVALID_SLOT 0xFFFFFFFFu
+
+layout(std430, binding = 8) buffer TextureFeedbackBlock { uint TextureFeedback[]; };
+
+void WriteTextureFeedback(uint InFeedbackSlot, vec2 InTextureCoords)
+{
+    // Derivatives have to be taken in uniform control flow
+    vec2 dUVdx = dFdx(InTextureCoords);
+    vec2 dUVdy = dFdy(InTextureCoords);
+
+    uvec2 TilePixel = uvec2(gl_FragCoord.xy) % TEXTURE_FEEDBACK_TILE_SIZE;
+    uint  FramePixel = (uFrameNumber * 37u) % (TEXTURE_FEEDBACK_TILE_SIZE * TEXTURE_FEEDBACK_TILE_SIZE);
+    if (InFeedbackSlot == TEXTURE_FEEDBACK_INVALID_SLOT || (TilePixel.y * TEXTURE_FEEDBACK_TILE_SIZE + TilePixel.x) != FramePixel)
+    {
+        return;
+    }
+
+    // log2 of the footprint is the mip level for a 1x1 texture, the streamer adds log2 of the texture size.
+    // Stored as biased fixed point, so the finest footprint wins the atomicMin.
+    float Log2Footprint = 0.5 * log2(max(max(dot(dUVdx, dUVdx), dot(dUVdy, dUVdy)), 1e-20));
+    atomicMin(TextureFeedback[InFeedbackSlot], uint(clamp((Log2Footprint + 32.0) * 16.0, 0.0, 65535.0)));
+}
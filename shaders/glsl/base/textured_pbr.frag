@@ -38,7 +38,8 @@ struct FTexturedPBRMaterial
     float Roughness;
     float Metallic;
 
-    int Flags;
+    int  Flags;
+    uint TextureFeedbackSlot;
 };
 
 #include "pbr.glsl"
@@ -46,6 +47,8 @@ struct FTexturedPBRMaterial
 layout(std430, binding = 3) buffer MaterialDataDataBlock { FTexturedPBRMaterial MaterialData[]; };
 
 #include "parallax_occlusion.glsl"
+#include "normal_map.glsl"
+#include "texture_feedback.glsl"
 
 out vec4 oFragColor;
 
@@ -54,6 +57,8 @@ void main()
     vec3 ToViewN = normalize(uViewPos - fsIn.FragPos);
     vec2 UV      = fsIn.TextureCoords;
 
+    WriteTextureFeedback(MATERIAL_DATA.TextureFeedbackSlot, fsIn.TextureCoords);
+
     if (bool(MATERIAL_DATA.Flags & HAS_DISPLACEMENT))
     {
         UV = ParallaxOcclusionMapping(fsIn.inverseTBN * ToViewN, fsIn.TextureCoords, MATERIAL_DATA.DisplacementMap);
@@ -66,27 +71,13 @@ void main()
     vec3 Normal;
     if (bool(MATERIAL_DATA.Flags & HAS_NORMAL))
     {
-        Normal = normalize(fsIn.TBN * ((texture(MATERIAL_DATA.NormalMap, UV).rgb * 2) - 1));
+        Normal = normalize(fsIn.TBN * UnpackNormalMap(texture(MATERIAL_DATA.NormalMap, UV)));
     }
     else
     {
         Normal = normalize(fsIn.InterpolatedNormal);
     }
 
-    float ShadowFactor = 1;
-    if (uLightType == DIRECTIONAL_LIGHT)
-    {
-        ShadowFactor = CalculateShadow(fsIn.FragPos, Normal, normalize(uLightDirection));
-    }
-    else if (uLightType == POINT_LIGHT)
-    {
-        ShadowFactor = CalculateShadowCubemap(fsIn.FragPos, Normal, uLightPosition);
-    }
-    else if (uLightType == SPOT_LIGHT)
-    {
-        ShadowFactor = CalculateShadow(fsIn.FragPos, Normal, normalize(uLightDirection));
-    }
-
     vec3  Albedo    = bool(MATERIAL_DATA.Flags & HAS_ALBEDO) ? texture(MATERIAL_DATA.AlbedoMap, UV).rgb : MATERIAL_DATA.Albedo;
     float Roughness = bool(MATERIAL_DATA.Flags & HAS_ROUGHNESS) ? texture(MATERIAL_DATA.RoughnessMap, UV).r : MATERIAL_DATA.Roughness;
     float Metallic  = bool(MATERIAL_DATA.Flags & HAS_METALLIC) ? texture(MATERIAL_DATA.MetallicMap, UV).r : MATERIAL_DATA.Metallic;
@@ -96,5 +87,26 @@ void main()
     float AmbientOcclusion = bool(MATERIAL_DATA.Flags & HAS_AO) ? texture(MATERIAL_DATA.AOMap, UV).r : texture(uAmbientOcclusion, ScreenSpaceCoords).r;
     vec3  Ambient          = Albedo * uAmbientStrength * AmbientOcclusion;
 
-    oFragColor = vec4(Ambient + CalculatePBR(Normal, Roughness, Metallic, Albedo) * ShadowFactor, 1.0);
+    vec3 Result = Ambient;
+
+    uint ClusterIdx = GetClusterIndex(gl_FragCoord.xy, fsIn.FragPos);
+    uint NumLights  = GetClusterNumLights(ClusterIdx);
+    for (uint i = 0; i < NumLights; ++i)
+    {
+        Light = Lights[GetClusterLightIndex(ClusterIdx, i)];
+
+        float ShadowFactor = 1;
+        if (Light.Type == POINT_LIGHT)
+        {
+            ShadowFactor = CalculateShadowCubemap(fsIn.FragPos, Normal, Light.Position);
+        }
+        else
+        {
+            ShadowFactor = CalculateShadow(fsIn.FragPos, Normal, normalize(Light.Direction));
+        }
+
+        Result += CalculatePBR(Normal, Roughness, Metallic, Albedo) * ShadowFactor;
+    }
+
+    oFragColor = vec4(Result, 1.0);
 }
\ No newline at end of file
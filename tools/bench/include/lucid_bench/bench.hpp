@@ -0,0 +1,48 @@
+#pragma once
+
+#include "common/types.hpp"
+#include "misc/math.hpp"
+#include "schemas/types.hpp"
+
+namespace lucid::scene
+{
+    class CWorld;
+    class CCamera;
+} // namespace lucid::scene
+
+namespace lucid::bench
+{
+    /** Scene used to track how the renderer scales between commits, the same settings always generate the same scene */
+    struct FSyntheticSceneSettings
+    {
+        u32 NumMeshes = 0;
+        u32 NumLights = 0;
+
+        /** Every n-th point light casts shadows, 0 means that none of them do */
+        u32 ShadowCastingLightsStep = 0;
+
+        /** Resolution of the terrain in cells, 0 means no terrain. Rounded up to a multiple of TERRAIN_CHUNK_SIZE, so it's drawn in chunks */
+        u32 TerrainSize = 0;
+
+        /** Static mesh actor asset that's instanced, the first static mesh asset in the actor database is used when it's not set */
+        const char* MeshAssetName = nullptr;
+
+        u32 Seed = 1;
+    };
+
+    /**
+     * Creates a world with the meshes scattered over a grid, the point lights floating above them, a shadow casting sun and a terrain underneath.
+     * The terrain asset is created and added to the actor database the first time a given size is used, the next runs reuse it.
+     * OutBounds are the world space bounds of the generated scene.
+     */
+    scene::CWorld* GenerateSyntheticWorld(const FSyntheticSceneSettings& InSettings, math::FAABB& OutBounds);
+
+    /** World space bounds of the static meshes and terrains, the transforms are up to date only after the world was culled once */
+    math::FAABB GetWorldBounds(scene::CWorld* InWorld);
+
+    /** Path circling around the bounds and looking at their center, used when no recorded camera path is given */
+    void MakeOrbitCameraPath(const math::FAABB& InBounds, const float& InDuration, FCameraPath& OutCameraPath);
+
+    /** Moves the camera to it's pose on the path at InTime, the keys are interpolated linearly */
+    void SampleCameraPath(const FCameraPath& InCameraPath, const float& InTime, scene::CCamera* InCamera);
+} // namespace lucid::bench
@@ -0,0 +1,67 @@
+#include "lucid_bench/bench.hpp"
+
+#include <algorithm>
+
+#include "glm/gtc/constants.hpp"
+
+#include "scene/camera.hpp"
+
+namespace lucid::bench
+{
+    /** Number of keys of the orbit, the camera moves linearly between them */
+    static constexpr u32 ORBIT_KEYS_COUNT = 128;
+
+    void MakeOrbitCameraPath(const math::FAABB& InBounds, const float& InDuration, FCameraPath& OutCameraPath)
+    {
+        const glm::vec3 Center = { (InBounds.MinXWS + InBounds.MaxXWS) / 2, (InBounds.MinYWS + InBounds.MaxYWS) / 2, (InBounds.MinZWS + InBounds.MaxZWS) / 2 };
+        const float     Radius = glm::max(InBounds.MaxXWS - InBounds.MinXWS, InBounds.MaxZWS - InBounds.MinZWS) * 0.6f + 5.f;
+        const float     Height = InBounds.MaxYWS + Radius * 0.35f;
+
+        OutCameraPath.Keys.clear();
+        OutCameraPath.Keys.reserve(ORBIT_KEYS_COUNT + 1);
+
+        for (u32 i = 0; i <= ORBIT_KEYS_COUNT; ++i)
+        {
+            const float     Angle     = glm::two_pi<float>() * i / ORBIT_KEYS_COUNT;
+            const glm::vec3 Position  = { Center.x + cosf(Angle) * Radius, Height, Center.z + sinf(Angle) * Radius };
+            const glm::vec3 Direction = glm::normalize(Center - Position);
+
+            FCameraPathKey Key;
+            Key.Time        = InDuration * i / ORBIT_KEYS_COUNT;
+            Key.Position[0] = Position.x;
+            Key.Position[1] = Position.y;
+            Key.Position[2] = Position.z;
+            Key.Yaw         = glm::degrees(Angle) + 180.f; // Keeps increasing, so interpolating between the keys doesn't wrap around
+            Key.Pitch       = glm::degrees(asinf(Direction.y));
+            OutCameraPath.Keys.push_back(Key);
+        }
+    }
+
+    void SampleCameraPath(const FCameraPath& InCameraPath, const float& InTime, scene::CCamera* InCamera)
+    {
+        const std::vector<FCameraPathKey>& Keys = InCameraPath.Keys;
+        if (Keys.empty())
+        {
+            return;
+        }
+
+        // First key after InTime
+        const auto NextKeyIt = std::upper_bound(
+          Keys.begin(), Keys.end(), InTime, [](const float& InKeyTime, const FCameraPathKey& InKey) { return InKeyTime < InKey.Time; });
+
+        const FCameraPathKey& NextKey = NextKeyIt == Keys.end() ? Keys.back() : *NextKeyIt;
+        const FCameraPathKey& PrevKey = NextKeyIt == Keys.begin() ? Keys.front() : *(NextKeyIt - 1);
+
+        const float KeysTimeDelta = NextKey.Time - PrevKey.Time;
+        const float T             = KeysTimeDelta > 0 ? glm::clamp((InTime - PrevKey.Time) / KeysTimeDelta, 0.f, 1.f) : 0.f;
+
+        const glm::vec3 PrevPosition = { PrevKey.Position[0], PrevKey.Position[1], PrevKey.Position[2] };
+        const glm::vec3 NextPosition = { NextKey.Position[0], NextKey.Position[1], NextKey.Position[2] };
+
+        InCamera->SetPosition(glm::mix(PrevPosition, NextPosition, T));
+        InCamera->SetYaw(glm::mix(PrevKey.Yaw, NextKey.Yaw, T));
+        InCamera->SetPitch(glm::mix(PrevKey.Pitch, NextKey.Pitch, T));
+        InCamera->UpdateCameraVectors();
+        InCamera->UpdateFrustumAABB();
+    }
+} // namespace lucid::bench
@@ -0,0 +1,501 @@
+#include "engine/engine.hpp"
+
+#include "common/log.hpp"
+
+#include "devices/gpu/viewport.hpp"
+
+#include "platform/window.hpp"
+#include "platform/util.hpp"
+
+#include "scene/camera.hpp"
+#include "scene/world.hpp"
+#include "scene/renderer.hpp"
+#include "scene/forward_renderer.hpp"
+
+#include "resources/resource_streamer.hpp"
+
+#include "schemas/json.hpp"
+
+#include "lucid_bench/bench.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if !DEVELOPMENT
+#error "lucid_bench reads the renderer stats, which are only gathered in DEVELOPMENT builds"
+#endif
+
+using namespace lucid;
+
+/** Upper bound of frames spent waiting for the resources of the world to be streamed in before the warmup starts */
+static constexpr u32 MAX_STREAMING_FRAMES = 10000;
+
+struct FBenchSettings
+{
+    const char* WorldFilePath      = nullptr;
+    bool        bBinaryWorld       = false;
+    const char* CameraPathFilePath = nullptr;
+    const char* ReportFilePath     = "bench_report.json";
+
+    /** 0 means one frame per simulation step over the duration of the camera path */
+    u32 NumFrames       = 0;
+    u32 NumWarmupFrames = 60;
+
+    /** Duration of the orbit used when no camera path is given */
+    float OrbitDuration = 10.f;
+
+    bench::FSyntheticSceneSettings SyntheticScene;
+};
+
+struct FPassSamples
+{
+    const char*        Name;
+    std::vector<float> GPUTimes;
+    u64                NumDrawCalls = 0;
+};
+
+struct FBenchSamples
+{
+    std::vector<float>        CPUTimes;
+    std::vector<float>        GPUTimes;
+    std::vector<float>        FrameTimes;
+    std::vector<float>        NumDrawCalls;
+    u64                       NumShadowTilesUpdated = 0;
+    std::vector<FPassSamples> Passes;
+};
+
+static void PrintUsage();
+static bool ParseArguments(const int& InArgc, char** InArgv, FBenchSettings& OutSettings);
+static void RenderFrame(scene::CWorld* InWorld, scene::FRenderView& InRenderView, FBenchSamples* OutSamples);
+static bool WriteReport(const FBenchSettings& InSettings, const FBenchSamples& InSamples, const glm::uvec2& InResolution);
+
+int main(int argc, char** argv)
+{
+    FBenchSettings Settings;
+    if (!ParseArguments(argc, argv, Settings))
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    FEngineConfig EngineConfig;
+    EngineConfig.bHotReloadShaders = false;
+    EngineConfig.bHeadless         = true;
+
+    if (GEngine.InitEngine(EngineConfig) != EEngineInitError::NONE)
+    {
+        return -1;
+    }
+
+    auto*            Renderer   = (scene::CForwardRenderer*)GEngine.GetRenderer();
+    const glm::uvec2 Resolution = Renderer->ResultResolution;
+
+    // Nothing is ever presented, the window is only there to own the context
+    platform::FWindowDefiniton BenchWindow;
+    BenchWindow.title           = "Lucid Bench";
+    BenchWindow.X               = 0;
+    BenchWindow.Y               = 0;
+    BenchWindow.Width           = Resolution.x;
+    BenchWindow.Height          = Resolution.y;
+    BenchWindow.sRGBFramebuffer = false;
+    BenchWindow.bHidden         = true;
+
+    platform::CWindow* Window = platform::CreateNewWindow(BenchWindow);
+    if (!Window)
+    {
+        LUCID_LOG(ELogLevel::ERR, "Failed to create the offscreen window");
+        GEngine.Shutdown();
+        return -1;
+    }
+    Window->Prepare();
+
+    GEngine.LoadResources();
+
+    Renderer->RendererSettings.bDrawGrid = false;
+
+    // Load or generate the world
+    scene::CWorld* World = nullptr;
+    math::FAABB    WorldBounds;
+
+    if (Settings.WorldFilePath)
+    {
+        const FSString WorldFilePath{ (char*)Settings.WorldFilePath };
+        World = Settings.bBinaryWorld ? scene::LoadWorldFromBinaryFile(WorldFilePath) : scene::LoadWorldFromJSONFile(WorldFilePath);
+    }
+    else
+    {
+        World = bench::GenerateSyntheticWorld(Settings.SyntheticScene, WorldBounds);
+    }
+
+    if (!World)
+    {
+        LUCID_LOG(ELogLevel::ERR, "Failed to create the world to benchmark");
+        GEngine.Shutdown();
+        return -1;
+    }
+
+    FCameraPath CameraPath;
+    if (Settings.CameraPathFilePath && (!ReadFromJSONFile(CameraPath, Settings.CameraPathFilePath) || CameraPath.Keys.empty()))
+    {
+        LUCID_LOG(ELogLevel::ERR, "Failed to read camera path %s", Settings.CameraPathFilePath);
+        GEngine.Shutdown();
+        return -1;
+    }
+
+    scene::CCamera Camera{ scene::ECameraMode::PERSPECTIVE };
+    Camera.SetAspectRatio((float)Resolution.x / (float)Resolution.y);
+    Camera.SetYaw(-90.f);
+    Camera.UpdateCameraVectors();
+
+    if (CameraPath.Keys.size())
+    {
+        bench::SampleCameraPath(CameraPath, 0, &Camera);
+    }
+
+    scene::FRenderView RenderView;
+    RenderView.Camera   = &Camera;
+    RenderView.Viewport = { 0, 0, Resolution.x, Resolution.y };
+
+    // Let the streamer load everything the world references, so the measured frames don't include the uploads
+    u32 NumStreamingFrames = 0;
+    do
+    {
+        RenderFrame(World, RenderView, nullptr);
+    } while (GEngine.GetResourceStreamer().GetNumPendingResources() && ++NumStreamingFrames < MAX_STREAMING_FRAMES);
+
+    if (NumStreamingFrames == MAX_STREAMING_FRAMES)
+    {
+        LUCID_LOG(ELogLevel::WARN, "Resources are still streaming after %d frames, results might be skewed", MAX_STREAMING_FRAMES);
+    }
+
+    // The world space bounds of a loaded world are known only after it was culled at least once
+    if (CameraPath.Keys.empty())
+    {
+        if (Settings.WorldFilePath)
+        {
+            WorldBounds = bench::GetWorldBounds(World);
+        }
+        bench::MakeOrbitCameraPath(WorldBounds, Settings.OrbitDuration, CameraPath);
+    }
+
+    bench::SampleCameraPath(CameraPath, 0, &Camera);
+    for (u32 i = 0; i < Settings.NumWarmupFrames; ++i)
+    {
+        RenderFrame(World, RenderView, nullptr);
+    }
+
+    // Fly through the path at a fixed step, so the same frames are rendered regardless of how long they take
+    const float PathDuration = CameraPath.Keys.back().Time;
+    const u32   NumFrames    = Settings.NumFrames ? Settings.NumFrames : std::max(1u, (u32)(PathDuration / platform::SimulationStep));
+
+    FBenchSamples Samples;
+    Samples.CPUTimes.reserve(NumFrames);
+    Samples.GPUTimes.reserve(NumFrames);
+    Samples.FrameTimes.reserve(NumFrames);
+    Samples.NumDrawCalls.reserve(NumFrames);
+
+    LUCID_LOG(ELogLevel::INFO, "Benchmarking %d frames over %f seconds of camera path", NumFrames, PathDuration);
+
+    for (u32 i = 0; i < NumFrames; ++i)
+    {
+        const float Time = NumFrames > 1 ? PathDuration * i / (NumFrames - 1) : 0;
+        bench::SampleCameraPath(CameraPath, Time, &Camera);
+        RenderFrame(World, RenderView, &Samples);
+    }
+
+    const bool bReportWritten = WriteReport(Settings, Samples, Resolution);
+
+    GEngine.GetRenderer()->ResetState();
+    World->Unload();
+    delete World;
+
+    GEngine.Shutdown();
+    return bReportWritten ? 0 : -1;
+}
+
+static void PrintUsage()
+{
+    printf("Usage: lucid_bench [options]\n"
+           "  --world <path>                JSON world asset to benchmark\n"
+           "  --binary-world <path>         Binary world asset to benchmark\n"
+           "  --camera-path <path>          Camera path recorded in the editor, an orbit around the world is used when not set\n"
+           "  --orbit-duration <seconds>    Duration of the orbit, 10 by default\n"
+           "  --frames <n>                  Number of measured frames, one per simulation step of the path by default\n"
+           "  --warmup <n>                  Number of frames rendered before measuring, 60 by default\n"
+           "  --out <path>                  Where the JSON report is written, bench_report.json by default\n"
+           "Synthetic scene, used when no world is given:\n"
+           "  --meshes <n>                  Number of static meshes\n"
+           "  --lights <n>                  Number of point lights\n"
+           "  --shadow-lights-step <n>      Every n-th point light casts shadows\n"
+           "  --terrain <n>                 Terrain resolution in cells\n"
+           "  --mesh <name>                 Static mesh actor asset to instance\n"
+           "  --seed <n>                    Seed of the scene layout\n");
+}
+
+static bool ParseArguments(const int& InArgc, char** InArgv, FBenchSettings& OutSettings)
+{
+    for (int i = 1; i < InArgc; ++i)
+    {
+        const char* Arg = InArgv[i];
+        if (i + 1 >= InArgc)
+        {
+            LUCID_LOG(ELogLevel::ERR, "Missing value for %s", Arg);
+            return false;
+        }
+
+        const char* Value = InArgv[++i];
+
+        if (strcmp(Arg, "--world") == 0)
+        {
+            OutSettings.WorldFilePath = Value;
+            OutSettings.bBinaryWorld  = false;
+        }
+        else if (strcmp(Arg, "--binary-world") == 0)
+        {
+            OutSettings.WorldFilePath = Value;
+            OutSettings.bBinaryWorld  = true;
+        }
+        else if (strcmp(Arg, "--camera-path") == 0)
+        {
+            OutSettings.CameraPathFilePath = Value;
+        }
+        else if (strcmp(Arg, "--orbit-duration") == 0)
+        {
+            OutSettings.OrbitDuration = (float)atof(Value);
+        }
+        else if (strcmp(Arg, "--frames") == 0)
+        {
+            OutSettings.NumFrames = (u32)atoi(Value);
+        }
+        else if (strcmp(Arg, "--warmup") == 0)
+        {
+            OutSettings.NumWarmupFrames = (u32)atoi(Value);
+        }
+        else if (strcmp(Arg, "--out") == 0)
+        {
+            OutSettings.ReportFilePath = Value;
+        }
+        else if (strcmp(Arg, "--meshes") == 0)
+        {
+            OutSettings.SyntheticScene.NumMeshes = (u32)atoi(Value);
+        }
+        else if (strcmp(Arg, "--lights") == 0)
+        {
+            OutSettings.SyntheticScene.NumLights = (u32)atoi(Value);
+        }
+        else if (strcmp(Arg, "--shadow-lights-step") == 0)
+        {
+            OutSettings.SyntheticScene.ShadowCastingLightsStep = (u32)atoi(Value);
+        }
+        else if (strcmp(Arg, "--terrain") == 0)
+        {
+            OutSettings.SyntheticScene.TerrainSize = (u32)atoi(Value);
+        }
+        else if (strcmp(Arg, "--mesh") == 0)
+        {
+            OutSettings.SyntheticScene.MeshAssetName = Value;
+        }
+        else if (strcmp(Arg, "--seed") == 0)
+        {
+            OutSettings.SyntheticScene.Seed = (u32)atoi(Value);
+        }
+        else
+        {
+            LUCID_LOG(ELogLevel::ERR, "Unknown argument %s", Arg);
+            return false;
+        }
+    }
+
+    if (OutSettings.OrbitDuration <= 0)
+    {
+        LUCID_LOG(ELogLevel::ERR, "Orbit duration has to be positive");
+        return false;
+    }
+
+    return true;
+}
+
+static void RenderFrame(scene::CWorld* InWorld, scene::FRenderView& InRenderView, FBenchSamples* OutSamples)
+{
+    const double FrameStartTime = platform::GetPreciseTimeMiliseconds();
+
+    GEngine.BeginFrame();
+    InWorld->Tick(platform::SimulationStep);
+    scene::FRenderScene* RenderScene = InWorld->MakeRenderScene(InRenderView.Camera);
+
+    // Render() measures itself, without the wait for the GPU timers
+    const double SceneTime = platform::GetPreciseTimeMiliseconds() - FrameStartTime;
+
+    GEngine.GetRenderer()->Render(RenderScene, &InRenderView);
+    GEngine.EndFrame();
+
+    if (!OutSamples)
+    {
+        return;
+    }
+
+    OutSamples->FrameTimes.push_back((float)(platform::GetPreciseTimeMiliseconds() - FrameStartTime));
+    OutSamples->CPUTimes.push_back((float)SceneTime + scene::GRenderStats.CPUTimeMiliseconds);
+    OutSamples->GPUTimes.push_back(scene::GRenderStats.FrameTimeMiliseconds);
+    OutSamples->NumDrawCalls.push_back((float)scene::GRenderStats.NumDrawCalls);
+    OutSamples->NumShadowTilesUpdated += scene::GRenderStats.NumShadowTilesUpdated;
+
+    for (u8 i = 0; i < scene::GRenderStats.NumPasses; ++i)
+    {
+        const scene::FRenderPassStats& PassStats = scene::GRenderStats.Passes[i];
+
+        // Passes are identified by their name, as some of them are skipped when there is nothing to draw
+        auto PassSamples = std::find_if(OutSamples->Passes.begin(), OutSamples->Passes.end(), [&](const FPassSamples& InPass) {
+            return strcmp(InPass.Name, PassStats.Name) == 0;
+        });
+
+        if (PassSamples == OutSamples->Passes.end())
+        {
+            OutSamples->Passes.push_back({ PassStats.Name });
+            PassSamples = OutSamples->Passes.end() - 1;
+        }
+
+        PassSamples->GPUTimes.push_back(PassStats.GPUTimeMiliseconds);
+        PassSamples->NumDrawCalls += PassStats.NumDrawCalls;
+    }
+}
+
+/** Nearest-rank percentile, InSortedSamples can't be empty */
+static float Percentile(const std::vector<float>& InSortedSamples, const float& InPercentile)
+{
+    const u64 Rank = (u64)std::ceil(InPercentile / 100.f * InSortedSamples.size());
+    return InSortedSamples[std::max(Rank, (u64)1) - 1];
+}
+
+static void WriteStats(FILE* InFile, const char* InIndent, const char* InName, std::vector<float> InSamples, const bool& bInLast)
+{
+    float Mean = 0;
+    if (InSamples.size())
+    {
+        std::sort(InSamples.begin(), InSamples.end());
+        for (const float& Sample : InSamples)
+        {
+            Mean += Sample;
+        }
+        Mean /= InSamples.size();
+    }
+    else
+    {
+        InSamples.push_back(0);
+    }
+
+    fprintf(InFile,
+            "%s\"%s\": { \"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }%s\n",
+            InIndent,
+            InName,
+            Mean,
+            InSamples.front(),
+            Percentile(InSamples, 50),
+            Percentile(InSamples, 90),
+            Percentile(InSamples, 95),
+            Percentile(InSamples, 99),
+            InSamples.back(),
+            bInLast ? "" : ",");
+}
+
+static void WriteString(FILE* InFile, const char* InString)
+{
+    fputc('"', InFile);
+    for (const char* Char = InString; *Char; ++Char)
+    {
+        if (*Char == '"' || *Char == '\\')
+        {
+            fputc('\\', InFile);
+        }
+        fputc(*Char, InFile);
+    }
+    fputc('"', InFile);
+}
+
+static bool WriteReport(const FBenchSettings& InSettings, const FBenchSamples& InSamples, const glm::uvec2& InResolution)
+{
+    FILE* ReportFile = fopen(InSettings.ReportFilePath, "w");
+    if (!ReportFile)
+    {
+        LUCID_LOG(ELogLevel::ERR, "Failed to open %s for writing", InSettings.ReportFilePath);
+        return false;
+    }
+
+    const u32 NumFrames = (u32)InSamples.FrameTimes.size();
+
+    fprintf(ReportFile, "{\n");
+
+    if (InSettings.WorldFilePath)
+    {
+        fprintf(ReportFile, "    \"world\": ");
+        WriteString(ReportFile, InSettings.WorldFilePath);
+        fprintf(ReportFile, ",\n");
+    }
+    else
+    {
+        const bench::FSyntheticSceneSettings& Scene = InSettings.SyntheticScene;
+        fprintf(ReportFile,
+                "    \"synthetic_scene\": { \"meshes\": %u, \"lights\": %u, \"shadow_lights_step\": %u, \"terrain_size\": %u, \"seed\": %u, \"mesh\": ",
+                Scene.NumMeshes,
+                Scene.NumLights,
+                Scene.ShadowCastingLightsStep,
+                Scene.TerrainSize,
+                Scene.Seed);
+        WriteString(ReportFile, Scene.MeshAssetName ? Scene.MeshAssetName : "");
+        fprintf(ReportFile, " },\n");
+    }
+
+    fprintf(ReportFile, "    \"camera_path\": ");
+    WriteString(ReportFile, InSettings.CameraPathFilePath ? InSettings.CameraPathFilePath : "orbit");
+    fprintf(ReportFile, ",\n");
+
+    fprintf(ReportFile, "    \"resolution\": [%u, %u],\n", InResolution.x, InResolution.y);
+    fprintf(ReportFile, "    \"frames\": %u,\n", NumFrames);
+
+    WriteStats(ReportFile, "    ", "cpu_ms", InSamples.CPUTimes, false);
+    WriteStats(ReportFile, "    ", "gpu_ms", InSamples.GPUTimes, false);
+    WriteStats(ReportFile, "    ", "frame_ms", InSamples.FrameTimes, false);
+    WriteStats(ReportFile, "    ", "draw_calls", InSamples.NumDrawCalls, false);
+
+    fprintf(ReportFile, "    \"shadow_tiles_updated_per_frame\": %.4f,\n", NumFrames ? (float)InSamples.NumShadowTilesUpdated / NumFrames : 0.f);
+
+    fprintf(ReportFile, "    \"passes\": [\n");
+    for (u64 i = 0; i < InSamples.Passes.size(); ++i)
+    {
+        const FPassSamples& Pass = InSamples.Passes[i];
+
+        fprintf(ReportFile, "        {\n            \"name\": ");
+        WriteString(ReportFile, Pass.Name);
+        fprintf(ReportFile, ",\n");
+        fprintf(ReportFile, "            \"frames\": %u,\n", (u32)Pass.GPUTimes.size());
+        fprintf(ReportFile, "            \"draw_calls_per_frame\": %.4f,\n", (float)Pass.NumDrawCalls / Pass.GPUTimes.size());
+        WriteStats(ReportFile, "            ", "gpu_ms", Pass.GPUTimes, true);
+        fprintf(ReportFile, "        }%s\n", i + 1 < InSamples.Passes.size() ? "," : "");
+    }
+    fprintf(ReportFile, "    ]\n");
+    fprintf(ReportFile, "}\n");
+
+    fclose(ReportFile);
+
+    std::vector<float> CPUTimes = InSamples.CPUTimes;
+    std::vector<float> GPUTimes = InSamples.GPUTimes;
+    std::sort(CPUTimes.begin(), CPUTimes.end());
+    std::sort(GPUTimes.begin(), GPUTimes.end());
+
+    if (NumFrames)
+    {
+        LUCID_LOG(ELogLevel::INFO,
+                  "CPU p50 %.3f ms p99 %.3f ms, GPU p50 %.3f ms p99 %.3f ms, report written to %s",
+                  Percentile(CPUTimes, 50),
+                  Percentile(CPUTimes, 99),
+                  Percentile(GPUTimes, 50),
+                  Percentile(GPUTimes, 99),
+                  InSettings.ReportFilePath);
+    }
+
+    return true;
+}
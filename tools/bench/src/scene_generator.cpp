@@ -0,0 +1,199 @@
+#include "lucid_bench/bench.hpp"
+
+#include <cstring>
+#include <random>
+
+#include "engine/engine.hpp"
+
+#include "common/log.hpp"
+
+#include "glm/gtc/quaternion.hpp"
+
+#include "scene/world.hpp"
+#include "scene/renderer.hpp"
+#include "scene/actors/actor.hpp"
+#include "scene/actors/lights.hpp"
+#include "scene/actors/static_mesh.hpp"
+#include "scene/actors/terrain.hpp"
+
+namespace lucid::bench
+{
+    /** Gap between the meshes on the grid, their spacing is based on the size of the mesh */
+    static constexpr float MESH_GAP = 1.f;
+
+    /** How high above the meshes the point lights float */
+    static constexpr float LIGHTS_HEIGHT = 3.f;
+
+    static constexpr float LIGHTS_ATTENUATION_RADIUS = 10.f;
+
+    static constexpr float TERRAIN_CELL_SIZE  = 1.f;
+    static constexpr float TERRAIN_MAX_HEIGHT = 10.f;
+
+    /** Looked up in the order of the actor database, so the same asset is picked every run */
+    static scene::IActor* FindActorAsset(const scene::EActorType& InType, const char* InName)
+    {
+        for (const FActorDatabaseEntry& Entry : GEngine.GetActorsDatabase().Entries)
+        {
+            if (Entry.ActorType != InType)
+            {
+                continue;
+            }
+
+            scene::IActor* ActorAsset = GEngine.GetActorsResources().Get(Entry.ActorId);
+            if (ActorAsset && (!InName || strcmp(*ActorAsset->Name, InName) == 0))
+            {
+                return ActorAsset;
+            }
+        }
+        return nullptr;
+    }
+
+    static scene::CTerrain* GetTerrainAsset(const u32& InTerrainSize)
+    {
+        FDString TerrainName = SPrintf("BenchTerrain_%d", InTerrainSize);
+
+        if (scene::IActor* TerrainAsset = FindActorAsset(scene::EActorType::TERRAIN, *TerrainName))
+        {
+            TerrainName.Free();
+            return (scene::CTerrain*)TerrainAsset;
+        }
+
+        scene::FTerrainSettings TerrainSettings;
+        TerrainSettings.Resolution = { (float)InTerrainSize, (float)InTerrainSize };
+        TerrainSettings.GridSize   = TerrainSettings.Resolution * TERRAIN_CELL_SIZE;
+        TerrainSettings.bFlatMesh  = false;
+        TerrainSettings.Seed       = 1;
+        TerrainSettings.MinHeight  = 0;
+        TerrainSettings.MaxHeight  = TERRAIN_MAX_HEIGHT;
+
+        scene::CTerrain* TerrainAsset = scene::CTerrain::CreateAsset(TerrainName, TerrainSettings);
+        if (TerrainAsset)
+        {
+            GEngine.AddActorAsset(TerrainAsset);
+        }
+        return TerrainAsset;
+    }
+
+    scene::CWorld* GenerateSyntheticWorld(const FSyntheticSceneSettings& InSettings, math::FAABB& OutBounds)
+    {
+        auto* World = new scene::CWorld;
+        World->Init();
+
+        std::mt19937                          RandomEngine{ InSettings.Seed };
+        std::uniform_real_distribution<float> RandomUnit{ 0, 1 };
+
+        // Meshes
+        float GridExtent = 0;
+        if (InSettings.NumMeshes)
+        {
+            scene::IActor* MeshAsset = FindActorAsset(scene::EActorType::STATIC_MESH, InSettings.MeshAssetName);
+            if (!MeshAsset)
+            {
+                LUCID_LOG(ELogLevel::ERR, "Failed to generate the synthetic world - no static mesh asset");
+                delete World;
+                return nullptr;
+            }
+
+            const math::FAABB& MeshAABB    = MeshAsset->GetAABB();
+            const float        MeshSpacing = glm::max(MeshAABB.MaxX - MeshAABB.MinX, MeshAABB.MaxZ - MeshAABB.MinZ) + MESH_GAP;
+            const u32          GridSide    = (u32)glm::ceil(glm::sqrt((float)InSettings.NumMeshes));
+
+            GridExtent = GridSide * MeshSpacing;
+
+            for (u32 i = 0; i < InSettings.NumMeshes; ++i)
+            {
+                scene::FTransform3D MeshTransform;
+                MeshTransform.Translation = { ((i % GridSide) + 0.5f) * MeshSpacing - GridExtent / 2, 0, ((i / GridSide) + 0.5f) * MeshSpacing - GridExtent / 2 };
+                MeshTransform.Rotation    = glm::angleAxis(RandomUnit(RandomEngine) * glm::two_pi<float>(), glm::vec3{ 0, 1, 0 });
+
+                scene::IActor* Mesh = MeshAsset->CreateActorInstanceFromAsset(World, MeshTransform.Translation);
+                Mesh->SetTransform(MeshTransform);
+            }
+        }
+
+        // Terrain, it's top is below the meshes
+        float TerrainExtent = 0;
+        if (InSettings.TerrainSize)
+        {
+            const u32 TerrainSize = ((InSettings.TerrainSize + scene::TERRAIN_CHUNK_SIZE - 1) / scene::TERRAIN_CHUNK_SIZE) * scene::TERRAIN_CHUNK_SIZE;
+            if (scene::CTerrain* TerrainAsset = GetTerrainAsset(TerrainSize))
+            {
+                TerrainAsset->CreateActorInstanceFromAsset(World, { 0, 0, 0 })->SetTranslation({ 0, -TERRAIN_MAX_HEIGHT, 0 });
+                TerrainExtent = TerrainSize * TERRAIN_CELL_SIZE;
+            }
+        }
+
+        const float SceneExtent = glm::max(glm::max(GridExtent, TerrainExtent), LIGHTS_ATTENUATION_RADIUS);
+
+        // Lights are scattered over the whole scene
+        for (u32 i = 0; i < InSettings.NumLights; ++i)
+        {
+            const bool bCastsShadow = InSettings.ShadowCastingLightsStep && (i % InSettings.ShadowCastingLightsStep) == 0;
+
+            scene::CPointLight* PointLight = GEngine.GetRenderer()->CreatePointLight(SPrintf("PointLight_%d", i), nullptr, World, bCastsShadow);
+
+            const float X = (RandomUnit(RandomEngine) - 0.5f) * SceneExtent;
+            const float Z = (RandomUnit(RandomEngine) - 0.5f) * SceneExtent;
+
+            PointLight->SetTranslation({ X, LIGHTS_HEIGHT, Z });
+            PointLight->Color             = { 0.3f + RandomUnit(RandomEngine) * 0.7f, 0.3f + RandomUnit(RandomEngine) * 0.7f, 0.3f + RandomUnit(RandomEngine) * 0.7f };
+            PointLight->AttenuationRadius = LIGHTS_ATTENUATION_RADIUS;
+            PointLight->bCastsShadow      = bCastsShadow;
+
+            World->AddPointLight(PointLight);
+        }
+
+        // Sun
+        {
+            scene::CDirectionalLight* Sun = GEngine.GetRenderer()->CreateDirectionalLight(CopyToString("Sun"), nullptr, World, true, 3);
+
+            Sun->Direction    = glm::normalize(glm::vec3{ -0.4f, -0.8f, -0.45f });
+            Sun->LightUp      = glm::normalize(glm::cross(glm::cross(Sun->Direction, glm::vec3{ 0, 1, 0 }), Sun->Direction));
+            Sun->CascadeCount = 3;
+            Sun->bCastsShadow = true;
+
+            World->AddDirectionalLight(Sun);
+        }
+
+        OutBounds.MinXWS = OutBounds.MinZWS = -SceneExtent / 2;
+        OutBounds.MaxXWS = OutBounds.MaxZWS = SceneExtent / 2;
+        OutBounds.MinYWS                    = InSettings.TerrainSize ? -TERRAIN_MAX_HEIGHT : 0;
+        OutBounds.MaxYWS                    = LIGHTS_HEIGHT;
+
+        LUCID_LOG(ELogLevel::INFO,
+                  "Generated synthetic world: %d meshes, %d lights, %d terrain size, %f extent",
+                  InSettings.NumMeshes,
+                  InSettings.NumLights,
+                  InSettings.TerrainSize,
+                  SceneExtent);
+
+        return World;
+    }
+
+    math::FAABB GetWorldBounds(scene::CWorld* InWorld)
+    {
+        math::FAABB Bounds;
+        bool        bEmpty = true;
+
+        for (const auto& Entry : InWorld->GetActorsMap())
+        {
+            const scene::IActor* Actor = Entry.value;
+            if (Actor->GetActorType() != scene::EActorType::STATIC_MESH && Actor->GetActorType() != scene::EActorType::TERRAIN)
+            {
+                continue;
+            }
+
+            if (bEmpty)
+            {
+                Bounds = Actor->GetAABB();
+                bEmpty = false;
+            }
+            else
+            {
+                Bounds.GrowInWorldSpace(Actor->GetAABB());
+            }
+        }
+
+        return Bounds;
+    }
+} // namespace lucid::bench
@@ -4,6 +4,7 @@
 #include "scene/actors/actor.hpp"
 #include "common/strings.hpp"
 #include "common/types.hpp"
+#include "schemas/types.hpp"
 
 #include "imgui.h"
 #include "imgui_internal.h"
@@ -46,6 +47,7 @@ namespace lucid
     {
         class CMeshResource;
         class CTextureResource;
+        class CBatchImport;
     }; // namespace resources
 
     namespace scene
@@ -97,6 +99,9 @@ namespace lucid
         ImGui::FileBrowser FileDialog;
         void (*OnFileSelected)(const std::filesystem::path&);
 
+        bool               bShowDirectoryDialog = false;
+        ImGui::FileBrowser DirectoryDialog{ ImGuiFileBrowserFlags_SelectDirectory };
+
         /** Variables used when importing an asset to the engine */
 
         char                  AssetNameBuffer[256];
@@ -108,6 +113,11 @@ namespace lucid
         bool bIsImportingTexture     = false;
         bool bFailedToImportResource = false;
 
+        /** Set while a directory is imported */
+        resources::CBatchImport* BatchImport             = nullptr;
+        u32                      NumFailedBatchImports   = 0;
+        bool                     bShowBatchImportResults = false;
+
         resources::CMeshResource*    ClickedMeshResource    = nullptr;
         resources::CTextureResource* ClickedTextureResource = nullptr;
         scene::CMaterial*            ClickedMaterialAsset   = nullptr;
@@ -127,6 +137,7 @@ namespace lucid
 
         bool GenericBoolParam0 = false;
         bool GenericBoolParam1 = false;
+        bool GenericBoolParam2 = false;
 
         float GenericFloat2Param0[2] = { 0 };
         float GenericFloat2Param1[2] = { 0 };
@@ -165,6 +176,10 @@ namespace lucid
         float                FrameTimes[NumFrameTimesSamples] = { 0 };
         int                  FrameTimesIndex                  = 0;
 
+        /** Camera path replayed by lucid_bench, a key is added every simulation step while it's recorded */
+        bool        bRecordingCameraPath = false;
+        FCameraPath RecordedCameraPath;
+
         bool bShowingControlsWindow        = false;
         bool bShowingStatsWindow           = false;
         bool bShowingRendererSettinsWindow = false;
@@ -192,17 +192,15 @@ namespace lucid
                1.f;
     }
 
-    template <typename T>
-    struct FCachedTextureHitResult
+    /**
+     * Requests a pick under the cursor while the left mouse button is pressed in the scene window.
+     * Returns the result of the latest pick made since the button was pressed or nullptr if it's not ready yet.
+     */
+    static const scene::FPickResult* SceneWindow_PickUnderCursor()
     {
-        T    Value{ 0 };
-        bool bHit = false;
-    };
-
-    template <typename T>
-    static void SceneWindow_GetCachedTextureValueUnderCursor(const scene::FCachedTexture<T>& CachedTexture, FCachedTextureHitResult<T>& OutHitResult)
-    {
-        OutHitResult.bHit = false;
+        // Id of the first pick requested since the button was pressed, results of the older picks are stale
+        static u32 FirstPickRequestId = 0;
+        static u64 LastPickFrame      = 0;
 
         const glm::vec2 MouseScreenSpacePos = GetMouseScreenSpacePos();
 
@@ -210,56 +208,71 @@ namespace lucid
         if (MouseScreenSpacePos.x < 0 || MouseScreenSpacePos.x > GSceneEditorState.SceneWindowWidth || MouseScreenSpacePos.y < 0 ||
             MouseScreenSpacePos.y > GSceneEditorState.SceneWindowHeight)
         {
-            return;
+            return nullptr;
         }
 
         // Check if the scene window is not obscured by some other widget
         if (ImGui::GetFocusID() != GSceneEditorState.ImSceneWindow->ID && ImGui::GetFocusID() != GSceneEditorState.SceneDockId)
         {
-            return;
+            return nullptr;
         }
 
-        if (IsMouseButtonPressed(LEFT) && GSceneEditorState.World)
+        if (!IsMouseButtonPressed(LEFT) || !GSceneEditorState.World)
         {
-            // Adjust mouse postion based on hitmap texture size
-            const float RatioX = MouseScreenSpacePos.x / GSceneEditorState.SceneWindowWidth;
-            const float RatioY = MouseScreenSpacePos.y / GSceneEditorState.SceneWindowHeight;
+            return nullptr;
+        }
+
+        // Adjust mouse postion based on the renderer's resolution
+        scene::CRenderer* Renderer = GEngine.GetRenderer();
 
-            const glm::vec2 AdjustedMousePos = { ((float)CachedTexture.Width) * RatioX, ((float)CachedTexture.Height) * RatioY };
+        const float RatioX = MouseScreenSpacePos.x / GSceneEditorState.SceneWindowWidth;
+        const float RatioY = MouseScreenSpacePos.y / GSceneEditorState.SceneWindowHeight;
 
-            OutHitResult.bHit  = true;
-            OutHitResult.Value = CachedTexture.GetValueAtPosition(AdjustedMousePos);
+        const glm::uvec2 PickPosition = { (u32)(Renderer->ResultResolution.x * RatioX), (u32)(Renderer->ResultResolution.y * RatioY) };
+        const u32        RequestId    = Renderer->RequestPick(PickPosition);
+
+        // We weren't picking in the previous frame, so this is a new click
+        if (FirstPickRequestId == 0 || LastPickFrame + 1 < scene::GRenderStats.FrameNumber)
+        {
+            FirstPickRequestId = RequestId;
         }
+        LastPickFrame = scene::GRenderStats.FrameNumber;
+
+        const scene::FPickResult& PickResult = Renderer->GetLastPickResult();
+        if (PickResult.RequestId < FirstPickRequestId)
+        {
+            return nullptr;
+        }
+
+        return &PickResult;
     }
 
     scene::IActor* SceneWindow_GetActorUnderCursor()
     {
-        static FCachedTextureHitResult<u32> ActorHitResult;
-        SceneWindow_GetCachedTextureValueUnderCursor(GEngine.GetRenderer()->GetCachedHitMap(), ActorHitResult);
-
-        if (!ActorHitResult.bHit)
+        const scene::FPickResult* PickResult = SceneWindow_PickUnderCursor();
+        if (!PickResult)
         {
             return nullptr;
         }
 
-        if (scene::IActor* ClickedActor = GSceneEditorState.World->GetActorById(ActorHitResult.Value))
+        if (scene::IActor* ClickedActor = GSceneEditorState.World->GetActorById(PickResult->ActorId))
         {
             if (GSceneEditorState.CurrentlySelectedActor == nullptr)
             {
                 // Remember the actor that we hit and how far from the camera it was on the z axis
                 GSceneEditorState.CurrentlySelectedActor = ClickedActor;
             }
+            return ClickedActor;
         }
+
+        return nullptr;
     }
 
     float SceneWindow_GetDistanceToCameraUnderCursor()
     {
-        static FCachedTextureHitResult<float> DistanceHitResult;
-        SceneWindow_GetCachedTextureValueUnderCursor(GEngine.GetRenderer()->GetCachedDistanceToCameraMap(), DistanceHitResult);
-
-        if (DistanceHitResult.bHit)
+        if (const scene::FPickResult* PickResult = SceneWindow_PickUnderCursor())
         {
-            return DistanceHitResult.Value;
+            return PickResult->DistanceToCamera;
         }
 
         return -1;
@@ -24,6 +24,7 @@
 
 #include "resources/texture_resource.hpp"
 #include "resources/mesh_resource.hpp"
+#include "resources/batch_import.hpp"
 
 #include "glm/gtc/quaternion.hpp"
 
@@ -65,6 +66,7 @@ void UIDrawActorDetailsWindow();
 void UIDrawFileDialog();
 void UIDrawMeshImporter();
 void UIDrawTextureImporter();
+void UIDrawBatchImport();
 void UIDrawMeshContextMenu();
 void UIDrawTextureContextMenu();
 void UIDrawMaterialContextMenu();
@@ -86,7 +88,10 @@ void UIDrawDraggableImage(const char*    InDragDropId,
 
 void ImportTexture(const std::filesystem::path& SelectedFilePath);
 void ImportMesh(const std::filesystem::path& SelectedFilePath);
+void ImportDirectory(const std::filesystem::path& SelectedDirectoryPath);
 void LoadWorld(const std::filesystem::path& SelectedFilePath);
+void RecordCameraPathKey();
+void SaveRecordedCameraPath();
 
 int main(int argc, char** argv)
 {
@@ -136,6 +141,11 @@ int main(int argc, char** argv)
             GSceneEditorState.CurrentCamera->Tick(platform::SimulationStep);
             GSceneEditorState.SecondsSinceLastVideoMemorySnapshot += platform::SimulationStep;
 
+            if (GSceneEditorState.bRecordingCameraPath)
+            {
+                RecordCameraPathKey();
+            }
+
             if (GSceneEditorState.SecondsSinceLastVideoMemorySnapshot > 1)
             {
                 GSceneEditorState.VideoMemoryUsage[GSceneEditorState.VideoMemoryUsageIndex++ % GSceneEditorState.NumVideoMemoryUsageSamples] =
@@ -534,6 +544,12 @@ void UISetupDockspace()
                 }
             }
 
+            // Packs the resources into the archive that's loaded on startup
+            if (ImGui::MenuItem("Cook assets"))
+            {
+                GEngine.CookResources();
+            }
+
             ImGui::EndMenu();
         }
         if (ImGui::BeginMenu("Settings"))
@@ -557,6 +573,27 @@ void UISetupDockspace()
                 GSceneEditorState.bShowingStatsWindow = true;
             }
 
+            // The results are written to the log
+            if (ImGui::MenuItem("Benchmark hash maps"))
+            {
+                BenchmarkHashMaps();
+            }
+
+            // Recorded paths are replayed by lucid_bench
+            if (!GSceneEditorState.bRecordingCameraPath)
+            {
+                if (ImGui::MenuItem("Record camera path"))
+                {
+                    GSceneEditorState.RecordedCameraPath.Keys.clear();
+                    GSceneEditorState.bRecordingCameraPath = true;
+                }
+            }
+            else if (ImGui::MenuItem("Stop recording camera path"))
+            {
+                SaveRecordedCameraPath();
+                GSceneEditorState.bRecordingCameraPath = false;
+            }
+
             ImGui::EndMenu();
         }
         ImGui::EndMenuBar();
@@ -735,6 +772,15 @@ void UIDrawResourceBrowserWindow()
                         GSceneEditorState.FileDialog.Open();
                     }
 
+                    if (ImGui::MenuItem("Directory", nullptr, false, GSceneEditorState.BatchImport == nullptr))
+                    {
+                        GSceneEditorState.DirectoryDialog.SetTitle("Select a directory, meshes and textures in it will be imported");
+                        GSceneEditorState.OnFileSelected       = &ImportDirectory;
+                        GSceneEditorState.bShowDirectoryDialog = true;
+                        GSceneEditorState.DirectoryDialog.ClearSelected();
+                        GSceneEditorState.DirectoryDialog.Open();
+                    }
+
                     ImGui::EndMenu();
                 }
                 ImGui::EndMenu();
@@ -831,6 +877,10 @@ void UIDrawResourceBrowserWindow()
     {
         UIDrawTextureImporter();
     }
+    else if (GSceneEditorState.BatchImport || GSceneEditorState.bShowBatchImportResults)
+    {
+        UIDrawBatchImport();
+    }
     else if (GSceneEditorState.ClickedMeshResource)
     {
         UIDrawMeshContextMenu();
@@ -1108,6 +1158,7 @@ void UIDrawMeshImporter()
                   resources::ImportMesh(GSceneEditorState.PathToSelectedFile, MeshName, GSceneEditorState.GenericBoolParam0, MeshImportStrategy);
 
                 ImportedMeshes.Free();
+                MeshName.Free();
 
                 // End mesh import
                 GSceneEditorState.bIsImportingMesh       = false;
@@ -1151,6 +1202,7 @@ void UIDrawTextureImporter()
         ImGui::InputText("Texture name (max 255)", GSceneEditorState.AssetNameBuffer, 255);
         ImGui::Checkbox("Flip UVs", &GSceneEditorState.GenericBoolParam0);
         ImGui::Checkbox("Perform gamma correction", &GSceneEditorState.GenericBoolParam1);
+        ImGui::Checkbox("Normal map", &GSceneEditorState.GenericBoolParam2);
         if (ImGui::Button("Import"))
         {
             GSceneEditorState.bAssetNameMissing       = false;
@@ -1175,6 +1227,7 @@ void UIDrawTextureImporter()
                     ImportedTexture = resources::ImportTexture(GSceneEditorState.PathToSelectedFile,
                                                                { IMPORTED_TEXTURE_FILE_PATH },
                                                                GSceneEditorState.GenericBoolParam1,
+                                                               GSceneEditorState.GenericBoolParam2,
                                                                gpu::ETextureDataType::UNSIGNED_BYTE,
                                                                GSceneEditorState.GenericBoolParam0,
                                                                true,
@@ -1185,6 +1238,7 @@ void UIDrawTextureImporter()
                     ImportedTexture = resources::ImportTexture(GSceneEditorState.PathToSelectedFile,
                                                                { IMPORTED_TEXTURE_FILE_PATH },
                                                                GSceneEditorState.GenericBoolParam1,
+                                                               GSceneEditorState.GenericBoolParam2,
                                                                gpu::ETextureDataType::UNSIGNED_BYTE,
                                                                true,
                                                                true,
@@ -1231,6 +1285,58 @@ void UIDrawTextureImporter()
     ImGui::EndPopup();
 }
 
+void UIDrawBatchImport()
+{
+    if (!ImGui::IsPopupOpen(POPUP_WINDOW))
+    {
+        ImGui::OpenPopup(POPUP_WINDOW);
+    }
+
+    ImGui::SetNextWindowPos({ GSceneEditorState.Window->GetPosition().x + GSceneEditorState.Window->GetWidth() * 0.5f,
+                              GSceneEditorState.Window->GetPosition().y + GSceneEditorState.Window->GetHeight() * 0.5f },
+                            ImGuiCond_Always,
+                            { 0.5f, 0.5f });
+    ImGui::SetNextWindowSize({ 0, 0 });
+    ImGui::BeginPopupModal(POPUP_WINDOW, nullptr, ImGuiWindowFlags_NoTitleBar);
+    {
+        if (GSceneEditorState.BatchImport)
+        {
+            resources::CBatchImport* BatchImport = GSceneEditorState.BatchImport;
+            ImGui::Text("Importing %d/%d", BatchImport->GetNumImported(), BatchImport->GetNumToImport());
+            ImGui::ProgressBar(BatchImport->GetProgress(), { 300, 0 });
+
+            // The workers are done, register the imported resources
+            if (BatchImport->IsDone())
+            {
+                GSceneEditorState.NumFailedBatchImports   = BatchImport->Finish();
+                GSceneEditorState.bShowBatchImportResults = true;
+
+                delete BatchImport;
+                GSceneEditorState.BatchImport = nullptr;
+            }
+        }
+        else
+        {
+            if (GSceneEditorState.NumFailedBatchImports)
+            {
+                ImGui::Text("Failed to import %d files, see the log for details", GSceneEditorState.NumFailedBatchImports);
+            }
+            else
+            {
+                ImGui::Text("Import done");
+            }
+
+            if (ImGui::Button("Close"))
+            {
+                GSceneEditorState.bShowBatchImportResults = false;
+                GSceneEditorState.bDisableCameraMovement  = false;
+                ImGui::CloseCurrentPopup();
+            }
+        }
+    }
+    ImGui::EndPopup();
+}
+
 void UIDrawMeshContextMenu()
 {
     UIOpenPopup(*GSceneEditorState.ClickedMeshResource->GetName());
@@ -1304,7 +1410,7 @@ void UIDrawSceneHierarchyWindow()
     {
         if (GSceneEditorState.World)
         {
-            auto ActorMap = GSceneEditorState.World->GetActorsMap();
+            auto& ActorMap = GSceneEditorState.World->GetActorsMap();
             for (u32 i = 0; i < ActorMap.GetLength(); ++i)
             {
                 auto* Actor = ActorMap.GetByIndex(i);
@@ -1357,6 +1463,19 @@ void UIDrawFileDialog()
             GSceneEditorState.FileDialog.Display();
         }
     }
+
+    if (GSceneEditorState.bShowDirectoryDialog)
+    {
+        if (GSceneEditorState.DirectoryDialog.HasSelected())
+        {
+            GSceneEditorState.OnFileSelected(GSceneEditorState.DirectoryDialog.GetSelected());
+            GSceneEditorState.bShowDirectoryDialog = false;
+        }
+        else
+        {
+            GSceneEditorState.DirectoryDialog.Display();
+        }
+    }
 }
 
 void ImportTexture(const std::filesystem::path& SelectedFilePath)
@@ -1388,6 +1507,46 @@ void ImportMesh(const std::filesystem::path& SelectedFilePath)
     Zero(GSceneEditorState.AssetNameBuffer, 256);
 }
 
+void ImportDirectory(const std::filesystem::path& SelectedDirectoryPath)
+{
+    auto* BatchImport = new resources::CBatchImport;
+
+    for (const auto& Entry : std::filesystem::directory_iterator(SelectedDirectoryPath))
+    {
+        if (!Entry.is_regular_file())
+        {
+            continue;
+        }
+
+        const std::string& Extension = Entry.path().extension().string();
+        FDString           Path      = CopyToString(Entry.path().string().c_str());
+        FDString           Name      = CopyToString(Entry.path().stem().string().c_str());
+
+        // Same settings as the defaults of the single file importers
+        if (EqualIgnoreCase(Extension, ".obj"))
+        {
+            BatchImport->AddMesh(Path, Name, false, resources::EMeshImportStretegy::SUBMESHES);
+        }
+        else if (EqualIgnoreCase(Extension, ".png"))
+        {
+            BatchImport->AddTexture(Path, Name, false, false);
+        }
+        else if (EqualIgnoreCase(Extension, ".jpg") || EqualIgnoreCase(Extension, ".jpeg") || EqualIgnoreCase(Extension, ".tga"))
+        {
+            BatchImport->AddTexture(Path, Name, false, true);
+        }
+
+        Path.Free();
+        Name.Free();
+    }
+
+    BatchImport->Start();
+
+    GSceneEditorState.BatchImport            = BatchImport;
+    GSceneEditorState.NumFailedBatchImports  = 0;
+    GSceneEditorState.bDisableCameraMovement = true;
+}
+
 void UIDrawMaterialCreationMenu()
 {
     if (!ImGui::IsPopupOpen(POPUP_WINDOW))
@@ -1719,6 +1878,42 @@ void LoadWorld(const std::filesystem::path& SelectedFilePath)
     GSceneEditorState.World         = scene::LoadWorldFromJSONFile(GSceneEditorState.WorldFilePath);
 }
 
+void RecordCameraPathKey()
+{
+    std::vector<FCameraPathKey>& Keys = GSceneEditorState.RecordedCameraPath.Keys;
+
+    const glm::vec3 CameraPosition = GSceneEditorState.CurrentCamera->GetPosition();
+
+    FCameraPathKey Key;
+    Key.Time        = Keys.empty() ? 0 : Keys.back().Time + platform::SimulationStep;
+    Key.Position[0] = CameraPosition.x;
+    Key.Position[1] = CameraPosition.y;
+    Key.Position[2] = CameraPosition.z;
+    Key.Yaw         = GSceneEditorState.CurrentCamera->GetYaw();
+    Key.Pitch       = GSceneEditorState.CurrentCamera->GetPitch();
+    Keys.push_back(Key);
+}
+
+void SaveRecordedCameraPath()
+{
+    if (GSceneEditorState.RecordedCameraPath.Keys.empty())
+    {
+        return;
+    }
+
+    std::filesystem::create_directories("assets/camera_paths");
+
+    FDString CameraPathFilePath = SPrintf("assets/camera_paths/%s.json", sole::uuid4().str().c_str());
+    WriteToJSONFile(GSceneEditorState.RecordedCameraPath, *CameraPathFilePath);
+
+    LUCID_LOG(ELogLevel::INFO,
+              "Recorded camera path with %d keys saved to %s",
+              (u32)GSceneEditorState.RecordedCameraPath.Keys.size(),
+              *CameraPathFilePath);
+
+    CameraPathFilePath.Free();
+}
+
 void UIDrawHelpWindow() {}
 
 void UIDrawStatsWindow()
@@ -1746,6 +1941,14 @@ void UIDrawStatsWindow()
 
         ImGui::PlotLines("Frame time (ms)", GSceneEditorState.FrameTimes, GSceneEditorState.NumFrameTimesSamples, 0, NULL, 0.0f, 120, ImVec2(0, 100));
 
+        ImGui::Spacing();
+
+        for (u8 i = 0; i < scene::GRenderStats.NumPasses; ++i)
+        {
+            const scene::FRenderPassStats& PassStats = scene::GRenderStats.Passes[i];
+            ImGui::Text("%s: %.3f ms, %d draw calls", PassStats.Name, PassStats.GPUTimeMiliseconds, PassStats.NumDrawCalls);
+        }
+
         ImGui::End();
     }
 }
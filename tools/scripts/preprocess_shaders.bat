@@ -4,7 +4,7 @@ SET PROCESSED_SHADERS_DIR=shaders\glsl
 
 @ECHO Pre-processing shaders...
 
-FOR %%f IN (%BASE_SHADERS_DIR%\*.frag, %BASE_SHADERS_DIR%\*.vert, %BASE_SHADERS_DIR%\*.geom) DO (
+FOR %%f IN (%BASE_SHADERS_DIR%\*.frag, %BASE_SHADERS_DIR%\*.vert, %BASE_SHADERS_DIR%\*.geom, %BASE_SHADERS_DIR%\*.comp) DO (
     @ECHO Processing %%~nxf
     CALL python tools/scripts/shaders_preprocessor.py %BASE_SHADERS_DIR% %PROCESSED_SHADERS_DIR% %%~nxf %%~nxf
     IF %ERRORLEVEL% NEQ 0 (